@@ -45,6 +45,29 @@ namespace Asset //! Namespace containing all asset related classes, enums and fu
     {
       return Texture(Violet_Assets_Texture::Load(file_path));
     }
+    /**
+    * @brief Loads a texture from disk on a streaming thread. The texture is usable right away and shows a placeholder until it is loaded
+    * @param file_path (const String) The file path of the desired texture
+    * @param priority (const float) The priority of the load. Lower priorities are loaded sooner
+    * @return (Asset::Texture) The texture that is being loaded
+    * @public
+    **/
+    Texture LoadTextureAsync(const String&in file_path, const float&in priority = 0.0f)
+    {
+      return Texture(Violet_Assets_Texture::LoadAsync(file_path, priority));
+    }
+    /**
+    * @brief Loads a texture from disk on a streaming thread. The texture shows the placeholder until it is loaded
+    * @param file_path (const String) The file path of the desired texture
+    * @param placeholder (const Asset::Texture) The texture that is shown while loading
+    * @param priority (const float) The priority of the load. Lower priorities are loaded sooner
+    * @return (Asset::Texture) The texture that is being loaded
+    * @public
+    **/
+    Texture LoadTextureAsync(const String&in file_path, const Texture&in placeholder, const float&in priority = 0.0f)
+    {
+      return Texture(Violet_Assets_Texture::LoadAsync(file_path, placeholder.GetId(), priority));
+    }
     Texture LoadCubeMap(const String&in front, const String&in back, const String&in top, const String&in bottom, const String&in left, const String&in right)
     {
       return Texture(Violet_Assets_Texture::LoadCubeMap(front, back, top, bottom, left, right));
@@ -68,6 +91,17 @@ namespace Asset //! Namespace containing all asset related classes, enums and fu
       return Mesh(Violet_Assets_Mesh::Load(file_path));
     }
     /**
+    * @brief Loads a mesh from disk on a streaming thread. The mesh is empty until it is loaded
+    * @param file_path (const String) The file path of the desired mesh
+    * @param priority (const float) The priority of the load. Lower priorities are loaded sooner
+    * @return (Asset::Mesh) The mesh that is being loaded
+    * @public
+    **/
+    Mesh LoadMeshAsync(const String&in file_path, const float&in priority = 0.0f)
+    {
+      return Mesh(Violet_Assets_Mesh::LoadAsync(file_path, priority));
+    }
+    /**
     * @brief Loads a shader from disk
     * @param file_path (const String) The file path of the desired shader
     * @return (Asset::Shader) The loaded shader
@@ -87,6 +121,17 @@ namespace Asset //! Namespace containing all asset related classes, enums and fu
     {
       return Wave(Violet_Assets_Wave::Load(file_path));
     }
+    /**
+    * @brief Loads a wave from disk on a streaming thread. The wave is silent until it is loaded
+    * @param file_path (const String) The file path of the desired wave
+    * @param priority (const float) The priority of the load. Lower priorities are loaded sooner
+    * @return (Asset::Wave) The wave that is being loaded
+    * @public
+    **/
+    Wave LoadWaveAsync(const String&in file_path, const float&in priority = 0.0f)
+    {
+      return Wave(Violet_Assets_Wave::LoadAsync(file_path, priority));
+    }
   }
 }
 Asset::AssetManager asset_manager; //!< The static instance of the asset manager
@@ -26,6 +26,22 @@ namespace Asset //! Namespace containing all asset related classes, enums and fu
         kR16, //!< R float 16 bits per pixel
         kR24G8 //!< RG Depth Stencil 32 bits per pixel
     };
+
+    /**
+    * @enum LoadState
+    * @brief The state of an asset that was loaded asynchronously
+    * @public
+    **/
+    enum LoadState
+    {
+        kNone, //!< Never streamed, the asset was loaded directly
+        kQueued, //!< Waiting for a streaming thread
+        kLoading, //!< Being read from disk
+        kLoaded, //!< Read from disk, waiting to be handed to the asset
+        kReady, //!< The asset contains the loaded data
+        kFailed, //!< The asset could not be loaded and still contains its placeholder
+        kCancelled //!< The load was cancelled and the asset still contains its placeholder
+    };
 }
 
 namespace Input //! Namespace containing all input classes, enums and functions
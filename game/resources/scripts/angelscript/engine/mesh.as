@@ -1,4 +1,5 @@
 /** @file mesh.as */
+#include "enums.as"
 
 /**
 * @addtogroup Assets
@@ -64,6 +65,51 @@ namespace Asset //! Namespace containing all asset related classes, enums and fu
       return Violet_Assets_Mesh::GetSubMeshCount(id);
     }
     /**
+    * @brief Get the state of the mesh if it was loaded asynchronously
+    * @return (Asset::LoadState) The load state of the mesh
+    * @public
+    **/
+    LoadState GetLoadState() const
+    {
+      return LoadState(Violet_Assets_Mesh::GetLoadState(id));
+    }
+    /**
+    * @brief Whether or not the mesh contains its data. True for meshs that were not loaded asynchronously
+    * @return (bool) Whether or not the mesh contains its data
+    * @public
+    **/
+    bool IsLoaded() const
+    {
+      LoadState state = GetLoadState();
+      return state == LoadState::kNone || state == LoadState::kReady;
+    }
+    /**
+    * @brief Set the priority of a mesh that is still loading. Lower priorities are loaded sooner
+    * @param priority (const float) The new priority, usually the distance to the camera
+    * @public
+    **/
+    void SetLoadPriority(const float&in priority) const
+    {
+      Violet_Assets_Mesh::SetLoadPriority(id, priority);
+    }
+    /**
+    * @brief Cancel loading the mesh. The mesh keeps its placeholder
+    * @public
+    **/
+    void CancelLoad() const
+    {
+      Violet_Assets_Mesh::CancelLoad(id);
+    }
+    /**
+    * @brief Call a function once the mesh is done loading. It is called right away if it is done already
+    * @param function (const String) The full name of a global function with the signature void(uint64 id, uint8 state)
+    * @public
+    **/
+    void OnLoaded(const String&in function) const
+    {
+      Violet_Assets_Mesh::OnLoaded(id, function);
+    }
+    /**
     * @brief Returns the engine id of this mesh
     * @return (uint16) The engine id of this mesh
     * @public
@@ -68,6 +68,51 @@ namespace Asset //! Namespace containing all asset related classes, enums and fu
       return Violet_Assets_Texture::GetSize(id);
     }
     /**
+    * @brief Get the state of the texture if it was loaded asynchronously
+    * @return (Asset::LoadState) The load state of the texture
+    * @public
+    **/
+    LoadState GetLoadState() const
+    {
+      return LoadState(Violet_Assets_Texture::GetLoadState(id));
+    }
+    /**
+    * @brief Whether or not the texture contains its data. True for textures that were not loaded asynchronously
+    * @return (bool) Whether or not the texture contains its data
+    * @public
+    **/
+    bool IsLoaded() const
+    {
+      LoadState state = GetLoadState();
+      return state == LoadState::kNone || state == LoadState::kReady;
+    }
+    /**
+    * @brief Set the priority of a texture that is still loading. Lower priorities are loaded sooner
+    * @param priority (const float) The new priority, usually the distance to the camera
+    * @public
+    **/
+    void SetLoadPriority(const float&in priority) const
+    {
+      Violet_Assets_Texture::SetLoadPriority(id, priority);
+    }
+    /**
+    * @brief Cancel loading the texture. The texture keeps its placeholder
+    * @public
+    **/
+    void CancelLoad() const
+    {
+      Violet_Assets_Texture::CancelLoad(id);
+    }
+    /**
+    * @brief Call a function once the texture is done loading. It is called right away if it is done already
+    * @param function (const String) The full name of a global function with the signature void(uint64 id, uint8 state)
+    * @public
+    **/
+    void OnLoaded(const String&in function) const
+    {
+      Violet_Assets_Texture::OnLoaded(id, function);
+    }
+    /**
     * @brief Get the engine id of the texture
     * @return (uint64) The engine id of the texture
     * @public
@@ -1,4 +1,5 @@
 /** @file wave.as */
+#include "enums.as"
 
 /**
 * @addtogroup Assets
@@ -40,6 +41,51 @@ namespace Asset //! Namespace containing all asset related classes, enums and fu
       id = other.id;
     }
     /**
+    * @brief Get the state of the wave if it was loaded asynchronously
+    * @return (Asset::LoadState) The load state of the wave
+    * @public
+    **/
+    LoadState GetLoadState() const
+    {
+      return LoadState(Violet_Assets_Wave::GetLoadState(id));
+    }
+    /**
+    * @brief Whether or not the wave contains its data. True for waves that were not loaded asynchronously
+    * @return (bool) Whether or not the wave contains its data
+    * @public
+    **/
+    bool IsLoaded() const
+    {
+      LoadState state = GetLoadState();
+      return state == LoadState::kNone || state == LoadState::kReady;
+    }
+    /**
+    * @brief Set the priority of a wave that is still loading. Lower priorities are loaded sooner
+    * @param priority (const float) The new priority, usually the distance to the camera
+    * @public
+    **/
+    void SetLoadPriority(const float&in priority) const
+    {
+      Violet_Assets_Wave::SetLoadPriority(id, priority);
+    }
+    /**
+    * @brief Cancel loading the wave. The wave keeps its placeholder
+    * @public
+    **/
+    void CancelLoad() const
+    {
+      Violet_Assets_Wave::CancelLoad(id);
+    }
+    /**
+    * @brief Call a function once the wave is done loading. It is called right away if it is done already
+    * @param function (const String) The full name of a global function with the signature void(uint64 id, uint8 state)
+    * @public
+    **/
+    void OnLoaded(const String&in function) const
+    {
+      Violet_Assets_Wave::OnLoaded(id, function);
+    }
+    /**
     * @brief Get the engine id of the wave
     * @return (uint64) The engine id of the wave
     * @public
@@ -0,0 +1,227 @@
+#include "benchmark.h"
+#include "assets/asset_handle.h"
+#include <glm/glm.hpp>
+#include <random>
+#include <thread>
+
+namespace lambda
+{
+	namespace benchmarks
+	{
+		static constexpr uint32_t kRenderableCount = 50000u;
+		static constexpr uint32_t kMeshCount       = 64u;
+		static constexpr uint32_t kTextureCount    = 256u;
+		static constexpr uint32_t kRepeatCount     = 10u;
+		static constexpr uint32_t kThreadCount     = 4u;
+
+		///////////////////////////////////////////////////////////////////////////
+		// Stands in for meshes and textures, which would pull in the renderer.
+		template<uint32_t kType>
+		struct BenchmarkAsset
+		{
+			static void release(BenchmarkAsset* asset, const size_t& hash)
+			{
+			}
+		};
+		typedef BenchmarkAsset<0u> BenchmarkMesh;
+		typedef BenchmarkAsset<1u> BenchmarkTexture;
+
+		///////////////////////////////////////////////////////////////////////////
+		// The handle every asset had before the slot table. Every copy and
+		// destruction locks a mutex and looks the name up in a map.
+		namespace legacy
+		{
+			template<typename T>
+			class RefHandler
+			{
+			public:
+				static void incRef(const size_t& hash)
+				{
+					std::lock_guard<std::mutex> lock(g_mutex);
+					if (hash != 0u)
+						g_refs[hash]++;
+				}
+				static bool decRef(const size_t& hash)
+				{
+					std::lock_guard<std::mutex> lock(g_mutex);
+					if (hash == 0u)
+						return true;
+
+					const int ref = --g_refs[hash];
+					if (ref <= 0)
+						g_refs.erase(hash);
+					return ref > 0;
+				}
+
+			private:
+				static std::mutex g_mutex;
+				static UnorderedMap<size_t, int> g_refs;
+			};
+			template<typename T>
+			std::mutex RefHandler<T>::g_mutex;
+			template<typename T>
+			UnorderedMap<size_t, int> RefHandler<T>::g_refs;
+
+			template<typename T>
+			class Handle
+			{
+			public:
+				Handle() : hash_(0u), data_(nullptr) {}
+				Handle(T* data, const Name& name) : hash_(name.getHash()), data_(data)
+				{
+					RefHandler<T>::incRef(hash_);
+				}
+				Handle(const Handle& other) : hash_(other.hash_), data_(other.data_)
+				{
+					RefHandler<T>::incRef(hash_);
+				}
+				~Handle()
+				{
+					RefHandler<T>::decRef(hash_);
+				}
+				void operator=(const Handle& other)
+				{
+					if (hash_ == other.hash_)
+						return;
+					RefHandler<T>::decRef(hash_);
+					hash_ = other.hash_;
+					data_ = other.data_;
+					RefHandler<T>::incRef(hash_);
+				}
+
+			private:
+				size_t hash_;
+				T* data_;
+			};
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Laid out like utilities::Renderable.
+		template<typename MeshHandle, typename TextureHandle>
+		struct BenchmarkRenderable
+		{
+			uint32_t      entity;
+			glm::mat4x4   model_matrix;
+			MeshHandle    mesh;
+			uint32_t      sub_mesh = 0u;
+			TextureHandle albedo_texture;
+			TextureHandle normal_texture;
+			TextureHandle dmra_texture;
+			TextureHandle emissive_texture;
+			float         metallicness = 0.0f;
+			float         roughness    = 1.0f;
+			glm::vec3     emissiveness;
+			glm::vec3     min;
+			glm::vec3     max;
+			glm::vec3     center;
+			float         radius;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename Renderable, typename MeshHandle, typename TextureHandle>
+		static Vector<Renderable> makeRenderables(const Vector<MeshHandle>& meshes, const Vector<TextureHandle>& textures)
+		{
+			std::mt19937 random(kRenderableCount);
+			Vector<Renderable> renderables(kRenderableCount);
+			for (uint32_t i = 0u; i < kRenderableCount; ++i)
+			{
+				Renderable& renderable = renderables[i];
+				renderable.entity           = i + 1u;
+				renderable.mesh             = meshes[random() % kMeshCount];
+				renderable.albedo_texture   = textures[random() % kTextureCount];
+				renderable.normal_texture   = textures[random() % kTextureCount];
+				renderable.dmra_texture     = textures[random() % kTextureCount];
+				renderable.emissive_texture = textures[random() % kTextureCount];
+			}
+			return renderables;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Copies the list into a render list and drops it again, once on one
+		// thread and once on several at the same time, like the views that are
+		// culled in parallel.
+		template<typename Renderable>
+		static void measureCopies(const char* name, const Vector<Renderable>& renderables)
+		{
+			utilities::Timer timer;
+			for (uint32_t r = 0u; r < kRepeatCount; ++r)
+			{
+				Vector<Renderable> list(renderables.begin(), renderables.end());
+				doNotOptimize(list);
+			}
+			report(name, "copy 50k renderables", timer.elapsed().milliseconds() / (double)kRepeatCount, "ms");
+
+			timer.reset();
+			std::thread threads[kThreadCount];
+			for (std::thread& thread : threads)
+			{
+				thread = std::thread([&renderables]() {
+					for (uint32_t r = 0u; r < kRepeatCount; ++r)
+					{
+						Vector<Renderable> list(renderables.begin(), renderables.end());
+						doNotOptimize(list);
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+			report(name, "copy 50k renderables on 4 threads", timer.elapsed().milliseconds() / (double)kRepeatCount, "ms");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(AssetHandleLegacy)
+		{
+			typedef legacy::Handle<BenchmarkMesh>    MeshHandle;
+			typedef legacy::Handle<BenchmarkTexture> TextureHandle;
+			typedef BenchmarkRenderable<MeshHandle, TextureHandle> Renderable;
+
+			BenchmarkMesh    mesh;
+			BenchmarkTexture texture;
+			Vector<MeshHandle>    meshes;
+			Vector<TextureHandle> textures;
+			for (uint32_t i = 0u; i < kMeshCount; ++i)
+				meshes.push_back(MeshHandle(&mesh, Name("mesh_" + toString(i))));
+			for (uint32_t i = 0u; i < kTextureCount; ++i)
+				textures.push_back(TextureHandle(&texture, Name("texture_" + toString(i))));
+
+			measureCopies("AssetHandleLegacy", makeRenderables<Renderable>(meshes, textures));
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename MeshType, typename TextureType>
+		static void measureSlots(const char* name)
+		{
+			typedef asset::VioletHandle<BenchmarkMesh>    MeshHandle;
+			typedef asset::VioletHandle<BenchmarkTexture> TextureHandle;
+
+			BenchmarkMesh    mesh;
+			BenchmarkTexture texture;
+			{
+				Vector<MeshHandle>    meshes;
+				Vector<TextureHandle> textures;
+				for (uint32_t i = 0u; i < kMeshCount; ++i)
+					meshes.push_back(MeshHandle(&mesh, Name("mesh_" + toString(i))));
+				for (uint32_t i = 0u; i < kTextureCount; ++i)
+					textures.push_back(TextureHandle(&texture, Name("texture_" + toString(i))));
+
+				typedef BenchmarkRenderable<MeshType, TextureType> Renderable;
+				measureCopies(name, makeRenderables<Renderable>(meshes, textures));
+			}
+
+			asset::VioletRefHandler<BenchmarkMesh>::collectGarbage();
+			asset::VioletRefHandler<BenchmarkTexture>::collectGarbage();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(AssetHandle)
+		{
+			measureSlots<asset::VioletHandle<BenchmarkMesh>, asset::VioletHandle<BenchmarkTexture>>("AssetHandle");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(AssetRef)
+		{
+			measureSlots<asset::VioletRef<BenchmarkMesh>, asset::VioletRef<BenchmarkTexture>>("AssetRef");
+		}
+	}
+}
@@ -0,0 +1,228 @@
+#include "benchmark.h"
+#include <assets/asset_pack.h>
+#include <utils/file_system.h>
+#include <utils/console.h>
+#include <lz4.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#if VIOLET_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace lambda
+{
+	namespace benchmarks
+	{
+		static constexpr uint32_t kAssetCount = 2000u;
+		static const char* const  kMagic      = "tex";
+
+		///////////////////////////////////////////////////////////////////////////
+		// Half of the assets compress well, like vertex data. The other half
+		// does not, like block compressed textures.
+		struct BenchmarkAssets
+		{
+			Vector<uint64_t>     hashes;
+			Vector<Vector<char>> headers;
+			Vector<Vector<char>> data;
+			size_t               bytes = 0u;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		static BenchmarkAssets makeAssets()
+		{
+			std::mt19937 random(kAssetCount);
+			std::uniform_int_distribution<uint32_t> size(4u << 10u, 64u << 10u);
+
+			BenchmarkAssets assets;
+			for (uint32_t i = 0u; i < kAssetCount; ++i)
+			{
+				const String json = "{\"hash\":" + toString(i) + ",\"file\":\"textures/benchmark_" + toString(i) + ".png\",\"width\":256,\"height\":256}";
+				Vector<char> data(size(random));
+				for (size_t j = 0u; j < data.size(); ++j)
+					data[j] = (i & 1u) ? (char)random() : (char)((j / 12u) & 0x3Fu);
+
+				assets.hashes.push_back(hash("benchmark_" + toString(i)));
+				assets.headers.push_back(Vector<char>(json.begin(), json.end()));
+				assets.bytes += data.size();
+				assets.data.push_back(eastl::move(data));
+			}
+			return assets;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Drops the file from the OS cache so the next read has to go to disk.
+		// Only done on Linux. Elsewhere the cold numbers include the cache.
+		static void evict(const String& file)
+		{
+#if VIOLET_LINUX
+			const int fd = open(FileSystem::FullFilePath(file).c_str(), O_RDONLY);
+			if (fd < 0)
+				return;
+			fdatasync(fd);
+			posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+			close(fd);
+#endif
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// How VioletBaseAssetManager stored assets before the packs. Two files
+		// per asset, and the data read whole and decompressed into a buffer of
+		// LZ4_compressBound() bytes.
+		namespace legacy
+		{
+			static String dataFile(uint64_t hash)
+			{
+				return String("benchmark_") + kMagic + "_data_" + toString(hash);
+			}
+			static String headerFile(uint64_t hash)
+			{
+				return String("benchmark_") + kMagic + "_header_" + toString(hash);
+			}
+
+			static void save(const Vector<char>& header, const Vector<char>& data, uint64_t hash)
+			{
+				FileSystem::WriteFile(headerFile(hash), header.data(), header.size(), kMagic, 3u);
+
+				Vector<char> compressed_data((uint64_t)LZ4_compressBound((int)data.size()), '\0');
+				compressed_data.resize(LZ4_compress_default(data.data(), compressed_data.data(), (int)data.size(), (int)compressed_data.size()) + sizeof(uint32_t));
+				uint32_t size = (uint32_t)data.size();
+				memcpy(compressed_data.data() + compressed_data.size() - sizeof(uint32_t), &size, sizeof(uint32_t));
+				FileSystem::WriteFile(dataFile(hash), compressed_data.data(), compressed_data.size(), kMagic, 3u);
+			}
+
+			static Vector<char> loadData(uint64_t hash)
+			{
+				Vector<char> data = FileSystem::FileToVector(dataFile(hash), kMagic, 3u);
+
+				uint32_t original_size = 0u;
+				memcpy(&original_size, data.data() + data.size() - sizeof(uint32_t), sizeof(uint32_t));
+
+				Vector<char> decompressed_data(LZ4_compressBound((int)original_size), '\0');
+				int res = LZ4_decompress_safe(data.data(), decompressed_data.data(), (int)data.size() - sizeof(uint32_t), (int)decompressed_data.size());
+				decompressed_data.resize(res < 0 ? 0u : (uint64_t)res);
+				return decompressed_data;
+			}
+
+			static Vector<char> loadHeader(uint64_t hash)
+			{
+				return FileSystem::FileToVector(headerFile(hash), kMagic, 3u);
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static double loadLegacy(const BenchmarkAssets& assets)
+		{
+			utilities::Timer timer;
+			size_t bytes = 0u;
+			for (uint64_t hash : assets.hashes)
+			{
+				Vector<char> header = legacy::loadHeader(hash);
+				Vector<char> data   = legacy::loadData(hash);
+				bytes += header.size() + data.size();
+				doNotOptimize(data);
+			}
+			LMB_ASSERT(bytes >= assets.bytes, "BENCHMARK: Legacy load lost data");
+			return timer.elapsed().milliseconds();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Opens the pack as part of the load, like the managers do on start up.
+		// With spans, uncompressed data is only touched instead of copied.
+		static double loadPack(const BenchmarkAssets& assets, bool spans)
+		{
+			utilities::Timer timer;
+			VioletAssetPack pack;
+			pack.Open("benchmark.pack", kMagic);
+
+			size_t bytes = 0u;
+			Vector<char> data;
+			for (uint64_t hash : assets.hashes)
+			{
+				Vector<char> header = pack.Read(hash, VioletPackBlob::kHeader);
+				bytes += header.size();
+
+				VioletPackSpan span = spans ? pack.GetSpan(hash, VioletPackBlob::kData) : VioletPackSpan();
+				if (span.data)
+				{
+					uint64_t sum = 0u;
+					for (size_t i = 0u; i < span.size; i += 4096u)
+						sum += (uint8_t)span.data[i];
+					doNotOptimize(sum);
+					bytes += span.size;
+				}
+				else
+				{
+					data.resize(pack.GetSize(hash, VioletPackBlob::kData));
+					pack.Read(hash, VioletPackBlob::kData, data.data(), data.size());
+					doNotOptimize(data);
+					bytes += data.size();
+				}
+			}
+			LMB_ASSERT(bytes >= assets.bytes, "BENCHMARK: Pack load lost data");
+			return timer.elapsed().milliseconds();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(AssetPack)
+		{
+			FileSystem::SetBaseDir("./");
+			const BenchmarkAssets assets = makeAssets();
+			report("AssetPack", "assets", (double)kAssetCount, "");
+			report("AssetPack", "data", (double)assets.bytes / (1024.0 * 1024.0), "MiB");
+
+			utilities::Timer timer;
+			for (uint32_t i = 0u; i < kAssetCount; ++i)
+				legacy::save(assets.headers[i], assets.data[i], assets.hashes[i]);
+			report("AssetPack", "write per-file", timer.elapsed().milliseconds(), "ms");
+
+			timer.reset();
+			{
+				VioletAssetPack pack;
+				pack.Open("benchmark.pack", kMagic);
+				for (uint32_t i = 0u; i < kAssetCount; ++i)
+				{
+					pack.Write(assets.hashes[i], VioletPackBlob::kHeader, assets.headers[i].data(), assets.headers[i].size(), VioletPackCodec::kNone);
+					pack.Write(assets.hashes[i], VioletPackBlob::kData, assets.data[i].data(), assets.data[i].size(), VioletPackCodec::kLZ4);
+				}
+				pack.Flush();
+			}
+			report("AssetPack", "write pack", timer.elapsed().milliseconds(), "ms");
+
+			for (uint64_t hash : assets.hashes)
+			{
+				evict(legacy::headerFile(hash));
+				evict(legacy::dataFile(hash));
+			}
+			report("AssetPack", "cold load per-file", loadLegacy(assets), "ms");
+			report("AssetPack", "warm load per-file", loadLegacy(assets), "ms");
+
+			evict("benchmark.pack");
+			report("AssetPack", "cold load pack", loadPack(assets, false), "ms");
+			report("AssetPack", "warm load pack", loadPack(assets, false), "ms");
+			evict("benchmark.pack");
+			report("AssetPack", "cold load pack spans", loadPack(assets, true), "ms");
+			report("AssetPack", "warm load pack spans", loadPack(assets, true), "ms");
+
+			// Replaces a quarter of the assets, which appends to the pack.
+			timer.reset();
+			{
+				VioletAssetPack pack;
+				pack.Open("benchmark.pack", kMagic);
+				for (uint32_t i = 0u; i < kAssetCount; i += 4u)
+					pack.Write(assets.hashes[i], VioletPackBlob::kData, assets.data[i].data(), assets.data[i].size(), VioletPackCodec::kLZ4);
+				pack.Flush();
+			}
+			report("AssetPack", "append 1/4 to pack", timer.elapsed().milliseconds(), "ms");
+
+			for (uint64_t hash : assets.hashes)
+			{
+				std::remove(FileSystem::FullFilePath(legacy::headerFile(hash)).c_str());
+				std::remove(FileSystem::FullFilePath(legacy::dataFile(hash)).c_str());
+			}
+			std::remove(FileSystem::FullFilePath("benchmark.pack").c_str());
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <containers/containers.h>
+#include <utils/timer.h>
+
+namespace lambda
+{
+	namespace benchmarks
+	{
+		typedef void(*BenchmarkFunction)();
+
+		///////////////////////////////////////////////////////////////////////////
+		struct Benchmark
+		{
+			const char* name;
+			BenchmarkFunction function;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		Vector<Benchmark>& getBenchmarks();
+		// Prints one line per measurement so results can be diffed and gated on.
+		void report(const char* benchmark, const char* metric, double value, const char* unit);
+		// CPU time consumed by the whole process, across all threads.
+		double processCpuSeconds();
+
+		///////////////////////////////////////////////////////////////////////////
+		struct BenchmarkRegistrar
+		{
+			BenchmarkRegistrar(const char* name, BenchmarkFunction function)
+			{
+				getBenchmarks().push_back({ name, function });
+			}
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// Keeps the optimizer from removing the work that is being measured.
+		extern const void* volatile k_do_not_optimize_sink;
+		template<typename T>
+		inline void doNotOptimize(const T& value)
+		{
+			k_do_not_optimize_sink = &value;
+		}
+	}
+}
+
+#define LMB_BENCHMARK(name) \
+	static void name(); \
+	static lambda::benchmarks::BenchmarkRegistrar k_##name##_registrar(#name, name); \
+	static void name()
@@ -0,0 +1,204 @@
+#include "benchmark.h"
+#include "utils/bvh.h"
+#include "platform/debug_renderer.h"
+#include <memory/frame_heap.h>
+#include <memory/memory.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace lambda
+{
+	namespace platform
+	{
+		// bvh.cc draws through the debug renderer, which pulls in the whole
+		// renderer. The benchmarks never draw.
+		void DebugRenderer::DrawLine(const DebugLine& line)
+		{
+		}
+	}
+
+	namespace benchmarks
+	{
+		static constexpr uint32_t kSizes[]     = { 10000u, 100000u, 1000000u };
+		static constexpr uint32_t kQueryCount  = 16u;
+		static constexpr uint32_t kRefitCount  = 4u;
+		// Every refit moves this part of the primitives by up to a unit.
+		static constexpr float    kMovedFraction = 0.25f;
+
+		///////////////////////////////////////////////////////////////////////////
+		// Boxes of up to two units spread over a cube that grows with the
+		// count, so the density stays the same.
+		struct Scene
+		{
+			Vector<utilities::BVHAABB> aabbs;
+			Vector<utilities::Frustum> frustums;
+			float extent;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		static utilities::BVHAABB randomAABB(std::mt19937& random, float extent)
+		{
+			std::uniform_real_distribution<float> position(-extent, extent);
+			std::uniform_real_distribution<float> size(0.25f, 1.0f);
+			const glm::vec3 center(position(random), position(random), position(random));
+			const glm::vec3 half(size(random), size(random), size(random));
+			return utilities::BVHAABB(center - half, center + half);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static Scene makeScene(uint32_t count)
+		{
+			Scene scene;
+			scene.extent = 5.0f * std::cbrt((float)count);
+
+			std::mt19937 random(count);
+			scene.aabbs.resize(count);
+			for (utilities::BVHAABB& aabb : scene.aabbs)
+				aabb = randomAABB(random, scene.extent);
+
+			// Cameras on a circle around the center, looking inwards.
+			const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, scene.extent);
+			for (uint32_t i = 0u; i < kQueryCount; ++i)
+			{
+				const float angle = glm::radians(360.0f) * (float)i / (float)kQueryCount;
+				const glm::vec3 eye = glm::vec3(std::cos(angle), 0.25f, std::sin(angle)) * scene.extent;
+				utilities::Frustum frustum;
+				frustum.construct(projection, glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+				scene.frustums.push_back(frustum);
+			}
+
+			return scene;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Dynamic objects move a little every frame.
+		static void moveAABBs(Scene& scene, std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+			const uint32_t moved = (uint32_t)(scene.aabbs.size() * kMovedFraction);
+			for (uint32_t i = 0u; i < moved; ++i)
+			{
+				utilities::BVHAABB& aabb = scene.aabbs[random() % scene.aabbs.size()];
+				const glm::vec3 delta(offset(random), offset(random), offset(random));
+				aabb = utilities::BVHAABB(aabb.bl + delta, aabb.tr + delta);
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static void releaseFrameHeap()
+		{
+			for (uint32_t i = 0u; i < foundation::FrameHeap::kHeapCount; ++i)
+				foundation::GetFrameHeap()->update();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static void reportSize(const char* name, const char* metric, uint32_t count, double value, const char* unit)
+		{
+			char full_metric[64];
+			snprintf(full_metric, sizeof(full_metric), "%s %u", metric, count);
+			report(name, full_metric, value, unit);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// The pointer BVHs have no refit. TransientBVH was refit by clearing
+		// and inserting everything again, so that is what is measured.
+		template<typename BVH>
+		static void runPointerBVH(const char* name)
+		{
+			for (uint32_t count : kSizes)
+			{
+				Scene scene = makeScene(count);
+				std::mt19937 random(1234u);
+
+				BVH* bvh = foundation::Memory::construct<BVH>();
+				utilities::Timer timer;
+				for (uint32_t i = 0u; i < count; ++i)
+					bvh->add(i + 1u, nullptr, scene.aabbs[i]);
+				reportSize(name, "build", count, timer.elapsed().milliseconds(), "ms");
+
+				double ms = 0.0;
+				for (uint32_t r = 0u; r < kRefitCount; ++r)
+				{
+					moveAABBs(scene, random);
+					timer.reset();
+					bvh->clear();
+					for (uint32_t i = 0u; i < count; ++i)
+						bvh->add(i + 1u, nullptr, scene.aabbs[i]);
+					ms += timer.elapsed().milliseconds();
+					releaseFrameHeap();
+				}
+				reportSize(name, "refit", count, ms / (double)kRefitCount, "ms");
+
+				size_t found = 0u;
+				timer.reset();
+				for (const utilities::Frustum& frustum : scene.frustums)
+					found += bvh->getAllEntityInAABB(frustum).size();
+				reportSize(name, "frustum query", count, timer.elapsed().milliseconds() / (double)kQueryCount, "ms");
+				reportSize(name, "found", count, (double)found / (double)kQueryCount, "primitives");
+
+				bvh->clear();
+				foundation::Memory::destruct(bvh);
+				releaseFrameHeap();
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(BVHPointer)
+		{
+			runPointerBVH<utilities::BVH>("BVHPointer");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(BVHTransient)
+		{
+			runPointerBVH<utilities::TransientBVH>("BVHTransient");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(BVHFlat)
+		{
+			const char* name = "BVHFlat";
+			for (uint32_t count : kSizes)
+			{
+				Scene scene = makeScene(count);
+				std::mt19937 random(1234u);
+
+				utilities::FlatBVH bvh;
+				utilities::Timer timer;
+				for (uint32_t i = 0u; i < count; ++i)
+					bvh.add(i + 1u, nullptr, scene.aabbs[i]);
+				bvh.commit();
+				reportSize(name, "build", count, timer.elapsed().milliseconds(), "ms");
+
+				double ms = 0.0;
+				for (uint32_t r = 0u; r < kRefitCount; ++r)
+				{
+					moveAABBs(scene, random);
+					timer.reset();
+					for (uint32_t i = 0u; i < count; ++i)
+						bvh.update(i + 1u, scene.aabbs[i]);
+					bvh.commit();
+					ms += timer.elapsed().milliseconds();
+				}
+				reportSize(name, "refit", count, ms / (double)kRefitCount, "ms");
+
+				Vector<entity::Entity> entities(count);
+				size_t found = 0u;
+				timer.reset();
+				for (const utilities::Frustum& frustum : scene.frustums)
+					found += bvh.getEntitiesInFrustum(frustum, entities.data(), count);
+				reportSize(name, "frustum query", count, timer.elapsed().milliseconds() / (double)kQueryCount, "ms");
+				reportSize(name, "found", count, (double)found / (double)kQueryCount, "primitives");
+
+				// The same query on a tree that was built for the current positions.
+				bvh.build();
+				timer.reset();
+				for (const utilities::Frustum& frustum : scene.frustums)
+					found += bvh.getEntitiesInFrustum(frustum, entities.data(), count);
+				reportSize(name, "frustum query rebuilt", count, timer.elapsed().milliseconds() / (double)kQueryCount, "ms");
+			}
+		}
+	}
+}
@@ -0,0 +1,159 @@
+#include "benchmark.h"
+#include "systems/component_store.h"
+#include <algorithm>
+#include <random>
+
+namespace lambda
+{
+	namespace benchmarks
+	{
+		static constexpr uint32_t kEntityCount = 100000u;
+		static constexpr uint32_t kRepeatCount = 10u;
+
+		///////////////////////////////////////////////////////////////////////////
+		// About the size of a small component. The padding keeps the payload
+		// from fitting in a couple of cache lines.
+		struct BenchmarkData
+		{
+			BenchmarkData() {};
+			BenchmarkData(const entity::Entity& entity) : entity(entity) {};
+
+			float value[12] = {};
+			entity::Entity entity = entity::InvalidEntity;
+			bool valid = true;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// The SystemData every system had before the sparse set.
+		namespace legacy
+		{
+			struct SystemData
+			{
+				Vector<BenchmarkData>         data;
+				Map<entity::Entity, uint32_t> entity_to_data;
+				Map<uint32_t, entity::Entity> data_to_entity;
+				Set<entity::Entity>           marked_for_delete;
+				Queue<uint32_t>               unused_data_entries;
+
+				BenchmarkData& add(const entity::Entity& entity)
+				{
+					uint32_t idx = 0ul;
+					if (!unused_data_entries.empty())
+					{
+						idx = unused_data_entries.front();
+						unused_data_entries.pop();
+						data[idx] = BenchmarkData(entity);
+					}
+					else
+					{
+						idx = (uint32_t)data.size();
+						data.push_back(BenchmarkData(entity));
+					}
+
+					data_to_entity[idx] = entity;
+					entity_to_data[entity] = idx;
+					return data[idx];
+				}
+				BenchmarkData& get(const entity::Entity& entity)
+				{
+					return data[entity_to_data.find(entity)->second];
+				}
+				void remove(const entity::Entity& entity)
+				{
+					marked_for_delete.insert(entity);
+				}
+				void collectGarbage()
+				{
+					for (entity::Entity entity : marked_for_delete)
+					{
+						const auto& it = entity_to_data.find(entity);
+						if (it != entity_to_data.end())
+						{
+							uint32_t idx = it->second;
+							unused_data_entries.push(idx);
+							data_to_entity.erase(idx);
+							entity_to_data.erase(entity);
+							data[idx].valid = false;
+						}
+					}
+					marked_for_delete.clear();
+				}
+			};
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Every fourth entity is removed so the legacy store iterates holes and
+		// the sparse set has swapped components around.
+		static Vector<entity::Entity> makeEntities()
+		{
+			Vector<entity::Entity> entities(kEntityCount);
+			for (uint32_t i = 0u; i < kEntityCount; ++i)
+				entities[i] = entity::makeEntity(i + 1u, 0u);
+			return entities;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static Vector<entity::Entity> makeLookups(const Vector<entity::Entity>& entities)
+		{
+			Vector<entity::Entity> lookups;
+			for (uint32_t i = 0u; i < kEntityCount; ++i)
+				if (i % 4u != 0u)
+					lookups.push_back(entities[i]);
+
+			std::mt19937 random(1234u);
+			std::shuffle(lookups.begin(), lookups.end(), random);
+			return lookups;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename Store>
+		static void run(const char* name, Store& store)
+		{
+			const Vector<entity::Entity> entities = makeEntities();
+			const Vector<entity::Entity> lookups  = makeLookups(entities);
+
+			utilities::Timer timer;
+			for (uint32_t i = 0u; i < kEntityCount; ++i)
+				store.add(entities[i]).value[0] = (float)i;
+			for (uint32_t i = 0u; i < kEntityCount; i += 4u)
+				store.remove(entities[i]);
+			store.collectGarbage();
+			double ms = timer.elapsed().milliseconds();
+			report(name, "add+remove", ms * 1000000.0 / (double)(kEntityCount + kEntityCount / 4u), "ns/op");
+
+			float sum = 0.0f;
+			timer.reset();
+			for (uint32_t r = 0u; r < kRepeatCount; ++r)
+				for (entity::Entity entity : lookups)
+					sum += store.get(entity).value[0];
+			ms = timer.elapsed().milliseconds();
+			doNotOptimize(sum);
+			report(name, "random lookup", ms * 1000000.0 / (double)(lookups.size() * kRepeatCount), "ns/op");
+
+			sum = 0.0f;
+			timer.reset();
+			for (uint32_t r = 0u; r < kRepeatCount; ++r)
+				for (const BenchmarkData& data : store.data)
+					if (data.valid)
+						sum += data.value[0];
+			ms = timer.elapsed().milliseconds();
+			doNotOptimize(sum);
+			report(name, "iteration", ms * 1000000.0 / (double)(lookups.size() * kRepeatCount), "ns/component");
+			report(name, "slots iterated", (double)store.data.size(), "slots");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(ComponentStoreLegacy)
+		{
+			legacy::SystemData store;
+			run("ComponentStoreLegacy", store);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(ComponentStoreSparseSet)
+		{
+			components::ComponentStore<BenchmarkData> store;
+			run("ComponentStoreSparseSet", store);
+		}
+	}
+}
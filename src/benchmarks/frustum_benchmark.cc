@@ -0,0 +1,107 @@
+#include "benchmark.h"
+#include "platform/frustum.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <random>
+
+namespace lambda
+{
+	namespace benchmarks
+	{
+		static constexpr uint32_t kBoxCount     = 1000000u;
+		static constexpr uint32_t kFrustumCount = 16u;
+
+		///////////////////////////////////////////////////////////////////////////
+		// Boxes of up to two units in SoA, spread like the BVH benchmark scenes.
+		struct Boxes
+		{
+			Vector<float> min[3];
+			Vector<float> max[3];
+
+			utilities::AABBArrays arrays() const
+			{
+				return { min[0].data(), min[1].data(), min[2].data(), max[0].data(), max[1].data(), max[2].data() };
+			}
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		static Boxes makeBoxes(float extent)
+		{
+			std::mt19937 random(kBoxCount);
+			std::uniform_real_distribution<float> position(-extent, extent);
+			std::uniform_real_distribution<float> size(0.25f, 1.0f);
+
+			Boxes boxes;
+			for (uint32_t axis = 0u; axis < 3u; ++axis)
+			{
+				boxes.min[axis].resize(kBoxCount);
+				boxes.max[axis].resize(kBoxCount);
+			}
+			for (uint32_t i = 0u; i < kBoxCount; ++i)
+			{
+				for (uint32_t axis = 0u; axis < 3u; ++axis)
+				{
+					const float center = position(random);
+					const float half   = size(random);
+					boxes.min[axis][i] = center - half;
+					boxes.max[axis][i] = center + half;
+				}
+			}
+			return boxes;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static Vector<utilities::Frustum> makeFrustums(float extent)
+		{
+			Vector<utilities::Frustum> frustums;
+			const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, extent);
+			for (uint32_t i = 0u; i < kFrustumCount; ++i)
+			{
+				const float angle = glm::radians(360.0f) * (float)i / (float)kFrustumCount;
+				const glm::vec3 eye = glm::vec3(std::cos(angle), 0.25f, std::sin(angle)) * extent;
+				utilities::Frustum frustum;
+				frustum.construct(projection, glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+				frustums.push_back(frustum);
+			}
+			return frustums;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// One box at a time against the kernel that tests a batch of them.
+		LMB_BENCHMARK(FrustumCull)
+		{
+			const float extent = 5.0f * std::cbrt((float)kBoxCount);
+			const Boxes boxes = makeBoxes(extent);
+			const Vector<utilities::Frustum> frustums = makeFrustums(extent);
+			Vector<uint32_t> visible(kBoxCount);
+
+			size_t found = 0u;
+			utilities::Timer timer;
+			for (const utilities::Frustum& frustum : frustums)
+			{
+				uint32_t count = 0u;
+				for (uint32_t i = 0u; i < kBoxCount; ++i)
+				{
+					const glm::vec3 min(boxes.min[0][i], boxes.min[1][i], boxes.min[2][i]);
+					const glm::vec3 max(boxes.max[0][i], boxes.max[1][i], boxes.max[2][i]);
+					if (frustum.ContainsAABB(min, max))
+						visible[count++] = i;
+				}
+				found += count;
+			}
+			double ms = timer.elapsed().milliseconds();
+			doNotOptimize(found);
+			report("FrustumCull", "single", ms * 1000000.0 / (double)(kBoxCount * kFrustumCount), "ns/box");
+
+			found = 0u;
+			const utilities::AABBArrays arrays = boxes.arrays();
+			timer.reset();
+			for (const utilities::Frustum& frustum : frustums)
+				found += frustum.cullAABBs(arrays, 0u, kBoxCount, visible.data());
+			ms = timer.elapsed().milliseconds();
+			doNotOptimize(found);
+			report("FrustumCull", "batch", ms * 1000000.0 / (double)(kBoxCount * kFrustumCount), "ns/box");
+			report("FrustumCull", "visible", (double)found / (double)kFrustumCount, "boxes");
+		}
+	}
+}
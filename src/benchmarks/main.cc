@@ -0,0 +1,86 @@
+#include "benchmark.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#if VIOLET_WIN32
+#include <Windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace lambda
+{
+	namespace benchmarks
+	{
+		const void* volatile k_do_not_optimize_sink = nullptr;
+
+		///////////////////////////////////////////////////////////////////////////
+		Vector<Benchmark>& getBenchmarks()
+		{
+			static Vector<Benchmark> benchmarks;
+			return benchmarks;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void report(const char* benchmark, const char* metric, double value, const char* unit)
+		{
+			printf("%-32s %-40s %16.4f %s\n", benchmark, metric, value, unit);
+			fflush(stdout);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		double processCpuSeconds()
+		{
+#if VIOLET_WIN32
+			FILETIME creation, exit, kernel, user;
+			GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+			ULARGE_INTEGER k, u;
+			k.LowPart = kernel.dwLowDateTime;
+			k.HighPart = kernel.dwHighDateTime;
+			u.LowPart = user.dwLowDateTime;
+			u.HighPart = user.dwHighDateTime;
+			return (double)(k.QuadPart + u.QuadPart) * 1e-7;
+#else
+			rusage usage;
+			getrusage(RUSAGE_SELF, &usage);
+			return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+				(double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+		}
+	}
+}
+
+using namespace lambda;
+
+// Usage: lambda-benchmarks [benchmark-name ...]
+// Runs every registered benchmark when no names are given.
+int main(int argc, char** argv)
+{
+	int ran = 0;
+	for (const benchmarks::Benchmark& benchmark : benchmarks::getBenchmarks())
+	{
+		bool selected = (argc == 1);
+		for (int i = 1; i < argc && !selected; ++i)
+			selected = strcmp(argv[i], benchmark.name) == 0;
+
+		if (!selected)
+			continue;
+
+		printf("== %s\n", benchmark.name);
+		utilities::Timer timer;
+		benchmark.function();
+		benchmarks::report(benchmark.name, "total", timer.elapsed().milliseconds(), "ms");
+		ran++;
+	}
+
+	if (ran == 0)
+	{
+		printf("No benchmarks matched. Available:\n");
+		for (const benchmarks::Benchmark& benchmark : benchmarks::getBenchmarks())
+			printf("  %s\n", benchmark.name);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,623 @@
+#include "benchmark.h"
+#include <message.h>
+#include <message_codec.h>
+#include <messages.h>
+#include <server.h>
+#include <client.h>
+#include <snapshot.h>
+#include <enet/enet.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+namespace lambda
+{
+	namespace benchmarks
+	{
+		static constexpr uint32_t kMessageCount    = 200000u;
+		// MessagePacket counts its messages in a uint8_t.
+		static constexpr uint32_t kMessagesPerTick = 200u;
+		static constexpr uint16_t kPort            = 47610u;
+		static constexpr double   kConnectTimeout  = 1000.0;
+		static constexpr uint32_t kSnapshotTicks   = 90u;
+		static constexpr float    kSnapshotRate    = 30.0f;
+		// How long a tick waits for the client to ack the snapshot.
+		static constexpr double   kSnapshotPatience = 50.0;
+		static constexpr uint32_t kInterestClients  = 16u;
+		static constexpr uint32_t kInterestEntities = 10000u;
+		static constexpr uint32_t kInterestTicks    = 150u;
+		static constexpr float    kInterestRadius   = 50.0f;
+		static constexpr uint32_t kLatencyPings     = 300u;
+		// Frames after the last ping for the last replies to come in.
+		static constexpr uint32_t kLatencyDrain     = 30u;
+		// Different, so where one frame falls in the other drifts.
+		static constexpr double   kLatencyClientRate = 144.0;
+		static constexpr double   kLatencyServerRate = 60.0;
+
+		///////////////////////////////////////////////////////////////////////////
+		// ENet is set up for the length of one benchmark.
+		struct ENetScope
+		{
+			ENetScope() { enet_initialize(); }
+			~ENetScope() { enet_deinitialize(); }
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// A server and its clients in this process, over UDP on 127.0.0.1.
+		// Both are shut down when it goes, so every benchmark can use kPort.
+		struct Loopback
+		{
+			explicit Loopback(uint32_t client_count = 1u) :
+				clients(client_count)
+			{
+				server.initialize(kPort);
+				for (networking::Client& client : clients)
+					client.initialize("benchmark", kPort);
+			}
+			~Loopback()
+			{
+				for (networking::Client& client : clients)
+					client.deinitialize();
+				server.deinitialize();
+			}
+
+			bool isConnected()
+			{
+				for (networking::Client& client : clients)
+					if (!client.isConnected())
+						return false;
+				return true;
+			}
+
+			// Calls update until every client is connected, for up to
+			// kConnectTimeout.
+			template <typename Update>
+			bool connect(const char* benchmark, Update update)
+			{
+				utilities::Timer connecting;
+				while (!isConnected() && connecting.elapsed().milliseconds() < kConnectTimeout)
+					update();
+				if (isConnected())
+					return true;
+				printf("%s: could not connect over loopback\n", benchmark);
+				return false;
+			}
+
+			networking::Server server;
+			Vector<networking::Client> clients;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// The same update in both codecs: an entity and its position.
+		struct Update
+		{
+			uint32_t id;
+			float x, y, z;
+		};
+
+		static Update makeUpdate(uint32_t i)
+		{
+			return { i % 4096u, (float)(i % 1000u) * 0.25f, 1.5f, (float)(i % 777u) * -0.5f };
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		struct Totals
+		{
+			uint32_t messages = 0u;
+			size_t   bytes    = 0u;
+			uint32_t invalid  = 0u;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// The String codec, as scripts use it now. The position is text in
+		// the message, and every packet is sent reliably.
+		namespace legacy
+		{
+			static void writeTick(uint32_t first, uint32_t count, Vector<ENetPacket*>& packets)
+			{
+				networking::MessagePacket packet;
+				char text[64];
+				for (uint32_t i = first; i < first + count; ++i)
+				{
+					const Update update = makeUpdate(i);
+					snprintf(text, sizeof(text), "%u %f %f %f", update.id, update.x, update.y, update.z);
+					networking::Message message("pos", text);
+					message.client_id = 1u;
+					packet.addMessage(message);
+				}
+				packets.push_back(packet.asPacket());
+			}
+
+			static void read(ENetPacket* packet, Totals& totals)
+			{
+				totals.bytes += packet->dataLength;
+				// Destroys the packet.
+				networking::MessagePacket messages(packet);
+				for (uint8_t i = 0u; i < messages.messageCount(); ++i)
+				{
+					const networking::Message message = messages.getMessage(i);
+					Update update;
+					if (sscanf(message.message.c_str(), "%u %f %f %f", &update.id, &update.x, &update.y, &update.z) == 4)
+						totals.messages++;
+					else
+						totals.invalid++;
+				}
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		namespace binary
+		{
+			static networking::Delivery k_delivery = networking::Delivery::kReliable;
+
+			static void writeTick(uint32_t first, uint32_t count, Vector<ENetPacket*>& packets)
+			{
+				networking::PacketWriter writer;
+				networking::MessageWriter payload;
+				for (uint32_t i = first; i < first + count; ++i)
+				{
+					const Update update = makeUpdate(i);
+					payload.clear();
+					payload.writeVarint(update.id);
+					payload.write(update.x);
+					payload.write(update.y);
+					payload.write(update.z);
+
+					if (!writer.fits(payload.size()))
+						packets.push_back(writer.finish(k_delivery));
+					writer.add(networking::kMessageTypeUser, 1u, payload.data(), payload.size());
+				}
+				packets.push_back(writer.finish(k_delivery));
+			}
+
+			static void read(ENetPacket* packet, Totals& totals)
+			{
+				totals.bytes += packet->dataLength;
+				networking::ReceivedPacket received(packet, nullptr, 0u);
+				networking::MessageView message;
+				while (received.next(message))
+				{
+					networking::MessageReader reader = message.reader();
+					Update update;
+					update.id = (uint32_t)reader.readVarint();
+					update.x  = reader.read<float>();
+					update.y  = reader.read<float>();
+					update.z  = reader.read<float>();
+					doNotOptimize(update);
+					if (reader.isValid())
+						totals.messages++;
+					else
+						totals.invalid++;
+				}
+			}
+		}
+
+		typedef void(*WriteTick)(uint32_t, uint32_t, Vector<ENetPacket*>&);
+		typedef void(*ReadPacket)(ENetPacket*, Totals&);
+
+		///////////////////////////////////////////////////////////////////////////
+		// Without sockets, so only the codecs are measured.
+		static void runCodec(const char* benchmark, WriteTick write, ReadPacket read)
+		{
+			Totals totals;
+			Vector<ENetPacket*> packets;
+			utilities::Timer timer;
+			for (uint32_t first = 0u; first < kMessageCount; first += kMessagesPerTick)
+			{
+				packets.clear();
+				write(first, kMessagesPerTick, packets);
+				for (ENetPacket* packet : packets)
+				{
+					// What a receiving host makes of it.
+					ENetPacket* received = enet_packet_create(packet->data, packet->dataLength, 0);
+					enet_packet_destroy(packet);
+					read(received, totals);
+				}
+			}
+			const double seconds = timer.elapsed().seconds();
+			report(benchmark, "codec messages", (double)totals.messages / seconds, "msg/s");
+			report(benchmark, "codec bytes", (double)totals.bytes / seconds / (1024.0 * 1024.0), "MB/s");
+			report(benchmark, "codec bytes per message", (double)totals.bytes / (double)totals.messages, "bytes");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// A server and a client host in this process, talking over UDP on
+		// 127.0.0.1. A tick of messages is sent once the last one arrived,
+		// or nothing arrived for patience milliseconds.
+		static void runLoopback(const char* benchmark, const char* metric, WriteTick write, ReadPacket read, double patience)
+		{
+			ENetAddress address;
+			enet_address_set_host(&address, "127.0.0.1");
+			address.port = kPort;
+			ENetHost* server = enet_host_create(&address, 1, networking::kChannelCount, 0, 0);
+			ENetHost* client = enet_host_create(nullptr, 1, networking::kChannelCount, 0, 0);
+			if (server == nullptr || client == nullptr)
+			{
+				printf("%s: could not create the ENet hosts\n", benchmark);
+				return;
+			}
+
+			ENetPeer* peer = enet_host_connect(client, &address, networking::kChannelCount, 0);
+			ENetEvent event;
+			bool connected = false;
+			utilities::Timer connecting;
+			while (!connected && connecting.elapsed().milliseconds() < kConnectTimeout)
+			{
+				enet_host_service(server, &event, 1);
+				connected = enet_host_service(client, &event, 1) > 0 && event.type == ENET_EVENT_TYPE_CONNECT;
+			}
+
+			Totals totals;
+			uint32_t sent = 0u;
+			Vector<ENetPacket*> packets;
+			utilities::Timer timer;
+			while (connected && sent < kMessageCount)
+			{
+				packets.clear();
+				write(sent, kMessagesPerTick, packets);
+				sent += kMessagesPerTick;
+				for (ENetPacket* packet : packets)
+					enet_peer_send(peer, 0u, packet);
+				enet_host_flush(client);
+
+				utilities::Timer idle;
+				while (totals.messages + totals.invalid < sent && idle.elapsed().milliseconds() < patience)
+				{
+					while (enet_host_service(client, &event, 0) > 0)
+					{
+						if (event.type == ENET_EVENT_TYPE_RECEIVE)
+							enet_packet_destroy(event.packet);
+					}
+					while (enet_host_service(server, &event, 1) > 0)
+					{
+						if (event.type == ENET_EVENT_TYPE_RECEIVE)
+						{
+							read(event.packet, totals);
+							idle.reset();
+						}
+					}
+				}
+			}
+			const double seconds = timer.elapsed().seconds();
+
+			enet_peer_disconnect_now(peer, 0);
+			enet_host_destroy(client);
+			enet_host_destroy(server);
+
+			if (!connected)
+			{
+				printf("%s: could not connect over loopback\n", benchmark);
+				return;
+			}
+			report(benchmark, (String(metric) + " messages").c_str(), (double)totals.messages / seconds, "msg/s");
+			report(benchmark, (String(metric) + " bytes").c_str(), (double)totals.bytes / seconds / (1024.0 * 1024.0), "MB/s");
+			report(benchmark, (String(metric) + " delivered").c_str(), 100.0 * (double)totals.messages / (double)sent, "%");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// A server and a client in this process, replicating entity_count
+		// entities over UDP on 127.0.0.1. Every entity moves a little every
+		// tick and one in four turns, so every snapshot is a real delta.
+		static void runSnapshots(const char* benchmark, uint32_t entity_count)
+		{
+			Loopback loopback;
+			networking::Server& server = loopback.server;
+			networking::Client& client = loopback.clients[0];
+			// Acks go out in the update that made them, not on the next tick.
+			server.setFlushPolicy(networking::FlushPolicy::kImmediate);
+			client.setFlushPolicy(networking::FlushPolicy::kImmediate);
+
+			const double tick = 1.0 / kSnapshotRate;
+			if (!loopback.connect(benchmark, [&]() { server.update(tick); client.update(tick); }))
+				return;
+
+			networking::Snapshot snapshot;
+			// An animation state, which rarely changes.
+			snapshot.field_bits.push_back(4u);
+			double collect_ms = 0.0;
+			double client_ms  = 0.0;
+			size_t full_bytes  = 0u;
+			size_t delta_bytes = 0u;
+			uint32_t delivered = 0u;
+			for (uint32_t t = 0u; t < kSnapshotTicks; ++t)
+			{
+				const float time = (float)t / kSnapshotRate;
+				utilities::Timer cpu;
+				snapshot.time = time;
+				for (uint32_t i = 0u; i < entity_count; ++i)
+				{
+					const float phase = time + (float)i * 0.01f;
+					const glm::vec3 position((float)(i % 256u) * 2.0f + sinf(phase), 0.0f, (float)(i / 256u) * 2.0f + cosf(phase));
+					const float angle = i % 4u == 0u ? phase : (float)i;
+					const glm::quat rotation(cosf(angle * 0.5f), 0.0f, sinf(angle * 0.5f), 0.0f);
+					const uint32_t state = (i + t / 30u) % 3u;
+					snapshot.add(i + 1u, position, rotation, &state);
+				}
+				server.sendSnapshot(snapshot);
+				collect_ms += cpu.elapsed().milliseconds();
+
+				if (t == 0u)
+					full_bytes = server.getSnapshotBytes();
+				else
+					delta_bytes += server.getSnapshotBytes();
+
+				// Waits for the ack, so the next snapshot is a delta against
+				// this one.
+				server.update(tick);
+				utilities::Timer waiting;
+				while (client.getSnapshots().getAck() != t + 1u && waiting.elapsed().milliseconds() < kSnapshotPatience)
+				{
+					utilities::Timer update;
+					client.update(0.0);
+					client_ms += update.elapsed().milliseconds();
+					server.update(0.0);
+				}
+				if (client.getSnapshots().getAck() == t + 1u)
+					delivered++;
+				utilities::Timer update;
+				client.update(tick);
+				client_ms += update.elapsed().milliseconds();
+				server.update(0.0);
+			}
+
+			client.disconnect();
+			server.update(tick);
+
+			const String prefix = toString(entity_count) + " entities ";
+			const double bytes_per_tick = (double)delta_bytes / (double)(kSnapshotTicks - 1u);
+			report(benchmark, (prefix + "server collect and encode").c_str(), collect_ms / (double)kSnapshotTicks, "ms/tick");
+			report(benchmark, (prefix + "client receive and decode").c_str(), client_ms / (double)kSnapshotTicks, "ms/tick");
+			report(benchmark, (prefix + "full snapshot").c_str(), (double)full_bytes, "bytes");
+			report(benchmark, (prefix + "delta per client").c_str(), bytes_per_tick, "bytes/tick");
+			report(benchmark, (prefix + "bandwidth per client").c_str(), bytes_per_tick * kSnapshotRate / 1024.0, "KB/s");
+			report(benchmark, (prefix + "acked").c_str(), 100.0 * (double)delivered / (double)kSnapshotTicks, "%");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// A server and kInterestClients synthetic clients in this process, over
+		// UDP on 127.0.0.1. The entities are spread over a 400 by 400 field and
+		// all of them move. With observers every client looks from its own
+		// spot. The update rate is measured on the first client, for the
+		// entities in the near and the far half of its radius.
+		static void runInterest(const char* benchmark, const char* metric, bool observe, size_t budget)
+		{
+			Loopback loopback(kInterestClients);
+			networking::Server& server = loopback.server;
+			Vector<networking::Client>& clients = loopback.clients;
+			server.setSnapshotBudget(budget);
+			for (networking::Client& client : clients)
+				client.setFlushPolicy(networking::FlushPolicy::kImmediate);
+
+			const double tick = 1.0 / kSnapshotRate;
+			const bool connected = loopback.connect(benchmark, [&]() {
+				server.update(tick);
+				for (networking::Client& client : clients)
+					client.update(tick);
+			});
+			if (!connected)
+				return;
+
+			Vector<glm::vec3> spots(kInterestClients);
+			for (uint32_t c = 0u; c < kInterestClients; ++c)
+			{
+				spots[c] = glm::vec3((float)(c % 4u) * 100.0f + 50.0f, 0.0f, (float)(c / 4u) * 100.0f + 50.0f);
+				if (observe)
+					clients[c].setObservers({ networking::Observer{ spots[c], kInterestRadius } });
+			}
+
+			networking::Snapshot snapshot;
+			UnorderedMap<uint32_t, networking::QuantizedTransform> seen;
+			double server_ms = 0.0;
+			size_t bytes = 0u;
+			size_t entities = 0u;
+			uint32_t near_updates = 0u, near_samples = 0u;
+			uint32_t far_updates  = 0u, far_samples  = 0u;
+			for (uint32_t t = 0u; t < kInterestTicks; ++t)
+			{
+				const float time = (float)t / kSnapshotRate;
+				utilities::Timer cpu;
+				snapshot.time = time;
+				for (uint32_t i = 0u; i < kInterestEntities; ++i)
+				{
+					const float phase = time + (float)i;
+					const glm::vec3 position((float)(i % 100u) * 4.0f + sinf(phase), 0.0f, (float)(i / 100u) * 4.0f + cosf(phase));
+					snapshot.add(i + 1u, position, glm::quat());
+				}
+				server.sendSnapshot(snapshot);
+				server_ms += cpu.elapsed().milliseconds();
+				bytes += server.getSnapshotBytes();
+
+				server.update(tick);
+				for (networking::Client& client : clients)
+					client.update(tick);
+				server.update(0.0);
+
+				// What changed on the first client since the last tick.
+				const networking::SnapshotReceiver& receiver = clients[0].getSnapshots();
+				const networking::Snapshot* latest = receiver.find(receiver.getAck());
+				if (latest == nullptr)
+					continue;
+				entities += latest->size();
+				for (size_t i = 0u; i < latest->size(); ++i)
+				{
+					const float distance = glm::length(networking::dequantizePosition(latest->transforms[i]) - spots[0]);
+					auto it = seen.find(latest->ids[i]);
+					const bool updated = it != seen.end() && !(it->second == latest->transforms[i]);
+					if (distance < kInterestRadius * 0.5f)
+					{
+						near_samples++;
+						near_updates += updated ? 1u : 0u;
+					}
+					else if (distance < kInterestRadius)
+					{
+						far_samples++;
+						far_updates += updated ? 1u : 0u;
+					}
+					seen[latest->ids[i]] = latest->transforms[i];
+				}
+			}
+
+			const String prefix = String(metric) + " ";
+			const double per_client = (double)bytes / (double)kInterestTicks / (double)kInterestClients;
+			report(benchmark, (prefix + "server ms").c_str(), server_ms / (double)kInterestTicks, "ms/tick");
+			report(benchmark, (prefix + "bytes per client").c_str(), per_client, "bytes/tick");
+			report(benchmark, (prefix + "bandwidth per client").c_str(), per_client * kSnapshotRate / 1024.0, "KB/s");
+			report(benchmark, (prefix + "entities per client").c_str(), (double)entities / (double)kInterestTicks, "entities");
+			if (near_samples > 0u)
+				report(benchmark, (prefix + "near update rate").c_str(), kSnapshotRate * (double)near_updates / (double)near_samples, "Hz");
+			if (far_samples > 0u)
+				report(benchmark, (prefix + "far update rate").c_str(), kSnapshotRate * (double)far_updates / (double)far_samples, "Hz");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static double percentile(const Vector<double>& sorted, double fraction)
+		{
+			if (sorted.empty())
+				return 0.0;
+			return sorted[std::min((size_t)(fraction * (double)sorted.size()), sorted.size() - 1u)];
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// A server and a client in this process, over UDP on 127.0.0.1. Each
+		// runs a game loop of its own, on a thread of its own, that updates
+		// once per frame and sleeps out the rest of it, like two processes
+		// would. Every frame the client sends a message with the time on it,
+		// which the server relays back. The round trip includes the time
+		// messages wait for an update and for a tick to be sent.
+		static void runLatency(const char* benchmark, const char* metric, bool threaded, networking::FlushPolicy policy)
+		{
+			auto sleepOut = [](const utilities::Timer& frame_time, double frame) {
+				const double left = frame - frame_time.elapsed().seconds();
+				if (left > 0.0)
+					std::this_thread::sleep_for(std::chrono::duration<double>(left));
+			};
+
+			Loopback loopback;
+			networking::Server& server = loopback.server;
+			networking::Client& client = loopback.clients[0];
+			server.setFlushPolicy(policy);
+			client.setFlushPolicy(policy);
+			server.setThreaded(threaded);
+			client.setThreaded(threaded);
+
+			std::atomic<bool> serving(true);
+			std::thread server_loop([&]() {
+				const double frame = 1.0 / kLatencyServerRate;
+				while (serving)
+				{
+					utilities::Timer frame_time;
+					server.update(frame);
+					sleepOut(frame_time, frame);
+				}
+			});
+
+			const double frame = 1.0 / kLatencyClientRate;
+			const bool connected = loopback.connect(benchmark, [&]() {
+				utilities::Timer frame_time;
+				client.update(frame);
+				sleepOut(frame_time, frame);
+			});
+			if (!connected)
+			{
+				serving = false;
+				server_loop.join();
+				return;
+			}
+
+			utilities::Timer clock;
+			Vector<double> round_trips;
+			Vector<networking::ReceivedPacket> packets;
+			for (uint32_t f = 0u; f < kLatencyPings + kLatencyDrain; ++f)
+			{
+				utilities::Timer frame_time;
+				if (f < kLatencyPings)
+				{
+					networking::MessageWriter ping;
+					ping.write(clock.elapsed().milliseconds());
+					client.sendMessage(networking::kMessageTypeUser, ping);
+				}
+				client.update(frame);
+
+				packets.clear();
+				client.pollPackets(packets);
+				for (networking::ReceivedPacket& packet : packets)
+				{
+					networking::MessageView message;
+					while (packet.next(message))
+					{
+						if (message.type != networking::kMessageTypeUser)
+							continue;
+						networking::MessageReader reader = message.reader();
+						const double sent = reader.read<double>();
+						if (reader.isValid())
+							round_trips.push_back(clock.elapsed().milliseconds() - sent);
+					}
+				}
+				sleepOut(frame_time, frame);
+			}
+
+			client.disconnect();
+			std::this_thread::sleep_for(std::chrono::duration<double>(2.0 / kLatencyServerRate));
+			serving = false;
+			server_loop.join();
+
+			std::sort(round_trips.begin(), round_trips.end());
+			const String prefix = String(metric) + " ";
+			report(benchmark, (prefix + "round trip p50").c_str(), percentile(round_trips, 0.5), "ms");
+			report(benchmark, (prefix + "round trip p90").c_str(), percentile(round_trips, 0.9), "ms");
+			report(benchmark, (prefix + "round trip p99").c_str(), percentile(round_trips, 0.99), "ms");
+			report(benchmark, (prefix + "delivered").c_str(), 100.0 * (double)round_trips.size() / (double)kLatencyPings, "%");
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(NetworkLatency)
+		{
+			ENetScope enet;
+			runLatency("NetworkLatency", "on tick", false, networking::FlushPolicy::kOnTick);
+			runLatency("NetworkLatency", "immediate", false, networking::FlushPolicy::kImmediate);
+			runLatency("NetworkLatency", "thread on tick", true, networking::FlushPolicy::kOnTick);
+			runLatency("NetworkLatency", "thread immediate", true, networking::FlushPolicy::kImmediate);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(NetworkInterest)
+		{
+			ENetScope enet;
+			runInterest("NetworkInterest", "broadcast", false, 0u);
+			runInterest("NetworkInterest", "interest", true, 0u);
+			runInterest("NetworkInterest", "interest 2KB", true, 2048u);
+			runInterest("NetworkInterest", "interest 512B", true, 512u);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(NetworkSnapshots)
+		{
+			ENetScope enet;
+			runSnapshots("NetworkSnapshots", 1000u);
+			runSnapshots("NetworkSnapshots", 10000u);
+			runSnapshots("NetworkSnapshots", 50000u);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(NetworkCodecString)
+		{
+			ENetScope enet;
+			runCodec("NetworkCodecString", legacy::writeTick, legacy::read);
+			runLoopback("NetworkCodecString", "loopback reliable", legacy::writeTick, legacy::read, 1000.0);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(NetworkCodecBinary)
+		{
+			ENetScope enet;
+			binary::k_delivery = networking::Delivery::kReliable;
+			runCodec("NetworkCodecBinary", binary::writeTick, binary::read);
+			runLoopback("NetworkCodecBinary", "loopback reliable", binary::writeTick, binary::read, 1000.0);
+			binary::k_delivery = networking::Delivery::kUnreliableSequenced;
+			runLoopback("NetworkCodecBinary", "loopback unreliable sequenced", binary::writeTick, binary::read, 20.0);
+		}
+	}
+}
@@ -0,0 +1,179 @@
+#include "benchmark.h"
+#include "utils/mt_manager.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace lambda
+{
+	namespace benchmarks
+	{
+		///////////////////////////////////////////////////////////////////////////
+		// The scheduler as it was before the work-stealing rewrite: one thread
+		// per priority, a mutex per priority and sleep_for(1us) spinning.
+		namespace legacy
+		{
+			enum Priority { kLow, kMedium, kHigh, kCritical, kCount };
+			struct FunctionArgument
+			{
+				Function<void(void*)> function;
+				void* argument;
+			};
+			std::atomic<bool> k_alive = { true };
+			Queue<FunctionArgument> k_functions[Priority::kCount];
+			std::atomic<int> k_num_functions[Priority::kCount];
+			std::mutex k_lock[Priority::kCount];
+			std::thread k_worker_threads[Priority::kCount];
+
+			void executeFunctions(Priority priority)
+			{
+				while (true)
+				{
+					Priority selected_priority = Priority::kCount;
+					for (int8_t i = Priority::kCount - 1; i >= priority; --i)
+					{
+						if (k_num_functions[i] > 0)
+						{
+							selected_priority = (Priority)i;
+							break;
+						}
+					}
+
+					if (selected_priority == Priority::kCount && k_alive)
+					{
+						std::this_thread::sleep_for(std::chrono::microseconds(1));
+						continue;
+					}
+
+					if (!k_alive)
+						return;
+
+					k_lock[selected_priority].lock();
+					if (k_num_functions[selected_priority] <= 0)
+					{
+						k_lock[selected_priority].unlock();
+						continue;
+					}
+
+					k_num_functions[selected_priority]--;
+					auto function = k_functions[selected_priority].front();
+					k_functions[selected_priority].pop();
+					k_lock[selected_priority].unlock();
+
+					function.function(function.argument);
+				}
+			}
+
+			void queue(Function<void(void*)> function, void* arguments, Priority priority)
+			{
+				k_lock[priority].lock();
+				k_functions[priority].push({ function, arguments });
+				k_num_functions[priority]++;
+				k_lock[priority].unlock();
+
+				if (!k_worker_threads[0].joinable())
+				{
+					k_alive = true;
+					for (uint8_t i = 0u; i < Priority::kCount; ++i)
+						k_worker_threads[i] = std::thread(executeFunctions, (Priority)i);
+				}
+			}
+
+			void terminate()
+			{
+				k_alive = false;
+				for (uint8_t i = 0u; i < Priority::kCount; ++i)
+				{
+					k_worker_threads[i].join();
+					k_functions[i] = {};
+					k_num_functions[i] = 0;
+				}
+			}
+		}
+
+		static constexpr uint32_t kJobCount = 200000u;
+		static constexpr uint32_t kIdleMilliseconds = 1000u;
+		static std::atomic<uint32_t> k_executed;
+
+		///////////////////////////////////////////////////////////////////////////
+		static void smallJob(void*)
+		{
+			uint32_t value = 0u;
+			for (uint32_t i = 0u; i < 64u; ++i)
+				value = value * 1664525u + 1013904223u;
+			doNotOptimize(value);
+			k_executed.fetch_add(1u, std::memory_order_relaxed);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static void rangeJob(uint32_t begin, uint32_t end, void*)
+		{
+			for (uint32_t i = begin; i < end; ++i)
+				smallJob(nullptr);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static double measureIdleCpu()
+		{
+			double cpu_begin = processCpuSeconds();
+			std::this_thread::sleep_for(std::chrono::milliseconds(kIdleMilliseconds));
+			double cpu_end = processCpuSeconds();
+			// Cores kept busy while nothing was queued.
+			return (cpu_end - cpu_begin) / ((double)kIdleMilliseconds / 1000.0);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(TaskSchedulerLegacy)
+		{
+			k_executed = 0u;
+			utilities::Timer timer;
+			for (uint32_t i = 0u; i < kJobCount; ++i)
+				legacy::queue(smallJob, nullptr, (legacy::Priority)(i % legacy::kCount));
+			while (k_executed.load() < kJobCount)
+				std::this_thread::yield();
+			double ms = timer.elapsed().milliseconds();
+
+			report("TaskSchedulerLegacy", "queue throughput", (double)kJobCount / (ms / 1000.0), "jobs/s");
+			report("TaskSchedulerLegacy", "idle cpu", measureIdleCpu(), "cores");
+			legacy::terminate();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LMB_BENCHMARK(TaskSchedulerWorkStealing)
+		{
+			platform::TaskScheduler::initialize();
+			report("TaskSchedulerWorkStealing", "workers", (double)platform::TaskScheduler::getWorkerCount(), "threads");
+
+			// Legacy API through the shim.
+			k_executed = 0u;
+			utilities::Timer timer;
+			for (uint32_t i = 0u; i < kJobCount; ++i)
+				platform::TaskScheduler::queue(smallJob, nullptr, (platform::TaskScheduler::Priority)(i % platform::TaskScheduler::kCount));
+			while (k_executed.load() < kJobCount)
+				std::this_thread::yield();
+			double ms = timer.elapsed().milliseconds();
+			report("TaskSchedulerWorkStealing", "queue throughput", (double)kJobCount / (ms / 1000.0), "jobs/s");
+
+			// Counters and helping the workers from the calling thread.
+			k_executed = 0u;
+			platform::TaskScheduler::Counter counter;
+			timer.reset();
+			for (uint32_t i = 0u; i < kJobCount; ++i)
+				platform::TaskScheduler::run(smallJob, nullptr, &counter);
+			platform::TaskScheduler::waitForCounter(&counter);
+			ms = timer.elapsed().milliseconds();
+			report("TaskSchedulerWorkStealing", "run+wait throughput", (double)kJobCount / (ms / 1000.0), "jobs/s");
+
+			// Ranges.
+			k_executed = 0u;
+			timer.reset();
+			platform::TaskScheduler::parallelFor(kJobCount, 1024u, rangeJob, nullptr, &counter);
+			platform::TaskScheduler::waitForCounter(&counter);
+			ms = timer.elapsed().milliseconds();
+			report("TaskSchedulerWorkStealing", "parallelFor throughput", (double)kJobCount / (ms / 1000.0), "items/s");
+
+			report("TaskSchedulerWorkStealing", "idle cpu", measureIdleCpu(), "cores");
+			platform::TaskScheduler::terminate();
+		}
+	}
+}
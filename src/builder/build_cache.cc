@@ -0,0 +1,271 @@
+#include "build_cache.h"
+#include <utils/file_system.h>
+#include <utils/console.h>
+#include <lz4.h>
+#include <xxhash.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#if VIOLET_WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Followed by the size before and after LZ4, and then the artifact.
+  static const char kMagic[4] = { 'L', 'B', 'C', '1' };
+
+  // LZ4 never makes anything more than this many times smaller.
+  static constexpr uint64_t kMaxCompressionRatio = 255u;
+
+  // The fewest bytes a record and a file take up, with empty data, so
+  // counts can be checked before anything is allocated for them.
+  static constexpr uint64_t kMinRecordSize = sizeof(uint64_t) + sizeof(VioletPackBlob) + sizeof(bool) + sizeof(uint64_t);
+  static constexpr uint64_t kMinFileSize   = sizeof(uint64_t) * 2u;
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  template <typename T>
+  static void Write(Vector<char>& buffer, const T& value)
+  {
+    buffer.insert(buffer.end(), (const char*)&value, (const char*)&value + sizeof(T));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void Write(Vector<char>& buffer, const char* data, size_t size)
+  {
+    Write(buffer, (uint64_t)size);
+    buffer.insert(buffer.end(), data, data + size);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Fails instead of reading past the end, as other machines write these.
+  class Reader
+  {
+  public:
+    Reader(const Vector<char>& buffer) : buffer_(buffer), offset_(0u) {}
+
+    template <typename T>
+    bool Read(T& value)
+    {
+      if (buffer_.size() - offset_ < sizeof(T))
+        return false;
+      memcpy(&value, buffer_.data() + offset_, sizeof(T));
+      offset_ += sizeof(T);
+      return true;
+    }
+    template <typename T>
+    bool Read(T& value, uint64_t size)
+    {
+      if (buffer_.size() - offset_ < size)
+        return false;
+      value.resize((size_t)size);
+      memcpy((void*)value.data(), buffer_.data() + offset_, (size_t)size);
+      offset_ += (size_t)size;
+      return true;
+    }
+    uint64_t GetLeft() const
+    {
+      return buffer_.size() - offset_;
+    }
+
+  private:
+    const Vector<char>& buffer_;
+    size_t              offset_;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void MakeFolder(const String& folder)
+  {
+    for (size_t i = 1u; i <= folder.size(); ++i)
+    {
+      if (i != folder.size() && folder[i] != '/')
+        continue;
+
+      const String path = folder.substr(0u, i);
+#if VIOLET_WIN32
+      _mkdir(path.c_str());
+#else
+      mkdir(path.c_str(), 0755);
+#endif
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildCache::SetFolder(const String& folder)
+  {
+    folder_ = FileSystem::FixFilePath(folder);
+    if (folder_.empty())
+      return;
+
+    if (folder_.back() != '/')
+      folder_ += '/';
+    MakeFolder(folder_.substr(0u, folder_.size() - 1u));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool BuildCache::IsEnabled() const
+  {
+    return !folder_.empty();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  uint64_t BuildCache::MakeKey(const String& settings, uint32_t version, const Vector<String>& files)
+  {
+    XXH64_state_t* state = XXH64_createState();
+    XXH64_reset(state, 0u);
+    XXH64_update(state, kMagic, sizeof(kMagic));
+    XXH64_update(state, settings.c_str(), settings.size() + 1u);
+    XXH64_update(state, &version, sizeof(version));
+
+    // The paths go in as well, so moving an include is a change. Sizes
+    // keep the bytes of one file from passing for the next.
+    for (const String& file : files)
+    {
+      XXH64_update(state, file.c_str(), file.size() + 1u);
+      const Vector<char> data = FileSystem::DoesFileExist(file) ? FileSystem::FileToVector(file) : Vector<char>();
+      const uint64_t size = data.size();
+      XXH64_update(state, &size, sizeof(size));
+      XXH64_update(state, data.data(), data.size());
+    }
+
+    const uint64_t key = XXH64_digest(state);
+    XXH64_freeState(state);
+    return key;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool BuildCache::Load(uint64_t key, BuildArtifact& artifact) const
+  {
+    if (!IsEnabled())
+      return false;
+
+    std::ifstream stream(GetPath(key).c_str(), std::ios::binary | std::ios::ate);
+    if (!stream)
+      return false;
+
+    Vector<char> file((size_t)stream.tellg());
+    stream.seekg(0, std::ios::beg);
+    if (!stream.read(file.data(), file.size()))
+      return false;
+
+    Reader header(file);
+    char magic[sizeof(kMagic)];
+    uint64_t size = 0u;
+    uint64_t compressed_size = 0u;
+    if (!header.Read(magic) || memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !header.Read(size) || !header.Read(compressed_size))
+      return false;
+
+    const size_t offset = sizeof(kMagic) + sizeof(uint64_t) * 2u;
+    if (file.size() - offset != compressed_size)
+      return false;
+    if (size > compressed_size * kMaxCompressionRatio || size > (uint64_t)LZ4_MAX_INPUT_SIZE)
+      return false;
+
+    Vector<char> buffer((size_t)size);
+    if (LZ4_decompress_safe(file.data() + offset, buffer.data(), (int)compressed_size, (int)size) != (int)size)
+      return false;
+
+    Reader reader(buffer);
+    uint64_t record_count = 0u;
+    if (!reader.Read(record_count) || record_count > reader.GetLeft() / kMinRecordSize)
+      return false;
+    artifact.records.resize((size_t)record_count);
+    for (VioletAssetRecord& record : artifact.records)
+    {
+      uint64_t data_size = 0u;
+      if (!reader.Read(record.hash) || !reader.Read(record.blob) || !reader.Read(record.removed) ||
+          !reader.Read(data_size) || !reader.Read(record.data, data_size))
+        return false;
+    }
+
+    uint64_t file_count = 0u;
+    if (!reader.Read(file_count) || file_count > reader.GetLeft() / kMinFileSize)
+      return false;
+    artifact.files.resize((size_t)file_count);
+    for (auto& it : artifact.files)
+    {
+      uint64_t name_size = 0u;
+      uint64_t data_size = 0u;
+      if (!reader.Read(name_size) || !reader.Read(it.first, name_size) ||
+          !reader.Read(data_size) || !reader.Read(it.second, data_size))
+        return false;
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildCache::Store(uint64_t key, const BuildArtifact& artifact) const
+  {
+    if (!IsEnabled())
+      return;
+
+    Vector<char> buffer;
+    Write(buffer, (uint64_t)artifact.records.size());
+    for (const VioletAssetRecord& record : artifact.records)
+    {
+      Write(buffer, record.hash);
+      Write(buffer, record.blob);
+      Write(buffer, record.removed);
+      Write(buffer, record.data.data(), record.data.size());
+    }
+    Write(buffer, (uint64_t)artifact.files.size());
+    for (const auto& it : artifact.files)
+    {
+      Write(buffer, it.first.data(), it.first.size());
+      Write(buffer, it.second.data(), it.second.size());
+    }
+
+    Vector<char> file(sizeof(kMagic) + sizeof(uint64_t) * 2u + (size_t)LZ4_compressBound((int)buffer.size()));
+    const int compressed_size = LZ4_compress_default(
+      buffer.data(),
+      file.data() + sizeof(kMagic) + sizeof(uint64_t) * 2u,
+      (int)buffer.size(),
+      (int)(file.size() - sizeof(kMagic) - sizeof(uint64_t) * 2u)
+    );
+    if (compressed_size <= 0)
+      return;
+
+    const uint64_t sizes[2] = { (uint64_t)buffer.size(), (uint64_t)compressed_size };
+    memcpy(file.data(), kMagic, sizeof(kMagic));
+    memcpy(file.data() + sizeof(kMagic), sizes, sizeof(sizes));
+    file.resize(sizeof(kMagic) + sizeof(sizes) + (size_t)compressed_size);
+
+    // Other threads and machines can store the same key at the same time.
+    // Whoever renames last wins, which is fine as the contents match.
+    const String path = GetPath(key);
+    const String temporary = path + "." +
+      toString(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "." +
+      toString(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+    {
+      std::ofstream stream(temporary.c_str(), std::ios::binary | std::ios::trunc);
+      if (!stream.write(file.data(), file.size()))
+      {
+        stream.close();
+        std::remove(temporary.c_str());
+        foundation::Warning("Could not write to the build cache: " + temporary + "\n");
+        return;
+      }
+    }
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+      // Windows does not replace files that exist.
+      std::remove(temporary.c_str());
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  String BuildCache::GetPath(uint64_t key) const
+  {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return folder_ + name + ".lbc";
+  }
+}
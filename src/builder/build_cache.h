@@ -0,0 +1,38 @@
+#pragma once
+#include <assets/base_asset_manager.h>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // What one compile did: its writes to the pack, and the files that it
+  // wrote next to the source, like the textures embedded in a mesh.
+  struct BuildArtifact
+  {
+    Vector<VioletAssetRecord>          records;
+    Vector<Pair<String, Vector<char>>> files;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Compiled assets, keyed on the bytes of everything that went into them.
+  // Every key is a file of its own in a plain folder. Files are written
+  // under a temporary name and then renamed, so the folder can be shared
+  // between machines while they use it.
+  class BuildCache
+  {
+  public:
+    // An empty folder turns the cache off.
+    void SetFolder(const String& folder);
+    bool IsEnabled() const;
+
+    // Hashes the settings, the compiler version and the path and bytes of
+    // every file, in order.
+    static uint64_t MakeKey(const String& settings, uint32_t version, const Vector<String>& files);
+    bool Load(uint64_t key, BuildArtifact& artifact) const;
+    void Store(uint64_t key, const BuildArtifact& artifact) const;
+
+  private:
+    String GetPath(uint64_t key) const;
+
+    String folder_;
+  };
+}
@@ -0,0 +1,211 @@
+#include "build_state.h"
+#include <utils/file_system.h>
+#include <utils/console.h>
+#include <cstring>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static const char* kTimeStampFile = "generated/timestamps";
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildState::Read()
+  {
+    time_stamps_.clear();
+    if (!FileSystem::DoesFileExist(kTimeStampFile))
+    {
+      foundation::Error("Could not open file: " + String(kTimeStampFile) + ".\n");
+      return;
+    }
+
+    // One "time_stamp file" pair per line.
+    const String data = FileSystem::FileToString(kTimeStampFile);
+    size_t offset = 0u;
+    while (offset < data.size())
+    {
+      size_t end = data.find('\n', offset);
+      if (end == String::npos)
+        end = data.size();
+
+      const size_t space = data.find(' ', offset);
+      if (space != String::npos && space < end)
+      {
+        const String time_stamp = data.substr(offset, space - offset);
+        const String file       = data.substr(space + 1u, end - space - 1u);
+        time_stamps_[file] = std::stoull(time_stamp.c_str());
+      }
+      offset = end + 1u;
+    }
+    dirty_ = false;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildState::Write()
+  {
+    if (!dirty_)
+      return;
+
+    String data;
+    for (const auto& it : time_stamps_)
+      data += toString(it.second) + " " + it.first + "\n";
+
+    FileSystem::WriteFile(kTimeStampFile, data.data(), data.size());
+    dirty_ = false;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool BuildState::HasFile(const String& file) const
+  {
+    return time_stamps_.find(file) != time_stamps_.end();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  uint64_t BuildState::GetTimeStamp(const String& file) const
+  {
+    auto it = time_stamps_.find(file);
+    return it == time_stamps_.end() ? 0u : it->second;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildState::SetTimeStamp(const String& file, uint64_t time_stamp)
+  {
+    auto it = time_stamps_.find(file);
+    if (it != time_stamps_.end() && it->second == time_stamp)
+      return;
+
+    time_stamps_[file] = time_stamp;
+    dirty_ = true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildState::RemoveFile(const String& file)
+  {
+    auto it = time_stamps_.find(file);
+    if (it != time_stamps_.end())
+    {
+      time_stamps_.erase(it);
+      dirty_ = true;
+    }
+
+    // Files that include it keep their edge, so they rebuild when it
+    // comes back.
+    SetDependencies(file, Vector<String>());
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  Vector<String> BuildState::GetFiles() const
+  {
+    Vector<String> files;
+    files.reserve(time_stamps_.size());
+    for (const auto& it : time_stamps_)
+      files.push_back(it.first);
+    return files;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildState::SetDependencies(const String& file, const Vector<String>& dependencies)
+  {
+    auto it = dependencies_.find(file);
+    if (it != dependencies_.end())
+    {
+      for (const String& dependency : it->second)
+      {
+        Vector<String>& dependents = dependents_[dependency];
+        auto dependent = eastl::find(dependents.begin(), dependents.end(), file);
+        if (dependent != dependents.end())
+          dependents.erase(dependent);
+      }
+      dependencies_.erase(it);
+    }
+
+    if (dependencies.empty())
+      return;
+
+    dependencies_[file] = dependencies;
+    for (const String& dependency : dependencies)
+      dependents_[dependency].push_back(file);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildState::GetDependencies(const String& file, Set<String>& dependencies) const
+  {
+    auto it = dependencies_.find(file);
+    if (it == dependencies_.end())
+      return;
+
+    for (const String& dependency : it->second)
+      if (dependencies.insert(dependency).second)
+        GetDependencies(dependency, dependencies);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void BuildState::GetDependents(const String& file, Set<String>& dependents) const
+  {
+    auto it = dependents_.find(file);
+    if (it == dependents_.end())
+      return;
+
+    for (const String& dependent : it->second)
+      if (dependents.insert(dependent).second)
+        GetDependents(dependent, dependents);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static String GetFolder(const String& file)
+  {
+    const size_t slash = file.find_last_of('/');
+    return slash == String::npos ? String() : file.substr(0u, slash + 1u);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Every string that follows the key, up to the closing quote.
+  static void FindQuoted(const String& source, const char* key, const String& folder, Vector<String>& found)
+  {
+    size_t offset = 0u;
+    while ((offset = source.find(key, offset)) != String::npos)
+    {
+      offset += strlen(key);
+      const size_t begin = source.find('"', offset);
+      const size_t line  = source.find('\n', offset);
+      if (begin == String::npos || (line != String::npos && line < begin))
+        continue;
+      const size_t end = source.find('"', begin + 1u);
+      if (end == String::npos || (line != String::npos && line < end))
+        continue;
+
+      // Embedded buffers are part of the file itself.
+      const String path = source.substr(begin + 1u, end - begin - 1u);
+      if (!path.empty() && path.find("data:") != 0u)
+        found.push_back(FileSystem::FixFilePath(folder + path));
+      offset = end + 1u;
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  Vector<String> BuildState::ScanDependencies(const String& file)
+  {
+    Vector<String> dependencies;
+    const String extension = FileSystem::GetExtension(file);
+    if (extension != "fx" && extension != "fxh" && extension != "gltf")
+      return dependencies;
+    if (!FileSystem::DoesFileExist(file))
+      return dependencies;
+
+    // Includes are relative to the file that includes them, the same as
+    // in the shader compiler.
+    const String source = FileSystem::FileToString(file);
+    if (extension != "gltf")
+    {
+      FindQuoted(source, "#include", GetFolder(file), dependencies);
+      return dependencies;
+    }
+
+    // Images are only referred to by name, the buffers are read.
+    Vector<String> uris;
+    FindQuoted(source, "\"uri\"", GetFolder(file), uris);
+    for (const String& uri : uris)
+      if (FileSystem::GetExtension(uri) == "bin")
+        dependencies.push_back(uri);
+    return dependencies;
+  }
+}
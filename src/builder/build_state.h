@@ -0,0 +1,40 @@
+#pragma once
+#include <containers/containers.h>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // What the builder knows about the source files. The time stamps that
+  // were built last are kept in generated/timestamps. The dependencies are
+  // found again on every start, as they are cheap to scan.
+  class BuildState
+  {
+  public:
+    void Read();
+    // Only writes when something changed since the last write.
+    void Write();
+
+    bool HasFile(const String& file) const;
+    // Files that were never built have a time stamp of 0.
+    uint64_t GetTimeStamp(const String& file) const;
+    void SetTimeStamp(const String& file, uint64_t time_stamp);
+    void RemoveFile(const String& file);
+    Vector<String> GetFiles() const;
+
+    // Replaces what the file includes or references.
+    void SetDependencies(const String& file, const Vector<String>& dependencies);
+    // Adds every file that the file depends on, directly or through others.
+    void GetDependencies(const String& file, Set<String>& dependencies) const;
+    // Adds every file that depends on the file, directly or through others.
+    void GetDependents(const String& file, Set<String>& dependents) const;
+
+    // The includes of shaders and the buffers of glTF files.
+    static Vector<String> ScanDependencies(const String& file);
+
+  private:
+    UnorderedMap<String, uint64_t>       time_stamps_;
+    UnorderedMap<String, Vector<String>> dependencies_;
+    UnorderedMap<String, Vector<String>> dependents_;
+    bool                                 dirty_ = false;
+  };
+}
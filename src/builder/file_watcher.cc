@@ -0,0 +1,260 @@
+#include "file_watcher.h"
+#include <memory/memory.h>
+#include <utils/file_system.h>
+
+#if VIOLET_WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif VIOLET_LINUX
+#include <sys/inotify.h>
+#include <dirent.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace lambda
+{
+#if VIOLET_WIN32
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  struct FileWatcher::Platform
+  {
+    HANDLE     directory  = INVALID_HANDLE_VALUE;
+    HANDLE     event      = NULL;
+    OVERLAPPED overlapped = {};
+    // Changes that do not fit are lost, which Wait() reports.
+    alignas(DWORD) char buffer[64u * 1024u];
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static bool ReadChanges(FileWatcher::Platform& platform)
+  {
+    ZeroMemory(&platform.overlapped, sizeof(platform.overlapped));
+    platform.overlapped.hEvent = platform.event;
+    return ReadDirectoryChangesW(
+      platform.directory,
+      platform.buffer,
+      (DWORD)sizeof(platform.buffer),
+      TRUE,
+      FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+      NULL,
+      &platform.overlapped,
+      NULL
+    ) != FALSE;
+  }
+#elif VIOLET_LINUX
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  struct FileWatcher::Platform
+  {
+    int                          fd = -1;
+    String                       root;
+    // inotify does not watch recursively, so every folder has a watch.
+    UnorderedMap<int, String>    folders;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void WatchFolder(FileWatcher::Platform& platform, const String& folder)
+  {
+    const String path = platform.root + folder;
+    const int watch = inotify_add_watch(
+      platform.fd,
+      path.c_str(),
+      IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+    );
+    if (watch < 0)
+      return;
+    platform.folders[watch] = folder;
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir)
+      return;
+    while (dirent* entry = readdir(dir))
+    {
+      if (entry->d_type == DT_DIR && entry->d_name[0] != '.')
+        WatchFolder(platform, folder + entry->d_name + "/");
+    }
+    closedir(dir);
+  }
+#else
+  struct FileWatcher::Platform {};
+#endif
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  FileWatcher::FileWatcher()
+    : platform_(nullptr)
+  {
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  FileWatcher::~FileWatcher()
+  {
+    Stop();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool FileWatcher::Start(const String& folder)
+  {
+    Stop();
+
+#if VIOLET_WIN32
+    platform_ = foundation::Memory::construct<Platform>();
+    platform_->directory = CreateFileA(
+      folder.c_str(),
+      FILE_LIST_DIRECTORY,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      NULL,
+      OPEN_EXISTING,
+      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+      NULL
+    );
+    platform_->event = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (platform_->directory == INVALID_HANDLE_VALUE || platform_->event == NULL || !ReadChanges(*platform_))
+    {
+      Stop();
+      return false;
+    }
+    return true;
+#elif VIOLET_LINUX
+    platform_ = foundation::Memory::construct<Platform>();
+    platform_->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (platform_->fd < 0)
+    {
+      Stop();
+      return false;
+    }
+    platform_->root = FileSystem::FixFilePath(folder);
+    if (!platform_->root.empty() && platform_->root.back() != '/')
+      platform_->root += '/';
+    WatchFolder(*platform_, "");
+    if (platform_->folders.empty())
+    {
+      Stop();
+      return false;
+    }
+    return true;
+#else
+    (void)folder;
+    return false;
+#endif
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void FileWatcher::Stop()
+  {
+    if (!platform_)
+      return;
+
+#if VIOLET_WIN32
+    if (platform_->directory != INVALID_HANDLE_VALUE)
+    {
+      DWORD bytes = 0u;
+      if (CancelIoEx(platform_->directory, &platform_->overlapped) || GetLastError() != ERROR_NOT_FOUND)
+        GetOverlappedResult(platform_->directory, &platform_->overlapped, &bytes, TRUE);
+      CloseHandle(platform_->directory);
+    }
+    if (platform_->event != NULL)
+      CloseHandle(platform_->event);
+#elif VIOLET_LINUX
+    if (platform_->fd >= 0)
+      close(platform_->fd);
+#endif
+
+    foundation::Memory::destruct(platform_);
+    platform_ = nullptr;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool FileWatcher::IsWatching() const
+  {
+    return platform_ != nullptr;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool FileWatcher::Wait(Vector<String>& changed, uint32_t timeout_ms)
+  {
+    if (!platform_)
+      return false;
+
+#if VIOLET_WIN32
+    if (WaitForSingleObject(platform_->event, timeout_ms) != WAIT_OBJECT_0)
+      return true;
+
+    DWORD bytes = 0u;
+    const bool complete = GetOverlappedResult(platform_->directory, &platform_->overlapped, &bytes, FALSE) != FALSE;
+
+    // No bytes means the buffer overflowed.
+    bool lost = !complete || bytes == 0u;
+    if (!lost)
+    {
+      const char* it = platform_->buffer;
+      while (true)
+      {
+        const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)it;
+        const int length = (int)(info->FileNameLength / sizeof(WCHAR));
+        const int size = WideCharToMultiByte(CP_UTF8, 0, info->FileName, length, NULL, 0, NULL, NULL);
+        String file(size, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, info->FileName, length, (char*)file.data(), size, NULL, NULL);
+        changed.push_back(FileSystem::FixFilePath(file));
+
+        if (info->NextEntryOffset == 0u)
+          break;
+        it += info->NextEntryOffset;
+      }
+    }
+
+    ResetEvent(platform_->event);
+    if (!ReadChanges(*platform_))
+    {
+      Stop();
+      return false;
+    }
+    return !lost;
+#elif VIOLET_LINUX
+    pollfd fd = { platform_->fd, POLLIN, 0 };
+    if (poll(&fd, 1, (int)timeout_ms) <= 0)
+      return true;
+
+    bool lost = false;
+    alignas(inotify_event) char buffer[16u * 1024u];
+    ssize_t bytes;
+    while ((bytes = read(platform_->fd, buffer, sizeof(buffer))) > 0)
+    {
+      for (const char* it = buffer; it < buffer + bytes;)
+      {
+        const inotify_event* event = (const inotify_event*)it;
+        it += sizeof(inotify_event) + event->len;
+
+        if ((event->mask & IN_Q_OVERFLOW))
+        {
+          lost = true;
+          continue;
+        }
+        if ((event->mask & IN_IGNORED))
+        {
+          platform_->folders.erase(event->wd);
+          continue;
+        }
+
+        auto folder = platform_->folders.find(event->wd);
+        if (folder == platform_->folders.end() || event->len == 0u)
+          continue;
+
+        const String file = folder->second + event->name;
+        if ((event->mask & IN_ISDIR))
+        {
+          // Whatever the folder holds already was never reported.
+          if ((event->mask & (IN_CREATE | IN_MOVED_TO)))
+            WatchFolder(*platform_, file + "/");
+          lost = true;
+        }
+        else
+          changed.push_back(file);
+      }
+    }
+    return !lost;
+#else
+    (void)changed;
+    (void)timeout_ms;
+    return false;
+#endif
+  }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <containers/containers.h>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Tells which files below a folder changed, from the change notifications
+  // of the OS. ReadDirectoryChangesW on Windows and inotify on Linux. Start()
+  // fails on other platforms, in which case the folder has to be polled.
+  class FileWatcher
+  {
+  public:
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool Start(const String& folder);
+    void Stop();
+    bool IsWatching() const;
+    // Waits at most timeout_ms for changes and adds the files that changed,
+    // relative to the folder. Files can be added more than once. Returns
+    // false when changes were lost and the folder has to be scanned again.
+    bool Wait(Vector<String>& changed, uint32_t timeout_ms);
+
+    // Defined per platform in the .cc.
+    struct Platform;
+
+  private:
+    Platform* platform_;
+  };
+}
@@ -1,10 +1,17 @@
 #include <memory/memory.h>
 #include <utils/console.h>
 #include <utils/file_system.h>
+#include <compilers/compile_pool.h>
 #include <compilers/texture_compiler.h>
 #include <compilers/wave_compiler.h>
 #include <compilers/shader_compiler.h>
 #include <compilers/mesh_compiler.h>
+#include <utils/timer.h>
+#include "build_cache.h"
+#include "build_state.h"
+#include "file_watcher.h"
+#include <cstdlib>
+#include <cstring>
 #include <thread>
 #include <stb_image.h>
 #include <stb_image_write.h>
@@ -216,175 +223,116 @@ void SendMessage()
 
 
 
-class TimeStampManager
+enum class AssetType : uint32_t
 {
-public:
-  TimeStampManager()
-  {
-    read();
-  }
-  void read()
-  {
-    if (!lambda::FileSystem::DoesFileExist("generated/timestamps"))
-    {
-      lambda::foundation::Error("Could not open file: generated/timestamps.\n");
-      return;
-    }
-    lambda::Vector<char> data = lambda::FileSystem::FileToVector("generated/timestamps");
-    uint32_t offset = 0u;
-    while (offset < data.size())
-    {
-      lambda::Vector<char> time_stamp_vec(data.begin() + offset, std::find(data.begin() + offset, data.end(), ' '));
-      lambda::String time_stamp(time_stamp_vec.size(), '\0');
-      memcpy((void*)time_stamp.data(), time_stamp_vec.data(), time_stamp_vec.size());
-      offset += (uint32_t)time_stamp.size() + 1u;
-      lambda::Vector<char> file_name_vec(data.begin() + offset, std::find(data.begin() + offset, data.end(), '\n'));
-      lambda::String file_name(file_name_vec.size(), '\0');
-      memcpy((void*)file_name.data(), file_name_vec.data(), file_name_vec.size());
-      offset += (uint32_t)file_name.size() + 1u;
-
-      // Add the file name and time stamp.
-      file_names_.push_back(file_name);
-      time_stamps_.push_back(std::stoull(time_stamp.c_str()));
-    }
-  }
-  void write()
-  {
-    // Get the size of the data.
-    uint32_t size = 0u;
-    for (uint32_t i = 0u; i < file_names_.size(); ++i)
-    {
-      size += (uint32_t)lambda::toString(time_stamps_[i]).size() + 1u;
-      size += (uint32_t)file_names_[i].size() + 1u;
-    }
+  kTexture,
+  kWave,
+  kShader,
+  kMesh,
+  kCount,
+  // Tracked, but nothing is compiled from it.
+  kOther = kCount,
+};
 
-    lambda::Vector<char> data(size);
-    uint32_t offset = 0u;
+static const char* kAssetTags[(uint32_t)AssetType::kCount] = { "[TEX]", "[WAV]", "[SHA]", "[MSH]" };
 
-    // Write the data.
-    for (uint32_t i = 0u; i < file_names_.size(); ++i)
-    {
-      lambda::String time_stamp = lambda::toString(time_stamps_[i]);
-      memcpy(data.data() + offset, time_stamp.data(), time_stamp.size());
-      offset += (uint32_t)time_stamp.size();
-      memset(data.data() + offset, ' ', 1u);
-      offset += 1u;
-      memcpy(data.data() + offset, file_names_[i].data(), file_names_[i].size());
-      offset += (uint32_t)file_names_[i].size();
-      memset(data.data() + offset, '\n', 1u);
-      offset += 1u;
-    }
+AssetType getAssetType(const lambda::String& extension)
+{
+  if (extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "hdr")
+    return AssetType::kTexture;
+  if (extension == "wav")
+    return AssetType::kWave;
+  if (extension == "fx")
+    return AssetType::kShader;
+  if (extension == "gltf" || extension == "glb")
+    return AssetType::kMesh;
+  return AssetType::kOther;
+}
 
-    // Write the file.
-    lambda::FileSystem::WriteFile("generated/timestamps", data);
-  }
+struct Compilers
+{
+  lambda::VioletTextureCompiler texture;
+  lambda::VioletWaveCompiler    wave;
+  lambda::VioletShaderCompiler  shader;
+  lambda::VioletMeshCompiler    mesh;
+  lambda::TextureQuality        texture_quality = lambda::TextureQuality::kNormal;
+  uint32_t                      lod_count = lambda::MeshCompileInfo().lod_count;
 
-  bool hasFileChanged(const lambda::String& file_name) const
-  {
-    for (uint32_t i = 0u; i < file_names_.size(); ++i)
-      if (file_name == file_names_[i])
-        return hasFileChanged(i);
-    return false;
-  }
-  bool hasFileChanged(const uint32_t index) const
+  // What the compilers are told besides the file, for the build cache key.
+  lambda::String getSettings(AssetType type) const
   {
-    return lambda::FileSystem::GetTimeStamp(file_names_[index]) != time_stamps_[index];
+    if (type == AssetType::kTexture)
+      return "|quality " + lambda::toString((uint32_t)texture_quality);
+    if (type == AssetType::kMesh)
+      return "|lods " + lambda::toString(lod_count);
+    return lambda::String();
   }
-  void updateTimeStap(const lambda::String& file_name)
+  uint32_t getVersion(AssetType type) const
   {
-    for (uint32_t i = 0u; i < file_names_.size(); ++i)
+    switch (type)
     {
-      if (file_name == file_names_[i])
-      {
-        updateTimeStap(i);
-        return;
-      }
+    case AssetType::kTexture: return lambda::VioletTextureCompiler::kVersion;
+    case AssetType::kWave:    return lambda::VioletWaveCompiler::kVersion;
+    case AssetType::kShader:  return lambda::VioletShaderCompiler::kVersion;
+    case AssetType::kMesh:    return lambda::VioletMeshCompiler::kVersion;
+    default: return 0u;
     }
   }
-  void updateTimeStap(const uint32_t index)
+  void replay(AssetType type, const lambda::Vector<lambda::VioletAssetRecord>& records)
   {
-    const uint64_t time_stamp = lambda::FileSystem::GetTimeStamp(file_names_[index]);
-    if (time_stamp != time_stamps_[index])
+    switch (type)
     {
-      time_stamps_[index] = time_stamp;
-      write();
+    case AssetType::kTexture: texture.Replay(records); break;
+    case AssetType::kWave:    wave.Replay(records);    break;
+    case AssetType::kShader:  shader.Replay(records);  break;
+    case AssetType::kMesh:    mesh.Replay(records);    break;
+    default: break;
     }
   }
-  const lambda::Vector<lambda::String>& getFiles() const
-  {
-    return file_names_;
-  }
-  bool hasFile(lambda::String file_name) const
-  {
-    return (eastl::find(file_names_.begin(), file_names_.end(), file_name) != file_names_.end());
-  }
-  void addFile(lambda::String file_name)
+  void save(AssetType type)
   {
-    if (hasFile(file_name))
-      return;
-
-    file_names_.push_back(file_name);
-    time_stamps_.push_back(0u);
-    write();
-  }
-  void removeFile(lambda::String file_name)
-  {
-    if (!hasFile(file_name))
-      return;
-
-    for (uint32_t i = 0u; i < file_names_.size(); ++i)
+    switch (type)
     {
-      if (file_names_[i] == file_name)
-      {
-        file_names_.erase(file_names_.begin() + i);
-        time_stamps_.erase(time_stamps_.begin() + i);
-        write();
-        return;
-      }
+    case AssetType::kTexture: texture.Save(); break;
+    case AssetType::kWave:    wave.Save();    break;
+    case AssetType::kShader:  shader.Save();  break;
+    case AssetType::kMesh:    mesh.Save();    break;
+    default: break;
     }
   }
-
-private:
-  lambda::Vector<lambda::String> file_names_;
-  lambda::Vector<uint64_t>       time_stamps_;
 };
 
-void removeFile(
-	const lambda::String& file, 
-	lambda::VioletTextureCompiler texture_compiler, 
-	lambda::VioletWaveCompiler wave_compiler,
-	lambda::VioletShaderCompiler shader_compiler,
-	lambda::VioletMeshCompiler mesh_compiler)
+void removeFile(const lambda::String& file, Compilers& compilers)
 {
   lambda::String extension = lambda::FileSystem::GetExtension(file);
-  if (extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "hdr")
+  switch (getAssetType(extension))
   {
-    texture_compiler.RemoveTexture(texture_compiler.GetHash(file));
+  case AssetType::kTexture:
+    compilers.texture.RemoveTexture(compilers.texture.GetHash(file));
     lambda::foundation::Info("[TEX] " + file + " removed!\n");
-  }
-  else if (extension == "wav")
-  {
-    wave_compiler.RemoveWave(wave_compiler.GetHash(file));
-	lambda::foundation::Info("[WAV] " + file + " removed!\n");
-  }
-  else if (extension == "fx")
-  {
-    shader_compiler.RemoveShader(shader_compiler.GetHash(file));
-	lambda::foundation::Info("[SHA] " + file + " removed!\n");
-  }
-  else if (extension == "gltf" || extension == "glb")
-  {
-    mesh_compiler.RemoveMesh(mesh_compiler.GetHash(file));
-	lambda::foundation::Info("[MSH] " + file + " removed!\n");
-  }
-  else if (extension == "fxh")
+    return;
+  case AssetType::kWave:
+    compilers.wave.RemoveWave(compilers.wave.GetHash(file));
+    lambda::foundation::Info("[WAV] " + file + " removed!\n");
+    return;
+  case AssetType::kShader:
+    compilers.shader.RemoveShader(compilers.shader.GetHash(file));
+    lambda::foundation::Info("[SHA] " + file + " removed!\n");
+    return;
+  case AssetType::kMesh:
+    compilers.mesh.RemoveMesh(compilers.mesh.GetHash(file));
+    lambda::foundation::Info("[MSH] " + file + " removed!\n");
+    return;
+  default:
+    break;
+  }
+
+  if (extension == "fxh")
     Warning("[SHA] " + file + " removed!\n");
   else if (extension == "as")
     Warning("[AS-] " + file + " removed!\n");
   else if (extension == "wren")
     Warning("[WRE] " + file + " removed!\n");
-  else if (extension == "glb")
-    Warning("[MDL] " + file + " removed!\n");
   else if (extension == "ttf")
     Warning("[FNT] " + file + " removed!\n");
   else if (extension == "txt")
@@ -451,7 +399,9 @@ public:
 	int w = 0, h = 0, c = 0;
 };
 
-void handleDMRA(const lambda::String& file, const lambda::String& extension)
+// Merges the loose maps into a DMRA texture. Returns the file it wrote, if
+// any, which has to be compiled as well.
+lambda::String handleDMRA(const lambda::String& file, const lambda::String& extension)
 {
 	bool is_ao  = file.find("_ao."  + extension) != lambda::String::npos;
 	bool is_dis = file.find("_dis." + extension) != lambda::String::npos;
@@ -488,109 +438,139 @@ void handleDMRA(const lambda::String& file, const lambda::String& extension)
 		lambda::String output_file = lambda::FileSystem::FullFilePath(file_base + "_dmra.png");
 		stbi_write_png(output_file.c_str(), w, h, 4, data, w * 4);
 		lambda::foundation::Memory::deallocate(data);
+		return file_base + "_dmra.png";
 	}
+	return lambda::String();
 }
 
-
-bool updateFile(
-	const lambda::String& file, 
-	lambda::VioletTextureCompiler texture_compiler, 
-	lambda::VioletWaveCompiler wave_compiler,
-	lambda::VioletShaderCompiler shader_compiler,
-	lambda::VioletMeshCompiler mesh_compiler)
+// Runs on the build threads. The compilers only share their packs, which
+// lock themselves. Saving is left to the end of the batch.
+bool compileFile(const lambda::String& file, AssetType type, Compilers& compilers)
 {
-  lambda::String extension = lambda::FileSystem::GetExtension(file);
-  if (extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "hdr")
+  switch (type)
+  {
+  case AssetType::kTexture:
   {
-		handleDMRA(file, extension);
-
-    lambda::foundation::Info("[TEX] " + file + "\n");
-    lambda::foundation::Info("\tCompiling...\n");
-
     lambda::TextureCompileInfo compile_info{};
-    compile_info.file = file;
-    
-	if (texture_compiler.Compile(compile_info))
-	{
-      lambda::foundation::Info("\tCompiled!\n");
-      texture_compiler.Save();
-      lambda::foundation::Info("\tSaved!\n");
-	  return true;
-	}
-	else
-	{
-	  lambda::foundation::Info("\tCompilation failed!\n");
-	  return false;
-	}
+    compile_info.file    = file;
+    compile_info.quality = compilers.texture_quality;
+    return compilers.texture.Compile(compile_info);
   }
-  else if (extension == "wav")
+  case AssetType::kWave:
   {
-    lambda::foundation::Info("[WAV] " + file + "\n");
-    lambda::foundation::Info("\tCompiling...\n");
-    
     lambda::WaveCompileInfo compile_info{};
     compile_info.file = file;
-    if (wave_compiler.Compile(compile_info))
-    {
-      lambda::foundation::Info("\tCompiled!\n");
-      wave_compiler.Save();
-      lambda::foundation::Info("\tSaved!\n");
-	  return true;
-	}
-    else
-    {
-      lambda::foundation::Info("\tCompilation failed!\n");
-	  return false;
-	}
+    return compilers.wave.Compile(compile_info);
   }
-  else if (extension == "fx")
+  case AssetType::kShader:
   {
-    lambda::foundation::Info("[SHA] " + file + "\n");
-    lambda::foundation::Info("\tCompiling...\n");
-    
     lambda::ShaderCompileInfo compile_info{};
     compile_info.file = file;
-    if (shader_compiler.Compile(compile_info))
-    {
-      lambda::foundation::Info("\tCompiled!\n");
-      shader_compiler.Save();
-      lambda::foundation::Info("\tSaved!\n");
-	  return true;
-	}
-    else
-    {
-      lambda::foundation::Info("\tCompilation failed!\n");
-	  return false;
-    }
+    return compilers.shader.Compile(compile_info);
   }
-  else if (extension == "gltf" || extension == "glb")
+  case AssetType::kMesh:
   {
-    lambda::foundation::Info("[MSH] " + file + "\n");
-    lambda::foundation::Info("\tCompiling...\n");
-    
     lambda::MeshCompileInfo compile_info{};
-    compile_info.file = file;
-    if (mesh_compiler.Compile(compile_info))
+    compile_info.file      = file;
+    compile_info.lod_count = compilers.lod_count;
+    return compilers.mesh.Compile(compile_info);
+  }
+  default:
+    return true;
+  }
+}
+
+// Everything besides the sources and the compiler versions that changes
+// what is compiled. Part of the build cache key.
+static const lambda::String kCompileSettings =
+#if VIOLET_WIN32
+  "win32"
+#else
+  "posix"
+#endif
+#if VIOLET_SHADER_CONDUCTOR
+  "|shader-conductor"
+#endif
+  ;
+
+// The textures that the mesh compiler wrote out of a mesh that has them
+// embedded. They are numbered from 0 next to the mesh.
+lambda::Vector<lambda::String> getEmbeddedTextures(const lambda::String& file)
+{
+  lambda::Vector<lambda::String> textures;
+  const lambda::String base = lambda::FileSystem::RemoveName(file) + "__" + lambda::FileSystem::FileName(file) + "_";
+  for (uint32_t i = 0u; lambda::FileSystem::DoesFileExist(base + lambda::toString(i) + "__.png"); ++i)
+    textures.push_back(base + lambda::toString(i) + "__.png");
+  return textures;
+}
+
+// Compiles the file, or takes what it compiles to from the cache. Runs on
+// the build threads. Files that were written next to the source are added
+// to written.
+bool buildFile(
+  const lambda::String& file,
+  AssetType type,
+  const lambda::BuildState& state,
+  const lambda::BuildCache& cache,
+  Compilers& compilers,
+  bool& cached,
+  lambda::Vector<lambda::String>& written)
+{
+  uint64_t key = 0u;
+  if (cache.IsEnabled())
+  {
+    lambda::Set<lambda::String> dependencies;
+    state.GetDependencies(file, dependencies);
+    lambda::Vector<lambda::String> inputs(1u, file);
+    inputs.insert(inputs.end(), dependencies.begin(), dependencies.end());
+    key = lambda::BuildCache::MakeKey(kCompileSettings + "|" + kAssetTags[(uint32_t)type] + compilers.getSettings(type), compilers.getVersion(type), inputs);
+
+    lambda::BuildArtifact artifact;
+    if (cache.Load(key, artifact))
     {
-      lambda::foundation::Info("\tCompiled!\n");
-	  mesh_compiler.Save();
-      lambda::foundation::Info("\tSaved!\n");
-	  return true;
-	}
-    else
+      compilers.replay(type, artifact.records);
+      for (const auto& it : artifact.files)
+      {
+        if (lambda::FileSystem::DoesFileExist(it.first) && lambda::FileSystem::FileToVector(it.first) == it.second)
+          continue;
+        lambda::FileSystem::WriteFile(it.first, it.second);
+        written.push_back(it.first);
+      }
+      cached = true;
+      return true;
+    }
+  }
+
+  lambda::BuildArtifact artifact;
+  lambda::VioletBaseAssetManager::StartRecording(&artifact.records);
+  const bool succeeded = compileFile(file, type, compilers);
+  lambda::VioletBaseAssetManager::StopRecording();
+  if (!succeeded)
+    return false;
+
+  if (type == AssetType::kMesh)
+  {
+    for (const lambda::String& texture : getEmbeddedTextures(file))
     {
-      lambda::foundation::Info("\tCompilation failed!\n");
-	  return false;
+      artifact.files.push_back(eastl::make_pair(texture, lambda::FileSystem::FileToVector(texture)));
+      written.push_back(texture);
     }
   }
-  else if (extension == "fxh")
-    Warning("[SHA]" + file + " changed!\n");
+  if (cache.IsEnabled())
+    cache.Store(key, artifact);
+  return true;
+}
+
+// For the files that nothing is compiled from.
+void reportChange(const lambda::String& file)
+{
+  lambda::String extension = lambda::FileSystem::GetExtension(file);
+  if (extension == "fxh")
+    Warning("[SHA] " + file + " changed!\n");
   else if (extension == "as")
     Warning("[AS-] " + file + " changed!\n");
   else if (extension == "wren")
     Warning("[WRE] " + file + " changed!\n");
-  else if (extension == "glb")
-    Warning("[MDL] " + file + " changed!\n");
   else if (extension == "ttf")
     Warning("[FNT] " + file + " changed!\n");
   else if (extension == "txt")
@@ -599,62 +579,339 @@ bool updateFile(
     Warning("[INI] " + file + " changed!\n");
   else
     Debug("[---] " + file + " changed!\n");
-  return true;
 }
 
-int main(int argc, char** argv)
+struct BuildStats
 {
-  //SendMessage();
- 
-  if (argc == 1)
-    LMB_ASSERT(false, "No project folder was speficied!");
-  lambda::FileSystem::SetBaseDir(argv[1]);
-  TimeStampManager time_stamp_manager;
-  lambda::VioletTextureCompiler texture_compiler;
-  lambda::VioletWaveCompiler wave_compiler;
-  lambda::VioletShaderCompiler shader_compiler;
-  lambda::VioletMeshCompiler mesh_compiler;
+  uint32_t built[(uint32_t)AssetType::kCount]        = {};
+  // Out of built, how many came from the cache.
+  uint32_t cached[(uint32_t)AssetType::kCount]       = {};
+  uint32_t failed[(uint32_t)AssetType::kCount]       = {};
+  // Summed over the threads.
+  double   milliseconds[(uint32_t)AssetType::kCount] = {};
+  double   wall_milliseconds                         = 0.0;
+  uint32_t thread_count                              = 0u;
 
-  while (true)
+  uint32_t getBuilt() const
+  {
+    uint32_t count = 0u;
+    for (uint32_t i = 0u; i < (uint32_t)AssetType::kCount; ++i)
+      count += built[i];
+    return count;
+  }
+  uint32_t getFailed() const
   {
-    auto function_start = std::chrono::high_resolution_clock::now();
-    lambda::Vector<lambda::String> previous_files = time_stamp_manager.getFiles();
+    uint32_t count = 0u;
+    for (uint32_t i = 0u; i < (uint32_t)AssetType::kCount; ++i)
+      count += failed[i];
+    return count;
+  }
+  uint32_t getCached() const
+  {
+    uint32_t count = 0u;
+    for (uint32_t i = 0u; i < (uint32_t)AssetType::kCount; ++i)
+      count += cached[i];
+    return count;
+  }
+};
+
+void report(const BuildStats& stats, bool cache)
+{
+  for (uint32_t i = 0u; i < (uint32_t)AssetType::kCount; ++i)
+  {
+    if (stats.built[i] + stats.failed[i] == 0u)
+      continue;
+
+    lambda::foundation::Info(
+      lambda::String(kAssetTags[i]) + " " +
+      lambda::toString(stats.built[i]) + " built (" +
+      lambda::toString(stats.cached[i]) + " cached), " +
+      lambda::toString(stats.failed[i]) + " failed, " +
+      lambda::toString((uint32_t)stats.milliseconds[i]) + "ms\n"
+    );
+  }
 
-    for (lambda::String file : lambda::FileSystem::GetAllFilesInFolderRecursive("", ""))
+  lambda::foundation::Info(
+    "Built " + lambda::toString(stats.getBuilt() + stats.getFailed()) + " assets in " +
+    lambda::toString((uint32_t)stats.wall_milliseconds) + "ms on " +
+    lambda::toString(stats.thread_count) + " threads.\n"
+  );
+
+  // Failed compiles were cache misses as well.
+  if (cache)
+  {
+    lambda::foundation::Info(
+      "Build cache: " + lambda::toString(stats.getCached()) + " hits, " +
+      lambda::toString(stats.getBuilt() + stats.getFailed() - stats.getCached()) + " misses.\n"
+    );
+  }
+}
+
+// Every file on disk, and the ones that were built before so deleted files
+// are noticed.
+lambda::Vector<lambda::String> scanAll(const lambda::BuildState& state)
+{
+  lambda::Vector<lambda::String> files = lambda::FileSystem::GetAllFilesInFolderRecursive("", "");
+  const lambda::Vector<lambda::String> known = state.GetFiles();
+  files.insert(files.end(), known.begin(), known.end());
+  return files;
+}
+
+// Builds the candidates that changed since they were built last, and every
+// file that depends on them. The compiles are spread over all cores. The
+// packs and the time stamps are written once, at the end.
+void build(const lambda::Vector<lambda::String>& candidates, lambda::BuildState& state, const lambda::BuildCache& cache, Compilers& compilers, BuildStats& stats)
+{
+  lambda::utilities::Timer timer;
+  lambda::Set<lambda::String> changed;
+  lambda::Vector<lambda::String> removed;
+  bool dirty[(uint32_t)AssetType::kCount] = {};
+
+  for (const lambda::String& candidate : candidates)
+  {
+    // Make the file relative, so it can be used by the file system.
+    const lambda::String file = lambda::FileSystem::MakeRelative(candidate);
+
+    // Don't track hidden files, or what the builder writes itself.
+    if (lambda::FileSystem::GetExtension(file).empty() || file.find("generated/") == 0u)
+    {
+      // Older versions tracked the generated files as well.
+      if (state.HasFile(file))
+        state.RemoveFile(file);
+      continue;
+    }
+
+    if (!lambda::FileSystem::DoesFileExist(file))
     {
-      // Don't track hidden files.
-      if (lambda::FileSystem::GetExtension(file).empty())
+      if (!state.HasFile(file))
         continue;
 
-      // Make the file relative, so it can be used by the file system.
-      file = lambda::FileSystem::MakeRelative(file);
+      state.RemoveFile(file);
+      removeFile(file, compilers);
+      removed.push_back(file);
+      const AssetType type = getAssetType(lambda::FileSystem::GetExtension(file));
+      if (type != AssetType::kOther)
+        dirty[(uint32_t)type] = true;
+    }
+    else if (!state.HasFile(file) || lambda::FileSystem::GetTimeStamp(file) != state.GetTimeStamp(file))
+      changed.insert(file);
+  }
 
-      // If this file does not exist yet. Add it.
-      if (!time_stamp_manager.hasFile(file))
-        time_stamp_manager.addFile(file);
+  // The merged DMRA textures are written before anything is compiled, as
+  // more than one of their maps can change at once.
+  lambda::Vector<lambda::String> generated;
+  for (const lambda::String& file : changed)
+  {
+    const lambda::String extension = lambda::FileSystem::GetExtension(file);
+    if (getAssetType(extension) == AssetType::kTexture)
+    {
+      const lambda::String output = handleDMRA(file, extension);
+      if (!output.empty())
+        generated.push_back(output);
+    }
+  }
+  changed.insert(generated.begin(), generated.end());
 
-      // Erase this file from the to delete list.
-      lambda::String* it = nullptr;
-      while ((it = std::find(previous_files.begin(), previous_files.end(), file)) != previous_files.end())
-        previous_files.erase(it);
+  lambda::Set<lambda::String> targets = changed;
+  for (const lambda::String& file : changed)
+  {
+    state.SetDependencies(file, lambda::BuildState::ScanDependencies(file));
+    state.GetDependents(file, targets);
+  }
+  for (const lambda::String& file : removed)
+    state.GetDependents(file, targets);
 
-      // Update the file.
-      if (time_stamp_manager.hasFileChanged(file))
-        if (updateFile(file, texture_compiler, wave_compiler, shader_compiler, mesh_compiler))
-		  time_stamp_manager.updateTimeStap(file);
+  struct Job
+  {
+    lambda::String file;
+    AssetType      type;
+    uint64_t       time_stamp;
+    uint64_t       size;
+    bool           succeeded;
+    bool           cached;
+    double         milliseconds;
+    lambda::Vector<lambda::String> written;
+  };
+  lambda::Vector<Job> jobs;
+
+  for (const lambda::String& file : targets)
+  {
+    if (!lambda::FileSystem::DoesFileExist(file))
+      continue;
+
+    // The time stamp is taken before compiling, so changes that are made
+    // while it compiles are built again.
+    const uint64_t time_stamp = lambda::FileSystem::GetTimeStamp(file);
+    const AssetType type = getAssetType(lambda::FileSystem::GetExtension(file));
+    if (type == AssetType::kOther)
+    {
+      if (changed.find(file) != changed.end())
+      {
+        reportChange(file);
+        state.SetTimeStamp(file, time_stamp);
+      }
+      continue;
+    }
+
+    jobs.push_back(Job{ file, type, time_stamp, lambda::FileSystem::GetFileSize(file), false, false, 0.0 });
+  }
+
+  // Largest first, so one large mesh does not keep a thread busy at the end.
+  std::sort(jobs.begin(), jobs.end(), [](const Job& lhs, const Job& rhs) { return lhs.size > rhs.size; });
+
+  // One job at a time, so the workers that are left can help the
+  // compilers split up the last, largest files.
+  lambda::CompilePool::ParallelFor((uint32_t)jobs.size(), 1u, [&jobs, &state, &cache, &compilers](uint32_t first, uint32_t last) {
+    for (uint32_t i = first; i < last; ++i)
+    {
+      Job& job = jobs[i];
+      lambda::utilities::Timer job_timer;
+      job.succeeded    = buildFile(job.file, job.type, state, cache, compilers, job.cached, job.written);
+      job.milliseconds = job_timer.elapsed().milliseconds();
+
+      const lambda::String tag = kAssetTags[(uint32_t)job.type];
+      if (job.succeeded)
+        lambda::foundation::Info(tag + " " + job.file + (job.cached ? " (cached, " : " (") + lambda::toString((uint32_t)job.milliseconds) + "ms)\n");
+      else
+        lambda::foundation::Error(tag + " " + job.file + ": Compilation failed!\n");
+    }
+  });
+  const uint32_t thread_count = jobs.empty() ? 0u : std::min(lambda::CompilePool::GetThreadCount(), (uint32_t)jobs.size());
+
+  // Failed files keep their old time stamp, so they are tried again.
+  lambda::Vector<lambda::String> written;
+  for (const Job& job : jobs)
+  {
+    const uint32_t type = (uint32_t)job.type;
+    stats.milliseconds[type] += job.milliseconds;
+    written.insert(written.end(), job.written.begin(), job.written.end());
+    if (job.succeeded)
+    {
+      stats.built[type]++;
+      stats.cached[type] += job.cached ? 1u : 0u;
+      state.SetTimeStamp(job.file, job.time_stamp);
+    }
+    else
+      stats.failed[type]++;
+    dirty[type] = true;
+  }
+
+  for (uint32_t i = 0u; i < (uint32_t)AssetType::kCount; ++i)
+    if (dirty[i])
+      compilers.save((AssetType)i);
+  state.Write();
+
+  stats.wall_milliseconds += timer.elapsed().milliseconds();
+  stats.thread_count = std::max(stats.thread_count, thread_count);
+
+  // The textures that came out of meshes.
+  if (!written.empty())
+    build(written, state, cache, compilers, stats);
+}
+
+int main(int argc, char** argv)
+{
+  //SendMessage();
+
+  // lambda-builder <project folder> [--once] [--cache <folder>] [--no-cache]
+  //                [--texture-quality fast|normal|high] [--lods <count>]
+  // With --once everything that changed is built, after which it exits. The
+  // exit code is 1 when anything failed to compile, for CI.
+  // The build cache is in generated/cache unless --cache or the
+  // LAMBDA_BUILD_CACHE environment variable point elsewhere, like a share
+  // that the build farm fills. Meshes get up to --lods simplified versions,
+  // 0 turns them off.
+  const char* folder = nullptr;
+  const char* cache_folder = getenv("LAMBDA_BUILD_CACHE");
+  bool once = false;
+  bool use_cache = true;
+  lambda::TextureQuality texture_quality = lambda::TextureQuality::kNormal;
+  uint32_t lod_count = lambda::MeshCompileInfo().lod_count;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--once") == 0)
+      once = true;
+    else if (strcmp(argv[i], "--no-cache") == 0)
+      use_cache = false;
+    else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+      cache_folder = argv[++i];
+    else if (strcmp(argv[i], "--texture-quality") == 0 && i + 1 < argc)
+    {
+      const char* quality = argv[++i];
+      if (strcmp(quality, "fast") == 0)
+        texture_quality = lambda::TextureQuality::kFast;
+      else if (strcmp(quality, "high") == 0)
+        texture_quality = lambda::TextureQuality::kHigh;
+      else
+        texture_quality = lambda::TextureQuality::kNormal;
     }
+    else if (strcmp(argv[i], "--lods") == 0 && i + 1 < argc)
+      lod_count = (uint32_t)atoi(argv[++i]);
+    else
+      folder = argv[i];
+  }
 
-    // Remove all deleted files.
-    for (const lambda::String& file : previous_files)
+  if (folder == nullptr)
+    LMB_ASSERT(false, "No project folder was speficied!");
+  lambda::CompilePool::Initialize(std::max(1u, std::thread::hardware_concurrency()));
+  lambda::FileSystem::SetBaseDir(folder);
+  lambda::BuildState state;
+  state.Read();
+  Compilers compilers;
+  compilers.texture_quality = texture_quality;
+  compilers.lod_count       = lod_count;
+  lambda::BuildCache cache;
+  if (use_cache)
+    cache.SetFolder(cache_folder ? lambda::String(cache_folder) : lambda::FileSystem::FullFilePath("generated/cache/"));
+
+  // Dependencies are not stored, so a change to a header that was made
+  // while the builder was not running still reaches its includers.
+  const lambda::Vector<lambda::String> files = scanAll(state);
+  for (const lambda::String& file : files)
+  {
+    const lambda::String relative = lambda::FileSystem::MakeRelative(file);
+    state.SetDependencies(relative, lambda::BuildState::ScanDependencies(relative));
+  }
+
+  BuildStats stats;
+  build(files, state, cache, compilers, stats);
+  report(stats, cache.IsEnabled());
+  if (once)
+  {
+    lambda::CompilePool::Deinitialize();
+    return stats.getFailed() > 0u ? 1 : 0;
+  }
+
+  lambda::FileWatcher watcher;
+  if (!watcher.Start(lambda::FileSystem::GetBaseDir()))
+    lambda::foundation::Warning("Could not watch the project folder. Polling it every second instead.\n");
+
+  while (true)
+  {
+    lambda::Vector<lambda::String> changed;
+    bool complete = false;
+    if (watcher.IsWatching())
     {
-      time_stamp_manager.removeFile(file);
-      removeFile(file, texture_compiler, wave_compiler, shader_compiler, mesh_compiler);
+      complete = watcher.Wait(changed, 1000u);
+      if (complete && changed.empty())
+        continue;
+
+      // Editors tend to write a file more than once. Wait until it is quiet,
+      // so it is built once.
+      size_t count = 0u;
+      while (complete && changed.size() != count)
+      {
+        count = changed.size();
+        complete = watcher.Wait(changed, 100u);
+      }
     }
+    else
+      std::this_thread::sleep_for(std::chrono::seconds(1));
 
-    // Sleep if we should.
-    auto function_end = std::chrono::high_resolution_clock::now();
-    auto sleep_point = function_start + std::chrono::seconds(1);
-    if (function_end < sleep_point)
-      std::this_thread::sleep_for(sleep_point - function_end);
+    // A full scan when changes were lost, or without a watcher.
+    BuildStats batch;
+    build(complete ? changed : scanAll(state), state, cache, compilers, batch);
+    if (batch.getBuilt() + batch.getFailed() > 0u)
+      report(batch, cache.IsEnabled());
   }
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include "utils/name.h"
 #include <utils/console.h>
+#include <memory/memory.h>
+#include <atomic>
 #include <mutex>
 
 namespace lambda
@@ -12,114 +14,185 @@ namespace lambda
 			kGPUOnly = 1u,
 		};
 
+		///////////////////////////////////////////////////////////////////////////
+		// Shared by all handles of one asset. The name is written once when the
+		// slot is handed out, so it can be read without taking a lock.
+		template<typename T>
+		struct VioletSlot
+		{
+			std::atomic<int32_t> refs;
+			size_t hash    = 0u;
+			T*     data    = nullptr;
+			bool   pending = false;
+			Name   name;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// Hands out the slots of one asset type. Copying and destroying handles
+		// only touches the atomic in the slot. The lock is taken when a handle
+		// is made from a name and when an asset loses its last handle.
+		// Assets without handles are released by collectGarbage(), which runs
+		// once the renderer is done with the frame, so non-owning references in
+		// render lists stay valid until then.
 		template<typename T>
 		class VioletRefHandler
 		{
 		public:
-			static void incRef(const size_t& hash)
+			static VioletSlot<T>* acquire(T* data, const Name& name)
 			{
-				g_mutex.lock();
+				std::lock_guard<std::mutex> lock(g_mutex);
 				LMB_ASSERT(g_valid, "AssetHandle not valid anymore");
 
-				if (hash == 0u)
+				auto it = g_slots.find(name.getHash());
+				if (it != g_slots.end())
 				{
-					g_mutex.unlock();
-					return;
+					// Also brings back assets that are waiting to be released.
+					it->second->refs.fetch_add(1, std::memory_order_relaxed);
+					return it->second;
+				}
+
+				if (g_free.empty())
+				{
+					Chunk* chunk = foundation::Memory::construct<Chunk>();
+					g_chunks.push_back(chunk);
+					for (uint32_t i = kChunkSize; i > 0u; --i)
+						g_free.push_back(&chunk->slots[i - 1u]);
 				}
 
-				g_refs[hash]++;
-				g_mutex.unlock();
+				VioletSlot<T>* slot = g_free.back();
+				g_free.pop_back();
+				slot->refs.store(1, std::memory_order_relaxed);
+				slot->hash    = name.getHash();
+				slot->data    = data;
+				slot->pending = false;
+				slot->name    = name;
+				g_slots.insert(eastl::make_pair(slot->hash, slot));
+				return slot;
+			}
+			static void incRef(VioletSlot<T>* slot)
+			{
+				LMB_ASSERT(g_valid, "AssetHandle not valid anymore");
+				slot->refs.fetch_add(1, std::memory_order_relaxed);
 			}
-			static bool decRef(const size_t& hash)
+			static void decRef(VioletSlot<T>* slot)
 			{
-				g_mutex.lock();
 				LMB_ASSERT(g_valid, "AssetHandle not valid anymore");
+				if (slot->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+					return;
 
-				if (hash == 0u)
+				std::lock_guard<std::mutex> lock(g_mutex);
+				if (!slot->pending)
 				{
-					g_mutex.unlock();
-					return true;
+					slot->pending = true;
+					g_pending.push_back(slot);
+				}
+			}
+			static void collectGarbage()
+			{
+				Vector<VioletSlot<T>*> dead;
+				{
+					std::lock_guard<std::mutex> lock(g_mutex);
+					for (VioletSlot<T>* slot : g_pending)
+					{
+						slot->pending = false;
+						if (slot->refs.load(std::memory_order_acquire) == 0)
+						{
+							g_slots.erase(slot->hash);
+							dead.push_back(slot);
+						}
+					}
+					g_pending.clear();
 				}
 
-				const int ref = --g_refs[hash];
-
-				if (ref <= 0)
+				// Releasing can drop handles to other assets, so it happens without
+				// holding the lock.
+				for (VioletSlot<T>* slot : dead)
 				{
-					g_refs.erase(hash);
-					g_names.erase(hash);
+					foundation::Info("Released \"" + slot->name.getName() + "\"\n");
+					T::release(slot->data, slot->hash);
 				}
-				g_mutex.unlock();
 
-				return ref > 0;
-			}
-			static const Name& getName(const size_t& hash)
-			{
-				g_mutex.lock();
-				LMB_ASSERT(g_valid, "AssetHandle not valid anymore");
-				Name& name = g_names[hash];
-				g_mutex.unlock();
-				return name;
-			}
-			static void tyToSetName(const size_t& hash, const Name& name)
-			{
-				g_mutex.lock();
-				LMB_ASSERT(g_valid, "AssetHandle not valid anymore");
-				if (g_names.find(hash) == g_names.end())
-					g_names[hash] = name;
-				g_mutex.unlock();
+				std::lock_guard<std::mutex> lock(g_mutex);
+				for (VioletSlot<T>* slot : dead)
+				{
+					slot->data = nullptr;
+					slot->name = Name();
+					g_free.push_back(slot);
+				}
 			}
 			static void releaseAll()
 			{
-				g_mutex.lock();
-				g_refs = UnorderedMap<size_t, int>();
-				g_names = UnorderedMap<size_t, Name>();
-				g_valid = false;
+				std::lock_guard<std::mutex> lock(g_mutex);
+				for (Chunk* chunk : g_chunks)
+					foundation::Memory::destruct(chunk);
+				g_chunks  = Vector<Chunk*>();
+				g_free    = Vector<VioletSlot<T>*>();
+				g_pending = Vector<VioletSlot<T>*>();
+				g_slots   = UnorderedMap<size_t, VioletSlot<T>*>();
+				g_valid   = false;
 			}
 
 		private:
+			static constexpr uint32_t kChunkSize = 256u;
+			struct Chunk
+			{
+				VioletSlot<T> slots[kChunkSize];
+			};
+
 			static std::mutex g_mutex;
-			static UnorderedMap<size_t, int> g_refs;
-			static UnorderedMap<size_t, Name> g_names;
+			static UnorderedMap<size_t, VioletSlot<T>*> g_slots;
+			static Vector<Chunk*> g_chunks;
+			static Vector<VioletSlot<T>*> g_free;
+			static Vector<VioletSlot<T>*> g_pending;
 			static bool g_valid;
 		};
 
 
 		template<typename T>
-		UnorderedMap<size_t, int> VioletRefHandler<T>::g_refs;
+		UnorderedMap<size_t, VioletSlot<T>*> VioletRefHandler<T>::g_slots;
+		template<typename T>
+		Vector<typename VioletRefHandler<T>::Chunk*> VioletRefHandler<T>::g_chunks;
+		template<typename T>
+		Vector<VioletSlot<T>*> VioletRefHandler<T>::g_free;
 		template<typename T>
-		UnorderedMap<size_t, Name> VioletRefHandler<T>::g_names;
+		Vector<VioletSlot<T>*> VioletRefHandler<T>::g_pending;
 		template<typename T>
 		bool VioletRefHandler<T>::g_valid = true;
 		template<typename T>
 		std::mutex VioletRefHandler<T>::g_mutex;
 
+		template<typename T>
+		class VioletRef;
 
 		template<typename T>
 		class VioletHandle
 		{
 		public:
 			VioletHandle()
-				: data_(nullptr)
-				, hash_(0ull)
+				: hash_(0ull)
+				, data_(nullptr)
+				, slot_(nullptr)
 			{
 			}
 			VioletHandle(T* data, Name name)
-				: data_(data)
-				, hash_(name.getHash())
+				: hash_(name.getHash())
+				, data_(data)
+				, slot_(nullptr)
 			{
 				if (hash_)
-				{
-					VioletRefHandler<T>::tyToSetName(hash_, name);
-					VioletRefHandler<T>::incRef(hash_);
-				}
+					slot_ = VioletRefHandler<T>::acquire(data_, name);
 			}
 			VioletHandle(const VioletHandle& other)
-				: data_(other.data_)
-				, hash_(other.hash_)
+				: hash_(other.hash_)
+				, data_(other.data_)
+				, slot_(other.slot_)
 			{
-				if (hash_)
-					VioletRefHandler<T>::incRef(hash_);
+				if (slot_)
+					VioletRefHandler<T>::incRef(slot_);
 			}
+			// Takes ownership again. The asset has to still be alive, which is
+			// true for references made during the current frame.
+			VioletHandle(const VioletRef<T>& other);
 			~VioletHandle()
 			{
 				release();
@@ -133,14 +206,14 @@ namespace lambda
 
 				data_ = other.data_;
 				hash_ = other.hash_;
+				slot_ = other.slot_;
 
-				if (hash_)
-					VioletRefHandler<T>::incRef(hash_);
+				if (slot_)
+					VioletRefHandler<T>::incRef(slot_);
 			}
 			void operator=(const std::nullptr_t& /*null*/)
 			{
 				release();
-				data_ = nullptr;
 			}
 			bool operator==(const VioletHandle<T>& other) const
 			{
@@ -193,25 +266,22 @@ namespace lambda
 			}
 			Name getName()
 			{
-				return hash_ ? VioletRefHandler<T>::getName(hash_) : Name();
+				return slot_ ? slot_->name : Name();
 			}
 
 			const Name& getName() const
 			{
 				static Name k_name;
-				return hash_ ? VioletRefHandler<T>::getName(hash_) : k_name;
+				return slot_ ? slot_->name : k_name;
 			}
 
 			void release()
 			{
-				Name name = VioletRefHandler<T>::getName(hash_);
-				if (hash_ && !VioletRefHandler<T>::decRef(hash_))
-				{
-					foundation::Info("Released \"" + name.getName() + "\"\n");
-					T::release(data_, hash_);
-					data_ = nullptr;
-					hash_ = 0ull;
-				}
+				if (slot_)
+					VioletRefHandler<T>::decRef(slot_);
+				data_ = nullptr;
+				hash_ = 0ull;
+				slot_ = nullptr;
 			}
 
 			void metaSet(String name)
@@ -224,8 +294,94 @@ namespace lambda
 			}
 
 		private:
+			friend class VioletRef<T>;
+
+			size_t hash_;
+			T* data_;
+			VioletSlot<T>* slot_;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// Refers to an asset without owning it, so copying one costs nothing.
+		// Meant for lists that are rebuilt every frame, while a VioletHandle
+		// elsewhere keeps the asset alive.
+		template<typename T>
+		class VioletRef
+		{
+		public:
+			VioletRef()
+				: hash_(0ull)
+				, data_(nullptr)
+				, slot_(nullptr)
+			{
+			}
+			VioletRef(const VioletHandle<T>& handle)
+				: hash_(handle.hash_)
+				, data_(handle.data_)
+				, slot_(handle.slot_)
+			{
+			}
+			bool operator==(const VioletRef<T>& other) const
+			{
+				return hash_ == other.hash_;
+			}
+			bool operator!=(const VioletRef<T>& other) const
+			{
+				return hash_ != other.hash_;
+			}
+			bool operator!() const
+			{
+				return data_ == nullptr;
+			}
+			operator bool() const
+			{
+				return data_ != nullptr;
+			}
+			T* operator->() const
+			{
+				return data_;
+			}
+			T* get() const
+			{
+				return data_;
+			}
+			size_t getHash() const
+			{
+				return hash_;
+			}
+			const Name& getName() const
+			{
+				static Name k_name;
+				return slot_ ? slot_->name : k_name;
+			}
+
+			// Only valid while something else owns the asset it is set to.
+			void metaSet(String name)
+			{
+				*this = VioletRef<T>(T::privMetaSet(name));
+			}
+			String metaGet() const
+			{
+				return getName().getName();
+			}
+
+		private:
+			friend class VioletHandle<T>;
+
 			size_t hash_;
 			T* data_;
+			VioletSlot<T>* slot_;
 		};
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		inline VioletHandle<T>::VioletHandle(const VioletRef<T>& other)
+			: hash_(other.hash_)
+			, data_(other.data_)
+			, slot_(other.slot_)
+		{
+			if (slot_)
+				VioletRefHandler<T>::incRef(slot_);
+		}
 	}
 }
@@ -0,0 +1,390 @@
+#include "asset_streamer.h"
+#include <memory/memory.h>
+#include <utils/console.h>
+#include <utils/profiler.h>
+#include <utils/timer.h>
+#include <algorithm>
+
+namespace lambda
+{
+	namespace asset
+	{
+		///////////////////////////////////////////////////////////////////////////
+		// Below this many entries the queue is not worth rebuilding.
+		static constexpr size_t kMinCompactSize = 64u;
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::initialize(uint32_t thread_count)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (alive_)
+				return;
+
+			// Most of the time goes to page faults and LZ4, so a few threads are
+			// enough and leave the job system its cores.
+			if (thread_count == 0u)
+			{
+				const uint32_t hardware_threads = std::thread::hardware_concurrency();
+				thread_count = hardware_threads > 8u ? hardware_threads / 4u : 2u;
+			}
+
+			alive_ = true;
+			for (uint32_t i = 0u; i < thread_count; ++i)
+				threads_.push_back(std::thread(&AssetStreamer::execute, this));
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::terminate()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				alive_ = false;
+			}
+			wake_.notify_all();
+			for (std::thread& thread : threads_)
+				thread.join();
+			threads_.clear();
+
+			for (auto& it : requests_)
+			{
+				if (it.second.job)
+					foundation::Memory::destruct(it.second.job);
+				it.second.job = nullptr;
+			}
+			requests_.clear();
+			queue_ = PriorityQueue<QueueEntry, QueueOrder>();
+			queued_ = 0u;
+			loaded_.clear();
+			finished_.clear();
+			destroyRetired();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::request(uint64_t hash, IStreamJob* job, float priority)
+		{
+			// Returns at once when the threads run.
+			initialize();
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				Request& request = requests_[hash];
+				switch (request.state)
+				{
+				case LoadState::kNone:
+				case LoadState::kReady:
+				case LoadState::kFailed:
+				case LoadState::kCancelled:
+					request.job      = job;
+					request.priority = priority;
+					request.state    = LoadState::kQueued;
+					queued_++;
+					push(hash, request);
+					job = nullptr;
+					break;
+				case LoadState::kQueued:
+					if (priority < request.priority)
+					{
+						request.priority = priority;
+						push(hash, request);
+						compact();
+					}
+					break;
+				default:
+					break;
+				}
+			}
+
+			if (job)
+				foundation::Memory::destruct(job);
+			else
+				wake_.notify_one();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::setPriority(uint64_t hash, float priority)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto it = requests_.find(hash);
+			if (it == requests_.end())
+				return;
+
+			Request& request = it->second;
+			if (request.priority == priority)
+				return;
+
+			request.priority = priority;
+			if (request.state == LoadState::kQueued)
+			{
+				push(hash, request);
+				compact();
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::cancel(uint64_t hash)
+		{
+			IStreamJob* job = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				auto it = requests_.find(hash);
+				if (it == requests_.end())
+					return;
+
+				Request& request = it->second;
+				if (request.state != LoadState::kQueued &&
+					  request.state != LoadState::kLoading &&
+					  request.state != LoadState::kLoaded)
+					return;
+
+				// A loading job belongs to its thread, which retires it once it
+				// sees that the generation moved on.
+				if (request.state == LoadState::kQueued)
+					queued_--;
+				job = request.job;
+				request.job   = nullptr;
+				request.state = LoadState::kCancelled;
+				request.generation++;
+				finished_.push_back(hash);
+			}
+
+			if (job)
+				foundation::Memory::destruct(job);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::addCallback(uint64_t hash, StreamCallback callback)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			Request& request = requests_[hash];
+			if (request.state == LoadState::kNone)
+				request.state = LoadState::kReady;
+
+			request.callbacks.push_back(callback);
+			if (request.state == LoadState::kReady ||
+				  request.state == LoadState::kFailed ||
+				  request.state == LoadState::kCancelled)
+				finished_.push_back(hash);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::forget(uint64_t hash)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto it = requests_.find(hash);
+			if (it == requests_.end())
+				return;
+
+			// Jobs hold a handle to their asset, so a destroyed asset can only
+			// have requests that are done. The worker looks the request up
+			// again after loading, in case that ever changes.
+			if (it->second.job == nullptr)
+				requests_.erase(it);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		LoadState AssetStreamer::getState(uint64_t hash) const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto it = requests_.find(hash);
+			return it == requests_.end() ? LoadState::kNone : it->second.state;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		bool AssetStreamer::isStreaming() const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return !queue_.empty() || in_flight_ > 0u || !loaded_.empty();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::finalize(const StreamBudget& budget)
+		{
+			LMB_PROFILE_SCOPE("StreamFinalize");
+			destroyRetired();
+
+			Vector<Pair<float, uint64_t>> loaded;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (uint64_t hash : loaded_)
+				{
+					auto it = requests_.find(hash);
+					if (it != requests_.end() && it->second.state == LoadState::kLoaded)
+						loaded.push_back(eastl::make_pair(it->second.priority, hash));
+				}
+				loaded_.clear();
+			}
+			if (loaded.empty())
+				return;
+
+			// Closest first. What does not fit in the budget waits a frame.
+			std::sort(loaded.begin(), loaded.end());
+
+			utilities::Timer timer;
+			size_t bytes = 0u;
+			size_t i = 0u;
+			for (; i < loaded.size(); ++i)
+			{
+				if (i > 0u && (bytes >= budget.bytes || timer.elapsed().milliseconds() >= budget.milliseconds))
+					break;
+
+				// Only cancel() takes jobs from loaded requests, and that is
+				// called on this thread as well.
+				IStreamJob* job = nullptr;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					Request& request = requests_.at(loaded[i].second);
+					job = request.job;
+					request.job = nullptr;
+				}
+
+				bytes += job->finalize();
+				foundation::Memory::destruct(job);
+
+				std::lock_guard<std::mutex> lock(mutex_);
+				requests_.at(loaded[i].second).state = LoadState::kReady;
+				finished_.push_back(loaded[i].second);
+			}
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (; i < loaded.size(); ++i)
+				loaded_.push_back(loaded[i].second);
+			LMB_PROFILE_COUNTER("Streamed Bytes", bytes);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::dispatchCallbacks()
+		{
+			Vector<Pair<uint64_t, LoadState>> done;
+			Vector<Vector<StreamCallback>> callbacks;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (uint64_t hash : finished_)
+				{
+					auto it = requests_.find(hash);
+					if (it == requests_.end() || it->second.callbacks.empty())
+						continue;
+					done.push_back(eastl::make_pair(hash, it->second.state));
+					callbacks.push_back(eastl::move(it->second.callbacks));
+					it->second.callbacks.clear();
+				}
+				finished_.clear();
+			}
+
+			// Callbacks are free to request and cancel other assets.
+			for (size_t i = 0u; i < done.size(); ++i)
+				for (const StreamCallback& callback : callbacks[i])
+					callback(done[i].first, done[i].second);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		AssetStreamer* AssetStreamer::getInstance()
+		{
+			static AssetStreamer* s_instance =
+				foundation::Memory::construct<AssetStreamer>();
+
+			return s_instance;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		AssetStreamer::~AssetStreamer()
+		{
+			terminate();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::execute()
+		{
+			LMB_PROFILE_THREAD("Streamer");
+			std::unique_lock<std::mutex> lock(mutex_);
+
+			while (true)
+			{
+				wake_.wait(lock, [this]() { return !alive_ || !queue_.empty(); });
+				if (!alive_)
+					return;
+
+				const QueueEntry entry = queue_.top();
+				queue_.pop();
+
+				auto it = requests_.find(entry.hash);
+				if (it == requests_.end() ||
+					  it->second.state != LoadState::kQueued ||
+					  it->second.generation != entry.generation)
+					continue;
+
+				IStreamJob* job = it->second.job;
+				it->second.job   = nullptr;
+				it->second.state = LoadState::kLoading;
+				queued_--;
+				in_flight_++;
+				lock.unlock();
+
+				bool loaded = false;
+				{
+					LMB_PROFILE_SCOPE("StreamLoad");
+					loaded = job->load();
+				}
+
+				lock.lock();
+				in_flight_--;
+				it = requests_.find(entry.hash);
+				if (it == requests_.end() ||
+					  it->second.state != LoadState::kLoading ||
+					  it->second.generation != entry.generation)
+				{
+					retired_.push_back(job);
+					continue;
+				}
+
+				Request& request = it->second;
+
+				if (loaded)
+				{
+					request.job   = job;
+					request.state = LoadState::kLoaded;
+					loaded_.push_back(entry.hash);
+				}
+				else
+				{
+					retired_.push_back(job);
+					request.state = LoadState::kFailed;
+					finished_.push_back(entry.hash);
+				}
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::push(uint64_t hash, Request& request)
+		{
+			request.generation++;
+			queue_.push(QueueEntry{ request.priority, request.generation, hash });
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::compact()
+		{
+			// Priorities change every frame, so without this the queue would
+			// grow with every frame an asset waits.
+			if (queue_.size() < kMinCompactSize || queue_.size() <= (size_t)queued_ * 2u)
+				return;
+
+			PriorityQueue<QueueEntry, QueueOrder> queue;
+			for (const auto& it : requests_)
+				if (it.second.state == LoadState::kQueued)
+					queue.push(QueueEntry{ it.second.priority, it.second.generation, it.first });
+			queue_ = eastl::move(queue);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void AssetStreamer::destroyRetired()
+		{
+			Vector<IStreamJob*> retired;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				retired.swap(retired_);
+			}
+			for (IStreamJob* job : retired)
+				foundation::Memory::destruct(job);
+		}
+	}
+}
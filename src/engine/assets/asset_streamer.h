@@ -0,0 +1,136 @@
+#pragma once
+#include <containers/containers.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace lambda
+{
+	namespace asset
+	{
+		///////////////////////////////////////////////////////////////////////////
+		enum class LoadState : uint8_t
+		{
+			kNone      = 0u, // Never requested.
+			kQueued    = 1u,
+			kLoading   = 2u,
+			kLoaded    = 3u, // Read and decoded, waiting for finalize().
+			kReady     = 4u,
+			kFailed    = 5u,
+			kCancelled = 6u,
+		};
+
+		typedef Function<void(uint64_t hash, LoadState state)> StreamCallback;
+
+		///////////////////////////////////////////////////////////////////////////
+		// One asset that is streamed in. load() runs on a streaming thread and
+		// may only touch the asset packs and its own members. finalize() runs
+		// on the main thread while the renderer is idle and swaps the loaded
+		// data into the asset that was handed out.
+		class IStreamJob
+		{
+		public:
+			virtual ~IStreamJob() {};
+			virtual bool load() = 0;
+			// Returns the number of bytes that were handed to the asset.
+			virtual size_t finalize() = 0;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// How much finalize() may do in one frame. At least one asset is
+		// finalized every frame, however large it is.
+		struct StreamBudget
+		{
+			float  milliseconds = 2.0f;
+			size_t bytes        = 32u << 20u;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// Loads assets on a few threads of its own, so slow reads never hold up
+		// the job system. Requests are keyed on the asset hash and ordered on
+		// priority, lower is sooner. The mesh render system feeds it the
+		// distance to the camera.
+		class AssetStreamer
+		{
+		public:
+			// A thread count of 0 uses a quarter of the hardware threads. Starts
+			// itself on the first request if this is not called.
+			void initialize(uint32_t thread_count = 0u);
+			// Cancels everything that is left and stops the threads.
+			void terminate();
+
+			// Takes ownership of the job. When the asset is still queued or
+			// loading the job is dropped and only the priority is raised. Done
+			// requests start over.
+			void request(uint64_t hash, IStreamJob* job, float priority);
+			void setPriority(uint64_t hash, float priority);
+			void cancel(uint64_t hash);
+			// Called from dispatchCallbacks() once the request is done. Also
+			// when it was done before the callback was added. Assets that were
+			// never requested were loaded directly, so they count as ready.
+			void addCallback(uint64_t hash, StreamCallback callback);
+			// Called when the asset is destroyed, so a later request streams it
+			// in again. Pending callbacks are dropped.
+			void forget(uint64_t hash);
+			LoadState getState(uint64_t hash) const;
+			// Whether anything is queued, loading or waiting to be finalized.
+			bool isStreaming() const;
+
+			// Main thread, while the renderer does not use any assets.
+			void finalize(const StreamBudget& budget = StreamBudget());
+			// Main thread, where scripts are allowed to run.
+			void dispatchCallbacks();
+
+		public:
+			static AssetStreamer* getInstance();
+			~AssetStreamer();
+
+		private:
+			struct Request
+			{
+				IStreamJob*            job        = nullptr;
+				float                  priority   = 0.0f;
+				uint32_t               generation = 0u;
+				LoadState              state      = LoadState::kNone;
+				Vector<StreamCallback> callbacks;
+			};
+			// Changing the priority pushes the request again with a new
+			// generation. Entries with an older generation are skipped, and
+			// dropped once they outnumber the queued requests.
+			struct QueueEntry
+			{
+				float    priority;
+				uint32_t generation;
+				uint64_t hash;
+			};
+			struct QueueOrder
+			{
+				bool operator()(const QueueEntry& lhs, const QueueEntry& rhs) const
+				{
+					return lhs.priority > rhs.priority;
+				}
+			};
+
+			void execute();
+			void push(uint64_t hash, Request& request);
+			void compact();
+			void destroyRetired();
+
+			mutable std::mutex                         mutex_;
+			std::condition_variable                    wake_;
+			Vector<std::thread>                        threads_;
+			bool                                       alive_ = false;
+			UnorderedMap<uint64_t, Request>            requests_;
+			PriorityQueue<QueueEntry, QueueOrder>      queue_;
+			// Requests in LoadState::kQueued, which each have one entry in
+			// queue_ that is not skipped.
+			uint32_t                                   queued_ = 0u;
+			uint32_t                                   in_flight_ = 0u;
+			Vector<uint64_t>                           loaded_;
+			Vector<uint64_t>                           finished_;
+			// Jobs of requests that were cancelled while they were loading.
+			// Destroyed on the main thread, as they hold asset handles.
+			Vector<IStreamJob*>                        retired_;
+		};
+	}
+}
@@ -4,6 +4,7 @@
 #include "interfaces/irenderer.h"
 #include <utils/file_system.h>
 #include <glm/gtx/norm.hpp>
+#include "asset_streamer.h"
 
 namespace lambda
 {
@@ -943,7 +944,8 @@ namespace lambda
 		}
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		VioletMeshHandle MeshManager::create(Name name, VioletMesh mesh)
+		// Everything but the textures, so it can run on a streaming thread.
+		static Mesh convertMesh(const VioletMesh& mesh)
 		{
 			Vector<glm::vec3> pos(mesh.data.pos.data.size() / sizeof(glm::vec3));
 			Vector<glm::vec3> nor(mesh.data.nor.data.size() / sizeof(glm::vec3));
@@ -1031,15 +1033,21 @@ namespace lambda
 				sub_meshes.push_back(sm);
 			}
 
-			Vector<asset::VioletTextureHandle> textures;
-			for (const String& texture : mesh.data.tex_alb)
-				textures.push_back(asset::TextureManager::getInstance()->get(texture));
-			for (const String& texture : mesh.data.tex_nrm)
-				textures.push_back(asset::TextureManager::getInstance()->get(texture));
-			for (const String& texture : mesh.data.tex_dmra)
-				textures.push_back(asset::TextureManager::getInstance()->get(texture));
-			for (const String& texture : mesh.data.tex_emi)
-				textures.push_back(asset::TextureManager::getInstance()->get(texture));
+			// Copies of their sub mesh with other indices, so they draw the
+			// same way and the others keep their index.
+			for (const VioletSubMeshLOD& lod : mesh.data.lods)
+			{
+				asset::SubMesh sm = sub_meshes.at(lod.sub_mesh);
+				sm.lods.clear();
+				sm.lod_of = lod.sub_mesh;
+				sm.offsets[asset::MeshElements::kIndices] = asset::SubMesh::Offset{
+					mesh.data.idx.segments.at(lod.idx).offset,
+					mesh.data.idx.segments.at(lod.idx).count,
+					mesh.data.idx.segments.at(lod.idx).stride
+				};
+				sub_meshes.at(lod.sub_mesh).lods.push_back(asset::SubMesh::LOD{ (uint32_t)sub_meshes.size(), lod.error });
+				sub_meshes.push_back(sm);
+			}
 
 			asset::Mesh m;
 			m.set(asset::MeshElements::kPositions, eastl::move(pos));
@@ -1051,14 +1059,30 @@ namespace lambda
 			m.set(asset::MeshElements::kWeights, eastl::move(wei));
 			m.set(asset::MeshElements::kIndices, eastl::move(idx));
 			m.setSubMeshes(eastl::move(sub_meshes));
-			m.setAttachedTextures(eastl::move(textures));
 			m.setAttachedTextureCount(glm::uvec4(
 				mesh.data.tex_alb.size(),
 				mesh.data.tex_nrm.size(),
 				mesh.data.tex_dmra.size(),
 				mesh.data.tex_emi.size()
 			));
+			return m;
+		}
 
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		VioletMeshHandle MeshManager::create(Name name, VioletMesh mesh)
+		{
+			Vector<asset::VioletTextureHandle> textures;
+			for (const String& texture : mesh.data.tex_alb)
+				textures.push_back(asset::TextureManager::getInstance()->get(texture));
+			for (const String& texture : mesh.data.tex_nrm)
+				textures.push_back(asset::TextureManager::getInstance()->get(texture));
+			for (const String& texture : mesh.data.tex_dmra)
+				textures.push_back(asset::TextureManager::getInstance()->get(texture));
+			for (const String& texture : mesh.data.tex_emi)
+				textures.push_back(asset::TextureManager::getInstance()->get(texture));
+
+			asset::Mesh m = convertMesh(mesh);
+			m.setAttachedTextures(eastl::move(textures));
 			return create(name, m);
 		}
 
@@ -1078,6 +1102,89 @@ namespace lambda
 			return create(mesh.file, mesh);
 		}
 
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Reads and converts the mesh on a streaming thread. Its textures are
+		// streamed in as well, behind the placeholders of their kind.
+		class MeshStreamJob : public IStreamJob
+		{
+		public:
+			MeshStreamJob(VioletMeshManager& manager, VioletMeshHandle mesh, const Vector<VioletTextureHandle>& placeholders, float priority)
+				: manager_(manager)
+				, mesh_(mesh)
+				, placeholders_(placeholders)
+				, priority_(priority)
+			{
+			}
+			bool load() override
+			{
+				if (!manager_.HasHeader(mesh_.getHash()))
+					return false;
+
+				const VioletMesh mesh = manager_.GetMesh(mesh_.getHash(), true);
+				data_ = convertMesh(mesh);
+				textures_[0] = mesh.data.tex_alb;
+				textures_[1] = mesh.data.tex_nrm;
+				textures_[2] = mesh.data.tex_dmra;
+				textures_[3] = mesh.data.tex_emi;
+				return true;
+			}
+			size_t finalize() override
+			{
+				Vector<VioletTextureHandle> textures;
+				for (uint32_t i = 0u; i < 4u; ++i)
+				{
+					const VioletTextureHandle placeholder = i < placeholders_.size() ? placeholders_[i] : VioletTextureHandle();
+					for (const String& texture : textures_[i])
+						textures.push_back(TextureManager::getInstance()->getAsync(texture, placeholder, priority_, true));
+				}
+				data_.setAttachedTextures(textures);
+
+				size_t bytes = 0u;
+				for (uint32_t element : { kPositions, kNormals, kTexCoords, kColours, kTangents, kJoints, kWeights, kIndices })
+					if (data_.has(element))
+						bytes += data_.get(element).count * data_.get(element).size;
+
+				*mesh_.get() = data_;
+				return bytes;
+			}
+
+		private:
+			VioletMeshManager&          manager_;
+			VioletMeshHandle            mesh_;
+			Vector<VioletTextureHandle> placeholders_;
+			float                       priority_;
+			Mesh                        data_;
+			Vector<String>              textures_[4];
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		VioletMeshHandle MeshManager::getAsync(Name name, float priority)
+		{
+			const String file = FileSystem::MakeRelative(name.getName());
+			const uint64_t hash = manager_.GetHash(file);
+
+			auto it = mesh_cache_.find(hash);
+			if (it != mesh_cache_.end())
+			{
+				AssetStreamer::getInstance()->setPriority(hash, priority);
+				return VioletMeshHandle(it->second, Name(file));
+			}
+
+			VioletMeshHandle handle = create(Name(file));
+			AssetStreamer::getInstance()->request(
+				hash,
+				foundation::Memory::construct<MeshStreamJob>(manager_, handle, texture_placeholders_, priority),
+				priority
+			);
+			return handle;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void MeshManager::setTexturePlaceholders(const Vector<VioletTextureHandle>& placeholders)
+		{
+			texture_placeholders_ = placeholders;
+		}
+
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		VioletMeshHandle MeshManager::getFromCache(Name name)
 		{
@@ -1098,6 +1205,7 @@ namespace lambda
 
 			foundation::Memory::destruct<Mesh>(mesh);
 			renderer_->destroyMesh(hash);
+			AssetStreamer::getInstance()->forget(hash);
 		}
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
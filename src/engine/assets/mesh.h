@@ -78,6 +78,18 @@ namespace lambda
 			size_t index_offset = 0;
 			size_t vertex_offset = 0;
 
+			// Simplified versions that the mesh compiler made, finest first.
+			// They are sub meshes after all of the others, which only differ in
+			// their indices, and have lod_of set to this one.
+			struct LOD
+			{
+				uint32_t sub_mesh;
+				// How far the surface moved at most, in the units of the mesh.
+				float    error;
+			};
+			Vector<LOD> lods;
+			int         lod_of = -1;
+
 			struct {
 				// Required information.
 				int       parent = 0;
@@ -246,6 +258,7 @@ namespace lambda
 		}
 
 		using VioletMeshHandle = VioletHandle<Mesh>;
+		using VioletMeshRef    = VioletRef<Mesh>;
 
 		///////////////////////////////////////////////////////////////////////////
 		class MeshManager
@@ -256,6 +269,11 @@ namespace lambda
 			VioletMeshHandle create(Name name, VioletMesh mesh);
 			VioletMeshHandle get(Name name);
 			VioletMeshHandle get(uint64_t hash);
+			// Returns an empty mesh straight away. The streamer fills it in later
+			// and streams its textures behind the texture placeholders.
+			VioletMeshHandle getAsync(Name name, float priority = 0.0f);
+			// Albedo, normal, DMRA and emissive, in that order.
+			void setTexturePlaceholders(const Vector<VioletTextureHandle>& placeholders);
 			VioletMeshHandle getFromCache(Name name);
 			void destroy(Mesh* mesh, const size_t& hash);
 
@@ -272,6 +290,7 @@ namespace lambda
 			platform::IRenderer* renderer_;
 			VioletMeshManager manager_;
 			UnorderedMap<uint64_t, Mesh*> mesh_cache_;
+			Vector<VioletTextureHandle> texture_placeholders_;
 		};
 	}
 }
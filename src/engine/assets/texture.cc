@@ -4,6 +4,9 @@
 #include "utils/file_system.h"
 #include <memory/memory.h>
 #include <interfaces/irenderer.h>
+#include "asset_streamer.h"
+#include "texture_streamer.h"
+#include <algorithm>
 
 namespace lambda
 {
@@ -443,11 +446,95 @@ namespace lambda
 			return create(texture.file, texture);
 		}
 
+		///////////////////////////////////////////////////////////////////////////
+		// Reads the header and the data on a streaming thread. Replaces all
+		// layers of the placeholder, so the renderer recreates the texture.
+		// Streamed mips start at the tail and are handed to the texture
+		// streamer.
+		class TextureStreamJob : public IStreamJob
+		{
+		public:
+			TextureStreamJob(VioletTextureManager& manager, VioletTextureHandle texture, bool stream_mips)
+				: manager_(manager)
+				, texture_(texture)
+				, stream_mips_(stream_mips)
+				, tail_mip_(0u)
+			{
+			}
+			bool load() override
+			{
+				if (!manager_.HasHeader(texture_.getHash()))
+					return false;
+
+				header_ = manager_.GetTexture(texture_.getHash());
+				tail_mip_ = stream_mips_ ? TextureStreamer::getTailMip(header_) : 0u;
+				if (tail_mip_ > 0u)
+					data_ = manager_.GetMips(header_, tail_mip_, header_.mip_count);
+				else
+					data_ = manager_.GetTexture(texture_.getHash(), true).data;
+				return !data_.empty();
+			}
+			size_t finalize() override
+			{
+				const size_t bytes = data_.size();
+				VioletTexture layer = header_;
+				layer.width     = (uint16_t)std::max(1, header_.width >> tail_mip_);
+				layer.height    = (uint16_t)std::max(1, header_.height >> tail_mip_);
+				layer.mip_count = header_.mip_count - tail_mip_;
+				layer.data      = eastl::move(data_);
+
+				const bool keep_in_memory = texture_->getKeepInMemory();
+				*texture_.get() = Texture(layer);
+				texture_->setKeepInMemory(keep_in_memory);
+
+				// The layer drops the alpha flag of textures from the packer.
+				texture_->getLayer(0u).setFlags(header_.flags | kTextureFlagRecreate);
+				TextureStreamer::getInstance()->add(texture_, header_, tail_mip_);
+				return bytes;
+			}
+
+		private:
+			VioletTextureManager& manager_;
+			VioletTextureHandle   texture_;
+			bool                  stream_mips_;
+			uint16_t              tail_mip_;
+			VioletTexture         header_;
+			Vector<char>          data_;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		VioletTextureHandle TextureManager::getAsync(Name name, VioletTextureHandle placeholder, float priority, bool stream_mips)
+		{
+			const String file = FileSystem::MakeRelative(name.getName());
+			const uint64_t hash = manager_.GetHash(file);
+
+			auto it = texture_cache_.find(hash);
+			if (it != texture_cache_.end())
+			{
+				AssetStreamer::getInstance()->setPriority(hash, priority);
+				return VioletTextureHandle(it->second, Name(file));
+			}
+
+			VioletTextureHandle handle;
+			if (placeholder)
+				handle = create(Name(file), *placeholder.get());
+			else
+				handle = create(Name(file), 1u, 1u, 1u, TextureFormat::kR8G8B8A8, 0u, Vector<unsigned char>{ 255u, 255u, 255u, 255u });
+
+			AssetStreamer::getInstance()->request(
+				hash,
+				foundation::Memory::construct<TextureStreamJob>(manager_, handle, stream_mips),
+				priority
+			);
+			return handle;
+		}
+
 		///////////////////////////////////////////////////////////////////////////
 		Vector<char> TextureManager::getData(VioletTextureHandle texture)
 		{
 			LMB_ASSERT(manager_.HasHeader(texture.getHash()), "Could not find texture: %s", texture.getName().getName().c_str());
-			return eastl::move(manager_.GetData(texture.getHash()));
+			// Textures that are stored per mip have no data blob.
+			return eastl::move(manager_.GetTexture(texture.getHash(), true).data);
 		}
 
 		///////////////////////////////////////////////////////////////////////////
@@ -462,6 +549,8 @@ namespace lambda
 
 			foundation::Memory::destruct<Texture>(texture);
 			renderer_->destroyTexture(hash);
+			AssetStreamer::getInstance()->forget(hash);
+			TextureStreamer::getInstance()->remove(hash);
 		}
 
 		///////////////////////////////////////////////////////////////////////////
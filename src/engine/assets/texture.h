@@ -74,6 +74,7 @@ namespace lambda
 			bool keep_in_memory_;
 		};
 		using VioletTextureHandle = VioletHandle<Texture>;
+		using VioletTextureRef    = VioletRef<Texture>;
 
 		///////////////////////////////////////////////////////////////////////////
 		class TextureManager
@@ -103,6 +104,11 @@ namespace lambda
 			VioletTextureHandle getFromCache(Name name);
 			VioletTextureHandle get(Name name);
 			VioletTextureHandle get(uint64_t hash);
+			// Returns straight away with a copy of the placeholder, or a white
+			// pixel without one. The streamer swaps the real texture in later.
+			// With stream_mips only the smallest mips are loaded, the texture
+			// streamer brings in the rest when the texture is seen up close.
+			VioletTextureHandle getAsync(Name name, VioletTextureHandle placeholder = VioletTextureHandle(), float priority = 0.0f, bool stream_mips = false);
 			Vector<char> getData(VioletTextureHandle texture);
 			void destroy(Texture* texture, const size_t& hash);
 
@@ -116,6 +122,8 @@ namespace lambda
 			const VioletTextureManager& getManager() const;
 
 		private:
+			friend class TextureStreamer;
+
 			VioletTextureManager manager_;
 			platform::IRenderer* renderer_;
 			UnorderedMap<uint64_t, Texture*> texture_cache_;
@@ -0,0 +1,323 @@
+#include "texture_streamer.h"
+#include "asset_streamer.h"
+#include <memory/memory.h>
+#include <utils/profiler.h>
+#include <algorithm>
+#include <cmath>
+
+namespace lambda
+{
+	namespace asset
+	{
+		///////////////////////////////////////////////////////////////////////////
+		// The streamer has one request per key, so the finer mips are requested
+		// under a key of their own and do not disturb the load state of the
+		// texture itself.
+		static uint64_t mipRequest(uint64_t hash)
+		{
+			return hash ^ 0x9e3779b97f4a7c15ull;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static size_t mipBytes(const VioletTexture& header, uint16_t first_mip, uint16_t last_mip)
+		{
+			size_t bytes = 0u;
+			for (uint16_t mip = first_mip; mip < last_mip; ++mip)
+				bytes += VioletTextureManager::GetMipSize(header, mip);
+			return bytes;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Reads mips [first_mip, last_mip) on a streaming thread and hands them
+		// to the texture streamer.
+		class MipStreamJob : public IStreamJob
+		{
+		public:
+			MipStreamJob(VioletTextureManager& manager, VioletTextureHandle texture, const VioletTexture& header, uint16_t first_mip, uint16_t last_mip)
+				: manager_(manager)
+				, texture_(texture)
+				, header_(header)
+				, first_mip_(first_mip)
+				, last_mip_(last_mip)
+				, finalized_(false)
+			{
+			}
+			~MipStreamJob()
+			{
+				// Failed and cancelled loads release their space in the budget.
+				if (!finalized_)
+					TextureStreamer::getInstance()->finish(texture_.getHash());
+			}
+			bool load() override
+			{
+				data_ = manager_.GetMips(header_, first_mip_, last_mip_);
+				return !data_.empty();
+			}
+			size_t finalize() override
+			{
+				const size_t bytes = data_.size();
+				TextureStreamer::getInstance()->apply(texture_.getHash(), first_mip_, last_mip_, data_);
+				finalized_ = true;
+				return bytes;
+			}
+
+		private:
+			VioletTextureManager& manager_;
+			VioletTextureHandle   texture_;
+			VioletTexture         header_;
+			uint16_t              first_mip_;
+			uint16_t              last_mip_;
+			bool                  finalized_;
+			Vector<char>          data_;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		uint16_t TextureStreamer::getTailMip(const VioletTexture& header)
+		{
+			if (header.mip_count <= 1u || VioletTextureManager::GetMipSize(header, 0u) == 0u)
+				return 0u;
+
+			uint16_t mip = 0u;
+			while (mip + 1u < header.mip_count &&
+				  std::max(header.width >> mip, header.height >> mip) > (int)kTailSize)
+				mip++;
+			return mip;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void TextureStreamer::add(const VioletTextureHandle& texture, const VioletTexture& header, uint16_t resident_mip)
+		{
+			if (resident_mip == 0u)
+				return;
+
+			Entry& entry = entries_[texture.getHash()];
+			resident_bytes_ -= entry.resident_bytes;
+
+			entry.texture        = texture.get();
+			entry.name           = texture.getName();
+			entry.header         = header;
+			entry.header.data.clear();
+			entry.tail_mip       = resident_mip;
+			entry.resident_mip   = resident_mip;
+			entry.wanted_mip     = resident_mip;
+			entry.resident_bytes = mipBytes(header, resident_mip, header.mip_count);
+			resident_bytes_     += entry.resident_bytes;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void TextureStreamer::remove(uint64_t hash)
+		{
+			auto it = entries_.find(hash);
+			if (it == entries_.end())
+				return;
+
+			resident_bytes_ -= it->second.resident_bytes;
+			loading_bytes_  -= it->second.loading_bytes;
+			entries_.erase(it);
+			AssetStreamer::getInstance()->forget(mipRequest(hash));
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		bool TextureStreamer::empty() const
+		{
+			return entries_.empty();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void TextureStreamer::use(uint64_t hash, float pixels, float priority)
+		{
+			auto it = entries_.find(hash);
+			if (it == entries_.end())
+				return;
+
+			Entry& entry = it->second;
+			const float size = (float)std::max(entry.header.width, entry.header.height);
+			uint16_t mip = 0u;
+			if (pixels < size)
+				mip = (uint16_t)std::min(std::floor(std::log2(size / std::max(pixels, 1.0f))), (float)entry.tail_mip);
+
+			if (entry.last_used != frame_)
+			{
+				entry.last_used  = frame_;
+				entry.wanted_mip = mip;
+				entry.priority   = priority;
+			}
+			else
+			{
+				entry.wanted_mip = std::min(entry.wanted_mip, mip);
+				entry.priority   = std::min(entry.priority, priority);
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void TextureStreamer::update(size_t budget)
+		{
+			LMB_PROFILE_SCOPE("TextureStreamerUpdate");
+
+			// Only what was used since the last update streams in, closest
+			// first.
+			Vector<Pair<float, uint64_t>> loads;
+			for (const auto& it : entries_)
+			{
+				const Entry& entry = it.second;
+				if (entry.last_used == frame_ && entry.wanted_mip < entry.resident_mip && entry.loading_bytes == 0u)
+					loads.push_back(eastl::make_pair(entry.priority, it.first));
+			}
+			std::sort(loads.begin(), loads.end());
+
+			VioletTextureManager& manager = TextureManager::getInstance()->getManager();
+			for (const auto& load : loads)
+			{
+				Entry& entry = entries_.at(load.second);
+				uint16_t first_mip = entry.wanted_mip;
+				size_t bytes = mipBytes(entry.header, first_mip, entry.resident_mip);
+				if (!fits(bytes, budget))
+					evict(resident_bytes_ + loading_bytes_ + bytes - budget);
+
+				// Settle for one mip finer when the whole step does not fit.
+				if (!fits(bytes, budget))
+				{
+					first_mip = entry.resident_mip - 1u;
+					bytes = mipBytes(entry.header, first_mip, entry.resident_mip);
+				}
+				if (!fits(bytes, budget))
+					continue;
+
+				entry.loading_bytes = bytes;
+				loading_bytes_     += bytes;
+				AssetStreamer::getInstance()->request(
+					mipRequest(load.second),
+					foundation::Memory::construct<MipStreamJob>(
+						manager,
+						VioletTextureHandle(entry.texture, entry.name),
+						entry.header,
+						first_mip,
+						entry.resident_mip
+					),
+					entry.priority
+				);
+			}
+
+			// The budget might have been lowered.
+			if (resident_bytes_ + loading_bytes_ > budget)
+				evict(resident_bytes_ + loading_bytes_ - budget);
+
+			LMB_PROFILE_COUNTER("Texture Bytes", resident_bytes_);
+			frame_++;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		size_t TextureStreamer::getResidentBytes() const
+		{
+			return resident_bytes_;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		TextureStreamer* TextureStreamer::getInstance()
+		{
+			static TextureStreamer* s_instance =
+				foundation::Memory::construct<TextureStreamer>();
+
+			return s_instance;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		uint16_t TextureStreamer::getTargetMip(const Entry& entry) const
+		{
+			return entry.last_used == frame_ ? entry.wanted_mip : entry.tail_mip;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		bool TextureStreamer::fits(size_t bytes, size_t budget) const
+		{
+			return resident_bytes_ + loading_bytes_ + bytes <= budget;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void TextureStreamer::evict(size_t bytes)
+		{
+			// Least recently used first. Textures that are in use only lose the
+			// mips that are finer than they need.
+			Vector<Pair<uint64_t, uint64_t>> candidates;
+			for (const auto& it : entries_)
+			{
+				const Entry& entry = it.second;
+				if (entry.loading_bytes == 0u && getTargetMip(entry) > entry.resident_mip)
+					candidates.push_back(eastl::make_pair(entry.last_used, it.first));
+			}
+			std::sort(candidates.begin(), candidates.end());
+
+			size_t freed = 0u;
+			for (const auto& candidate : candidates)
+			{
+				if (freed >= bytes)
+					break;
+
+				Entry& entry = entries_.at(candidate.second);
+				const uint16_t mip = getTargetMip(entry);
+				const size_t offset = mipBytes(entry.header, entry.resident_mip, mip);
+				const Vector<char>& data = entry.texture->getLayer(0u).getData();
+				if (data.size() < offset)
+					continue;
+
+				const size_t before = entry.resident_bytes;
+				setResident(entry, mip, Vector<char>(data.begin() + offset, data.end()));
+				freed += before - entry.resident_bytes;
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void TextureStreamer::setResident(Entry& entry, uint16_t mip, Vector<char> data)
+		{
+			VioletTexture layer = entry.header;
+			layer.width     = (uint16_t)std::max(1, entry.header.width >> mip);
+			layer.height    = (uint16_t)std::max(1, entry.header.height >> mip);
+			layer.mip_count = entry.header.mip_count - mip;
+			layer.data      = eastl::move(data);
+
+			resident_bytes_ -= entry.resident_bytes;
+			entry.resident_bytes = layer.data.size();
+			entry.resident_mip   = mip;
+			resident_bytes_ += entry.resident_bytes;
+
+			// The layer drops the alpha flag of textures that come from the
+			// packer, so the flags are put back. Recreate tells the renderer
+			// that the size changed.
+			TextureLayer& target = entry.texture->getLayer(0u);
+			target = TextureLayer(layer);
+			target.setFlags(entry.header.flags | kTextureFlagRecreate);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void TextureStreamer::apply(uint64_t hash, uint16_t first_mip, uint16_t last_mip, Vector<char>& data)
+		{
+			auto it = entries_.find(hash);
+			if (it == entries_.end())
+				return;
+
+			Entry& entry = it->second;
+			loading_bytes_ -= entry.loading_bytes;
+			entry.loading_bytes = 0u;
+
+			// Only possible when the texture started streaming again while
+			// this was loading.
+			if (last_mip != entry.resident_mip)
+				return;
+
+			const Vector<char>& resident = entry.texture->getLayer(0u).getData();
+			data.insert(data.end(), resident.begin(), resident.end());
+			setResident(entry, first_mip, eastl::move(data));
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void TextureStreamer::finish(uint64_t hash)
+		{
+			auto it = entries_.find(hash);
+			if (it == entries_.end())
+				return;
+
+			loading_bytes_ -= it->second.loading_bytes;
+			it->second.loading_bytes = 0u;
+		}
+	}
+}
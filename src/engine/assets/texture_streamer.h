@@ -0,0 +1,74 @@
+#pragma once
+#include "texture.h"
+
+namespace lambda
+{
+	namespace asset
+	{
+		///////////////////////////////////////////////////////////////////////////
+		// Keeps only the mips of streamed textures that are needed on screen.
+		// Textures start out with their smallest mips. Every frame the mesh
+		// render system reports how many pixels each texture covers, and
+		// update() streams the finer mips in while they fit in the budget.
+		// When they do not, the finer mips of the least recently used
+		// textures are dropped first.
+		class TextureStreamer
+		{
+		public:
+			// Mips up to this size on their largest side are always resident.
+			static constexpr uint32_t kTailSize = 64u;
+			// The first mip that is loaded when the texture starts streaming.
+			// Textures that are small enough to load in full return 0.
+			static uint16_t getTailMip(const VioletTexture& header);
+
+			// Takes over a texture that holds mips [resident_mip, mip_count)
+			// of the header.
+			void add(const VioletTextureHandle& texture, const VioletTexture& header, uint16_t resident_mip);
+			void remove(uint64_t hash);
+			bool empty() const;
+			// Called for every use of the texture this frame. The use that
+			// covers the most pixels decides the mip, the lowest priority
+			// decides the order in which the mips are streamed in.
+			void use(uint64_t hash, float pixels, float priority);
+			// Main thread, while the renderer does not use any assets.
+			void update(size_t budget);
+			size_t getResidentBytes() const;
+
+		public:
+			static TextureStreamer* getInstance();
+
+		private:
+			friend class MipStreamJob;
+
+			struct Entry
+			{
+				// Removed when the texture is destroyed.
+				Texture*      texture        = nullptr;
+				Name          name;
+				// Without data.
+				VioletTexture header;
+				uint16_t      tail_mip       = 0u;
+				uint16_t      resident_mip   = 0u;
+				uint16_t      wanted_mip     = 0u;
+				float         priority       = 0.0f;
+				uint64_t      last_used      = 0u;
+				size_t        resident_bytes = 0u;
+				// Not zero while finer mips are being loaded.
+				size_t        loading_bytes  = 0u;
+			};
+
+			uint16_t getTargetMip(const Entry& entry) const;
+			bool fits(size_t bytes, size_t budget) const;
+			void evict(size_t bytes);
+			void setResident(Entry& entry, uint16_t mip, Vector<char> data);
+			// Prepends the loaded mips to the resident ones.
+			void apply(uint64_t hash, uint16_t first_mip, uint16_t last_mip, Vector<char>& data);
+			void finish(uint64_t hash);
+
+			UnorderedMap<uint64_t, Entry> entries_;
+			size_t                        resident_bytes_ = 0u;
+			size_t                        loading_bytes_  = 0u;
+			uint64_t                      frame_          = 1u;
+		};
+	}
+}
@@ -2,6 +2,7 @@
 #include <utils/file_system.h>
 #include <memory/memory.h>
 #include <soloud_wav.h>
+#include "asset_streamer.h"
 
 namespace lambda
 {
@@ -130,6 +131,67 @@ namespace lambda
 			return create(wave.file, wave);
 		}
 
+		///////////////////////////////////////////////////////////////////////////
+		// Decodes the whole file on a streaming thread.
+		class WaveStreamJob : public IStreamJob
+		{
+		public:
+			WaveStreamJob(VioletWaveManager& manager, VioletWaveHandle wave)
+				: manager_(manager)
+				, wave_(wave)
+				, buffer_(nullptr)
+			{
+			}
+			~WaveStreamJob()
+			{
+				if (buffer_)
+					foundation::Memory::destruct(buffer_);
+			}
+			bool load() override
+			{
+				if (!manager_.HasHeader(wave_.getHash()))
+					return false;
+
+				const VioletWave wave = manager_.GetWave(wave_.getHash());
+				buffer_ = foundation::Memory::construct<SoLoud::Wav>();
+				return buffer_->load(FileSystem::FullFilePath(wave.file).c_str()) == SoLoud::SO_NO_ERROR;
+			}
+			size_t finalize() override
+			{
+				const size_t bytes = buffer_->mSampleCount * buffer_->mChannels * sizeof(float);
+				wave_->setBuffer(buffer_);
+				buffer_ = nullptr;
+				return bytes;
+			}
+
+		private:
+			VioletWaveManager& manager_;
+			VioletWaveHandle   wave_;
+			SoLoud::Wav*       buffer_;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		VioletWaveHandle WaveManager::getAsync(Name name, float priority)
+		{
+			const String file = FileSystem::MakeRelative(name.getName());
+			const uint64_t hash = manager_.GetHash(file);
+
+			auto it = wave_cache_.find(hash);
+			if (it != wave_cache_.end())
+			{
+				AssetStreamer::getInstance()->setPriority(hash, priority);
+				return VioletWaveHandle(it->second, Name(file));
+			}
+
+			VioletWaveHandle handle = create(Name(file));
+			AssetStreamer::getInstance()->request(
+				hash,
+				foundation::Memory::construct<WaveStreamJob>(manager_, handle),
+				priority
+			);
+			return handle;
+		}
+
 		///////////////////////////////////////////////////////////////////////////
 		void WaveManager::destroy(Wave* wave, const size_t& hash)
 		{
@@ -141,6 +203,7 @@ namespace lambda
 				wave_cache_.erase(it);
 
 			foundation::Memory::destruct<Wave>(wave);
+			AssetStreamer::getInstance()->forget(hash);
 		}
 
 		///////////////////////////////////////////////////////////////////////////
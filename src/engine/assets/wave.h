@@ -41,6 +41,9 @@ namespace lambda
       VioletWaveHandle create(Name name, VioletWave wave);
       VioletWaveHandle get(Name name);
       VioletWaveHandle get(uint64_t hash);
+      // Returns a wave without a buffer straight away. The streamer decodes
+      // the file and hands the buffer over later.
+      VioletWaveHandle getAsync(Name name, float priority = 0.0f);
       void destroy(Wave* wave, const size_t& hash);
 
     public:
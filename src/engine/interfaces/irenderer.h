@@ -56,6 +56,7 @@ namespace lambda
 
 		class PostProcessManager;
 		class ShaderPass;
+		struct RenderStats;
 		class RasterizerState;
 		class BlendState;
 		class SamplerState;
@@ -136,6 +137,9 @@ namespace lambda
 			virtual void  beginTimer(const String& name) = 0;
 			virtual void  endTimer(const String& name) = 0;
 			virtual uint64_t getTimerMicroSeconds(const String& name) = 0;
+			// Adds what the renderer counted itself in the frame that ended
+			// last. Called on the thread that flushes, after endFrame().
+			virtual void addFrameStats(RenderStats& /*stats*/) const {}
 
 			virtual void setRenderScale(const float& render_scale) = 0;
 			virtual float getRenderScale() = 0;
@@ -49,13 +49,12 @@ namespace lambda
 		struct MTGC
 		{
 			scripting::IScriptContext* context = nullptr;
-			std::atomic<bool> done = true;
+			platform::TaskScheduler::Counter counter;
 		} mtgc;
 
 		void queueGarbageCollection(void* user_data)
 		{
 			mtgc.context->collectGarbage();
-			mtgc.done = true;
 		}
 #endif
 
@@ -70,6 +69,7 @@ namespace lambda
 			
 			double time_step_remainer = 0.0;
 			profiler_.startTimer("BetweenFrames");
+			LMB_PROFILE_THREAD("Main");
 
 			while (scene_.window->isOpen())
 			{
@@ -79,15 +79,14 @@ namespace lambda
 
 				controller_manager_.update();
 
-				delta_time_ = timer_.elapsed().seconds() * scene_.time_scale;
+				delta_time_ = (fixed_delta_time_ > 0.0 ? fixed_delta_time_ : timer_.elapsed().seconds()) * scene_.time_scale;
 				timer_.reset();
 
 				if (scene_.window->getSize().x == 0.0f || scene_.window->getSize().y == 0.0f)
 					continue;
 
 #if USE_MT_GC
-				while (!mtgc.done)
-					std::this_thread::sleep_for(std::chrono::microseconds(1));
+				platform::TaskScheduler::waitForCounter(&mtgc.counter);
 #endif
 
 				scripting_->executeFunction("Input::InputHelper::UpdateAxes", {});
@@ -131,8 +130,7 @@ namespace lambda
 				if (did_fixed_update)
 				{
 					mtgc.context = scene_.scripting;
-					mtgc.done = false;
-					platform::TaskScheduler::queue(queueGarbageCollection, nullptr, platform::TaskScheduler::kHigh);
+					platform::TaskScheduler::run(queueGarbageCollection, nullptr, &mtgc.counter, nullptr, platform::TaskScheduler::kHigh);
 				}
 #else
 				if (did_fixed_update)
@@ -146,6 +144,11 @@ namespace lambda
 				profiler_.endTimer("ConstructRender");
 				
 				profiler_.endTimer("Total");
+
+				LMB_PROFILE_COUNTER("Allocated", foundation::Memory::default_allocator()->allocated() + foundation::Memory::new_allocator()->allocated());
+				LMB_PROFILE_COUNTER("Draws", scene_.render_stats.draw_calls);
+				LMB_PROFILE_COUNTER("Bodies", scene_.rigid_body.size());
+				LMB_PROFILE_FRAME();
 				profiler_.startTimer("BetweenFrames");
 			}
 
@@ -218,6 +221,12 @@ namespace lambda
 			return delta_time_;
 		}
 
+		///////////////////////////////////////////////////////////////////////////
+		void IWorld::setFixedDeltaTime(const double& fixed_delta_time)
+		{
+			fixed_delta_time_ = fixed_delta_time;
+		}
+
 		///////////////////////////////////////////////////////////////////////////
 		scene::Scene& IWorld::getScene()
 		{
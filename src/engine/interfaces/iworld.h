@@ -45,6 +45,9 @@ namespace lambda
 
     public:
       double getDeltaTime() const;
+      // Steps every frame by this many seconds instead of the measured time
+      // when larger than zero. Makes runs repeatable.
+      void setFixedDeltaTime(const double& fixed_delta_time);
       scene::Scene& getScene();
       scripting::IScriptContext* getScripting();
       void setWindow(platform::IWindow* window);
@@ -57,6 +60,7 @@ namespace lambda
 
     private:
 			double delta_time_;
+			double fixed_delta_time_ = 0.0;
       scene::Scene scene_;
       utilities::Timer timer_;
       io::Input<io::Mouse::State> mouse_;
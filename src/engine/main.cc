@@ -45,6 +45,7 @@
 #include "assets/mesh.h"
 #include "assets/shader.h"
 #include "assets/wave.h"
+#include "assets/asset_streamer.h"
 
 #include "systems/entity_system.h"
 #include "systems/transform_system.h"
@@ -64,6 +65,7 @@
 
 #include <INIReader.h>
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
@@ -87,6 +89,9 @@
 #if defined VIOLET_WINDOW_SDL2
 #include "windows/sdl2/sdl2_window.h"
 #endif
+#if defined VIOLET_WINDOW_NO
+#include "windows/no/no_window.h"
+#endif
   
 //#undef VIOLET_SCRIPTING_WREN
 
@@ -99,6 +104,10 @@
 
 using namespace lambda;
 
+// Chunks the frame heap starts with and keeps, so the first frames do not
+// have to allocate them.
+static constexpr uint32_t kFrameHeapReserve = 1u << 20u;
+
 glm::vec4 RGBtoHSV(const glm::vec4& rgb) {
   glm::vec4 hsv = rgb;
   float fCMax = std::fmaxf(std::fmaxf(rgb.x, rgb.y), rgb.z);
@@ -335,11 +344,147 @@ private:
   FrameCounter frame_counter;
 };
 
+// Runs a fixed number of frames with a fixed time step while the main camera
+// circles the origin, then logs what every phase of a frame cost on the CPU.
+// Frame counts and render counters are the same every run, so they can be
+// compared between builds as is. Times are reported as mean and median.
+// Given a trace path, the measured frames are captured and written to it as a
+// Chrome trace.
+class BenchmarkWorld : public world::IWorld
+{
+public:
+  BenchmarkWorld(
+    platform::IWindow* window,
+    platform::IRenderer* renderer,
+    scripting::IScriptContext* scripting,
+    uint32_t frame_count,
+    const char* trace_path
+  ) : IWorld(window, renderer, scripting), frame_count_(frame_count), trace_path_(trace_path) {}
+
+  virtual ~BenchmarkWorld() {};
+
+  void initialize() override
+  {
+    setFixedDeltaTime(1.0 / 60.0);
+    for (Vector<double>& samples : samples_)
+      samples.reserve(frame_count_);
+  }
+  void deinitialize() override
+  {
+  }
+
+  void update(const double& delta_time) override
+  {
+    scene::Scene& scene = getScene();
+    const float angle = (float)frame_ * (6.28318530718f / (float)kPathFrames);
+    if (scene.camera.main_camera != entity::InvalidEntity)
+    {
+      const glm::vec3 position(std::cos(angle) * kPathRadius, kPathHeight, std::sin(angle) * kPathRadius);
+      components::TransformSystem::setWorldTranslation(scene.camera.main_camera, position, scene);
+      components::TransformSystem::lookAt(scene.camera.main_camera, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), scene);
+    }
+
+    // The profiler holds the last frame, so the first frame has nothing yet.
+    if (frame_++ < kWarmupFrames)
+      return;
+    if (trace_path_ && !utilities::ProfileCapture::isCapturing() && samples_[0].empty())
+      utilities::ProfileCapture::start();
+
+    for (uint32_t i = 0u; i < kPhaseCount - 1u; ++i)
+      samples_[i].push_back(getProfiler().getTime(kPhaseNames[i]));
+    samples_[kPhaseCount - 1u].push_back(scene.flush_time);
+
+    stats_.add(scene.render_stats);
+
+    if (samples_[0].size() == frame_count_)
+    {
+      if (trace_path_)
+      {
+        utilities::ProfileCapture::stop();
+        utilities::ProfileCapture::writeChromeTrace(trace_path_);
+      }
+      report();
+      scene.window->close();
+    }
+  }
+
+  virtual void fixedUpdate() override
+  {
+  }
+
+  virtual void handleWindowMessage(const platform::WindowMessage& message) override
+  {
+    switch (message.type)
+    {
+    case platform::WindowMessageType::kClose:
+      getScene().window->close();
+      break;
+    default:
+      break;
+    }
+  }
+
+private:
+  void report()
+  {
+    LMB_LOG_INFO("Benchmark: %u frames\n", frame_count_);
+    for (uint32_t i = 0u; i < kPhaseCount; ++i)
+    {
+      Vector<double>& samples = samples_[i];
+      double total = 0.0;
+      for (double sample : samples)
+        total += sample;
+      std::sort(samples.begin(), samples.end());
+      LMB_LOG_INFO("  %-16s mean %8.4fms median %8.4fms\n", kPhaseNames[i], total / (double)samples.size(), samples[samples.size() / 2u]);
+    }
+
+    LMB_LOG_INFO("  draws %u instances %u state changes %u skipped %u\n", stats_.draw_calls, stats_.instances, stats_.state_changes, stats_.skipped_state_changes);
+#if defined VIOLET_RENDERER_NO
+    LMB_LOG_INFO("  commands %llu buffer bytes %llu\n", (unsigned long long)stats_.commands, (unsigned long long)stats_.buffer_bytes);
+#endif
+
+    const foundation::FrameHeapStatistics heap = foundation::GetFrameHeap()->getStatistics();
+    LMB_LOG_INFO("  frame heap peak %u bytes reserved %u bytes in %u chunks overflows %u oversized %u\n", heap.all_time_peak_bytes, heap.reserved_bytes, heap.chunk_count, heap.total_overflows, heap.oversized_allocations);
+  }
+
+private:
+  static constexpr uint32_t kWarmupFrames = 2u;
+  static constexpr uint32_t kPathFrames   = 600u;
+  static constexpr float    kPathRadius   = 20.0f;
+  static constexpr float    kPathHeight   = 5.0f;
+  static constexpr uint32_t kPhaseCount   = 5u;
+  static constexpr const char* kPhaseNames[kPhaseCount] = { "FixedUpdate", "Update", "CollectGarbage", "ConstructRender", "Flush" };
+
+  uint32_t frame_count_;
+  const char* trace_path_;
+  uint32_t frame_ = 0u;
+  Vector<double> samples_[kPhaseCount];
+  platform::RenderStats stats_;
+};
+constexpr const char* BenchmarkWorld::kPhaseNames[BenchmarkWorld::kPhaseCount];
+
 int main(int argc, char** argv)
 {
 	LMB_ASSERT(argc != 1, "No project folder was speficied!");
 
 	lambda::FileSystem::SetBaseDir(argv[1]);
+
+	// lambda-engine <project> --benchmark <frames> [--trace <file>]
+	uint32_t benchmark_frames = 0u;
+	const char* benchmark_trace = nullptr;
+	if (argc > 3 && strcmp(argv[2], "--benchmark") == 0)
+		benchmark_frames = (uint32_t)std::max(1, atoi(argv[3]));
+	if (argc > 5 && strcmp(argv[4], "--trace") == 0)
+	{
+#if defined VIOLET_PROFILER
+		benchmark_trace = argv[5];
+#else
+		// Without the profiler no zones are recorded and the trace would be empty.
+		LMB_LOG_WARN("Benchmark: --trace needs VIOLET_PROFILER, no trace is written\n");
+#endif
+	}
+
+	foundation::GetFrameHeap()->reserve(kFrameHeapReserve);
 	
 	{
 #if defined VIOLET_RENDERER_D3D11
@@ -361,6 +506,8 @@ int main(int argc, char** argv)
 			platform::IWindow* window = foundation::Memory::construct<window::GLFWWindow>();
 #elif defined VIOLET_WINDOW_SDL2
 			platform::IWindow* window = foundation::Memory::construct<window::SDL2Window>();
+#elif defined VIOLET_WINDOW_NO
+			platform::IWindow* window = foundation::Memory::construct<window::NoWindow>();
 #else
 #error No valid window found!
 #endif
@@ -377,6 +524,15 @@ int main(int argc, char** argv)
 
 			window->create(glm::uvec2(1280u, 720u), "Engine");
 
+			if (benchmark_frames > 0u)
+			{
+				BenchmarkWorld world(window, renderer, scripting, benchmark_frames, benchmark_trace);
+				scripting->initialize({});
+				scripting->loadScripts({ script });
+
+				world.run();
+			}
+			else
 			{
 				MyWorld world(window, renderer, scripting);
 
@@ -389,6 +545,15 @@ int main(int argc, char** argv)
 
 			//scripting::ScriptRelease();
 
+			asset::AssetStreamer::getInstance()->terminate();
+			platform::TaskScheduler::terminate();
+
+			// Release what the world let go of while the managers still exist.
+			asset::VioletRefHandler<asset::Mesh>::collectGarbage();
+			asset::VioletRefHandler<asset::Texture>::collectGarbage();
+			asset::VioletRefHandler<asset::Shader>::collectGarbage();
+			asset::VioletRefHandler<asset::Wave>::collectGarbage();
+
 			foundation::Memory::destruct(asset::ShaderManager::getInstance());
 			foundation::Memory::destruct(asset::TextureManager::getInstance());
 			foundation::Memory::destruct(asset::WaveManager::getInstance());
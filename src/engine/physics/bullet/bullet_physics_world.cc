@@ -984,7 +984,8 @@ namespace lambda
 		///////////////////////////////////////////////////////////////////////////
 		void BulletPhysicsWorld::createCollisionBody(entity::Entity entity)
 		{
-			size_t entry = scene_->collider.entity_to_data[entity];
+			// Keyed on the entity index since collider slots move when colliders are removed.
+			size_t entry = entity::getIndex(entity);
 			if (collision_bodies_.size() < entry + 1ull)
 				collision_bodies_.resize(entry + 1ull);
 
@@ -1000,14 +1001,14 @@ namespace lambda
 		///////////////////////////////////////////////////////////////////////////
 		void BulletPhysicsWorld::destroyCollisionBody(entity::Entity entity)
 		{
-			size_t entry = scene_->collider.entity_to_data[entity];
+			size_t entry = entity::getIndex(entity);
 			collision_bodies_[entry] = BulletCollisionBody();
 		}
 
 		///////////////////////////////////////////////////////////////////////////
 		ICollisionBody& BulletPhysicsWorld::getCollisionBody(entity::Entity entity)
 		{
-			size_t entry = scene_->collider.entity_to_data[entity];
+			size_t entry = entity::getIndex(entity);
 			return collision_bodies_[entry];
 		}
 
@@ -825,7 +825,8 @@ namespace lambda
 		///////////////////////////////////////////////////////////////////////////
 		void ReactPhysicsWorld::createCollisionBody(entity::Entity entity)
 		{
-			size_t entry = scene_->collider.entity_to_data[entity];
+			// Keyed on the entity index since collider slots move when colliders are removed.
+			size_t entry = entity::getIndex(entity);
 			if (collision_bodies_.size() < entry + 1ull)
 				collision_bodies_.resize(entry + 1ull);
 
@@ -841,14 +842,14 @@ namespace lambda
 		///////////////////////////////////////////////////////////////////////////
 		void ReactPhysicsWorld::destroyCollisionBody(entity::Entity entity)
 		{
-			size_t entry = scene_->collider.entity_to_data[entity];
+			size_t entry = entity::getIndex(entity);
 			collision_bodies_[entry] = ReactCollisionBody();
 		}
 
 		///////////////////////////////////////////////////////////////////////////
 		ICollisionBody& ReactPhysicsWorld::getCollisionBody(entity::Entity entity)
 		{
-			size_t entry = scene_->collider.entity_to_data[entity];
+			size_t entry = entity::getIndex(entity);
 			return collision_bodies_[entry];
 		}
 
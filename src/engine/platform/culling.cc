@@ -4,7 +4,6 @@
 #include "systems/mesh_render_system.h"
 #include "utils/zone_manager.h"
 #include <memory/frame_heap.h>
-#include "frustum.h"
 #include <algorithm>
 #include <platform/scene.h>
 
@@ -40,40 +39,57 @@ namespace lambda
 			cull_frequency_ = cull_frequency;
 		}
 
+		///////////////////////////////////////////////////////////////////////////
+		void Culler::setCullSphere(const glm::vec3& center, const float& radius)
+		{
+			sphere_center_ = center;
+			sphere_radius_ = radius;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		static uint32_t query(const FlatBVH& bvh, const Frustum& frustum, const glm::vec3& center, float radius, entity::Entity* entities, uint32_t capacity)
+		{
+			if (radius > 0.0f)
+				return bvh.getEntitiesInFrustum(frustum, center, radius, entities, capacity);
+			return bvh.getEntitiesInFrustum(frustum, entities, capacity);
+		}
+
 		////////////////////////////////////////////////////////////////////////////
-		void Culler::cullDynamics(const BaseBVH& bvh, const Frustum& frustum)
+		void Culler::cullDynamics(const FlatBVH& bvh, const Frustum& frustum)
 		{
-			memset(&dynamic_, 0, sizeof(dynamic_));
-			LinkedNode* node_it = &dynamic_;
+			dynamic_ = CullList();
 
-			BVHAABB aabb(frustum.getMin(), frustum.getMax());
+			const uint32_t capacity = bvh.size();
+			if (capacity == 0u)
+				return;
 
-			for (const entity::Entity& entity : bvh.getAllEntityInAABB(frustum))
-			{
-				LinkedNode* node = foundation::GetFrameHeap()->construct<LinkedNode>();
-				node_it->next  = node;
-				node->entity   = entity;
-				node->previous = node_it;
-				node_it        = node;
-			}
+			entity::Entity* entities = (entity::Entity*)foundation::GetFrameHeap()->alloc(capacity * sizeof(entity::Entity), 16u, false);
+			dynamic_.entities = entities;
+			dynamic_.count    = query(bvh, frustum, sphere_center_, sphere_radius_, entities, capacity);
 		}
 
 		////////////////////////////////////////////////////////////////////////////
-		void Culler::cullStatics(const BaseBVH& bvh, const Frustum& frustum)
+		void Culler::cullStatics(const FlatBVH& bvh, const Frustum& frustum)
 		{
-			memset(&static_, 0, sizeof(static_));
-			LinkedNode* node_it = &static_;
-
-			BVHAABB aabb(frustum.getMin(), frustum.getMax());
+			const bool valid = static_cached_ &&
+				static_version_ == bvh.getVersion() &&
+				static_sphere_center_ == sphere_center_ &&
+				static_sphere_radius_ == sphere_radius_ &&
+				static_frustum_.hasSamePlanes(frustum);
 
-			for (const entity::Entity& entity : bvh.getAllEntityInAABB(frustum))
+			if (!valid)
 			{
-				LinkedNode* node = foundation::GetFrameHeap()->construct<LinkedNode>();
-				node_it->next  = node;
-				node->entity   = entity;
-				node->previous = node_it;
-				node_it        = node;
+				static_cache_.resize(bvh.size());
+				static_cache_.resize(query(bvh, frustum, sphere_center_, sphere_radius_, static_cache_.data(), (uint32_t)static_cache_.size()));
+				static_frustum_       = frustum;
+				static_sphere_center_ = sphere_center_;
+				static_sphere_radius_ = sphere_radius_;
+				static_version_       = bvh.getVersion();
+				static_cached_        = true;
 			}
+
+			static_.entities = static_cache_.data();
+			static_.count    = (uint32_t)static_cache_.size();
 		}
 	}
 }
\ No newline at end of file
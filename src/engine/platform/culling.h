@@ -1,20 +1,20 @@
 #pragma once
 #include "systems/mesh_render_system.h"
+#include "frustum.h"
 
 namespace lambda
 {
   namespace utilities
   {
-    class Frustum;
 	class ZoneManager;
-	class BVH;
+	class FlatBVH;
     
     ///////////////////////////////////////////////////////////////////////////
-    struct LinkedNode
+    // The visible entities, packed in the frame heap.
+    struct CullList
     {
-      LinkedNode* previous = nullptr;
-      LinkedNode* next = nullptr;
-      entity::Entity entity = entity::InvalidEntity;
+      const entity::Entity* entities = nullptr;
+      uint32_t count = 0u;
     };
     
     ///////////////////////////////////////////////////////////////////////////
@@ -26,14 +26,27 @@ namespace lambda
       void setShouldCull(const bool& should_cull);
       void setCullShadowCasters(const bool& cull_shadow_casters);
       void setCullFrequency(const uint8_t& cull_frequency);
-	  void cullDynamics(const BaseBVH& bvh, const Frustum& frustum);
-	  void cullStatics(const BaseBVH& bvh, const Frustum& frustum);
-      LinkedNode getDynamics() const { return dynamic_; }
-      LinkedNode getStatics()  const { return static_; }
+      // Only keeps what touches the sphere as well, like the reach of a
+      // light. A radius of zero turns it off.
+      void setCullSphere(const glm::vec3& center, const float& radius);
+	  void cullDynamics(const FlatBVH& bvh, const Frustum& frustum);
+	  void cullStatics(const FlatBVH& bvh, const Frustum& frustum);
+      CullList getDynamics() const { return dynamic_; }
+      CullList getStatics()  const { return static_; }
 
     private:
-      LinkedNode dynamic_;
-      LinkedNode static_;
+      CullList dynamic_;
+      CullList static_;
+      // Statics hardly ever move, so their list is kept until the tree,
+      // the frustum or the sphere changes.
+      Vector<entity::Entity> static_cache_;
+      Frustum   static_frustum_;
+      glm::vec3 static_sphere_center_;
+      float     static_sphere_radius_ = 0.0f;
+      uint32_t  static_version_       = 0u;
+      bool      static_cached_        = false;
+      glm::vec3 sphere_center_        = glm::vec3(0.0f);
+      float     sphere_radius_        = 0.0f;
       //uint8_t frames_since_cull_   = UINT8_MAX;
       uint8_t cull_frequency_      = 1u;
       bool    cull_                = true;
@@ -1,10 +1,25 @@
 #include "frustum.h"
 #include "utils/mt_manager.h"
+#include <cstring>
 #include <utils/console.h>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VIOLET_FRUSTUM_AVX 1
+#else
+#define VIOLET_FRUSTUM_AVX 0
+#endif
+
+#if VIOLET_FRUSTUM_AVX || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define VIOLET_FRUSTUM_SSE 1
+#else
+#define VIOLET_FRUSTUM_SSE 0
+#endif
+
 #if VIOLET_WIN32
 #include <Windows.h>
 #include <process.h>
@@ -44,58 +59,181 @@ namespace lambda
       constructCorners(glm::inverse(matrix));
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    constexpr uint32_t Frustum::kPlaneCount;
+    constexpr uint32_t Frustum::kPlaneLanes;
+
     ///////////////////////////////////////////////////////////////////////////
     bool Frustum::ContainsAABB(
       const glm::vec3& min, 
       const glm::vec3& max) const
     {
-      // Check if any one point of the cube is in the view frustum.
-      for (uint8_t i = 0u; i < 6u; ++i)
+      return classifyAABB(min, max) != FrustumTest::kOutside;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    FrustumTest Frustum::classifyAABB(
+      const glm::vec3& min,
+      const glm::vec3& max) const
+    {
+      // The corner furthest along the normal (p) decides whether the box is
+      // outside a plane, the nearest corner (n) whether it is fully inside.
+#if VIOLET_FRUSTUM_SSE
+      const __m128 zero  = _mm_setzero_ps();
+      const __m128 min_x = _mm_set1_ps(min.x);
+      const __m128 min_y = _mm_set1_ps(min.y);
+      const __m128 min_z = _mm_set1_ps(min.z);
+      const __m128 max_x = _mm_set1_ps(max.x);
+      const __m128 max_y = _mm_set1_ps(max.y);
+      const __m128 max_z = _mm_set1_ps(max.z);
+
+      int intersect = 0;
+      for (uint32_t i = 0u; i < kPlaneLanes; i += 4u)
+      {
+        const __m128 a = _mm_loadu_ps(plane_a_ + i);
+        const __m128 b = _mm_loadu_ps(plane_b_ + i);
+        const __m128 c = _mm_loadu_ps(plane_c_ + i);
+        const __m128 d = _mm_loadu_ps(plane_d_ + i);
+        const __m128 sign_a = _mm_cmpge_ps(a, zero);
+        const __m128 sign_b = _mm_cmpge_ps(b, zero);
+        const __m128 sign_c = _mm_cmpge_ps(c, zero);
+
+        const __m128 p_x = _mm_or_ps(_mm_and_ps(sign_a, max_x), _mm_andnot_ps(sign_a, min_x));
+        const __m128 p_y = _mm_or_ps(_mm_and_ps(sign_b, max_y), _mm_andnot_ps(sign_b, min_y));
+        const __m128 p_z = _mm_or_ps(_mm_and_ps(sign_c, max_z), _mm_andnot_ps(sign_c, min_z));
+        const __m128 p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, p_x), _mm_mul_ps(b, p_y)), _mm_add_ps(_mm_mul_ps(c, p_z), d));
+        if (_mm_movemask_ps(_mm_cmplt_ps(p, zero)) != 0)
+          return FrustumTest::kOutside;
+
+        const __m128 n_x = _mm_or_ps(_mm_and_ps(sign_a, min_x), _mm_andnot_ps(sign_a, max_x));
+        const __m128 n_y = _mm_or_ps(_mm_and_ps(sign_b, min_y), _mm_andnot_ps(sign_b, max_y));
+        const __m128 n_z = _mm_or_ps(_mm_and_ps(sign_c, min_z), _mm_andnot_ps(sign_c, max_z));
+        const __m128 n = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, n_x), _mm_mul_ps(b, n_y)), _mm_add_ps(_mm_mul_ps(c, n_z), d));
+        intersect |= _mm_movemask_ps(_mm_cmplt_ps(n, zero));
+      }
+
+      return intersect != 0 ? FrustumTest::kIntersect : FrustumTest::kInside;
+#else
+      bool intersect = false;
+      for (uint32_t i = 0u; i < kPlaneCount; ++i)
+      {
+        const uint8_t signs = plane_signs_[i];
+        const glm::vec3 p(
+          (signs & 1u) ? max.x : min.x,
+          (signs & 2u) ? max.y : min.y,
+          (signs & 4u) ? max.z : min.z
+        );
+        const glm::vec3 n(
+          (signs & 1u) ? min.x : max.x,
+          (signs & 2u) ? min.y : max.y,
+          (signs & 4u) ? min.z : max.z
+        );
+        if (plane_a_[i] * p.x + plane_b_[i] * p.y + plane_c_[i] * p.z + plane_d_[i] < 0.0f)
+          return FrustumTest::kOutside;
+        if (plane_a_[i] * n.x + plane_b_[i] * n.y + plane_c_[i] * n.z + plane_d_[i] < 0.0f)
+          intersect = true;
+      }
+
+      return intersect ? FrustumTest::kIntersect : FrustumTest::kInside;
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    uint32_t Frustum::cullAABBs(
+      const AABBArrays& aabbs,
+      uint32_t first,
+      uint32_t count,
+      uint32_t* visible) const
+    {
+      // The sign of a plane is the same for every box, so the arrays that hold
+      // the corner furthest along the normal are picked once per plane.
+      const float* p_x[kPlaneCount];
+      const float* p_y[kPlaneCount];
+      const float* p_z[kPlaneCount];
+      for (uint32_t p = 0u; p < kPlaneCount; ++p)
       {
-        if (planes_[i].dot(glm::vec3(min.x, min.y, min.z)) < 0.0f &&
-            planes_[i].dot(glm::vec3(min.x, min.y, max.z)) < 0.0f &&
-            planes_[i].dot(glm::vec3(min.x, max.y, min.z)) < 0.0f &&
-            planes_[i].dot(glm::vec3(min.x, max.y, max.z)) < 0.0f &&
-            planes_[i].dot(glm::vec3(max.x, min.y, min.z)) < 0.0f &&
-            planes_[i].dot(glm::vec3(max.x, min.y, max.z)) < 0.0f &&
-            planes_[i].dot(glm::vec3(max.x, max.y, min.z)) < 0.0f &&
-            planes_[i].dot(glm::vec3(max.x, max.y, max.z)) < 0.0f)
+        p_x[p] = (plane_signs_[p] & 1u) ? aabbs.max_x : aabbs.min_x;
+        p_y[p] = (plane_signs_[p] & 2u) ? aabbs.max_y : aabbs.min_y;
+        p_z[p] = (plane_signs_[p] & 4u) ? aabbs.max_z : aabbs.min_z;
+      }
+
+      // Writes every lane and only advances past the visible ones, which
+      // keeps the compaction free of branches.
+      const uint32_t end = first + count;
+      uint32_t found = 0u;
+      uint32_t i = first;
+
+#if VIOLET_FRUSTUM_AVX
+      const __m256 zero8 = _mm256_setzero_ps();
+      for (; i + 8u <= end; i += 8u)
+      {
+        __m256 outside = zero8;
+        for (uint32_t p = 0u; p < kPlaneCount; ++p)
         {
-          return false;
+          const __m256 distance = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane_a_[p]), _mm256_loadu_ps(p_x[p] + i)), _mm256_mul_ps(_mm256_set1_ps(plane_b_[p]), _mm256_loadu_ps(p_y[p] + i))),
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane_c_[p]), _mm256_loadu_ps(p_z[p] + i)), _mm256_set1_ps(plane_d_[p]))
+          );
+          outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, zero8, _CMP_LT_OQ));
+        }
+
+        const uint32_t mask = ~(uint32_t)_mm256_movemask_ps(outside);
+        for (uint32_t lane = 0u; lane < 8u; ++lane)
+        {
+          visible[found] = i + lane;
+          found += (mask >> lane) & 1u;
         }
       }
+#endif
 
-      return true;
+#if VIOLET_FRUSTUM_SSE
+      const __m128 zero = _mm_setzero_ps();
+      for (; i + 4u <= end; i += 4u)
+      {
+        __m128 outside = zero;
+        for (uint32_t p = 0u; p < kPlaneCount; ++p)
+        {
+          const __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane_a_[p]), _mm_loadu_ps(p_x[p] + i)), _mm_mul_ps(_mm_set1_ps(plane_b_[p]), _mm_loadu_ps(p_y[p] + i))),
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane_c_[p]), _mm_loadu_ps(p_z[p] + i)), _mm_set1_ps(plane_d_[p]))
+          );
+          outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+        }
+
+        const uint32_t mask = ~(uint32_t)_mm_movemask_ps(outside);
+        for (uint32_t lane = 0u; lane < 4u; ++lane)
+        {
+          visible[found] = i + lane;
+          found += (mask >> lane) & 1u;
+        }
+      }
+#endif
+
+      for (; i < end; ++i)
+      {
+        uint32_t inside = 1u;
+        for (uint32_t p = 0u; p < kPlaneCount; ++p)
+        {
+          const float distance = plane_a_[p] * p_x[p][i] + plane_b_[p] * p_y[p][i] + plane_c_[p] * p_z[p][i] + plane_d_[p];
+          inside &= distance >= 0.0f ? 1u : 0u;
+        }
+        visible[found] = i;
+        found += inside;
+      }
+
+      return found;
     }
 
     ///////////////////////////////////////////////////////////////////////////
     bool Frustum::ContainsSphere(const glm::vec3& position, const float& radius) const
     {
-      if      (planes_[0].a * position.x + planes_[0].b * 
-        position.y + planes_[0].c * 
-        position.z + planes_[0].d <= -radius) { return false; }
-      
-      else if (planes_[1].a * position.x + planes_[1].b * 
-        position.y + planes_[1].c * 
-        position.z + planes_[1].d <= -radius) { return false; }
-      
-      else if (planes_[2].a * position.x + planes_[2].b * 
-        position.y + planes_[2].c * 
-        position.z + planes_[2].d <= -radius) { return false; }
-      
-      else if (planes_[3].a * position.x + planes_[3].b * 
-        position.y + planes_[3].c * 
-        position.z + planes_[3].d <= -radius) { return false; }
-      
-      else if (planes_[4].a * position.x + planes_[4].b * 
-        position.y + planes_[4].c * 
-        position.z + planes_[4].d <= -radius) { return false; }
-      
-      else if (planes_[5].a * position.x + planes_[5].b * 
-        position.y + planes_[5].c * 
-        position.z + planes_[5].d <= -radius) { return false; }
-      
-      else { return true;  }
+      for (uint32_t i = 0u; i < kPlaneCount; ++i)
+      {
+        if (plane_a_[i] * position.x + plane_b_[i] * position.y + plane_c_[i] * position.z + plane_d_[i] <= -radius)
+          return false;
+      }
+
+      return true;
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -127,7 +265,19 @@ namespace lambda
     ///////////////////////////////////////////////////////////////////////////
     Vector<Plane> Frustum::getPlanes() const
     {
-      return planes_;
+      Vector<Plane> planes(kPlaneCount);
+      for (uint32_t i = 0u; i < kPlaneCount; ++i)
+        planes[i] = { plane_a_[i], plane_b_[i], plane_c_[i], plane_d_[i] };
+      return planes;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool Frustum::hasSamePlanes(const Frustum& other) const
+    {
+      return memcmp(plane_a_, other.plane_a_, sizeof(plane_a_)) == 0 &&
+             memcmp(plane_b_, other.plane_b_, sizeof(plane_b_)) == 0 &&
+             memcmp(plane_c_, other.plane_c_, sizeof(plane_c_)) == 0 &&
+             memcmp(plane_d_, other.plane_d_, sizeof(plane_d_)) == 0;
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -157,47 +307,60 @@ namespace lambda
     ///////////////////////////////////////////////////////////////////////////
     void Frustum::constructPlanes(const glm::mat4x4& matrix)
     {
-      planes_.resize(8u);
+      Plane planes[kPlaneCount];
       // Calculate near plane of frustum.
-      planes_[0].a = matrix[0][3] + matrix[0][2];
-      planes_[0].b = matrix[1][3] + matrix[1][2];
-      planes_[0].c = matrix[2][3] + matrix[2][2];
-      planes_[0].d = matrix[3][3] + matrix[3][2];
+      planes[0].a = matrix[0][3] + matrix[0][2];
+      planes[0].b = matrix[1][3] + matrix[1][2];
+      planes[0].c = matrix[2][3] + matrix[2][2];
+      planes[0].d = matrix[3][3] + matrix[3][2];
 
       // Calculate far plane of frustum.
-      planes_[1].a = matrix[0][3] - matrix[0][2];
-      planes_[1].b = matrix[1][3] - matrix[1][2];
-      planes_[1].c = matrix[2][3] - matrix[2][2];
-      planes_[1].d = matrix[3][3] - matrix[3][2];
+      planes[1].a = matrix[0][3] - matrix[0][2];
+      planes[1].b = matrix[1][3] - matrix[1][2];
+      planes[1].c = matrix[2][3] - matrix[2][2];
+      planes[1].d = matrix[3][3] - matrix[3][2];
 
       // Calculate left plane of frustum.
-      planes_[2].a = matrix[0][3] + matrix[0][0];
-      planes_[2].b = matrix[1][3] + matrix[1][0];
-      planes_[2].c = matrix[2][3] + matrix[2][0];
-      planes_[2].d = matrix[3][3] + matrix[3][0];
+      planes[2].a = matrix[0][3] + matrix[0][0];
+      planes[2].b = matrix[1][3] + matrix[1][0];
+      planes[2].c = matrix[2][3] + matrix[2][0];
+      planes[2].d = matrix[3][3] + matrix[3][0];
 
       // Calculate right plane of frustum.
-      planes_[3].a = matrix[0][3] - matrix[0][0];
-      planes_[3].b = matrix[1][3] - matrix[1][0];
-      planes_[3].c = matrix[2][3] - matrix[2][0];
-      planes_[3].d = matrix[3][3] - matrix[3][0];
+      planes[3].a = matrix[0][3] - matrix[0][0];
+      planes[3].b = matrix[1][3] - matrix[1][0];
+      planes[3].c = matrix[2][3] - matrix[2][0];
+      planes[3].d = matrix[3][3] - matrix[3][0];
 
       // Calculate top plane of frustum.
-      planes_[4].a = matrix[0][3] - matrix[0][1];
-      planes_[4].b = matrix[1][3] - matrix[1][1];
-      planes_[4].c = matrix[2][3] - matrix[2][1];
-      planes_[4].d = matrix[3][3] - matrix[3][1];
+      planes[4].a = matrix[0][3] - matrix[0][1];
+      planes[4].b = matrix[1][3] - matrix[1][1];
+      planes[4].c = matrix[2][3] - matrix[2][1];
+      planes[4].d = matrix[3][3] - matrix[3][1];
 
       // Calculate bottom plane of frustum.
-      planes_[5].a = matrix[0][3] + matrix[0][1];
-      planes_[5].b = matrix[1][3] + matrix[1][1];
-      planes_[5].c = matrix[2][3] + matrix[2][1];
-      planes_[5].d = matrix[3][3] + matrix[3][1];
+      planes[5].a = matrix[0][3] + matrix[0][1];
+      planes[5].b = matrix[1][3] + matrix[1][1];
+      planes[5].c = matrix[2][3] + matrix[2][1];
+      planes[5].d = matrix[3][3] + matrix[3][1];
+
+      // Normalize planes and store them as SoA.
+      for (uint8_t i = 0u; i < kPlaneCount; ++i)
+      {
+        planes[i].normalize();
+        plane_a_[i] = planes[i].a;
+        plane_b_[i] = planes[i].b;
+        plane_c_[i] = planes[i].c;
+        plane_d_[i] = planes[i].d;
+        plane_signs_[i] = (planes[i].a >= 0.0f ? 1u : 0u) | (planes[i].b >= 0.0f ? 2u : 0u) | (planes[i].c >= 0.0f ? 4u : 0u);
+      }
 
-      // Normalize planes.
-      for (uint8_t i = 0u; i < 6u; ++i)
+      for (uint8_t i = kPlaneCount; i < kPlaneLanes; ++i)
       {
-        planes_[i].normalize();
+        plane_a_[i] = 0.0f;
+        plane_b_[i] = 0.0f;
+        plane_c_[i] = 0.0f;
+        plane_d_[i] = 1.0f;
       }
     }
 
@@ -67,12 +67,48 @@ namespace lambda
       float d;
     };
 
+    ///////////////////////////////////////////////////////////////////////////
+    enum class FrustumTest : uint8_t
+    {
+      kOutside,
+      kIntersect,
+      kInside
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Boxes with one array per component, so a batch of them can be loaded
+    // straight into SIMD registers.
+    struct AABBArrays
+    {
+      const float* min_x;
+      const float* min_y;
+      const float* min_z;
+      const float* max_x;
+      const float* max_y;
+      const float* max_z;
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     class Frustum
     {
     public:
+      static constexpr uint32_t kPlaneCount = 6u;
+      // Padded so the planes fill two SSE registers or one AVX register.
+      static constexpr uint32_t kPlaneLanes = 8u;
+
       void construct(glm::mat4x4 projection, const glm::mat4x4& view);
       bool ContainsAABB(const glm::vec3& min, const glm::vec3& max) const;
+      // Tells whether a box is outside, partly inside or fully inside.
+      FrustumTest classifyAABB(const glm::vec3& min, const glm::vec3& max) const;
+      // Tests the boxes [first, first + count) four or eight at a time and
+      // writes the indices of the visible ones to visible, which needs room
+      // for count indices. Returns the number written.
+      uint32_t cullAABBs(
+        const AABBArrays& aabbs,
+        uint32_t first,
+        uint32_t count,
+        uint32_t* visible
+      ) const;
       bool ContainsSphere(
         const glm::vec3& position, 
         const float& radius
@@ -83,6 +119,8 @@ namespace lambda
         const CullType& type
       ) const;
       Vector<Plane> getPlanes() const;
+      // Whether both were constructed from the same matrices.
+      bool hasSamePlanes(const Frustum& other) const;
       Vector<glm::vec3> getCorners() const;
       glm::vec3 getCenter() const;
       glm::vec3 getMin() const;
@@ -93,7 +131,14 @@ namespace lambda
       void constructCorners(const glm::mat4x4& matrix);
 
     private:
-      Vector<Plane> planes_;
+      // Plane coefficients in SoA. The padding planes contain everything.
+      float plane_a_[kPlaneLanes];
+      float plane_b_[kPlaneLanes];
+      float plane_c_[kPlaneLanes];
+      float plane_d_[kPlaneLanes];
+      // Bit per axis that is set when the normal points along it. Picks the
+      // corner of a box that is furthest along the normal.
+      uint8_t plane_signs_[kPlaneCount];
       Vector<glm::vec3> corners_;
       glm::vec3 center_;
       glm::vec3 min_;
@@ -0,0 +1,263 @@
+#include "render_queue.h"
+#include <interfaces/irenderer.h>
+#include <cstring>
+
+namespace lambda
+{
+	namespace platform
+	{
+		///////////////////////////////////////////////////////////////////////////
+		void RenderStats::add(const RenderStats& other)
+		{
+			draw_calls            += other.draw_calls;
+			instances             += other.instances;
+			state_changes         += other.state_changes;
+			skipped_state_changes += other.skipped_state_changes;
+			commands              += other.commands;
+			buffer_bytes          += other.buffer_bytes;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		constexpr uint32_t RenderQueue::kMaxInstances;
+		constexpr uint8_t RenderQueue::kFlagAlpha;
+		constexpr uint8_t RenderQueue::kFlagDoubleSided;
+
+		///////////////////////////////////////////////////////////////////////////
+		// Same layout as cbPerMesh in common.fxh.
+		struct PerMeshData
+		{
+			glm::mat4x4 model_matrix[RenderQueue::kMaxInstances];
+			glm::vec4   metallic_roughness[RenderQueue::kMaxInstances];
+			glm::vec4   emissiveness[RenderQueue::kMaxInstances];
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		void RenderQueue::add(const utilities::Renderable& renderable, bool alpha, const glm::vec3& eye)
+		{
+			// Double sided and alpha tested meshes are drawn without culling.
+			const auto& sub_mesh = renderable.mesh->getSubMeshes().at(renderable.sub_mesh);
+			const bool double_sided = sub_mesh.io.double_sided == true || (sub_mesh.io.tex_alb >= 0 && renderable.mesh->getAttachedTextures().at(sub_mesh.io.tex_alb)->getLayer(0u).containsAlpha());
+
+			size_t mesh = renderable.mesh.getHash();
+			hashCombine(mesh, renderable.sub_mesh);
+			size_t material = renderable.albedo_texture.getHash();
+			hashCombine(material, renderable.normal_texture.getHash());
+			hashCombine(material, renderable.dmra_texture.getHash());
+			hashCombine(material, renderable.emissive_texture.getHash());
+
+			// Positive floats sort the same as their bits.
+			const glm::vec3 offset = renderable.center - eye;
+			const float distance = glm::dot(offset, offset);
+			uint32_t depth;
+			memcpy(&depth, &distance, sizeof(depth));
+
+			// The hashes only decide the order. Whether two renderables can
+			// share a draw is checked on the renderables themselves.
+			uint64_t key;
+			if (!alpha)
+			{
+				key = ((uint64_t)double_sided << 62u) |
+				      ((uint64_t)(mesh & 0xFFFFFu) << 42u) |
+				      ((uint64_t)(material & 0xFFFFFu) << 22u) |
+				      (uint64_t)(depth >> 10u);
+			}
+			else
+			{
+				key = (1ull << 63u) |
+				      ((uint64_t)(~depth >> 1u) << 32u) |
+				      ((uint64_t)double_sided << 31u) |
+				      ((uint64_t)(mesh & 0x7FFFu) << 16u) |
+				      (uint64_t)(material & 0xFFFFu);
+			}
+
+			items_.push_back({ key, (uint32_t)renderables_.size() });
+			renderables_.push_back(renderable);
+			flags_.push_back((alpha ? kFlagAlpha : 0u) | (double_sided ? kFlagDoubleSided : 0u));
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void RenderQueue::sort()
+		{
+			const uint32_t count = (uint32_t)items_.size();
+			if (count < 2u)
+				return;
+
+			// LSD radix sort, one byte per pass. All histograms are built in a
+			// single pass over the keys.
+			uint32_t histograms[8u][256u] = {};
+			for (const SortItem& item : items_)
+				for (uint32_t b = 0u; b < 8u; ++b)
+					histograms[b][(item.key >> (b * 8u)) & 0xFFu]++;
+
+			Vector<SortItem> scratch(count);
+			SortItem* src = items_.data();
+			SortItem* dst = scratch.data();
+			for (uint32_t b = 0u; b < 8u; ++b)
+			{
+				const uint32_t shift = b * 8u;
+				uint32_t* histogram = histograms[b];
+
+				// All keys share this byte, so the pass would not move anything.
+				if (histogram[(src[0].key >> shift) & 0xFFu] == count)
+					continue;
+
+				uint32_t offset = 0u;
+				for (uint32_t v = 0u; v < 256u; ++v)
+				{
+					const uint32_t bucket = histogram[v];
+					histogram[v] = offset;
+					offset += bucket;
+				}
+
+				for (uint32_t i = 0u; i < count; ++i)
+					dst[histogram[(src[i].key >> shift) & 0xFFu]++] = src[i];
+
+				SortItem* temp = src;
+				src = dst;
+				dst = temp;
+			}
+
+			if (src != items_.data())
+				items_.swap(scratch);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void RenderQueue::clear()
+		{
+			renderables_.clear();
+			flags_.clear();
+			items_.clear();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		uint32_t RenderQueue::size() const
+		{
+			return (uint32_t)items_.size();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		bool RenderQueue::empty() const
+		{
+			return items_.empty();
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		bool RenderQueue::canInstance(uint32_t a, uint32_t b) const
+		{
+			const utilities::Renderable& lhs = renderables_[a];
+			const utilities::Renderable& rhs = renderables_[b];
+			return flags_[a]            == flags_[b] &&
+			       lhs.mesh             == rhs.mesh &&
+			       lhs.sub_mesh         == rhs.sub_mesh &&
+			       lhs.albedo_texture   == rhs.albedo_texture &&
+			       lhs.normal_texture   == rhs.normal_texture &&
+			       lhs.dmra_texture     == rhs.dmra_texture &&
+			       lhs.emissive_texture == rhs.emissive_texture;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void RenderQueue::render(
+			IRenderer* renderer,
+			RasterizerState::CullMode cull_mode,
+			const BlendState& opaque_blend,
+			const BlendState& alpha_blend,
+			RenderStats& stats) const
+		{
+			if (items_.empty())
+				return;
+
+			platform::IRenderBuffer* cb = renderer->allocRenderBuffer(sizeof(PerMeshData), platform::IRenderBuffer::kFlagConstant | platform::IRenderBuffer::kFlagTransient | platform::IRenderBuffer::kFlagDynamic);
+			renderer->setConstantBuffer(cb, cbPerMeshIdx);
+
+			RasterizerState culled = RasterizerState::SolidNone();
+			if (cull_mode == RasterizerState::CullMode::kBack)
+				culled = RasterizerState::SolidBack();
+			else if (cull_mode == RasterizerState::CullMode::kFront)
+				culled = RasterizerState::SolidFront();
+
+			// Nothing is known to be bound when the queue starts.
+			const utilities::Renderable* bound = nullptr;
+			uint8_t bound_flags = 0u;
+
+			const uint32_t count = (uint32_t)items_.size();
+			for (uint32_t i = 0u; i < count;)
+			{
+				const uint32_t first = items_[i].index;
+				uint32_t end = i + 1u;
+				while (end < count && end - i < kMaxInstances && canInstance(first, items_[end].index))
+					end++;
+
+				const utilities::Renderable& renderable = renderables_[first];
+				const uint8_t flags = flags_[first];
+
+				if (!bound || (bound_flags & kFlagAlpha) != (flags & kFlagAlpha))
+				{
+					renderer->setBlendState((flags & kFlagAlpha) ? alpha_blend : opaque_blend);
+					stats.state_changes++;
+				}
+				else
+					stats.skipped_state_changes++;
+
+				if (!bound || (bound_flags & kFlagDoubleSided) != (flags & kFlagDoubleSided))
+				{
+					renderer->setRasterizerState((flags & kFlagDoubleSided) ? RasterizerState::SolidNone() : culled);
+					stats.state_changes++;
+				}
+				else
+					stats.skipped_state_changes++;
+
+				if (!bound || bound->mesh != renderable.mesh || bound->sub_mesh != renderable.sub_mesh)
+				{
+					renderer->setMesh(renderable.mesh);
+					renderer->setSubMesh(renderable.sub_mesh);
+					stats.state_changes += 2u;
+				}
+				else
+					stats.skipped_state_changes += 2u;
+
+				const asset::VioletTextureRef* textures[] = {
+					&renderable.albedo_texture,
+					&renderable.normal_texture,
+					&renderable.dmra_texture,
+					&renderable.emissive_texture,
+				};
+				const asset::VioletTextureRef* bound_textures[] = {
+					bound ? &bound->albedo_texture   : nullptr,
+					bound ? &bound->normal_texture   : nullptr,
+					bound ? &bound->dmra_texture     : nullptr,
+					bound ? &bound->emissive_texture : nullptr,
+				};
+				for (uint8_t slot = 0u; slot < 4u; ++slot)
+				{
+					if (!bound_textures[slot] || *bound_textures[slot] != *textures[slot])
+					{
+						renderer->setTexture(*textures[slot], slot);
+						stats.state_changes++;
+					}
+					else
+						stats.skipped_state_changes++;
+				}
+
+				// Only the instances that are drawn are written.
+				const uint32_t instance_count = end - i;
+				PerMeshData* data = (PerMeshData*)cb->lock();
+				for (uint32_t j = 0u; j < instance_count; ++j)
+				{
+					const utilities::Renderable& instance = renderables_[items_[i + j].index];
+					data->model_matrix[j]       = instance.model_matrix;
+					data->metallic_roughness[j] = glm::vec4(instance.metallicness, instance.roughness, 0.0f, 0.0f);
+					data->emissiveness[j]       = glm::vec4(instance.emissiveness.x, instance.emissiveness.y, instance.emissiveness.z, 0.0f);
+				}
+				cb->unlock();
+
+				renderer->draw(instance_count);
+				stats.draw_calls++;
+				stats.instances += instance_count;
+
+				bound       = &renderable;
+				bound_flags = flags;
+				i           = end;
+			}
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "utils/renderable.h"
+#include "platform/rasterizer_state.h"
+#include "platform/blend_state.h"
+#include <containers/containers.h>
+
+namespace lambda
+{
+	namespace platform
+	{
+		class IRenderer;
+
+		///////////////////////////////////////////////////////////////////////////
+		// What drawing cost the renderer. A state change is a mesh, sub-mesh,
+		// texture, rasterizer or blend state that was set. Skipped ones were
+		// equal to what the previous draw left bound. Commands and buffer
+		// bytes are only counted by renderers that record their commands.
+		struct RenderStats
+		{
+			uint32_t draw_calls            = 0u;
+			uint32_t instances             = 0u;
+			uint32_t state_changes         = 0u;
+			uint32_t skipped_state_changes = 0u;
+			uint64_t commands              = 0u;
+			uint64_t buffer_bytes          = 0u;
+
+			void add(const RenderStats& other);
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// The renderables of one view, sorted on a 64 bit key. Runs that share
+		// the mesh, sub-mesh, material and rasterizer state are drawn as one
+		// instanced draw and state that did not change is not set again.
+		// Shaders are bound by the shader pass around the queue, so the key
+		// orders on blend, rasterizer state, mesh, material and depth. Opaque
+		// renderables are grouped by mesh and then go front to back, alpha
+		// renderables go back to front.
+		class RenderQueue
+		{
+		public:
+			// Has to match kPerMeshCount in common.fxh.
+			static constexpr uint32_t kMaxInstances = 64u;
+
+			void add(const utilities::Renderable& renderable, bool alpha, const glm::vec3& eye);
+			void sort();
+			void clear();
+			uint32_t size() const;
+			bool empty() const;
+
+			void render(
+				IRenderer* renderer,
+				RasterizerState::CullMode cull_mode,
+				const BlendState& opaque_blend,
+				const BlendState& alpha_blend,
+				RenderStats& stats
+			) const;
+
+		private:
+			struct SortItem
+			{
+				uint64_t key;
+				uint32_t index;
+			};
+
+			static constexpr uint8_t kFlagAlpha       = 1u << 0u;
+			static constexpr uint8_t kFlagDoubleSided = 1u << 1u;
+
+			bool canInstance(uint32_t a, uint32_t b) const;
+
+			Vector<utilities::Renderable> renderables_;
+			Vector<uint8_t>               flags_;
+			Vector<SortItem>              items_;
+		};
+	}
+}
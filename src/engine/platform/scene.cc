@@ -8,8 +8,11 @@
 #include "platform/depth_stencil_state.h"
 #include "platform/blend_state.h"
 #include "platform/rasterizer_state.h"
+#include "platform/render_queue.h"
 #include <gui/gui.h>
 #include <memory/frame_heap.h>
+#include <utils/timer.h>
+#include <utils/profiler.h>
 #include <algorithm>
 #include <utils/decompose_matrix.h>
 #include <rapidjson/document.h>
@@ -19,9 +22,9 @@
 #include <utils/register_serializer.h>
 #include <utils/register_meta.h>
 #include <interfaces/irenderer.h>
+#include <assets/texture_streamer.h>
 
 #define USE_MT 1
-#define USE_RENDERABLES 0
 
 #if USE_MT
 #include "utils/mt_manager.h"
@@ -46,9 +49,13 @@ namespace lambda
 		}
 		void sceneUpdate(const float& delta_time, scene::Scene& scene)
 		{
+			asset::AssetStreamer::getInstance()->dispatchCallbacks();
 			components::LODSystem::update(delta_time, scene);
 			components::MonoBehaviourSystem::update(delta_time, scene);
 			components::WaveSourceSystem::update(delta_time, scene);
+#if VIOLET_NETWORKING
+			components::ReplicationSystem::update(delta_time, scene);
+#endif
 		}
 
 		void sceneFixedUpdate(const float& delta_time, scene::Scene& scene)
@@ -57,25 +64,6 @@ namespace lambda
 			components::MonoBehaviourSystem::fixedUpdate(delta_time, scene);
 		}
 
-#if USE_RENDERABLES
-		struct SceneRenderable
-		{
-			~SceneRenderable() {}
-
-			glm::mat4x4* mm;
-			glm::vec4* mr;
-			glm::vec4* em;
-			uint32_t model_count = 0ul;
-			uint32_t model_size = 0ul;
-			asset::VioletMeshHandle mesh;
-			uint32_t sub_mesh;
-			asset::VioletTextureHandle albedo;
-			asset::VioletTextureHandle normal;
-			asset::VioletTextureHandle dmra;
-			asset::VioletTextureHandle emissive;
-		};
-#endif
-
 		struct SceneShaderPass
 		{
 			~SceneShaderPass() {};
@@ -100,13 +88,8 @@ namespace lambda
 			glm::vec3 position;
 			float near;
 			float far;
-#if USE_RENDERABLES
-			Vector<SceneRenderable> renderables;
-#else
-			Vector<utilities::Renderable> opaque;
-			Vector<utilities::Renderable> alpha;
-#endif
-			Vector<SceneShaderPass>  shader_passes;
+			platform::RenderQueue   queue;
+			Vector<SceneShaderPass> shader_passes;
 
 			void operator=(const CameraBatch& other)
 			{
@@ -116,12 +99,7 @@ namespace lambda
 				near          = other.near;
 				far           = other.far;
 				shader_passes = other.shader_passes;
-#if USE_RENDERABLES
-				renderables   = other.renderables;
-#else
-				opaque        = other.opaque;
-				alpha         = other.alpha;
-#endif
+				queue         = other.queue;
 			}
 		};
 
@@ -136,12 +114,7 @@ namespace lambda
 				glm::mat4x4 view_projection;
 				glm::vec3   direction;
 
-#if USE_RENDERABLES
-				Vector<SceneRenderable>  renderables;
-#else
-				Vector<utilities::Renderable> opaque;
-				Vector<utilities::Renderable> alpha;
-#endif
+				platform::RenderQueue queue;
 
 				SceneShaderPass           generate;
 				Vector<SceneShaderPass>   modify;
@@ -150,12 +123,7 @@ namespace lambda
 				{
 					view_projection = other.view_projection;
 					direction       = other.direction;
-#if USE_RENDERABLES
-					renderables     = other.renderables;
-#else
-					opaque          = other.opaque;
-					alpha           = other.alpha;
-#endif
+					queue           = other.queue;
 					generate        = other.generate;
 					modify          = other.modify;
 				}
@@ -189,186 +157,53 @@ namespace lambda
 			}
 		};
 
-#if USE_RENDERABLES
-		static constexpr uint32_t kNumRenderModels = 8ull;
-		void convertRenderableList(const Vector<utilities::Renderable>& u_renderables, Vector<SceneRenderable>& s_renderables)
+		// Culls and sorts the render queue of one view. Views only read the
+		// scene, so they run as jobs once every batch has been set up.
+		struct ViewJob
 		{
-			for (const utilities::Renderable& renderable : u_renderables)
-			{
-				bool found = false;
-				for (auto s_renderable : s_renderables)
-				{
-					if (s_renderable.mesh     == renderable.mesh &&
-						s_renderable.sub_mesh == renderable.sub_mesh &&
-						s_renderable.albedo   == renderable.albedo_texture &&
-						s_renderable.normal   == renderable.normal_texture &&
-						s_renderable.dmra     == renderable.dmra_texture &&
-						s_renderable.emissive == renderable.emissive_texture)
-					{
-						if (s_renderable.model_count + 1ul > s_renderable.model_size)
-						{
-							uint32_t new_model_size = s_renderable.model_size + kNumRenderModels;
-							s_renderable.mm = (glm::mat4x4*)foundation::GetFrameHeap()->realloc(
-								s_renderable.mm,
-								sizeof(glm::mat4x4) * s_renderable.model_size,
-								sizeof(glm::mat4x4) * new_model_size
-							);
-							s_renderable.mr = (glm::vec4*)foundation::GetFrameHeap()->realloc(
-								s_renderable.mr,
-								sizeof(glm::vec4) * s_renderable.model_size,
-								sizeof(glm::vec4) * new_model_size
-							);
-							s_renderable.em = (glm::vec4*)foundation::GetFrameHeap()->realloc(
-								s_renderable.em,
-								sizeof(glm::vec4) * s_renderable.model_size,
-								sizeof(glm::vec4) * new_model_size
-							);
-							s_renderable.model_size = new_model_size;
-						}
-						s_renderable.mm[s_renderable.model_count]   = renderable.model_matrix;
-						s_renderable.mr[s_renderable.model_count]   = glm::vec4(renderable.metallicness, renderable.roughness, 0.0f, 0.0f);
-						s_renderable.em[s_renderable.model_count++] = glm::vec4(renderable.emissiveness.x, renderable.emissiveness.y, renderable.emissiveness.z, 0.0f);
-						found = true;
-						break;
-					}
-				}
-
-				if (!found)
-				{
-					SceneRenderable s_renderable;
-					s_renderable.mesh     = renderable.mesh;
-					s_renderable.sub_mesh = renderable.sub_mesh;
-					s_renderable.albedo   = renderable.albedo_texture;
-					s_renderable.normal   = renderable.normal_texture;
-					s_renderable.dmra     = renderable.dmra_texture;
-					s_renderable.emissive = renderable.emissive_texture;
-					s_renderable.model_count = 0ul;
-					s_renderable.model_size  = 1ul;
-					s_renderable.mm = (glm::mat4x4*)foundation::GetFrameHeap()->alloc(sizeof(glm::mat4x4) * s_renderable.model_size);
-					s_renderable.mr = (glm::vec4*)foundation::GetFrameHeap()->alloc(sizeof(glm::vec4) * s_renderable.model_size);
-					s_renderable.em = (glm::vec4*)foundation::GetFrameHeap()->alloc(sizeof(glm::vec4) * s_renderable.model_size);
-					
-					if (renderable.emissiveness.x != 0.0f || renderable.emissiveness.y != 0.0f || renderable.emissiveness.z != 0.0f)
-						int xxx = 0;
-					
-					s_renderable.mm[s_renderable.model_count]   = renderable.model_matrix;
-					s_renderable.mr[s_renderable.model_count]   = glm::vec4(renderable.metallicness, renderable.roughness, 0.0, 0.0f);
-					s_renderable.em[s_renderable.model_count++] = glm::vec4(renderable.emissiveness.x, renderable.emissiveness.y, renderable.emissiveness.z, 0.0f);
-					s_renderables.push_back(s_renderable);
-				}
-			}
-		}
+			static constexpr uint32_t kCamera = ~0u;
+
+			utilities::Frustum     frustum;
+			utilities::Culler*     culler;
+			glm::vec3              eye;
+			// Index of the light batch or kCamera.
+			uint32_t               batch;
+			uint32_t               face;
+			bool                   dynamics;
+			platform::RenderQueue* queue;
+		};
+		constexpr uint32_t ViewJob::kCamera;
 
-		void renderMeshes(platform::IRenderer* renderer, const Vector<SceneRenderable>& renderables, platform::RasterizerState::CullMode cull_mode)
+		struct ViewJobs
 		{
-			struct CBData
-			{
-				glm::mat4x4 mm[64];
-				glm::vec4 mr[64];
-				glm::vec4 em[64];
-			} data;
-
-			platform::IRenderBuffer* cb = renderer->allocRenderBuffer(sizeof(data), platform::IRenderBuffer::kFlagConstant | platform::IRenderBuffer::kFlagTransient | platform::IRenderBuffer::kFlagDynamic, &data);
-			renderer->setConstantBuffer(cb, cbPerMeshIdx);
-
-			renderer->setBlendState(platform::BlendState::Alpha());
-			for (const SceneRenderable& renderable : renderables)
-			{
-				renderer->setMesh(renderable.mesh);
-				renderer->setSubMesh(renderable.sub_mesh);
-
-				renderer->setTexture(renderable.albedo,   0);
-				renderer->setTexture(renderable.normal,   1);
-				renderer->setTexture(renderable.dmra,     2);
-				renderer->setTexture(renderable.emissive, 3);
-
-				auto sub_mesh = renderable.mesh->getSubMeshes().at(renderable.sub_mesh);
-				// TODO (Hilze): Implement.
-				if (sub_mesh.io.double_sided == true || (sub_mesh.io.tex_alb >= 0 && renderable.mesh->getAttachedTextures().at(sub_mesh.io.tex_alb)->getLayer(0u).containsAlpha()))
-					renderer->setRasterizerState(platform::RasterizerState::SolidNone());
-				else
-				{
-					if (cull_mode == platform::RasterizerState::CullMode::kBack)
-						renderer->setRasterizerState(platform::RasterizerState::SolidBack());
-					else if (cull_mode == platform::RasterizerState::CullMode::kFront)
-						renderer->setRasterizerState(platform::RasterizerState::SolidFront());
-					else
-						renderer->setRasterizerState(platform::RasterizerState::SolidNone());
-				}
-
-				uint32_t offset = 0u;
-				while (offset < renderable.model_count)
-				{
-					uint32_t count = std::min(renderable.model_count - offset, 64u);
-					memcpy(data.mm, renderable.mm + offset, count * sizeof(glm::mat4x4));
-					memcpy(data.mr, renderable.mr + offset, count * sizeof(glm::vec4));
-					memcpy(data.em, renderable.em + offset, count * sizeof(glm::vec4));
-					memcpy(cb->lock(), &data, sizeof(data));
-					cb->unlock();
-
-					renderer->draw(count);
-					offset += 64;
-				}
+			Scene*   scene;
+			ViewJob* jobs;
+		};
 
-				//foundation::GetFrameHeap()->deconstruct(renderable);
-			}
-		}
-#else
-		void renderMeshes(platform::IRenderer* renderer, const Vector<utilities::Renderable>& renderables, platform::RasterizerState::CullMode cull_mode)
+		static void cullViews(uint32_t begin, uint32_t end, void* user_data)
 		{
-			struct CBData
-			{
-				glm::mat4x4 mm[64];
-				glm::vec4 mr[64];
-				glm::vec4 em[64];
-			} data;
-
-			platform::IRenderBuffer* cb = renderer->allocRenderBuffer(sizeof(data), platform::IRenderBuffer::kFlagConstant | platform::IRenderBuffer::kFlagTransient | platform::IRenderBuffer::kFlagDynamic, &data);
-			renderer->setConstantBuffer(cb, cbPerMeshIdx);
+			LMB_PROFILE_SCOPE("CullViews");
+			ViewJobs& view_jobs = *(ViewJobs*)user_data;
+			Scene& scene = *view_jobs.scene;
 
-			renderer->setBlendState(platform::BlendState::Alpha());
-			for (utilities::Renderable renderable : renderables)
+			for (uint32_t i = begin; i < end; ++i)
 			{
-				glm::vec4 mr(renderable.metallicness, renderable.roughness, 0.0f, 0.0f);
-				glm::vec4 em(renderable.emissiveness.x, renderable.emissiveness.y, renderable.emissiveness.z, 0.0f);
-				memcpy(data.mm, &renderable.model_matrix, sizeof(glm::mat4x4));
-				memcpy(data.mr, &mr, sizeof(glm::vec4));
-				memcpy(data.em, &em, sizeof(glm::vec4));
-				memcpy(cb->lock(), &data, sizeof(data));
-				cb->unlock();
-
-				renderer->setMesh(renderable.mesh);
-				renderer->setSubMesh(renderable.sub_mesh);
-
-				renderer->setTexture(renderable.albedo_texture,   0);
-				renderer->setTexture(renderable.normal_texture,   1);
-				renderer->setTexture(renderable.dmra_texture,     2);
-				renderer->setTexture(renderable.emissive_texture, 3);
-
-				auto sub_mesh = renderable.mesh->getSubMeshes().at(renderable.sub_mesh);
-				// TODO (Hilze): Implement.
-				if (sub_mesh.io.double_sided == true || (sub_mesh.io.tex_alb >= 0 && renderable.mesh->getAttachedTextures().at(sub_mesh.io.tex_alb)->getLayer(0u).containsAlpha()))
-					renderer->setRasterizerState(platform::RasterizerState::SolidNone());
-				else
+				const ViewJob& job = view_jobs.jobs[i];
+				job.culler->cullStatics(*scene.mesh_render.static_bvh, job.frustum);
+				components::MeshRenderSystem::createRenderQueue(job.culler->getStatics(), job.eye, *job.queue, scene);
+				if (job.dynamics)
 				{
-					if (cull_mode == platform::RasterizerState::CullMode::kBack)
-						renderer->setRasterizerState(platform::RasterizerState::SolidBack());
-					else if (cull_mode == platform::RasterizerState::CullMode::kFront)
-						renderer->setRasterizerState(platform::RasterizerState::SolidFront());
-					else
-						renderer->setRasterizerState(platform::RasterizerState::SolidNone());
+					job.culler->cullDynamics(*scene.mesh_render.dynamic_bvh, job.frustum);
+					components::MeshRenderSystem::createRenderQueue(job.culler->getDynamics(), job.eye, *job.queue, scene);
 				}
-
-				renderer->draw(1);
+				job.queue->sort();
 			}
 		}
-#endif
 
-		CameraBatch constructCamera(Scene& scene, entity::Entity entity)
+		CameraBatch constructCamera(Scene& scene, entity::Entity entity, Vector<ViewJob>& jobs)
 		{
 			LMB_ASSERT(entity, "CAMERA: Camera was not valid");
 			auto camera = scene.camera.get(entity);
-			lambda::utilities::Culler  culler;
 			lambda::utilities::Frustum frustum;
 			CameraBatch camera_batch;
 
@@ -385,20 +220,8 @@ namespace lambda
 			}
 
 			// Create render list.
-			components::MeshRenderSystem::createRenderList(culler, frustum, scene);
-			auto statics  = culler.getStatics();
-			auto dynamics = culler.getDynamics();
-#if USE_RENDERABLES
-			Vector<utilities::Renderable> opaque;
-			Vector<utilities::Renderable> alpha;
-			components::MeshRenderSystem::createSortedRenderList(&statics,  opaque, alpha, scene);
-			components::MeshRenderSystem::createSortedRenderList(&dynamics, opaque, alpha, scene);
-			convertRenderableList(opaque, camera_batch.renderables);
-			convertRenderableList(alpha, camera_batch.renderables);
-#else
-			components::MeshRenderSystem::createSortedRenderList(&statics,  camera_batch.opaque, camera_batch.alpha, scene);
-			components::MeshRenderSystem::createSortedRenderList(&dynamics, camera_batch.opaque, camera_batch.alpha, scene);
-#endif
+			jobs.push_back({ frustum, &scene.camera.main_camera_culler, camera_batch.position, ViewJob::kCamera, 0u, true, nullptr });
+
 			for (const auto& shader_pass : camera.shader_passes)
 			{
 				SceneShaderPass sp;
@@ -411,7 +234,7 @@ namespace lambda
 			return camera_batch;
 		}
 
-		void renderCamera(platform::IRenderer* renderer, const CameraBatch& camera_batch)
+		void renderCamera(platform::IRenderer* renderer, const CameraBatch& camera_batch, platform::RenderStats& stats)
 		{
 			renderer->beginTimer("Main Camera");
 			renderer->pushMarker("Main Camera");
@@ -452,12 +275,7 @@ namespace lambda
 					renderer->setDepthStencilState(platform::DepthStencilState::Equal());
 
 				renderer->bindShaderPass(platform::ShaderPass(Name(""), camera_batch.shader_passes[i].shader, camera_batch.shader_passes[i].input, camera_batch.shader_passes[i].output));
-#if USE_RENDERABLES
-				renderMeshes(renderer, camera_batch.renderables, platform::RasterizerState::CullMode::kFront);
-#else
-				renderMeshes(renderer, camera_batch.opaque, platform::RasterizerState::CullMode::kFront);
-				renderMeshes(renderer, camera_batch.alpha, platform::RasterizerState::CullMode::kFront);
-#endif
+				camera_batch.queue.render(renderer, platform::RasterizerState::CullMode::kFront, platform::BlendState::Alpha(), platform::BlendState::Alpha(), stats);
 			}
 
 			renderer->popMarker();
@@ -472,7 +290,7 @@ namespace lambda
 
 		static Map<entity::Entity, void*> g_generatedOnce;
 
-		LightBatch constructDirectional(entity::Entity entity, Scene& scene)
+		LightBatch constructDirectional(entity::Entity entity, Scene& scene, uint32_t batch, Vector<ViewJob>& jobs)
 		{
 			LightBatch light_batch;
 			LightBatch::Face light_batch_face;
@@ -575,20 +393,7 @@ namespace lambda
 				utilities::Frustum frustum;
 				frustum.construct(data.projection.back(), data.view.back());
 
-				components::MeshRenderSystem::createRenderList(data.culler.back(), frustum, scene);
-				auto statics = data.culler.back().getStatics();
-				auto dynamics = data.culler.back().getDynamics();
-#if USE_RENDERABLES
-				Vector<utilities::Renderable> opaque;
-				Vector<utilities::Renderable> alpha;
-				components::MeshRenderSystem::createSortedRenderList(&statics, opaque, alpha, scene);
-				components::MeshRenderSystem::createSortedRenderList(&dynamics, opaque, alpha, scene);
-				convertRenderableList(opaque, light_batch_face.renderables);
-				convertRenderableList(alpha, light_batch_face.renderables);
-#else
-				components::MeshRenderSystem::createSortedRenderList(&statics, light_batch_face.opaque, light_batch_face.alpha, scene);
-				components::MeshRenderSystem::createSortedRenderList(&dynamics, light_batch_face.opaque, light_batch_face.alpha, scene);
-#endif
+				jobs.push_back({ frustum, &data.culler.back(), translation, batch, 0u, true, nullptr });
 
 				String config = "__temp_target_" + toString(shadow_maps.at(0u).getTexture()->getLayer(0).getWidth()) + "_" + toString(shadow_maps.at(0u).getTexture()->getLayer(0).getHeight()) + "__";
 				asset::VioletTextureHandle temp = asset::TextureManager::getInstance()->create(Name(config),
@@ -659,7 +464,7 @@ namespace lambda
 			return light_batch;
 		}
 
-		LightBatch constructPoint(entity::Entity entity, Scene& scene)
+		LightBatch constructPoint(entity::Entity entity, Scene& scene, uint32_t batch, Vector<ViewJob>& jobs)
 		{
 			LightBatch light_batch;
 			LightBatch::Face light_batch_faces[6];
@@ -788,38 +593,9 @@ namespace lambda
 					utilities::Frustum frustum;
 					frustum.construct(data.projection[i], data.view[i]);
 
-					// Render to the shadow map.
-					if (statics_only)
-					{
-						components::MeshRenderSystem::createRenderList(data.culler.back(), frustum, scene);
-						auto statics = data.culler.back().getStatics();
-#if USE_RENDERABLES
-						Vector<utilities::Renderable> opaque;
-						Vector<utilities::Renderable> alpha;
-						components::MeshRenderSystem::createSortedRenderList(&statics, opaque, alpha, scene);
-						convertRenderableList(opaque, light_batch_faces[i].renderables);
-						convertRenderableList(alpha, light_batch_faces[i].renderables);
-#else
-						components::MeshRenderSystem::createSortedRenderList(&statics, light_batch_faces[i].opaque, light_batch_faces[i].alpha, scene);
-#endif
-					}
-					else
-					{
-						components::MeshRenderSystem::createRenderList(data.culler.back(), frustum, scene);
-						auto statics = data.culler.back().getStatics();
-						auto dynamics = data.culler.back().getDynamics();
-#if USE_RENDERABLES
-						Vector<utilities::Renderable> opaque;
-						Vector<utilities::Renderable> alpha;
-						components::MeshRenderSystem::createSortedRenderList(&statics, opaque, alpha, scene);
-						components::MeshRenderSystem::createSortedRenderList(&dynamics, opaque, alpha, scene);
-						convertRenderableList(opaque, light_batch_faces[i].renderables);
-						convertRenderableList(alpha, light_batch_faces[i].renderables);
-#else
-						components::MeshRenderSystem::createSortedRenderList(&statics, light_batch_faces[i].opaque, light_batch_faces[i].alpha, scene);
-						components::MeshRenderSystem::createSortedRenderList(&dynamics, light_batch_faces[i].opaque, light_batch_faces[i].alpha, scene);
-#endif
-					}
+					// Render to the shadow map. Only what the light reaches casts a shadow.
+					data.culler[i].setCullSphere(data.view_position[i], data.depth[i]);
+					jobs.push_back({ frustum, &data.culler[i], data.view_position[i], batch, i, !statics_only, nullptr });
 
 					String config1 = "__temp_target_cube1_" + toString(shadow_map.getTexture()->getLayer(0).getWidth()) + "_" + toString(shadow_map.getTexture()->getLayer(0).getHeight()) + "__";
 					asset::VioletTextureHandle temp1 = asset::TextureManager::getInstance()->create(Name(config1),
@@ -918,9 +694,10 @@ namespace lambda
 			return light_batch;
 		}
 
-		Vector<LightBatch> constructLight(const CameraBatch& camera, Scene& scene)
+		Vector<LightBatch> constructLight(const CameraBatch& camera, Scene& scene, Vector<ViewJob>& jobs)
 		{
 			Vector<LightBatch> light_batches;
+			light_batches.reserve(scene.light.data.size());
 
 			utilities::Frustum frustum;
 			frustum.construct(camera.projection, camera.view);
@@ -949,13 +726,13 @@ namespace lambda
 					switch (data.type)
 					{
 					case components::LightType::kDirectional:
-						light_batches.push_back(constructDirectional(data.entity, scene));
+						light_batches.push_back(constructDirectional(data.entity, scene, (uint32_t)light_batches.size(), jobs));
 						break;
 					case components::LightType::kSpot:
 						//constructSpot(data.entity, scene, light_batches);
 						break;
 					case components::LightType::kPoint:
-						light_batches.push_back(constructPoint(data.entity, scene));
+						light_batches.push_back(constructPoint(data.entity, scene, (uint32_t)light_batches.size(), jobs));
 						break;
 					case components::LightType::kCascade:
 						//constructCascade(data.entity, scene, light_batches);
@@ -970,7 +747,7 @@ namespace lambda
 			return light_batches;
 		}
 
-		void renderLight(platform::IRenderer* renderer, platform::PostProcessManager& post_process_manager, const LightBatch* light_batches, uint32_t light_batch_count)
+		void renderLight(platform::IRenderer* renderer, platform::PostProcessManager& post_process_manager, const LightBatch* light_batches, uint32_t light_batch_count, platform::RenderStats& stats)
 		{
 			renderer->beginTimer("Lighting");
 
@@ -1039,12 +816,7 @@ namespace lambda
 						renderer->pushMarker("Generate");
 						renderer->bindShaderPass(platform::ShaderPass(Name(""), face.generate.shader, face.generate.input, face.generate.output));
 
-#if USE_RENDERABLES
-						renderMeshes(renderer, face.renderables, platform::RasterizerState::CullMode::kNone);
-#else
-						renderMeshes(renderer, face.alpha, platform::RasterizerState::CullMode::kNone);
-						renderMeshes(renderer, face.opaque, platform::RasterizerState::CullMode::kNone);
-#endif
+						face.queue.render(renderer, platform::RasterizerState::CullMode::kNone, platform::BlendState::Alpha(), platform::BlendState::Alpha(), stats);
 						renderer->popMarker();
 
 						renderer->pushMarker("Modify");
@@ -1202,11 +974,14 @@ namespace lambda
 		///////////////////////////////////////////////////////////////////////////
 		void flush(scene::Scene& scene, const CameraBatch& camera_batch, const Vector<LightBatch>& light_batches)
 		{
+			LMB_PROFILE_SCOPE("Flush");
+			utilities::Timer timer;
 			scene.renderer->setOverrideScene(&scene);
 			scene.renderer->startFrame();
 
-			renderCamera(scene.renderer, camera_batch);
-			renderLight(scene.renderer, *scene.post_process_manager, light_batches.data(), (uint32_t)light_batches.size());
+			scene.render_stats = platform::RenderStats();
+			renderCamera(scene.renderer, camera_batch, scene.render_stats);
+			renderLight(scene.renderer, *scene.post_process_manager, light_batches.data(), (uint32_t)light_batches.size(), scene.render_stats);
 
 			scene.gui->render(scene);
 
@@ -1217,12 +992,15 @@ namespace lambda
 			}
 
 			scene.renderer->endFrame();
+			scene.renderer->addFrameStats(scene.render_stats);
 			scene.renderer->setOverrideScene(nullptr);
+			scene.flush_time = timer.elapsed().milliseconds();
 		}
 
 		///////////////////////////////////////////////////////////////////////////
 		void construct(scene::Scene& scene, CameraBatch& camera_batch, Vector<LightBatch>& light_batches)
 		{
+			LMB_PROFILE_SCOPE("Construct");
 			//Add all render actions.
 			Vector<IRenderAction*> render_actions;
 			render_actions.push_back(foundation::GetFrameHeap()->construct<RenderAction_PostProcess>());
@@ -1233,14 +1011,31 @@ namespace lambda
 			render_actions.insert(render_actions.end(), scene.render_actions.begin(), scene.render_actions.end());
 			scene.render_actions = eastl::move(render_actions);
 
-			camera_batch = constructCamera(scene, scene.camera.main_camera);
-			light_batches = constructLight(camera_batch, scene);
+			Vector<ViewJob> jobs;
+			camera_batch = constructCamera(scene, scene.camera.main_camera, jobs);
+			light_batches = constructLight(camera_batch, scene, jobs);
+			// Pixels covered by one unit at a distance of one unit.
+			const float pixels_per_unit = camera_batch.projection[1][1] * 0.5f * (float)scene.window->getSize().y;
+			components::MeshRenderSystem::updateStreamingPriorities(jobs.front().frustum, camera_batch.position, pixels_per_unit, scene);
+
+			// The batches are in place now, so the queues will not move.
+			for (ViewJob& job : jobs)
+				job.queue = (job.batch == ViewJob::kCamera) ? &camera_batch.queue : &light_batches[job.batch].faces[job.face].queue;
+
+			ViewJobs view_jobs = { &scene, jobs.data() };
+#if USE_MT
+			platform::TaskScheduler::Counter counter;
+			platform::TaskScheduler::parallelFor((uint32_t)jobs.size(), 1u, cullViews, &view_jobs, &counter);
+			platform::TaskScheduler::waitForCounter(&counter);
+#else
+			cullViews(0u, (uint32_t)jobs.size(), &view_jobs);
+#endif
 		}
 
 #if USE_MT
 		struct QueueFlushData
 		{
-			std::atomic<bool> done = true;
+			platform::TaskScheduler::Counter counter;
 			Scene scene;
 			CameraBatch camera_batch;
 			Vector<LightBatch> light_batches;
@@ -1250,19 +1045,36 @@ namespace lambda
 		{
 			QueueFlushData& qfd = *(QueueFlushData*)user_data;
 			flush(qfd.scene, qfd.camera_batch, qfd.light_batches);
-			qfd.done = true;
 		}
 #endif
 
+		///////////////////////////////////////////////////////////////////////////
+		// Render lists only refer to assets, so assets that lost their last
+		// handle are released once the flush that used them is done. Meshes go
+		// first, as they hold handles to textures. Streamed assets are swapped
+		// in at the same point, before the next frame is constructed.
+		static void collectAssetGarbage(scene::Scene& scene)
+		{
+			asset::VioletRefHandler<asset::Mesh>::collectGarbage();
+			asset::VioletRefHandler<asset::Texture>::collectGarbage();
+			asset::VioletRefHandler<asset::Shader>::collectGarbage();
+			asset::VioletRefHandler<asset::Wave>::collectGarbage();
+			asset::TextureStreamer::getInstance()->update(scene.texture_budget);
+			asset::AssetStreamer::getInstance()->finalize(scene.stream_budget);
+		}
+
 		void sceneConstructRender(scene::Scene& scene)
 		{
+			components::TransformSystem::update(scene);
 			components::MeshRenderSystem::updateDynamicsBvh(scene);
 			components::LightSystem::updateLightTransforms(scene);
 			components::CameraSystem::updateCameraTransforms(scene);
 
 #if USE_MT
-			while (!k_queue_flush_data.done)
-				std::this_thread::sleep_for(std::chrono::microseconds(1));
+			platform::TaskScheduler::waitForCounter(&k_queue_flush_data.counter);
+			scene.render_stats = k_queue_flush_data.scene.render_stats;
+			scene.flush_time   = k_queue_flush_data.scene.flush_time;
+			collectAssetGarbage(scene);
 
 			construct(scene, k_queue_flush_data.camera_batch, k_queue_flush_data.light_batches);
 			k_queue_flush_data.scene.renderer                 = scene.renderer;
@@ -1275,9 +1087,7 @@ namespace lambda
 			k_queue_flush_data.scene.mesh_render.static_bvh   = scene.mesh_render.static_bvh;
 			k_queue_flush_data.scene.mesh_render.dynamic_bvh  = scene.mesh_render.dynamic_bvh;
 
-			k_queue_flush_data.done = false;
-
-			platform::TaskScheduler::queue(queueFlush, &k_queue_flush_data, platform::TaskScheduler::kCritical);
+			platform::TaskScheduler::run(queueFlush, &k_queue_flush_data, &k_queue_flush_data.counter, nullptr, platform::TaskScheduler::kCritical);
 #else
 			// Create new.
 
@@ -1285,6 +1095,7 @@ namespace lambda
 			Vector<LightBatch> light_batches;
 			construct(scene, camera_batch, light_batches);
 			flush(scene, camera_batch, light_batches);
+			collectAssetGarbage(scene);
 #endif
 
 			scene.render_actions.clear();
@@ -1303,6 +1114,11 @@ namespace lambda
 			components::MonoBehaviourSystem::collectGarbage(scene);
 			components::WaveSourceSystem::collectGarbage(scene);
 			components::LightSystem::collectGarbage(scene);
+#if VIOLET_NETWORKING
+			components::ReplicationSystem::collectGarbage(scene);
+#endif
+			// Entity indices are only reused once no component refers to them.
+			scene.entity.collectGarbage();
 
 			if (scene.do_serialize)
 			{
@@ -1321,8 +1137,7 @@ namespace lambda
 		void sceneDeinitialize(scene::Scene& scene)
 		{
 #if USE_MT
-			while (!k_queue_flush_data.done)
-				std::this_thread::sleep_for(std::chrono::microseconds(1));
+			platform::TaskScheduler::waitForCounter(&k_queue_flush_data.counter);
 #endif
 			
 			components::ColliderSystem::deinitialize(scene);
@@ -1335,6 +1150,9 @@ namespace lambda
 			components::MonoBehaviourSystem::deinitialize(scene);
 			components::WaveSourceSystem::deinitialize(scene);
 			components::LightSystem::deinitialize(scene);
+#if VIOLET_NETWORKING
+			components::ReplicationSystem::deinitialize(scene);
+#endif
 		}
 
 		std::string k_src;
@@ -1403,6 +1221,8 @@ namespace lambda
 			new_scene.render_actions       = scene.render_actions;
 			new_scene.fixed_time_step      = scene.fixed_time_step;
 			new_scene.time_scale           = scene.time_scale;
+			new_scene.stream_budget        = scene.stream_budget;
+			new_scene.texture_budget       = scene.texture_budget;
 			new_scene.do_serialize         = scene.do_serialize;
 			new_scene.do_deserialize       = scene.do_deserialize;
 
@@ -1410,9 +1230,9 @@ namespace lambda
 
 			// Reconstruct the static BVH.
 			scene.mesh_render.static_bvh->clear();
-			for (const auto& index : scene.mesh_render.static_renderables)
+			for (const auto& entity : scene.mesh_render.static_renderables)
 			{
-				auto& data = scene.mesh_render.data[index];
+				auto& data = scene.mesh_render.get(entity);
 				scene.mesh_render.static_bvh->add(data.renderable.entity, &data.renderable.entity, utilities::BVHAABB(data.renderable.min, data.renderable.max));
 			}
 
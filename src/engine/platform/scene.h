@@ -10,8 +10,13 @@
 #include <systems/camera_system.h>
 #include <systems/transform_system.h>
 #include <systems/mesh_render_system.h>
+#if VIOLET_NETWORKING
+#include <systems/replication_system.h>
+#endif
 #include <platform/post_process_manager.h>
 #include <platform/debug_renderer.h>
+#include <platform/render_queue.h>
+#include <assets/asset_streamer.h>
 #include <interfaces/iscript_context.h>
 #include <containers/containers.h>
 
@@ -46,8 +51,19 @@ namespace lambda
 			components::LightSystem::SystemData         light;
 			components::TransformSystem::SystemData     transform;
 			components::MeshRenderSystem::SystemData    mesh_render;
+#if VIOLET_NETWORKING
+			components::ReplicationSystem::SystemData   replication;
+#endif
 			platform::DebugRenderer         debug_renderer;
 			platform::PostProcessManager*   post_process_manager;
+			// What the last flushed frame cost the renderer.
+			platform::RenderStats           render_stats;
+			// How long the last flush took, in milliseconds.
+			double                          flush_time = 0.0;
+			// How much streamed data is handed to the assets per frame.
+			asset::StreamBudget             stream_budget;
+			// How much memory the mips of streamed textures may take.
+			size_t                          texture_budget = 256u << 20u;
 			scripting::IScriptContext* scripting = nullptr;
 			platform::IRenderer*       renderer  = nullptr;
 			platform::IWindow*         window    = nullptr;
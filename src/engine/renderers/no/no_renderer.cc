@@ -1,28 +1,168 @@
 #include "no_renderer.h"
+#include "platform/rasterizer_state.h"
+#include "platform/blend_state.h"
+#include "platform/depth_stencil_state.h"
+#include "platform/sampler_state.h"
+#include "platform/shader_pass.h"
+#include "platform/render_queue.h"
+#include <memory/frame_heap.h>
+#include <memory/memory.h>
+#include <cstring>
 
 namespace lambda
 {
   namespace windows
   {
+    ///////////////////////////////////////////////////////////////////////////
+    // FNV-1a. The states only hold enums and bools, so their bytes are all
+    // that tells them apart.
+    template<typename T>
+    static uint64_t hashBytes(const T& value)
+    {
+      const unsigned char* bytes = (const unsigned char*)&value;
+      uint64_t hash = 14695981039346656037ull;
+      for (size_t i = 0u; i < sizeof(T); ++i)
+      {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    NoRenderBuffer::NoRenderBuffer(uint32_t size, uint32_t flags, uint32_t id, NoRenderer* renderer)
+      : renderer_(renderer)
+      , data_(size)
+      , flags_(flags)
+      , id_(id)
+    {
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void* NoRenderBuffer::lock()
+    {
+      return data_.data();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderBuffer::unlock()
+    {
+      renderer_->onBufferUpdate(*this);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    uint32_t NoRenderBuffer::getFlags() const
+    {
+      return flags_;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    uint32_t NoRenderBuffer::getSize() const
+    {
+      return (uint32_t)data_.size();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    uint32_t NoRenderBuffer::getId() const
+    {
+      return id_;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     NoRenderer::~NoRenderer()
     {
+      for (NoRenderBuffer* buffer : transient_buffers_)
+        foundation::Memory::destruct(buffer);
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::initialize(world::IWorld* world)
+    platform::IRenderBuffer* NoRenderer::allocRenderBuffer(uint32_t size, uint32_t flags, void* data)
     {
+      NoRenderBuffer* buffer = foundation::Memory::construct<NoRenderBuffer>(size, flags, next_buffer_id_++, this);
+      if (data)
+      {
+        memcpy(buffer->lock(), data, size);
+        buffer->unlock();
+      }
+
+      if (flags & platform::IRenderBuffer::kFlagTransient)
+        transient_buffers_.push_back(buffer);
+
+      return buffer;
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::deinitialize()
+    void NoRenderer::freeRenderBuffer(platform::IRenderBuffer*& buffer)
     {
+      foundation::Memory::destruct((NoRenderBuffer*)buffer);
+      buffer = nullptr;
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setWindow(
-      foundation::SharedPointer<platform::IWindow> window)
+    void NoRenderer::onBufferUpdate(const NoRenderBuffer& buffer)
     {
+      stats_.buffer_bytes += buffer.getSize();
+      record(NoCommandType::kUpdateBuffer, buffer.getId(), 0u, buffer.getSize());
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::record(NoCommandType type, uint64_t argument, uint8_t slot, uint32_t count)
+    {
+      NoCommand command;
+      command.type     = type;
+      command.slot     = slot;
+      command.padding  = 0u;
+      command.count    = count;
+      command.argument = argument;
+      commands_.push_back(command);
+      stats_.commands++;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::bind(NoCommandType type, uint64_t argument, uint8_t slot, uint32_t count)
+    {
+      record(type, argument, slot, count);
+
+      const uint32_t t = (uint32_t)type;
+      const uint32_t s = slot % kSlotCount;
+      if (is_bound_[t][s] && bound_[t][s] == argument)
+      {
+        stats_.redundant_state_changes++;
+        return;
+      }
+
+      is_bound_[t][s] = true;
+      bound_[t][s]    = argument;
+      stats_.state_changes++;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::setWindow(platform::IWindow* window)
+    {
+      window_ = window;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::setOverrideScene(scene::Scene* scene)
+    {
+      override_scene_ = scene;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::initialize(scene::Scene& scene)
+    {
+      scene_ = &scene;
+      memset(is_bound_, 0, sizeof(is_bound_));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::deinitialize()
+    {
+      for (NoRenderBuffer* buffer : transient_buffers_)
+        foundation::Memory::destruct(buffer);
+      transient_buffers_.clear();
+      commands_.clear();
+      last_commands_.clear();
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -38,164 +178,257 @@ namespace lambda
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::startFrame()
     {
+      LMB_ASSERT(override_scene_, "NO RENDERER: Tried to render outside of the flush thread");
+
+      // Nothing is bound at the start of a frame.
+      commands_.clear();
+      stats_ = NoFrameStats();
+      memset(is_bound_, 0, sizeof(is_bound_));
     }
-   
+
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::endFrame(bool display)
     {
+      LMB_ASSERT(override_scene_, "NO RENDERER: Tried to render outside of the flush thread");
+
+      for (NoRenderBuffer* buffer : transient_buffers_)
+        foundation::Memory::destruct(buffer);
+      transient_buffers_.clear();
+
+      last_commands_.swap(commands_);
+      last_stats_ = stats_;
+      frame_count_++;
+
+      foundation::GetFrameHeap()->update();
     }
-    
-    ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::draw()
-    {
-    }
-    
+
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::drawInstanced(const Vector<glm::mat4>& matrices)
+    void NoRenderer::draw(uint32_t instance_count)
     {
+      LMB_ASSERT(instance_count, "NO RENDERER: Tried to render zero instances");
+
+      record(NoCommandType::kDraw, instance_count);
+      stats_.draws++;
+      stats_.instances += instance_count;
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setRasterizerState(
-      const platform::RasterizerState& rasterizer_state)
+    void NoRenderer::setRasterizerState(const platform::RasterizerState& rasterizer_state)
     {
+      bind(NoCommandType::kSetRasterizerState, hashBytes(rasterizer_state));
     }
 
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::setBlendState(const platform::BlendState& blend_state)
     {
+      bind(NoCommandType::kSetBlendState, hashBytes(blend_state));
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setDepthStencilState(
-      const platform::DepthStencilState& depth_stencil_state)
+    void NoRenderer::setDepthStencilState(const platform::DepthStencilState& depth_stencil_state)
     {
+      bind(NoCommandType::kSetDepthStencilState, hashBytes(depth_stencil_state));
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setSamplerState(
-      const platform::SamplerState& sampler_state, 
-      unsigned char slot)
+    void NoRenderer::setSamplerState(const platform::SamplerState& sampler_state, unsigned char slot)
     {
+      bind(NoCommandType::kSetSamplerState, hashBytes(sampler_state), slot);
     }
 
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::generateMipMaps(const asset::VioletTextureHandle& texture)
     {
+      record(NoCommandType::kGenerateMipMaps, texture.getHash());
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::copyToScreen(const asset::VioletTextureHandle& texture)
     {
+      record(NoCommandType::kCopyToScreen, texture.getHash());
     }
-    
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::copyToTexture(const asset::VioletTextureHandle& src, const asset::VioletTextureHandle& dst)
+    {
+      size_t hash = src.getHash();
+      hashCombine(hash, dst.getHash());
+      record(NoCommandType::kCopyToTexture, hash);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::bindShaderPass(const platform::ShaderPass& shader_pass)
     {
+      size_t hash = shader_pass.getShader().getHash();
+      for (const platform::RenderTarget& input : shader_pass.getInputs())
+        hashCombine(hash, input.getTexture().getHash());
+      for (const platform::RenderTarget& output : shader_pass.getOutputs())
+        hashCombine(hash, output.getTexture().getHash());
+      bind(NoCommandType::kBindShaderPass, hash, 0u, (uint32_t)(shader_pass.getInputs().size() + shader_pass.getOutputs().size()));
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::clearRenderTarget(
-      asset::VioletTextureHandle texture, 
-      const glm::vec4& colour)
+    void NoRenderer::clearRenderTarget(asset::VioletTextureHandle texture, const glm::vec4& colour)
     {
+      record(NoCommandType::kClearRenderTarget, texture.getHash());
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setScissorRect(const glm::vec4& rect)
+    void NoRenderer::setScissorRects(const Vector<glm::vec4>& rects)
     {
+      size_t hash = 0u;
+      for (const glm::vec4& rect : rects)
+        hashCombine(hash, hashBytes(rect));
+      bind(NoCommandType::kSetScissorRects, hash, 0u, (uint32_t)rects.size());
     }
 
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::setViewports(const Vector<glm::vec4>& rects)
     {
+      size_t hash = 0u;
+      for (const glm::vec4& rect : rects)
+        hashCombine(hash, hashBytes(rect));
+      bind(NoCommandType::kSetViewports, hash, 0u, (uint32_t)rects.size());
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setMesh(asset::MeshHandle mesh)
+    void NoRenderer::setMesh(asset::VioletMeshHandle mesh)
     {
+      bind(NoCommandType::kSetMesh, mesh.getHash());
     }
 
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::setSubMesh(const uint32_t& sub_mesh_idx)
     {
+      bind(NoCommandType::kSetSubMesh, sub_mesh_idx);
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setShader(asset::ShaderHandle shader)
+    void NoRenderer::setShader(asset::VioletShaderHandle shader)
     {
+      bind(NoCommandType::kSetShader, shader.getHash());
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setTexture(
-      asset::VioletTextureHandle texture, 
-      uint8_t slot)
+    void NoRenderer::setTexture(asset::VioletTextureHandle texture, uint8_t slot)
     {
+      bind(NoCommandType::kSetTexture, texture.getHash(), slot);
     }
-    
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::setConstantBuffer(platform::IRenderBuffer* constant_buffer, uint8_t slot)
+    {
+      bind(NoCommandType::kSetConstantBuffer, constant_buffer ? ((NoRenderBuffer*)constant_buffer)->getId() + 1u : 0u, slot);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::setUserData(glm::vec4 data, uint8_t slot)
+    {
+      bind(NoCommandType::kSetUserData, hashBytes(data), slot);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::setRenderTargets(Vector<asset::VioletTextureHandle> render_targets, asset::VioletTextureHandle depth_buffer)
+    {
+      size_t hash = depth_buffer.getHash();
+      for (const asset::VioletTextureHandle& render_target : render_targets)
+        hashCombine(hash, render_target.getHash());
+      bind(NoCommandType::kSetRenderTargets, hash, 0u, (uint32_t)render_targets.size());
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::pushMarker(const String& name)
     {
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::setMarker(const String& name)
     {
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::popMarker()
     {
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::beginTimer(const String& name)
     {
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
     void NoRenderer::endTimer(const String& name)
     {
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
     uint64_t NoRenderer::getTimerMicroSeconds(const String& name)
     {
       return 0ul;
     }
-    
+
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setShaderVariable(
-      const platform::ShaderVariable& variable)
+    void NoRenderer::setRenderScale(const float& render_scale)
     {
+      render_scale_ = render_scale;
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setRenderScale(const float & render_scale)
+    float NoRenderer::getRenderScale()
     {
+      return render_scale_;
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::destroyAsset(
-      foundation::SharedPointer<asset::IAsset> asset)
+    void NoRenderer::setVSync(bool vsync)
     {
+      vsync_ = vsync;
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void NoRenderer::setVSync(bool vsync)
+    bool NoRenderer::getVSync() const
     {
+      return vsync_;
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    float NoRenderer::getRenderScale()
+    void NoRenderer::destroyTexture(const size_t& hash)
     {
-      return 1.0f;
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    bool NoRenderer::getVSync() const
+    void NoRenderer::destroyShader(const size_t& hash)
+    {
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::destroyMesh(const size_t& hash)
+    {
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    const Vector<NoCommand>& NoRenderer::getCommands() const
+    {
+      return last_commands_;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoRenderer::addFrameStats(platform::RenderStats& stats) const
+    {
+      stats.commands     += last_stats_.commands;
+      stats.buffer_bytes += last_stats_.buffer_bytes;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    const NoFrameStats& NoRenderer::getFrameStats() const
+    {
+      return last_stats_;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    uint64_t NoRenderer::getFrameCount() const
     {
-      return false;
+      return frame_count_;
     }
   }
-}
\ No newline at end of file
+}
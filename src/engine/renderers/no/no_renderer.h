@@ -1,30 +1,109 @@
 #pragma once
 #include "interfaces/irenderer.h"
+#include <containers/containers.h>
 
 namespace lambda
 {
   namespace windows
   {
+    class NoRenderer;
+
+    ///////////////////////////////////////////////////////////////////////////
+    enum class NoCommandType : uint8_t
+    {
+      kDraw,
+      kSetRasterizerState,
+      kSetBlendState,
+      kSetDepthStencilState,
+      kSetSamplerState,
+      kGenerateMipMaps,
+      kCopyToScreen,
+      kCopyToTexture,
+      kBindShaderPass,
+      kClearRenderTarget,
+      kSetScissorRects,
+      kSetViewports,
+      kSetMesh,
+      kSetSubMesh,
+      kSetShader,
+      kSetTexture,
+      kSetConstantBuffer,
+      kSetUserData,
+      kSetRenderTargets,
+      kUpdateBuffer,
+      kCount
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // One recorded call. The argument identifies what was set: the hash of
+    // an asset or state, the id of a buffer or the number of instances that
+    // were drawn. Count holds sizes and list lengths.
+    struct NoCommand
+    {
+      NoCommandType type;
+      uint8_t       slot;
+      uint16_t      padding;
+      uint32_t      count;
+      uint64_t      argument;
+    };
+    static_assert(sizeof(NoCommand) == 16u, "NoCommand should be 16 bytes");
+
     ///////////////////////////////////////////////////////////////////////////
+    // State changes are calls that bound something else than what was bound
+    // in that slot. Calls that bound the same thing again are redundant.
+    struct NoFrameStats
+    {
+      uint32_t draws                   = 0u;
+      uint32_t instances               = 0u;
+      uint32_t state_changes           = 0u;
+      uint32_t redundant_state_changes = 0u;
+      uint64_t buffer_bytes            = 0u;
+      uint32_t commands                = 0u;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    class NoRenderBuffer : public platform::IRenderBuffer
+    {
+    public:
+      NoRenderBuffer(uint32_t size, uint32_t flags, uint32_t id, NoRenderer* renderer);
+      virtual void*    lock()   override;
+      virtual void     unlock() override;
+      virtual uint32_t getFlags() const override;
+      virtual uint32_t getSize()  const override;
+      uint32_t         getId()    const;
+
+    private:
+      NoRenderer*  renderer_;
+      Vector<char> data_;
+      uint32_t     flags_;
+      uint32_t     id_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Renderer that needs no GPU. Every call of a frame is recorded into a
+    // command stream, which together with the counters of the frame can be
+    // read back once the frame has ended.
     class NoRenderer : public platform::IRenderer
     {
     public:
       virtual ~NoRenderer();
-      virtual void setWindow(
-        foundation::SharedPointer<platform::IWindow> window
+
+      virtual platform::IRenderBuffer* allocRenderBuffer(
+        uint32_t size,
+        uint32_t flags,
+        void* data = nullptr
       ) override;
-      virtual void initialize(world::IWorld* world) override;
+      virtual void freeRenderBuffer(platform::IRenderBuffer*& buffer) override;
+
+      virtual void setWindow(platform::IWindow* window) override;
+      virtual void setOverrideScene(scene::Scene* scene) override;
+      virtual void initialize(scene::Scene& scene) override;
       virtual void deinitialize() override;
       virtual void resize() override;
       virtual void update(const double& delta_time) override;
       virtual void startFrame() override;
-      virtual void endFrame(bool display) override;
-
-      /////////////////////////////////////////////////////////////////////////
-      ///// Deferred Calls ////////////////////////////////////////////////////
-      /////////////////////////////////////////////////////////////////////////
-      virtual void draw() override;
-      virtual void drawInstanced(const Vector<glm::mat4>& matrices) override;
+      virtual void endFrame(bool display = true) override;
+      virtual void draw(uint32_t instance_count = 1ul) override;
 
       virtual void setRasterizerState(
         const platform::RasterizerState& rasterizer_state
@@ -36,7 +115,7 @@ namespace lambda
         const platform::DepthStencilState& depth_stencil_state
       ) override;
       virtual void setSamplerState(
-        const platform::SamplerState& sampler_state, 
+        const platform::SamplerState& sampler_state,
         unsigned char slot
       ) override;
 
@@ -46,23 +125,36 @@ namespace lambda
       virtual void copyToScreen(
         const asset::VioletTextureHandle& texture
       ) override;
+      virtual void copyToTexture(
+        const asset::VioletTextureHandle& src,
+        const asset::VioletTextureHandle& dst
+      ) override;
       virtual void bindShaderPass(
         const platform::ShaderPass& shader_pass
       ) override;
       virtual void clearRenderTarget(
-        asset::VioletTextureHandle texture, 
+        asset::VioletTextureHandle texture,
         const glm::vec4& colour
       ) override;
 
-      virtual void setScissorRect(const glm::vec4& rect) override;
-      virtual void setViewports(const Vector<glm::vec4>& rects);
+      virtual void setScissorRects(const Vector<glm::vec4>& rects) override;
+      virtual void setViewports(const Vector<glm::vec4>& rects) override;
 
-      virtual void setMesh(asset::MeshHandle mesh) override;
+      virtual void setMesh(asset::VioletMeshHandle mesh) override;
       virtual void setSubMesh(const uint32_t& sub_mesh_idx) override;
-      virtual void setShader(asset::ShaderHandle shader) override;
+      virtual void setShader(asset::VioletShaderHandle shader) override;
       virtual void setTexture(
-        asset::VioletTextureHandle texture, 
-        uint8_t slot
+        asset::VioletTextureHandle texture,
+        uint8_t slot = 0
+      ) override;
+      virtual void setConstantBuffer(
+        platform::IRenderBuffer* constant_buffer,
+        uint8_t slot = 0
+      ) override;
+      virtual void setUserData(glm::vec4 data, uint8_t slot = 0) override;
+      virtual void setRenderTargets(
+        Vector<asset::VioletTextureHandle> render_targets,
+        asset::VioletTextureHandle depth_buffer
       ) override;
 
       virtual void pushMarker(const String& name) override;
@@ -72,24 +164,50 @@ namespace lambda
       virtual void  beginTimer(const String& name) override;
       virtual void  endTimer(const String& name) override;
       virtual uint64_t getTimerMicroSeconds(const String& name) override;
-      /////////////////////////////////////////////////////////////////////////
-      ///// Deferred Calls End ////////////////////////////////////////////////
-      /////////////////////////////////////////////////////////////////////////
+      virtual void addFrameStats(platform::RenderStats& stats) const override;
 
       virtual void setRenderScale(const float& render_scale) override;
       virtual float getRenderScale() override;
-
       virtual void setVSync(bool vsync) override;
       virtual bool getVSync() const override;
 
-      void setShaderVariable(
-        const platform::ShaderVariable& variable
-      ) override;
+      virtual void destroyTexture(const size_t& hash) override;
+      virtual void destroyShader(const size_t& hash) override;
+      virtual void destroyMesh(const size_t& hash) override;
 
-    protected:
-      virtual void destroyAsset(
-        foundation::SharedPointer<asset::IAsset> asset
-      ) override;
+      // The commands and counters of the last frame that ended.
+      const Vector<NoCommand>& getCommands() const;
+      const NoFrameStats& getFrameStats() const;
+      uint64_t getFrameCount() const;
+
+      // Called by the buffers when their contents were written.
+      void onBufferUpdate(const NoRenderBuffer& buffer);
+
+    private:
+      static constexpr uint32_t kSlotCount = 16u;
+
+      void record(NoCommandType type, uint64_t argument, uint8_t slot = 0u, uint32_t count = 0u);
+      void bind(NoCommandType type, uint64_t argument, uint8_t slot = 0u, uint32_t count = 0u);
+
+    private:
+      scene::Scene* scene_          = nullptr;
+      scene::Scene* override_scene_ = nullptr;
+      platform::IWindow* window_    = nullptr;
+
+      Vector<NoCommand> commands_;
+      Vector<NoCommand> last_commands_;
+      NoFrameStats      stats_;
+      NoFrameStats      last_stats_;
+      uint64_t          frame_count_ = 0u;
+
+      // What every slot had bound, to tell changes from redundant calls.
+      uint64_t bound_[(uint32_t)NoCommandType::kCount][kSlotCount];
+      bool     is_bound_[(uint32_t)NoCommandType::kCount][kSlotCount];
+
+      Vector<NoRenderBuffer*> transient_buffers_;
+      uint32_t next_buffer_id_ = 0u;
+      float    render_scale_   = 1.0f;
+      bool     vsync_          = false;
     };
   }
-}
\ No newline at end of file
+}
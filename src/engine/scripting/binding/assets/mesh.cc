@@ -3,6 +3,7 @@
 #include <interfaces/iscript_context.h>
 #include <platform/scene.h>
 #include <assets/mesh.h>
+#include <assets/asset_streamer.h>
 #include <assets/mesh_io.h>
 #include <utils/mesh_decimator.h>
 
@@ -37,6 +38,16 @@ namespace lambda
           else
             return g_mesh_ids[file_path];
         }
+        uint64_t LoadAsync(const String& file_path, const float& priority)
+        {
+          if (g_mesh_ids.find(file_path) == g_mesh_ids.end())
+          {
+            asset::VioletMeshHandle mesh_handle = asset::MeshManager::getInstance()->getAsync(file_path, priority);
+            return Add(mesh_handle, file_path);
+          }
+          else
+            return g_mesh_ids[file_path];
+        }
         uint64_t Create()
         {
           static size_t sid = 0u;
@@ -158,6 +169,29 @@ namespace lambda
         {
           return (uint16_t)g_meshes[mesh_id]->getSubMeshes().size();
         }
+        uint8_t GetLoadState(const uint64_t& mesh_id)
+        {
+          return (uint8_t)asset::AssetStreamer::getInstance()->getState(g_meshes[mesh_id].getHash());
+        }
+        void SetLoadPriority(const uint64_t& mesh_id, const float& priority)
+        {
+          asset::AssetStreamer::getInstance()->setPriority(g_meshes[mesh_id].getHash(), priority);
+        }
+        void CancelLoad(const uint64_t& mesh_id)
+        {
+          asset::AssetStreamer::getInstance()->cancel(g_meshes[mesh_id].getHash());
+        }
+        void OnLoaded(const uint64_t& mesh_id, const String& function)
+        {
+          const uint64_t id = mesh_id;
+          asset::AssetStreamer::getInstance()->addCallback(
+            g_meshes[mesh_id].getHash(),
+            [id, function](uint64_t /*hash*/, asset::LoadState state) {
+              if (g_script_context)
+                g_script_context->executeFunction(function, { ScriptValue(id), ScriptValue((uint8_t)state) });
+            }
+          );
+        }
         void IncRef(const uint64_t& id)
         {
           auto it = g_ref_counts.find(id);
@@ -190,10 +224,15 @@ namespace lambda
 
           return Map<lambda::String, void*> {
             { "uint64 Violet_Assets_Mesh::Load(const String& in)",                                       (void*)Load },
+            { "uint64 Violet_Assets_Mesh::LoadAsync(const String& in, const float& in)",                 (void*)LoadAsync },
             { "uint64 Violet_Assets_Mesh::Create()",                                                     (void*)Create },
             { "uint64 Violet_Assets_Mesh::CreateDefault(const String& in)",                              (void*)CreateDefault },
             { "uint64 Violet_Assets_Mesh::Decimate(const uint64& in, const float& in, const float& in)", (void*)Decimate },
             { "uint16 Violet_Assets_Mesh::GetSubMeshCount(const uint64& in)",                            (void*)GetSubMeshCount },
+            { "uint8 Violet_Assets_Mesh::GetLoadState(const uint64& in)",                                (void*)GetLoadState },
+            { "void Violet_Assets_Mesh::SetLoadPriority(const uint64& in, const float& in)",             (void*)SetLoadPriority },
+            { "void Violet_Assets_Mesh::CancelLoad(const uint64& in)",                                   (void*)CancelLoad },
+            { "void Violet_Assets_Mesh::OnLoaded(const uint64& in, const String& in)",                   (void*)OnLoaded },
             { "void Violet_Assets_Mesh::IncRef(const uint64& in)",                                       (void*)IncRef },
             { "void Violet_Assets_Mesh::DecRef(const uint64& in)",                                       (void*)DecRef },
             { "void Violet_Assets_Mesh::SetPositions(const uint64& in, const Array<Vec3>& in)",          (void*)SetPositions },
@@ -1,5 +1,6 @@
 #include <scripting/binding/assets/texture.h>
 #include <assets/texture.h>
+#include <assets/asset_streamer.h>
 #include <interfaces/iworld.h>
 #include <interfaces/iscript_context.h>
 
@@ -28,6 +29,26 @@ namespace lambda
 
           return g_texture_ids.at(file_path);
         }
+        uint64_t LoadAsync(const String& file_path, const float& priority)
+        {
+          if (g_texture_ids.find(file_path) == g_texture_ids.end())
+          {
+            g_texture_ids.insert(eastl::make_pair(file_path, g_textures.size()));
+            g_textures.push_back(asset::TextureManager::getInstance()->getAsync(Name(file_path), asset::VioletTextureHandle(), priority));
+          }
+
+          return g_texture_ids.at(file_path);
+        }
+        uint64_t LoadAsyncWithPlaceholder(const String& file_path, const uint64_t& placeholder_id, const float& priority)
+        {
+          if (g_texture_ids.find(file_path) == g_texture_ids.end())
+          {
+            g_texture_ids.insert(eastl::make_pair(file_path, g_textures.size()));
+            g_textures.push_back(asset::TextureManager::getInstance()->getAsync(Name(file_path), g_textures[placeholder_id], priority));
+          }
+
+          return g_texture_ids.at(file_path);
+        }
         uint64_t CreateCubeMap(const String& front, const String& back, const String& top, const String& bottom, const String& left, const String& right)
         {
           String name = front + back + top + bottom + left + right;
@@ -95,6 +116,29 @@ namespace lambda
         {
           return false;// (g_textures[texture_id]->getLayer(0u).getFlags() & kTextureFlagMipMaps) != 0 ? true : false;
         }
+        uint8_t GetLoadState(const uint64_t& texture_id)
+        {
+          return (uint8_t)asset::AssetStreamer::getInstance()->getState(g_textures[texture_id].getHash());
+        }
+        void SetLoadPriority(const uint64_t& texture_id, const float& priority)
+        {
+          asset::AssetStreamer::getInstance()->setPriority(g_textures[texture_id].getHash(), priority);
+        }
+        void CancelLoad(const uint64_t& texture_id)
+        {
+          asset::AssetStreamer::getInstance()->cancel(g_textures[texture_id].getHash());
+        }
+        void OnLoaded(const uint64_t& texture_id, const String& function)
+        {
+          const uint64_t id = texture_id;
+          asset::AssetStreamer::getInstance()->addCallback(
+            g_textures[texture_id].getHash(),
+            [id, function](uint64_t /*hash*/, asset::LoadState state) {
+              if (g_script_context)
+                g_script_context->executeFunction(function, { ScriptValue(id), ScriptValue((uint8_t)state) });
+            }
+          );
+        }
         void IncRef(const uint64_t& id)
         {
           auto it = g_ref_counts.find(id);
@@ -132,12 +176,18 @@ namespace lambda
 
           return Map<lambda::String, void*>{
             { "uint64 Violet_Assets_Texture::Load(const String& in)",                                                                                                   (void*)Load },
+            { "uint64 Violet_Assets_Texture::LoadAsync(const String& in, const float& in)",                                                                             (void*)LoadAsync },
+            { "uint64 Violet_Assets_Texture::LoadAsync(const String& in, const uint64& in, const float& in)",                                                           (void*)LoadAsyncWithPlaceholder },
             { "uint64 Violet_Assets_Texture::LoadCubeMap(const String& in, const String& in, const String& in, const String& in, const String& in, const String& in)",  (void*)CreateCubeMap },
             { "uint64 Violet_Assets_Texture::Create(const float& in, const float& in, const uint8& in)",                                                                (void*)Create },
             { "uint64 Violet_Assets_Texture::Create(const float& in, const float& in, const Array<uint8>& in, const uint8& in)",                                        (void*)CreateFromData },
             { "Vec2 Violet_Assets_Texture::GetSize(const uint64& in)",                                                                                                  (void*)GetSize },
             { "void Violet_Assets_Texture::SetGenerateMipMaps(const uint64& in, const bool& in)",                                                                       (void*)SetGenerateMipMaps },
             { "bool Violet_Assets_Texture::GetGenerateMipMaps(const uint64& in)",                                                                                       (void*)GetGenerateMipMaps },
+            { "uint8 Violet_Assets_Texture::GetLoadState(const uint64& in)",                                                                                            (void*)GetLoadState },
+            { "void Violet_Assets_Texture::SetLoadPriority(const uint64& in, const float& in)",                                                                         (void*)SetLoadPriority },
+            { "void Violet_Assets_Texture::CancelLoad(const uint64& in)",                                                                                               (void*)CancelLoad },
+            { "void Violet_Assets_Texture::OnLoaded(const uint64& in, const String& in)",                                                                               (void*)OnLoaded },
             { "void Violet_Assets_Texture::IncRef(const uint64& in)",                                                                                                   (void*)IncRef },
             { "void Violet_Assets_Texture::DecRef(const uint64& in)",                                                                                                   (void*)DecRef }
           };
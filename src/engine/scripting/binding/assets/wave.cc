@@ -1,4 +1,7 @@
 #include <scripting/binding/assets/wave.h>
+#include <assets/asset_streamer.h>
+#include <interfaces/iworld.h>
+#include <interfaces/iscript_context.h>
 #include <soloud_wav.h>
 
 namespace lambda
@@ -9,6 +12,8 @@ namespace lambda
     {
       namespace wave
       {
+        IScriptContext* g_script_context = nullptr;
+
         Map<uint64_t, int16_t> g_ref_counts;
         UnorderedMap<String, uint64_t> g_wave_ids;
         Vector<asset::VioletWaveHandle> g_waves;
@@ -23,9 +28,44 @@ namespace lambda
 
           return g_wave_ids.at(file_path);
         }
+        uint64_t LoadAsync(const String& file_path, const float& priority)
+        {
+          if (g_wave_ids.find(file_path) == g_wave_ids.end())
+          {
+            g_wave_ids.insert(eastl::make_pair(file_path, g_waves.size()));
+            g_waves.push_back(asset::WaveManager::getInstance()->getAsync(Name(file_path.c_str()), priority));
+          }
+
+          return g_wave_ids.at(file_path);
+        }
         float GetLength(const uint64_t& id)
         {
-          return (float)g_waves[id]->getBuffer()->getLength();
+          // Waves that are still streaming have no buffer yet.
+          SoLoud::Wav* buffer = g_waves[id]->getBuffer();
+          return buffer ? (float)buffer->getLength() : 0.0f;
+        }
+        uint8_t GetLoadState(const uint64_t& id)
+        {
+          return (uint8_t)asset::AssetStreamer::getInstance()->getState(g_waves[id].getHash());
+        }
+        void SetLoadPriority(const uint64_t& id, const float& priority)
+        {
+          asset::AssetStreamer::getInstance()->setPriority(g_waves[id].getHash(), priority);
+        }
+        void CancelLoad(const uint64_t& id)
+        {
+          asset::AssetStreamer::getInstance()->cancel(g_waves[id].getHash());
+        }
+        void OnLoaded(const uint64_t& id, const String& function)
+        {
+          const uint64_t wave_id = id;
+          asset::AssetStreamer::getInstance()->addCallback(
+            g_waves[id].getHash(),
+            [wave_id, function](uint64_t /*hash*/, asset::LoadState state) {
+              if (g_script_context)
+                g_script_context->executeFunction(function, { ScriptValue(wave_id), ScriptValue((uint8_t)state) });
+            }
+          );
         }
         void IncRef(const uint64_t& id)
         {
@@ -65,11 +105,18 @@ namespace lambda
 
         extern Map<lambda::String, void*> Bind(world::IWorld* world)
         {
+          g_script_context = world->getScripting().get();
+
           return Map<lambda::String, void*>{
-            { "uint64 Violet_Assets_Wave::Load(const String& in)",     (void*)Load },
-            { "float Violet_Assets_Wave::GetLength(const uint64& in)", (void*)GetLength },
-            { "void Violet_Assets_Wave::IncRef(const uint64& in)",     (void*)IncRef },
-            { "void Violet_Assets_Wave::DecRef(const uint64& in)",     (void*)DecRef },
+            { "uint64 Violet_Assets_Wave::Load(const String& in)",                           (void*)Load },
+            { "uint64 Violet_Assets_Wave::LoadAsync(const String& in, const float& in)",     (void*)LoadAsync },
+            { "float Violet_Assets_Wave::GetLength(const uint64& in)",                       (void*)GetLength },
+            { "uint8 Violet_Assets_Wave::GetLoadState(const uint64& in)",                    (void*)GetLoadState },
+            { "void Violet_Assets_Wave::SetLoadPriority(const uint64& in, const float& in)", (void*)SetLoadPriority },
+            { "void Violet_Assets_Wave::CancelLoad(const uint64& in)",                       (void*)CancelLoad },
+            { "void Violet_Assets_Wave::OnLoaded(const uint64& in, const String& in)",       (void*)OnLoaded },
+            { "void Violet_Assets_Wave::IncRef(const uint64& in)",                           (void*)IncRef },
+            { "void Violet_Assets_Wave::DecRef(const uint64& in)",                           (void*)DecRef },
           };
         }
 
@@ -78,6 +125,7 @@ namespace lambda
           g_waves.clear();
           g_wave_ids.clear();
           g_ref_counts.clear();
+          g_script_context = nullptr;
         }
       }
     }
@@ -1,10 +1,13 @@
 #include "scripting/wren/wren_binding.h"
 #include <assets/texture.h>
+#include <assets/wave.h>
+#include <assets/asset_streamer.h>
 #include <assets/mesh.h>
 #include <assets/mesh_io.h>
 #include <assets/shader.h>
 #include <assets/shader_io.h>
 #include <systems/entity_system.h>
+#include <systems/component_store.h>
 #include <systems/name_system.h>
 #include <systems/transform_system.h>
 #include <systems/camera_system.h>
@@ -743,6 +746,85 @@ namespace lambda
 			return nullptr;
 		}
 	}
+    namespace Streaming
+    {
+      /////////////////////////////////////////////////////////////////////////
+      struct LoadCallback
+      {
+        WrenHandle* object;
+        WrenHandle* function;
+      };
+      // Keyed on an id instead of handed to the streamer, so the handles can
+      // be released with the VM while a load is still pending.
+      UnorderedMap<uint32_t, LoadCallback> g_callbacks;
+      uint32_t g_next_callback = 0u;
+
+      /////////////////////////////////////////////////////////////////////////
+      void release(WrenVM* vm)
+      {
+        for (auto& it : g_callbacks)
+        {
+          wrenReleaseHandle(vm, it.second.object);
+          wrenReleaseHandle(vm, it.second.function);
+        }
+        g_callbacks.clear();
+      }
+
+      /////////////////////////////////////////////////////////////////////////
+      // Expects the receiver in slot 1 and the signature of the method that
+      // is called with the load state in slot 2.
+      void onLoaded(WrenVM* vm, uint64_t hash)
+      {
+        const uint32_t id = g_next_callback++;
+        LoadCallback& callback = g_callbacks[id];
+        callback.object = wrenGetSlotHandle(vm, 1);
+        callback.function = wrenMakeCallHandle(vm, wrenGetSlotString(vm, 2));
+
+        asset::AssetStreamer::getInstance()->addCallback(
+          hash,
+          [id](uint64_t /*hash*/, asset::LoadState state) {
+            auto it = g_callbacks.find(id);
+            if (it == g_callbacks.end() || !g_world)
+              return;
+
+            const LoadCallback callback = it->second;
+            g_callbacks.erase(it);
+            g_world->getScripting()->executeFunction(
+              callback.object,
+              callback.function,
+              { ScriptValue((uint8_t)state) }
+            );
+            g_world->getScripting()->freeHandle(callback.object);
+            g_world->getScripting()->freeHandle(callback.function);
+          }
+        );
+      }
+
+      /////////////////////////////////////////////////////////////////////////
+      // Binds loadState, loadPriority=(_), cancelLoad() and onLoaded(_,_)
+      // for a foreign class that wraps an asset handle.
+      template<typename T>
+      WrenForeignMethodFn Bind(const char* signature)
+      {
+        if (strcmp(signature, "loadState") == 0) return [](WrenVM* vm) {
+          const T& handle = *GetForeign<T>(vm);
+          wrenSetSlotDouble(vm, 0, (double)asset::AssetStreamer::getInstance()->getState(handle.getHash()));
+        };
+        if (strcmp(signature, "loadPriority=(_)") == 0) return [](WrenVM* vm) {
+          const T& handle = *GetForeign<T>(vm);
+          asset::AssetStreamer::getInstance()->setPriority(handle.getHash(), (float)wrenGetSlotDouble(vm, 1));
+        };
+        if (strcmp(signature, "cancelLoad()") == 0) return [](WrenVM* vm) {
+          const T& handle = *GetForeign<T>(vm);
+          asset::AssetStreamer::getInstance()->cancel(handle.getHash());
+        };
+        if (strcmp(signature, "onLoaded(_,_)") == 0) return [](WrenVM* vm) {
+          const T& handle = *GetForeign<T>(vm);
+          onLoaded(vm, handle.getHash());
+        };
+        return nullptr;
+      }
+    }
     namespace Texture
     {
       WrenHandle* handle = nullptr;
@@ -786,6 +868,28 @@ namespace lambda
           asset::VioletTextureHandle& handle = *make(vm);
           handle = asset::TextureManager::getInstance()->get(name);
         };
+        if (strcmp(signature, "loadAsync(_,_)") == 0) return [](WrenVM* vm) {
+          Name name(wrenGetSlotString(vm, 1));
+          const float priority = (float)wrenGetSlotDouble(vm, 2);
+          asset::VioletTextureHandle& handle = *make(vm);
+          handle = asset::TextureManager::getInstance()->getAsync(
+            name,
+            asset::VioletTextureHandle(),
+            priority
+          );
+        };
+        if (strcmp(signature, "loadAsync(_,_,_)") == 0) return [](WrenVM* vm) {
+          Name name(wrenGetSlotString(vm, 1));
+          asset::VioletTextureHandle placeholder =
+            *GetForeign<asset::VioletTextureHandle>(vm, 2);
+          const float priority = (float)wrenGetSlotDouble(vm, 3);
+          asset::VioletTextureHandle& handle = *make(vm);
+          handle = asset::TextureManager::getInstance()->getAsync(
+            name,
+            placeholder,
+            priority
+          );
+        };
         if (strcmp(signature, "loadCubeMap(_,_,_,_,_,_)") == 0) 
           return [](WrenVM* vm) {
           Name name_01(wrenGetSlotString(vm, 1));
@@ -856,7 +960,7 @@ namespace lambda
 						*GetForeign<asset::VioletTextureHandle>(vm);
 					wrenSetSlotDouble(vm, 0, (double)handle->getLayer(0u).getFormat());
 				};
-        return nullptr;
+        return Streaming::Bind<asset::VioletTextureHandle>(signature);
       }
     }
     namespace Shader
@@ -943,7 +1047,13 @@ namespace lambda
           asset::VioletWaveHandle& handle = *make(vm);
           handle = asset::WaveManager::getInstance()->get(name);
         };
-        return nullptr;
+        if (strcmp(signature, "loadAsync(_,_)") == 0) return [](WrenVM* vm) {
+          Name name(wrenGetSlotString(vm, 1));
+          const float priority = (float)wrenGetSlotDouble(vm, 2);
+          asset::VioletWaveHandle& handle = *make(vm);
+          handle = asset::WaveManager::getInstance()->getAsync(name, priority);
+        };
+        return Streaming::Bind<asset::VioletWaveHandle>(signature);
       }
     }
     namespace Mesh
@@ -986,6 +1096,11 @@ namespace lambda
           Name name(wrenGetSlotString(vm, 1));
 					*make(vm) = asset::MeshManager::getInstance()->get(name);
         };
+				if (strcmp(signature, "loadAsync(_,_)") == 0) return [](WrenVM* vm) {
+					Name name(wrenGetSlotString(vm, 1));
+					const float priority = (float)wrenGetSlotDouble(vm, 2);
+					*make(vm) = asset::MeshManager::getInstance()->getAsync(name, priority);
+				};
 				if (strcmp(signature, "generate(_)") == 0) return [](WrenVM* vm) {
 					static uint32_t s_idx = 0u;
 					String type = wrenGetSlotString(vm, 1);
@@ -1219,7 +1334,7 @@ namespace lambda
           asset::VioletMeshHandle mesh = *GetForeign<asset::VioletMeshHandle>(vm);
           mesh->recalculateTangents();
         };
-        return nullptr;
+        return Streaming::Bind<asset::VioletMeshHandle>(signature);
       }
     }
 
@@ -1440,8 +1555,10 @@ namespace lambda
 			if (components::MonoBehaviourSystem::hasComponent(e, *g_scene)) components::MonoBehaviourSystem::removeComponent(e, *g_scene);
 			if (components::WaveSourceSystem::hasComponent(e, *g_scene))    components::WaveSourceSystem::removeComponent(e, *g_scene);
 			if (components::LightSystem::hasComponent(e, *g_scene))					components::LightSystem::removeComponent(e, *g_scene);
-			// TODO (Hilze): Free used entities.
-			//g_entitySystem->destroyEntity(e);
+#if VIOLET_NETWORKING
+			if (components::ReplicationSystem::hasComponent(e, *g_scene))   components::ReplicationSystem::removeComponent(e, *g_scene);
+#endif
+			g_scene->entity.destroy(e);
 		}
 
     ///////////////////////////////////////////////////////////////////////////
@@ -1449,29 +1566,9 @@ namespace lambda
     {
       ScriptingComponentData& getData(entity::Entity id)
       {
-        auto it = entity_to_data_.find(id);
-        if (it == entity_to_data_.end())
-        {
-					if (!unused_data_entries_.empty())
-					{
-						uint32_t idx = unused_data_entries_.front();
-						unused_data_entries_.pop();
-
-						data_[idx] = ScriptingComponentData(id);
-						data_to_entity_[idx] = id;
-						entity_to_data_[id] = idx;
-						return data_[idx];
-					}
-					else
-					{
-						data_.push_back(ScriptingComponentData(id));
-						uint32_t idx = (uint32_t)data_.size() - 1u;
-						data_to_entity_[idx] = id;
-						entity_to_data_[id] = idx;
-						return data_[idx];
-					}
-        }
-        return data_[it->second];
+        if (!data_.has(id))
+          return data_.add(id);
+        return data_.get(id);
       }
 
 			void getAll(Vector<entity::Entity>& vec, entity::Entity e)
@@ -1486,9 +1583,7 @@ namespace lambda
 
 			void freeAll(WrenVM* vm)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : entity_to_data_)
-					entities.push_back(it.first);
+				Vector<entity::Entity> entities = data_.entities;
 
 				for (const auto& entity : entities)
 					free(vm, entity);
@@ -1507,14 +1602,11 @@ namespace lambda
 					release(entity);
 
 					// Release the scripting data.
-					const auto& it = entity_to_data_.find(entity);
-					if (it != entity_to_data_.end())
+					if (data_.has(entity))
 					{
-						uint32_t idx = it->second;
-
 						{
 							// Free the resources.
-							auto& data = data_[idx];
+							auto& data = data_.get(entity);
 
 #define FREE(x) if (x) wrenReleaseHandle(vm, x), x = nullptr;
 							FREE(data.transform);
@@ -1529,18 +1621,13 @@ namespace lambda
 #undef FREE
 						}
 
-						unused_data_entries_.push(idx);
-						data_to_entity_.erase(idx);
-						entity_to_data_.erase(entity);
+						data_.erase(entity);
 					}
 				}
 			}
 
     private:
-			Vector<ScriptingComponentData> data_;
-			Map<entity::Entity, uint32_t> entity_to_data_;
-			Map<uint32_t, entity::Entity> data_to_entity_;
-			Queue<uint32_t> unused_data_entries_;
+			components::ComponentStore<ScriptingComponentData> data_;
     };
 
     ScriptingData* g_scriptingData = nullptr;
@@ -3594,6 +3681,52 @@ namespace lambda
 				return nullptr;
 			}
 		}
+		namespace Replication
+		{
+			WrenForeignMethodFn Bind(const char* signature)
+			{
+#if VIOLET_NETWORKING
+				if (strcmp(signature, "host(_,_)") == 0) return [](WrenVM* vm) {
+					components::ReplicationSystem::host((uint16_t)wrenGetSlotDouble(vm, 1), (uint32_t)wrenGetSlotDouble(vm, 2), *g_scene);
+				};
+				if (strcmp(signature, "connect(_,_)") == 0) return [](WrenVM* vm) {
+					components::ReplicationSystem::connect(wrenGetSlotString(vm, 1), (uint16_t)wrenGetSlotDouble(vm, 2), *g_scene);
+				};
+				if (strcmp(signature, "stop()") == 0) return [](WrenVM* vm) {
+					components::ReplicationSystem::stop(*g_scene);
+				};
+				if (strcmp(signature, "isServer") == 0) return [](WrenVM* vm) {
+					wrenSetSlotBool(vm, 0, components::ReplicationSystem::isServer(*g_scene));
+				};
+				if (strcmp(signature, "isClient") == 0) return [](WrenVM* vm) {
+					wrenSetSlotBool(vm, 0, components::ReplicationSystem::isClient(*g_scene));
+				};
+				if (strcmp(signature, "interestRadius=(_)") == 0) return [](WrenVM* vm) {
+					components::ReplicationSystem::setInterestRadius((float)wrenGetSlotDouble(vm, 1), *g_scene);
+				};
+				if (strcmp(signature, "replicate(_)") == 0) return [](WrenVM* vm) {
+					entity::Entity e = *GetForeign<entity::Entity>(vm, 1);
+					if (!components::ReplicationSystem::hasComponent(e, *g_scene))
+						components::ReplicationSystem::addComponent(e, *g_scene);
+				};
+				if (strcmp(signature, "networkId(_)") == 0) return [](WrenVM* vm) {
+					wrenSetSlotDouble(vm, 0, (double)components::ReplicationSystem::getNetworkId(*GetForeign<entity::Entity>(vm, 1), *g_scene));
+				};
+				if (strcmp(signature, "priority(_)") == 0) return [](WrenVM* vm) {
+					wrenSetSlotDouble(vm, 0, (double)components::ReplicationSystem::getPriority(*GetForeign<entity::Entity>(vm, 1), *g_scene));
+				};
+				if (strcmp(signature, "setPriority(_,_)") == 0) return [](WrenVM* vm) {
+					components::ReplicationSystem::setPriority(*GetForeign<entity::Entity>(vm, 1), (float)wrenGetSlotDouble(vm, 2), *g_scene);
+				};
+				return nullptr;
+#else
+				// Scripts still load without networking, but nothing replicates.
+				return [](WrenVM* vm) {
+					foundation::Warning("Replication: The engine was built without networking.\n");
+				};
+#endif
+			}
+		}
     namespace File
     {
       struct File
@@ -4213,6 +4346,8 @@ namespace lambda
 				return Debug::Bind(signature);
 			if (hashEqual(className, "Physics"))
 				return Physics::Bind(signature);
+			if (hashEqual(className, "Replication"))
+				return Replication::Bind(signature);
 			if (hashEqual(className, "Manifold"))
 				return Manifold::Bind(signature);
 			if (hashEqual(className, "File"))
@@ -4364,6 +4499,7 @@ namespace lambda
 			SAFE_RELEASE(vm, NavMeshPromise::handle);
 			SAFE_RELEASE(vm, TriNavMesh::handle);
 
+			Streaming::release(vm);
 			components::MonoBehaviourSystem::deinitialize(*g_scene);
 
 			g_scene = nullptr;
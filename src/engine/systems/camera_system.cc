@@ -17,22 +17,7 @@ namespace lambda
 		{
 			void collectGarbage(scene::Scene& scene)
 			{
-				if (!scene.camera.marked_for_delete.empty())
-				{
-					for (entity::Entity entity : scene.camera.marked_for_delete)
-					{
-						const auto& it = scene.camera.entity_to_data.find(entity);
-						if (it != scene.camera.entity_to_data.end())
-						{
-							uint32_t idx = it->second;
-							scene.camera.unused_data_entries.push(idx);
-							scene.camera.data_to_entity.erase(idx);
-							scene.camera.entity_to_data.erase(entity);
-							scene.camera.data[idx].valid = false;
-						}
-					}
-					scene.camera.marked_for_delete.clear();
-				}
+				scene.camera.collectGarbage();
 			}
 
 			void initialize(scene::Scene& scene)
@@ -44,9 +29,7 @@ namespace lambda
 
 			void deinitialize(scene::Scene& scene)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : scene.camera.entity_to_data)
-					entities.push_back(it.first);
+				Vector<entity::Entity> entities = scene.camera.entities;
 
 				for (const auto& entity : entities)
 					scene.camera.remove(entity);
@@ -71,8 +54,8 @@ namespace lambda
 				components::MeshRenderSystem::createRenderList(scene.camera.main_camera_culler, scene.camera.main_camera_frustum, scene);
 				auto statics = scene.camera.main_camera_culler.getStatics();
 				auto dynamics = scene.camera.main_camera_culler.getDynamics();
-				components::MeshRenderSystem::createSortedRenderList(&statics, opaque, alpha, scene);
-				components::MeshRenderSystem::createSortedRenderList(&dynamics, opaque, alpha, scene);
+				components::MeshRenderSystem::createSortedRenderList(statics, opaque, alpha, scene);
+				components::MeshRenderSystem::createSortedRenderList(dynamics, opaque, alpha, scene);
 
 				// Draw all passes.
 				scene.renderer->beginTimer("Main Camera");
@@ -96,10 +79,7 @@ namespace lambda
 			void updateCameraTransforms(scene::Scene& scene)
 			{
 				for (Data& data : scene.camera.data)
-				{
-					TransformSystem::cleanIfDirty(scene.transform.get(data.entity), scene);
-					data.world_matrix = scene.transform.get(data.entity).world;
-				}
+					data.world_matrix = TransformSystem::getWorld(data.entity, scene);
 			}
 
 			CameraComponent CameraSystem::addComponent(const entity::Entity& entity, scene::Scene& scene)
@@ -238,50 +218,6 @@ namespace lambda
 			}
 		}
 
-		// The system data.
-		namespace CameraSystem
-		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
-
-				return data[idx];
-			}
-
-			Data& SystemData::get(const entity::Entity& entity)
-			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "CAMERA: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "CAMERA: %llu's data was not valid", entity);
-				return data[it->second];
-			}
-
-			void SystemData::remove(const entity::Entity& entity)
-			{
-				marked_for_delete.insert(entity);
-			}
-
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
-			}
-		}
-
 		namespace CameraSystem
 		{
 			Data::Data(const Data& other)
@@ -291,7 +227,6 @@ namespace lambda
 				far_plane = other.far_plane;
 				shader_passes = other.shader_passes;
 				entity = other.entity;
-				valid = other.valid;
 				projection = other.projection;
 				width = other.width;
 				height = other.height;
@@ -304,7 +239,6 @@ namespace lambda
 				far_plane = other.far_plane;
 				shader_passes = other.shader_passes;
 				entity = other.entity;
-				valid = other.valid;
 				projection = other.projection;
 				width = other.width;
 				height = other.height;
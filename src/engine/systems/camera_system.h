@@ -1,5 +1,6 @@
 #pragma once
 #include <systems/entity.h>
+#include <systems/component_store.h>
 #include <utils/angle.h>
 #include <utils/distance.h>
 #include <platform/shader_pass.h>
@@ -71,22 +72,10 @@ namespace lambda
 				glm::mat4x4 world_matrix;
 
 				entity::Entity entity;
-				bool valid = true;
 			};
 
-			struct SystemData
+			struct SystemData : public ComponentStore<Data>
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
-
 				entity::Entity main_camera = entity::InvalidEntity;
 				utilities::Frustum main_camera_frustum;
 				utilities::Culler main_camera_culler;
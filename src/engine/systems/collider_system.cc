@@ -43,16 +43,9 @@ namespace lambda
 				{
 					for (entity::Entity entity : scene.collider.marked_for_delete)
 					{
-						const auto& it = scene.collider.entity_to_data.find(entity);
-						if (it != scene.collider.entity_to_data.end())
+						if (scene.collider.has(entity))
 						{
-							auto& data = scene.collider.data.at(it->second);
-
-							uint32_t idx = it->second;
-							scene.collider.unused_data_entries.push(idx);
-							scene.collider.data_to_entity.erase(idx);
-							scene.collider.entity_to_data.erase(entity);
-							scene.collider.data[idx].valid = false;
+							scene.collider.erase(entity);
 
 							if (RigidBodySystem::hasComponent(entity, scene))
 								RigidBodySystem::removeComponent(entity, scene);
@@ -64,9 +57,7 @@ namespace lambda
 			}
 			void deinitialize(scene::Scene& scene)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : scene.collider.entity_to_data)
-					entities.push_back(it.first);
+				Vector<entity::Entity> entities = scene.collider.entities;
 
 				for (const auto& entity : entities)
 					removeComponent(entity, scene);
@@ -104,53 +95,6 @@ namespace lambda
 
 
 
-		// The system data.
-		namespace ColliderSystem
-		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
-
-				return data[idx];
-			}
-
-			Data& SystemData::get(const entity::Entity& entity)
-			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "COLLIDER: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "COLLIDER: %llu's data was not valid", entity);
-				return data[it->second];
-			}
-
-			void SystemData::remove(const entity::Entity& entity)
-			{
-				marked_for_delete.insert(entity);
-			}
-
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
-			}
-		}
-
-
-
-
 		namespace ColliderSystem
 		{
 			Data::Data(const Data& other)
@@ -158,14 +102,12 @@ namespace lambda
 				type = other.type;
 				is_trigger = other.is_trigger;
 				entity = other.entity;
-				valid = other.valid;
 			}
 			Data& Data::operator=(const Data& other)
 			{
 				type = other.type;
 				is_trigger = other.is_trigger;
 				entity = other.entity;
-				valid = other.valid;
 				return *this;
 			}
 		}
@@ -0,0 +1,138 @@
+#pragma once
+#include "entity.h"
+#include <containers/containers.h>
+#include <utils/console.h>
+
+namespace lambda
+{
+	namespace components
+	{
+		///////////////////////////////////////////////////////////////////////////
+		// Sparse set of components. The components are packed in data so they can
+		// be iterated without holes. sparse maps the index of an entity to its
+		// slot in data and entities maps the slot back to the entity.
+		// Removing is deferred until collectGarbage. Erasing a component moves
+		// the last component into its slot, so slots are not stable.
+		template<typename T>
+		struct ComponentStore
+		{
+			static constexpr uint32_t kInvalidSlot = ~0u;
+
+			Vector<T>              data;
+			Vector<entity::Entity> entities;
+			Vector<uint32_t>       sparse;
+			Set<entity::Entity>    marked_for_delete;
+
+			T&       add(const entity::Entity& entity);
+			T&       get(const entity::Entity& entity);
+			void     remove(const entity::Entity& entity);
+			bool     has(const entity::Entity& entity) const;
+			uint32_t slot(const entity::Entity& entity) const;
+			uint32_t size() const { return (uint32_t)data.size(); }
+
+			// Removes the component immediately.
+			void erase(const entity::Entity& entity);
+			// Erases everything that was marked for delete.
+			void collectGarbage();
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		constexpr uint32_t ComponentStore<T>::kInvalidSlot;
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		T& ComponentStore<T>::add(const entity::Entity& entity)
+		{
+			const uint32_t index = entity::getIndex(entity);
+			if (index >= sparse.size())
+				sparse.resize(index + 1u, kInvalidSlot);
+
+			uint32_t idx = sparse[index];
+			if (idx != kInvalidSlot)
+			{
+				LMB_ASSERT(entities[idx] == entity, "COMPONENT: %u is still used by %u", index, entities[idx]);
+
+				// Adding again resets the component and cancels a pending remove.
+				marked_for_delete.erase(entity);
+				data[idx] = T(entity);
+				return data[idx];
+			}
+
+			idx = (uint32_t)data.size();
+			sparse[index] = idx;
+			entities.push_back(entity);
+			data.push_back(T(entity));
+			return data[idx];
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		T& ComponentStore<T>::get(const entity::Entity& entity)
+		{
+			const uint32_t idx = slot(entity);
+			LMB_ASSERT(idx != kInvalidSlot, "COMPONENT: %u does not have a component", entity);
+			return data[idx];
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		void ComponentStore<T>::remove(const entity::Entity& entity)
+		{
+			marked_for_delete.insert(entity);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		bool ComponentStore<T>::has(const entity::Entity& entity) const
+		{
+			return slot(entity) != kInvalidSlot;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		uint32_t ComponentStore<T>::slot(const entity::Entity& entity) const
+		{
+			const uint32_t index = entity::getIndex(entity);
+			if (index >= sparse.size())
+				return kInvalidSlot;
+
+			// The generation check makes stale handles miss.
+			const uint32_t idx = sparse[index];
+			if (idx == kInvalidSlot || entities[idx] != entity)
+				return kInvalidSlot;
+
+			return idx;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		void ComponentStore<T>::erase(const entity::Entity& entity)
+		{
+			const uint32_t idx = slot(entity);
+			if (idx == kInvalidSlot)
+				return;
+
+			const uint32_t last = (uint32_t)data.size() - 1u;
+			if (idx != last)
+			{
+				data[idx]     = eastl::move(data[last]);
+				entities[idx] = entities[last];
+				sparse[entity::getIndex(entities[idx])] = idx;
+			}
+
+			data.pop_back();
+			entities.pop_back();
+			sparse[entity::getIndex(entity)] = kInvalidSlot;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		void ComponentStore<T>::collectGarbage()
+		{
+			for (const entity::Entity& entity : marked_for_delete)
+				erase(entity);
+			marked_for_delete.clear();
+		}
+	}
+}
@@ -5,7 +5,29 @@ namespace lambda
 {
 	namespace entity
 	{
+		// The low bits index into the entity and component tables, the high
+		// bits hold a generation that is bumped every time the index is freed.
+		// A handle that is kept after its entity was destroyed will therefore
+		// not match the entity that reuses the index.
 		typedef uint32_t Entity;
 		constexpr Entity InvalidEntity = 0u;
+
+		constexpr uint32_t kIndexBits      = 24u;
+		constexpr uint32_t kGenerationBits = 8u;
+		constexpr uint32_t kIndexMask      = (1u << kIndexBits) - 1u;
+		constexpr uint32_t kGenerationMask = (1u << kGenerationBits) - 1u;
+
+		inline constexpr uint32_t getIndex(Entity entity)
+		{
+			return entity & kIndexMask;
+		}
+		inline constexpr uint32_t getGeneration(Entity entity)
+		{
+			return (entity >> kIndexBits) & kGenerationMask;
+		}
+		inline constexpr Entity makeEntity(uint32_t index, uint32_t generation)
+		{
+			return ((generation & kGenerationMask) << kIndexBits) | (index & kIndexMask);
+		}
 	}
-}
\ No newline at end of file
+}
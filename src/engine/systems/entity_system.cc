@@ -11,27 +11,43 @@ namespace lambda
 			{
 				if (free_ids.empty() == true)
 				{
-					for (entity::Entity i = 0ull; i < kFreeIdIncrement; ++i)
+					LMB_ASSERT(free_id_count + kFreeIdIncrement <= entity::kIndexMask, "ENTITY: Ran out of entity indices");
+					for (uint32_t i = 0u; i < kFreeIdIncrement; ++i)
 						free_ids.push(free_id_count + i);
 
 					free_id_count += kFreeIdIncrement;
+					generations.resize(free_id_count, 0u);
 				}
 
-				entity::Entity id = free_ids.front();
+				uint32_t index = free_ids.front();
 				free_ids.pop();
 
-				return id;
+				return entity::makeEntity(index, generations[index]);
 			}
 
 			void SystemData::destroy(entity::Entity entity)
 			{
-				free_ids.push(entity);
+				if (!valid(entity))
+					return;
+
+				// Bump the generation right away so the handle goes stale.
+				uint32_t index = entity::getIndex(entity);
+				generations[index] = (uint8_t)((generations[index] + 1u) & entity::kGenerationMask);
+				marked_for_delete.push_back(index);
+			}
+
+			bool SystemData::valid(entity::Entity entity) const
+			{
+				uint32_t index = entity::getIndex(entity);
+				return index > 0u && index < generations.size() && generations[index] == entity::getGeneration(entity);
 			}
 
-			bool SystemData::valid(entity::Entity entity)
+			void SystemData::collectGarbage()
 			{
-				return entity > 0ull;
+				for (uint32_t index : marked_for_delete)
+					free_ids.push(index);
+				marked_for_delete.clear();
 			}
 		}
 	}
-}
\ No newline at end of file
+}
@@ -16,13 +16,20 @@ namespace lambda
 		{
 			struct SystemData
 			{
-				static constexpr entity::Entity kFreeIdIncrement = 64ull;
-				entity::Entity free_id_count = 1;
-				Queue<entity::Entity> free_ids;
+				static constexpr uint32_t kFreeIdIncrement = 64u;
+				// Index 0 is never handed out so InvalidEntity stays invalid.
+				uint32_t free_id_count = 1u;
+				Queue<uint32_t> free_ids;
+				// The current generation of every index that was ever handed out.
+				Vector<uint8_t> generations;
+				// Destroyed indices are only reused after the component systems
+				// have collected their garbage.
+				Vector<uint32_t> marked_for_delete;
 
 				entity::Entity create();
 				void destroy(entity::Entity entity);
-				bool valid(entity::Entity entity);
+				bool valid(entity::Entity entity) const;
+				void collectGarbage();
 			};
 		}
 	}
@@ -37,7 +44,9 @@ namespace meta
 	{
 		return members(
 			member("free_id_count", &lambda::components::EntitySystem::SystemData::free_id_count),
-			member("free_ids", &lambda::components::EntitySystem::SystemData::free_ids)
+			member("free_ids", &lambda::components::EntitySystem::SystemData::free_ids),
+			member("generations", &lambda::components::EntitySystem::SystemData::generations),
+			member("marked_for_delete", &lambda::components::EntitySystem::SystemData::marked_for_delete)
 		);
 	}
 }
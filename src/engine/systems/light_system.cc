@@ -57,31 +57,13 @@ namespace lambda
 			}
 			void collectGarbage(scene::Scene& scene)
 			{
-				if (!scene.light.marked_for_delete.empty())
-				{
-					for (entity::Entity entity : scene.light.marked_for_delete)
-					{
-						const auto& it = scene.light.entity_to_data.find(entity);
-						if (it != scene.light.entity_to_data.end())
-						{
-							uint32_t idx = it->second;
-							scene.light.unused_data_entries.push(idx);
-							scene.light.data_to_entity.erase(idx);
-							scene.light.entity_to_data.erase(entity);
-							scene.light.data[idx].valid = false;
-						}
-					}
-					scene.light.marked_for_delete.clear();
-				}
+				scene.light.collectGarbage();
 			}
 
 			void updateLightTransforms(scene::Scene& scene)
 			{
 				for (Data& data : scene.light.data)
-				{
-					TransformSystem::cleanIfDirty(scene.transform.get(data.entity), scene);
-					data.world_matrix = scene.transform.get(data.entity).world;
-				}
+					data.world_matrix = TransformSystem::getWorld(data.entity, scene);
 			}
 
 			LightComponent addDirectionalLight(const entity::Entity& entity, scene::Scene& scene)
@@ -148,9 +130,7 @@ namespace lambda
 			}
 		void deinitialize(scene::Scene& scene)
 		{
-			Vector<entity::Entity> entities;
-			for (const auto& it : scene.light.entity_to_data)
-				entities.push_back(it.first);
+			Vector<entity::Entity> entities = scene.light.entities;
 
 			for (const auto& entity : entities)
 				removeComponent(entity, scene);
@@ -869,9 +849,7 @@ namespace lambda
 						if (statics_only)
 						{
 							MeshRenderSystem::createRenderList(data.culler.back(), frustum, scene);
-							utilities::LinkedNode statics = data.culler.back().getStatics();
-							utilities::LinkedNode dynamics;
-							MeshRenderSystem::renderAll(&statics, &dynamics, scene, false);
+							MeshRenderSystem::renderAll(data.culler.back().getStatics(), utilities::CullList(), scene, false);
 						}
 						else
 							MeshRenderSystem::renderAll(data.culler.back(), frustum, scene, false);
@@ -1175,56 +1153,6 @@ namespace lambda
 
 
 
-		// The system data.
-		namespace LightSystem
-		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
-
-				return data[idx];
-			}
-
-			Data& SystemData::get(const entity::Entity& entity)
-			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "LIGHT: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "LIGHT: %llu's data was not valid", entity);
-				return data[it->second];
-			}
-
-			void SystemData::remove(const entity::Entity& entity)
-			{
-				marked_for_delete.insert(entity);
-			}
-
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
-			}
-		}
-
-
-
-
-
-
-
 		namespace LightSystem
 		{
 			Data::Data(const Data& other)
@@ -1250,7 +1178,6 @@ namespace lambda
 				projection = other.projection;
 				view = other.view;
 				view_position = other.view_position;
-				valid = other.valid;
 				render_target_texture = other.render_target_texture;
 				depth_target_texture = other.depth_target_texture;
 				world_matrix = other.world_matrix;
@@ -1278,7 +1205,6 @@ namespace lambda
 				projection = other.projection;
 				view = other.view;
 				view_position = other.view_position;
-				valid = other.valid;
 				render_target_texture = other.render_target_texture;
 				depth_target_texture = other.depth_target_texture;
 				world_matrix = other.world_matrix;
@@ -1,5 +1,6 @@
 #pragma once
 #include "interfaces/icomponent.h"
+#include "systems/component_store.h"
 #include "interfaces/isystem.h"
 #include "platform/shader_pass.h"
 #include "utils/angle.h"
@@ -98,7 +99,6 @@ namespace lambda
 				bool rsm = false;
 				uint8_t dynamic_frequency = 1u;
 				uint8_t dynamic_index = 254u;
-				bool valid = true;
 
 				Vector<float>       depth;
 				Vector<glm::mat4x4> projection;
@@ -115,19 +115,8 @@ namespace lambda
 				glm::mat4x4 world_matrix;
 			};
 
-			struct SystemData
+			struct SystemData : public ComponentStore<Data>
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
-
 				asset::VioletMeshHandle full_screen_mesh;
 
 				String   shader_generate;
@@ -1,5 +1,6 @@
 #include <systems/lod_system.h>
 #include <platform/scene.h>
+#include <interfaces/iwindow.h>
 
 #include <algorithm>
 
@@ -56,28 +57,11 @@ namespace lambda
 			}
 			void collectGarbage(scene::Scene& scene)
 			{
-				if (!scene.lod.marked_for_delete.empty())
-				{
-					for (entity::Entity entity : scene.lod.marked_for_delete)
-					{
-						const auto& it = scene.lod.entity_to_data.find(entity);
-						if (it != scene.lod.entity_to_data.end())
-						{
-							uint32_t idx = it->second;
-							scene.lod.unused_data_entries.push(idx);
-							scene.lod.data_to_entity.erase(idx);
-							scene.lod.entity_to_data.erase(entity);
-							scene.lod.data[idx].valid = false;
-						}
-					}
-					scene.lod.marked_for_delete.clear();
-				}
+				scene.lod.collectGarbage();
 			}
 			void deinitialize(scene::Scene& scene)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : scene.lod.entity_to_data)
-					entities.push_back(it.first);
+				Vector<entity::Entity> entities = scene.lod.entities;
 
 				for (const auto& entity : entities)
 					scene.lod.remove(entity);
@@ -111,6 +95,42 @@ namespace lambda
 
 					components::MeshRenderSystem::setMesh(data.entity, chosen_lod->getMesh(), scene);
 				}
+
+				// Everything else picks from the LODs that came with its mesh.
+				const float window_height = scene.window ? (float)scene.window->getSize().y : 0.0f;
+				const float pixels_per_unit = components::CameraSystem::getProjectionMatrix(scene.camera.main_camera, scene)[1][1] * 0.5f * window_height;
+
+				for (auto& data : scene.mesh_render.data)
+				{
+					if (!data.mesh || data.sub_mesh >= data.mesh->getSubMeshes().size() || scene.lod.has(data.entity))
+						continue;
+
+					const asset::SubMesh& current = data.mesh->getSubMeshes().at(data.sub_mesh);
+					const uint32_t base = current.lod_of >= 0 ? (uint32_t)current.lod_of : data.sub_mesh;
+					const Vector<asset::SubMesh::LOD>& lods = data.mesh->getSubMeshes().at(base).lods;
+					if (lods.empty())
+						continue;
+
+					const glm::vec3 scale = components::TransformSystem::getWorldScale(data.entity, scene);
+					const float max_scale = std::max(std::abs(scale.x), std::max(std::abs(scale.y), std::abs(scale.z)));
+					const float distance = std::max(0.001f, glm::length(components::TransformSystem::getWorldTranslation(data.entity, scene) - camera_position));
+
+					uint32_t chosen = base;
+					for (const asset::SubMesh::LOD& lod : lods)
+					{
+						if (lod.error * max_scale * pixels_per_unit / distance > scene.lod.max_pixel_error)
+							break;
+						chosen = lod.sub_mesh;
+					}
+
+					// Statics only copy their sub mesh when they are made static.
+					if (chosen != data.sub_mesh)
+					{
+						data.sub_mesh = chosen;
+						if (data.renderable.mesh.get() == data.mesh.get())
+							data.renderable.sub_mesh = chosen;
+					}
+				}
 			}
 
 			void setBaseLOD(const entity::Entity& entity, const LOD& lod, scene::Scene& scene)
@@ -134,50 +154,6 @@ namespace lambda
 			}
 		}
 
-		// The system data.
-		namespace LODSystem
-		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
-
-				return data[idx];
-			}
-
-			Data& SystemData::get(const entity::Entity& entity)
-			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "LOD: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "LOD: %llu's data was not valid", entity);
-				return data[it->second];
-			}
-
-			void SystemData::remove(const entity::Entity& entity)
-			{
-				marked_for_delete.insert(entity);
-			}
-
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
-			}
-		}
-
 		namespace LODSystem
 		{
 			Data::Data(const Data& other)
@@ -185,14 +161,12 @@ namespace lambda
 				lods = other.lods;
 				base_lod = other.base_lod;
 				entity = other.entity;
-				valid = other.valid;
 			}
 			Data& Data::operator=(const Data& other)
 			{
 				lods = other.lods;
 				base_lod = other.base_lod;
 				entity = other.entity;
-				valid = other.valid;
 
 				return *this;
 			}
@@ -1,5 +1,6 @@
 #pragma once
 #include <interfaces/icomponent.h>
+#include <systems/component_store.h>
 #include <interfaces/isystem.h>
 #include <assets/mesh.h>
 #include <systems/mesh_render_system.h>
@@ -60,24 +61,15 @@ namespace lambda
 				Vector<LOD> lods;
 				LOD base_lod;
 				entity::Entity entity;
-				bool valid = true;
 			};
 
-			struct SystemData
+			struct SystemData : public ComponentStore<Data>
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
-
 				float time;
 				float update_frequency = 1.0f / 30.0f;
+				// Meshes with LODs from the mesh compiler use the coarsest one that
+				// moves the surface less than this many pixels on screen.
+				float max_pixel_error = 1.0f;
 			};
 
 			LODComponent addComponent(const entity::Entity& entity, scene::Scene& scene);
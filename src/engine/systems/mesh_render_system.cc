@@ -10,6 +10,8 @@
 #include <glm/gtx/norm.hpp>
 #include "assets/mesh_io.h"
 #include "assets/mesh.h"
+#include "assets/asset_streamer.h"
+#include "assets/texture_streamer.h"
 #include <algorithm>
 #include <cmath>
 #include "platform/culling.h"
@@ -53,9 +55,14 @@ namespace lambda
 				if (!TransformSystem::hasComponent(entity, scene))
 					TransformSystem::addComponent(entity, scene);
 
-				scene.mesh_render.add(entity);
-				
-				scene.mesh_render.dynamic_renderables.push_back(scene.mesh_render.entity_to_data[entity]);
+				Data& data = scene.mesh_render.add(entity);
+				data.albedo_texture    = scene.mesh_render.default_albedo;
+				data.normal_texture    = scene.mesh_render.default_normal;
+				data.dmra_texture      = scene.mesh_render.default_dmra;
+				data.emissive_texture  = scene.mesh_render.default_emissive;
+				data.renderable.entity = entity;
+
+				scene.mesh_render.dynamic_renderables.push_back(entity);
 
 				return MeshRenderComponent(entity, scene);
 			}
@@ -78,25 +85,27 @@ namespace lambda
 				{
 					for (entity::Entity entity : scene.mesh_render.marked_for_delete)
 					{
-						const auto& it = scene.mesh_render.entity_to_data.find(entity);
-						if (it != scene.mesh_render.entity_to_data.end())
+						if (scene.mesh_render.has(entity))
 						{
-							auto dit = eastl::find(scene.mesh_render.dynamic_renderables.begin(), scene.mesh_render.dynamic_renderables.end(), scene.mesh_render.entity_to_data[entity]);
+							auto dit = eastl::find(scene.mesh_render.dynamic_renderables.begin(), scene.mesh_render.dynamic_renderables.end(), entity);
 							if (dit != scene.mesh_render.dynamic_renderables.end())
+							{
+								scene.mesh_render.dynamic_bvh->remove(entity);
 								scene.mesh_render.dynamic_renderables.erase(dit);
+							}
 
-							auto sit = eastl::find(scene.mesh_render.static_renderables.begin(), scene.mesh_render.static_renderables.end(), scene.mesh_render.entity_to_data[entity]);
+							auto sit = eastl::find(scene.mesh_render.static_renderables.begin(), scene.mesh_render.static_renderables.end(), entity);
 							if (sit != scene.mesh_render.static_renderables.end())
 							{
 								scene.mesh_render.static_bvh->remove(entity);
 								scene.mesh_render.static_renderables.erase(sit);
 							}
 
-							uint32_t idx = it->second;
-							scene.mesh_render.unused_data_entries.push(idx);
-							scene.mesh_render.data_to_entity.erase(idx);
-							scene.mesh_render.entity_to_data.erase(entity);
-							scene.mesh_render.data[idx].valid = false;
+							auto pit = eastl::find(scene.mesh_render.streaming_statics.begin(), scene.mesh_render.streaming_statics.end(), entity);
+							if (pit != scene.mesh_render.streaming_statics.end())
+								scene.mesh_render.streaming_statics.erase(pit);
+
+							scene.mesh_render.erase(entity);
 						}
 					}
 					scene.mesh_render.marked_for_delete.clear();
@@ -137,14 +146,20 @@ namespace lambda
 					Vector<unsigned char>{ 255u, 255u, 255u, 255u }
 				);
 
-				scene.mesh_render.static_bvh = foundation::Memory::construct<utilities::BVH>();
-				scene.mesh_render.dynamic_bvh = foundation::Memory::construct<utilities::TransientBVH>();
+				scene.mesh_render.static_bvh = foundation::Memory::construct<utilities::FlatBVH>();
+				scene.mesh_render.dynamic_bvh = foundation::Memory::construct<utilities::FlatBVH>();
+
+				// Textures of streamed meshes show these until they are in.
+				asset::MeshManager::getInstance()->setTexturePlaceholders({
+					scene.mesh_render.default_albedo,
+					scene.mesh_render.default_normal,
+					scene.mesh_render.default_dmra,
+					scene.mesh_render.default_emissive
+				});
 			}
 			void deinitialize(scene::Scene& scene)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : scene.mesh_render.entity_to_data)
-					entities.push_back(it.first);
+				Vector<entity::Entity> entities = scene.mesh_render.entities;
 
 				for (const auto& entity : entities)
 					scene.mesh_render.remove(entity);
@@ -155,18 +170,47 @@ namespace lambda
 				foundation::Memory::destruct(scene.mesh_render.static_bvh);
 				foundation::Memory::destruct(scene.mesh_render.dynamic_bvh);
 
+				asset::MeshManager::getInstance()->setTexturePlaceholders({});
 				scene.mesh_render.default_albedo   = nullptr;
 				scene.mesh_render.default_normal   = nullptr;
 				scene.mesh_render.default_dmra     = nullptr;
 				scene.mesh_render.default_emissive = nullptr;
 			}
+			// A mesh that is still streaming has no sub meshes yet, so there is
+			// nothing to put in a BVH.
+			static bool hasSubMesh(const Data& data)
+			{
+				return data.mesh && data.sub_mesh < data.mesh->getSubMeshes().size();
+			}
+			static void addStatic(Data& data, scene::Scene& scene)
+			{
+				const asset::SubMesh& sub_mesh = data.renderable.mesh->getSubMeshes().at(data.renderable.sub_mesh);
+				getMinMax(sub_mesh.min, sub_mesh.max, data.renderable.model_matrix, data.renderable.min, data.renderable.max);
+				data.renderable.center = (data.renderable.min + data.renderable.max) * 0.5f;
+				data.renderable.radius = glm::length(data.renderable.center - data.renderable.max);
+
+				scene.mesh_render.static_bvh->add(data.renderable.entity, &data.renderable.entity, utilities::BVHAABB(data.renderable.min, data.renderable.max));
+			}
 			void updateDynamicsBvh(scene::Scene& scene)
 			{
-				scene.mesh_render.dynamic_bvh->clear();
+				// Statics whose mesh finished streaming.
+				for (size_t i = 0u; i < scene.mesh_render.streaming_statics.size();)
+				{
+					Data& data = scene.mesh_render.get(scene.mesh_render.streaming_statics[i]);
+					if (hasSubMesh(data))
+					{
+						addStatic(data, scene);
+						scene.mesh_render.streaming_statics.erase(scene.mesh_render.streaming_statics.begin() + i);
+					}
+					else
+						++i;
+				}
 
-				for (uint32_t index : scene.mesh_render.dynamic_renderables)
+				// Moved renderables are refit in place. The tree is only rebuilt
+				// when renderables were added or the refit made it too expensive.
+				for (entity::Entity entity : scene.mesh_render.dynamic_renderables)
 				{
-					auto& data = scene.mesh_render.data[index];
+					auto& data = scene.mesh_render.get(entity);
 					auto& renderable = data.renderable;
 
 					renderable.mesh             = data.mesh;
@@ -180,7 +224,7 @@ namespace lambda
 					renderable.emissiveness     = data.emissiveness;
 					renderable.model_matrix     = components::TransformSystem::getWorld(data.entity, scene);
 
-					if (data.mesh)
+					if (hasSubMesh(data))
 					{
 						const asset::SubMesh& sub_mesh = renderable.mesh->getSubMeshes().at(renderable.sub_mesh);
 						getMinMax(sub_mesh.min, sub_mesh.max, renderable.model_matrix, renderable.min, renderable.max);
@@ -189,7 +233,12 @@ namespace lambda
 
 						scene.mesh_render.dynamic_bvh->add(renderable.entity, &renderable.entity, utilities::BVHAABB(renderable.min, renderable.max));
 					}
+					else
+						scene.mesh_render.dynamic_bvh->remove(renderable.entity);
 				}
+
+				scene.mesh_render.dynamic_bvh->commit();
+				scene.mesh_render.static_bvh->commit();
 			}
 
 			void setMesh(const entity::Entity& entity, asset::VioletMeshHandle mesh, scene::Scene& scene)
@@ -274,10 +323,15 @@ namespace lambda
 				size_t dmra_offset = nor_offset + texture_count.y;
 				size_t emi_offset  = dmra_offset + texture_count.z;
 
+				// The LODs are at the end, and are picked by the LOD system.
+				size_t sub_mesh_count = 0u;
+				while (sub_mesh_count < mesh->getSubMeshes().size() && mesh->getSubMeshes().at(sub_mesh_count).lod_of < 0)
+					sub_mesh_count++;
+
 				// Prepare all of the entities.
-				Vector<entity::Entity> entities(mesh->getSubMeshes().size());
-				Vector<TransformComponent> transforms(mesh->getSubMeshes().size());
-				for (size_t i = 0; i < mesh->getSubMeshes().size(); ++i)
+				Vector<entity::Entity> entities(sub_mesh_count);
+				Vector<TransformComponent> transforms(sub_mesh_count);
+				for (size_t i = 0; i < sub_mesh_count; ++i)
 				{
 					// Create an entity.
 					entity::Entity& e = entities.at(i);
@@ -291,7 +345,7 @@ namespace lambda
 				}
 
 				// Attach all of the mesh renderers.
-				for (size_t i = 0; i < mesh->getSubMeshes().size(); ++i)
+				for (size_t i = 0; i < sub_mesh_count; ++i)
 				{
 					asset::SubMesh& sub_mesh = mesh->getSubMeshes().at(i);
 					TransformComponent transform = transforms.at(i);
@@ -357,14 +411,15 @@ namespace lambda
 			}
 			void makeStatic(const entity::Entity& entity, scene::Scene& scene)
 			{
-				for (uint32_t index : scene.mesh_render.static_renderables)
-					if (scene.mesh_render.data[index].entity == entity)
-						return;
-
+				if (eastl::find(scene.mesh_render.static_renderables.begin(), scene.mesh_render.static_renderables.end(), entity) != scene.mesh_render.static_renderables.end())
+					return;
 
-				auto it = eastl::find(scene.mesh_render.dynamic_renderables.begin(), scene.mesh_render.dynamic_renderables.end(), scene.mesh_render.entity_to_data[entity]);
+				auto it = eastl::find(scene.mesh_render.dynamic_renderables.begin(), scene.mesh_render.dynamic_renderables.end(), entity);
 				if (it != scene.mesh_render.dynamic_renderables.end())
+				{
+					scene.mesh_render.dynamic_bvh->remove(entity);
 					scene.mesh_render.dynamic_renderables.erase(it);
+				}
 
 				Data& data = scene.mesh_render.get(entity);
 				
@@ -379,31 +434,93 @@ namespace lambda
 				data.renderable.roughness        = data.roughness;
 				data.renderable.emissiveness     = data.emissiveness;
 
-				if (data.renderable.mesh)
-				{
-					const asset::SubMesh& sub_mesh = data.renderable.mesh->getSubMeshes().at(data.renderable.sub_mesh);
-					getMinMax(sub_mesh.min, sub_mesh.max, data.renderable.model_matrix, data.renderable.min, data.renderable.max);
-					data.renderable.center = (data.renderable.min + data.renderable.max) * 0.5f;
-					data.renderable.radius = glm::length(data.renderable.center - data.renderable.max);
-
-					scene.mesh_render.static_bvh->add(data.renderable.entity, &data.renderable.entity, utilities::BVHAABB(data.renderable.min, data.renderable.max));
-				}
+				if (hasSubMesh(data))
+					addStatic(data, scene);
+				else if (data.renderable.mesh)
+					scene.mesh_render.streaming_statics.push_back(entity);
 
-				scene.mesh_render.static_renderables.push_back(scene.mesh_render.entity_to_data[entity]);
+				scene.mesh_render.static_renderables.push_back(entity);
 			}
 			void makeDynamic(const entity::Entity& entity, scene::Scene& scene)
 			{
-				for (uint32_t index : scene.mesh_render.dynamic_renderables)
-					if (scene.mesh_render.data[index].entity == entity)
-						return;
-
+				if (eastl::find(scene.mesh_render.dynamic_renderables.begin(), scene.mesh_render.dynamic_renderables.end(), entity) != scene.mesh_render.dynamic_renderables.end())
+					return;
 
-				auto it = eastl::find(scene.mesh_render.static_renderables.begin(), scene.mesh_render.static_renderables.end(), scene.mesh_render.entity_to_data[entity]);
+				auto it = eastl::find(scene.mesh_render.static_renderables.begin(), scene.mesh_render.static_renderables.end(), entity);
 				if (it != scene.mesh_render.static_renderables.end())
 					scene.mesh_render.static_renderables.erase(it);
 
+				auto pit = eastl::find(scene.mesh_render.streaming_statics.begin(), scene.mesh_render.streaming_statics.end(), entity);
+				if (pit != scene.mesh_render.streaming_statics.end())
+					scene.mesh_render.streaming_statics.erase(pit);
+
 				scene.mesh_render.static_bvh->remove(entity);
-				scene.mesh_render.dynamic_renderables.push_back(scene.mesh_render.entity_to_data[entity]);
+				scene.mesh_render.dynamic_renderables.push_back(entity);
+			}
+
+			void updateStreamingPriorities(const utilities::Frustum& frustum, const glm::vec3& eye, float pixels_per_unit, scene::Scene& scene)
+			{
+				asset::AssetStreamer* streamer = asset::AssetStreamer::getInstance();
+				asset::TextureStreamer* texture_streamer = asset::TextureStreamer::getInstance();
+				if (!streamer->isStreaming() && texture_streamer->empty())
+					return;
+
+				// Whatever is in view goes first, closest first. The rest waits
+				// until the view is complete. Shared assets take the closest use.
+				static constexpr float kOutOfView = 1.0e6f;
+				UnorderedMap<uint64_t, float> priorities;
+				auto use = [&priorities](uint64_t hash, float priority) {
+					if (hash == 0u)
+						return;
+					auto it = priorities.insert(eastl::make_pair(hash, priority)).first;
+					if (priority < it->second)
+						it->second = priority;
+				};
+
+				for (const Data& data : scene.mesh_render.data)
+				{
+					if (!data.mesh || !data.visible)
+						continue;
+
+					glm::vec3 center;
+					float radius;
+					if (hasSubMesh(data))
+					{
+						center = data.renderable.center;
+						radius = data.renderable.radius;
+					}
+					else
+					{
+						center = glm::vec3(TransformSystem::getWorld(data.entity, scene)[3]);
+						radius = 1.0f;
+					}
+
+					const float distance = glm::length(center - eye);
+					const bool in_view = frustum.ContainsSphere(center, radius);
+					float priority = distance;
+					if (!in_view)
+						priority += kOutOfView;
+
+					// The size of the bounding sphere on screen. It is a rough
+					// guess of the texel density, but it only picks a mip.
+					if (in_view && hasSubMesh(data))
+					{
+						const float pixels = 2.0f * radius * pixels_per_unit / std::max(distance, radius);
+						texture_streamer->use(data.albedo_texture.getHash(), pixels, priority);
+						texture_streamer->use(data.normal_texture.getHash(), pixels, priority);
+						texture_streamer->use(data.dmra_texture.getHash(), pixels, priority);
+						texture_streamer->use(data.emissive_texture.getHash(), pixels, priority);
+					}
+
+					use(data.mesh.getHash(), priority);
+					use(data.albedo_texture.getHash(), priority);
+					use(data.normal_texture.getHash(), priority);
+					use(data.dmra_texture.getHash(), priority);
+					use(data.emissive_texture.getHash(), priority);
+				}
+
+				for (const auto& it : priorities)
+					streamer->setPriority(it.first, it.second);
 			}
 
 			void createRenderList(utilities::Culler& culler, const utilities::Frustum& frustum, scene::Scene& scene)
@@ -412,35 +529,28 @@ namespace lambda
 				culler.cullDynamics(*scene.mesh_render.dynamic_bvh, frustum);
 			}
 
-			void createSortedRenderList(utilities::LinkedNode* linked_node, Vector<utilities::Renderable*>& opaque, Vector<utilities::Renderable*>& alpha, scene::Scene& scene)
+			void createSortedRenderList(const utilities::CullList& list, Vector<utilities::Renderable*>& opaque, Vector<utilities::Renderable*>& alpha, scene::Scene& scene)
 			{
-				if (linked_node)
+				opaque.reserve(opaque.size() + list.count);
+				for (uint32_t i = 0u; i < list.count; ++i)
 				{
-					for (utilities::LinkedNode* node = linked_node->next; node != nullptr; node = node->next)
-					{
-						utilities::Renderable* renderable = &scene.mesh_render.get(node->entity).renderable;
-						// TODO (Hilze): Implement.
-						if (renderable->albedo_texture && renderable->albedo_texture->getLayer(0u).containsAlpha())
-							alpha.push_back(renderable);
-						else
-							opaque.push_back(renderable);
-					}
+					utilities::Renderable* renderable = &scene.mesh_render.get(list.entities[i]).renderable;
+					// TODO (Hilze): Implement.
+					if (renderable->albedo_texture && renderable->albedo_texture->getLayer(0u).containsAlpha())
+						alpha.push_back(renderable);
+					else
+						opaque.push_back(renderable);
 				}
 			}
 
-			void createSortedRenderList(utilities::LinkedNode* linked_node, Vector<utilities::Renderable>& opaque, Vector<utilities::Renderable>& alpha, scene::Scene& scene)
+			void createRenderQueue(const utilities::CullList& list, const glm::vec3& eye, platform::RenderQueue& queue, scene::Scene& scene)
 			{
-				if (linked_node)
+				for (uint32_t i = 0u; i < list.count; ++i)
 				{
-					for (utilities::LinkedNode* node = linked_node->next; node != nullptr; node = node->next)
-					{
-						utilities::Renderable& renderable = scene.mesh_render.get(node->entity).renderable;
-						// TODO (Hilze): Implement.
-						if (renderable.albedo_texture && renderable.albedo_texture->getLayer(0u).containsAlpha())
-							alpha.push_back(renderable);
-						else
-							opaque.push_back(renderable);
-					}
+					const utilities::Renderable& renderable = scene.mesh_render.get(list.entities[i]).renderable;
+					// TODO (Hilze): Implement.
+					const bool alpha = renderable.albedo_texture && renderable.albedo_texture->getLayer(0u).containsAlpha();
+					queue.add(renderable, alpha, eye);
 				}
 			}
 
@@ -461,12 +571,9 @@ namespace lambda
 			{
 				createRenderList(culler, frustum, scene);
 
-				utilities::LinkedNode statics = culler.getStatics();
-				utilities::LinkedNode dynamics = culler.getDynamics();
-
-				renderAll(&statics, &dynamics, scene, is_rh);
+				renderAll(culler.getStatics(), culler.getDynamics(), scene, is_rh);
 			}
-			void renderAll(utilities::LinkedNode* statics, utilities::LinkedNode* dynamics, scene::Scene& scene, bool is_rh)
+			void renderAll(const utilities::CullList& statics, const utilities::CullList& dynamics, scene::Scene& scene, bool is_rh)
 			{
 				Vector<utilities::Renderable*> opaque;
 				Vector<utilities::Renderable*> alpha;
@@ -476,109 +583,23 @@ namespace lambda
 			}
 			void renderAll(const Vector<utilities::Renderable*>& opaque, const Vector<utilities::Renderable*>& alpha, scene::Scene& scene, bool is_rh)
 			{
-				// -------------------------RENDER-STATIC-OPAQUE-------------------------
-				scene.renderer->setBlendState(platform::BlendState::Default());
+				// These lists were never depth sorted, so there is no eye to sort on.
+				platform::RenderQueue queue;
 				for (const utilities::Renderable* renderable : opaque)
-				{
-					scene.renderer->setMesh(renderable->mesh);
-					scene.renderer->setSubMesh(renderable->sub_mesh);
-
-					scene.renderer->setTexture(renderable->albedo_texture, 0);
-					scene.renderer->setTexture(renderable->normal_texture, 1);
-					scene.renderer->setTexture(renderable->dmra_texture, 2);
-
-					//scene.shader_variable_manager.setVariable(platform::ShaderVariable(Name("metallic_roughness"), glm::vec2(renderable->metallicness, renderable->roughness)));
-					//scene.shader_variable_manager.setVariable(platform::ShaderVariable(Name("model_matrix"), renderable->model_matrix));
-
-					auto sub_mesh = renderable->mesh->getSubMeshes().at(renderable->sub_mesh);
-					// TODO (Hilze): Implement.
-					if (sub_mesh.io.double_sided == true || (sub_mesh.io.tex_alb >= 0 && renderable->mesh->getAttachedTextures().at(sub_mesh.io.tex_alb)->getLayer(0u).containsAlpha()))
-					{
-						scene.renderer->setRasterizerState(platform::RasterizerState::SolidNone());
-					}
-					else
-					{
-						if (is_rh)
-							scene.renderer->setRasterizerState(platform::RasterizerState::SolidFront());
-						else
-							scene.renderer->setRasterizerState(platform::RasterizerState::SolidBack());
-					}
-
-					scene.renderer->draw();
-				}
-				// -------------------------RENDER-STATIC-ALPHA-------------------------
-				scene.renderer->setBlendState(platform::BlendState::Alpha());
+					queue.add(*renderable, false, glm::vec3(0.0f));
 				for (const utilities::Renderable* renderable : alpha)
-				{
-					scene.renderer->setMesh(renderable->mesh);
-					//scene.shader_variable_manager.setVariable(platform::ShaderVariable(Name("metallic_roughness"), glm::vec2(renderable->metallicness, renderable->roughness)));
-					scene.renderer->setSubMesh(renderable->sub_mesh);
-					scene.renderer->setTexture(renderable->albedo_texture, 0);
-					scene.renderer->setTexture(renderable->normal_texture, 1);
-					scene.renderer->setTexture(renderable->dmra_texture, 2);
-					//scene.shader_variable_manager.setVariable(platform::ShaderVariable(Name("model_matrix"), renderable->model_matrix));
-
-					auto sub_mesh = renderable->mesh->getSubMeshes().at(renderable->sub_mesh);
-					// TODO (Hilze): Implement.
-					if (sub_mesh.io.double_sided == true || (sub_mesh.io.tex_alb >= 0 && renderable->mesh->getAttachedTextures().at(sub_mesh.io.tex_alb)->getLayer(0u).containsAlpha()))
-						scene.renderer->setRasterizerState(platform::RasterizerState::SolidNone());
-					else
-						scene.renderer->setRasterizerState(platform::RasterizerState::SolidFront());
-
-					scene.renderer->draw();
-				}
-			}
-		}
-
-		// The system data.
-		namespace MeshRenderSystem
-		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
-
-				Data& d = data[idx];
-				d.entity            = entity;
-				d.albedo_texture    = default_albedo;
-				d.normal_texture    = default_normal;
-				d.dmra_texture      = default_dmra;
-				d.emissive_texture  = default_emissive;
-				d.renderable.entity = entity;
-
-				return d;
-			}
-
-			Data& SystemData::get(const entity::Entity& entity)
-			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "MESHRENDER: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "MESHRENDER: %llu's data was not valid", entity);
-				return data[it->second];
-			}
-
-			void SystemData::remove(const entity::Entity& entity)
-			{
-				marked_for_delete.insert(entity);
-			}
-
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
+					queue.add(*renderable, true, glm::vec3(0.0f));
+				queue.sort();
+
+				platform::RenderStats stats;
+				queue.render(
+					scene.renderer,
+					is_rh ? platform::RasterizerState::CullMode::kFront : platform::RasterizerState::CullMode::kBack,
+					platform::BlendState::Default(),
+					platform::BlendState::Alpha(),
+					stats
+				);
+				scene.render_stats.add(stats);
 			}
 		}
 
@@ -599,7 +620,6 @@ namespace lambda
 				visible = other.visible;
 				cast_shadows = other.cast_shadows;
 				entity = other.entity;
-				valid = other.valid;
 				renderable = other.renderable;
 			}
 			Data& Data::operator=(const Data& other)
@@ -616,7 +636,6 @@ namespace lambda
 				visible = other.visible;
 				cast_shadows = other.cast_shadows;
 				entity = other.entity;
-				valid = other.valid;
 				renderable = other.renderable;
 
 				return *this;
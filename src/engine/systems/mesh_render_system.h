@@ -1,10 +1,12 @@
 #pragma once
 #include "interfaces/icomponent.h"
+#include "systems/component_store.h"
 #include "assets/mesh.h"
 #include "interfaces/iwindow.h"
 #include "assets/mesh_io.h"
 #include "utils/bvh.h"
 #include "utils/renderable.h"
+#include "platform/render_queue.h"
 
 namespace lambda
 {
@@ -13,7 +15,7 @@ namespace lambda
 		class Frustum;
 		class Culler;
 		struct Renderable;
-		struct LinkedNode;
+		struct CullList;
 	}
 
 	namespace scene
@@ -78,29 +80,19 @@ namespace lambda
 				glm::vec3 emissiveness = glm::vec3(0.0f, 0.0f, 0.0f);
 				bool visible       = true;
 				bool cast_shadows  = true;
-				bool valid         = true;
 				utilities::Renderable renderable;
 
 				entity::Entity entity;
 			};
 
-			struct SystemData
+			struct SystemData : public ComponentStore<Data>
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
-
-				Vector<uint32_t>         dynamic_renderables;
-				Vector<uint32_t>         static_renderables;
-				utilities::BVH*          static_bvh;
-				utilities::TransientBVH* dynamic_bvh;
+				Vector<entity::Entity>   dynamic_renderables;
+				Vector<entity::Entity>   static_renderables;
+				// Statics that wait for their mesh to stream in.
+				Vector<entity::Entity>   streaming_statics;
+				utilities::FlatBVH*      static_bvh;
+				utilities::FlatBVH*      dynamic_bvh;
 
 				asset::VioletTextureHandle default_albedo;
 				asset::VioletTextureHandle default_normal;
@@ -117,6 +109,10 @@ namespace lambda
 			void initialize(scene::Scene& scene);
 			void deinitialize(scene::Scene& scene);
 			void updateDynamicsBvh(scene::Scene& scene);
+			// Feeds the asset streamer the distance from the eye to what uses
+			// the assets that are still streaming, and the texture streamer
+			// how many pixels the textures in view cover on screen.
+			void updateStreamingPriorities(const utilities::Frustum& frustum, const glm::vec3& eye, float pixels_per_unit, scene::Scene& scene);
 
 			void setMesh(const entity::Entity& entity, asset::VioletMeshHandle mesh, scene::Scene& scene);
 			void setSubMesh(const entity::Entity& entity, const uint32_t& sub_mesh, scene::Scene& scene);
@@ -145,10 +141,10 @@ namespace lambda
 			void makeDynamic(const entity::Entity& entity, scene::Scene& scene);
 
 			void createRenderList(utilities::Culler& culler, const utilities::Frustum& frustum, scene::Scene& scene);
-			void createSortedRenderList(utilities::LinkedNode* linked_node, Vector<utilities::Renderable*>& opaque, Vector<utilities::Renderable*>& alpha, scene::Scene& scene);
-			void createSortedRenderList(utilities::LinkedNode* linked_node, Vector<utilities::Renderable>& opaque, Vector<utilities::Renderable>& alpha, scene::Scene& scene);
+			void createSortedRenderList(const utilities::CullList& list, Vector<utilities::Renderable*>& opaque, Vector<utilities::Renderable*>& alpha, scene::Scene& scene);
+			void createRenderQueue(const utilities::CullList& list, const glm::vec3& eye, platform::RenderQueue& queue, scene::Scene& scene);
 			void renderAll(utilities::Culler& culler, const utilities::Frustum& frustum, scene::Scene& scene, bool is_rh = true);
-			void renderAll(utilities::LinkedNode* statics, utilities::LinkedNode* dynamics, scene::Scene& scene, bool is_rh = true);
+			void renderAll(const utilities::CullList& statics, const utilities::CullList& dynamics, scene::Scene& scene, bool is_rh = true);
 			void renderAll(const Vector<utilities::Renderable*>& opaque, const Vector<utilities::Renderable*>& alpha, scene::Scene& scene, bool is_rh = true);
 		}
 	}
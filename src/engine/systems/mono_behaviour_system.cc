@@ -33,6 +33,12 @@ namespace lambda
 				{
 					for (entity::Entity entity : scene.mono_behaviour.marked_for_delete)
 					{
+						if (!scene.mono_behaviour.has(entity))
+						{
+							Warning("Could not find id: " + toString(entity));
+							continue;
+						}
+
 						{
 							Data& data = scene.mono_behaviour.get(entity);
 #define FREE(x) if (x) scene.scripting->freeHandle(x), x = nullptr
@@ -48,26 +54,14 @@ namespace lambda
 #undef FREE
 						}
 
-						const auto& it = scene.mono_behaviour.entity_to_data.find(entity);
-						if (it != scene.mono_behaviour.entity_to_data.end())
-						{
-							uint32_t idx = it->second;
-							scene.mono_behaviour.unused_data_entries.push(idx);
-							scene.mono_behaviour.data_to_entity.erase(idx);
-							scene.mono_behaviour.entity_to_data.erase(entity);
-							scene.mono_behaviour.data[idx].valid = false;
-						}
-						else
-							Warning("Could not find id: " + toString(entity));
+						scene.mono_behaviour.erase(entity);
 					}
 					scene.mono_behaviour.marked_for_delete.clear();
 				}
 			}
 			void deinitialize(scene::Scene& scene)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : scene.mono_behaviour.entity_to_data)
-					entities.push_back(it.first);
+				Vector<entity::Entity> entities = scene.mono_behaviour.entities;
 
 				for (const auto& entity : entities)
 					removeComponent(entity, scene);
@@ -78,7 +72,7 @@ namespace lambda
 				for (uint32_t i = 0u; i < scene.mono_behaviour.data.size(); ++i)
 				{
 					const auto& data = scene.mono_behaviour.data[i];
-					if (data.valid && data.object && data.update)
+					if (data.object && data.update)
 						scene.scripting->executeFunction(data.object, data.update, {});
 				}
 			}
@@ -87,7 +81,7 @@ namespace lambda
 				for (uint32_t i = 0u; i < scene.mono_behaviour.data.size(); ++i)
 				{
 					const auto& data = scene.mono_behaviour.data[i];
-					if (data.valid && data.object && data.fixed_update)
+					if (data.object && data.fixed_update)
 						scene.scripting->executeFunction(data.object, data.fixed_update, {});
 				}
 			}
@@ -209,50 +203,6 @@ namespace lambda
 			}
 		}
 
-		// The system data.
-		namespace MonoBehaviourSystem
-		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
-
-				return data[idx];
-			}
-
-			Data& SystemData::get(const entity::Entity& entity)
-			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "MONOBEHAVIOUR: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "MONOBEHAVIOUR: %llu's data was not valid", entity);
-				return data[it->second];
-			}
-
-			void SystemData::remove(const entity::Entity& entity)
-			{
-				marked_for_delete.insert(entity);
-			}
-
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
-			}
-		}
-
 		namespace MonoBehaviourSystem
 		{
 			Data::Data(const Data & other)
@@ -267,7 +217,6 @@ namespace lambda
 				on_trigger_enter = other.on_trigger_enter;
 				on_trigger_exit = other.on_trigger_exit;
 				entity = other.entity;
-				valid = other.valid;
 			}
 			Data & Data::operator=(const Data & other)
 			{
@@ -281,7 +230,6 @@ namespace lambda
 				on_trigger_enter = other.on_trigger_enter;
 				on_trigger_exit = other.on_trigger_exit;
 				entity = other.entity;
-				valid = other.valid;
 
 				return *this;
 			}
@@ -1,6 +1,7 @@
 #pragma once
 #include "interfaces/isystem.h"
 #include "interfaces/icomponent.h"
+#include "systems/component_store.h"
 #include <containers/containers.h>
 #include <memory/memory.h>
 #include <glm/glm.hpp>
@@ -47,23 +48,12 @@ namespace lambda
 
 				void* on_trigger_enter = nullptr;
 				void* on_trigger_exit = nullptr;
-				bool valid = true;
 
 				entity::Entity entity;
 			};
 
-			struct SystemData
+			struct SystemData : public ComponentStore<Data>
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
 			};
 
 			MonoBehaviourComponent addComponent(const entity::Entity& entity, scene::Scene& scene);
@@ -36,30 +36,13 @@ namespace lambda
 			/////////////////////////////////////////////////////////////////////////////
 			void collectGarbage(scene::Scene& scene)
 			{
-				if (!scene.name.marked_for_delete.empty())
-				{
-					for (entity::Entity entity : scene.name.marked_for_delete)
-					{
-						const auto& it = scene.name.entity_to_data.find(entity);
-						if (it != scene.name.entity_to_data.end())
-						{
-							uint32_t idx = it->second;
-							scene.name.unused_data_entries.push(idx);
-							scene.name.data_to_entity.erase(idx);
-							scene.name.entity_to_data.erase(entity);
-							scene.name.data[idx].valid = false;
-						}
-					}
-					scene.name.marked_for_delete.clear();
-				}
+				scene.name.collectGarbage();
 			}
 
 			/////////////////////////////////////////////////////////////////////////////
 			void deinitialize(scene::Scene& scene)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : scene.name.entity_to_data)
-					entities.push_back(it.first);
+				Vector<entity::Entity> entities = scene.name.entities;
 
 				for (const auto& entity : entities)
 					scene.name.remove(entity);
@@ -91,50 +74,6 @@ namespace lambda
 			}
 		}
 
-		// The system data.
-		namespace NameSystem
-		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
-
-				return data[idx];
-			}
-
-			Data& SystemData::get(const entity::Entity& entity)
-			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "NAME: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "NAME: %llu's data was not valid", entity);
-				return data[it->second];
-			}
-
-			void SystemData::remove(const entity::Entity& entity)
-			{
-				marked_for_delete.insert(entity);
-			}
-
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
-			}
-		}
-
 		// The name data.
 		namespace NameSystem
 		{
@@ -144,7 +83,6 @@ namespace lambda
 				name = other.name;
 				tags = other.tags;
 				entity = other.entity;
-				valid = other.valid;
 			}
 
 			/////////////////////////////////////////////////////////////////////////////
@@ -153,7 +91,6 @@ namespace lambda
 				name = other.name;
 				tags = other.tags;
 				entity = other.entity;
-				valid = other.valid;
 
 				return *this;
 			}
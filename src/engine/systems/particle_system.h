@@ -1,5 +1,6 @@
 #pragma once
 #include <interfaces/icomponent.h>
+#include <systems/component_store.h>
 #include <systems/entity.h>
 #include <platform/scene.h>
 
@@ -23,24 +24,13 @@ namespace lambda
 				Vector<glm::vec3> positions;
 
 				entity::Entity entity;
-				bool valid = true;
 
 			private:
 				entity::Entity parent = entity::InvalidEntity;
 			};
 
-			struct SystemData
+			struct SystemData : public ComponentStore<Data>
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
 			};
 
 			ParticleComponent addComponent(const entity::Entity& entity, scene::Scene& scene);
@@ -0,0 +1,344 @@
+#include "replication_system.h"
+#include <systems/transform_system.h>
+#include <platform/scene.h>
+#include <server.h>
+#include <client.h>
+#include <networking.h>
+#include <memory/memory.h>
+#include <cmath>
+
+namespace lambda
+{
+	namespace components
+	{
+		namespace ReplicationSystem
+		{
+			/////////////////////////////////////////////////////////////////////////////
+			static void sendSnapshot(scene::Scene& scene)
+			{
+				SystemData& replication = scene.replication;
+				networking::Snapshot& snapshot = replication.snapshot;
+				snapshot.clear();
+				snapshot.time = (float)replication.server_time;
+				snapshot.field_bits.resize(replication.fields.size());
+				for (size_t i = 0u; i < replication.fields.size(); ++i)
+					snapshot.field_bits[i] = replication.fields[i].bits;
+				replication.values.resize(replication.fields.size());
+
+				for (uint32_t i = 0u; i < replication.size(); ++i)
+				{
+					const entity::Entity entity = replication.entities[i];
+					if (!TransformSystem::hasComponent(entity, scene))
+						continue;
+
+					for (size_t f = 0u; f < replication.fields.size(); ++f)
+						replication.values[f] = replication.fields[f].get(entity, scene);
+
+					snapshot.add(
+						replication.data[i].network_id,
+						TransformSystem::getWorldTranslation(entity, scene),
+						TransformSystem::getWorldRotation(entity, scene),
+						replication.values.data(),
+						replication.data[i].priority
+					);
+				}
+
+				snapshot.sort();
+				replication.server->sendSnapshot(snapshot);
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			static void applySnapshot(scene::Scene& scene)
+			{
+				SystemData& replication = scene.replication;
+				replication.observers.clear();
+				if (replication.interest_radius > 0.0f && TransformSystem::hasComponent(scene.camera.main_camera, scene))
+					replication.observers.push_back({ TransformSystem::getWorldTranslation(scene.camera.main_camera, scene), replication.interest_radius });
+				replication.client->setObservers(replication.observers);
+
+				networking::InterpolatedSnapshot& interpolated = replication.interpolated;
+				if (!replication.client->getSnapshots().sample(interpolated))
+					return;
+
+				const size_t field_count = eastl::min(interpolated.field_count, replication.fields.size());
+				for (size_t i = 0u; i < interpolated.size(); ++i)
+				{
+					const uint32_t network_id = interpolated.ids[i];
+					auto it = replication.remote_entities.find(network_id);
+					entity::Entity entity;
+					if (it == replication.remote_entities.end())
+					{
+						entity = scene.entity.create();
+						TransformSystem::addComponent(entity, scene);
+						replication.add(entity).network_id = network_id;
+						replication.remote_entities.insert(eastl::make_pair(network_id, entity));
+					}
+					else
+						entity = it->second;
+
+					TransformSystem::setWorldTranslation(entity, interpolated.positions[i], scene);
+					TransformSystem::setWorldRotation(entity, interpolated.rotations[i], scene);
+					for (size_t f = 0u; f < field_count; ++f)
+					{
+						if (replication.fields[f].set)
+							replication.fields[f].set(entity, interpolated.fields[i * interpolated.field_count + f], scene);
+					}
+				}
+
+				// The ids are sorted, so the ones that are gone can be searched for.
+				for (auto it = replication.remote_entities.begin(); it != replication.remote_entities.end();)
+				{
+					if (eastl::binary_search(interpolated.ids.begin(), interpolated.ids.end(), it->first))
+					{
+						++it;
+						continue;
+					}
+
+					TransformSystem::removeComponent(it->second, scene);
+					replication.remove(it->second);
+					scene.entity.destroy(it->second);
+					it = replication.remote_entities.erase(it);
+				}
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			ReplicatedComponent addComponent(const entity::Entity& entity, scene::Scene& scene)
+			{
+				if (!TransformSystem::hasComponent(entity, scene))
+					TransformSystem::addComponent(entity, scene);
+
+				scene.replication.add(entity).network_id = scene.replication.next_network_id++;
+				return ReplicatedComponent(entity, scene);
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			ReplicatedComponent getComponent(const entity::Entity& entity, scene::Scene& scene)
+			{
+				return ReplicatedComponent(entity, scene);
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			bool hasComponent(const entity::Entity& entity, scene::Scene& scene)
+			{
+				return scene.replication.has(entity);
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void removeComponent(const entity::Entity& entity, scene::Scene& scene)
+			{
+				scene.replication.remove(entity);
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void collectGarbage(scene::Scene& scene)
+			{
+				scene.replication.collectGarbage();
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void deinitialize(scene::Scene& scene)
+			{
+				stop(scene);
+				Vector<entity::Entity> entities = scene.replication.entities;
+
+				for (const auto& entity : entities)
+					scene.replication.remove(entity);
+				collectGarbage(scene);
+				scene.replication.remote_entities.clear();
+				scene.replication.server = nullptr;
+				scene.replication.client = nullptr;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void update(const float& delta_time, scene::Scene& scene)
+			{
+				SystemData& replication = scene.replication;
+				if (replication.owns_connection)
+				{
+					if (replication.server != nullptr)
+						replication.server->update(delta_time);
+					if (replication.client != nullptr)
+						replication.client->update(delta_time);
+				}
+
+				if (replication.client != nullptr)
+					applySnapshot(scene);
+
+				if (replication.server == nullptr)
+					return;
+
+				// Snapshots go out at a fixed rate. After a long frame the ticks
+				// that were missed are skipped rather than sent all at once.
+				const float tick = 1.0f / replication.tick_rate;
+				replication.time += delta_time;
+				if (replication.time < tick)
+					return;
+
+				replication.time = fmodf(replication.time, tick);
+				replication.server_time += tick;
+				sendSnapshot(scene);
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void setServer(networking::Server* server, scene::Scene& scene)
+			{
+				scene.replication.server = server;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void setClient(networking::Client* client, scene::Scene& scene)
+			{
+				scene.replication.client = client;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void host(uint16_t port, uint32_t max_clients, scene::Scene& scene)
+			{
+				stop(scene);
+				networking::initializeNetworking();
+				networking::Server* server = foundation::Memory::construct<networking::Server>();
+				server->initialize(port, 0u, max_clients);
+				scene.replication.server = server;
+				scene.replication.owns_connection = true;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void connect(const String& name, uint16_t port, scene::Scene& scene)
+			{
+				stop(scene);
+				networking::initializeNetworking();
+				networking::Client* client = foundation::Memory::construct<networking::Client>();
+				client->initialize(name, port);
+				scene.replication.client = client;
+				scene.replication.owns_connection = true;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void stop(scene::Scene& scene)
+			{
+				SystemData& replication = scene.replication;
+				if (!replication.owns_connection)
+					return;
+
+				if (replication.server != nullptr)
+				{
+					replication.server->deinitialize();
+					foundation::Memory::destruct(replication.server);
+				}
+				if (replication.client != nullptr)
+				{
+					replication.client->deinitialize();
+					foundation::Memory::destruct(replication.client);
+				}
+				networking::deinitializeNetworking();
+				replication.server = nullptr;
+				replication.client = nullptr;
+				replication.owns_connection = false;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			bool isServer(scene::Scene& scene)
+			{
+				return scene.replication.server != nullptr;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			bool isClient(scene::Scene& scene)
+			{
+				return scene.replication.client != nullptr;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void registerField(const Field& field, scene::Scene& scene)
+			{
+				LMB_ASSERT(field.bits > 0u && field.bits <= networking::kMaxFieldBits, "REPLICATION: A field can not be %u bits", field.bits);
+				scene.replication.fields.push_back(field);
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			uint32_t getNetworkId(const entity::Entity& entity, scene::Scene& scene)
+			{
+				return scene.replication.get(entity).network_id;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void setPriority(const entity::Entity& entity, float priority, scene::Scene& scene)
+			{
+				scene.replication.get(entity).priority = priority;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			float getPriority(const entity::Entity& entity, scene::Scene& scene)
+			{
+				return scene.replication.get(entity).priority;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			void setInterestRadius(float radius, scene::Scene& scene)
+			{
+				scene.replication.interest_radius = radius;
+			}
+		}
+
+		// The replication data.
+		namespace ReplicationSystem
+		{
+			/////////////////////////////////////////////////////////////////////////////
+			Data::Data(const Data& other)
+			{
+				network_id = other.network_id;
+				priority   = other.priority;
+				entity     = other.entity;
+			}
+
+			/////////////////////////////////////////////////////////////////////////////
+			Data& Data::operator=(const Data& other)
+			{
+				network_id = other.network_id;
+				priority   = other.priority;
+				entity     = other.entity;
+
+				return *this;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		ReplicatedComponent::ReplicatedComponent(const entity::Entity& entity, scene::Scene& scene)
+			: IComponent(entity)
+			, scene_(&scene)
+		{
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		ReplicatedComponent::ReplicatedComponent(const ReplicatedComponent& other)
+			: IComponent(other.entity_)
+			, scene_(other.scene_)
+		{
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		ReplicatedComponent::ReplicatedComponent()
+			: IComponent(entity::Entity())
+			, scene_(nullptr)
+		{
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		uint32_t ReplicatedComponent::getNetworkId() const
+		{
+			return ReplicationSystem::getNetworkId(entity_, *scene_);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		void ReplicatedComponent::setPriority(float priority)
+		{
+			ReplicationSystem::setPriority(entity_, priority, *scene_);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		float ReplicatedComponent::getPriority() const
+		{
+			return ReplicationSystem::getPriority(entity_, *scene_);
+		}
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include "interfaces/icomponent.h"
+#include "systems/component_store.h"
+#include "interfaces/isystem.h"
+#include <snapshot.h>
+#include <interest.h>
+
+namespace lambda
+{
+	namespace networking
+	{
+		class Server;
+		class Client;
+	}
+
+	namespace scene
+	{
+		struct Scene;
+	}
+
+	namespace components
+	{
+		class ReplicatedComponent : public IComponent
+		{
+		public:
+			ReplicatedComponent(const entity::Entity& entity, scene::Scene& scene);
+			ReplicatedComponent(const ReplicatedComponent& other);
+			ReplicatedComponent();
+
+			uint32_t getNetworkId() const;
+			void setPriority(float priority);
+			float getPriority() const;
+
+		private:
+			scene::Scene* scene_;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// Sends the world transform of every replicated entity from the server
+		// to the clients as delta compressed snapshots, at tick_rate snapshots
+		// per second. Clients create an entity for every network id they get
+		// and move it between the two snapshots around their playback time.
+		// Entities the server stops replicating are destroyed on the clients.
+		// With an interest radius, clients only get the entities near their
+		// main camera, and entities with a higher priority are updated more
+		// often when the server limits the bytes per client.
+		namespace ReplicationSystem
+		{
+			// Extra state per entity, like an animation or a health value, in
+			// the low bits of a uint32_t. Servers and clients have to register
+			// the same fields in the same order.
+			struct Field
+			{
+				uint8_t bits;
+				Function<uint32_t(const entity::Entity&, scene::Scene&)> get;
+				Function<void(const entity::Entity&, uint32_t, scene::Scene&)> set;
+			};
+
+			struct Data
+			{
+				Data() {};
+				Data(const entity::Entity& entity) : entity(entity) {};
+				Data(const Data& other);
+				Data& operator=(const Data& other);
+
+				uint32_t network_id = 0u;
+				float priority = 1.0f;
+				entity::Entity entity;
+			};
+
+			struct SystemData : public ComponentStore<Data>
+			{
+				networking::Server* server = nullptr;
+				networking::Client* client = nullptr;
+				// Made by host or connect, so the system updates and stops it.
+				bool owns_connection = false;
+				float tick_rate   = 30.0f;
+				float time        = 0.0f;
+				double server_time = 0.0;
+				uint32_t next_network_id = 1u;
+				// 0 gets every entity.
+				float interest_radius = 0.0f;
+				Vector<Field> fields;
+				// The entities the client made for the network ids it got.
+				UnorderedMap<uint32_t, entity::Entity> remote_entities;
+
+				// Reused every tick.
+				networking::Snapshot snapshot;
+				networking::InterpolatedSnapshot interpolated;
+				Vector<uint32_t> values;
+				Vector<networking::Observer> observers;
+			};
+
+			ReplicatedComponent addComponent(const entity::Entity& entity, scene::Scene& scene);
+			ReplicatedComponent getComponent(const entity::Entity& entity, scene::Scene& scene);
+			bool hasComponent(const entity::Entity& entity, scene::Scene& scene);
+			void removeComponent(const entity::Entity& entity, scene::Scene& scene);
+
+			void collectGarbage(scene::Scene& scene);
+			void deinitialize(scene::Scene& scene);
+			void update(const float& delta_time, scene::Scene& scene);
+
+			// A scene replicates to the clients of a server, or from the server
+			// of a client. The scene does not own either.
+			void setServer(networking::Server* server, scene::Scene& scene);
+			void setClient(networking::Client* client, scene::Scene& scene);
+			// Starts a server or a client that the scene owns, and updates and
+			// stops with it. This is what scripts use.
+			void host(uint16_t port, uint32_t max_clients, scene::Scene& scene);
+			void connect(const String& name, uint16_t port, scene::Scene& scene);
+			// Stops what host or connect started.
+			void stop(scene::Scene& scene);
+			bool isServer(scene::Scene& scene);
+			bool isClient(scene::Scene& scene);
+			void registerField(const Field& field, scene::Scene& scene);
+			uint32_t getNetworkId(const entity::Entity& entity, scene::Scene& scene);
+			void setPriority(const entity::Entity& entity, float priority, scene::Scene& scene);
+			float getPriority(const entity::Entity& entity, scene::Scene& scene);
+			void setInterestRadius(float radius, scene::Scene& scene);
+		}
+	}
+}
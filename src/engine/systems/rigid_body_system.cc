@@ -52,16 +52,10 @@ namespace lambda
 			  {
 				  for (entity::Entity entity : scene.rigid_body.marked_for_delete)
 				  {
-					  const auto& it = scene.rigid_body.entity_to_data.find(entity);
-					  if (it != scene.rigid_body.entity_to_data.end())
+					  if (scene.rigid_body.has(entity))
 					  {
-						  auto& data = scene.rigid_body.data.at(it->second);
 							scene.rigid_body.physics_world->getCollisionBody(entity).makeRigidBody();
-						  uint32_t idx = it->second;
-						  scene.rigid_body.unused_data_entries.push(idx);
-						  scene.rigid_body.data_to_entity.erase(idx);
-						  scene.rigid_body.entity_to_data.erase(entity);
-						  scene.rigid_body.data[idx].valid = false;
+						  scene.rigid_body.erase(entity);
 					  }
 				  }
 				  scene.rigid_body.marked_for_delete.clear();
@@ -82,9 +76,7 @@ namespace lambda
 
 		  void deinitialize(scene::Scene & scene)
 		  {
-			  Vector<entity::Entity> entities;
-			  for (const auto& it : scene.rigid_body.entity_to_data)
-				  entities.push_back(it.first);
+			  Vector<entity::Entity> entities = scene.rigid_body.entities;
 
 			  for (const auto& entity : entities)
 				  removeComponent(entity, scene);
@@ -166,65 +158,15 @@ namespace lambda
 
 
 
-	  // The system data.
-	  namespace RigidBodySystem
-	  {
-		  Data& SystemData::add(const entity::Entity& entity)
-		  {
-			  uint32_t idx = 0ul;
-			  if (!unused_data_entries.empty())
-			  {
-				  idx = unused_data_entries.front();
-				  unused_data_entries.pop();
-				  data[idx] = Data(entity);
-			  }
-			  else
-			  {
-				  idx = (uint32_t)data.size();
-				  data.push_back(Data(entity));
-				  data_to_entity[idx] = entity;
-			  }
-
-			  data_to_entity[idx] = entity;
-			  entity_to_data[entity] = idx;
-
-			  return data[idx];
-		  }
-
-		  Data& SystemData::get(const entity::Entity& entity)
-		  {
-			  auto it = entity_to_data.find(entity);
-			  LMB_ASSERT(it != entity_to_data.end(), "RIGIDBODY: %llu does not have a component", entity);
-			  LMB_ASSERT(data[it->second].valid, "RIGIDBODY: %llu's data was not valid", entity);
-			  return data[it->second];
-		  }
-
-		  void SystemData::remove(const entity::Entity& entity)
-		  {
-			  marked_for_delete.insert(entity);
-		  }
-
-		  bool SystemData::has(const entity::Entity& entity)
-		  {
-			  return entity_to_data.find(entity) != entity_to_data.end();
-		  }
-	  }
-
-
-
-
-
 	namespace RigidBodySystem
 	{
 		Data::Data(const Data& other)
 		{
 			entity = other.entity;
-			valid = other.valid;
 		}
 		Data& Data::operator=(const Data& other)
 		{
 			entity = other.entity;
-			valid = other.valid;
 			return *this;
 		}
 	}
@@ -2,6 +2,7 @@
 #include "interfaces/isystem.h"
 #include "interfaces/iphysics.h"
 #include "interfaces/icomponent.h"
+#include "systems/component_store.h"
 
 #include <containers/containers.h>
 #include <memory/memory.h>
@@ -59,23 +60,11 @@ namespace lambda
 				Data(const Data& other);
 				Data& operator=(const Data& other);
 
-				bool valid = true;
 				entity::Entity entity;
 			};
 
-			struct SystemData
+			struct SystemData : public ComponentStore<Data>
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
-
 				physics::IPhysicsWorld* physics_world;
 			};
 
@@ -2,6 +2,14 @@
 #include "utils/decompose_matrix.h"
 #include <utils/console.h>
 #include <platform/scene.h>
+#include "utils/mt_manager.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define VIOLET_TRANSFORM_SSE 1
+#else
+#define VIOLET_TRANSFORM_SSE 0
+#endif
 
 namespace lambda
 {
@@ -72,43 +80,143 @@ namespace lambda
 				return quaternion;
 			}
 
-			void cleanIfDirty(Data& data, scene::Scene& scene)
+
+			// out = a * b for column major matrices.
+			static inline void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
 			{
-				if (data.dirty)
+#if VIOLET_TRANSFORM_SSE
+				const float* pa = &a[0][0];
+				const float* pb = &b[0][0];
+				float* po = &out[0][0];
+
+				const __m128 a0 = _mm_loadu_ps(pa + 0);
+				const __m128 a1 = _mm_loadu_ps(pa + 4);
+				const __m128 a2 = _mm_loadu_ps(pa + 8);
+				const __m128 a3 = _mm_loadu_ps(pa + 12);
+
+				for (uint32_t c = 0u; c < 4u; ++c)
 				{
-					data.dirty = false;
+					__m128 r = _mm_mul_ps(a0, _mm_set1_ps(pb[c * 4u + 0u]));
+					r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(pb[c * 4u + 1u])));
+					r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(pb[c * 4u + 2u])));
+					r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(pb[c * 4u + 3u])));
+					_mm_storeu_ps(po + c * 4u, r);
+				}
+#else
+				out = a * b;
+#endif
+			}
+
+			// translate(t) * mat4_cast(r) * scale(s) without the full multiplications.
+			static inline void composeLocal(SystemData& transform, uint32_t idx)
+			{
+				const glm::mat3 rotation = glm::mat3_cast(transform.rotations[idx]);
+				const glm::vec3& scale   = transform.scales[idx];
+				glm::mat4& local = transform.locals[idx];
 
-					// Local.
-					data.local = glm::translate(glm::mat4(1.0f), data.translation);
-					data.local *= glm::mat4_cast(data.rotation);
-					data.local = glm::scale(data.local, data.scale);
+				local[0] = glm::vec4(rotation[0] * scale.x, 0.0f);
+				local[1] = glm::vec4(rotation[1] * scale.y, 0.0f);
+				local[2] = glm::vec4(rotation[2] * scale.z, 0.0f);
+				local[3] = glm::vec4(transform.translations[idx], 1.0f);
+			}
 
-					// World.
-					if (data.getParent() == kRoot || data.getParent() == data.entity)
-					{
-						data.world = data.local;
-					}
-					else
-					{
-						data.world = getWorld(data.getParent(), scene) * data.local;
-					}
+			// Rebuilds a transform if it or its parent changed. The parent has to be clean.
+			static inline void cleanSlot(SystemData& transform, uint32_t idx, uint32_t parent_idx)
+			{
+				const bool local_dirty = transform.dirty[idx] != 0u;
+				if (!local_dirty && (parent_idx == SystemData::kInvalidSlot || transform.parent_versions[idx] == transform.world_versions[parent_idx]))
+					return;
+
+				if (local_dirty)
+				{
+					composeLocal(transform, idx);
+					transform.dirty[idx] = 0u;
+				}
+
+				if (parent_idx == SystemData::kInvalidSlot)
+				{
+					transform.worlds[idx] = transform.locals[idx];
+					transform.parent_versions[idx] = 0u;
 				}
+				else
+				{
+					multiply(transform.worlds[parent_idx], transform.locals[idx], transform.worlds[idx]);
+					transform.parent_versions[idx] = transform.world_versions[parent_idx];
+				}
+				transform.world_versions[idx]++;
+			}
+
+			static uint32_t parentSlot(const SystemData& transform, uint32_t idx)
+			{
+				const entity::Entity parent = transform.parents[idx];
+				if (parent == kRoot || parent == transform.entities[idx])
+					return SystemData::kInvalidSlot;
+				return transform.slot(parent);
+			}
+
+			// Lazy path for getters that are used between two updates.
+			static void cleanIfDirty(SystemData& transform, uint32_t idx)
+			{
+				const uint32_t parent_idx = parentSlot(transform, idx);
+				if (parent_idx != SystemData::kInvalidSlot)
+					cleanIfDirty(transform, parent_idx);
+				cleanSlot(transform, idx, parent_idx);
 			}
 
-			void makeDirtyRecursive(Data& data, scene::Scene& scene)
+			static uint32_t getSlot(const entity::Entity& entity, scene::Scene& scene)
 			{
-				data.dirty = true;
-				for (const entity::Entity& child : data.children)
+				const uint32_t idx = scene.transform.slot(entity);
+				LMB_ASSERT(idx != SystemData::kInvalidSlot, "TRANSFORM: %u does not have a component", entity);
+				return idx;
+			}
+
+			static void unlinkChild(SystemData& transform, const entity::Entity& parent, const entity::Entity& child)
+			{
+				const uint32_t parent_idx = transform.slot(parent);
+				if (parent_idx == SystemData::kInvalidSlot)
+					return;
+
+				const uint32_t child_idx = transform.slot(child);
+				entity::Entity* link = &transform.first_children[parent_idx];
+				while (*link != entity::InvalidEntity)
 				{
-					makeDirtyRecursive(scene.transform.get(child), scene);
+					if (*link == child)
+					{
+						*link = transform.next_siblings[child_idx];
+						transform.next_siblings[child_idx] = entity::InvalidEntity;
+						return;
+					}
+					link = &transform.next_siblings[transform.slot(*link)];
 				}
 			}
 
+			struct LevelJob
+			{
+				SystemData* transform;
+				uint32_t    offset;
+			};
+
+			static void updateLevelRange(uint32_t begin, uint32_t end, void* user_data)
+			{
+				const LevelJob& job = *(const LevelJob*)user_data;
+				SystemData& transform = *job.transform;
+				for (uint32_t i = job.offset + begin; i < job.offset + end; ++i)
+					cleanSlot(transform, i, transform.parent_slots[i]);
+			}
+
 			bool isChildOf(const entity::Entity& parent, const entity::Entity& child, scene::Scene& scene)
 			{
-				for (const entity::Entity& ch : scene.transform.get(parent).children)
-					if (ch == child || isChildOf(ch, child, scene))
+				// Walk up from the child. The hierarchy is shallow compared to its width.
+				uint32_t idx = scene.transform.slot(child);
+				while (idx != SystemData::kInvalidSlot)
+				{
+					const uint32_t parent_idx = parentSlot(scene.transform, idx);
+					if (parent_idx == SystemData::kInvalidSlot)
+						return false;
+					if (scene.transform.entities[parent_idx] == parent)
 						return true;
+					idx = parent_idx;
+				}
 
 				return false;
 			}
@@ -140,47 +248,59 @@ namespace lambda
 
 			void collectGarbage(scene::Scene & scene)
 			{
-				if (!scene.transform.marked_for_delete.empty())
-				{
-					for (entity::Entity entity : scene.transform.marked_for_delete)
-					{
-						const auto& it = scene.transform.entity_to_data.find(entity);
-						if (it != scene.transform.entity_to_data.end())
-						{
-							uint32_t idx = it->second;
-							scene.transform.unused_data_entries.push(idx);
-							scene.transform.data_to_entity.erase(idx);
-							scene.transform.entity_to_data.erase(entity);
-							scene.transform.data[idx].valid = false;
-						}
-					}
-					scene.transform.marked_for_delete.clear();
-				}
+				scene.transform.collectGarbage();
 			}
 
 			void deinitialize(scene::Scene & scene)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : scene.transform.entity_to_data)
-					entities.push_back(it.first);
+				Vector<entity::Entity> entities = scene.transform.entities;
 
 				for (const auto& entity : entities)
 					scene.transform.remove(entity);
 				collectGarbage(scene);
 			}
-			
+
+			void update(scene::Scene& scene)
+			{
+				static constexpr uint32_t kParallelLevelSize = 4096u;
+				static constexpr uint32_t kGrainSize         = 1024u;
+
+				SystemData& transform = scene.transform;
+				if (!transform.sorted)
+					transform.sort();
+
+				// Parents are always on an earlier level, so every level only reads
+				// matrices that were finished before it started.
+				for (uint32_t level = 0u; level + 1u < transform.level_offsets.size(); ++level)
+				{
+					const uint32_t begin = transform.level_offsets[level];
+					const uint32_t count = transform.level_offsets[level + 1u] - begin;
+
+					LevelJob job = { &transform, begin };
+					if (count >= kParallelLevelSize)
+					{
+						platform::TaskScheduler::Counter counter;
+						platform::TaskScheduler::parallelFor(count, kGrainSize, updateLevelRange, &job, &counter);
+						platform::TaskScheduler::waitForCounter(&counter);
+					}
+					else
+						updateLevelRange(0u, count, &job);
+				}
+			}
+
 			glm::mat4 getLocal(const entity::Entity& entity, scene::Scene& scene)
 			{
-				Data& data = scene.transform.get(entity);
-				cleanIfDirty(data, scene);
-				return data.local;
+				const uint32_t idx = getSlot(entity, scene);
+				if (scene.transform.dirty[idx])
+					cleanIfDirty(scene.transform, idx);
+				return scene.transform.locals[idx];
 			}
 
 			glm::mat4 getWorld(const entity::Entity& entity, scene::Scene& scene)
 			{
-				Data& data = scene.transform.get(entity);
-				cleanIfDirty(data, scene);
-				return data.world;
+				const uint32_t idx = getSlot(entity, scene);
+				cleanIfDirty(scene.transform, idx);
+				return scene.transform.worlds[idx];
 			}
 
 			glm::mat4 getInvWorld(const entity::Entity& entity, scene::Scene& scene)
@@ -190,13 +310,13 @@ namespace lambda
 
 			bool hasParent(const entity::Entity& entity, scene::Scene& scene)
 			{
-				const Data& data = scene.transform.get(entity);
-				return data.getParent() != 0u && data.getParent() != entity;
+				const entity::Entity parent = scene.transform.parents[getSlot(entity, scene)];
+				return parent != 0u && parent != entity;
 			}
 
 			entity::Entity getParent(const entity::Entity& entity, scene::Scene& scene)
 			{
-				return scene.transform.get(entity).getParent();
+				return scene.transform.parents[getSlot(entity, scene)];
 			}
 
 			void setParent(const entity::Entity& entity, const entity::Entity& parent, scene::Scene& scene)
@@ -206,27 +326,28 @@ namespace lambda
 				if (entity == parent || isChildOf(entity, parent, scene))
 					return;
 
+				SystemData& transform = scene.transform;
+
 				// You cannot parent yourself to something else recursively.
-				if (parent != kRoot && entity == scene.transform.get(parent).getParent())
+				if (parent != kRoot && entity == transform.parents[getSlot(parent, scene)])
 					return;
 
-				Data& data = scene.transform.get(entity);
-				//entity::Entity was  = data.getParent();
-				if (data.getParent() != kRoot)
-				{
-					Data& p_data = scene.transform.get(data.getParent());
-					eastl::remove(p_data.children.begin(), p_data.children.end(), entity);
-				}
+				const uint32_t idx = getSlot(entity, scene);
+				if (transform.parents[idx] == parent)
+					return;
 
-				data.setParent(parent);
+				if (transform.parents[idx] != kRoot)
+					unlinkChild(transform, transform.parents[idx], entity);
 
-				makeDirtyRecursive(data, scene);
+				transform.parents[idx] = parent;
+				transform.dirty[idx]   = 1u;
+				transform.sorted       = false;
 
 				if (parent != kRoot)
 				{
-					auto& parent_data = scene.transform.get(parent);
-					if (eastl::find(parent_data.children.begin(), parent_data.children.end(), entity) == parent_data.children.end())
-						parent_data.children.push_back(entity);
+					const uint32_t parent_idx = getSlot(parent, scene);
+					transform.next_siblings[idx] = transform.first_children[parent_idx];
+					transform.first_children[parent_idx] = entity;
 				}
 			}
 
@@ -238,23 +359,23 @@ namespace lambda
 			Vector<entity::Entity> getChildren(const entity::Entity& entity, scene::Scene& scene)
 			{
 				Vector<entity::Entity> children;
-				for (const auto& child : scene.transform.get(entity).children)
+				for (entity::Entity child = scene.transform.first_children[getSlot(entity, scene)]; child != entity::InvalidEntity; child = scene.transform.next_siblings[getSlot(child, scene)])
 					children.push_back(child);
 				return children;
 			}
 
 			void setLocalTranslation(const entity::Entity& entity, const glm::vec3& translation, scene::Scene& scene)
 			{
-				Data& data = scene.transform.get(entity);
-				data.translation = translation;
-				makeDirtyRecursive(data, scene);
+				const uint32_t idx = getSlot(entity, scene);
+				scene.transform.translations[idx] = translation;
+				scene.transform.dirty[idx] = 1u;
 			}
 
 			void setLocalRotation(const entity::Entity& entity, const glm::quat& rotation, scene::Scene& scene)
 			{
-				Data& data = scene.transform.get(entity);
-				data.rotation = rotation;
-				makeDirtyRecursive(data, scene);
+				const uint32_t idx = getSlot(entity, scene);
+				scene.transform.rotations[idx] = rotation;
+				scene.transform.dirty[idx] = 1u;
 			}
 
 			void setLocalRotation(const entity::Entity& entity, const glm::vec3& euler, scene::Scene& scene)
@@ -264,51 +385,50 @@ namespace lambda
 
 			void setLocalScale(const entity::Entity& entity, const glm::vec3& scale, scene::Scene& scene)
 			{
-				Data& data = scene.transform.get(entity);
-				data.scale = scale;
-				makeDirtyRecursive(data, scene);
+				const uint32_t idx = getSlot(entity, scene);
+				scene.transform.scales[idx] = scale;
+				scene.transform.dirty[idx] = 1u;
 			}
 
 			glm::vec3 getLocalTranslation(const entity::Entity& entity, scene::Scene& scene)
 			{
-				return scene.transform.get(entity).translation;
+				return scene.transform.translations[getSlot(entity, scene)];
 			}
 
 			glm::quat getLocalRotation(const entity::Entity& entity, scene::Scene& scene)
 			{
-				return scene.transform.get(entity).rotation;
+				return scene.transform.rotations[getSlot(entity, scene)];
 			}
 
 			glm::vec3 getLocalScale(const entity::Entity& entity, scene::Scene& scene)
 			{
-				return scene.transform.get(entity).scale;
+				return scene.transform.scales[getSlot(entity, scene)];
 			}
 
 			void moveLocal(const entity::Entity& entity, const glm::vec3& delta, scene::Scene& scene)
 			{
-				Data& data = scene.transform.get(entity);
-				data.translation += delta;
-				makeDirtyRecursive(data, scene);
+				const uint32_t idx = getSlot(entity, scene);
+				scene.transform.translations[idx] += delta;
+				scene.transform.dirty[idx] = 1u;
 			}
 
 			void rotateLocal(const entity::Entity& entity, const glm::quat& delta, scene::Scene& scene)
 			{
-				Data& data = scene.transform.get(entity);
-				data.rotation += delta; // TODO (Hilze): Validate this.
-				makeDirtyRecursive(data, scene);
+				const uint32_t idx = getSlot(entity, scene);
+				scene.transform.rotations[idx] += delta; // TODO (Hilze): Validate this.
+				scene.transform.dirty[idx] = 1u;
 			}
 
 			void scaleLocal(const entity::Entity& entity, const glm::vec3& delta, scene::Scene& scene)
 			{
-				Data& data = scene.transform.get(entity);
-				data.scale *= delta;
-				makeDirtyRecursive(data, scene);
+				const uint32_t idx = getSlot(entity, scene);
+				scene.transform.scales[idx] *= delta;
+				scene.transform.dirty[idx] = 1u;
 			}
 
 			void setWorldTranslation(const entity::Entity& entity, const glm::vec3& translation, scene::Scene& scene)
 			{
-				const Data& data = scene.transform.get(entity);
-				if (0u == data.getParent() || data.getParent() == entity)
+				if (!hasParent(entity, scene))
 				{
 					setLocalTranslation(entity, translation, scene);
 					return;
@@ -322,14 +442,13 @@ namespace lambda
 
 			void setWorldRotation(const entity::Entity& entity, const glm::quat& rotation, scene::Scene& scene)
 			{
-				const Data& data = scene.transform.get(entity);
-				if (0u == data.getParent() || data.getParent() == entity)
+				if (!hasParent(entity, scene))
 				{
 					setLocalRotation(entity, rotation, scene);
 					return;
 				}
 
-				const glm::quat parent_rotation = getWorldRotation(data.getParent(), scene);
+				const glm::quat parent_rotation = getWorldRotation(getParent(entity, scene), scene);
 				// q' represents the rotation from the rotation q1 to the rotation q2
 				// q' = q1^-1 * q2
 
@@ -343,8 +462,7 @@ namespace lambda
 
 			void setWorldScale(const entity::Entity& entity, const glm::vec3& scale, scene::Scene& scene)
 			{
-				const Data& data = scene.transform.get(entity);
-				if (0u == data.getParent() || data.getParent() == entity)
+				if (!hasParent(entity, scene))
 				{
 					setLocalScale(entity, scale, scene);
 					return;
@@ -365,20 +483,20 @@ namespace lambda
 
 			glm::quat getWorldRotation(const entity::Entity& entity, scene::Scene& scene)
 			{
-				const Data& data = scene.transform.get(entity);
-				if (data.getParent() != 0u && entity != data.getParent())
-					return getWorldRotation(data.getParent(), scene) * data.rotation;
+				const glm::quat& rotation = scene.transform.rotations[getSlot(entity, scene)];
+				if (hasParent(entity, scene))
+					return getWorldRotation(getParent(entity, scene), scene) * rotation;
 				else
-					return data.rotation;
+					return rotation;
 			}
 
 			glm::vec3 getWorldScale(const entity::Entity& entity, scene::Scene& scene)
 			{
-				const Data& data = scene.transform.get(entity);
-				if (data.getParent() != 0u && entity != data.getParent())
-					return data.scale * getWorldScale(data.getParent(), scene);
+				const glm::vec3& scale = scene.transform.scales[getSlot(entity, scene)];
+				if (hasParent(entity, scene))
+					return scale * getWorldScale(getParent(entity, scene), scene);
 				else
-					return data.scale;
+					return scale;
 			}
 
 			void moveWorld(const entity::Entity& entity, const glm::vec3& delta, scene::Scene& scene)
@@ -478,37 +596,56 @@ namespace lambda
 			}
 		}
 
-		// The system data.
+		// The transform data.
 		namespace TransformSystem
 		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
+			constexpr uint32_t SystemData::kInvalidSlot;
 
-				return data[idx];
+			template<typename T>
+			static void gather(Vector<T>& values, const Vector<uint32_t>& order)
+			{
+				Vector<T> sorted(values.size());
+				for (uint32_t i = 0u; i < order.size(); ++i)
+					sorted[i] = values[order[i]];
+				values.swap(sorted);
 			}
 
-			Data& SystemData::get(const entity::Entity& entity)
+			uint32_t SystemData::add(const entity::Entity& entity)
 			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "TRANSFORM: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "TRANSFORM: %llu's data was not valid", entity);
-				return data[it->second];
+				const uint32_t index = entity::getIndex(entity);
+				if (index >= sparse.size())
+					sparse.resize(index + 1u, kInvalidSlot);
+
+				uint32_t idx = sparse[index];
+				if (idx != kInvalidSlot)
+				{
+					LMB_ASSERT(entities[idx] == entity, "TRANSFORM: %u is still used by %u", index, entities[idx]);
+
+					// Adding again resets the transform and cancels a pending remove.
+					marked_for_delete.erase(entity);
+					translations[idx] = glm::vec3(0.0f);
+					rotations[idx]    = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+					scales[idx]       = glm::vec3(1.0f);
+					dirty[idx]        = 1u;
+					return idx;
+				}
+
+				idx = (uint32_t)entities.size();
+				sparse[index] = idx;
+				entities.push_back(entity);
+				parents.push_back(kRoot);
+				first_children.push_back(entity::InvalidEntity);
+				next_siblings.push_back(entity::InvalidEntity);
+				translations.push_back(glm::vec3(0.0f));
+				rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+				scales.push_back(glm::vec3(1.0f));
+				locals.push_back(glm::mat4(1.0f));
+				worlds.push_back(glm::mat4(1.0f));
+				dirty.push_back(1u);
+				world_versions.push_back(0u);
+				parent_versions.push_back(0u);
+				sorted = false;
+				return idx;
 			}
 
 			void SystemData::remove(const entity::Entity& entity)
@@ -516,60 +653,152 @@ namespace lambda
 				marked_for_delete.insert(entity);
 			}
 
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
-			}
-		}
-
-		// The transform data.
-		namespace TransformSystem
-		{
-			Data::Data(const Data& other)
+			bool SystemData::has(const entity::Entity& entity) const
 			{
-				children = other.children;
-				parent = other.parent;
-				entity = other.entity;
-				translation = other.translation;
-				rotation = other.rotation;
-				scale = other.scale;
-				local = other.local;
-				world = other.world;
-				dirty = other.dirty;
-				valid = other.valid;
+				return slot(entity) != kInvalidSlot;
 			}
 
-			Data& Data::operator=(const Data& other)
+			uint32_t SystemData::slot(const entity::Entity& entity) const
 			{
-				children = other.children;
-				parent = other.parent;
-				entity = other.entity;
-				translation = other.translation;
-				rotation = other.rotation;
-				scale = other.scale;
-				local = other.local;
-				world = other.world;
-				dirty = other.dirty;
-				valid = other.valid;
-				return *this;
-			}
-		}
-
-
-
+				const uint32_t index = entity::getIndex(entity);
+				if (index >= sparse.size())
+					return kInvalidSlot;
 
+				const uint32_t idx = sparse[index];
+				if (idx == kInvalidSlot || entities[idx] != entity)
+					return kInvalidSlot;
 
+				return idx;
+			}
 
+			void SystemData::erase(const entity::Entity& entity)
+			{
+				const uint32_t idx = slot(entity);
+				if (idx == kInvalidSlot)
+					return;
 
+				// Children that are left behind become roots.
+				for (entity::Entity child = first_children[idx]; child != entity::InvalidEntity;)
+				{
+					const uint32_t child_idx = slot(child);
+					child = next_siblings[child_idx];
+					parents[child_idx]       = kRoot;
+					next_siblings[child_idx] = entity::InvalidEntity;
+					dirty[child_idx]         = 1u;
+				}
 
+				if (parents[idx] != kRoot)
+					unlinkChild(*this, parents[idx], entity);
 
+				const uint32_t last = (uint32_t)entities.size() - 1u;
+				if (idx != last)
+				{
+					entities[idx]        = entities[last];
+					parents[idx]         = parents[last];
+					first_children[idx]  = first_children[last];
+					next_siblings[idx]   = next_siblings[last];
+					translations[idx]    = translations[last];
+					rotations[idx]       = rotations[last];
+					scales[idx]          = scales[last];
+					locals[idx]          = locals[last];
+					worlds[idx]          = worlds[last];
+					dirty[idx]           = dirty[last];
+					world_versions[idx]  = world_versions[last];
+					parent_versions[idx] = parent_versions[last];
+					sparse[entity::getIndex(entities[idx])] = idx;
+				}
 
+				entities.pop_back();
+				parents.pop_back();
+				first_children.pop_back();
+				next_siblings.pop_back();
+				translations.pop_back();
+				rotations.pop_back();
+				scales.pop_back();
+				locals.pop_back();
+				worlds.pop_back();
+				dirty.pop_back();
+				world_versions.pop_back();
+				parent_versions.pop_back();
+				sparse[entity::getIndex(entity)] = kInvalidSlot;
+				sorted = false;
+			}
 
+			void SystemData::collectGarbage()
+			{
+				for (const entity::Entity& entity : marked_for_delete)
+					erase(entity);
+				marked_for_delete.clear();
+			}
 
+			void SystemData::sort()
+			{
+				const uint32_t count = size();
 
+				// Depth of every transform. Walks up until it finds a known depth.
+				Vector<uint32_t> depths(count, kInvalidSlot);
+				Vector<uint32_t> stack;
+				uint32_t max_depth = 0u;
+				for (uint32_t i = 0u; i < count; ++i)
+				{
+					uint32_t idx = i;
+					while (depths[idx] == kInvalidSlot)
+					{
+						const uint32_t parent_idx = parentSlot(*this, idx);
+						if (parent_idx == kInvalidSlot)
+						{
+							depths[idx] = 0u;
+							break;
+						}
+						stack.push_back(idx);
+						idx = parent_idx;
+					}
 
+					while (!stack.empty())
+					{
+						depths[stack.back()] = depths[idx] + 1u;
+						idx = stack.back();
+						stack.pop_back();
+					}
 
+					max_depth = eastl::max(max_depth, depths[i]);
+				}
 
+				// Counting sort on depth. Keeps the relative order within a level.
+				level_offsets.assign(count > 0u ? max_depth + 2u : 1u, 0u);
+				for (uint32_t i = 0u; i < count; ++i)
+					level_offsets[depths[i] + 1u]++;
+				for (uint32_t i = 1u; i < level_offsets.size(); ++i)
+					level_offsets[i] += level_offsets[i - 1u];
+
+				Vector<uint32_t> order(count);
+				Vector<uint32_t> cursors(level_offsets.begin(), level_offsets.end());
+				for (uint32_t i = 0u; i < count; ++i)
+					order[cursors[depths[i]]++] = i;
+
+				gather(entities, order);
+				gather(parents, order);
+				gather(first_children, order);
+				gather(next_siblings, order);
+				gather(translations, order);
+				gather(rotations, order);
+				gather(scales, order);
+				gather(locals, order);
+				gather(worlds, order);
+				gather(dirty, order);
+				gather(world_versions, order);
+				gather(parent_versions, order);
+
+				for (uint32_t i = 0u; i < count; ++i)
+					sparse[entity::getIndex(entities[i])] = i;
+
+				parent_slots.resize(count);
+				for (uint32_t i = 0u; i < count; ++i)
+					parent_slots[i] = parentSlot(*this, i);
+
+				sorted = true;
+			}
+		}
 
 		TransformComponent::TransformComponent(const entity::Entity& entity, scene::Scene& scene) :
 			IComponent(entity), scene_(&scene)
@@ -83,41 +83,47 @@ namespace lambda
 
 		namespace TransformSystem
 		{
-			struct Data
-			{
-				Data() {};
-				Data(const entity::Entity& entity) : entity(entity) {};
-				Data(const Data& other);
-				Data& operator=(const Data& other);
-
-				Vector<entity::Entity> children;
-				entity::Entity entity;
-
-				glm::vec3 translation = glm::vec3(0.0f);
-				glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-				glm::vec3 scale = glm::vec3(1.0f);
-				glm::mat4 local = glm::mat4(1.0f);
-				glm::mat4 world = glm::mat4(1.0f);
-				bool dirty = true;
-				bool valid = true;
-				entity::Entity parent = entity::InvalidEntity;
-
-				entity::Entity getParent() const { return parent; }
-				void setParent(entity::Entity p) { parent = p; }
-			};
-
+			// Transforms are stored as arrays per member and sorted on their depth
+			// in the hierarchy, so every parent comes before its children. update()
+			// rebuilds the dirty world matrices level by level. Getters that are
+			// called between two updates clean the transforms they need.
 			struct SystemData
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
+				static constexpr uint32_t kInvalidSlot = ~0u;
+
+				Vector<entity::Entity> entities;
+				Vector<entity::Entity> parents;
+				Vector<entity::Entity> first_children;
+				Vector<entity::Entity> next_siblings;
+				Vector<glm::vec3>      translations;
+				Vector<glm::quat>      rotations;
+				Vector<glm::vec3>      scales;
+				Vector<glm::mat4>      locals;
+				Vector<glm::mat4>      worlds;
+				// Set when the local matrix has to be rebuilt.
+				Vector<uint8_t>        dirty;
+				// Bumped every time a world matrix is rebuilt. A world matrix is
+				// stale when its parent's version differs from the one it was built with.
+				Vector<uint32_t>       world_versions;
+				Vector<uint32_t>       parent_versions;
+
+				// Only valid while sorted is set.
+				Vector<uint32_t>       parent_slots;
+				Vector<uint32_t>       level_offsets;
+				bool                   sorted = true;
+
+				Vector<uint32_t>       sparse;
+				Set<entity::Entity>    marked_for_delete;
+
+				uint32_t add(const entity::Entity& entity);
+				void     remove(const entity::Entity& entity);
+				bool     has(const entity::Entity& entity) const;
+				uint32_t slot(const entity::Entity& entity) const;
+				uint32_t size() const { return (uint32_t)entities.size(); }
+				void     erase(const entity::Entity& entity);
+				void     collectGarbage();
+				// Orders the transforms on their depth in the hierarchy.
+				void     sort();
 			};
 
 			TransformComponent addComponent(const entity::Entity& entity, scene::Scene& scene);
@@ -181,8 +187,8 @@ namespace lambda
 			void lookAt(const entity::Entity& entity, const glm::vec3& target, glm::vec3 up, scene::Scene& scene);
 			void lookAtLocal(const entity::Entity& entity, const glm::vec3& target, glm::vec3 up, scene::Scene& scene);
 
-			void cleanIfDirty(Data& data, scene::Scene& scene);
-			void makeDirtyRecursive(Data& data, scene::Scene& scene);
+			// Rebuilds every dirty world matrix. Called once per frame before rendering.
+			void update(scene::Scene& scene);
 			bool isChildOf(const entity::Entity& parent, const entity::Entity& child, scene::Scene& scene);
 
 			glm::quat lookRotation(const glm::vec3& forward, const glm::vec3& up);
@@ -94,19 +94,16 @@ namespace lambda
 			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 			void deinitialize(scene::Scene& scene)
 			{
-				Vector<entity::Entity> entities;
-				for (const auto& it : scene.wave_source.entity_to_data)
-					entities.push_back(it.first);
+				for (const auto& data : scene.wave_source.data)
+					if (scene.wave_source.engine->isValidVoiceHandle(data.handle))
+						scene.wave_source.engine->stop(data.handle);
+
+				Vector<entity::Entity> entities = scene.wave_source.entities;
 
 				for (const auto& entity : entities)
 					removeComponent(entity, scene);
 				collectGarbage(scene);
 
-				for (const auto& data : scene.wave_source.data)
-					if (scene.wave_source.engine->isValidVoiceHandle(data.handle))
-						scene.wave_source.engine->stop(data.handle);
-				scene.wave_source.data.clear();
-
 				scene.wave_source.engine->stopAll();
 
 				while (scene.wave_source.engine->getActiveVoiceCount() > 0)
@@ -151,22 +148,7 @@ namespace lambda
 
 			void collectGarbage(scene::Scene& scene)
 			{
-				if (!scene.wave_source.marked_for_delete.empty())
-				{
-					for (entity::Entity entity : scene.wave_source.marked_for_delete)
-					{
-						const auto& it = scene.wave_source.entity_to_data.find(entity);
-						if (it != scene.wave_source.entity_to_data.end())
-						{
-							uint32_t idx = it->second;
-							scene.wave_source.unused_data_entries.push(idx);
-							scene.wave_source.data_to_entity.erase(idx);
-							scene.wave_source.entity_to_data.erase(entity);
-							scene.wave_source.data[idx].valid = false;
-						}
-					}
-					scene.wave_source.marked_for_delete.clear();
-				}
+				scene.wave_source.collectGarbage();
 			}
 			
 			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -189,7 +171,7 @@ namespace lambda
 
 				if (data.handle != 0u)
 					scene.wave_source.engine->setPause(scene.wave_source.get(entity).handle, false);
-				else
+				else if (data.buffer && data.buffer->getBuffer())
 				{
 					if (data.in_world)
 						data.handle = scene.wave_source.engine->play3d(*data.buffer->getBuffer(), 0.0f, 0.0f, 0.0f);
@@ -314,53 +296,6 @@ namespace lambda
 
 
 
-		// The system data.
-		namespace WaveSourceSystem
-		{
-			Data& SystemData::add(const entity::Entity& entity)
-			{
-				uint32_t idx = 0ul;
-				if (!unused_data_entries.empty())
-				{
-					idx = unused_data_entries.front();
-					unused_data_entries.pop();
-					data[idx] = Data(entity);
-				}
-				else
-				{
-					idx = (uint32_t)data.size();
-					data.push_back(Data(entity));
-					data_to_entity[idx] = entity;
-				}
-
-				data_to_entity[idx] = entity;
-				entity_to_data[entity] = idx;
-
-				return data[idx];
-			}
-
-			Data& SystemData::get(const entity::Entity& entity)
-			{
-				auto it = entity_to_data.find(entity);
-				LMB_ASSERT(it != entity_to_data.end(), "NAME: %llu does not have a component", entity);
-				LMB_ASSERT(data[it->second].valid, "NAME: %llu's data was not valid", entity);
-				return data[it->second];
-			}
-
-			void SystemData::remove(const entity::Entity& entity)
-			{
-				marked_for_delete.insert(entity);
-			}
-
-			bool SystemData::has(const entity::Entity& entity)
-			{
-				return entity_to_data.find(entity) != entity_to_data.end();
-			}
-		}
-
-
-
-
 		namespace WaveSourceSystem
 		{
 			Data::Data(const Data & other)
@@ -375,7 +310,6 @@ namespace lambda
 				pitch = other.pitch;
 				radius = other.radius;
 				last_position = other.last_position;
-				valid = other.valid;
 			}
 			Data & Data::operator=(const Data & other)
 			{
@@ -389,7 +323,6 @@ namespace lambda
 				pitch = other.pitch;
 				radius = other.radius;
 				last_position = other.last_position;
-				valid = other.valid;
 
 				return *this;
 			}
@@ -1,5 +1,6 @@
 #pragma once
 #include "interfaces/icomponent.h"
+#include "systems/component_store.h"
 #include <containers/containers.h>
 #include <memory/memory.h>
 #include <glm/glm.hpp>
@@ -76,23 +77,11 @@ namespace lambda
 				float gain = 1.0f;
 				float pitch = 1.0f;
 				float radius = 100.0f;
-				bool  valid = true;
 				glm::vec3 last_position;
 			};
 
-			struct SystemData
+			struct SystemData : public ComponentStore<Data>
 			{
-				Vector<Data>                  data;
-				Map<entity::Entity, uint32_t> entity_to_data;
-				Map<uint32_t, entity::Entity> data_to_entity;
-				Set<entity::Entity>           marked_for_delete;
-				Queue<uint32_t>               unused_data_entries;
-
-				Data& add(const entity::Entity& entity);
-				Data& get(const entity::Entity& entity);
-				void  remove(const entity::Entity& entity);
-				bool  has(const entity::Entity& entity);
-
 				entity::Entity listener;
 				glm::vec3 last_listener_position;
 				SoLoud::Soloud* engine;
@@ -2,6 +2,8 @@
 #include "../platform/debug_renderer.h"
 #include <memory/frame_heap.h>
 #include <glm/gtx/norm.hpp>
+#include <algorithm>
+#include <cfloat>
 
 namespace lambda
 {
@@ -544,5 +546,721 @@ namespace lambda
 		glm::vec3 half_size  = (size + other.size) * 0.5f;
 		return abs_center.x < half_size.x && abs_center.y < half_size.y && abs_center.z < half_size.z;
 	}
+
+
+
+
+
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	constexpr uint32_t FlatBVH::kInvalidIndex;
+
+	// Costs are relative to testing a single primitive.
+	static constexpr float    kTraversalCost   = 1.0f;
+	static constexpr uint32_t kBinCount        = 16u;
+	static constexpr uint32_t kMinLeafSize     = 4u;
+	static constexpr uint32_t kMaxLeafSize     = 8u;
+	// Past this depth the tree is split on the median, which bounds the depth.
+	static constexpr uint32_t kMaxSahDepth     = 64u;
+	static constexpr uint32_t kStackSize       = 128u;
+	// Rebuild once a refit tree is this much more expensive than a fresh one.
+	static constexpr float    kRebuildRatio    = 1.5f;
+	static constexpr uint32_t kMaxPendingCount = 64u;
+	// Primitives handed to the frustum kernel at once.
+	static constexpr uint32_t kCullBatchSize   = 64u;
+
+	///////////////////////////////////////////////////////////////////////////
+	static inline float surfaceArea(const glm::vec3& min, const glm::vec3& max)
+	{
+		const glm::vec3 size = glm::max(max - min, glm::vec3(0.0f));
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	static inline bool overlaps(const glm::vec3& min_a, const glm::vec3& max_a, const glm::vec3& min_b, const glm::vec3& max_b)
+	{
+		return min_a.x <= max_b.x && max_a.x >= min_b.x &&
+		       min_a.y <= max_b.y && max_a.y >= min_b.y &&
+		       min_a.z <= max_b.z && max_a.z >= min_b.z;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	static inline bool overlapsSphere(const glm::vec3& min, const glm::vec3& max, const glm::vec3& center, float radius)
+	{
+		const glm::vec3 offset = glm::clamp(center, min, max) - center;
+		return glm::dot(offset, offset) <= radius * radius;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	static inline bool anywhere(const glm::vec3& min, const glm::vec3& max)
+	{
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::add(const entity::Entity& entity, void* user_data, const BVHAABB& aabb)
+	{
+		const uint32_t idx = primitiveIndex(entity);
+		if (idx != kInvalidIndex)
+		{
+			user_datas_[idx] = user_data;
+			update(entity, aabb);
+			return;
+		}
+
+		const uint32_t index = entity::getIndex(entity);
+		if (index >= sparse_.size())
+			sparse_.resize(index + 1u, kInvalidIndex);
+		sparse_[index] = (uint32_t)entities_.size();
+
+		for (uint32_t axis = 0u; axis < 3u; ++axis)
+		{
+			mins_[axis].push_back(aabb.bl[axis]);
+			maxs_[axis].push_back(aabb.tr[axis]);
+		}
+		entities_.push_back(entity);
+		user_datas_.push_back(user_data);
+		version_++;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::remove(const entity::Entity& entity)
+	{
+		const uint32_t idx = primitiveIndex(entity);
+		if (idx == kInvalidIndex)
+			return;
+
+		// Removed primitives stay in their leaf until the next build. The leaf
+		// bounds are left as they are, which is conservative. The inverted
+		// bounds fail every overlap and frustum test.
+		sparse_[entity::getIndex(entity)] = kInvalidIndex;
+		entities_[idx]   = entity::InvalidEntity;
+		user_datas_[idx] = nullptr;
+		setPrimitiveBounds(idx, glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX));
+		removed_count_++;
+		version_++;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::update(const entity::Entity& entity, const BVHAABB& aabb)
+	{
+		const uint32_t idx = primitiveIndex(entity);
+		if (idx == kInvalidIndex)
+			return;
+
+		setPrimitiveBounds(idx, aabb.bl, aabb.tr);
+		if (idx < built_count_)
+			needs_refit_ = true;
+		version_++;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool FlatBVH::has(const entity::Entity& entity) const
+	{
+		return primitiveIndex(entity) != kInvalidIndex;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::clear()
+	{
+		nodes_.clear();
+		for (uint32_t axis = 0u; axis < 3u; ++axis)
+		{
+			mins_[axis].clear();
+			maxs_[axis].clear();
+		}
+		entities_.clear();
+		user_datas_.clear();
+		sparse_.clear();
+		built_count_   = 0u;
+		removed_count_ = 0u;
+		built_cost_    = 0.0f;
+		needs_refit_   = false;
+		version_++;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint32_t FlatBVH::size() const
+	{
+		return (uint32_t)entities_.size() - removed_count_;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint32_t FlatBVH::getVersion() const
+	{
+		return version_;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::commit()
+	{
+		// A few added primitives are cheaper to test one by one than to rebuild for.
+		const uint32_t pending = (uint32_t)entities_.size() - built_count_;
+		if (pending > kMaxPendingCount || (pending > 0u && built_count_ == 0u) || removed_count_ * 2u > (uint32_t)entities_.size())
+		{
+			build();
+		}
+		else if (needs_refit_)
+		{
+			refit();
+			if (cost() > built_cost_ * kRebuildRatio)
+				build();
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::build()
+	{
+		// Drop the removed primitives.
+		uint32_t count = 0u;
+		for (uint32_t i = 0u; i < entities_.size(); ++i)
+		{
+			if (entities_[i] == entity::InvalidEntity)
+				continue;
+			setPrimitiveBounds(count, primitiveMin(i), primitiveMax(i));
+			entities_[count]   = entities_[i];
+			user_datas_[count] = user_datas_[i];
+			count++;
+		}
+		for (uint32_t axis = 0u; axis < 3u; ++axis)
+		{
+			mins_[axis].resize(count);
+			maxs_[axis].resize(count);
+		}
+		entities_.resize(count);
+		user_datas_.resize(count);
+
+		nodes_.clear();
+		built_count_   = count;
+		removed_count_ = 0u;
+		needs_refit_   = false;
+		built_cost_    = 0.0f;
+
+		if (count == 0u)
+			return;
+
+		// Build on packed copies so every pass over a range is sequential.
+		struct BuildPrimitive
+		{
+			glm::vec3 min;
+			glm::vec3 max;
+			glm::vec3 center;
+			uint32_t  index;
+		};
+
+		// Bounds of a range of primitives and of their centers.
+		struct Bounds
+		{
+			glm::vec3 min        = glm::vec3(FLT_MAX);
+			glm::vec3 max        = glm::vec3(-FLT_MAX);
+			glm::vec3 center_min = glm::vec3(FLT_MAX);
+			glm::vec3 center_max = glm::vec3(-FLT_MAX);
+
+			void add(const BuildPrimitive& primitive)
+			{
+				min = glm::min(min, primitive.min);
+				max = glm::max(max, primitive.max);
+				center_min = glm::min(center_min, primitive.center);
+				center_max = glm::max(center_max, primitive.center);
+			}
+			void add(const Bounds& other)
+			{
+				min = glm::min(min, other.min);
+				max = glm::max(max, other.max);
+				center_min = glm::min(center_min, other.center_min);
+				center_max = glm::max(center_max, other.center_max);
+			}
+		};
+
+		struct Task
+		{
+			uint32_t node;
+			uint32_t begin;
+			uint32_t end;
+			uint32_t depth;
+			Bounds   bounds;
+		};
+
+		Vector<BuildPrimitive> primitives(count);
+		Bounds root;
+		for (uint32_t i = 0u; i < count; ++i)
+		{
+			const glm::vec3 min = primitiveMin(i);
+			const glm::vec3 max = primitiveMax(i);
+			primitives[i] = { min, max, (min + max) * 0.5f, i };
+			root.add(primitives[i]);
+		}
+
+		nodes_.reserve(count * 2u - 1u);
+		nodes_.push_back(FlatBVHNode());
+		Vector<Task> tasks;
+		tasks.push_back({ 0u, 0u, count, 0u, root });
+
+		while (!tasks.empty())
+		{
+			const Task task = tasks.back();
+			tasks.pop_back();
+
+			FlatBVHNode& node = nodes_[task.node];
+			node.min   = task.bounds.min;
+			node.max   = task.bounds.max;
+			node.first = task.begin;
+			node.count = task.end - task.begin;
+
+			const uint32_t primitive_count = task.end - task.begin;
+			if (primitive_count <= kMinLeafSize)
+				continue;
+
+			// Bin all three axes in one pass, then find the cheapest split.
+			// The bins also give the bounds of both children.
+			const glm::vec3 center_min = task.bounds.center_min;
+			const glm::vec3 extent     = task.bounds.center_max - center_min;
+			float    best_cost = FLT_MAX;
+			uint32_t best_axis = 0u;
+			uint32_t best_bin  = 0u;
+			Bounds   bins[3][kBinCount];
+			uint32_t bin_counts[3][kBinCount] = {};
+			glm::vec3 scale;
+			if (task.depth < kMaxSahDepth)
+			{
+				for (uint32_t axis = 0u; axis < 3u; ++axis)
+					scale[axis] = extent[axis] > 0.0f ? (float)kBinCount / extent[axis] : 0.0f;
+
+				for (uint32_t i = task.begin; i < task.end; ++i)
+				{
+					const BuildPrimitive& primitive = primitives[i];
+					for (uint32_t axis = 0u; axis < 3u; ++axis)
+					{
+						const uint32_t b = eastl::min(kBinCount - 1u, (uint32_t)((primitive.center[axis] - center_min[axis]) * scale[axis]));
+						bins[axis][b].add(primitive);
+						bin_counts[axis][b]++;
+					}
+				}
+
+				for (uint32_t axis = 0u; axis < 3u; ++axis)
+				{
+					if (extent[axis] <= 0.0f)
+						continue;
+
+					// Sweep from the right to get the cost of every right side.
+					float right_areas[kBinCount];
+					uint32_t right_counts[kBinCount];
+					Bounds right;
+					uint32_t right_count = 0u;
+					for (uint32_t b = kBinCount - 1u; b > 0u; --b)
+					{
+						right.add(bins[axis][b]);
+						right_count += bin_counts[axis][b];
+						right_areas[b]  = surfaceArea(right.min, right.max);
+						right_counts[b] = right_count;
+					}
+
+					Bounds left;
+					uint32_t left_count = 0u;
+					for (uint32_t b = 0u; b < kBinCount - 1u; ++b)
+					{
+						left.add(bins[axis][b]);
+						left_count += bin_counts[axis][b];
+						if (left_count == 0u || right_counts[b + 1u] == 0u)
+							continue;
+
+						const float split_cost = surfaceArea(left.min, left.max) * left_count + right_areas[b + 1u] * right_counts[b + 1u];
+						if (split_cost < best_cost)
+						{
+							best_cost = split_cost;
+							best_axis = axis;
+							best_bin  = b;
+						}
+					}
+				}
+			}
+
+			uint32_t middle = task.begin + primitive_count / 2u;
+			Bounds left, right;
+			if (best_cost != FLT_MAX)
+			{
+				const float area      = surfaceArea(task.bounds.min, task.bounds.max);
+				const float leaf_cost = area * primitive_count;
+				if (kTraversalCost * area + best_cost >= leaf_cost && primitive_count <= kMaxLeafSize)
+					continue;
+
+				// Same bin computation as above, so the split matches the cost.
+				const float axis_scale = scale[best_axis];
+				const float axis_min   = center_min[best_axis];
+				middle = (uint32_t)(std::partition(primitives.begin() + task.begin, primitives.begin() + task.end, [&](const BuildPrimitive& primitive) {
+					return eastl::min(kBinCount - 1u, (uint32_t)((primitive.center[best_axis] - axis_min) * axis_scale)) <= best_bin;
+				}) - primitives.begin());
+
+				for (uint32_t b = 0u; b < kBinCount; ++b)
+					(b <= best_bin ? left : right).add(bins[best_axis][b]);
+			}
+			else
+			{
+				// All centers are the same or the tree got too deep. Split on the median.
+				if (primitive_count <= kMaxLeafSize)
+					continue;
+				const uint32_t axis = extent.x > extent.y ? (extent.x > extent.z ? 0u : 2u) : (extent.y > extent.z ? 1u : 2u);
+				std::nth_element(primitives.begin() + task.begin, primitives.begin() + middle, primitives.begin() + task.end, [axis](const BuildPrimitive& a, const BuildPrimitive& b) {
+					return a.center[axis] < b.center[axis];
+				});
+
+				for (uint32_t i = task.begin; i < middle; ++i)
+					left.add(primitives[i]);
+				for (uint32_t i = middle; i < task.end; ++i)
+					right.add(primitives[i]);
+			}
+
+			const uint32_t left_node = (uint32_t)nodes_.size();
+			nodes_[task.node].first = left_node;
+			nodes_[task.node].count = 0u;
+			nodes_.push_back(FlatBVHNode());
+			nodes_.push_back(FlatBVHNode());
+			tasks.push_back({ left_node + 1u, middle, task.end, task.depth + 1u, right });
+			tasks.push_back({ left_node, task.begin, middle, task.depth + 1u, left });
+		}
+
+		// Put the primitives in leaf order.
+		Vector<entity::Entity> entities(count);
+		Vector<void*>          user_datas(count);
+		for (uint32_t i = 0u; i < count; ++i)
+		{
+			const uint32_t idx = primitives[i].index;
+			for (uint32_t axis = 0u; axis < 3u; ++axis)
+			{
+				mins_[axis][i] = primitives[i].min[axis];
+				maxs_[axis][i] = primitives[i].max[axis];
+			}
+			entities[i]   = entities_[idx];
+			user_datas[i] = user_datas_[idx];
+			sparse_[entity::getIndex(entities[i])] = i;
+		}
+		entities_.swap(entities);
+		user_datas_.swap(user_datas);
+
+		built_cost_ = cost();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::refit()
+	{
+		// Children always come after their parent.
+		for (uint32_t i = (uint32_t)nodes_.size(); i-- > 0u;)
+		{
+			FlatBVHNode& node = nodes_[i];
+			if (node.count == 0u)
+			{
+				const FlatBVHNode& left  = nodes_[node.first];
+				const FlatBVHNode& right = nodes_[node.first + 1u];
+				node.min = glm::min(left.min, right.min);
+				node.max = glm::max(left.max, right.max);
+			}
+			else
+			{
+				for (uint32_t axis = 0u; axis < 3u; ++axis)
+				{
+					float min = FLT_MAX, max = -FLT_MAX;
+					for (uint32_t j = node.first; j < node.first + node.count; ++j)
+					{
+						min = eastl::min(min, mins_[axis][j]);
+						max = eastl::max(max, maxs_[axis][j]);
+					}
+					node.min[axis] = min;
+					node.max[axis] = max;
+				}
+			}
+		}
+		needs_refit_ = false;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	float FlatBVH::cost() const
+	{
+		if (nodes_.empty())
+			return 0.0f;
+
+		float cost = 0.0f;
+		for (const FlatBVHNode& node : nodes_)
+			cost += surfaceArea(node.min, node.max) * (node.count == 0u ? kTraversalCost : (float)node.count);
+
+		const float root_area = surfaceArea(nodes_[0].min, nodes_[0].max);
+		return root_area > 0.0f ? cost / root_area : cost;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint32_t FlatBVH::primitiveIndex(const entity::Entity& entity) const
+	{
+		const uint32_t index = entity::getIndex(entity);
+		if (index >= sparse_.size())
+			return kInvalidIndex;
+
+		const uint32_t idx = sparse_[index];
+		if (idx == kInvalidIndex || entities_[idx] != entity)
+			return kInvalidIndex;
+
+		return idx;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	glm::vec3 FlatBVH::primitiveMin(uint32_t idx) const
+	{
+		return glm::vec3(mins_[0][idx], mins_[1][idx], mins_[2][idx]);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	glm::vec3 FlatBVH::primitiveMax(uint32_t idx) const
+	{
+		return glm::vec3(maxs_[0][idx], maxs_[1][idx], maxs_[2][idx]);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::setPrimitiveBounds(uint32_t idx, const glm::vec3& min, const glm::vec3& max)
+	{
+		for (uint32_t axis = 0u; axis < 3u; ++axis)
+		{
+			mins_[axis][idx] = min[axis];
+			maxs_[axis][idx] = max[axis];
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	AABBArrays FlatBVH::primitiveArrays() const
+	{
+		return { mins_[0].data(), mins_[1].data(), mins_[2].data(), maxs_[0].data(), maxs_[1].data(), maxs_[2].data() };
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	template<typename Test, typename Output>
+	uint32_t FlatBVH::query(const Test& test, const Output& output, uint32_t max_count) const
+	{
+		uint32_t found = 0u;
+
+		if (!nodes_.empty())
+		{
+			uint32_t stack[kStackSize];
+			uint32_t top = 0u;
+			stack[top++] = 0u;
+
+			while (top > 0u)
+			{
+				const FlatBVHNode& node = nodes_[stack[--top]];
+				if (!test(node.min, node.max))
+					continue;
+
+				if (node.count == 0u)
+				{
+					stack[top++] = node.first + 1u;
+					stack[top++] = node.first;
+					continue;
+				}
+
+				for (uint32_t i = node.first; i < node.first + node.count; ++i)
+				{
+					if (entities_[i] != entity::InvalidEntity && test(primitiveMin(i), primitiveMax(i)))
+					{
+						if (found == max_count)
+							return found;
+						output(i, found++);
+					}
+				}
+			}
+		}
+
+		// Primitives that were added since the last build.
+		for (uint32_t i = built_count_; i < entities_.size(); ++i)
+		{
+			if (entities_[i] != entity::InvalidEntity && test(primitiveMin(i), primitiveMax(i)))
+			{
+				if (found == max_count)
+					return found;
+				output(i, found++);
+			}
+		}
+
+		return found;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	template<typename Volume, typename Output>
+	uint32_t FlatBVH::queryFrustum(const Frustum& frustum, const Volume& volume, const Output& output, uint32_t max_count) const
+	{
+		const AABBArrays aabbs = primitiveArrays();
+		uint32_t visible[kCullBatchSize];
+		uint32_t found = 0u;
+
+		// Tests a range of primitives in batches. Removed primitives never pass.
+		const auto cullRange = [&](uint32_t begin, uint32_t end) {
+			for (; begin < end; begin += kCullBatchSize)
+			{
+				const uint32_t count = frustum.cullAABBs(aabbs, begin, eastl::min(kCullBatchSize, end - begin), visible);
+				for (uint32_t i = 0u; i < count; ++i)
+				{
+					if (!volume(primitiveMin(visible[i]), primitiveMax(visible[i])))
+						continue;
+					if (found == max_count)
+						return false;
+					output(visible[i], found++);
+				}
+			}
+			return true;
+		};
+
+		if (!nodes_.empty())
+		{
+			uint32_t stack[kStackSize];
+			uint32_t top = 0u;
+			stack[top++] = 0u;
+
+			while (top > 0u)
+			{
+				const FlatBVHNode& node = nodes_[stack[--top]];
+				if (!volume(node.min, node.max))
+					continue;
+				const FrustumTest test = frustum.classifyAABB(node.min, node.max);
+				if (test == FrustumTest::kOutside)
+					continue;
+
+				if (test == FrustumTest::kInside)
+				{
+					// The whole subtree is visible. Its primitives run from the
+					// leftmost to the rightmost leaf and need no plane tests.
+					const FlatBVHNode* left  = &node;
+					const FlatBVHNode* right = &node;
+					while (left->count == 0u)
+						left = &nodes_[left->first];
+					while (right->count == 0u)
+						right = &nodes_[right->first + 1u];
+
+					for (uint32_t i = left->first; i < right->first + right->count; ++i)
+					{
+						if (entities_[i] == entity::InvalidEntity || !volume(primitiveMin(i), primitiveMax(i)))
+							continue;
+						if (found == max_count)
+							return found;
+						output(i, found++);
+					}
+					continue;
+				}
+
+				if (node.count == 0u)
+				{
+					stack[top++] = node.first + 1u;
+					stack[top++] = node.first;
+					continue;
+				}
+
+				if (!cullRange(node.first, node.first + node.count))
+					return found;
+			}
+		}
+
+		// Primitives that were added since the last build.
+		cullRange(built_count_, (uint32_t)entities_.size());
+		return found;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint32_t FlatBVH::getEntitiesInAABB(const BVHAABB& aabb, entity::Entity* entities, uint32_t max_count) const
+	{
+		return query(
+			[&aabb](const glm::vec3& min, const glm::vec3& max) { return overlaps(min, max, aabb.bl, aabb.tr); },
+			[this, entities](uint32_t idx, uint32_t i) { entities[i] = entities_[idx]; },
+			max_count
+		);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint32_t FlatBVH::getEntitiesInFrustum(const Frustum& frustum, entity::Entity* entities, uint32_t max_count) const
+	{
+		return queryFrustum(
+			frustum,
+			anywhere,
+			[this, entities](uint32_t idx, uint32_t i) { entities[i] = entities_[idx]; },
+			max_count
+		);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint32_t FlatBVH::getEntitiesInFrustum(const Frustum& frustum, const glm::vec3& center, float radius, entity::Entity* entities, uint32_t max_count) const
+	{
+		return queryFrustum(
+			frustum,
+			[&center, radius](const glm::vec3& min, const glm::vec3& max) { return overlapsSphere(min, max, center, radius); },
+			[this, entities](uint32_t idx, uint32_t i) { entities[i] = entities_[idx]; },
+			max_count
+		);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint32_t FlatBVH::getUserDataInAABB(const BVHAABB& aabb, void** user_datas, uint32_t max_count) const
+	{
+		return query(
+			[&aabb](const glm::vec3& min, const glm::vec3& max) { return overlaps(min, max, aabb.bl, aabb.tr); },
+			[this, user_datas](uint32_t idx, uint32_t i) { user_datas[i] = user_datas_[idx]; },
+			max_count
+		);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint32_t FlatBVH::getUserDataInFrustum(const Frustum& frustum, void** user_datas, uint32_t max_count) const
+	{
+		return queryFrustum(
+			frustum,
+			anywhere,
+			[this, user_datas](uint32_t idx, uint32_t i) { user_datas[i] = user_datas_[idx]; },
+			max_count
+		);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void FlatBVH::draw(platform::DebugRenderer* renderer) const
+	{
+		static const glm::ivec2 indices[] = {
+			glm::ivec2(0, 1), glm::ivec2(1, 2), glm::ivec2(2, 3), glm::ivec2(3, 0),
+			glm::ivec2(4, 5), glm::ivec2(5, 6), glm::ivec2(6, 7), glm::ivec2(7, 4),
+			glm::ivec2(0, 4), glm::ivec2(1, 5), glm::ivec2(2, 6), glm::ivec2(3, 7),
+		};
+
+		if (nodes_.empty())
+			return;
+
+		// Only the leaves are drawn, coloured by depth.
+		glm::uvec2 stack[kStackSize];
+		uint32_t top = 0u;
+		stack[top++] = glm::uvec2(0u, 0u);
+		while (top > 0u)
+		{
+			const glm::uvec2 entry = stack[--top];
+			const FlatBVHNode& node = nodes_[entry.x];
+			if (node.count == 0u)
+			{
+				stack[top++] = glm::uvec2(node.first + 1u, entry.y + 1u);
+				stack[top++] = glm::uvec2(node.first, entry.y + 1u);
+				continue;
+			}
+
+			const glm::vec3 corners[] = {
+				glm::vec3(node.min.x, node.min.y, node.min.z),
+				glm::vec3(node.min.x, node.min.y, node.max.z),
+				glm::vec3(node.max.x, node.min.y, node.max.z),
+				glm::vec3(node.max.x, node.min.y, node.min.z),
+
+				glm::vec3(node.min.x, node.max.y, node.min.z),
+				glm::vec3(node.min.x, node.max.y, node.max.z),
+				glm::vec3(node.max.x, node.max.y, node.max.z),
+				glm::vec3(node.max.x, node.max.y, node.min.z),
+			};
+
+			for (uint32_t i = 0; i < sizeof(indices) / sizeof(indices[0]); ++i)
+			{
+				renderer->DrawLine(platform::DebugLine(
+					corners[indices[i].x],
+					corners[indices[i].y],
+					kColors[entry.y % kColorCount]
+				));
+			}
+		}
+	}
   }
 }
\ No newline at end of file
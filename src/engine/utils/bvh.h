@@ -89,5 +89,87 @@ namespace lambda
 		  virtual void privateRemove(BVHNode* node) override;
 		  virtual BVHNode* privateCreate() override;
 	  };
+
+	  ///////////////////////////////////////////////////////////////////////////
+	  // 32 bytes, two nodes per cache line. The children of a node are stored
+	  // next to each other, so only the index of the left child is needed.
+	  struct FlatBVHNode
+	  {
+		  glm::vec3 min;
+		  // Index of the left child or, for leaves, of the first primitive.
+		  uint32_t  first;
+		  glm::vec3 max;
+		  // Number of primitives. Zero for inner nodes.
+		  uint32_t  count;
+	  };
+	  static_assert(sizeof(FlatBVHNode) == 32u, "FlatBVHNode should be 32 bytes");
+
+	  ///////////////////////////////////////////////////////////////////////////
+	  // BVH that is built top-down with binned SAH into a flat array of nodes.
+	  // Primitives are kept in leaf order, so a leaf is a range of primitives
+	  // and so is every subtree. Their bounds are stored as SoA so the frustum
+	  // test can check a batch of them at once.
+	  // Moving a primitive marks the tree for a refit, which is applied by
+	  // commit(). Added primitives are tested one by one until enough of them
+	  // piled up for commit() to rebuild.
+	  class FlatBVH
+	  {
+	  public:
+		  static constexpr uint32_t kInvalidIndex = ~0u;
+
+		  void add(const entity::Entity& entity, void* user_data, const BVHAABB& aabb);
+		  void remove(const entity::Entity& entity);
+		  // Moves a primitive. Queries see the new bounds after the next commit.
+		  void update(const entity::Entity& entity, const BVHAABB& aabb);
+		  bool has(const entity::Entity& entity) const;
+		  void clear();
+		  uint32_t size() const;
+		  // Changes whenever a primitive is added, removed or moved.
+		  uint32_t getVersion() const;
+
+		  // Rebuilds when primitives were added or the refit tree got too
+		  // expensive, refits when primitives only moved.
+		  void commit();
+		  void build();
+		  void refit();
+
+		  void draw(platform::DebugRenderer* renderer) const;
+
+		  // Write up to max_count results and return the number written.
+		  uint32_t getEntitiesInAABB(const BVHAABB& aabb, entity::Entity* entities, uint32_t max_count) const;
+		  uint32_t getEntitiesInFrustum(const Frustum& frustum, entity::Entity* entities, uint32_t max_count) const;
+		  // Only what also touches the sphere, like what a point light reaches.
+		  uint32_t getEntitiesInFrustum(const Frustum& frustum, const glm::vec3& center, float radius, entity::Entity* entities, uint32_t max_count) const;
+		  uint32_t getUserDataInAABB(const BVHAABB& aabb, void** user_datas, uint32_t max_count) const;
+		  uint32_t getUserDataInFrustum(const Frustum& frustum, void** user_datas, uint32_t max_count) const;
+
+	  private:
+		  uint32_t primitiveIndex(const entity::Entity& entity) const;
+		  glm::vec3 primitiveMin(uint32_t idx) const;
+		  glm::vec3 primitiveMax(uint32_t idx) const;
+		  void setPrimitiveBounds(uint32_t idx, const glm::vec3& min, const glm::vec3& max);
+		  AABBArrays primitiveArrays() const;
+		  float cost() const;
+		  template<typename Test, typename Output>
+		  uint32_t query(const Test& test, const Output& output, uint32_t max_count) const;
+		  template<typename Volume, typename Output>
+		  uint32_t queryFrustum(const Frustum& frustum, const Volume& volume, const Output& output, uint32_t max_count) const;
+
+	  private:
+		  Vector<FlatBVHNode>    nodes_;
+		  // Per axis.
+		  Vector<float>          mins_[3];
+		  Vector<float>          maxs_[3];
+		  Vector<entity::Entity> entities_;
+		  Vector<void*>          user_datas_;
+		  // Entity index to primitive index.
+		  Vector<uint32_t>       sparse_;
+		  // Primitives from here on are not in the tree yet.
+		  uint32_t built_count_   = 0u;
+		  uint32_t removed_count_ = 0u;
+		  uint32_t version_       = 0u;
+		  float    built_cost_    = 0.0f;
+		  bool     needs_refit_   = false;
+	  };
   }
 }
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include "mt_manager.h"
 #include <memory/memory.h>
+#include <utils/console.h>
+#include <utils/profiler.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #ifdef MULTI_THREADED_MANAGER
 namespace lambda
@@ -8,86 +13,633 @@ namespace lambda
 	{
 		namespace TaskScheduler
 		{
-			struct FunctionArgument
+			static constexpr uint32_t kMaxWorkers    = 64u;
+			static constexpr uint32_t kQueueCapacity = 4096u;
+			static constexpr uint32_t kQueueMask     = kQueueCapacity - 1u;
+			static constexpr uint32_t kJobBlockSize  = 256u;
+			static constexpr uint32_t kSpinCount     = 64u;
+			// Set in Counter::value while the jobs waiting on it are touched.
+			// Waiters see a locked counter as busy, so a counter is not done
+			// before the thread that let its jobs go is done with it.
+			static constexpr uint32_t kCounterLocked = 1u << 31u;
+
+			struct JobPool;
+			struct Job
+			{
+				JobFunction function = nullptr;
+				RangeFunction range_function = nullptr;
+				Function<void(void*)> functor;
+				void* argument = nullptr;
+				uint32_t begin = 0u;
+				uint32_t end = 0u;
+				Counter* counter = nullptr;
+				Counter* dependency = nullptr;
+				Priority priority = kMedium;
+				JobPool* pool = nullptr;
+				Job* next = nullptr;
+			};
+
+			///////////////////////////////////////////////////////////////////////////
+			// Chase-Lev deque. Only the owning worker pushes and pops at the
+			// bottom, all other threads steal from the top.
+			class WorkStealingDeque
 			{
-				Function<void(void*)> function;
-				void* argument;
+			public:
+				WorkStealingDeque()
+				{
+					for (auto& job : jobs_)
+						job.store(nullptr, std::memory_order_relaxed);
+				}
+				bool push(Job* job)
+				{
+					int64_t bottom = bottom_.load(std::memory_order_relaxed);
+					int64_t top    = top_.load(std::memory_order_acquire);
+					if (bottom - top >= (int64_t)kQueueCapacity)
+						return false;
+
+					jobs_[bottom & kQueueMask].store(job, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_release);
+					bottom_.store(bottom + 1, std::memory_order_relaxed);
+					return true;
+				}
+				Job* pop()
+				{
+					int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+					bottom_.store(bottom, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					int64_t top = top_.load(std::memory_order_relaxed);
+
+					if (top > bottom)
+					{
+						bottom_.store(bottom + 1, std::memory_order_relaxed);
+						return nullptr;
+					}
+
+					Job* job = jobs_[bottom & kQueueMask].load(std::memory_order_relaxed);
+					if (top == bottom)
+					{
+						// Last job. Race the thieves for it.
+						if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+							job = nullptr;
+						bottom_.store(bottom + 1, std::memory_order_relaxed);
+					}
+					return job;
+				}
+				Job* steal()
+				{
+					int64_t top = top_.load(std::memory_order_acquire);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+					if (top >= bottom)
+						return nullptr;
+
+					Job* job = jobs_[top & kQueueMask].load(std::memory_order_relaxed);
+					if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+						return nullptr;
+					return job;
+				}
+				bool empty() const
+				{
+					return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+				}
+
+			private:
+				// Keep top and bottom on separate cache lines.
+				std::atomic<int64_t> top_ = { 0 };
+				char padding_[64];
+				std::atomic<int64_t> bottom_ = { 0 };
+				std::atomic<Job*> jobs_[kQueueCapacity];
 			};
-			bool k_alive = true;
-			Queue<FunctionArgument> k_functions[Priority::kCount];
-			std::atomic<int> k_num_functions[Priority::kCount];
-			std::mutex k_lock[Priority::kCount];
-			std::thread k_worker_threads[Priority::kCount];
 
-			void executeFunctions(Priority priority)
+			///////////////////////////////////////////////////////////////////////////
+			// Bounded multi-producer multi-consumer queue. Used for jobs that
+			// are queued from threads that are not workers.
+			class InjectionQueue
 			{
-				while (true)
+			public:
+				InjectionQueue()
 				{
-					Priority selected_priority = Priority::kCount;
-					for (int8_t i = Priority::kCount - 1; i >= priority; --i)
+					for (uint32_t i = 0u; i < kQueueCapacity; ++i)
 					{
-						if (k_num_functions[i] > 0)
+						cells_[i].sequence.store(i, std::memory_order_relaxed);
+						cells_[i].job = nullptr;
+					}
+				}
+				bool push(Job* job)
+				{
+					size_t position = enqueue_.load(std::memory_order_relaxed);
+					while (true)
+					{
+						Cell& cell = cells_[position & kQueueMask];
+						size_t sequence = cell.sequence.load(std::memory_order_acquire);
+						intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+						if (difference == 0)
 						{
-							selected_priority = (Priority)i;
-							break;
+							if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+							{
+								cell.job = job;
+								cell.sequence.store(position + 1, std::memory_order_release);
+								return true;
+							}
 						}
+						else if (difference < 0)
+							return false;
+						else
+							position = enqueue_.load(std::memory_order_relaxed);
 					}
+				}
+				Job* pop()
+				{
+					size_t position = dequeue_.load(std::memory_order_relaxed);
+					while (true)
+					{
+						Cell& cell = cells_[position & kQueueMask];
+						size_t sequence = cell.sequence.load(std::memory_order_acquire);
+						intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+						if (difference == 0)
+						{
+							if (dequeue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+							{
+								Job* job = cell.job;
+								cell.sequence.store(position + kQueueCapacity, std::memory_order_release);
+								return job;
+							}
+						}
+						else if (difference < 0)
+							return nullptr;
+						else
+							position = dequeue_.load(std::memory_order_relaxed);
+					}
+				}
+				bool empty() const
+				{
+					return enqueue_.load(std::memory_order_relaxed) <= dequeue_.load(std::memory_order_relaxed);
+				}
+
+			private:
+				struct Cell
+				{
+					std::atomic<size_t> sequence;
+					Job* job;
+				};
+				std::atomic<size_t> enqueue_ = { 0u };
+				char padding_[64];
+				std::atomic<size_t> dequeue_ = { 0u };
+				Cell cells_[kQueueCapacity];
+			};
+
+			///////////////////////////////////////////////////////////////////////////
+			// Every thread that queues jobs owns a pool of jobs. Finished jobs go
+			// back to the pool they came from. Other threads hand them back
+			// through a lock-free list that the owner takes over in one go.
+			struct JobPool
+			{
+				Job* free_jobs = nullptr;
+				std::atomic<Job*> returned_jobs = { nullptr };
+				Vector<Job*> blocks;
+			};
+
+			struct Worker
+			{
+				WorkStealingDeque deque;
+				std::thread thread;
+			};
+
+			std::atomic<bool> k_alive = { false };
+			std::mutex k_state_lock;
+			uint32_t k_worker_count = 0u;
+			Worker* k_workers[kMaxWorkers] = {};
+			InjectionQueue* k_injection_queues[Priority::kCount] = {};
+
+			std::mutex k_pool_lock;
+			Vector<JobPool*> k_pools;
+			std::atomic<uint32_t> k_pool_generation = { 1u };
 
-					if (selected_priority == Priority::kCount && k_alive)
+			std::mutex k_sleep_lock;
+			std::condition_variable k_wake;
+			std::atomic<uint32_t> k_sleeping = { 0u };
+
+			thread_local int32_t k_worker_index = -1;
+			thread_local JobPool* k_job_pool = nullptr;
+			thread_local uint32_t k_job_pool_generation = 0u;
+			thread_local uint32_t k_random = 0u;
+
+			///////////////////////////////////////////////////////////////////////////
+			Job* allocateJob()
+			{
+				// Pools are released on terminate, so grab a new one if ours is stale.
+				if (k_job_pool == nullptr || k_job_pool_generation != k_pool_generation.load())
+				{
+					k_job_pool = foundation::Memory::construct<JobPool>();
+					k_job_pool_generation = k_pool_generation.load();
+					k_pool_lock.lock();
+					k_pools.push_back(k_job_pool);
+					k_pool_lock.unlock();
+				}
+
+				JobPool* pool = k_job_pool;
+				if (pool->free_jobs == nullptr)
+					pool->free_jobs = pool->returned_jobs.exchange(nullptr, std::memory_order_acquire);
+
+				if (pool->free_jobs == nullptr)
+				{
+					Job* block = (Job*)foundation::Memory::allocate(sizeof(Job) * kJobBlockSize);
+					for (uint32_t i = 0u; i < kJobBlockSize; ++i)
 					{
-						std::this_thread::sleep_for(std::chrono::microseconds(1));
-						continue;
+						new (&block[i]) Job();
+						block[i].pool = pool;
+						block[i].next = i + 1u < kJobBlockSize ? &block[i + 1u] : nullptr;
 					}
+					pool->blocks.push_back(block);
+					pool->free_jobs = block;
+				}
 
-					if (!k_alive)
-						return;
+				Job* job = pool->free_jobs;
+				pool->free_jobs = job->next;
+
+				job->function       = nullptr;
+				job->range_function = nullptr;
+				job->counter        = nullptr;
+				job->dependency     = nullptr;
+				job->next           = nullptr;
+				return job;
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void freeJob(Job* job)
+			{
+				job->functor = nullptr;
+				JobPool* pool = job->pool;
+				if (pool == k_job_pool)
+				{
+					job->next = pool->free_jobs;
+					pool->free_jobs = job;
+					return;
+				}
 
-					k_lock[selected_priority].lock();
+				Job* head = pool->returned_jobs.load(std::memory_order_relaxed);
+				do
+				{
+					job->next = head;
+				} while (!pool->returned_jobs.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+			}
 
-					// Damn.. we just missed it..
-					if (k_num_functions[selected_priority] <= 0)
+			///////////////////////////////////////////////////////////////////////////
+			uint32_t nextRandom()
+			{
+				if (k_random == 0u)
+					k_random = (uint32_t)(std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1u);
+				k_random ^= k_random << 13;
+				k_random ^= k_random >> 17;
+				k_random ^= k_random << 5;
+				return k_random;
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			bool hasWork()
+			{
+				for (uint32_t i = 0u; i < Priority::kCount; ++i)
+					if (!k_injection_queues[i]->empty())
+						return true;
+				for (uint32_t i = 0u; i < k_worker_count; ++i)
+					if (!k_workers[i]->deque.empty())
+						return true;
+				return false;
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void wakeWorkers(bool all)
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (k_sleeping.load() == 0u)
+					return;
+
+				k_sleep_lock.lock();
+				if (all)
+					k_wake.notify_all();
+				else
+					k_wake.notify_one();
+				k_sleep_lock.unlock();
+			}
+
+			Job* getJob();
+			void executeJob(Job* job);
+
+			///////////////////////////////////////////////////////////////////////////
+			void pushJob(Job* job)
+			{
+				bool pushed = false;
+				if (k_worker_index >= 0 && job->priority < Priority::kCritical)
+					pushed = k_workers[k_worker_index]->deque.push(job);
+
+				while (!pushed)
+				{
+					pushed = k_injection_queues[job->priority]->push(job);
+					if (!pushed)
 					{
-						k_lock[selected_priority].unlock();
-						continue;
+						// Full. Make some room by helping out.
+						Job* other = getJob();
+						if (other)
+							executeJob(other);
+						else
+							std::this_thread::yield();
 					}
+				}
+
+				wakeWorkers(false);
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void lockCounter(Counter* counter)
+			{
+				while (counter->value.fetch_or(kCounterLocked, std::memory_order_acquire) & kCounterLocked)
+					std::this_thread::yield();
+			}
 
-					k_num_functions[selected_priority]--;
-					auto function = k_functions[selected_priority].front();
-					k_functions[selected_priority].pop();
-					k_lock[selected_priority].unlock();
+			///////////////////////////////////////////////////////////////////////////
+			void unlockCounter(Counter* counter)
+			{
+				counter->value.fetch_and(~kCounterLocked, std::memory_order_release);
+			}
 
-					function.function(function.argument);
+			///////////////////////////////////////////////////////////////////////////
+			// Parks the job on its dependency if that has not reached zero yet.
+			// Returns false if the job can run now.
+			bool parkJob(Job* job)
+			{
+				Counter* dependency = job->dependency;
+				lockCounter(dependency);
+				bool parked = (dependency->value.load(std::memory_order_relaxed) & ~kCounterLocked) > 0u;
+				if (parked)
+				{
+					job->next = dependency->waiting;
+					dependency->waiting = job;
 				}
+				unlockCounter(dependency);
+				return parked;
 			}
 
-			void queue(Function<void(void*)> function, void* arguments, Priority priority)
+			///////////////////////////////////////////////////////////////////////////
+			// Counts a job of the counter as done. The last one queues the jobs
+			// that were parked on the counter.
+			void finishCounter(Counter* counter)
+			{
+				uint32_t value = counter->value.load(std::memory_order_relaxed);
+				while ((value & ~kCounterLocked) > 1u)
+					if (counter->value.compare_exchange_weak(value, value - 1u, std::memory_order_acq_rel, std::memory_order_relaxed))
+						return;
+
+				lockCounter(counter);
+				Job* waiting = nullptr;
+				if (counter->value.fetch_sub(1u, std::memory_order_acq_rel) == kCounterLocked + 1u)
+				{
+					waiting = counter->waiting;
+					counter->waiting = nullptr;
+				}
+				unlockCounter(counter);
+
+				while (waiting)
+				{
+					Job* job = waiting;
+					waiting = job->next;
+					job->next = nullptr;
+					pushJob(job);
+				}
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			Job* getJob()
+			{
+				Job* job = nullptr;
+				if (k_worker_index >= 0)
+					if ((job = k_workers[k_worker_index]->deque.pop()) != nullptr)
+						return job;
+
+				for (int8_t i = Priority::kCount - 1; i >= 0; --i)
+					if ((job = k_injection_queues[i]->pop()) != nullptr)
+						return job;
+
+				if (k_worker_count == 0u)
+					return nullptr;
+
+				uint32_t offset = nextRandom() % k_worker_count;
+				for (uint32_t i = 0u; i < k_worker_count; ++i)
+				{
+					uint32_t victim = (offset + i) % k_worker_count;
+					if ((int32_t)victim == k_worker_index)
+						continue;
+					if ((job = k_workers[victim]->deque.steal()) != nullptr)
+						return job;
+				}
+
+				return nullptr;
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void executeJob(Job* job)
 			{
-				k_lock[priority].lock();
-				k_functions[priority].push({ function, arguments });
-				k_num_functions[priority]++;
-				k_lock[priority].unlock();
+				LMB_PROFILE_SCOPE("Job");
+
+				if (job->range_function)
+					job->range_function(job->begin, job->end, job->argument);
+				else if (job->function)
+					job->function(job->argument);
+				else if (job->functor)
+					job->functor(job->argument);
+
+				Counter* counter = job->counter;
+				freeJob(job);
+				if (counter)
+					finishCounter(counter);
+			}
 
-				if (!k_worker_threads[0].joinable())
+			///////////////////////////////////////////////////////////////////////////
+			void executeFunctions(uint32_t worker_index)
+			{
+				k_worker_index = (int32_t)worker_index;
+				LMB_PROFILE_THREAD("Worker");
+				uint32_t idle_count = 0u;
+
+				while (k_alive.load(std::memory_order_relaxed))
 				{
-					for (uint8_t i = 0u; i < Priority::kCount; ++i)
+					Job* job = getJob();
+					if (job)
+					{
+						executeJob(job);
+						idle_count = 0u;
+						continue;
+					}
+
+					if (++idle_count < kSpinCount)
 					{
-						k_worker_threads[i] = std::thread(executeFunctions, (Priority)i);
+						std::this_thread::yield();
+						continue;
 					}
+
+					// Nothing to do. Go to sleep until someone queues a job.
+					std::unique_lock<std::mutex> lock(k_sleep_lock);
+					k_sleeping++;
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (!hasWork() && k_alive.load())
+						k_wake.wait(lock);
+					k_sleeping--;
+					idle_count = 0u;
+				}
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void initialize(uint32_t worker_count)
+			{
+				std::lock_guard<std::mutex> lock(k_state_lock);
+				if (k_alive)
+					return;
+
+				if (worker_count == 0u)
+				{
+					uint32_t hardware_threads = std::thread::hardware_concurrency();
+					worker_count = hardware_threads > 1u ? hardware_threads - 1u : 1u;
+				}
+				k_worker_count = worker_count < kMaxWorkers ? worker_count : kMaxWorkers;
+
+				for (uint32_t i = 0u; i < Priority::kCount; ++i)
+					k_injection_queues[i] = foundation::Memory::construct<InjectionQueue>();
+				for (uint32_t i = 0u; i < k_worker_count; ++i)
+					k_workers[i] = foundation::Memory::construct<Worker>();
+
+				k_alive = true;
+				for (uint32_t i = 0u; i < k_worker_count; ++i)
+					k_workers[i]->thread = std::thread(executeFunctions, i);
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			uint32_t getWorkerCount()
+			{
+				return k_worker_count;
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void run(JobFunction function, void* argument, Counter* counter, Counter* dependency, Priority priority)
+			{
+				if (!k_alive)
+					initialize();
+
+				Job* job = allocateJob();
+				job->function   = function;
+				job->argument   = argument;
+				job->counter    = counter;
+				job->dependency = dependency;
+				job->priority   = priority;
+
+				if (counter)
+					counter->value.fetch_add(1u, std::memory_order_relaxed);
+				// Jobs that have to wait are queued by the job that finishes the
+				// dependency, so no worker picks them up before then.
+				if (dependency == nullptr || !parkJob(job))
+					pushJob(job);
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void parallelFor(uint32_t count, uint32_t grain_size, RangeFunction function, void* user_data, Counter* counter)
+			{
+				if (count == 0u)
+					return;
+				if (!k_alive)
+					initialize();
+				if (grain_size == 0u)
+					grain_size = (count + k_worker_count) / (k_worker_count + 1u);
+
+				for (uint32_t begin = 0u; begin < count; begin += grain_size)
+				{
+					Job* job = allocateJob();
+					job->range_function = function;
+					job->argument       = user_data;
+					job->begin          = begin;
+					job->end            = begin + grain_size < count ? begin + grain_size : count;
+					job->counter        = counter;
+					job->priority       = kMedium;
+
+					if (counter)
+						counter->value.fetch_add(1u, std::memory_order_relaxed);
+					pushJob(job);
 				}
 			}
 
+			///////////////////////////////////////////////////////////////////////////
+			void waitForCounter(Counter* counter)
+			{
+				while (counter->value.load(std::memory_order_acquire) > 0u)
+				{
+					// Help out instead of blocking.
+					Job* job = k_alive ? getJob() : nullptr;
+					if (job)
+						executeJob(job);
+					else
+						std::this_thread::yield();
+				}
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			bool isDone(const Counter* counter)
+			{
+				return counter->value.load(std::memory_order_acquire) == 0u;
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void queue(Function<void(void*)> function, void* arguments, Priority priority)
+			{
+				if (!k_alive)
+					initialize();
+
+				Job* job = allocateJob();
+				job->functor  = eastl::move(function);
+				job->argument = arguments;
+				job->priority = priority;
+				pushJob(job);
+			}
+
+			///////////////////////////////////////////////////////////////////////////
 			void terminate()
 			{
+				std::lock_guard<std::mutex> lock(k_state_lock);
+				if (!k_alive)
+					return;
+
 				k_alive = false;
+				wakeWorkers(true);
+
+				// Workers steal from each other until they stop, so they all have to
+				// be joined before any of them goes.
+				for (uint32_t i = 0u; i < k_worker_count; ++i)
+					k_workers[i]->thread.join();
+				for (uint32_t i = 0u; i < k_worker_count; ++i)
+				{
+					foundation::Memory::destruct(k_workers[i]);
+					k_workers[i] = nullptr;
+				}
+				for (uint32_t i = 0u; i < Priority::kCount; ++i)
+				{
+					foundation::Memory::destruct(k_injection_queues[i]);
+					k_injection_queues[i] = nullptr;
+				}
+				k_worker_count = 0u;
 
-				for (uint8_t i = 0u; i < Priority::kCount; ++i)
+				k_pool_lock.lock();
+				for (JobPool* pool : k_pools)
 				{
-					k_worker_threads[i].join();
-					k_functions[i] = {};
-					k_num_functions[i] = 0;
+					for (Job* block : pool->blocks)
+					{
+						for (uint32_t i = 0u; i < kJobBlockSize; ++i)
+							block[i].~Job();
+						foundation::Memory::deallocate(block);
+					}
+					foundation::Memory::destruct(pool);
 				}
+				k_pools.clear();
+				k_pool_generation++;
+				k_pool_lock.unlock();
 			}
 		}
 	}
 }
-#endif
\ No newline at end of file
+#endif
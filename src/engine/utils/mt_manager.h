@@ -2,6 +2,7 @@
 #define MULTI_THREADED_MANAGER
 #ifdef MULTI_THREADED_MANAGER
 #include <containers/containers.h>
+#include <atomic>
 
 namespace lambda
 {
@@ -17,9 +18,40 @@ namespace lambda
 		kCritical,
 		kCount,
 	  };
-	  extern void queue(Function<void(void*)> function, void* arguments, Priority priority);
+
+	  struct Job;
+
+	  // Counts the number of jobs that still have to finish. Jobs that are
+	  // queued with a counter increment it and decrement it once they are done.
+	  struct Counter
+	  {
+		std::atomic<uint32_t> value = { 0u };
+		// Jobs that depend on the counter wait here until it reaches zero.
+		Job* waiting = nullptr;
+	  };
+
+	  typedef void(*JobFunction)(void* argument);
+	  typedef void(*RangeFunction)(uint32_t begin, uint32_t end, void* user_data);
+
+	  // Starts the worker threads. A worker count of 0 uses one worker per
+	  // hardware thread minus the calling thread. If this is not called the
+	  // scheduler starts itself with the default worker count on first use.
+	  void initialize(uint32_t worker_count = 0u);
+	  uint32_t getWorkerCount();
+
+	  // Queues a job. When a dependency is given the job will not start
+	  // before the dependency has reached zero.
+	  void run(JobFunction function, void* argument, Counter* counter = nullptr, Counter* dependency = nullptr, Priority priority = kMedium);
+	  // Splits [0, count) in ranges of at most grain_size and runs them as jobs.
+	  void parallelFor(uint32_t count, uint32_t grain_size, RangeFunction function, void* user_data, Counter* counter);
+	  // Executes queued jobs on the calling thread until the counter is zero.
+	  void waitForCounter(Counter* counter);
+	  bool isDone(const Counter* counter);
+
+	  // Kept for older code. Prefer run(), which does not copy a Function.
+	  void queue(Function<void(void*)> function, void* arguments, Priority priority);
 	  void terminate();
 	}
   }
 }
-#endif
\ No newline at end of file
+#endif
@@ -641,7 +641,7 @@ namespace lambda
 			fpqi->to      = to;
 			fpqi->promise = promise;
 
-			TaskScheduler::queue(findPathQueued, fpqi, platform::TaskScheduler::kMedium);
+			TaskScheduler::run(findPathQueued, fpqi, nullptr, nullptr, platform::TaskScheduler::kMedium);
 
 			return promise;
 		}
@@ -75,8 +75,7 @@ namespace meta
 			member("gain", &lambda::components::WaveSourceSystem::Data::gain),
 			member("pitch", &lambda::components::WaveSourceSystem::Data::pitch),
 			member("radius", &lambda::components::WaveSourceSystem::Data::radius),
-			member("last_position", &lambda::components::WaveSourceSystem::Data::last_position),
-			member("valid", &lambda::components::WaveSourceSystem::Data::valid)
+			member("last_position", &lambda::components::WaveSourceSystem::Data::last_position)
 		);
 	}
 
@@ -84,10 +83,9 @@ namespace meta
 	inline auto registerMembers<lambda::components::WaveSourceSystem::SystemData>()
 	{
 		return members(
-			member("entity_to_data", &lambda::components::WaveSourceSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::WaveSourceSystem::SystemData::data_to_entity),
+			member("entities", &lambda::components::WaveSourceSystem::SystemData::entities),
+			member("sparse", &lambda::components::WaveSourceSystem::SystemData::sparse),
 			member("marked_for_delete", &lambda::components::WaveSourceSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::WaveSourceSystem::SystemData::unused_data_entries),
 			member("listener", &lambda::components::WaveSourceSystem::SystemData::listener),
 			member("last_listener_position", &lambda::components::WaveSourceSystem::SystemData::last_listener_position),
 			member("data", &lambda::components::WaveSourceSystem::SystemData::data)
@@ -139,7 +137,6 @@ namespace meta
 			member("rsm", &lambda::components::LightSystem::Data::rsm),
 			member("dynamic_frequency", &lambda::components::LightSystem::Data::dynamic_frequency),
 			member("dynamic_index", &lambda::components::LightSystem::Data::dynamic_index),
-			member("valid", &lambda::components::LightSystem::Data::valid),
 			member("depth", &lambda::components::LightSystem::Data::depth),
 			member("projection", &lambda::components::LightSystem::Data::projection),
 			member("view", &lambda::components::LightSystem::Data::view),
@@ -158,10 +155,9 @@ namespace meta
 	{
 		return members(
 			member("data", &lambda::components::LightSystem::SystemData::data),
-			member("entity_to_data", &lambda::components::LightSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::LightSystem::SystemData::data_to_entity),
+			member("entities", &lambda::components::LightSystem::SystemData::entities),
+			member("sparse", &lambda::components::LightSystem::SystemData::sparse),
 			member("marked_for_delete", &lambda::components::LightSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::LightSystem::SystemData::unused_data_entries),
 			member("full_screen_mesh", &lambda::components::LightSystem::SystemData::full_screen_mesh),
 			member("shader_generate", &lambda::components::LightSystem::SystemData::shader_generate),
 			member("shader_modify", &lambda::components::LightSystem::SystemData::shader_modify),
@@ -182,8 +178,7 @@ namespace meta
 			member("far_plane", &lambda::components::CameraSystem::Data::far_plane),
 			member("shader_passes", &lambda::components::CameraSystem::Data::shader_passes),
 			member("world_matrix", &lambda::components::CameraSystem::Data::world_matrix),
-			member("entity", &lambda::components::CameraSystem::Data::entity),
-			member("valid", &lambda::components::CameraSystem::Data::valid)
+			member("entity", &lambda::components::CameraSystem::Data::entity)
 		);
 	}
 
@@ -192,10 +187,9 @@ namespace meta
 	{
 		return members(
 			member("data", &lambda::components::CameraSystem::SystemData::data),
-			member("entity_to_data", &lambda::components::CameraSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::CameraSystem::SystemData::data_to_entity),
+			member("entities", &lambda::components::CameraSystem::SystemData::entities),
+			member("sparse", &lambda::components::CameraSystem::SystemData::sparse),
 			member("marked_for_delete", &lambda::components::CameraSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::CameraSystem::SystemData::unused_data_entries),
 			member("main_camera", &lambda::components::CameraSystem::SystemData::main_camera)
 		);
 	}
@@ -224,6 +218,14 @@ namespace meta
 		);
 	}
 
+	template <>
+	inline auto registerMembers<lambda::asset::VioletRef<lambda::asset::Mesh>>()
+	{
+		return members(
+			member("from_name", &lambda::asset::VioletRef<lambda::asset::Mesh>::metaGet, &lambda::asset::VioletRef<lambda::asset::Mesh>::metaSet)
+		);
+	}
+
 	template <>
 	inline auto registerMembers<lambda::asset::VioletHandle<lambda::asset::Shader>>()
 	{
@@ -241,47 +243,51 @@ namespace meta
 	}
 
 	template <>
-	inline auto registerMembers<lambda::asset::VioletHandle<lambda::asset::Wave>>()
+	inline auto registerMembers<lambda::asset::VioletRef<lambda::asset::Texture>>()
 	{
 		return members(
-			member("from_name", &lambda::asset::VioletHandle<lambda::asset::Wave>::metaGet, &lambda::asset::VioletHandle<lambda::asset::Wave>::metaSet)
+			member("from_name", &lambda::asset::VioletRef<lambda::asset::Texture>::metaGet, &lambda::asset::VioletRef<lambda::asset::Texture>::metaSet)
 		);
 	}
 
 	template <>
-	inline auto registerMembers<lambda::Name>()
+	inline auto registerMembers<lambda::asset::VioletHandle<lambda::asset::Wave>>()
 	{
 		return members(
-			member("name", &lambda::Name::name_),
-			member("hash", &lambda::Name::hash_)
+			member("from_name", &lambda::asset::VioletHandle<lambda::asset::Wave>::metaGet, &lambda::asset::VioletHandle<lambda::asset::Wave>::metaSet)
 		);
 	}
 
 	template <>
-	inline auto registerMembers<lambda::components::TransformSystem::Data>()
+	inline auto registerMembers<lambda::Name>()
 	{
 		return members(
-			member("children", &lambda::components::TransformSystem::Data::children),
-			member("entity", &lambda::components::TransformSystem::Data::entity),
-			member("translation", &lambda::components::TransformSystem::Data::translation),
-			member("rotation", &lambda::components::TransformSystem::Data::rotation),
-			member("scale", &lambda::components::TransformSystem::Data::scale),
-			member("local", &lambda::components::TransformSystem::Data::local),
-			member("world", &lambda::components::TransformSystem::Data::world),
-			member("dirty", &lambda::components::TransformSystem::Data::dirty),
-			member("valid", &lambda::components::TransformSystem::Data::valid),
-			member("parent", &lambda::components::TransformSystem::Data::parent)
+			member("name", &lambda::Name::name_),
+			member("hash", &lambda::Name::hash_)
 		);
 	}
+
 	template <>
 	inline auto registerMembers<lambda::components::TransformSystem::SystemData>()
 	{
 		return members(
-			member("data", &lambda::components::TransformSystem::SystemData::data),
-			member("entity_to_data", &lambda::components::TransformSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::TransformSystem::SystemData::data_to_entity),
-			member("marked_for_delete", &lambda::components::TransformSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::TransformSystem::SystemData::unused_data_entries)
+			member("entities", &lambda::components::TransformSystem::SystemData::entities),
+			member("parents", &lambda::components::TransformSystem::SystemData::parents),
+			member("first_children", &lambda::components::TransformSystem::SystemData::first_children),
+			member("next_siblings", &lambda::components::TransformSystem::SystemData::next_siblings),
+			member("translations", &lambda::components::TransformSystem::SystemData::translations),
+			member("rotations", &lambda::components::TransformSystem::SystemData::rotations),
+			member("scales", &lambda::components::TransformSystem::SystemData::scales),
+			member("locals", &lambda::components::TransformSystem::SystemData::locals),
+			member("worlds", &lambda::components::TransformSystem::SystemData::worlds),
+			member("dirty", &lambda::components::TransformSystem::SystemData::dirty),
+			member("world_versions", &lambda::components::TransformSystem::SystemData::world_versions),
+			member("parent_versions", &lambda::components::TransformSystem::SystemData::parent_versions),
+			member("parent_slots", &lambda::components::TransformSystem::SystemData::parent_slots),
+			member("level_offsets", &lambda::components::TransformSystem::SystemData::level_offsets),
+			member("sorted", &lambda::components::TransformSystem::SystemData::sorted),
+			member("sparse", &lambda::components::TransformSystem::SystemData::sparse),
+			member("marked_for_delete", &lambda::components::TransformSystem::SystemData::marked_for_delete)
 		);
 	}
 
@@ -289,7 +295,6 @@ namespace meta
 	inline auto registerMembers<lambda::components::RigidBodySystem::Data>()
 	{
 		return members(
-			member("valid", &lambda::components::RigidBodySystem::Data::valid),
 			member("entity", &lambda::components::RigidBodySystem::Data::entity)
 		);
 	}
@@ -298,10 +303,9 @@ namespace meta
 	{
 		return members(
 			member("data", &lambda::components::RigidBodySystem::SystemData::data),
-			member("entity_to_data", &lambda::components::RigidBodySystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::RigidBodySystem::SystemData::data_to_entity),
-			member("marked_for_delete", &lambda::components::RigidBodySystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::RigidBodySystem::SystemData::unused_data_entries)
+			member("entities", &lambda::components::RigidBodySystem::SystemData::entities),
+			member("sparse", &lambda::components::RigidBodySystem::SystemData::sparse),
+			member("marked_for_delete", &lambda::components::RigidBodySystem::SystemData::marked_for_delete)
 		);
 	}
 
@@ -311,8 +315,7 @@ namespace meta
 		return members(
 			member("name", &lambda::components::NameSystem::Data::name),
 			member("tags", &lambda::components::NameSystem::Data::tags),
-			member("entity", &lambda::components::NameSystem::Data::entity),
-			member("valid", &lambda::components::NameSystem::Data::valid)
+			member("entity", &lambda::components::NameSystem::Data::entity)
 		);
 	}
 	template <>
@@ -320,10 +323,9 @@ namespace meta
 	{
 		return members(
 			member("data", &lambda::components::NameSystem::SystemData::data),
-			member("entity_to_data", &lambda::components::NameSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::NameSystem::SystemData::data_to_entity),
-			member("marked_for_delete", &lambda::components::NameSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::NameSystem::SystemData::unused_data_entries)
+			member("entities", &lambda::components::NameSystem::SystemData::entities),
+			member("sparse", &lambda::components::NameSystem::SystemData::sparse),
+			member("marked_for_delete", &lambda::components::NameSystem::SystemData::marked_for_delete)
 		);
 	}
 
@@ -340,7 +342,6 @@ namespace meta
 			member("on_collision_exit", &lambda::components::MonoBehaviourSystem::Data::on_collision_exit),
 			member("on_trigger_enter", &lambda::components::MonoBehaviourSystem::Data::on_trigger_enter),
 			member("on_trigger_exit", &lambda::components::MonoBehaviourSystem::Data::on_trigger_exit),
-			member("valid", &lambda::components::MonoBehaviourSystem::Data::valid),
 			member("entity", &lambda::components::MonoBehaviourSystem::Data::entity)
 		);
 	}
@@ -349,10 +350,9 @@ namespace meta
 	{
 		return members(
 			member("data", &lambda::components::MonoBehaviourSystem::SystemData::data),
-			member("entity_to_data", &lambda::components::MonoBehaviourSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::MonoBehaviourSystem::SystemData::data_to_entity),
-			member("marked_for_delete", &lambda::components::MonoBehaviourSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::MonoBehaviourSystem::SystemData::unused_data_entries)
+			member("entities", &lambda::components::MonoBehaviourSystem::SystemData::entities),
+			member("sparse", &lambda::components::MonoBehaviourSystem::SystemData::sparse),
+			member("marked_for_delete", &lambda::components::MonoBehaviourSystem::SystemData::marked_for_delete)
 		);
 	}
 
@@ -371,7 +371,6 @@ namespace meta
 			member("emissiveness", &lambda::components::MeshRenderSystem::Data::emissiveness),
 			member("visible", &lambda::components::MeshRenderSystem::Data::visible),
 			member("cast_shadows", &lambda::components::MeshRenderSystem::Data::cast_shadows),
-			member("valid", &lambda::components::MeshRenderSystem::Data::valid),
 			member("entity", &lambda::components::MeshRenderSystem::Data::entity),
 			member("renderable", &lambda::components::MeshRenderSystem::Data::renderable)
 		);
@@ -381,10 +380,9 @@ namespace meta
 	{
 		return members(
 			member("data", &lambda::components::MeshRenderSystem::SystemData::data),
-			member("entity_to_data", &lambda::components::MeshRenderSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::MeshRenderSystem::SystemData::data_to_entity),
+			member("entities", &lambda::components::MeshRenderSystem::SystemData::entities),
+			member("sparse", &lambda::components::MeshRenderSystem::SystemData::sparse),
 			member("marked_for_delete", &lambda::components::MeshRenderSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::MeshRenderSystem::SystemData::unused_data_entries),
 			member("dynamic_renderables", &lambda::components::MeshRenderSystem::SystemData::dynamic_renderables),
 			member("static_renderables", &lambda::components::MeshRenderSystem::SystemData::static_renderables),
 			member("default_albedo", &lambda::components::MeshRenderSystem::SystemData::default_albedo),
@@ -429,8 +427,7 @@ namespace meta
 		return members(
 			member("lods", &lambda::components::LODSystem::Data::lods),
 			member("base_lod", &lambda::components::LODSystem::Data::base_lod),
-			member("entity", &lambda::components::LODSystem::Data::entity),
-			member("valid", &lambda::components::LODSystem::Data::valid)
+			member("entity", &lambda::components::LODSystem::Data::entity)
 		);
 	}
 	template <>
@@ -438,10 +435,9 @@ namespace meta
 	{
 		return members(
 			member("data", &lambda::components::LODSystem::SystemData::data),
-			member("entity_to_data", &lambda::components::LODSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::LODSystem::SystemData::data_to_entity),
-			member("marked_for_delete", &lambda::components::LODSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::LODSystem::SystemData::unused_data_entries)
+			member("entities", &lambda::components::LODSystem::SystemData::entities),
+			member("sparse", &lambda::components::LODSystem::SystemData::sparse),
+			member("marked_for_delete", &lambda::components::LODSystem::SystemData::marked_for_delete)
 		);
 	}
 
@@ -451,7 +447,6 @@ namespace meta
 		return members(
 			member("type", &lambda::components::ColliderSystem::Data::type),
 			member("is_trigger", &lambda::components::ColliderSystem::Data::is_trigger),
-			member("valid", &lambda::components::ColliderSystem::Data::valid),
 			member("entity", &lambda::components::ColliderSystem::Data::entity)
 		);
 	}
@@ -460,10 +455,9 @@ namespace meta
 	{
 		return members(
 			member("data", &lambda::components::ColliderSystem::SystemData::data),
-			member("entity_to_data", &lambda::components::ColliderSystem::SystemData::entity_to_data),
-			member("data_to_entity", &lambda::components::ColliderSystem::SystemData::data_to_entity),
-			member("marked_for_delete", &lambda::components::ColliderSystem::SystemData::marked_for_delete),
-			member("unused_data_entries", &lambda::components::ColliderSystem::SystemData::unused_data_entries)
+			member("entities", &lambda::components::ColliderSystem::SystemData::entities),
+			member("sparse", &lambda::components::ColliderSystem::SystemData::sparse),
+			member("marked_for_delete", &lambda::components::ColliderSystem::SystemData::marked_for_delete)
 		);
 	}
 	/*template <>
@@ -8,16 +8,18 @@ namespace lambda
 {
   namespace utilities
   {
+    // Copied into render lists every frame, so the assets are only referred
+    // to. The mesh render component owns them.
     struct Renderable
     {
       entity::Entity entity;
       glm::mat4x4 model_matrix;
-      asset::VioletMeshHandle mesh;
+      asset::VioletMeshRef mesh;
       uint32_t sub_mesh = 0u;
-      asset::VioletTextureHandle albedo_texture;
-      asset::VioletTextureHandle normal_texture;
-			asset::VioletTextureHandle dmra_texture;
-			asset::VioletTextureHandle emissive_texture;
+      asset::VioletTextureRef albedo_texture;
+      asset::VioletTextureRef normal_texture;
+			asset::VioletTextureRef dmra_texture;
+			asset::VioletTextureRef emissive_texture;
       float metallicness = 0.0f;
 			float roughness    = 1.0f;
 			glm::vec3 emissiveness;
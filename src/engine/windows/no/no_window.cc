@@ -0,0 +1,115 @@
+#include "no_window.h"
+
+namespace lambda
+{
+  namespace window
+  {
+    ///////////////////////////////////////////////////////////////////////////
+    NoWindow::~NoWindow()
+    {
+      close();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoWindow::create(const glm::uvec2& size, const char* title)
+    {
+      size_    = size;
+      is_open_ = true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void* NoWindow::getWindow() const
+    {
+      return nullptr;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool NoWindow::pollMessage(platform::WindowMessage& message)
+    {
+      if (messages_.empty())
+        return false;
+
+      message = messages_.front();
+      messages_.pop();
+      return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoWindow::sendMessage(const platform::WindowMessage& message)
+    {
+      messages_.push(message);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoWindow::close()
+    {
+      is_open_ = false;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool NoWindow::isOpen() const
+    {
+      return is_open_;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    glm::uvec2 NoWindow::getSize() const
+    {
+      return size_;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    float NoWindow::getAspectRatio() const
+    {
+      return (float)size_.x / (float)size_.y;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    float NoWindow::getDPIMultiplier() const
+    {
+      return 1.0f;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoWindow::setSize(const glm::uvec2& size)
+    {
+      size_ = size;
+
+      platform::WindowMessage message;
+      message.type    = platform::WindowMessageType::kResize;
+      message.data[0] = size_.x;
+      message.data[1] = size_.y;
+      sendMessage(message);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool NoWindow::showCursor() const
+    {
+      return show_cursor_;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoWindow::setShowCursor(const bool& show_cursor)
+    {
+      show_cursor_ = show_cursor;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void NoWindow::setCursorPosition(const glm::ivec2& position)
+    {
+      cursor_position_ = position;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    glm::ivec2 NoWindow::getCursorPosition() const
+    {
+      return cursor_position_;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool NoWindow::inFocus() const
+    {
+      return true;
+    }
+  }
+}
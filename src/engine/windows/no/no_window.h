@@ -0,0 +1,41 @@
+#pragma once
+#include "interfaces/iwindow.h"
+#include <containers/containers.h>
+
+namespace lambda
+{
+  namespace window
+  {
+    ///////////////////////////////////////////////////////////////////////////
+    // Window that never shows anything. Pairs with the no renderer to run the
+    // engine headless, on build machines or for benchmarks.
+    class NoWindow : public platform::IWindow
+    {
+    public:
+      ~NoWindow();
+      virtual String name() const override { return "no"; };
+      void create(const glm::uvec2& size, const char* title) override;
+      void* getWindow() const override;
+      bool pollMessage(platform::WindowMessage& message) override;
+      void sendMessage(const platform::WindowMessage& message) override;
+      void close() override;
+      bool isOpen() const override;
+      glm::uvec2 getSize() const override;
+      float getAspectRatio() const override;
+      float getDPIMultiplier() const override;
+      void setSize(const glm::uvec2& size) override;
+      bool showCursor() const override;
+      void setShowCursor(const bool& show_cursor) override;
+      void setCursorPosition(const glm::ivec2& position) override;
+      glm::ivec2 getCursorPosition() const override;
+      bool inFocus() const override;
+
+    private:
+      glm::uvec2 size_;
+      glm::ivec2 cursor_position_ = glm::ivec2(0);
+      bool is_open_     = false;
+      bool show_cursor_ = true;
+      Queue<platform::WindowMessage> messages_;
+    };
+  }
+}
@@ -0,0 +1,472 @@
+#include "asset_pack.h"
+#include "utils/file_system.h"
+#include "utils/console.h"
+#include "memory/memory.h"
+#include <lz4.h>
+#include <algorithm>
+#include <cstdio>
+
+#if VIOLET_WIN32
+#include <share.h>
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#endif
+
+namespace lambda
+{
+	namespace
+	{
+		constexpr char     kPackMagic[4] = { 'L', 'P', 'A', 'K' };
+		constexpr uint32_t kPackVersion   = 1u;
+		// Blobs start on this alignment, so uncompressed vertex and texture
+		// data can be used straight from the mapping.
+		constexpr uint64_t kPackAlignment = 16u;
+		// Replaced blobs are only cleaned up once there is a fair amount.
+		constexpr uint64_t kCompactThreshold = 1ull << 20ull;
+
+		///////////////////////////////////////////////////////////////////////////
+		uint64_t align(uint64_t offset)
+		{
+			return (offset + kPackAlignment - 1u) & ~(kPackAlignment - 1u);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Readers keep the pack mapped while the builder writes to it, so the
+		// file is opened without denying others access.
+		FILE* openFile(const String& file, const char* mode)
+		{
+			const String path = FileSystem::FullFilePath(file);
+#if VIOLET_WIN32
+			FILE* fp = _fsopen(path.c_str(), mode, _SH_DENYNO);
+#else
+			FILE* fp = std::fopen(path.c_str(), mode);
+#endif
+			if (!fp)
+				foundation::Error("AssetPack: Could not open file for write: " + path + ".\n");
+			return fp;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void seek(FILE* fp, uint64_t offset)
+		{
+#if VIOLET_WIN32
+			_fseeki64(fp, (int64_t)offset, SEEK_SET);
+#else
+			fseeko(fp, (off_t)offset, SEEK_SET);
+#endif
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void writePadding(FILE* fp, uint64_t from, uint64_t to)
+		{
+			static const char kZeroes[kPackAlignment] = {};
+			if (to > from)
+				fwrite(kZeroes, 1u, (size_t)(to - from), fp);
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	VioletAssetPack::VioletAssetPack()
+		: mapping_(nullptr)
+		, entries_(nullptr)
+	{
+		memset(&header_, 0, sizeof(header_));
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	VioletAssetPack::~VioletAssetPack()
+	{
+		Flush();
+		Close();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void VioletAssetPack::Open(const String& file, const String& magic_number)
+	{
+		Close();
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		file_         = file;
+		magic_number_ = magic_number;
+		map();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void VioletAssetPack::Close()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (MappedFile* mapping : retired_)
+			foundation::Memory::destruct(mapping);
+		if (mapping_)
+			foundation::Memory::destruct(mapping_);
+
+		retired_.clear();
+		pending_.clear();
+		mapping_ = nullptr;
+		entries_ = nullptr;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool VioletAssetPack::Refresh()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (file_.empty())
+			return false;
+
+		// Misses are common, so do not map the file again unless it changed.
+		uint64_t size = 0u, write_time = 0u;
+		if (!MappedFile::GetInfo(file_, size, write_time))
+			return false;
+		if (mapping_ && size == mapping_->GetSize() && write_time == mapping_->GetWriteTime())
+			return false;
+
+		MappedFile*      previous        = mapping_;
+		const PackHeader previous_header = header_;
+		if (!map())
+			return false;
+		if (!previous || header_.index_offset != previous_header.index_offset)
+			return true;
+
+		// Nothing was flushed since, so the new mapping is not needed.
+		foundation::Memory::destruct(mapping_);
+		retired_.pop_back();
+		mapping_ = previous;
+		header_  = previous_header;
+		entries_ = (const Entry*)(previous->GetData() + header_.index_offset);
+		return false;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool VioletAssetPack::Has(uint64_t hash, VioletPackBlob blob) const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		const char* base = nullptr;
+		return find(hash, blob, base) != nullptr;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	size_t VioletAssetPack::GetSize(uint64_t hash, VioletPackBlob blob) const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		const char* base = nullptr;
+		const Entry* entry = find(hash, blob, base);
+		return entry ? entry->original_size : 0u;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	VioletPackSpan VioletAssetPack::GetSpan(uint64_t hash, VioletPackBlob blob) const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		const char* base = nullptr;
+		const Entry* entry = find(hash, blob, base);
+
+		VioletPackSpan span;
+		if (entry && entry->codec == VioletPackCodec::kNone)
+		{
+			span.data = base + entry->offset;
+			span.size = entry->size;
+		}
+		return span;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool VioletAssetPack::Read(uint64_t hash, VioletPackBlob blob, char* destination, size_t size) const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		const char* base = nullptr;
+		const Entry* entry = find(hash, blob, base);
+		if (!entry || entry->original_size != size)
+			return false;
+
+		const char* source = base + entry->offset;
+		switch (entry->codec)
+		{
+		case VioletPackCodec::kNone:
+			memcpy(destination, source, size);
+			return true;
+		case VioletPackCodec::kLZ4:
+			return LZ4_decompress_safe(source, destination, (int)entry->size, (int)size) == (int)size;
+		default:
+			return false;
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	Vector<char> VioletAssetPack::Read(uint64_t hash, VioletPackBlob blob) const
+	{
+		Vector<char> data(GetSize(hash, blob));
+		if (!Read(hash, blob, data.data(), data.size()))
+			LMB_ASSERT(false, "AssetPack: Could not read %llu from %s.", hash, file_.c_str());
+		return data;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void VioletAssetPack::Write(uint64_t hash, VioletPackBlob blob, const char* data, size_t size, VioletPackCodec codec)
+	{
+		Pending pending;
+		pending.removed = false;
+		memset(&pending.entry, 0, sizeof(pending.entry));
+		pending.entry.hash          = hash;
+		pending.entry.original_size = (uint32_t)size;
+		pending.entry.blob          = blob;
+		pending.entry.codec         = VioletPackCodec::kNone;
+
+		// Data that LZ4 barely shrinks, like block compressed textures, is
+		// stored as is so it can be used without a copy.
+		if (codec == VioletPackCodec::kLZ4)
+		{
+			pending.data.resize((size_t)LZ4_compressBound((int)size));
+			const int compressed = LZ4_compress_default(data, pending.data.data(), (int)size, (int)pending.data.size());
+			if (compressed > 0 && (size_t)compressed < size - size / 8u)
+			{
+				pending.data.resize((size_t)compressed);
+				pending.entry.codec = VioletPackCodec::kLZ4;
+			}
+		}
+		if (pending.entry.codec == VioletPackCodec::kNone)
+			pending.data.assign(data, data + size);
+		pending.entry.size = (uint32_t)pending.data.size();
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		pending_[Key(hash, (uint8_t)blob)] = eastl::move(pending);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void VioletAssetPack::Remove(uint64_t hash, VioletPackBlob blob)
+	{
+		Pending pending;
+		memset(&pending.entry, 0, sizeof(pending.entry));
+		pending.entry.hash = hash;
+		pending.entry.blob = blob;
+		pending.removed    = true;
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		pending_[Key(hash, (uint8_t)blob)] = eastl::move(pending);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void VioletAssetPack::Flush()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		append();
+		if (shouldCompact())
+			compact();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void VioletAssetPack::Compact()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		append();
+		compact();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool VioletAssetPack::map()
+	{
+		MappedFile* mapping = foundation::Memory::construct<MappedFile>();
+		if (!mapping->Open(file_))
+		{
+			foundation::Memory::destruct(mapping);
+			return false;
+		}
+
+		const PackHeader* header = (const PackHeader*)mapping->GetData();
+		bool valid = mapping->GetSize() >= sizeof(PackHeader) &&
+			memcmp(header->magic, kPackMagic, sizeof(kPackMagic)) == 0 &&
+			strncmp(header->asset, magic_number_.c_str(), sizeof(header->asset)) == 0 &&
+			header->version == kPackVersion;
+		valid = valid && header->index_offset + (uint64_t)header->entry_count * sizeof(Entry) <= mapping->GetSize();
+
+		if (!valid)
+		{
+			foundation::Error("AssetPack: " + file_ + " is not a valid " + magic_number_ + " pack.\n");
+			foundation::Memory::destruct(mapping);
+			return false;
+		}
+
+		if (mapping_)
+			retired_.push_back(mapping_);
+		mapping_ = mapping;
+		// The header is copied, because the builder rewrites it in place when
+		// it appends to the file.
+		header_  = *header;
+		entries_ = (const Entry*)(mapping->GetData() + header_.index_offset);
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	const VioletAssetPack::Entry* VioletAssetPack::find(uint64_t hash, VioletPackBlob blob, const char*& base) const
+	{
+		auto it = pending_.find(Key(hash, (uint8_t)blob));
+		if (it != pending_.end())
+		{
+			base = it->second.data.data();
+			return it->second.removed ? nullptr : &it->second.entry;
+		}
+
+		if (!mapping_)
+			return nullptr;
+
+		const Entry* end = entries_ + header_.entry_count;
+		const Entry* entry = std::lower_bound(entries_, end, Key(hash, (uint8_t)blob),
+			[](const Entry& lhs, const Key& rhs) {
+				return lhs.hash < rhs.first || (lhs.hash == rhs.first && (uint8_t)lhs.blob < rhs.second);
+			}
+		);
+		if (entry == end || entry->hash != hash || entry->blob != blob)
+			return nullptr;
+
+		base = mapping_->GetData();
+		return entry;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	Vector<VioletAssetPack::Entry> VioletAssetPack::mergeIndex() const
+	{
+		Vector<Entry> index;
+		if (mapping_)
+		{
+			index.reserve(header_.entry_count + pending_.size());
+			for (uint32_t i = 0u; i < header_.entry_count; ++i)
+				if (pending_.find(Key(entries_[i].hash, (uint8_t)entries_[i].blob)) == pending_.end())
+					index.push_back(entries_[i]);
+		}
+		return index;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void VioletAssetPack::append()
+	{
+		if (pending_.empty() || file_.empty())
+			return;
+
+		const bool exists = mapping_ != nullptr;
+		FILE* fp = openFile(file_, exists ? "r+b" : "wb");
+		if (!fp)
+			return;
+
+		PackHeader header;
+		memset(&header, 0, sizeof(header));
+		if (exists)
+			header = header_;
+		else
+		{
+			memcpy(header.magic, kPackMagic, sizeof(kPackMagic));
+			strncpy(header.asset, magic_number_.c_str(), sizeof(header.asset));
+			header.version = kPackVersion;
+			fwrite(&header, sizeof(header), 1u, fp);
+		}
+
+		// The new blobs and index go after everything that is already there,
+		// including the old index, so mappings of the old file stay intact.
+		uint64_t end = exists ? mapping_->GetSize() : sizeof(PackHeader);
+		Vector<Entry> index = mergeIndex();
+		uint64_t live_size = 0u;
+		for (const Entry& entry : index)
+			live_size += entry.size;
+
+		seek(fp, end);
+		for (auto& it : pending_)
+		{
+			if (it.second.removed)
+				continue;
+
+			const uint64_t offset = align(end);
+			writePadding(fp, end, offset);
+			fwrite(it.second.data.data(), 1u, it.second.data.size(), fp);
+			end = offset + it.second.data.size();
+
+			Entry entry = it.second.entry;
+			entry.offset = offset;
+			index.push_back(entry);
+			live_size += entry.size;
+		}
+
+		std::sort(index.begin(), index.end(), [](const Entry& lhs, const Entry& rhs) {
+			return lhs.hash < rhs.hash || (lhs.hash == rhs.hash && lhs.blob < rhs.blob);
+		});
+
+		header.index_offset = align(end);
+		header.entry_count  = (uint32_t)index.size();
+		header.live_size    = live_size;
+		writePadding(fp, end, header.index_offset);
+		fwrite(index.data(), sizeof(Entry), index.size(), fp);
+
+		// The header goes last. Until it is written readers see the old index.
+		seek(fp, 0u);
+		fwrite(&header, sizeof(header), 1u, fp);
+		fclose(fp);
+
+		pending_.clear();
+		map();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void VioletAssetPack::compact()
+	{
+		if (!mapping_)
+			return;
+
+		const String temp_file = file_ + ".tmp";
+		FILE* fp = openFile(temp_file, "wb");
+		if (!fp)
+			return;
+
+		PackHeader header = header_;
+		fwrite(&header, sizeof(header), 1u, fp);
+
+		Vector<Entry> index(entries_, entries_ + header_.entry_count);
+		uint64_t end = sizeof(PackHeader);
+		for (Entry& entry : index)
+		{
+			const uint64_t offset = align(end);
+			writePadding(fp, end, offset);
+			fwrite(mapping_->GetData() + entry.offset, 1u, entry.size, fp);
+			entry.offset = offset;
+			end = offset + entry.size;
+		}
+
+		header.index_offset = align(end);
+		writePadding(fp, end, header.index_offset);
+		fwrite(index.data(), sizeof(Entry), index.size(), fp);
+		seek(fp, 0u);
+		fwrite(&header, sizeof(header), 1u, fp);
+		fclose(fp);
+
+		// Spans into the old file do not survive this.
+		for (MappedFile* mapping : retired_)
+			foundation::Memory::destruct(mapping);
+		foundation::Memory::destruct(mapping_);
+		retired_.clear();
+		mapping_ = nullptr;
+		entries_ = nullptr;
+
+		// Fails while another process has the pack open on some platforms.
+		// The old file is kept then, and compacting is tried again later. The
+		// pack is replaced in one step, so a crash leaves one whole file.
+		const String path      = FileSystem::FullFilePath(file_);
+		const String temp_path = FileSystem::FullFilePath(temp_file);
+#if VIOLET_WIN32
+		if (MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) == FALSE)
+#else
+		if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+#endif
+		{
+			foundation::Warning("AssetPack: Could not compact " + file_ + ".\n");
+			std::remove(temp_path.c_str());
+		}
+
+		map();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool VioletAssetPack::shouldCompact() const
+	{
+		if (!mapping_)
+			return false;
+
+		const uint64_t dead_size = mapping_->GetSize() - header_.live_size;
+		return dead_size > header_.live_size && dead_size > kCompactThreshold;
+	}
+}
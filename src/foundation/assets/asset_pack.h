@@ -0,0 +1,120 @@
+#pragma once
+#include <containers/containers.h>
+#include <utils/mapped_file.h>
+#include <mutex>
+
+namespace lambda
+{
+	enum class VioletPackCodec : uint8_t
+	{
+		kNone = 0u,
+		kLZ4  = 1u,
+	};
+
+	enum class VioletPackBlob : uint8_t
+	{
+		kHeader = 0u,
+		kData   = 1u,
+		// Mip n of a texture is kMip + n, so single mips can be read
+		// without decoding the rest of the chain.
+		kMip    = 2u,
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	struct VioletPackSpan
+	{
+		const char* data = nullptr;
+		size_t      size = 0u;
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// All assets of one type in a single file. The blobs are followed by an
+	// index that is sorted on hash, so a lookup is a binary search through
+	// the mapped file:
+	//
+	//   PackHeader | blob | blob | ... | Entry[entry_count]
+	//
+	// Writes are kept in memory until Flush(), which appends the new blobs
+	// and a new index and then points the header at that index. Blobs that
+	// were replaced stay in the file until it is compacted, so readers that
+	// have the older version mapped are never disturbed.
+	class VioletAssetPack
+	{
+	public:
+		VioletAssetPack();
+		~VioletAssetPack();
+		VioletAssetPack(const VioletAssetPack&) = delete;
+		VioletAssetPack& operator=(const VioletAssetPack&) = delete;
+
+		void Open(const String& file, const String& magic_number);
+		void Close();
+		// Maps the file again if another process has flushed it since. Only
+		// looks at the size and write time of the file when it has not.
+		bool Refresh();
+
+		bool Has(uint64_t hash, VioletPackBlob blob) const;
+		size_t GetSize(uint64_t hash, VioletPackBlob blob) const;
+		// Points straight into the mapped file. Empty when the blob is
+		// compressed. Stays valid until the pack is closed or compacted, or
+		// until Flush() for blobs that were written and not flushed yet.
+		VioletPackSpan GetSpan(uint64_t hash, VioletPackBlob blob) const;
+		// Decodes into the destination, which has to hold GetSize() bytes.
+		bool Read(uint64_t hash, VioletPackBlob blob, char* destination, size_t size) const;
+		Vector<char> Read(uint64_t hash, VioletPackBlob blob) const;
+
+		void Write(uint64_t hash, VioletPackBlob blob, const char* data, size_t size, VioletPackCodec codec);
+		void Remove(uint64_t hash, VioletPackBlob blob);
+		// Appends everything that was written, and compacts the file once
+		// more than half of it is no longer referenced.
+		void Flush();
+		void Compact();
+
+	private:
+		struct PackHeader
+		{
+			char     magic[4];
+			char     asset[4];
+			uint32_t version;
+			uint32_t entry_count;
+			uint64_t index_offset;
+			uint64_t live_size;
+		};
+
+		struct Entry
+		{
+			uint64_t        hash;
+			uint64_t        offset;
+			uint32_t        size;
+			uint32_t        original_size;
+			VioletPackBlob  blob;
+			VioletPackCodec codec;
+			uint8_t         padding[6];
+		};
+
+		struct Pending
+		{
+			Entry        entry;
+			Vector<char> data;
+			bool         removed;
+		};
+		typedef Pair<uint64_t, uint8_t> Key;
+
+		bool map();
+		const Entry* find(uint64_t hash, VioletPackBlob blob, const char*& base) const;
+		Vector<Entry> mergeIndex() const;
+		void append();
+		void compact();
+		bool shouldCompact() const;
+
+		mutable std::mutex mutex_;
+		String             file_;
+		String             magic_number_;
+		MappedFile*        mapping_;
+		// Mappings that were replaced by Refresh(). Spans into them stay
+		// valid until the pack is closed.
+		Vector<MappedFile*> retired_;
+		PackHeader         header_;
+		const Entry*       entries_;
+		Map<Key, Pending>  pending_;
+	};
+}
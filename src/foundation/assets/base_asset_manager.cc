@@ -1,10 +1,26 @@
 #include "base_asset_manager.h"
-#include "utils/file_system.h"
 #include "utils/console.h"
-#include <lz4.h>
 
 namespace lambda
 {
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static thread_local Vector<VioletAssetRecord>* k_records = nullptr;
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void Record(uint64_t hash, VioletPackBlob blob, const Vector<char>* data)
+  {
+    if (!k_records)
+      return;
+
+    VioletAssetRecord record;
+    record.hash    = hash;
+    record.blob    = blob;
+    record.removed = data == nullptr;
+    if (data)
+      record.data = *data;
+    k_records->push_back(eastl::move(record));
+  }
+
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   void VioletBaseAssetManager::SetMagicNumber(String magic_number)
   {
@@ -23,6 +39,24 @@ namespace lambda
 		return eastl::move(LoadData(hash));
 	}
 
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool VioletBaseAssetManager::GetData(uint64_t hash, char* destination, size_t size) const
+	{
+		return pack_.Read(hash, VioletPackBlob::kData, destination, size);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	size_t VioletBaseAssetManager::GetDataSize(uint64_t hash) const
+	{
+		return pack_.GetSize(hash, VioletPackBlob::kData);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	VioletPackSpan VioletBaseAssetManager::GetDataSpan(uint64_t hash) const
+	{
+		return pack_.GetSpan(hash, VioletPackBlob::kData);
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	Vector<char> VioletBaseAssetManager::GetHeader(uint64_t hash) const
 	{
@@ -32,73 +66,112 @@ namespace lambda
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   bool VioletBaseAssetManager::HasHeader(uint64_t hash) const
   {
-    return FileSystem::DoesFileExist(file_path_generated_ + magic_number_ + "_data_" + toString(hash));
+    if (pack_.Has(hash, VioletPackBlob::kHeader))
+      return true;
+    return pack_.Refresh() && pack_.Has(hash, VioletPackBlob::kHeader);
   }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-  void VioletBaseAssetManager::Save() const
+  void VioletBaseAssetManager::Save()
   {
+    pack_.Flush();
   }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   void VioletBaseAssetManager::Load()
   {
+    pack_.Open(file_path_generated_ + magic_number_ + ".pack", magic_number_);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void VioletBaseAssetManager::StartRecording(Vector<VioletAssetRecord>* records)
+  {
+    k_records = records;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void VioletBaseAssetManager::StopRecording()
+  {
+    k_records = nullptr;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void VioletBaseAssetManager::Replay(const Vector<VioletAssetRecord>& records)
+  {
+    for (const VioletAssetRecord& record : records)
+    {
+      if (record.removed)
+        pack_.Remove(record.hash, record.blob);
+      else if (record.blob == VioletPackBlob::kHeader)
+        SaveHeader(record.data, record.hash);
+      else
+        SaveBlob(record.data, record.hash, record.blob);
+    }
   }
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	void VioletBaseAssetManager::SaveData(const Vector<char>& data, uint64_t hash)
 	{
-		Vector<char> compressed_data((uint64_t)LZ4_compressBound((int)data.size()), '\0');
-		compressed_data.resize(LZ4_compress_default(data.data(), compressed_data.data(), (int)data.size(), (int)compressed_data.size()) + sizeof(uint32_t));
-		//int compression = (int)((1.0f - (float)compressed_data.size() / (float)data.size()) * 100.0f);
-		uint32_t size = (uint32_t)data.size();
-		memcpy(compressed_data.end() - sizeof(uint32_t), &size, sizeof(uint32_t));
-
-		FileSystem::WriteFile(file_path_generated_ + magic_number_ + "_data_" + toString(hash), compressed_data.data(), compressed_data.size(), magic_number_.data(), magic_number_.size());
+		Record(hash, VioletPackBlob::kData, &data);
+		pack_.Write(hash, VioletPackBlob::kData, data.data(), data.size(), VioletPackCodec::kLZ4);
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	void VioletBaseAssetManager::SaveHeader(const Vector<char>& data, uint64_t hash)
 	{
-		FileSystem::WriteFile(file_path_generated_ + magic_number_ + "_header_" + toString(hash), data.data(), data.size(), magic_number_.data(), magic_number_.size());
+		Record(hash, VioletPackBlob::kHeader, &data);
+		pack_.Write(hash, VioletPackBlob::kHeader, data.data(), data.size(), VioletPackCodec::kNone);
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	Vector<char> VioletBaseAssetManager::LoadData(uint64_t hash) const
 	{
-		Vector<char> data = FileSystem::FileToVector(file_path_generated_ + magic_number_ + "_data_" + toString(hash), magic_number_.data(), magic_number_.size());
-
-		uint32_t original_size = 0u;
-		memcpy(&original_size, data.end() - sizeof(uint32_t), sizeof(uint32_t));
-
-		int size = LZ4_compressBound((int)original_size);
-		// Decompress the data.
-		Vector<char> decompressed_data(size, '\0');
-		int res = LZ4_decompress_safe(data.data(), decompressed_data.data(), (int)data.size() - sizeof(uint32_t), (int)decompressed_data.size());
-
-		if (res < 0)
-			LMB_ASSERT(false, "AssetManager: Could not decompress the data.");
-		else
-			decompressed_data.resize((uint64_t)res);
-
-		return eastl::move(decompressed_data);
+		return pack_.Read(hash, VioletPackBlob::kData);
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	Vector<char> VioletBaseAssetManager::LoadHeader(uint64_t hash) const
 	{
-		return eastl::move(FileSystem::FileToVector(file_path_generated_ + magic_number_ + "_header_" + toString(hash), magic_number_.data(), magic_number_.size()));
+		return pack_.Read(hash, VioletPackBlob::kHeader);
 	}
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   void VioletBaseAssetManager::RemoveData(uint64_t hash)
   {
-    FileSystem::RemoveFile(file_path_generated_ + magic_number_ + "_data_" + toString(hash));
+    Record(hash, VioletPackBlob::kData, nullptr);
+    pack_.Remove(hash, VioletPackBlob::kData);
   }
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	void VioletBaseAssetManager::RemoveHeader(uint64_t hash)
 	{
-		FileSystem::RemoveFile(file_path_generated_ + magic_number_ + "_header_" + toString(hash));
+		Record(hash, VioletPackBlob::kHeader, nullptr);
+		pack_.Remove(hash, VioletPackBlob::kHeader);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void VioletBaseAssetManager::SaveBlob(const Vector<char>& data, uint64_t hash, VioletPackBlob blob)
+	{
+		Record(hash, blob, &data);
+		pack_.Write(hash, blob, data.data(), data.size(), VioletPackCodec::kLZ4);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool VioletBaseAssetManager::LoadBlob(uint64_t hash, VioletPackBlob blob, char* destination, size_t size) const
+	{
+		return pack_.Read(hash, blob, destination, size);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	size_t VioletBaseAssetManager::GetBlobSize(uint64_t hash, VioletPackBlob blob) const
+	{
+		return pack_.GetSize(hash, blob);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void VioletBaseAssetManager::RemoveBlob(uint64_t hash, VioletPackBlob blob)
+	{
+		Record(hash, blob, nullptr);
+		pack_.Remove(hash, blob);
 	}
 }
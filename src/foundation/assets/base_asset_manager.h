@@ -1,21 +1,46 @@
 #pragma once
 #include <containers/containers.h>
 #include "package/package.h"
+#include "asset_pack.h"
 
 namespace lambda
 {
+  ///////////////////////////////////////////////////////////////////////////
+  // One write to a pack, or a removal, as the build cache stores it. The
+  // data is not compressed.
+  struct VioletAssetRecord
+  {
+    uint64_t       hash    = 0u;
+    VioletPackBlob blob    = VioletPackBlob::kHeader;
+    bool           removed = false;
+    Vector<char>   data;
+  };
+
   class VioletBaseAssetManager
   {
   public: // Not virtuals
     void SetMagicNumber(String magic_number);
     void SetGeneratedFilePath(String file_path);
 	Vector<char> GetData(uint64_t hash) const;
+	// Decodes straight into the destination, which holds GetDataSize() bytes.
+	bool GetData(uint64_t hash, char* destination, size_t size) const;
+	size_t GetDataSize(uint64_t hash) const;
+	// Empty when the data is compressed in the pack. See VioletAssetPack.
+	VioletPackSpan GetDataSpan(uint64_t hash) const;
 	Vector<char> GetHeader(uint64_t hash) const;
 	bool HasHeader(uint64_t hash) const;
 
-    void Save() const;
+    // Writes everything that was added or removed to the pack.
+    void Save();
     void Load();
 
+    // Adds every write and removal that this thread makes to any pack to
+    // the records, until it stops. The builder caches what a compile did
+    // this way, and replays it on a cache hit.
+    static void StartRecording(Vector<VioletAssetRecord>* records);
+    static void StopRecording();
+    void Replay(const Vector<VioletAssetRecord>& records);
+
   protected:
     void SaveData(const Vector<char>& data, uint64_t hash);
 	void SaveHeader(const Vector<char>& data, uint64_t hash);
@@ -23,9 +48,17 @@ namespace lambda
 	Vector<char> LoadHeader(uint64_t index) const;
 	void RemoveData(uint64_t hash);
 	void RemoveHeader(uint64_t hash);
+	// For assets that store their data in more than one blob.
+	void SaveBlob(const Vector<char>& data, uint64_t hash, VioletPackBlob blob);
+	bool LoadBlob(uint64_t hash, VioletPackBlob blob, char* destination, size_t size) const;
+	size_t GetBlobSize(uint64_t hash, VioletPackBlob blob) const;
+	void RemoveBlob(uint64_t hash, VioletPackBlob blob);
 
   private:
     String file_path_generated_;
     String magic_number_;
+    // Refreshed on lookups that miss, to pick up what the builder added.
+    // That only maps it again when the file changed.
+    mutable VioletAssetPack pack_;
   };
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
 
 namespace lambda
@@ -94,28 +95,21 @@ namespace lambda
       bpr = bpp * w;
       bpl = bpr * h;
       break;
+    // Rows and layers are counted in whole 4x4 blocks.
     case TextureFormat::kBC1:
-    case TextureFormat::kBC5:
+    case TextureFormat::kBC4:
       bpp = 1; // BPP is not really usable in this case.
-      bpr = (w + 3u) / 4u * 8u;
-      if (bpr < 8u)
-        bpr = 8u;
-      bpl = w * h / 2u;
-      if (bpl < 8u)
-        bpl = 8u;
+      bpr = std::max(1u, (w + 3u) / 4u) * 8u;
+      bpl = bpr * std::max(1u, (h + 3u) / 4u);
       break;
     case TextureFormat::kBC2:
     case TextureFormat::kBC3:
-    case TextureFormat::kBC4:
+    case TextureFormat::kBC5:
     case TextureFormat::kBC6:
     case TextureFormat::kBC7:
       bpp = 1; // BPP is not really usable in this case.
-      bpr = (w + 3u) / 4u * 16u;
-      if (bpr < 16u)
-        bpr = 16u;
-      bpl = w * h;
-      if (bpl < 16u)
-        bpl = 16u;
+      bpr = std::max(1u, (w + 3u) / 4u) * 16u;
+      bpl = bpr * std::max(1u, (h + 3u) / 4u);
       break;
     }
   }
@@ -3,11 +3,18 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 #include <utils/console.h>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace lambda
 {
-	static constexpr char kMagicHeader[] = { 'L', 'M', 'B' };
+	// Meshes from before the streams had an encoding are still read.
+	static constexpr char kMagicHeader[] = { 'L', 'M', 'E' };
+	static constexpr char kRawMagicHeader[] = { 'L', 'M', 'B' };
 	static constexpr char kInvalidHeader[] = { 'I', 'N', 'V' };
+	// A quarter of a texel of a 1024 texture.
+	static constexpr float kMaxHalfError = 1.0f / 4096.0f;
 
 	struct VioletDataHeader
 	{
@@ -24,6 +31,10 @@ namespace lambda
 	{
 		size_t model_count;
 	};
+	struct VioletLODHeader
+	{
+		size_t lod_count;
+	};
 	struct VioletTextureHeader
 	{
 		size_t alb_count;
@@ -44,6 +55,8 @@ namespace lambda
 	}
 	void writeHeader(Vector<char>& data, const VioletDataInfo& info)
 	{
+		write(data, (uint8_t)info.encoding);
+
 		VioletDataHeader header;
 		header.data_size = info.data.size();
 		header.segment_count = info.segments.size();
@@ -71,6 +84,15 @@ namespace lambda
 			write(data, (const char*)&mesh, sizeof(VioletSubMesh));
 		}
 	}
+	void writeHeader(Vector<char>& data, const Vector<VioletSubMeshLOD>& lods)
+	{
+		VioletLODHeader header;
+		header.lod_count = lods.size();
+		write(data, header);
+
+		for (const VioletSubMeshLOD& lod : lods)
+			write(data, lod);
+	}
 	void writeHeader(Vector<char>& data, const Vector<String>& alb, const Vector<String>& nrm, const Vector<String>& dmra, const Vector<String>& emi)
 	{
 		VioletTextureHeader header;
@@ -125,6 +147,7 @@ namespace lambda
 		writeHeader(data, mesh.data.idx);
 		writeHeader(data, mesh.data.tex_alb, mesh.data.tex_nrm, mesh.data.tex_dmra, mesh.data.tex_emi);
 		writeHeader(data, mesh.meshes);
+		writeHeader(data, mesh.data.lods);
 
 		finalizeWriting(data);
 		return eastl::move(data);
@@ -147,8 +170,16 @@ namespace lambda
 	{
 		read(data, offset, (char*)&t, sizeof(T));
 	}
-	void readHeader(const Vector<char>& data, size_t& offset, VioletDataInfo& info)
+	bool readHeader(const Vector<char>& data, size_t& offset, VioletDataInfo& info, bool has_encoding)
 	{
+		uint8_t encoding = (uint8_t)VioletStreamEncoding::kRaw;
+		if (has_encoding)
+			read(data, offset, encoding);
+		// Newer than this build, or not a mesh at all.
+		if (encoding > (uint8_t)VioletStreamEncoding::kIndex16)
+			return false;
+		info.encoding = (VioletStreamEncoding)encoding;
+
 		VioletDataHeader header;
 		read(data, offset, header);
 
@@ -167,6 +198,7 @@ namespace lambda
 
 			info.segments.push_back(segment);
 		}
+		return true;
 	}
 	void readHeader(const Vector<char>& data, size_t& offset, Vector<VioletSubMesh>& meshes)
 	{
@@ -180,6 +212,18 @@ namespace lambda
 			meshes.push_back(mesh);
 		}
 	}
+	void readHeader(const Vector<char>& data, size_t& offset, Vector<VioletSubMeshLOD>& lods)
+	{
+		VioletLODHeader header;
+		read(data, offset, header);
+
+		for (size_t i = 0; i < header.lod_count; ++i)
+		{
+			VioletSubMeshLOD lod;
+			read(data, offset, lod);
+			lods.push_back(lod);
+		}
+	}
 	void readHeader(const Vector<char>& data, size_t& offset, Vector<String>& alb, Vector<String>& nrm, Vector<String>& dmra, Vector<String>& emi)
 	{
 		VioletTextureHeader header;
@@ -222,35 +266,233 @@ namespace lambda
 		}
 	}
 
-	bool validateFile(const Vector<char>& data, size_t& offset)
+	bool validateFile(const Vector<char>& data, size_t& offset, bool& has_encoding)
 	{
+		if (data.size() < 3)
+			return false;
+
 		char magic_header[3];
 		read(data, offset, magic_header, 3);
 
-		return magic_header[0] == kMagicHeader[0] &&
-			   magic_header[1] == kMagicHeader[1] &&
-			   magic_header[2] == kMagicHeader[2];
+		has_encoding = memcmp(magic_header, kMagicHeader, 3) == 0;
+		return has_encoding || memcmp(magic_header, kRawMagicHeader, 3) == 0;
+	}
+
+	static float signNotZero(float value)
+	{
+		return value < 0.0f ? -1.0f : 1.0f;
+	}
+	static int16_t toSnorm16(float value)
+	{
+		return (int16_t)std::round(std::min(1.0f, std::max(-1.0f, value)) * 32767.0f);
+	}
+	static float fromSnorm16(int16_t value)
+	{
+		return std::max(-1.0f, (float)value / 32767.0f);
+	}
+	// Projects the direction on an octahedron and folds the lower half
+	// over the upper one, so it fits in a square.
+	static void encodeOctahedral(const float* direction, int16_t* encoded)
+	{
+		const float length = std::abs(direction[0]) + std::abs(direction[1]) + std::abs(direction[2]);
+		float x = length > 0.0f ? direction[0] / length : 0.0f;
+		float y = length > 0.0f ? direction[1] / length : 0.0f;
+		if (direction[2] < 0.0f)
+		{
+			const float folded_x = (1.0f - std::abs(y)) * signNotZero(x);
+			y = (1.0f - std::abs(x)) * signNotZero(y);
+			x = folded_x;
+		}
+		encoded[0] = toSnorm16(x);
+		encoded[1] = toSnorm16(y);
+	}
+	static void decodeOctahedral(const int16_t* encoded, float* direction)
+	{
+		float x = fromSnorm16(encoded[0]);
+		float y = fromSnorm16(encoded[1]);
+		const float z = 1.0f - std::abs(x) - std::abs(y);
+		if (z < 0.0f)
+		{
+			const float folded_x = (1.0f - std::abs(y)) * signNotZero(x);
+			y = (1.0f - std::abs(x)) * signNotZero(y);
+			x = folded_x;
+		}
+		const float length = std::sqrt(x * x + y * y + z * z);
+		direction[0] = x / length;
+		direction[1] = y / length;
+		direction[2] = z / length;
+	}
+
+	static bool encodeElement(VioletStreamEncoding encoding, const unsigned char* raw, unsigned char* encoded)
+	{
+		switch (encoding)
+		{
+		case VioletStreamEncoding::kOctahedral:
+		{
+			float normal[3];
+			memcpy(normal, raw, sizeof(normal));
+			int16_t octahedral[2];
+			encodeOctahedral(normal, octahedral);
+			memcpy(encoded, octahedral, sizeof(octahedral));
+			return true;
+		}
+		case VioletStreamEncoding::kOctahedralSign:
+		{
+			float tangent[4];
+			memcpy(tangent, raw, sizeof(tangent));
+			int16_t octahedral[3];
+			encodeOctahedral(tangent, octahedral);
+			octahedral[2] = tangent[3] < 0.0f ? -32767 : 32767;
+			memcpy(encoded, octahedral, sizeof(octahedral));
+			return true;
+		}
+		case VioletStreamEncoding::kHalf:
+		{
+			float uv[2];
+			memcpy(uv, raw, sizeof(uv));
+			uint16_t half[2];
+			for (int i = 0; i < 2; ++i)
+			{
+				half[i] = glm::packHalf1x16(uv[i]);
+				if (!(std::abs(glm::unpackHalf1x16(half[i]) - uv[i]) <= kMaxHalfError))
+					return false;
+			}
+			memcpy(encoded, half, sizeof(half));
+			return true;
+		}
+		case VioletStreamEncoding::kUnorm8:
+		{
+			float colour[4];
+			memcpy(colour, raw, sizeof(colour));
+			for (int i = 0; i < 4; ++i)
+			{
+				if (!(colour[i] >= 0.0f && colour[i] <= 1.0f))
+					return false;
+				encoded[i] = (unsigned char)std::round(colour[i] * 255.0f);
+			}
+			return true;
+		}
+		case VioletStreamEncoding::kIndex16:
+		{
+			uint32_t index;
+			memcpy(&index, raw, sizeof(index));
+			if (index > 0xffffu)
+				return false;
+			const uint16_t narrow = (uint16_t)index;
+			memcpy(encoded, &narrow, sizeof(narrow));
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+	static void decodeElement(VioletStreamEncoding encoding, const unsigned char* encoded, unsigned char* raw)
+	{
+		switch (encoding)
+		{
+		case VioletStreamEncoding::kOctahedral:
+		{
+			int16_t octahedral[2];
+			memcpy(octahedral, encoded, sizeof(octahedral));
+			float normal[3];
+			decodeOctahedral(octahedral, normal);
+			memcpy(raw, normal, sizeof(normal));
+			break;
+		}
+		case VioletStreamEncoding::kOctahedralSign:
+		{
+			int16_t octahedral[3];
+			memcpy(octahedral, encoded, sizeof(octahedral));
+			float tangent[4];
+			decodeOctahedral(octahedral, tangent);
+			tangent[3] = octahedral[2] < 0 ? -1.0f : 1.0f;
+			memcpy(raw, tangent, sizeof(tangent));
+			break;
+		}
+		case VioletStreamEncoding::kHalf:
+		{
+			uint16_t half[2];
+			memcpy(half, encoded, sizeof(half));
+			const float uv[2] = { glm::unpackHalf1x16(half[0]), glm::unpackHalf1x16(half[1]) };
+			memcpy(raw, uv, sizeof(uv));
+			break;
+		}
+		case VioletStreamEncoding::kUnorm8:
+		{
+			float colour[4];
+			for (int i = 0; i < 4; ++i)
+				colour[i] = encoded[i] / 255.0f;
+			memcpy(raw, colour, sizeof(colour));
+			break;
+		}
+		case VioletStreamEncoding::kIndex16:
+		{
+			uint16_t narrow;
+			memcpy(&narrow, encoded, sizeof(narrow));
+			const uint32_t index = narrow;
+			memcpy(raw, &index, sizeof(index));
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	static void decodeStream(VioletDataInfo& info)
+	{
+		if (info.encoding == VioletStreamEncoding::kRaw)
+			return;
+
+		const size_t encoded_size = VioletMeshManager::GetEncodedSize(info.encoding);
+		const size_t decoded_size = VioletMeshManager::GetDecodedSize(info.encoding);
+		const size_t count = info.data.size() / encoded_size;
+
+		Vector<unsigned char> decoded(count * decoded_size);
+		for (size_t i = 0; i < count; ++i)
+			decodeElement(info.encoding, info.data.data() + i * encoded_size, decoded.data() + i * decoded_size);
+
+		info.data = eastl::move(decoded);
+		info.encoding = VioletStreamEncoding::kRaw;
 	}
 
 	void read(VioletMesh& mesh, const Vector<char>& data)
 	{
 		size_t offset = 0;
-		if (!validateFile(data, offset))
+		bool has_encoding = false;
+		if (!validateFile(data, offset, has_encoding))
 		{
 			foundation::Error("[MESH] Failed to load mesh\n");
 			return;
 		}
 
-		readHeader(data, offset, mesh.data.pos);
-		readHeader(data, offset, mesh.data.nor);
-		readHeader(data, offset, mesh.data.tan);
-		readHeader(data, offset, mesh.data.col);
-		readHeader(data, offset, mesh.data.tex);
-		readHeader(data, offset, mesh.data.joi);
-		readHeader(data, offset, mesh.data.wei);
-		readHeader(data, offset, mesh.data.idx);
+		const bool known_encodings =
+			readHeader(data, offset, mesh.data.pos, has_encoding) &&
+			readHeader(data, offset, mesh.data.nor, has_encoding) &&
+			readHeader(data, offset, mesh.data.tan, has_encoding) &&
+			readHeader(data, offset, mesh.data.col, has_encoding) &&
+			readHeader(data, offset, mesh.data.tex, has_encoding) &&
+			readHeader(data, offset, mesh.data.joi, has_encoding) &&
+			readHeader(data, offset, mesh.data.wei, has_encoding) &&
+			readHeader(data, offset, mesh.data.idx, has_encoding);
+		if (!known_encodings)
+		{
+			foundation::Error("[MESH] Failed to load mesh, a stream has an unknown encoding\n");
+			return;
+		}
 		readHeader(data, offset, mesh.data.tex_alb, mesh.data.tex_nrm, mesh.data.tex_dmra, mesh.data.tex_emi);
 		readHeader(data, offset, mesh.meshes);
+		// Meshes without LODs from before they were generated end here.
+		if (has_encoding && offset < data.size())
+			readHeader(data, offset, mesh.data.lods);
+
+		decodeStream(mesh.data.pos);
+		decodeStream(mesh.data.nor);
+		decodeStream(mesh.data.tan);
+		decodeStream(mesh.data.col);
+		decodeStream(mesh.data.tex);
+		decodeStream(mesh.data.joi);
+		decodeStream(mesh.data.wei);
+		decodeStream(mesh.data.idx);
 	}
 
 
@@ -307,6 +549,65 @@ namespace lambda
 		RemoveHeader(hash);
   }
 
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool VioletMeshManager::EncodeStream(VioletDataInfo& info, VioletStreamEncoding encoding)
+  {
+    if (info.encoding != VioletStreamEncoding::kRaw || encoding == VioletStreamEncoding::kRaw || info.data.empty())
+      return false;
+
+    // The elements are stored back to back, so the segments have to be
+    // too for their offsets to still mean something after decoding.
+    const size_t encoded_size = GetEncodedSize(encoding);
+    const size_t decoded_size = GetDecodedSize(encoding);
+    size_t offset = 0u;
+    for (const VioletDataSegment& segment : info.segments)
+    {
+      if (segment.stride != decoded_size || segment.offset != offset)
+        return false;
+      offset += segment.count * segment.stride;
+    }
+    if (offset != info.data.size())
+      return false;
+
+    const size_t count = info.data.size() / decoded_size;
+    Vector<unsigned char> encoded(count * encoded_size);
+    for (size_t i = 0u; i < count; ++i)
+      if (!encodeElement(encoding, info.data.data() + i * decoded_size, encoded.data() + i * encoded_size))
+        return false;
+
+    info.data = eastl::move(encoded);
+    info.encoding = encoding;
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  size_t VioletMeshManager::GetEncodedSize(VioletStreamEncoding encoding)
+  {
+    switch (encoding)
+    {
+    case VioletStreamEncoding::kOctahedral:     return 2u * sizeof(int16_t);
+    case VioletStreamEncoding::kOctahedralSign: return 3u * sizeof(int16_t);
+    case VioletStreamEncoding::kHalf:           return 2u * sizeof(uint16_t);
+    case VioletStreamEncoding::kUnorm8:         return 4u * sizeof(uint8_t);
+    case VioletStreamEncoding::kIndex16:        return sizeof(uint16_t);
+    default:                                    return 1u;
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  size_t VioletMeshManager::GetDecodedSize(VioletStreamEncoding encoding)
+  {
+    switch (encoding)
+    {
+    case VioletStreamEncoding::kOctahedral:     return 3u * sizeof(float);
+    case VioletStreamEncoding::kOctahedralSign: return 4u * sizeof(float);
+    case VioletStreamEncoding::kHalf:           return 2u * sizeof(float);
+    case VioletStreamEncoding::kUnorm8:         return 4u * sizeof(float);
+    case VioletStreamEncoding::kIndex16:        return sizeof(uint32_t);
+    default:                                    return 1u;
+    }
+  }
+
   extern String rapidjsonErrortoString(rapidjson::ParseErrorCode error);
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
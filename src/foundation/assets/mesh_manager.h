@@ -13,10 +13,23 @@ namespace lambda
 		size_t count;
 		size_t stride;
 	};
+	// How the elements of a stream are stored in the packs. The segments
+	// always describe the raw floats and uint32 indices, which is also
+	// what GetMesh hands out, as the data is decoded when it is read.
+	enum class VioletStreamEncoding : uint8_t
+	{
+		kRaw,
+		kOctahedral,     // vec3 normals as two snorm16.
+		kOctahedralSign, // vec4 tangents as two snorm16 and the handedness.
+		kHalf,           // vec2 as two half floats.
+		kUnorm8,         // vec4 colours in [0, 1] as four unorm8.
+		kIndex16,        // uint32 indices below 65536 as uint16.
+	};
 	struct VioletDataInfo
 	{
 		Vector<unsigned char> data;
 		Vector<VioletDataSegment> segments;
+		VioletStreamEncoding encoding = VioletStreamEncoding::kRaw;
 	};
 	struct VioletSubMesh
 	{
@@ -50,6 +63,15 @@ namespace lambda
 		glm::vec3 emissiveness = glm::vec3(0.0f);
 		glm::vec4 colour = glm::vec4(1.0f);
 	};
+	// A simplified version of a sub mesh, drawn with its own indices
+	// into the same vertices.
+	struct VioletSubMeshLOD
+	{
+		int sub_mesh = -1;
+		int idx = -1;
+		// How far the surface moved at most, in the units of the sub mesh.
+		float error = 0.0f;
+	};
 	struct VioletMeshData
 	{
 		VioletDataInfo pos;
@@ -64,6 +86,8 @@ namespace lambda
 		Vector<String> tex_nrm;
 		Vector<String> tex_dmra;
 		Vector<String> tex_emi;
+		// Finest first for every sub mesh.
+		Vector<VioletSubMeshLOD> lods;
 	};
 	struct VioletMesh
 	{
@@ -84,6 +108,13 @@ namespace lambda
 		VioletMesh GetMesh(uint64_t hash, bool get_data = false);
 		void RemoveMesh(uint64_t hash);
 
+		// Stores a raw stream with the encoding. Returns false and leaves it
+		// raw when the stream does not hold what the encoding expects, or
+		// when the values would not survive it.
+		static bool EncodeStream(VioletDataInfo& info, VioletStreamEncoding encoding);
+		static size_t GetEncodedSize(VioletStreamEncoding encoding);
+		static size_t GetDecodedSize(VioletStreamEncoding encoding);
+
 	private:
 		VioletMesh JSonToMeshHeader(Vector<char> json);
 		Vector<char> MeshHeaderToJSon(VioletMesh mesh);
@@ -65,7 +65,16 @@ namespace lambda
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	void VioletShaderManager::getBlobs(VioletShader& shader_program)
 	{
-		Vector<char> data = GetData(shader_program.hash);
+		// Uncompressed blobs are copied straight out of the pack.
+		Vector<char> decoded;
+		VioletPackSpan data = GetDataSpan(shader_program.hash);
+		if (!data.data)
+		{
+			decoded   = GetData(shader_program.hash);
+			data.data = decoded.data();
+			data.size = decoded.size();
+		}
+
 		for (uint32_t l = 0; l < VIOLET_LANG_COUNT; ++l)
 		{
 			for (uint32_t s = 0; s < (uint32_t)ShaderStages::kCount; ++s)
@@ -73,7 +82,7 @@ namespace lambda
 				shader_program.blobs[s][l].resize(shader_program.blob_sizes[s][l].second);
 				memcpy(
 					shader_program.blobs[s][l].data(),
-					data.data() + shader_program.blob_sizes[s][l].first,
+					data.data + shader_program.blob_sizes[s][l].first,
 					shader_program.blob_sizes[s][l].second
 				);
 			}
@@ -3,9 +3,16 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 #include <utils/console.h>
+#include <algorithm>
 
 namespace lambda
 {
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static VioletPackBlob MipBlob(uint16_t mip)
+  {
+    return (VioletPackBlob)((uint8_t)VioletPackBlob::kMip + mip);
+  }
+
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   VioletTextureManager::VioletTextureManager()
   {
@@ -23,8 +30,39 @@ namespace lambda
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   void VioletTextureManager::AddTexture(VioletTexture texture)
   {
+    // Mip blobs of an older version that had more mips would linger.
+    if (HasHeader(texture.hash))
+    {
+      const VioletTexture previous = JSonToTextureHeader(GetHeader(texture.hash));
+      if ((previous.flags & kTextureFlagMipBlobs))
+        for (uint16_t mip = 0u; mip < previous.mip_count; ++mip)
+          RemoveBlob(texture.hash, MipBlob(mip));
+    }
+
+    size_t chain_size = 0u;
+    for (uint16_t mip = 0u; mip < texture.mip_count; ++mip)
+      chain_size += GetMipSize(texture, mip);
+
+    // Formats that GetMipSize() does not know are stored in one piece.
+    if (texture.mip_count > 1u && chain_size == texture.data.size())
+    {
+      texture.flags |= kTextureFlagMipBlobs;
+      size_t offset = 0u;
+      for (uint16_t mip = 0u; mip < texture.mip_count; ++mip)
+      {
+        const size_t size = GetMipSize(texture, mip);
+        SaveBlob(Vector<char>(texture.data.begin() + offset, texture.data.begin() + offset + size), texture.hash, MipBlob(mip));
+        offset += size;
+      }
+      RemoveData(texture.hash);
+    }
+    else
+    {
+      texture.flags &= ~kTextureFlagMipBlobs;
+      SaveData(texture.data, texture.hash);
+    }
+
     SaveHeader(TextureHeaderToJSon(texture), texture.hash);
-    SaveData(texture.data, texture.hash);
   }
   
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -32,17 +70,79 @@ namespace lambda
   {
     VioletTexture texture = JSonToTextureHeader(GetHeader(hash));
     if (get_data)
-      texture.data = GetData(hash);
+    {
+      if ((texture.flags & kTextureFlagMipBlobs))
+        texture.data = GetMips(texture, 0u, texture.mip_count);
+      else
+        texture.data = GetData(hash);
+    }
     return texture;
   }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   void VioletTextureManager::RemoveTexture(uint64_t hash)
   {
+    if (HasHeader(hash))
+    {
+      const VioletTexture texture = JSonToTextureHeader(GetHeader(hash));
+      if ((texture.flags & kTextureFlagMipBlobs))
+        for (uint16_t mip = 0u; mip < texture.mip_count; ++mip)
+          RemoveBlob(hash, MipBlob(mip));
+    }
 		RemoveData(hash);
 		RemoveHeader(hash);
   }
 
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  Vector<char> VioletTextureManager::GetMips(const VioletTexture& texture, uint16_t first_mip, uint16_t last_mip)
+  {
+    size_t offset = 0u;
+    size_t size   = 0u;
+    for (uint16_t mip = 0u; mip < last_mip; ++mip)
+    {
+      if (mip < first_mip)
+        offset += GetMipSize(texture, mip);
+      else
+        size += GetMipSize(texture, mip);
+    }
+
+    Vector<char> data(size);
+    if ((texture.flags & kTextureFlagMipBlobs))
+    {
+      char* destination = data.data();
+      for (uint16_t mip = first_mip; mip < last_mip; ++mip)
+      {
+        const size_t mip_size = GetMipSize(texture, mip);
+        if (!LoadBlob(texture.hash, MipBlob(mip), destination, mip_size))
+          return Vector<char>();
+        destination += mip_size;
+      }
+      return data;
+    }
+
+    // Textures that were stored in one piece have to be read in full.
+    const Vector<char> chain = GetData(texture.hash);
+    if (chain.size() < offset + size)
+      return Vector<char>();
+    memcpy(data.data(), chain.data() + offset, size);
+    return data;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  size_t VioletTextureManager::GetMipSize(const VioletTexture& texture, uint16_t mip)
+  {
+    uint32_t bpp, bpr, bpl;
+    calculateImageMemory(
+      texture.format,
+      (uint16_t)std::max(1, texture.width >> mip),
+      (uint16_t)std::max(1, texture.height >> mip),
+      bpp,
+      bpr,
+      bpl
+    );
+    return bpl;
+  }
+
   String rapidjsonErrortoString(rapidjson::ParseErrorCode error)
   {
     switch (error)
@@ -25,6 +25,8 @@ namespace lambda
   static constexpr uint32_t kTextureFlagFromDDS        = 1u << 6u;
   static constexpr uint32_t kTextureFlagContainsAlpha  = 1u << 7u;
   static constexpr uint32_t kTextureFlagResize         = 1u << 8u;
+  // Every mip is stored in a blob of its own. See GetMips().
+  static constexpr uint32_t kTextureFlagMipBlobs       = 1u << 9u;
 
   class VioletTextureManager : public VioletBaseAssetManager
   {
@@ -36,6 +38,10 @@ namespace lambda
     void AddTexture(VioletTexture texture);
     VioletTexture GetTexture(uint64_t hash, bool get_data = false);
     void RemoveTexture(uint64_t hash);
+    // The data of mips [first_mip, last_mip), finest first. Only those
+    // mips are read when the texture is stored one blob per mip.
+    Vector<char> GetMips(const VioletTexture& texture, uint16_t first_mip, uint16_t last_mip);
+    static size_t GetMipSize(const VioletTexture& texture, uint16_t mip);
 
   private:
     VioletTexture JSonToTextureHeader(Vector<char> json);
@@ -1,5 +1,6 @@
 #include "frame_heap.h"
 #include "memory.h"
+#include "pointer_arithmetic.h"
 #include <algorithm>
 
 namespace lambda
@@ -7,103 +8,249 @@ namespace lambda
   namespace foundation
   {
     FrameHeap* FrameHeap::s_frame_heap_ = nullptr;
-    
-    
+    constexpr uint32_t FrameHeap::kHeapCount;
+    constexpr uint32_t FrameHeap::kHistoryCount;
+    constexpr uint32_t FrameHeap::kChunkSize;
+    constexpr uint32_t FrameHeap::kDefaultAlignment;
+
+    ///////////////////////////////////////////////////////////////////////////
+    struct FrameHeap::Chunk
+    {
+      uint32_t size;
+      // Only written by the thread that owns the chunk this frame.
+      std::atomic<uint32_t> used;
+      char* data;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    struct ThreadArena
+    {
+      uint32_t heap   = 0u;
+      uint64_t frame  = 0u;
+      FrameHeap::Chunk* chunk = nullptr;
+      char* cursor    = nullptr;
+      char* end       = nullptr;
+    };
+    static thread_local ThreadArena k_arena;
+
+    static constexpr uint32_t kChunkHeaderSize = 64u;
+    static std::atomic<uint32_t> k_heap_id = { 0u };
+
+    ///////////////////////////////////////////////////////////////////////////
+    static FrameHeap::Chunk* createChunk(uint32_t size)
+    {
+      void* memory = Memory::allocate(kChunkHeaderSize + size, kChunkHeaderSize);
+      FrameHeap::Chunk* chunk = new (memory) FrameHeap::Chunk();
+      chunk->size = size;
+      chunk->used.store(0u, std::memory_order_relaxed);
+      chunk->data = (char*)memory + kChunkHeaderSize;
+      return chunk;
+    }
+
+
     FrameHeap::FrameHeap() :
-      current_frame_heap_(0u)
+      id_(++k_heap_id)
+      , frame_(0u)
       , current_history_(0u)
-      , allocated_(0u)
+      , reserved_chunks_(0u)
+      , frame_overflows_(0u)
     {
 			mutex_.lock();
-			memset(frame_heaps_, 0, sizeof(frame_heaps_));
-			memset(heap_sizes_, 0, sizeof(heap_sizes_));
 			memset(size_history_, 0, sizeof(size_history_));
+			memset(chunk_history_, 0, sizeof(chunk_history_));
 			mutex_.unlock();
 		}
 		FrameHeap::~FrameHeap()
 		{
 			mutex_.lock();
-			for (const auto& frame_heap : frame_heaps_)
-				foundation::Memory::deallocate(frame_heap);
+			for (auto& frame_chunks : frame_chunks_)
+			{
+				for (Chunk* chunk : frame_chunks)
+					releaseChunk(chunk);
+				frame_chunks.clear();
+			}
 
-			for (const auto& temp_allocs : temp_allocs_)
-				for (const auto& alloc : temp_allocs)
-					foundation::Memory::deallocate(alloc);
+			for (Chunk* chunk : free_chunks_)
+				releaseChunk(chunk);
+			free_chunks_.clear();
 			mutex_.unlock();
 		}
     void FrameHeap::update()
     {
 			mutex_.lock();
-			// Calculate the size of this alloc.
-      size_history_[current_history_] = allocated_;
-      
+			uint64_t frame = frame_.load(std::memory_order_relaxed);
+			uint32_t current_frame_heap = (uint32_t)(frame % kHeapCount);
+
+			// Calculate the size of this frame.
+			uint32_t allocated = 0u;
+			for (Chunk* chunk : frame_chunks_[current_frame_heap])
+				allocated += chunk->used.load(std::memory_order_relaxed);
+      size_history_[current_history_]  = allocated;
+      chunk_history_[current_history_] = (uint32_t)frame_chunks_[current_frame_heap].size();
+
       // Calculate the largest size in history.
-      uint32_t size = 0u;
+      uint32_t size   = 0u;
+      uint32_t chunks = 0u;
       for (uint32_t i = 0u; i < kHistoryCount; ++i)
       {
-        if (size_history_[i] > size)
-        {
-          size = size_history_[i];
-        }
+        size   = std::max(size,   size_history_[i]);
+        chunks = std::max(chunks, chunk_history_[i]);
       }
-      // Reset the state.
-      allocated_ = 0u;
-      current_frame_heap_ = (current_frame_heap_ + 1u) % kHeapCount;
-      current_history_    = (current_history_    + 1u) % kHistoryCount;
 
-      // Create the new alloc for the next frame.
-      if (heap_sizes_[current_frame_heap_] != size)
+			statistics_.frame                = frame;
+			statistics_.last_frame_bytes     = allocated;
+			statistics_.peak_frame_bytes     = size;
+			statistics_.all_time_peak_bytes  = std::max(statistics_.all_time_peak_bytes, allocated);
+			statistics_.last_frame_overflows = frame_overflows_;
+			frame_overflows_ = 0u;
+
+      // Advance. Threads notice the new frame on their next alloc and grab a new chunk.
+      current_history_ = (current_history_ + 1u) % kHistoryCount;
+      frame_.store(frame + 1u, std::memory_order_release);
+      uint32_t next_frame_heap = (uint32_t)((frame + 1u) % kHeapCount);
+
+      // The chunks of this slot were handed out kHeapCount frames ago. Recycle them.
+      for (Chunk* chunk : frame_chunks_[next_frame_heap])
+      {
+        if (chunk->size == kChunkSize)
+          free_chunks_.push_back(chunk);
+        else
+          releaseChunk(chunk);
+      }
+      frame_chunks_[next_frame_heap].resize(0u);
+
+      // Do not hold on to more chunks than the history says we need, or
+      // than were reserved.
+      uint32_t in_use = 0u;
+      for (const auto& frame_chunks : frame_chunks_)
+        in_use += (uint32_t)frame_chunks.size();
+      uint32_t keep = std::max(chunks * kHeapCount, reserved_chunks_);
+      while (!free_chunks_.empty() && in_use + free_chunks_.size() > keep)
       {
-        if (frame_heaps_[current_frame_heap_] != nullptr)
-					foundation::Memory::deallocate(frame_heaps_[current_frame_heap_]);
-        heap_sizes_[current_frame_heap_] = size;
-        frame_heaps_[current_frame_heap_] = foundation::Memory::allocate(size);
+        releaseChunk(free_chunks_.back());
+        free_chunks_.pop_back();
       }
-      
-      // Remove the previous temporary allocs.
-      for (const auto& temp_alloc : temp_allocs_[current_frame_heap_])
-				foundation::Memory::deallocate(temp_alloc);
-      temp_allocs_[current_frame_heap_].resize(0u);
 			mutex_.unlock();
     }
-    void* FrameHeap::alloc(uint32_t size)
+    void* FrameHeap::alloc(uint32_t size, uint32_t alignment, bool zero)
     {
-			mutex_.lock();
-			if (allocated_ + size <= heap_sizes_[current_frame_heap_])
-      {
-        void* data = (char*)frame_heaps_[current_frame_heap_] + allocated_;
-        allocated_ += size;
-				mutex_.unlock();
-				memset(data, 0, size);
-				return data;
-      }
-      else
-      {
-				allocated_ += size;
-        temp_allocs_[current_frame_heap_].push_back(foundation::Memory::allocate(size));
-        void* data = temp_allocs_[current_frame_heap_].back();
-				mutex_.unlock();
-				memset(data, 0, size);
-				return data;
+			ThreadArena& arena = k_arena;
+
+			// Fast path. Bump through the chunk this thread owns for this frame.
+			if (arena.heap == id_ && arena.frame == frame_.load(std::memory_order_acquire))
+			{
+				char* data = (char*)alignUp(arena.cursor, alignment);
+				if (data + size <= arena.end)
+				{
+					arena.cursor = data + size;
+					arena.chunk->used.store((uint32_t)(arena.cursor - arena.chunk->data), std::memory_order_relaxed);
+					if (zero)
+						memset(data, 0, size);
+					return data;
+				}
 			}
+
+			void* data = allocSlow(size, alignment);
+			if (zero)
+				memset(data, 0, size);
+			return data;
     }
-		void* FrameHeap::realloc(void* prev, uint32_t prev_size, uint32_t new_size)
+		void* FrameHeap::realloc(void* prev, uint32_t prev_size, uint32_t new_size, uint32_t alignment)
 		{
 			if (!new_size)
 				return nullptr;
 
-			void* mem = alloc(new_size);
-			memcpy(mem, prev, std::min(prev_size, new_size));
+			void* mem = alloc(new_size, alignment, false);
+			uint32_t copy_size = std::min(prev_size, new_size);
+			memcpy(mem, prev, copy_size);
+			memset((char*)mem + copy_size, 0, new_size - copy_size);
 			return mem;
 		}
+		void FrameHeap::reserve(uint32_t size)
+		{
+			mutex_.lock();
+			uint32_t chunk_count = (size + kChunkSize - 1u) / kChunkSize;
+			reserved_chunks_ = std::max(reserved_chunks_, chunk_count);
+			while (free_chunks_.size() < chunk_count)
+			{
+				Chunk* chunk = createChunk(kChunkSize);
+				statistics_.reserved_bytes += chunk->size;
+				statistics_.chunk_count++;
+				free_chunks_.push_back(chunk);
+			}
+			mutex_.unlock();
+		}
     uint32_t FrameHeap::currentHeapSize()
     {
 			mutex_.lock();
-			uint32_t heap_size = heap_sizes_[current_frame_heap_];
+			uint32_t heap_size = 0u;
+			for (Chunk* chunk : frame_chunks_[frame_.load() % kHeapCount])
+				heap_size += chunk->size;
 			mutex_.unlock();
 
 			return heap_size;
     }
+    FrameHeapStatistics FrameHeap::getStatistics()
+    {
+			mutex_.lock();
+			FrameHeapStatistics statistics = statistics_;
+			mutex_.unlock();
+
+			return statistics;
+    }
+    void* FrameHeap::allocSlow(uint32_t size, uint32_t alignment)
+    {
+			// Either this thread has not allocated this frame yet or its chunk is full.
+			uint32_t chunk_size = std::max(kChunkSize, size + alignment);
+
+			mutex_.lock();
+			uint64_t frame = frame_.load(std::memory_order_relaxed);
+			Chunk* chunk = acquireChunk(chunk_size);
+			frame_chunks_[frame % kHeapCount].push_back(chunk);
+			mutex_.unlock();
+
+			char* data = (char*)alignUp(chunk->data, alignment);
+			chunk->used.store((uint32_t)(data + size - chunk->data), std::memory_order_relaxed);
+
+			// Oversized chunks are not worth bumping through.
+			if (chunk_size == kChunkSize)
+			{
+				k_arena.heap   = id_;
+				k_arena.frame  = frame;
+				k_arena.chunk  = chunk;
+				k_arena.cursor = data + size;
+				k_arena.end    = chunk->data + chunk->size;
+			}
+
+			return data;
+    }
+    FrameHeap::Chunk* FrameHeap::acquireChunk(uint32_t size)
+    {
+			if (size == kChunkSize && !free_chunks_.empty())
+			{
+				Chunk* chunk = free_chunks_.back();
+				free_chunks_.pop_back();
+				chunk->used.store(0u, std::memory_order_relaxed);
+				return chunk;
+			}
+
+			Chunk* chunk = createChunk(size);
+			statistics_.reserved_bytes += size;
+			statistics_.chunk_count++;
+			statistics_.total_overflows++;
+			frame_overflows_++;
+			if (size != kChunkSize)
+				statistics_.oversized_allocations++;
+
+			return chunk;
+    }
+    void FrameHeap::releaseChunk(Chunk* chunk)
+    {
+			statistics_.reserved_bytes -= chunk->size;
+			statistics_.chunk_count--;
+			chunk->~Chunk();
+			Memory::deallocate(chunk);
+    }
     FrameHeap* GetFrameHeap()
     {
       if (FrameHeap::s_frame_heap_ == nullptr)
@@ -111,4 +258,4 @@ namespace lambda
       return FrameHeap::s_frame_heap_;
     }
   }
-}
\ No newline at end of file
+}
@@ -1,22 +1,51 @@
 #include <containers/containers.h>
+#include <atomic>
 #include <mutex>
 
 namespace lambda
 {
   namespace foundation
   {
+    struct FrameHeapStatistics
+    {
+      uint64_t frame                   = 0u;
+      // Bytes handed out during the last completed frame.
+      uint32_t last_frame_bytes        = 0u;
+      // Highest last_frame_bytes over the history window and ever.
+      uint32_t peak_frame_bytes        = 0u;
+      uint32_t all_time_peak_bytes     = 0u;
+      // Bytes held in chunks, whether they are in use or not.
+      uint32_t reserved_bytes          = 0u;
+      uint32_t chunk_count             = 0u;
+      // Chunks that could not be recycled and had to be allocated.
+      uint32_t last_frame_overflows    = 0u;
+      uint32_t total_overflows         = 0u;
+      // Allocations that did not fit in a regular chunk.
+      uint32_t oversized_allocations   = 0u;
+    };
+
+    // Memory that lives for kHeapCount frames. Every thread bumps through
+    // its own chunk, so allocating does not lock. Chunks are recycled once
+    // the frame they were handed out in has expired.
     class FrameHeap
     {
     public:
       friend FrameHeap* GetFrameHeap();
-      static constexpr uint32_t kHeapCount    = 5u;
-      static constexpr uint32_t kHistoryCount = 10u;
+      static constexpr uint32_t kHeapCount        = 5u;
+      static constexpr uint32_t kHistoryCount     = 10u;
+      static constexpr uint32_t kChunkSize        = 64u * 1024u;
+      static constexpr uint32_t kDefaultAlignment = 16u;
+
+      struct Chunk;
 
 			FrameHeap();
 			~FrameHeap();
       void update();
-      void* alloc(uint32_t size);
-			void* realloc(void* prev, uint32_t prev_size, uint32_t new_size);
+      void* alloc(uint32_t size, uint32_t alignment = kDefaultAlignment, bool zero = true);
+			void* realloc(void* prev, uint32_t prev_size, uint32_t new_size, uint32_t alignment = kDefaultAlignment);
+			// Makes sure there are enough chunks for the given amount of bytes,
+			// and keeps at least that many when trimming.
+			void reserve(uint32_t size);
 			template<typename T>
 			inline void deconstruct(T* t)
 			{
@@ -25,29 +54,39 @@ namespace lambda
       template<typename T>
       inline T* construct()
       {
-        T* allocated = reinterpret_cast<T*>(alloc(sizeof(T)));
+        T* allocated = reinterpret_cast<T*>(alloc(sizeof(T), alignof(T) > kDefaultAlignment ? alignof(T) : kDefaultAlignment, false));
         new (allocated) T();
         return allocated;
       }
       template<typename T, typename ...Args>
       inline T* construct(Args&& ...args)
       {
-        T* allocated = reinterpret_cast<T*>(alloc(sizeof(T)));
+        T* allocated = reinterpret_cast<T*>(alloc(sizeof(T), alignof(T) > kDefaultAlignment ? alignof(T) : kDefaultAlignment, false));
         new (allocated) T(eastl::forward<Args>(args)...);
         return allocated;
       }
 
       uint32_t currentHeapSize();
+      FrameHeapStatistics getStatistics();
 
     private:
-      uint32_t current_frame_heap_;
+      Chunk* acquireChunk(uint32_t size);
+      void releaseChunk(Chunk* chunk);
+      void* allocSlow(uint32_t size, uint32_t alignment);
+
+      // Unique per heap so thread arenas never outlive the heap they point into.
+      const uint32_t id_;
+      std::atomic<uint64_t> frame_;
       uint32_t current_history_;
 
-      uint32_t allocated_;
-      void*    frame_heaps_[kHeapCount];
-      uint32_t heap_sizes_[kHeapCount];
+      // Everything below is only touched while holding the mutex.
+      Vector<Chunk*> free_chunks_;
+      Vector<Chunk*> frame_chunks_[kHeapCount];
       uint32_t size_history_[kHistoryCount];
-      Vector<void*> temp_allocs_[kHeapCount];
+      uint32_t chunk_history_[kHistoryCount];
+      uint32_t reserved_chunks_;
+      uint32_t frame_overflows_;
+      FrameHeapStatistics statistics_;
 			std::mutex mutex_;
 
     protected:
@@ -56,4 +95,4 @@ namespace lambda
 
     extern FrameHeap* GetFrameHeap();
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,180 @@
+#include "mapped_file.h"
+#include "file_system.h"
+#include "console.h"
+
+#if VIOLET_WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lambda
+{
+#if VIOLET_WIN32
+	///////////////////////////////////////////////////////////////////////////
+	static uint64_t toWriteTime(const FILETIME& time)
+	{
+		return ((uint64_t)time.dwHighDateTime << 32ull) | (uint64_t)time.dwLowDateTime;
+	}
+#else
+	///////////////////////////////////////////////////////////////////////////
+	static uint64_t toWriteTime(const struct stat& info)
+	{
+#if VIOLET_OSX
+		return (uint64_t)info.st_mtimespec.tv_sec * 1000000000ull + (uint64_t)info.st_mtimespec.tv_nsec;
+#else
+		return (uint64_t)info.st_mtim.tv_sec * 1000000000ull + (uint64_t)info.st_mtim.tv_nsec;
+#endif
+	}
+#endif
+
+	///////////////////////////////////////////////////////////////////////////
+	MappedFile::MappedFile()
+		: data_(nullptr)
+		, size_(0u)
+		, write_time_(0u)
+#if VIOLET_WIN32
+		, file_(INVALID_HANDLE_VALUE)
+		, mapping_(nullptr)
+#else
+		, file_(-1)
+#endif
+	{
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool MappedFile::Open(const String& file)
+	{
+		Close();
+		const String path = FileSystem::FullFilePath(file);
+
+#if VIOLET_WIN32
+		file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		FILETIME write_time;
+		if (GetFileTime(file_, nullptr, nullptr, &write_time))
+			write_time_ = toWriteTime(write_time);
+
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+		if (!mapping_)
+		{
+			Close();
+			return false;
+		}
+
+		data_ = (const char*)MapViewOfFile(mapping_, FILE_MAP_READ, 0u, 0u, 0u);
+		size_ = (size_t)size.QuadPart;
+#else
+		file_ = open(path.c_str(), O_RDONLY);
+		if (file_ < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(file_, &info) != 0 || info.st_size == 0)
+		{
+			Close();
+			return false;
+		}
+
+		write_time_ = toWriteTime(info);
+		void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, file_, 0);
+		data_ = (data == MAP_FAILED) ? nullptr : (const char*)data;
+		size_ = (size_t)info.st_size;
+#endif
+
+		if (!data_)
+		{
+			foundation::Error("FILE SYSTEM: Could not map file: " + path + ".\n");
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	void MappedFile::Close()
+	{
+#if VIOLET_WIN32
+		if (data_)
+			UnmapViewOfFile(data_);
+		if (mapping_)
+			CloseHandle(mapping_);
+		if (file_ != INVALID_HANDLE_VALUE)
+			CloseHandle(file_);
+		mapping_ = nullptr;
+		file_    = INVALID_HANDLE_VALUE;
+#else
+		if (data_)
+			munmap((void*)data_, size_);
+		if (file_ >= 0)
+			close(file_);
+		file_ = -1;
+#endif
+		data_       = nullptr;
+		size_       = 0u;
+		write_time_ = 0u;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool MappedFile::IsOpen() const
+	{
+		return data_ != nullptr;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	const char* MappedFile::GetData() const
+	{
+		return data_;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	size_t MappedFile::GetSize() const
+	{
+		return size_;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	uint64_t MappedFile::GetWriteTime() const
+	{
+		return write_time_;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	bool MappedFile::GetInfo(const String& file, uint64_t& size, uint64_t& write_time)
+	{
+		const String path = FileSystem::FullFilePath(file);
+#if VIOLET_WIN32
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+			return false;
+		size       = ((uint64_t)data.nFileSizeHigh << 32ull) | (uint64_t)data.nFileSizeLow;
+		write_time = toWriteTime(data.ftLastWriteTime);
+#else
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0)
+			return false;
+		size       = (uint64_t)info.st_size;
+		write_time = toWriteTime(info);
+#endif
+		return true;
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "containers/containers.h"
+
+namespace lambda
+{
+	///////////////////////////////////////////////////////////////////////////
+	// Maps a whole file read-only into memory. The pages are loaded by the
+	// OS when they are first touched, so opening a large file is cheap.
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const String& file);
+		void Close();
+
+		bool IsOpen() const;
+		const char* GetData() const;
+		size_t GetSize() const;
+		// When the file was last written to before it was mapped.
+		uint64_t GetWriteTime() const;
+
+		// The size and last write time of a file, without mapping it. False
+		// if the file can not be found.
+		static bool GetInfo(const String& file, uint64_t& size, uint64_t& write_time);
+
+	private:
+		const char* data_;
+		size_t      size_;
+		uint64_t    write_time_;
+#if VIOLET_WIN32
+		void* file_;
+		void* mapping_;
+#else
+		int file_;
+#endif
+	};
+}
@@ -1,34 +1,315 @@
 #include "utils/profiler.h"
+#include "utils/file_system.h"
+#include "utils/console.h"
+#include "memory/memory.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 
 namespace lambda
 {
 	namespace utilities
 	{
+		///////////////////////////////////////////////////////////////////////////
+		namespace
+		{
+			struct ThreadBuffer
+			{
+				// Written by the owning thread only. Published with release so the
+				// events before it can be read by the thread that writes the trace.
+				std::atomic<uint64_t> head;
+				uint64_t     capture_begin;
+				uint32_t     id;
+				char         name[32];
+				ProfileEvent events[ProfileCapture::kEventCount];
+			};
+
+			std::atomic<ThreadBuffer*> k_threads[ProfileCapture::kThreadCount] = {};
+			std::atomic<uint32_t>      k_thread_count(0u);
+			uint64_t                   k_capture_start = 0u;
+
+			thread_local ThreadBuffer* k_thread = nullptr;
+			thread_local bool          k_thread_full = false;
+			thread_local char          k_thread_name[32] = {};
+
+			///////////////////////////////////////////////////////////////////////////
+			uint64_t now()
+			{
+				return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::high_resolution_clock::now().time_since_epoch()
+				).count();
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			ThreadBuffer* getThreadBuffer()
+			{
+				if (k_thread || k_thread_full)
+					return k_thread;
+
+				const uint32_t id = k_thread_count.fetch_add(1u, std::memory_order_relaxed);
+				if (id >= ProfileCapture::kThreadCount)
+				{
+					k_thread_full = true;
+					return nullptr;
+				}
+
+				ThreadBuffer* buffer = foundation::Memory::construct<ThreadBuffer>();
+				buffer->head.store(0u, std::memory_order_relaxed);
+				buffer->capture_begin = 0u;
+				buffer->id = id;
+				if (k_thread_name[0])
+					memcpy(buffer->name, k_thread_name, sizeof(buffer->name));
+				else
+					snprintf(buffer->name, sizeof(buffer->name), "Thread %u", id);
+
+				k_threads[id].store(buffer, std::memory_order_release);
+				k_thread = buffer;
+				return buffer;
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void appendEscaped(String& json, const char* text)
+			{
+				for (; *text; ++text)
+				{
+					if (*text == '"' || *text == '\\')
+						json += '\\';
+					json += *text;
+				}
+			}
+
+			///////////////////////////////////////////////////////////////////////////
+			void appendEvent(String& json, const char* name, const char* phase, uint64_t time, uint32_t tid, const char* extra)
+			{
+				char buffer[128];
+				json += json.back() == '[' ? "\n{" : ",\n{";
+				if (name)
+				{
+					json += "\"name\":\"";
+					appendEscaped(json, name);
+					json += "\",";
+				}
+				const double ts = (double)(time > k_capture_start ? time - k_capture_start : 0u) / 1000.0;
+				snprintf(buffer, sizeof(buffer), "\"ph\":\"%s\",\"ts\":%.3f,\"pid\":0,\"tid\":%u%s}", phase, ts, tid, extra);
+				json += buffer;
+			}
+		}
+
+		std::atomic<bool> ProfileCapture::k_capturing(false);
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::start()
+		{
+			// Threads that already have a buffer start the capture where they are
+			// now. Buffers made during the capture start at zero.
+			const uint32_t count = k_thread_count.load(std::memory_order_acquire);
+			for (uint32_t i = 0u; i < count && i < kThreadCount; ++i)
+			{
+				ThreadBuffer* buffer = k_threads[i].load(std::memory_order_acquire);
+				if (buffer)
+					buffer->capture_begin = buffer->head.load(std::memory_order_acquire);
+			}
+
+			k_capture_start = now();
+			k_capturing.store(true, std::memory_order_release);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::stop()
+		{
+			k_capturing.store(false, std::memory_order_release);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		bool ProfileCapture::isCapturing()
+		{
+			return k_capturing.load(std::memory_order_relaxed);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::record(const ProfileZone* zone, ProfileEventType type, int64_t value)
+		{
+			if (!k_capturing.load(std::memory_order_relaxed))
+				return;
+
+			ThreadBuffer* buffer = getThreadBuffer();
+			if (!buffer)
+				return;
+
+			const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+			ProfileEvent& event = buffer->events[head & (kEventCount - 1u)];
+			event.zone  = zone;
+			event.time  = now();
+			event.value = value;
+			event.type  = type;
+			buffer->head.store(head + 1u, std::memory_order_release);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::begin(const ProfileZone& zone)
+		{
+			record(&zone, ProfileEventType::kBegin, 0);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::end(const ProfileZone& zone)
+		{
+			record(&zone, ProfileEventType::kEnd, 0);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::counter(const ProfileZone& zone, int64_t value)
+		{
+			record(&zone, ProfileEventType::kCounter, value);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::frame()
+		{
+			record(nullptr, ProfileEventType::kFrame, 0);
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::setThreadName(const char* name)
+		{
+			snprintf(k_thread_name, sizeof(k_thread_name), "%s", name);
+			if (k_thread)
+				memcpy(k_thread->name, k_thread_name, sizeof(k_thread->name));
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		String ProfileCapture::toChromeTrace()
+		{
+			LMB_ASSERT(!isCapturing(), "PROFILER: Stop the capture before writing it");
+
+			String json = "{\"traceEvents\":[";
+			char extra[64];
+
+			const uint32_t count = k_thread_count.load(std::memory_order_acquire);
+			for (uint32_t i = 0u; i < count && i < kThreadCount; ++i)
+			{
+				const ThreadBuffer* buffer = k_threads[i].load(std::memory_order_acquire);
+				if (!buffer)
+					continue;
+
+				snprintf(extra, sizeof(extra), "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,", buffer->id);
+				json += json.back() == '[' ? "\n{" : ",\n{";
+				json += extra;
+				json += "\"args\":{\"name\":\"";
+				appendEscaped(json, buffer->name);
+				json += "\"}}";
+
+				// A thread can still be in the middle of the event it started before
+				// the capture stopped, so the slot after head is never read.
+				const uint64_t head  = buffer->head.load(std::memory_order_acquire);
+				uint64_t       first = buffer->capture_begin;
+				if (head - first > kEventCount - 1u)
+					first = head - (kEventCount - 1u);
+
+				// Ends of zones that began before the window would unbalance the
+				// trace, so they are dropped. Zones still open are closed at the end.
+				uint32_t depth = 0u;
+				uint64_t last_time = 0u;
+				for (uint64_t j = first; j < head; ++j)
+				{
+					const ProfileEvent& event = buffer->events[j & (kEventCount - 1u)];
+					last_time = event.time;
+					switch (event.type)
+					{
+					case ProfileEventType::kBegin:
+						appendEvent(json, event.zone->name, "B", event.time, buffer->id, "");
+						depth++;
+						break;
+					case ProfileEventType::kEnd:
+						if (depth == 0u)
+							break;
+						appendEvent(json, nullptr, "E", event.time, buffer->id, "");
+						depth--;
+						break;
+					case ProfileEventType::kCounter:
+						snprintf(extra, sizeof(extra), ",\"args\":{\"value\":%lld}", (long long)event.value);
+						appendEvent(json, event.zone->name, "C", event.time, buffer->id, extra);
+						break;
+					case ProfileEventType::kFrame:
+						appendEvent(json, "Frame", "i", event.time, buffer->id, ",\"s\":\"g\"");
+						break;
+					}
+				}
+				for (; depth > 0u; --depth)
+					appendEvent(json, nullptr, "E", last_time, buffer->id, "");
+			}
+
+			json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+			return json;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void ProfileCapture::writeChromeTrace(const String& path)
+		{
+			const String json = toChromeTrace();
+			FileSystem::WriteFile(path, json.data(), json.size());
+		}
+
 		///////////////////////////////////////////////////////////////////////////
 		Profiler::~Profiler()
 		{
 		}
 
 		///////////////////////////////////////////////////////////////////////////
-		void Profiler::startTimer(String name)
+		Profiler::Entry* Profiler::find(const char* name)
 		{
-			timers_[name].reset();
+			const uint64_t hash = profileHash(name);
+			for (uint32_t i = 0u; i < entry_count_; ++i)
+				if (entries_[i].zone.hash == hash)
+					return &entries_[i];
+			return nullptr;
 		}
 
 		///////////////////////////////////////////////////////////////////////////
-		void Profiler::endTimer(String name)
+		const Profiler::Entry* Profiler::find(const char* name) const
 		{
-			values_[name] = timers_[name].elapsed().milliseconds();
+			const uint64_t hash = profileHash(name);
+			for (uint32_t i = 0u; i < entry_count_; ++i)
+				if (entries_[i].zone.hash == hash)
+					return &entries_[i];
+			return nullptr;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void Profiler::startTimer(const char* name)
+		{
+			Entry* entry = find(name);
+			if (!entry)
+			{
+				LMB_ASSERT(entry_count_ < kMaxTimers, "PROFILER: Too many timers");
+				entry = &entries_[entry_count_++];
+				entry->zone = { name, __FILE__, __LINE__, profileHash(name) };
+			}
+
+			entry->timer.reset();
+#if defined VIOLET_PROFILER
+			ProfileCapture::begin(entry->zone);
+#endif
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		void Profiler::endTimer(const char* name)
+		{
+			Entry* entry = find(name);
+			if (!entry)
+				return;
+
+			entry->value = entry->timer.elapsed().milliseconds();
+#if defined VIOLET_PROFILER
+			ProfileCapture::end(entry->zone);
+#endif
 		}
 
 		///////////////////////////////////////////////////////////////////////////
-		double Profiler::getTime(String name) const
+		double Profiler::getTime(const char* name) const
 		{
-			auto it = values_.find(name);
-			if (it == values_.end())
-				return 0.0;
-			else
-				return it->second;
+			const Entry* entry = find(name);
+			return entry ? entry->value : 0.0;
 		}
 	}
-}
\ No newline at end of file
+}
@@ -1,22 +1,150 @@
 #pragma once
 #include "containers/containers.h"
 #include "utils/timer.h"
+#include <atomic>
+
+// Zones, counters and frame markers are only recorded when the build defines
+// VIOLET_PROFILER. Without it the macros below expand to nothing.
+#if defined VIOLET_PROFILER
+#define LMB_PROFILE_CONCAT_(a, b) a##b
+#define LMB_PROFILE_CONCAT(a, b) LMB_PROFILE_CONCAT_(a, b)
+#define LMB_PROFILE_SCOPE(name) \
+	static const lambda::utilities::ProfileZone LMB_PROFILE_CONCAT(lmb_profile_zone_, __LINE__) = { name, __FILE__, __LINE__, lambda::utilities::profileHash(name) }; \
+	lambda::utilities::ProfileScope LMB_PROFILE_CONCAT(lmb_profile_scope_, __LINE__)(LMB_PROFILE_CONCAT(lmb_profile_zone_, __LINE__))
+#define LMB_PROFILE_COUNTER(name, value) \
+	do { \
+		static const lambda::utilities::ProfileZone lmb_profile_counter = { name, __FILE__, __LINE__, lambda::utilities::profileHash(name) }; \
+		lambda::utilities::ProfileCapture::counter(lmb_profile_counter, (int64_t)(value)); \
+	} while (false)
+#define LMB_PROFILE_FRAME() lambda::utilities::ProfileCapture::frame()
+#define LMB_PROFILE_THREAD(name) lambda::utilities::ProfileCapture::setThreadName(name)
+#else
+#define LMB_PROFILE_SCOPE(name)
+#define LMB_PROFILE_COUNTER(name, value) do {} while (false)
+#define LMB_PROFILE_FRAME() do {} while (false)
+#define LMB_PROFILE_THREAD(name) do {} while (false)
+#endif
 
 namespace lambda
 {
 	namespace utilities
 	{
+		///////////////////////////////////////////////////////////////////////////
+		// FNV-1a. Folds to a constant for string literals.
+		constexpr uint64_t profileHash(const char* name)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			while (*name)
+			{
+				hash ^= (uint64_t)(unsigned char)*name++;
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// Describes a place in the code that is measured. Lives in static
+		// storage, so events only have to refer to it.
+		struct ProfileZone
+		{
+			const char* name;
+			const char* file;
+			uint32_t    line;
+			uint64_t    hash;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		enum class ProfileEventType : uint8_t
+		{
+			kBegin,
+			kEnd,
+			kCounter,
+			kFrame
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		struct ProfileEvent
+		{
+			const ProfileZone* zone;
+			uint64_t           time;
+			int64_t            value;
+			ProfileEventType   type;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// Every thread records into a ring buffer of its own, so recording takes
+		// no locks. Events are only recorded during a capture. A capture keeps
+		// the last kEventCount events of every thread.
+		class ProfileCapture
+		{
+		public:
+			static constexpr uint32_t kEventCount  = 1u << 16u;
+			static constexpr uint32_t kThreadCount = 64u;
+
+			static void start();
+			static void stop();
+			static bool isCapturing();
+
+			// Writes what was captured as Chrome trace JSON, which can be opened
+			// in chrome://tracing and Perfetto. Stop the capture first.
+			static String toChromeTrace();
+			static void writeChromeTrace(const String& path);
+
+			static void begin(const ProfileZone& zone);
+			static void end(const ProfileZone& zone);
+			static void counter(const ProfileZone& zone, int64_t value);
+			static void frame();
+			static void setThreadName(const char* name);
+
+		private:
+			static void record(const ProfileZone* zone, ProfileEventType type, int64_t value);
+			static std::atomic<bool> k_capturing;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		class ProfileScope
+		{
+		public:
+			ProfileScope(const ProfileZone& zone)
+				: zone_(zone)
+			{
+				ProfileCapture::begin(zone_);
+			}
+			~ProfileScope()
+			{
+				ProfileCapture::end(zone_);
+			}
+
+		private:
+			const ProfileZone& zone_;
+		};
+
+		///////////////////////////////////////////////////////////////////////////
+		// Times the phases of a frame and keeps the last duration of each, for
+		// overlays that show them. Names have to outlive the profiler, which is
+		// what string literals do. Every timer is also a zone when captured.
 		class Profiler
 		{
 		public:
 			~Profiler();
-			void startTimer(String name);
-			void endTimer(String name);
-			double getTime(String name) const;
-		
+			void startTimer(const char* name);
+			void endTimer(const char* name);
+			double getTime(const char* name) const;
+
 		private:
-			UnorderedMap<String, Timer> timers_;
-			UnorderedMap<String, double> values_;
+			struct Entry
+			{
+				ProfileZone zone;
+				Timer       timer;
+				double      value = 0.0;
+			};
+
+			Entry* find(const char* name);
+			const Entry* find(const char* name) const;
+
+			static constexpr uint32_t kMaxTimers = 32u;
+			Entry    entries_[kMaxTimers];
+			uint32_t entry_count_ = 0u;
 		};
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,226 @@
+#include "link_emulator.h"
+#include <utils/console.h>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static constexpr uint32_t kNoRoute = ~0u;
+  // How long the thread waits for the clients before it looks at the
+  // server and the delayed datagrams again. Adds up to this much to
+  // what the server sends.
+  static constexpr uint32_t kWaitMs = 1u;
+  // Hundreds of clients that all send at once overflow the defaults.
+  static constexpr int kSocketBufferSize = 4 * 1024 * 1024;
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static uint64_t getKey(const ENetAddress& address)
+  {
+    return ((uint64_t)address.host << 16u) | (uint64_t)address.port;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool LinkConditions::isPerfect() const
+  {
+    return loss <= 0.0f && latency_ms == 0u && jitter_ms == 0u;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  LinkEmulator::~LinkEmulator()
+  {
+    stop();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  bool LinkEmulator::start(uint16_t port, uint16_t server_port, const LinkConditions& conditions, uint32_t seed)
+  {
+    if (thread_.joinable())
+      return false;
+
+    ENetAddress address;
+    enet_address_set_host(&address, "127.0.0.1");
+    address.port = port;
+    socket_ = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+    if (socket_ == ENET_SOCKET_NULL || enet_socket_bind(socket_, &address) < 0)
+    {
+      LMB_LOG_ERR("[LINK] Could not listen on port %u.", port);
+      if (socket_ != ENET_SOCKET_NULL)
+        enet_socket_destroy(socket_);
+      socket_ = ENET_SOCKET_NULL;
+      return false;
+    }
+    enet_socket_set_option(socket_, ENET_SOCKOPT_NONBLOCK, 1);
+    enet_socket_set_option(socket_, ENET_SOCKOPT_RCVBUF, kSocketBufferSize);
+    enet_socket_set_option(socket_, ENET_SOCKOPT_SNDBUF, kSocketBufferSize);
+
+    server_      = address;
+    server_.port = server_port;
+    conditions_  = conditions;
+    random_.seed(seed);
+    forwarded_ = 0u;
+    dropped_   = 0u;
+    running_   = true;
+    thread_    = std::thread(&LinkEmulator::run, this);
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void LinkEmulator::stop()
+  {
+    if (!thread_.joinable())
+      return;
+
+    running_ = false;
+    thread_.join();
+
+    for (const Route& route : routes_)
+      enet_socket_destroy(route.socket);
+    routes_.clear();
+    route_of_client_.clear();
+    while (!delays_.empty())
+      delays_.pop();
+    datagrams_.clear();
+    free_slots_.clear();
+    enet_socket_destroy(socket_);
+    socket_ = ENET_SOCKET_NULL;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  uint64_t LinkEmulator::getForwarded() const
+  {
+    return forwarded_;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  uint64_t LinkEmulator::getDropped() const
+  {
+    return dropped_;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void LinkEmulator::run()
+  {
+    while (running_)
+    {
+      // Select can not take more than 64 sockets on Windows, so only the
+      // one of the clients is waited on and the others are polled.
+      enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE;
+      enet_socket_wait(socket_, &condition, kWaitMs);
+      receiveFromClients();
+      for (uint32_t route = 0u; route < (uint32_t)routes_.size(); ++route)
+        receiveFromServer(route);
+
+      const Clock::time_point now = Clock::now();
+      while (!delays_.empty() && delays_.top().due <= now)
+      {
+        const uint32_t slot = delays_.top().slot;
+        delays_.pop();
+        const Datagram& datagram = datagrams_[slot];
+        send(datagram.socket, datagram.to, datagram.data.data(), datagram.data.size());
+        free_slots_.push_back(slot);
+      }
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void LinkEmulator::receiveFromClients()
+  {
+    uint8_t data[ENET_PROTOCOL_MAXIMUM_MTU];
+    ENetBuffer buffer;
+    buffer.data       = data;
+    buffer.dataLength = sizeof(data);
+    ENetAddress from;
+    int size = 0;
+    while ((size = enet_socket_receive(socket_, &from, &buffer, 1u)) > 0)
+    {
+      const uint32_t route = findRoute(from);
+      if (route != kNoRoute)
+        forward(routes_[route].socket, server_, data, (size_t)size);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void LinkEmulator::receiveFromServer(uint32_t route)
+  {
+    uint8_t data[ENET_PROTOCOL_MAXIMUM_MTU];
+    ENetBuffer buffer;
+    buffer.data       = data;
+    buffer.dataLength = sizeof(data);
+    ENetAddress from;
+    int size = 0;
+    while ((size = enet_socket_receive(routes_[route].socket, &from, &buffer, 1u)) > 0)
+      forward(socket_, routes_[route].client, data, (size_t)size);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void LinkEmulator::forward(ENetSocket socket, const ENetAddress& to, const uint8_t* data, size_t size)
+  {
+    if (conditions_.loss > 0.0f && std::uniform_real_distribution<float>(0.0f, 1.0f)(random_) < conditions_.loss)
+    {
+      dropped_++;
+      return;
+    }
+
+    uint32_t delay = conditions_.latency_ms;
+    if (conditions_.jitter_ms > 0u)
+      delay += std::uniform_int_distribution<uint32_t>(0u, conditions_.jitter_ms)(random_);
+    if (delay == 0u)
+    {
+      send(socket, to, data, size);
+      return;
+    }
+
+    uint32_t slot = (uint32_t)datagrams_.size();
+    if (!free_slots_.empty())
+    {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    else
+      datagrams_.push_back(Datagram());
+
+    Datagram& datagram = datagrams_[slot];
+    datagram.socket = socket;
+    datagram.to     = to;
+    datagram.data.assign(data, data + size);
+    delays_.push({ Clock::now() + std::chrono::milliseconds(delay), slot });
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void LinkEmulator::send(ENetSocket socket, const ENetAddress& to, const uint8_t* data, size_t size)
+  {
+    ENetBuffer buffer;
+    buffer.data       = (void*)data;
+    buffer.dataLength = size;
+    if (enet_socket_send(socket, &to, &buffer, 1u) > 0)
+      forwarded_++;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  uint32_t LinkEmulator::findRoute(const ENetAddress& client)
+  {
+    const uint64_t key = getKey(client);
+    auto it = route_of_client_.find(key);
+    if (it != route_of_client_.end())
+      return it->second;
+
+    ENetAddress address;
+    enet_address_set_host(&address, "127.0.0.1");
+    address.port = 0u;
+    Route route;
+    route.client = client;
+    route.socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+    if (route.socket == ENET_SOCKET_NULL || enet_socket_bind(route.socket, &address) < 0)
+    {
+      LMB_LOG_ERR("[LINK] Could not open a socket for a client.");
+      if (route.socket != ENET_SOCKET_NULL)
+        enet_socket_destroy(route.socket);
+      return kNoRoute;
+    }
+    enet_socket_set_option(route.socket, ENET_SOCKOPT_NONBLOCK, 1);
+    enet_socket_set_option(route.socket, ENET_SOCKOPT_RCVBUF, kSocketBufferSize);
+
+    routes_.push_back(route);
+    route_of_client_.insert(eastl::make_pair(key, (uint32_t)routes_.size() - 1u));
+    return (uint32_t)routes_.size() - 1u;
+  }
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <containers/containers.h>
+#include <enet/enet.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // What happens to every datagram, in either direction.
+  struct LinkConditions
+  {
+    // The chance that a datagram is dropped, from 0 to 1.
+    float    loss       = 0.0f;
+    // How much later a datagram arrives, one way.
+    uint32_t latency_ms = 0u;
+    // Up to this much later still, at random, so datagrams can overtake
+    // each other.
+    uint32_t jitter_ms  = 0u;
+
+    bool isPerfect() const;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // A UDP relay on 127.0.0.1 that loses and delays datagrams. Clients
+  // connect to its port instead of the server's. Every client address it
+  // sees gets a socket of its own towards the server, so the server
+  // still tells the clients apart. Runs on a thread of its own.
+  class LinkEmulator
+  {
+  public:
+    ~LinkEmulator();
+
+    bool start(uint16_t port, uint16_t server_port, const LinkConditions& conditions, uint32_t seed = 1u);
+    void stop();
+
+    uint64_t getForwarded() const;
+    uint64_t getDropped() const;
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Route
+    {
+      ENetAddress client;
+      ENetSocket  socket;
+    };
+
+    struct Datagram
+    {
+      ENetSocket      socket;
+      ENetAddress     to;
+      Vector<uint8_t> data;
+    };
+
+    // Datagrams stay in their slot, so the queue only moves these.
+    struct Delay
+    {
+      Clock::time_point due;
+      uint32_t          slot;
+    };
+
+    struct Later
+    {
+      bool operator()(const Delay& lhs, const Delay& rhs) const { return lhs.due > rhs.due; }
+    };
+
+    void run();
+    void receiveFromClients();
+    void receiveFromServer(uint32_t route);
+    // Drops or delays it, or sends it right away.
+    void forward(ENetSocket socket, const ENetAddress& to, const uint8_t* data, size_t size);
+    void send(ENetSocket socket, const ENetAddress& to, const uint8_t* data, size_t size);
+    // Opens a route for clients it has not seen before.
+    uint32_t findRoute(const ENetAddress& client);
+
+  private:
+    ENetSocket socket_ = ENET_SOCKET_NULL;
+    ENetAddress server_;
+    LinkConditions conditions_;
+    std::mt19937 random_;
+
+    // Only used by the thread.
+    Vector<Route> routes_;
+    UnorderedMap<uint64_t, uint32_t> route_of_client_;
+    PriorityQueue<Delay, Later> delays_;
+    Vector<Datagram> datagrams_;
+    Vector<uint32_t> free_slots_;
+
+    std::atomic<bool> running_{ false };
+    std::atomic<uint64_t> forwarded_{ 0u };
+    std::atomic<uint64_t> dropped_{ 0u };
+    std::thread thread_;
+  };
+}
@@ -0,0 +1,486 @@
+#include <networking.h>
+#include <messages.h>
+#include <utils/timer.h>
+#include "link_emulator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // How long clients get to connect before the run starts without them.
+  static constexpr double   kConnectSeconds = 10.0;
+  // After the run, for the replies that are still on their way.
+  static constexpr double   kDrainSeconds   = 0.5;
+  // ENet can not give out more peer IDs than this.
+  static constexpr uint32_t kMaxClients     = 4095u;
+  // Room for clients that reconnect before the server saw them leave.
+  static constexpr uint32_t kSpareClients   = 64u;
+  static constexpr float    kSnapshotRate   = 30.0f;
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Messages that clients send, on a channel, of a size. Kinds are picked
+  // at random, in proportion to their weight.
+  struct MessageKind
+  {
+    uint8_t  channel;
+    uint32_t bytes;
+    uint32_t weight;
+  };
+
+  enum class Role
+  {
+    kBoth,
+    kServer,
+    kClients,
+  };
+
+  struct Options
+  {
+    Role     role        = Role::kBoth;
+    uint16_t port        = 47700u;
+    uint32_t clients     = 64u;
+    double   seconds     = 10.0;
+    // Messages per client per second.
+    double   rate        = 20.0;
+    double   frame_rate  = 60.0;
+    // Moving entities the server replicates, kSnapshotRate times per second.
+    uint32_t entities    = 0u;
+    // Clients that disconnect and connect again per second.
+    double   churn       = 0.0;
+    bool     threaded    = false;
+    bool     immediate   = false;
+    LinkConditions link;
+    Vector<MessageKind> mix;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static const char* kChannelNames[networking::kChannelCount] = {
+    "reliable",
+    "sequenced",
+    "unreliable",
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // <channel>:<bytes>:<weight>, separated by commas. Like
+  // unreliable:32:8,reliable:128:1.
+  static bool parseMix(const char* text, Vector<MessageKind>& mix)
+  {
+    mix.clear();
+    while (*text != '\0')
+    {
+      const char* end = strchr(text, ',');
+      const String item = end ? String(text, end) : String(text);
+      text = end ? end + 1 : text + strlen(text);
+
+      char channel[16] = {};
+      unsigned int bytes = 0u, weight = 0u;
+      if (sscanf(item.c_str(), "%15[a-z]:%u:%u", channel, &bytes, &weight) != 3 || weight == 0u)
+        return false;
+
+      MessageKind kind;
+      kind.channel = networking::kChannelCount;
+      for (uint8_t c = 0u; c < networking::kChannelCount; ++c)
+      {
+        if (strcmp(channel, kChannelNames[c]) == 0)
+          kind.channel = c;
+      }
+      if (kind.channel == networking::kChannelCount)
+        return false;
+      // Room for the time it was sent.
+      kind.bytes  = std::max((uint32_t)bytes, (uint32_t)sizeof(double));
+      kind.weight = weight;
+      mix.push_back(kind);
+    }
+    return !mix.empty();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static double percentile(const Vector<double>& sorted, double fraction)
+  {
+    if (sorted.empty())
+      return 0.0;
+    return sorted[std::min((size_t)(fraction * (double)sorted.size()), sorted.size() - 1u)];
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void report(const char* metric, double value, const char* unit)
+  {
+    printf("%-32s %14.3f %s\n", metric, value, unit);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void sleepOut(const utilities::Timer& frame_time, double frame)
+  {
+    const double left = frame - frame_time.elapsed().seconds();
+    if (left > 0.0)
+      std::this_thread::sleep_for(std::chrono::duration<double>(left));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void configure(networking::Client& client, const Options& options)
+  {
+    client.setFlushPolicy(options.immediate ? networking::FlushPolicy::kImmediate : networking::FlushPolicy::kOnTick);
+    client.setThreaded(options.threaded);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  struct ServerResults
+  {
+    // How long every frame with clients took, in milliseconds.
+    Vector<double> ticks;
+    uint32_t peak_clients   = 0u;
+    uint64_t snapshot_bytes = 0u;
+    uint64_t snapshots      = 0u;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Updates the server once per frame until stop is set. Every frame with
+  // clients connected counts towards the tick time.
+  static void runServer(const Options& options, const std::atomic<bool>& stop, ServerResults& results)
+  {
+    networking::Server server;
+    server.initialize(options.port, 0u, std::min(options.clients + kSpareClients, kMaxClients));
+    server.setFlushPolicy(options.immediate ? networking::FlushPolicy::kImmediate : networking::FlushPolicy::kOnTick);
+    server.setThreaded(options.threaded);
+
+    const double frame = 1.0 / options.frame_rate;
+    const double snapshot_interval = 1.0 / kSnapshotRate;
+    double snapshot_time = 0.0;
+    double time = 0.0;
+    networking::Snapshot snapshot;
+    utilities::Timer frame_time;
+    while (!stop)
+    {
+      // Frames that ran long still move time on by as much as they took.
+      const double delta_time = frame_time.elapsed().seconds();
+      frame_time.reset();
+      server.update(delta_time);
+
+      time += delta_time;
+      snapshot_time += delta_time;
+      if (options.entities > 0u && snapshot_time >= snapshot_interval)
+      {
+        snapshot_time = fmod(snapshot_time, snapshot_interval);
+        snapshot.time = (float)time;
+        for (uint32_t i = 0u; i < options.entities; ++i)
+        {
+          const float phase = (float)time + (float)i;
+          const glm::vec3 position((float)(i % 100u) * 4.0f + sinf(phase), 0.0f, (float)(i / 100u) * 4.0f + cosf(phase));
+          snapshot.add(i + 1u, position, glm::quat());
+        }
+        server.sendSnapshot(snapshot);
+        results.snapshot_bytes += server.getSnapshotBytes();
+        results.snapshots++;
+      }
+
+      const uint32_t clients = server.getClientCount();
+      if (clients > 0u)
+        results.ticks.push_back(frame_time.elapsed().milliseconds());
+      results.peak_clients = std::max(results.peak_clients, clients);
+      sleepOut(frame_time, frame);
+    }
+
+    server.deinitialize();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void reportServer(ServerResults& results)
+  {
+    std::sort(results.ticks.begin(), results.ticks.end());
+    report("server peak clients", (double)results.peak_clients, "clients");
+    report("server tick p50", percentile(results.ticks, 0.5), "ms");
+    report("server tick p99", percentile(results.ticks, 0.99), "ms");
+    report("server tick max", results.ticks.empty() ? 0.0 : results.ticks.back(), "ms");
+    if (results.snapshots > 0u && results.peak_clients > 0u)
+      report("server snapshot bytes", (double)results.snapshot_bytes / (double)results.snapshots / (double)results.peak_clients, "bytes/client/tick");
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Connects the clients, has every one of them send options.rate
+  // messages a second for options.seconds, and measures what the server
+  // relays back. Returns false when not every client connected, or two
+  // clients had the same ID.
+  static bool runClients(const Options& options, uint16_t port)
+  {
+    Vector<networking::Client> clients(options.clients);
+    for (networking::Client& client : clients)
+    {
+      client.initialize("load", port);
+      configure(client, options);
+    }
+
+    const double frame = 1.0 / options.frame_rate;
+    auto countConnected = [&clients]() {
+      uint32_t connected = 0u;
+      for (networking::Client& client : clients)
+        connected += client.isConnected() ? 1u : 0u;
+      return connected;
+    };
+    utilities::Timer connecting;
+    while (countConnected() < options.clients && connecting.elapsed().seconds() < kConnectSeconds)
+    {
+      utilities::Timer frame_time;
+      for (networking::Client& client : clients)
+        client.update(frame);
+      sleepOut(frame_time, frame);
+    }
+    const uint32_t connected = countConnected();
+    report("clients connected", (double)connected, "clients");
+    report("clients connect time", connecting.elapsed().seconds(), "s");
+
+    uint32_t total_weight = 0u;
+    for (const MessageKind& kind : options.mix)
+      total_weight += kind.weight;
+
+    // Spread over the frames, so they do not all send at once.
+    std::mt19937 random(7u);
+    Vector<double> budgets(options.clients);
+    for (double& budget : budgets)
+      budget = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+
+    utilities::Timer clock;
+    utilities::Timer frame_time;
+    Vector<double> frame_times;
+    Vector<double> round_trips;
+    Vector<networking::ReceivedPacket> packets;
+    Vector<uint8_t> filler;
+    uint64_t sent[networking::kChannelCount]     = {};
+    uint64_t returned[networking::kChannelCount] = {};
+    uint64_t received       = 0u;
+    uint64_t received_bytes = 0u;
+    uint32_t reconnects     = 0u;
+    uint32_t next_churn     = 0u;
+    double churn_budget     = 0.0;
+    while (clock.elapsed().seconds() < options.seconds + kDrainSeconds)
+    {
+      // The clients send as much when the frames take longer than they
+      // should. The frame times show when this process is what is slow.
+      const double delta_time = frame_time.elapsed().seconds();
+      frame_time.reset();
+      const bool sending = clock.elapsed().seconds() < options.seconds;
+      for (uint32_t i = 0u; i < options.clients; ++i)
+      {
+        networking::Client& client = clients[i];
+        budgets[i] += sending && client.isConnected() ? options.rate * delta_time : 0.0;
+        while (budgets[i] >= 1.0)
+        {
+          budgets[i] -= 1.0;
+          uint32_t pick = std::uniform_int_distribution<uint32_t>(0u, total_weight - 1u)(random);
+          const MessageKind* kind = options.mix.data();
+          while (pick >= kind->weight)
+            pick -= (kind++)->weight;
+
+          networking::MessageWriter payload;
+          payload.write(clock.elapsed().milliseconds());
+          filler.resize(kind->bytes - sizeof(double));
+          payload.writeBytes(filler.data(), filler.size());
+          client.sendMessage(networking::kMessageTypeUser, payload, kind->channel);
+          sent[kind->channel]++;
+        }
+
+        client.update(delta_time);
+        packets.clear();
+        client.pollPackets(packets);
+        for (networking::ReceivedPacket& packet : packets)
+        {
+          networking::MessageView message;
+          while (packet.next(message))
+          {
+            if (message.type != networking::kMessageTypeUser)
+              continue;
+            received++;
+            received_bytes += message.size;
+            if (message.sender != client.getId())
+              continue;
+
+            networking::MessageReader reader = message.reader();
+            const double time = reader.read<double>();
+            if (reader.isValid() && packet.getChannel() < networking::kChannelCount)
+            {
+              round_trips.push_back(clock.elapsed().milliseconds() - time);
+              returned[packet.getChannel()]++;
+            }
+          }
+        }
+      }
+
+      // Clients that leave free their ID, which the next one that
+      // connects should get.
+      churn_budget += sending ? options.churn * delta_time : 0.0;
+      while (churn_budget >= 1.0 && options.clients > 0u)
+      {
+        churn_budget -= 1.0;
+        networking::Client& client = clients[next_churn++ % options.clients];
+        client.disconnect();
+        client.deinitialize();
+        client = networking::Client();
+        client.initialize("load", port);
+        configure(client, options);
+        reconnects++;
+      }
+
+      if (sending)
+        frame_times.push_back(frame_time.elapsed().milliseconds());
+      sleepOut(frame_time, frame);
+    }
+
+    Vector<networking::ClientId> ids;
+    for (networking::Client& client : clients)
+    {
+      if (client.isConnected())
+        ids.push_back(client.getId());
+    }
+    std::sort(ids.begin(), ids.end());
+    uint32_t duplicates = 0u;
+    for (size_t i = 1u; i < ids.size(); ++i)
+      duplicates += ids[i] == ids[i - 1u] ? 1u : 0u;
+
+    for (networking::Client& client : clients)
+    {
+      client.disconnect();
+      client.deinitialize();
+    }
+
+    uint64_t total_sent = 0u;
+    for (uint64_t count : sent)
+      total_sent += count;
+    std::sort(round_trips.begin(), round_trips.end());
+    std::sort(frame_times.begin(), frame_times.end());
+    report("clients frame p50", percentile(frame_times, 0.5), "ms");
+    report("clients frame p99", percentile(frame_times, 0.99), "ms");
+    report("clients sent", (double)total_sent / options.seconds, "msg/s");
+    report("clients received", (double)received / options.seconds, "msg/s");
+    report("clients received bytes", (double)received_bytes / options.seconds / (1024.0 * 1024.0), "MB/s");
+    report("round trip p50", percentile(round_trips, 0.5), "ms");
+    report("round trip p90", percentile(round_trips, 0.9), "ms");
+    report("round trip p99", percentile(round_trips, 0.99), "ms");
+    report("round trip max", round_trips.empty() ? 0.0 : round_trips.back(), "ms");
+    for (uint8_t c = 0u; c < networking::kChannelCount; ++c)
+    {
+      if (sent[c] > 0u)
+        report((String("delivered ") + kChannelNames[c]).c_str(), 100.0 * (double)returned[c] / (double)sent[c], "%");
+    }
+    if (options.churn > 0.0)
+      report("reconnects", (double)reconnects, "clients");
+    report("highest client id", ids.empty() ? 0.0 : (double)ids.back(), "");
+    report("duplicate client ids", (double)duplicates, "");
+
+    return connected == options.clients && duplicates == 0u;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+  // lambda-load-test [--role both|server|clients] [--port <port>] [--clients <count>]
+  //                  [--seconds <seconds>] [--rate <messages per second>] [--frame-rate <hz>]
+  //                  [--mix <channel>:<bytes>:<weight>,...] [--entities <count>]
+  //                  [--churn <reconnects per second>] [--threaded] [--immediate]
+  //                  [--loss <percent>] [--latency <ms>] [--jitter <ms>]
+  // Runs a server and simulated clients on 127.0.0.1. Every client sends
+  // --rate messages a second of the --mix, which the server relays to
+  // all of them. With --role the server and the clients run in separate
+  // processes; start the server first and give it more --seconds. Loss,
+  // latency and jitter are added by a relay on --port + 1 that the
+  // clients connect through. The exit code is 1 when not every client
+  // connected or two clients got the same ID, for CI.
+  lambda::Options options;
+  bool valid = lambda::parseMix("unreliable:32:8,sequenced:64:4,reliable:128:1", options.mix);
+  for (int i = 1; i < argc && valid; ++i)
+  {
+    const bool has_value = i + 1 < argc;
+    if (strcmp(argv[i], "--role") == 0 && has_value)
+    {
+      const char* role = argv[++i];
+      if (strcmp(role, "server") == 0)
+        options.role = lambda::Role::kServer;
+      else if (strcmp(role, "clients") == 0)
+        options.role = lambda::Role::kClients;
+      else
+        options.role = lambda::Role::kBoth;
+    }
+    else if (strcmp(argv[i], "--port") == 0 && has_value)
+      options.port = (uint16_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--clients") == 0 && has_value)
+      options.clients = std::min((uint32_t)atoi(argv[++i]), lambda::kMaxClients);
+    else if (strcmp(argv[i], "--seconds") == 0 && has_value)
+      options.seconds = atof(argv[++i]);
+    else if (strcmp(argv[i], "--rate") == 0 && has_value)
+      options.rate = atof(argv[++i]);
+    else if (strcmp(argv[i], "--frame-rate") == 0 && has_value)
+      options.frame_rate = std::max(atof(argv[++i]), 1.0);
+    else if (strcmp(argv[i], "--mix") == 0 && has_value)
+      valid = lambda::parseMix(argv[++i], options.mix);
+    else if (strcmp(argv[i], "--entities") == 0 && has_value)
+      options.entities = (uint32_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--churn") == 0 && has_value)
+      options.churn = atof(argv[++i]);
+    else if (strcmp(argv[i], "--threaded") == 0)
+      options.threaded = true;
+    else if (strcmp(argv[i], "--immediate") == 0)
+      options.immediate = true;
+    else if (strcmp(argv[i], "--loss") == 0 && has_value)
+      options.link.loss = (float)atof(argv[++i]) / 100.0f;
+    else if (strcmp(argv[i], "--latency") == 0 && has_value)
+      options.link.latency_ms = (uint32_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--jitter") == 0 && has_value)
+      options.link.jitter_ms = (uint32_t)atoi(argv[++i]);
+    else
+      valid = false;
+  }
+  if (!valid)
+  {
+    printf("Invalid arguments. See the top of load_test/main.cc.\n");
+    return 2;
+  }
+
+  lambda::networking::initializeNetworking();
+
+  std::atomic<bool> stop(false);
+  lambda::ServerResults server_results;
+  std::thread server;
+  if (options.role != lambda::Role::kClients)
+    server = std::thread([&]() { lambda::runServer(options, stop, server_results); });
+
+  bool succeeded = true;
+  if (options.role == lambda::Role::kServer)
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+  else
+  {
+    lambda::LinkEmulator link;
+    uint16_t port = options.port;
+    if (!options.link.isPerfect())
+    {
+      port = options.port + 1u;
+      succeeded = link.start(port, options.port, options.link);
+    }
+
+    if (succeeded)
+      succeeded = lambda::runClients(options, port);
+
+    link.stop();
+    if (!options.link.isPerfect())
+    {
+      lambda::report("link forwarded", (double)link.getForwarded(), "datagrams");
+      lambda::report("link dropped", (double)link.getDropped(), "datagrams");
+    }
+  }
+
+  stop = true;
+  if (server.joinable())
+  {
+    server.join();
+    lambda::reportServer(server_results);
+  }
+
+  lambda::networking::deinitializeNetworking();
+  return succeeded ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#include "bit_stream.h"
+#include "message_codec.h"
+
+namespace lambda
+{
+  namespace networking
+  {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static const uint32_t kUnsignedClassBits[4] = { 4u, 8u, 16u, 32u };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    BitWriter::BitWriter(MessageWriter& writer) :
+      writer_(writer)
+    {
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void BitWriter::write(uint32_t value, uint32_t bits)
+    {
+      if (bits < 32u)
+        value &= (1u << bits) - 1u;
+      scratch_ |= (uint64_t)value << scratch_bits_;
+      scratch_bits_ += bits;
+      bit_count_    += bits;
+
+      if (scratch_bits_ >= 32u)
+      {
+        const uint32_t word = (uint32_t)scratch_;
+        writer_.write(word);
+        scratch_ >>= 32u;
+        scratch_bits_ -= 32u;
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void BitWriter::writeBool(bool value)
+    {
+      write(value ? 1u : 0u, 1u);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static uint32_t getUnsignedClass(uint32_t value)
+    {
+      uint32_t type = 0u;
+      while (type < 3u && value >= (1u << kUnsignedClassBits[type]))
+        type++;
+      return type;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static uint32_t zigZag(int32_t value)
+    {
+      return ((uint32_t)value << 1u) ^ (uint32_t)(value >> 31);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void BitWriter::writeUnsigned(uint32_t value)
+    {
+      const uint32_t type = getUnsignedClass(value);
+      write(type, 2u);
+      write(value, kUnsignedClassBits[type]);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void BitWriter::writeSigned(int32_t value)
+    {
+      writeUnsigned(zigZag(value));
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void BitWriter::flush()
+    {
+      while (scratch_bits_ > 0u)
+      {
+        const uint8_t byte = (uint8_t)scratch_;
+        writer_.write(byte);
+        scratch_ >>= 8u;
+        scratch_bits_ = scratch_bits_ > 8u ? scratch_bits_ - 8u : 0u;
+      }
+      scratch_ = 0u;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t BitWriter::getBitCount() const
+    {
+      return bit_count_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t BitWriter::getUnsignedBits(uint32_t value)
+    {
+      return 2u + kUnsignedClassBits[getUnsignedClass(value)];
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t BitWriter::getSignedBits(int32_t value)
+    {
+      return getUnsignedBits(zigZag(value));
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    BitReader::BitReader(const uint8_t* data, size_t size) :
+      data_(data),
+      size_(size)
+    {
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t BitReader::read(uint32_t bits)
+    {
+      while (scratch_bits_ < bits)
+      {
+        if (offset_ >= size_)
+        {
+          valid_ = false;
+          return 0u;
+        }
+        scratch_ |= (uint64_t)data_[offset_++] << scratch_bits_;
+        scratch_bits_ += 8u;
+      }
+
+      const uint32_t value = bits < 32u ? (uint32_t)scratch_ & ((1u << bits) - 1u) : (uint32_t)scratch_;
+      scratch_ >>= bits;
+      scratch_bits_ -= bits;
+      return value;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool BitReader::readBool()
+    {
+      return read(1u) != 0u;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t BitReader::readUnsigned()
+    {
+      return read(kUnsignedClassBits[read(2u)]);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    int32_t BitReader::readSigned()
+    {
+      const uint32_t value = readUnsigned();
+      return (int32_t)(value >> 1u) ^ -(int32_t)(value & 1u);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool BitReader::isValid() const
+    {
+      return valid_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t BitReader::getBitsLeft() const
+    {
+      return (size_ - offset_) * 8u + scratch_bits_;
+    }
+  }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <containers/containers.h>
+
+namespace lambda
+{
+  namespace networking
+  {
+    class MessageWriter;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Packs values of any width up to 32 bits, lowest bit first, and
+    // appends the bytes to a message payload as they fill up.
+    class BitWriter
+    {
+    public:
+      explicit BitWriter(MessageWriter& writer);
+
+      void write(uint32_t value, uint32_t bits);
+      void writeBool(bool value);
+      // Small values in few bits: a 2 bit class, then 4, 8, 16 or 32 bits.
+      void writeUnsigned(uint32_t value);
+      // Zig zag encoded, then as writeUnsigned.
+      void writeSigned(int32_t value);
+      // Pads the last byte with zeros. Call once when done.
+      void flush();
+      size_t getBitCount() const;
+
+      // What writeUnsigned and writeSigned would take, without writing.
+      static uint32_t getUnsignedBits(uint32_t value);
+      static uint32_t getSignedBits(int32_t value);
+
+    private:
+      MessageWriter& writer_;
+      uint64_t scratch_      = 0u;
+      uint32_t scratch_bits_ = 0u;
+      size_t   bit_count_    = 0u;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Reads what BitWriter wrote. Reads past the end return zeros and make
+    // isValid() false.
+    class BitReader
+    {
+    public:
+      BitReader(const uint8_t* data, size_t size);
+
+      uint32_t read(uint32_t bits);
+      bool readBool();
+      uint32_t readUnsigned();
+      int32_t readSigned();
+      bool isValid() const;
+      size_t getBitsLeft() const;
+
+    private:
+      const uint8_t* data_;
+      size_t   size_;
+      size_t   offset_       = 0u;
+      uint64_t scratch_      = 0u;
+      uint32_t scratch_bits_ = 0u;
+      bool     valid_        = true;
+    };
+  }
+}
@@ -15,9 +15,9 @@ namespace lambda
       host_ = enet_host_create(
         nullptr   /* create a client host */,
         1         /* only allow 1 outgoing connection */,
-        2         /* allow up 2 channels to be used, 0 and 1 */,
-        57600 / 8 /* 56K modem with 56 Kbps downstream bandwidth */,
-        14400 / 8 /* 56K modem with 14 Kbps upstream bandwidth */
+        kChannelCount /* allow up to kChannelCount channels to be used */,
+        0         /* assume any amount of incoming bandwidth */,
+        0         /* assume any amount of outgoing bandwidth */
       );
 
       if (host_ == nullptr)
@@ -28,8 +28,8 @@ namespace lambda
       address.port = port;
 
       /* Connect to localhost:1234. */
-      /* Initiate the connection, allocating the two channels 0 and 1. */
-      peer_ = enet_host_connect(host_, &address, 2, 0);
+      /* Initiate the connection, allocating all of the channels. */
+      peer_ = enet_host_connect(host_, &address, kChannelCount, 0);
 
       if (peer_ == nullptr)
       {
@@ -44,6 +44,7 @@ namespace lambda
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void Client::deinitialize()
     {
+      message_manager_.stopThread();
       enet_peer_reset(peer_);
       enet_host_destroy(host_);
     }
@@ -51,6 +52,8 @@ namespace lambda
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void Client::disconnect()
     {
+      // ENet can not be used from two threads.
+      message_manager_.stopThread();
       enet_peer_disconnect(peer_, 0);
       message_manager_.update(message_manager_.getFrequency());
     }
@@ -68,12 +71,15 @@ namespace lambda
           for (int i = 0; i < packet.messageCount(); ++i)
           {
             const Message& message = packet.getMessage(i);
-            if (message.client_id == id_)
+            // Skip the messages that the server relayed back. Until the
+            // server has given this client an ID, everything is new.
+            if (id_ != kServerId && message.client_id == id_)
               continue;
 
             if (message.header == MESSAGE_CONNECTED)
             {
               connected_ = true;
+              connect_id_ = packet.getConnectId();
               LMB_LOG_DEBG("[CLIENT] Connected to server.");
             }
             else if (message.header == MESSAGE_DISCONNECTED)
@@ -88,12 +94,47 @@ namespace lambda
           }
         }
       }
+
+      // Snapshots come in packets of their own.
+      incoming_packets_.clear();
+      message_manager_.receivePackets(incoming_packets_);
+      for (auto& packet : incoming_packets_)
+      {
+        MessageView message;
+        if (packet.next(message) && message.type == kMessageTypeSnapshot)
+        {
+          snapshots_.receive(message.data, message.size);
+        }
+        else
+        {
+          packet.rewind();
+          received_packets_.push_back(eastl::move(packet));
+        }
+      }
+
+      snapshots_.update(delta_time);
+      if (snapshots_.getAck() != sent_ack_)
+      {
+        sent_ack_ = snapshots_.getAck();
+        MessageWriter ack;
+        ack.writeVarint(sent_ack_);
+        sendMessage(kMessageTypeSnapshotAck, ack, kChannelSequenced);
+      }
+
+      if (message_manager_.getFlushPolicy() == FlushPolicy::kImmediate)
+        message_manager_.flush();
     }
     
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     bool Client::isConnected()
     {
-      return connected_ && (id_ != 0);
+      return connected_ && (id_ != kServerId);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ClientId Client::getId() const
+    {
+      return id_;
     }
     
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -102,6 +143,12 @@ namespace lambda
       message.client_id = id_;
       message_manager_.sendMessage(message);
     }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Client::sendMessage(uint32_t type, const MessageWriter& payload, uint8_t channel)
+    {
+      message_manager_.sendMessage(type, id_, payload, channel);
+    }
     
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void Client::setUpdateRate(uint8_t hertz)
@@ -114,6 +161,21 @@ namespace lambda
     {
       return message_manager_.getUpdateRate();
     }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Client::setFlushPolicy(FlushPolicy policy)
+    {
+      message_manager_.setFlushPolicy(policy);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Client::setThreaded(bool threaded, uint32_t service_timeout)
+    {
+      if (threaded)
+        message_manager_.startThread(service_timeout);
+      else
+        message_manager_.stopThread();
+    }
     
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     bool Client::pollMessages(Message& received_message)
@@ -128,23 +190,76 @@ namespace lambda
       }
     }
     
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool Client::pollPackets(Vector<ReceivedPacket>& packets)
+    {
+      if (received_packets_.empty())
+        return false;
+
+      for (auto& packet : received_packets_)
+        packets.push_back(eastl::move(packet));
+      received_packets_.clear();
+      return true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    SnapshotReceiver& Client::getSnapshots()
+    {
+      return snapshots_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Client::setObservers(const Vector<Observer>& observers)
+    {
+      bool changed = observers.size() != observers_.size();
+      for (size_t i = 0u; i < observers.size() && !changed; ++i)
+      {
+        changed = observers[i].position != observers_[i].position ||
+          observers[i].radius != observers_[i].radius;
+      }
+      if (!changed)
+        return;
+
+      if (observers.size() > kMaxObservers)
+      {
+        LMB_LOG_ERR("[CLIENT] Only %u observers are supported.", kMaxObservers);
+        return;
+      }
+
+      // Reliable, so the server never keeps a stale one.
+      observers_ = observers;
+      MessageWriter payload;
+      payload.writeVarint(observers_.size());
+      for (const Observer& observer : observers_)
+      {
+        payload.write(observer.position.x);
+        payload.write(observer.position.y);
+        payload.write(observer.position.z);
+        payload.write(observer.radius);
+      }
+      sendMessage(kMessageTypeObservers, payload, kChannelReliable);
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void Client::setId(String message)
     {
+      if (message.size() < sizeof(ClientId) + sizeof(uint32_t))
+        return;
+
       // Get the connect ID of the peer that the new ID will be assigned to.
       uint32_t connect_id;
-      memcpy(&connect_id, message.data() + 1, sizeof(uint32_t));
+      memcpy(&connect_id, message.data() + sizeof(ClientId), sizeof(uint32_t));
 
       // Check if this is that specific peer.
-      if (peer_->connectID == connect_id)
+      if (connect_id_ == connect_id)
       {
         // Set the new ID.
-        id_ = (uint8_t)message.at(0);
+        memcpy(&id_, message.data(), sizeof(ClientId));
 
         // Send a change name message.
         sendMessage(lambda::networking::Message(MESSAGE_SET_NAME, name_));
 
-        LMB_LOG_DEBG("[CLIENT] Got ID %i assigned from server.", id_);
+        LMB_LOG_DEBG("[CLIENT] Got ID %u assigned from server.", id_);
       }
     }
   }
@@ -1,5 +1,7 @@
 #pragma once
 #include "message_manager.h"
+#include "snapshot.h"
+#include "interest.h"
 #include <containers/containers.h>
 
 struct _ENetPeer;
@@ -20,10 +22,26 @@ namespace lambda
       void disconnect();
       void update(double delta_time);
       bool isConnected();
+      // kServerId until the server assigned one.
+      ClientId getId() const;
       void sendMessage(Message message);
+      void sendMessage(uint32_t type, const MessageWriter& payload, uint8_t channel = kChannelReliable);
       void setUpdateRate(uint8_t hertz);
       uint8_t getUpdateRate();
+      // With FlushPolicy::kImmediate, what was sent during update, like
+      // snapshot acks, goes out at the end of it.
+      void setFlushPolicy(FlushPolicy policy);
+      // Services the host on a thread of its own. See MessageManager.
+      void setThreaded(bool threaded, uint32_t service_timeout = 1u);
       bool pollMessages(Message& received_message);
+      // Binary messages, including the ones this client sent that the
+      // server relayed back.
+      bool pollPackets(Vector<ReceivedPacket>& packets);
+      // The snapshots the server replicated, played back a little behind.
+      SnapshotReceiver& getSnapshots();
+      // Where this client looks from. The server only sends the entities
+      // near them. Without observers it sends everything.
+      void setObservers(const Vector<Observer>& observers);
 
     private:
       void setId(String message);
@@ -34,9 +52,16 @@ namespace lambda
       ENetHost* host_ = nullptr;
       ENetPeer* peer_ = nullptr;
       bool connected_ = false;
-      uint8_t id_ = 0;
+      // Of peer_, from when it connected.
+      uint32_t connect_id_ = 0u;
+      ClientId id_ = kServerId;
 
       Queue<Message> received_messages_;
+      Vector<ReceivedPacket> received_packets_;
+      Vector<ReceivedPacket> incoming_packets_;
+      SnapshotReceiver snapshots_;
+      uint32_t sent_ack_ = kNoSnapshot;
+      Vector<Observer> observers_;
     };
   }
 }
\ No newline at end of file
@@ -54,22 +54,17 @@ namespace lambda
       Message msg;
       if (get(client).pollMessages(msg))
       {
-        assert(msg.header_size < LAMBDA_MAX_HEADER_LENGTH);
-        assert(msg.message_size < LAMBDA_MAX_MESSAGE_LENGTH);
-
-        unsigned char null_char = '\0';
-
-#if VIOLET_OSX
-        memcpy((void*)header, msg.header.data(), msg.header.size());
-        memcpy((void*)(header + msg.header_size), &null_char, 1);
-        memcpy((void*)message, msg.message.data(), msg.message.size());
-        memcpy((void*)(message + msg.message_size), &null_char, 1);
-#else
-        memcpy_s((void*)header, LAMBDA_MAX_HEADER_LENGTH, msg.header.data(), msg.header.size());
-        memcpy_s((void*)(header + msg.header_size), 1, &null_char, 1);
-        memcpy_s((void*)message, LAMBDA_MAX_HEADER_LENGTH, msg.message.data(), msg.message.size());
-        memcpy_s((void*)(message + msg.message_size), 1, &null_char, 1);
-#endif
+        // Messages are no longer limited to 255 characters on the wire,
+        // but the buffers of this API still are.
+        const size_t header_size  = eastl::min(msg.header.size(), (size_t)LAMBDA_MAX_HEADER_LENGTH - 1u);
+        const size_t message_size = eastl::min(msg.message.size(), (size_t)LAMBDA_MAX_MESSAGE_LENGTH - 1u);
+        assert(header_size == msg.header.size());
+        assert(message_size == msg.message.size());
+
+        memcpy((void*)header, msg.header.data(), header_size);
+        ((char*)header)[header_size] = '\0';
+        memcpy((void*)message, msg.message.data(), message_size);
+        ((char*)message)[message_size] = '\0';
         
         return true;
       }
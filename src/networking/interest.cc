@@ -0,0 +1,295 @@
+#include "interest.h"
+#include "message_codec.h"
+#include <EASTL/sort.h>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace lambda
+{
+  namespace networking
+  {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static constexpr uint32_t kNewEntity = ~0u;
+    // Roughly what encodeSnapshot writes besides the entities.
+    static constexpr size_t   kHeaderBits = 160u;
+    // Waiting entities that were not relevant for this many ticks are
+    // forgotten.
+    static constexpr uint32_t kWaitingSweep = 64u;
+
+    enum EntityState : uint8_t
+    {
+      kStateOmit,  // The client does not get it.
+      kStateSend,  // The client gets the state of this tick.
+      kStateCarry, // The client keeps the state it was last sent.
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static int16_t getZoneCoordinate(float value, float zone_size)
+    {
+      return (int16_t)glm::clamp(std::floor(value / zone_size), -32768.0f, 32767.0f);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    InterestGrid::InterestGrid(float zone_size) :
+      zone_size_(zone_size)
+    {
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void InterestGrid::build(const Snapshot& snapshot)
+    {
+      for (auto& zone : zones_)
+        zone.second.clear();
+
+      for (size_t i = 0u; i < snapshot.size(); ++i)
+      {
+        const glm::vec3 position = dequantizePosition(snapshot.transforms[i]);
+        zones_[hash(getZoneCoordinate(position.x, zone_size_), getZoneCoordinate(position.z, zone_size_))].push_back((uint32_t)i);
+      }
+
+      // The zones follow where the entities are now, not everywhere they
+      // have been.
+      for (auto it = zones_.begin(); it != zones_.end();)
+      {
+        if (it->second.empty())
+          it = zones_.erase(it);
+        else
+          ++it;
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void InterestGrid::query(const glm::vec3& position, float radius, Vector<uint32_t>& indices) const
+    {
+      const int16_t min_x = getZoneCoordinate(position.x - radius, zone_size_);
+      const int16_t max_x = getZoneCoordinate(position.x + radius, zone_size_);
+      const int16_t min_y = getZoneCoordinate(position.z - radius, zone_size_);
+      const int16_t max_y = getZoneCoordinate(position.z + radius, zone_size_);
+
+      for (int32_t y = min_y; y <= max_y; ++y)
+      {
+        for (int32_t x = min_x; x <= max_x; ++x)
+        {
+          auto it = zones_.find(hash((int16_t)x, (int16_t)y));
+          if (it != zones_.end())
+            indices.insert(indices.end(), it->second.begin(), it->second.end());
+        }
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    float InterestGrid::getZoneSize() const
+    {
+      return zone_size_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t InterestGrid::hash(int16_t x, int16_t y)
+    {
+      uint32_t hash = 0u;
+      memcpy(&hash, &x, sizeof(int16_t));
+      memcpy((char*)&hash + sizeof(int16_t), &y, sizeof(int16_t));
+      return hash;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    const Snapshot* ClientInterest::find(uint32_t sequence) const
+    {
+      const Snapshot& snapshot = history[sequence % kSnapshotHistory];
+      return sequence != kNoSnapshot && snapshot.sequence == sequence ? &snapshot : nullptr;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static void copyEntity(const Snapshot& source, size_t i, Snapshot& snapshot)
+    {
+      const size_t field_count = source.getFieldCount();
+      snapshot.ids.push_back(source.ids[i]);
+      snapshot.transforms.push_back(source.transforms[i]);
+      snapshot.fields.insert(snapshot.fields.end(), source.fields.begin() + i * field_count, source.fields.begin() + (i + 1u) * field_count);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void InterestManager::update(const Snapshot& snapshot)
+    {
+      grid_.build(snapshot);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void InterestManager::encode(const Snapshot& snapshot, ClientInterest& client, uint32_t acked, MessageWriter& writer)
+    {
+      client.ticks++;
+      Snapshot& sent = client.history[snapshot.sequence % kSnapshotHistory];
+      const Snapshot* baseline = client.find(acked);
+      if (baseline == &sent || (baseline != nullptr && baseline->field_bits != snapshot.field_bits))
+        baseline = nullptr;
+      const Snapshot* previous = client.find(client.last_sent);
+      if (previous == &sent || (previous != nullptr && previous->field_bits != snapshot.field_bits))
+        previous = nullptr;
+
+      // Everything without observers. Otherwise what is near them, in the
+      // order of the snapshot.
+      relevant_.clear();
+      if (client.observers.empty())
+      {
+        relevant_.resize(snapshot.size());
+        for (size_t i = 0u; i < relevant_.size(); ++i)
+          relevant_[i] = (uint32_t)i;
+      }
+      else
+      {
+        for (const Observer& observer : client.observers)
+          grid_.query(observer.position, observer.radius * kInterestHysteresis, relevant_);
+        eastl::sort(relevant_.begin(), relevant_.end());
+        relevant_.erase(eastl::unique(relevant_.begin(), relevant_.end()), relevant_.end());
+      }
+
+      const float zone_size = grid_.getZoneSize();
+      const size_t base_count = baseline ? baseline->size() : 0u;
+      const size_t previous_count = previous ? previous->size() : 0u;
+      base_slots_.resize(relevant_.size());
+      previous_slots_.resize(relevant_.size());
+      state_.resize(relevant_.size());
+      candidates_.clear();
+      size_t committed_bits = 0u;
+      size_t b = 0u, p = 0u;
+      for (size_t r = 0u; r < relevant_.size(); ++r)
+      {
+        const uint32_t i  = relevant_[r];
+        const uint32_t id = snapshot.ids[i];
+        while (b < base_count && baseline->ids[b] < id)
+          b++;
+        while (p < previous_count && previous->ids[p] < id)
+          p++;
+        const bool in_baseline = b < base_count && baseline->ids[b] == id;
+        const bool in_previous = p < previous_count && previous->ids[p] == id;
+        const bool known = in_baseline || in_previous;
+        base_slots_[r]     = in_baseline ? (uint32_t)b : kNewEntity;
+        previous_slots_[r] = in_previous ? (uint32_t)p : kNewEntity;
+
+        bool inside = client.observers.empty();
+        float distance = client.observers.empty() ? 0.0f : FLT_MAX;
+        if (!inside)
+        {
+          const glm::vec3 position = dequantizePosition(snapshot.transforms[i]);
+          for (const Observer& observer : client.observers)
+          {
+            const float d = glm::length(position - observer.position);
+            distance = eastl::min(distance, d);
+            inside |= d <= observer.radius * (known ? kInterestHysteresis : 1.0f);
+          }
+        }
+        if (!inside)
+        {
+          state_[r] = kStateOmit;
+          continue;
+        }
+
+        const uint32_t bits = getEntityBits(snapshot, i, in_baseline ? baseline : nullptr, b);
+        if (bits == 0u)
+        {
+          state_[r] = kStateSend;
+          client.waiting.erase(id);
+          continue;
+        }
+
+        // Until it is chosen, the client gets what it was sent last time
+        // again, in case that was lost.
+        uint32_t carry_bits = 0u;
+        if (in_previous)
+        {
+          state_[r] = kStateCarry;
+          carry_bits = getEntityBits(*previous, p, in_baseline ? baseline : nullptr, b);
+          committed_bits += carry_bits;
+        }
+        else
+          state_[r] = kStateOmit;
+
+        // Closer entities catch up sooner.
+        const float priority = snapshot.priorities.empty() ? 1.0f : snapshot.priorities[i];
+        ClientInterest::Waiting& waiting = client.waiting[id];
+        if (waiting.tick + 1u != client.ticks)
+          waiting.priority = 0.0f;
+        waiting.priority += priority * zone_size / (zone_size + distance);
+        waiting.tick = client.ticks;
+        candidates_.push_back({ waiting.priority, (uint32_t)r, bits > carry_bits ? bits - carry_bits : 0u });
+      }
+
+      if (budget_ == 0u)
+      {
+        for (const Candidate& candidate : candidates_)
+        {
+          state_[candidate.index] = kStateSend;
+          client.waiting.erase(snapshot.ids[relevant_[candidate.index]]);
+        }
+      }
+      else
+      {
+        eastl::sort(candidates_.begin(), candidates_.end(), [](const Candidate& lhs, const Candidate& rhs) { return lhs.priority > rhs.priority; });
+        const size_t used_bits = kHeaderBits + committed_bits;
+        size_t bits_left = budget_ * 8u > used_bits ? budget_ * 8u - used_bits : 0u;
+        for (const Candidate& candidate : candidates_)
+        {
+          // Smaller changes further down can still fit.
+          if (candidate.bits > bits_left)
+            continue;
+          bits_left -= candidate.bits;
+          state_[candidate.index] = kStateSend;
+          client.waiting.erase(snapshot.ids[relevant_[candidate.index]]);
+        }
+      }
+
+      sent.clear();
+      sent.sequence   = snapshot.sequence;
+      sent.time       = snapshot.time;
+      sent.field_bits = snapshot.field_bits;
+      for (size_t r = 0u; r < relevant_.size(); ++r)
+      {
+        if (state_[r] == kStateSend)
+          copyEntity(snapshot, relevant_[r], sent);
+        else if (state_[r] == kStateCarry)
+          copyEntity(*previous, previous_slots_[r], sent);
+      }
+      encodeSnapshot(sent, baseline, writer);
+      client.last_sent = sent.sequence;
+
+      // Acks only move forward, so what came before the one that was acked
+      // is never a baseline again.
+      if (acked != kNoSnapshot)
+      {
+        for (Snapshot& old : client.history)
+          if (old.sequence != kNoSnapshot && old.sequence < acked)
+            old = Snapshot();
+      }
+
+      if (client.ticks % kWaitingSweep == 0u)
+      {
+        for (auto it = client.waiting.begin(); it != client.waiting.end();)
+        {
+          if (it->second.tick != client.ticks)
+            it = client.waiting.erase(it);
+          else
+            ++it;
+        }
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void InterestManager::setBudget(size_t bytes)
+    {
+      budget_ = bytes;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t InterestManager::getBudget() const
+    {
+      return budget_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void InterestManager::setZoneSize(float zone_size)
+    {
+      grid_ = InterestGrid(zone_size);
+    }
+  }
+}
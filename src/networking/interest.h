@@ -0,0 +1,114 @@
+#pragma once
+#include "snapshot.h"
+
+namespace lambda
+{
+  namespace networking
+  {
+    class MessageWriter;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // The zones of utilities::ZoneManager: squares on the x/z plane, with
+    // zone (0, 0) from the origin up to kZoneSize.
+    static constexpr float kZoneSize = 25.0f;
+    // Entities a client already has stay relevant until they are this much
+    // further away than the radius, so they do not flicker at the edge.
+    static constexpr float kInterestHysteresis = 1.25f;
+    static constexpr uint32_t kMaxObservers = 16u;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Where a client looks from. Only entities within radius of one of the
+    // observers of a client are sent to it.
+    struct Observer
+    {
+      glm::vec3 position;
+      float     radius;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // The entities of a snapshot, binned in zones on their position.
+    class InterestGrid
+    {
+    public:
+      explicit InterestGrid(float zone_size = kZoneSize);
+
+      void build(const Snapshot& snapshot);
+      // Appends the snapshot index of every entity in the zones that touch
+      // the square around position. Indices can repeat across queries.
+      void query(const glm::vec3& position, float radius, Vector<uint32_t>& indices) const;
+      float getZoneSize() const;
+      // The same key as utilities::ZoneManager gives the zone.
+      static uint32_t hash(int16_t x, int16_t y);
+
+    private:
+      float zone_size_;
+      // On hash. Cleared between builds, and erased once nothing is in them.
+      UnorderedMap<uint32_t, Vector<uint32_t>> zones_;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // The state the server keeps per client to filter its snapshots.
+    struct ClientInterest
+    {
+      Vector<Observer> observers;
+      // What the client was sent. Sequences are those of the snapshots the
+      // server pushed, so acks mean the same thing in either mode. Only the
+      // last acked one and those after it are kept, the others are empty.
+      Snapshot history[kSnapshotHistory];
+      // How long entities waited to be sent, on their id. Reset when sent.
+      struct Waiting
+      {
+        float    priority;
+        uint32_t tick;
+      };
+      UnorderedMap<uint32_t, Waiting> waiting;
+      uint32_t last_sent = kNoSnapshot;
+      uint32_t ticks = 0u;
+      bool filtered = false;
+
+      const Snapshot* find(uint32_t sequence) const;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Chooses what every client gets of a snapshot. Entities near one of
+    // the observers of a client are relevant to it. Relevant entities that
+    // changed gain their priority, scaled down with distance, every tick
+    // until they are sent. The ones with the most are sent first, until
+    // the byte budget of the client is used. The others keep the state
+    // they were last sent with, so distant entities update less often.
+    // Resending that state until it is acked comes out of the budget
+    // first.
+    class InterestManager
+    {
+    public:
+      // Bins the entities of the snapshot of this tick.
+      void update(const Snapshot& snapshot);
+      // Encodes what the client gets of the snapshot against the last one
+      // it acked, and keeps it to delta against later.
+      void encode(const Snapshot& snapshot, ClientInterest& client, uint32_t acked, MessageWriter& writer);
+
+      // Bytes per client per snapshot. 0 sends every relevant change.
+      void setBudget(size_t bytes);
+      size_t getBudget() const;
+      void setZoneSize(float zone_size);
+
+    private:
+      struct Candidate
+      {
+        float    priority;
+        uint32_t index;
+        uint32_t bits;
+      };
+
+      InterestGrid grid_;
+      size_t budget_ = 0u;
+
+      // Reused for every client.
+      Vector<uint32_t> relevant_;
+      Vector<uint32_t> base_slots_;
+      Vector<uint32_t> previous_slots_;
+      Vector<uint8_t> state_;
+      Vector<Candidate> candidates_;
+    };
+  }
+}
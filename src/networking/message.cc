@@ -1,5 +1,6 @@
 #include "message.h"
 #include <enet/enet.h>
+#include "message_codec.h"
 #include "messages.h"
 
 namespace lambda
@@ -35,6 +36,12 @@ namespace lambda
       return client_;
     }
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t MessagePacket::getConnectId() const
+    {
+      return connect_id_;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void MessagePacket::addMessage(Message message)
     {
@@ -115,10 +122,11 @@ namespace lambda
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    MessagePacket MessagePacket::fromConnectedClient(ENetPeer * client)
+    MessagePacket MessagePacket::fromConnectedClient(ENetPeer * client, uint32_t connect_id)
     {
       MessagePacket packet;
       packet.client_ = client;
+      packet.connect_id_ = connect_id;
       packet.addMessage(Message(MESSAGE_CONNECTED, ""));
       return packet;
     }
@@ -134,6 +142,7 @@ namespace lambda
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     Message::Message() :
+      client_id(0),
       header_size(0),
       header(""),
       message_size(0),
@@ -143,6 +152,7 @@ namespace lambda
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     Message::Message(String header, String message) :
+      client_id(0),
       header_size((uint8_t)strlen(header.c_str())),
       header(header),
       message_size((uint8_t)strlen(message.c_str())),
@@ -150,6 +160,26 @@ namespace lambda
     {
     }
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Message::write(MessageWriter& writer) const
+    {
+      writer.writeString(header);
+      writer.writeString(message);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    Message Message::read(const MessageView& view)
+    {
+      MessageReader reader = view.reader();
+      Message message;
+      message.client_id    = view.sender;
+      message.header       = reader.readString();
+      message.header_size  = (uint8_t)message.header.size();
+      message.message      = reader.readString();
+      message.message_size = (uint8_t)message.message.size();
+      return message;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     String Message::asString() const
     {
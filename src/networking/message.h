@@ -11,15 +11,26 @@ namespace lambda
 {
   namespace networking
   {
+    class MessageWriter;
+    struct MessageView;
+
+    // What the server calls a client. 0 is the server itself. IDs of
+    // clients that left are given out again, oldest first.
+    typedef uint32_t ClientId;
+    static constexpr ClientId kServerId = 0u;
+
     class Message
     {
     public:
       Message();
       Message(String header, String message);
       String asString() const;
+      // As the payload of a kMessageTypeString message.
+      void write(MessageWriter& writer) const;
+      static Message read(const MessageView& view);
 
-      // Header.
-      uint8_t client_id;
+      // Header. The String codec only has room for the low byte.
+      ClientId client_id;
       uint8_t header_size;
       String  header;
       // Message.
@@ -37,21 +48,27 @@ namespace lambda
       uint8_t messageCount() const;
       Message getMessage(uint8_t index) const;
       ENetPeer* getClient() const;
+      uint32_t getConnectId() const;
 
       // Setters.
       void addMessage(Message message);
       
       // Misc.
+      // The String codec that was sent over the wire before the binary
+      // messages of message_codec.h. Kept to compare against.
       void read(ENetPacket* packet);
       ENetPacket* asPacket();
       void clear();
-      static MessagePacket fromConnectedClient(ENetPeer* client);
+      // The connect ID is read by whoever services the host, as ENet can
+      // change it while the peer is in use there.
+      static MessagePacket fromConnectedClient(ENetPeer* client, uint32_t connect_id);
       static MessagePacket fromDisonnectedClient(ENetPeer* client);
 
     private:
       // Client ID 0 means server.
       Vector<Message> messages_;
       ENetPeer*       client_ = 0; // For connecting and disconnecting.
+      uint32_t        connect_id_ = 0u;
     };
   }
 }
\ No newline at end of file
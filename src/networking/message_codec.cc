@@ -0,0 +1,408 @@
+#include "message_codec.h"
+#include <enet/enet.h>
+
+namespace lambda
+{
+  namespace networking
+  {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t getPacketFlags(Delivery delivery)
+    {
+      switch (delivery)
+      {
+      case Delivery::kReliable:
+        return ENET_PACKET_FLAG_RELIABLE;
+      case Delivery::kUnreliableSequenced:
+        return ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+      case Delivery::kUnreliable:
+        return ENET_PACKET_FLAG_UNSEQUENCED | ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+      }
+      return ENET_PACKET_FLAG_RELIABLE;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t writeVarint(uint8_t* output, uint64_t value)
+    {
+      size_t size = 0u;
+      while (value >= 0x80u)
+      {
+        output[size++] = (uint8_t)(value | 0x80u);
+        value >>= 7u;
+      }
+      output[size++] = (uint8_t)value;
+      return size;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t readVarint(const uint8_t* input, size_t size, uint64_t& value)
+    {
+      value = 0u;
+      for (size_t i = 0u; i < size && i < kMaxVarintSize; ++i)
+      {
+        value |= (uint64_t)(input[i] & 0x7Fu) << (7u * i);
+        if ((input[i] & 0x80u) == 0u)
+          return i + 1u;
+      }
+      return 0u;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    BufferPool::~BufferPool()
+    {
+      for (Vector<uint8_t>* buffer : free_)
+        delete buffer;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    Vector<uint8_t>* BufferPool::acquire()
+    {
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (!free_.empty())
+        {
+          Vector<uint8_t>* buffer = free_.back();
+          free_.pop_back();
+          return buffer;
+        }
+      }
+
+      Vector<uint8_t>* buffer = new Vector<uint8_t>();
+      buffer->reserve(kMaxBatchSize);
+      return buffer;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void BufferPool::release(Vector<uint8_t>* buffer)
+    {
+      buffer->clear();
+      std::lock_guard<std::mutex> guard(lock_);
+      free_.push_back(buffer);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    BufferPool& BufferPool::get()
+    {
+      static BufferPool pool;
+      return pool;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    MessageWriter::MessageWriter() :
+      buffer_(BufferPool::get().acquire())
+    {
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    MessageWriter::~MessageWriter()
+    {
+      BufferPool::get().release(buffer_);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageWriter::writeVarint(uint64_t value)
+    {
+      uint8_t bytes[kMaxVarintSize];
+      writeBytes(bytes, networking::writeVarint(bytes, value));
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageWriter::writeSignedVarint(int64_t value)
+    {
+      writeVarint(((uint64_t)value << 1u) ^ (uint64_t)(value >> 63));
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageWriter::writeBytes(const void* data, size_t size)
+    {
+      const uint8_t* bytes = (const uint8_t*)data;
+      buffer_->insert(buffer_->end(), bytes, bytes + size);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageWriter::writeString(const String& value)
+    {
+      writeVarint(value.size());
+      writeBytes(value.data(), value.size());
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageWriter::clear()
+    {
+      buffer_->clear();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    const uint8_t* MessageWriter::data() const
+    {
+      return buffer_->data();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t MessageWriter::size() const
+    {
+      return buffer_->size();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    MessageReader::MessageReader(const uint8_t* data, size_t size) :
+      data_(data),
+      size_(size)
+    {
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint64_t MessageReader::readVarint()
+    {
+      uint64_t value = 0u;
+      const size_t read = valid_ ? networking::readVarint(data_ + offset_, size_ - offset_, value) : 0u;
+      if (read == 0u)
+      {
+        valid_ = false;
+        return 0u;
+      }
+      offset_ += read;
+      return value;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    int64_t MessageReader::readSignedVarint()
+    {
+      const uint64_t value = readVarint();
+      return (int64_t)(value >> 1u) ^ -(int64_t)(value & 1u);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    const uint8_t* MessageReader::readBytes(size_t size)
+    {
+      if (!valid_ || size > size_ - offset_)
+      {
+        valid_ = false;
+        return nullptr;
+      }
+      const uint8_t* bytes = data_ + offset_;
+      offset_ += size;
+      return bytes;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    String MessageReader::readString()
+    {
+      const size_t size = (size_t)readVarint();
+      const uint8_t* bytes = readBytes(size);
+      return bytes ? String((const char*)bytes, (const char*)bytes + size) : String();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool MessageReader::isValid() const
+    {
+      return valid_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t MessageReader::remaining() const
+    {
+      return size_ - offset_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // ENet frees packets that were made with ENET_PACKET_FLAG_NO_ALLOCATE
+    // without touching their data, so the buffer goes back here.
+    static void ENET_CALLBACK releasePacketBuffer(ENetPacket* packet)
+    {
+      BufferPool::get().release((Vector<uint8_t>*)packet->userData);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    PacketWriter::PacketWriter() :
+      buffer_(BufferPool::get().acquire())
+    {
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    PacketWriter::~PacketWriter()
+    {
+      if (buffer_ != nullptr)
+        BufferPool::get().release(buffer_);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    PacketWriter::PacketWriter(PacketWriter&& other) :
+      buffer_(other.buffer_)
+    {
+      other.buffer_ = nullptr;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    PacketWriter& PacketWriter::operator=(PacketWriter&& other)
+    {
+      eastl::swap(buffer_, other.buffer_);
+      return *this;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool PacketWriter::fits(size_t payload_size) const
+    {
+      return buffer_->empty() || buffer_->size() + 3u * kMaxVarintSize + payload_size <= kMaxBatchSize;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void PacketWriter::add(uint32_t type, uint32_t sender, const uint8_t* data, size_t size)
+    {
+      uint8_t header[3u * kMaxVarintSize];
+      size_t header_size = 0u;
+      header_size += writeVarint(header + header_size, type);
+      header_size += writeVarint(header + header_size, sender);
+      header_size += writeVarint(header + header_size, size);
+
+      buffer_->insert(buffer_->end(), header, header + header_size);
+      buffer_->insert(buffer_->end(), data, data + size);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool PacketWriter::empty() const
+    {
+      return buffer_->empty();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t PacketWriter::size() const
+    {
+      return buffer_->size();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ENetPacket* PacketWriter::finish(Delivery delivery)
+    {
+      ENetPacket* packet = enet_packet_create(
+        buffer_->data(),
+        buffer_->size(),
+        getPacketFlags(delivery) | ENET_PACKET_FLAG_NO_ALLOCATE
+      );
+      if (packet == nullptr)
+      {
+        buffer_->clear();
+        return nullptr;
+      }
+
+      packet->userData     = buffer_;
+      packet->freeCallback = releasePacketBuffer;
+      buffer_ = BufferPool::get().acquire();
+      return packet;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ReceivedPacket::ReceivedPacket()
+    {
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ReceivedPacket::ReceivedPacket(ENetPacket* packet, ENetPeer* peer, uint8_t channel) :
+      packet_(packet),
+      peer_(peer),
+      channel_(channel)
+    {
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ReceivedPacket::ReceivedPacket(ReceivedPacket&& other) :
+      packet_(other.packet_),
+      peer_(other.peer_),
+      channel_(other.channel_),
+      offset_(other.offset_),
+      valid_(other.valid_)
+    {
+      other.packet_ = nullptr;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ReceivedPacket& ReceivedPacket::operator=(ReceivedPacket&& other)
+    {
+      if (this != &other)
+      {
+        release();
+        packet_  = other.packet_;
+        peer_    = other.peer_;
+        channel_ = other.channel_;
+        offset_  = other.offset_;
+        valid_   = other.valid_;
+        other.packet_ = nullptr;
+      }
+      return *this;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ReceivedPacket::~ReceivedPacket()
+    {
+      release();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool ReceivedPacket::next(MessageView& message)
+    {
+      if (packet_ == nullptr || !valid_ || offset_ >= packet_->dataLength)
+        return false;
+
+      const uint8_t* data = packet_->data;
+      const size_t   size = packet_->dataLength;
+      uint64_t type = 0u, sender = 0u, length = 0u;
+      size_t offset = offset_;
+      auto field = [&](uint64_t& value) {
+        const size_t read = readVarint(data + offset, size - offset, value);
+        offset += read;
+        return read != 0u;
+      };
+
+      if (!field(type) || !field(sender) || !field(length) || length > size - offset)
+      {
+        valid_ = false;
+        return false;
+      }
+
+      message.type   = (uint32_t)type;
+      message.sender = (uint32_t)sender;
+      message.data   = data + offset;
+      message.size   = (size_t)length;
+      offset_ = offset + (size_t)length;
+      return true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void ReceivedPacket::rewind()
+    {
+      offset_ = 0u;
+      valid_  = true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool ReceivedPacket::isValid() const
+    {
+      return valid_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ENetPeer* ReceivedPacket::getPeer() const
+    {
+      return peer_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint8_t ReceivedPacket::getChannel() const
+    {
+      return channel_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t ReceivedPacket::size() const
+    {
+      return packet_ ? packet_->dataLength : 0u;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void ReceivedPacket::release()
+    {
+      if (packet_ != nullptr)
+        enet_packet_destroy(packet_);
+      packet_ = nullptr;
+    }
+  }
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include <containers/containers.h>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+struct _ENetPacket;
+typedef _ENetPacket ENetPacket;
+
+struct _ENetPeer;
+typedef _ENetPeer ENetPeer;
+
+namespace lambda
+{
+  namespace networking
+  {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // How the packets of a channel are delivered.
+    enum class Delivery : uint8_t
+    {
+      kReliable,            // Resent until they arrive, in order.
+      kUnreliableSequenced, // Never resent. Packets older than the last one are dropped.
+      kUnreliable,          // Never resent, in any order.
+    };
+
+    // The channels that the client and the server open, and how they are
+    // delivered unless MessageManager::setDelivery says otherwise.
+    enum Channel : uint8_t
+    {
+      kChannelReliable   = 0u,
+      kChannelSequenced  = 1u,
+      kChannelUnreliable = 2u,
+      kChannelCount      = 3u,
+    };
+
+    // The ENet packet flags for a delivery. Packets that are not reliable
+    // are fragmented unreliably when they are larger than the MTU.
+    uint32_t getPacketFlags(Delivery delivery);
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Messages are batched into packets as
+    //   [varint type][varint sender][varint size][size bytes of payload]
+    // over and over. Varints are little endian groups of 7 bits with the
+    // high bit set on all but the last byte. Batches are closed at
+    // kMaxBatchSize, but a single message can be as large as ENet allows.
+    static constexpr size_t kMaxBatchSize  = 1200u;
+    static constexpr size_t kMaxVarintSize = 10u;
+
+    size_t writeVarint(uint8_t* output, uint64_t value);
+    // Returns how many bytes were read, or 0 when the varint does not end
+    // before size bytes.
+    size_t readVarint(const uint8_t* input, size_t size, uint64_t& value);
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Byte buffers that are reused for both payloads and packets. Packets
+    // that are made from them give their buffer back when ENet frees them,
+    // on whatever thread that happens.
+    class BufferPool
+    {
+    public:
+      ~BufferPool();
+      Vector<uint8_t>* acquire();
+      void release(Vector<uint8_t>* buffer);
+      static BufferPool& get();
+
+    private:
+      std::mutex lock_;
+      Vector<Vector<uint8_t>*> free_;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Builds the payload of one message in a pooled buffer. Values are
+    // written as they are in memory, which is little endian on every
+    // platform that is supported.
+    class MessageWriter
+    {
+    public:
+      MessageWriter();
+      ~MessageWriter();
+      MessageWriter(const MessageWriter&) = delete;
+      MessageWriter& operator=(const MessageWriter&) = delete;
+
+      template<typename T>
+      void write(const T& value)
+      {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+        writeBytes(&value, sizeof(T));
+      }
+      void writeVarint(uint64_t value);
+      // Zig zag encoded so small negative values stay small.
+      void writeSignedVarint(int64_t value);
+      void writeBytes(const void* data, size_t size);
+      // Varint size followed by the characters.
+      void writeString(const String& value);
+      void clear();
+
+      const uint8_t* data() const;
+      size_t size() const;
+
+    private:
+      Vector<uint8_t>* buffer_;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Reads a payload without copying it. Reads past the end return zeros
+    // and make isValid() false, so a message can be read whole and checked
+    // once.
+    class MessageReader
+    {
+    public:
+      MessageReader(const uint8_t* data, size_t size);
+
+      template<typename T>
+      T read()
+      {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+        T value;
+        const uint8_t* bytes = readBytes(sizeof(T));
+        if (bytes)
+          memcpy(&value, bytes, sizeof(T));
+        else
+          memset(&value, 0, sizeof(T));
+        return value;
+      }
+      uint64_t readVarint();
+      int64_t readSignedVarint();
+      // Points into the packet, so it is only valid as long as the packet.
+      const uint8_t* readBytes(size_t size);
+      String readString();
+
+      bool isValid() const;
+      size_t remaining() const;
+
+    private:
+      const uint8_t* data_;
+      size_t size_;
+      size_t offset_ = 0u;
+      bool   valid_  = true;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    struct MessageView
+    {
+      uint32_t       type   = 0u;
+      uint32_t       sender = 0u;
+      const uint8_t* data   = nullptr;
+      size_t         size   = 0u;
+
+      MessageReader reader() const { return MessageReader(data, size); }
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Batches messages into one pooled buffer and hands it to ENet without
+    // copying it.
+    class PacketWriter
+    {
+    public:
+      PacketWriter();
+      ~PacketWriter();
+      PacketWriter(PacketWriter&& other);
+      PacketWriter& operator=(PacketWriter&& other);
+      PacketWriter(const PacketWriter&) = delete;
+      PacketWriter& operator=(const PacketWriter&) = delete;
+
+      // Whether a message of this size still fits in the batch. Always true
+      // for an empty batch.
+      bool fits(size_t payload_size) const;
+      void add(uint32_t type, uint32_t sender, const uint8_t* data, size_t size);
+      bool empty() const;
+      size_t size() const;
+      // The buffer now belongs to the packet, and the writer starts over.
+      ENetPacket* finish(Delivery delivery);
+
+    private:
+      Vector<uint8_t>* buffer_;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Owns a packet that was received and reads its messages in place.
+    class ReceivedPacket
+    {
+    public:
+      ReceivedPacket();
+      ReceivedPacket(ENetPacket* packet, ENetPeer* peer, uint8_t channel);
+      ReceivedPacket(ReceivedPacket&& other);
+      ReceivedPacket& operator=(ReceivedPacket&& other);
+      ReceivedPacket(const ReceivedPacket&) = delete;
+      ReceivedPacket& operator=(const ReceivedPacket&) = delete;
+      ~ReceivedPacket();
+
+      // The next message, until there are none left or the packet turns
+      // out to be malformed.
+      bool next(MessageView& message);
+      void rewind();
+      bool isValid() const;
+
+      ENetPeer* getPeer() const;
+      uint8_t getChannel() const;
+      size_t size() const;
+
+    private:
+      void release();
+
+    private:
+      ENetPacket* packet_  = nullptr;
+      ENetPeer*   peer_    = nullptr;
+      uint8_t     channel_ = 0u;
+      size_t      offset_  = 0u;
+      bool        valid_   = true;
+    };
+  }
+}
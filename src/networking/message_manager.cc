@@ -1,10 +1,26 @@
 #include "message_manager.h"
+#include "network_thread.h"
 #include <enet/enet.h>
+#include <utils/console.h>
+#include "messages.h"
+#include <cmath>
 
 namespace lambda
 {
   namespace networking
   {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    MessageManager::MessageManager() = default;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    MessageManager::~MessageManager() = default;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    MessageManager::MessageManager(MessageManager&& other) = default;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    MessageManager& MessageManager::operator=(MessageManager&& other) = default;
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void MessageManager::connect(ENetHost* server)
     {
@@ -23,20 +39,72 @@ namespace lambda
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void MessageManager::update(double delta_time)
     {
+      // Ticks that were missed are not made up for. Starts on a tick.
       elapsed_time_ += delta_time;
-      
-      if (elapsed_time_ >= frequency_)
-      {
-        elapsed_time_ -= frequency_;
+      const bool tick = elapsed_time_ >= frequency_;
+      if (tick)
+        elapsed_time_ = fmod(elapsed_time_, frequency_);
+
+      if (tick || flush_policy_ == FlushPolicy::kImmediate)
         sendMessages();
-        pollMessages();
-      }
+      pollMessages();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::flush()
+    {
+      sendMessages();
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void MessageManager::sendMessage(Message message)
     {
-      packet_to_send_.addMessage(message);
+      MessageWriter payload;
+      message.write(payload);
+
+      if (!string_writer_.fits(payload.size()))
+        finishBatch(kChannelReliable, string_writer_, Delivery::kReliable);
+      string_writer_.add(kMessageTypeString, message.client_id, payload.data(), payload.size());
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::sendMessage(uint32_t type, uint32_t sender, const MessageWriter& payload, uint8_t channel)
+    {
+      sendMessage(type, sender, payload.data(), payload.size(), channel);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::sendMessage(uint32_t type, uint32_t sender, const uint8_t* data, size_t size, uint8_t channel)
+    {
+      if (channel >= kChannelCount)
+      {
+        LMB_LOG_ERR("[NETWORKING] Channel %i does not exist.", channel);
+        return;
+      }
+
+      // Full batches go out as they are, so the ones that are not
+      // reliable stay under the MTU. Larger messages get a batch of their
+      // own that ENet fragments.
+      PacketWriter& writer = writers_[channel];
+      if (!writer.fits(size))
+        finishBatch(channel, writer, deliveries_[channel]);
+      writer.add(type, sender, data, size);
+    }
+    
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::sendMessage(ENetPeer* peer, uint32_t type, uint32_t sender, const MessageWriter& payload, uint8_t channel)
+    {
+      if (channel >= kChannelCount)
+      {
+        LMB_LOG_ERR("[NETWORKING] Channel %i does not exist.", channel);
+        return;
+      }
+
+      PacketWriter writer;
+      writer.add(type, sender, payload.data(), payload.size());
+      ENetPacket* packet = writer.finish(deliveries_[channel]);
+      if (packet != nullptr)
+        packets_to_send_.push_back({ channel, packet, peer });
     }
     
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,11 +114,17 @@ namespace lambda
       {
         return false;
       }
+      else if (true == packets.empty())
+      {
+        // Both keep their memory.
+        packets.swap(packets_to_receive_);
+        return true;
+      }
       else
       {
-        for (const auto& packet : packets_to_receive_)
+        for (auto& packet : packets_to_receive_)
         {
-          packets.push_back(packet);
+          packets.push_back(eastl::move(packet));
         }
 
         packets_to_receive_.clear();
@@ -58,6 +132,35 @@ namespace lambda
       }
     }
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool MessageManager::receivePackets(Vector<ReceivedPacket>& packets)
+    {
+      if (received_packets_.empty())
+        return false;
+
+      for (auto& packet : received_packets_)
+        packets.push_back(eastl::move(packet));
+      received_packets_.clear();
+      return true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::setDelivery(uint8_t channel, Delivery delivery)
+    {
+      if (channel >= kChannelCount)
+      {
+        LMB_LOG_ERR("[NETWORKING] Channel %i does not exist.", channel);
+        return;
+      }
+      deliveries_[channel] = delivery;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    Delivery MessageManager::getDelivery(uint8_t channel) const
+    {
+      return channel < kChannelCount ? deliveries_[channel] : Delivery::kReliable;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void MessageManager::setUpdateRate(uint8_t hertz)
     {
@@ -77,45 +180,141 @@ namespace lambda
       return frequency_;
     }
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::setFlushPolicy(FlushPolicy policy)
+    {
+      flush_policy_ = policy;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    FlushPolicy MessageManager::getFlushPolicy() const
+    {
+      return flush_policy_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::startThread(uint32_t service_timeout)
+    {
+      if (host_ == nullptr || thread_)
+        return;
+      thread_ = foundation::Memory::constructUnique<NetworkThread>(host_, is_server_ ? nullptr : client_, service_timeout);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::stopThread()
+    {
+      if (!thread_)
+        return;
+
+      // Sends what is left, and hands over what came in meanwhile.
+      thread_->stop();
+      pollMessages();
+      thread_.reset();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool MessageManager::isThreaded() const
+    {
+      return (bool)thread_;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void MessageManager::pollMessages()
     {
       ENetEvent event;
+      if (thread_)
+      {
+        thread_->flush();
+        while (thread_->receive(event))
+          handleEvent(event);
+        return;
+      }
+
+      // The same as NetworkThread hands them over.
       while (enet_host_service(host_, &event, 0) > 0)
       {
-        switch (event.type)
+        if (event.type == ENET_EVENT_TYPE_CONNECT)
+          event.data = event.peer->connectID;
+        handleEvent(event);
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::handleEvent(const ENetEvent& event)
+    {
+      switch (event.type)
+      {
+      case ENET_EVENT_TYPE_CONNECT:
+        packets_to_receive_.push_back(MessagePacket::fromConnectedClient(event.peer, event.data));
+        break;
+      case ENET_EVENT_TYPE_RECEIVE:
+      {
+        // Header and message pairs are batched apart from the binary
+        // messages, so the first message says what the packet holds.
+        ReceivedPacket packet(event.packet, event.peer, event.channelID);
+        MessageView message;
+        if (packet.next(message) && message.type == kMessageTypeString)
         {
-        case ENET_EVENT_TYPE_CONNECT:
-          packets_to_receive_.push_back(MessagePacket::fromConnectedClient(event.peer));
-          break;
-        case ENET_EVENT_TYPE_RECEIVE:
-          packets_to_receive_.push_back(MessagePacket(event.packet));
-          break;
-        case ENET_EVENT_TYPE_DISCONNECT:
-          packets_to_receive_.push_back(MessagePacket::fromDisonnectedClient(event.peer));
-          break;
-        case ENET_EVENT_TYPE_NONE:
-            break;
+          MessagePacket strings;
+          do
+          {
+            strings.addMessage(Message::read(message));
+          } while (packet.next(message));
+          packets_to_receive_.push_back(strings);
         }
+        else if (packet.isValid())
+        {
+          packet.rewind();
+          received_packets_.push_back(eastl::move(packet));
+        }
+
+        if (!packet.isValid())
+          LMB_LOG_ERR("[NETWORKING] Dropped a malformed packet of %i bytes.", (int)event.packet->dataLength);
+        break;
+      }
+      case ENET_EVENT_TYPE_DISCONNECT:
+        packets_to_receive_.push_back(MessagePacket::fromDisonnectedClient(event.peer));
+        break;
+      case ENET_EVENT_TYPE_NONE:
+          break;
       }
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void MessageManager::sendMessages()
     {
-      if (packet_to_send_.messageCount() > 0)
+      if (!string_writer_.empty())
+        finishBatch(kChannelReliable, string_writer_, Delivery::kReliable);
+      for (uint8_t channel = 0u; channel < kChannelCount; ++channel)
       {
-        ENetPacket* packet = packet_to_send_.asPacket();
+        if (!writers_[channel].empty())
+          finishBatch(channel, writers_[channel], deliveries_[channel]);
+      }
 
-        if (true == is_server_)
+      for (const OutgoingPacket& outgoing : packets_to_send_)
+      {
+        if (thread_)
         {
-          enet_host_broadcast(host_, 0, packet);
+          thread_->send(outgoing);
         }
-        else
+        else if (true == is_server_ && outgoing.peer == nullptr)
         {
-          enet_peer_send(client_, 1, packet);
+          enet_host_broadcast(host_, outgoing.channel, outgoing.packet);
+        }
+        else if (enet_peer_send(outgoing.peer ? outgoing.peer : client_, outgoing.channel, outgoing.packet) != 0)
+        {
+          enet_packet_destroy(outgoing.packet);
         }
       }
+      packets_to_send_.clear();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void MessageManager::finishBatch(uint8_t channel, PacketWriter& writer, Delivery delivery)
+    {
+      ENetPacket* packet = writer.finish(delivery);
+      if (packet != nullptr)
+        packets_to_send_.push_back({ channel, packet, nullptr });
     }
   }
 }
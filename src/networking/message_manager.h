@@ -1,43 +1,110 @@
 #pragma once
 #include "message.h"
+#include "message_codec.h"
+#include <memory/memory.h>
 #include <limits>
 
 struct _ENetPeer;
 typedef _ENetPeer ENetPeer;
 struct _ENetHost;
 typedef _ENetHost ENetHost;
+struct _ENetEvent;
+typedef _ENetEvent ENetEvent;
 
 namespace lambda
 {
   namespace networking
   {
+    class NetworkThread;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    struct OutgoingPacket
+    {
+      uint8_t     channel;
+      ENetPacket* packet;
+      // Everyone when null.
+      ENetPeer*   peer;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // When what was sent goes out.
+    enum class FlushPolicy : uint8_t
+    {
+      kOnTick,    // Once per 1 / update rate, batched.
+      kImmediate, // At the end of every update.
+    };
+
     class MessageManager
     {
     public:
+      MessageManager();
+      ~MessageManager();
+      MessageManager(MessageManager&& other);
+      MessageManager& operator=(MessageManager&& other);
+
       void connect(ENetHost* server);
       void connect(ENetHost* host, ENetPeer* peer);
 
+      // Takes in what was received, every time. Sends on the tick, or
+      // every time with FlushPolicy::kImmediate.
       void update(double delta_time);
+      // Sends everything that was sent since the last update now.
+      void flush();
 
+      // Header and message pairs. Always sent reliably on kChannelReliable.
       void sendMessage(Message message);
       bool receiveMessages(Vector<MessagePacket>& packet);
+
+      // Binary messages. The server sends them to every client. Messages
+      // on one channel are batched until the next update, and go out in
+      // the order they were sent in.
+      void sendMessage(uint32_t type, uint32_t sender, const MessageWriter& payload, uint8_t channel = kChannelReliable);
+      void sendMessage(uint32_t type, uint32_t sender, const uint8_t* data, size_t size, uint8_t channel);
+      bool receivePackets(Vector<ReceivedPacket>& packets);
+      // A message for one peer only, in a packet of its own with the
+      // delivery of the channel. Goes out with the next update.
+      void sendMessage(ENetPeer* peer, uint32_t type, uint32_t sender, const MessageWriter& payload, uint8_t channel);
+
+      void setDelivery(uint8_t channel, Delivery delivery);
+      Delivery getDelivery(uint8_t channel) const;
       void setUpdateRate(uint8_t hertz);
       uint8_t getUpdateRate() const;
       double getFrequency() const;
+      void setFlushPolicy(FlushPolicy policy);
+      FlushPolicy getFlushPolicy() const;
+
+      // Services the host on a thread of its own, so packets are received
+      // as they arrive and sent within service_timeout milliseconds of a
+      // flush. Stop it before using the host anywhere else.
+      void startThread(uint32_t service_timeout = 1u);
+      void stopThread();
+      bool isThreaded() const;
 
     private:
       void pollMessages();
+      void handleEvent(const ENetEvent& event);
       void sendMessages();
+      void finishBatch(uint8_t channel, PacketWriter& writer, Delivery delivery);
 
     private:
       uint8_t update_rate_ = 60;
       double frequency_    = 0.01666667;
       double elapsed_time_ = std::numeric_limits<double>::max();
+      FlushPolicy flush_policy_ = FlushPolicy::kOnTick;
       bool is_server_      = true;
       ENetHost* host_      = nullptr;
       ENetPeer* client_    = nullptr;
-      MessagePacket packet_to_send_;
+      Delivery deliveries_[kChannelCount] = {
+        Delivery::kReliable,
+        Delivery::kUnreliableSequenced,
+        Delivery::kUnreliable,
+      };
+      PacketWriter string_writer_;
+      PacketWriter writers_[kChannelCount];
+      Vector<OutgoingPacket> packets_to_send_;
       Vector<MessagePacket> packets_to_receive_;
+      Vector<ReceivedPacket> received_packets_;
+      foundation::UniquePtr<NetworkThread> thread_;
     };
   }
-}
\ No newline at end of file
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 
 namespace lambda
 {
@@ -8,5 +9,16 @@ namespace lambda
 #define MESSAGE_DISCONNECTED "dc"
 #define MESSAGE_SET_ID "sid"
 #define MESSAGE_SET_NAME "snm"
+
+    // Types of the binary messages. The ones below kMessageTypeUser are
+    // used by the library itself.
+    enum MessageType : uint32_t
+    {
+      kMessageTypeString      = 0u, // A Message of the header and message API.
+      kMessageTypeSnapshot    = 1u, // An encoded Snapshot, from the server.
+      kMessageTypeSnapshotAck = 2u, // The newest snapshot a client decoded.
+      kMessageTypeObservers   = 3u, // Where a client looks from.
+      kMessageTypeUser        = 64u,
+    };
   }
 }
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "network_thread.h"
+
+namespace lambda
+{
+  namespace networking
+  {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    NetworkThread::NetworkThread(ENetHost* host, ENetPeer* peer, uint32_t service_timeout) :
+      host_(host),
+      peer_(peer),
+      service_timeout_(service_timeout),
+      running_(true)
+    {
+      thread_ = std::thread(&NetworkThread::run, this);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    NetworkThread::~NetworkThread()
+    {
+      stop();
+
+      // Nobody takes these anymore.
+      ENetEvent event;
+      while (receive(event))
+      {
+        if (event.type == ENET_EVENT_TYPE_RECEIVE)
+          enet_packet_destroy(event.packet);
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void NetworkThread::send(const OutgoingPacket& outgoing)
+    {
+      flush();
+      if (!outgoing_overflow_.empty() || !outgoing_.push(outgoing))
+        outgoing_overflow_.push_back(outgoing);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool NetworkThread::receive(ENetEvent& event)
+    {
+      if (incoming_.pop(event))
+        return true;
+
+      // Once the thread is gone its overflow is the game thread's.
+      if (!thread_.joinable() && !incoming_overflow_.empty())
+      {
+        event = incoming_overflow_.front();
+        incoming_overflow_.erase(incoming_overflow_.begin());
+        return true;
+      }
+      return false;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void NetworkThread::flush()
+    {
+      size_t pushed = 0u;
+      while (pushed < outgoing_overflow_.size() && outgoing_.push(outgoing_overflow_[pushed]))
+        pushed++;
+      outgoing_overflow_.erase(outgoing_overflow_.begin(), outgoing_overflow_.begin() + pushed);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void NetworkThread::stop()
+    {
+      if (!thread_.joinable())
+        return;
+
+      running_ = false;
+      thread_.join();
+
+      OutgoingPacket outgoing;
+      while (outgoing_.pop(outgoing))
+        sendPacket(outgoing);
+      for (const OutgoingPacket& packet : outgoing_overflow_)
+        sendPacket(packet);
+      outgoing_overflow_.clear();
+      enet_host_flush(host_);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void NetworkThread::run()
+    {
+      ENetEvent event;
+      while (running_)
+      {
+        // Events that did not fit last time go first, to keep the order.
+        size_t delivered = 0u;
+        while (delivered < incoming_overflow_.size() && incoming_.push(incoming_overflow_[delivered]))
+          delivered++;
+        incoming_overflow_.erase(incoming_overflow_.begin(), incoming_overflow_.begin() + delivered);
+
+        OutgoingPacket outgoing;
+        bool sent = false;
+        while (outgoing_.pop(outgoing))
+        {
+          sendPacket(outgoing);
+          sent = true;
+        }
+        if (sent)
+          enet_host_flush(host_);
+
+        // Waits for packets, and sends and resends what ENet has queued.
+        int result = enet_host_service(host_, &event, service_timeout_);
+        while (result > 0)
+        {
+          deliver(event);
+          result = enet_host_check_events(host_, &event);
+        }
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void NetworkThread::sendPacket(const OutgoingPacket& outgoing)
+    {
+      if (outgoing.peer == nullptr && peer_ == nullptr)
+        enet_host_broadcast(host_, outgoing.channel, outgoing.packet);
+      else if (enet_peer_send(outgoing.peer ? outgoing.peer : peer_, outgoing.channel, outgoing.packet) != 0)
+        enet_packet_destroy(outgoing.packet);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void NetworkThread::deliver(const ENetEvent& event)
+    {
+      ENetEvent delivered = event;
+      if (delivered.type == ENET_EVENT_TYPE_CONNECT)
+        delivered.data = delivered.peer->connectID;
+      if (!incoming_overflow_.empty() || !incoming_.push(delivered))
+        incoming_overflow_.push_back(delivered);
+    }
+
+  }
+}
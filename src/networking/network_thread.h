@@ -0,0 +1,58 @@
+#pragma once
+#include "message_manager.h"
+#include "spsc_queue.h"
+#include <enet/enet.h>
+#include <atomic>
+#include <thread>
+
+namespace lambda
+{
+  namespace networking
+  {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Services an ENet host on a thread of its own, so packets are taken
+    // in and sent out as they come rather than once per update. The game
+    // thread hands it packets to send and takes the events it received.
+    // ENet is not thread safe, so nothing else may use the host while it
+    // runs. Connect events carry the connect ID of their peer in data, as
+    // it can not be read from the peer on the game thread.
+    class NetworkThread
+    {
+    public:
+      // Without a peer, packets without one are broadcast. Service blocks
+      // for up to service_timeout milliseconds when nothing happens, which
+      // is also how long a packet can wait before it is sent.
+      NetworkThread(ENetHost* host, ENetPeer* peer, uint32_t service_timeout);
+      // Stops the thread. Whatever it had not sent yet is sent from the
+      // calling thread.
+      ~NetworkThread();
+
+      // Game thread only.
+      void send(const OutgoingPacket& outgoing);
+      bool receive(ENetEvent& event);
+      // Hands over the packets that did not fit in the queue before.
+      void flush();
+      void stop();
+
+    private:
+      void run();
+      void sendPacket(const OutgoingPacket& outgoing);
+      void deliver(const ENetEvent& event);
+
+    private:
+      static constexpr size_t kQueueSize = 1024u;
+
+      ENetHost* host_;
+      ENetPeer* peer_;
+      uint32_t service_timeout_;
+      std::atomic<bool> running_;
+      SpscQueue<OutgoingPacket, kQueueSize> outgoing_;
+      SpscQueue<ENetEvent, kQueueSize> incoming_;
+      // What did not fit in the queues, in order. Each is only used by the
+      // thread that pushes to its queue.
+      Vector<OutgoingPacket> outgoing_overflow_;
+      Vector<ENetEvent> incoming_overflow_;
+      std::thread thread_;
+    };
+  }
+}
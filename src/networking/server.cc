@@ -10,7 +10,7 @@ namespace lambda
   namespace networking
   {
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    void Server::initialize(uint16_t port, uint32_t host)
+    void Server::initialize(uint16_t port, uint32_t host, uint32_t max_clients)
     {
       ENetAddress address;
       /* Bind the server to the default localhost.     */
@@ -21,8 +21,8 @@ namespace lambda
 
       server_ = enet_host_create(
         &address /* the address to bind the server host to */,
-        32       /* allow up to 32 clients and/or outgoing connections */,
-        2        /* allow up to 2 channels to be used, 0 and 1 */,
+        max_clients /* allow up to max_clients clients and/or outgoing connections */,
+        kChannelCount /* allow up to kChannelCount channels to be used */,
         0        /* assume any amount of incoming bandwidth */,
         0        /* assume any amount of outgoing bandwidth */
       );
@@ -41,6 +41,7 @@ namespace lambda
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void Server::deinitialize()
     {
+      message_manager_.stopThread();
       enet_host_destroy(server_);
     }
     
@@ -60,7 +61,7 @@ namespace lambda
 
             if (message.header == MESSAGE_CONNECTED)
             {
-              connect(packet.getClient());
+              connect(packet.getClient(), packet.getConnectId());
             }
             else if (message.header == MESSAGE_DISCONNECTED)
             {
@@ -77,6 +78,14 @@ namespace lambda
           }
         }
       }
+
+      Vector<ReceivedPacket> received_packets;
+      message_manager_.receivePackets(received_packets);
+      for (auto& packet : received_packets)
+        handlePacket(packet);
+
+      if (message_manager_.getFlushPolicy() == FlushPolicy::kImmediate)
+        message_manager_.flush();
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -92,40 +101,129 @@ namespace lambda
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    void Server::connect(ENetPeer* peer)
+    void Server::setFlushPolicy(FlushPolicy policy)
+    {
+      message_manager_.setFlushPolicy(policy);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Server::setThreaded(bool threaded, uint32_t service_timeout)
+    {
+      if (threaded)
+        message_manager_.startThread(service_timeout);
+      else
+        message_manager_.stopThread();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Server::connect(ENetPeer* peer, uint32_t connect_id)
     {
-      peer->data = malloc(1);
-      memcpy(peer->data, &latest_open_client_id_, 1);
+      if (clients_.find(peer) != clients_.end())
+        return;
+
+      ClientId id = next_client_id_;
+      if (!free_client_ids_.empty())
+      {
+        id = free_client_ids_.front();
+        free_client_ids_.pop();
+      }
+      else
+        next_client_id_++;
 
-      clients_.insert(eastl::make_pair(peer, ClientData()));
+      ClientData client;
+      client.id = id;
+      clients_.insert(eastl::make_pair(peer, eastl::move(client)));
+      peers_.insert(eastl::make_pair(id, peer));
 
-      Message message(MESSAGE_SET_ID, String(sizeof(uint8_t) + sizeof(uint32_t), ' '));
-      message.message.at(0) = (char)latest_open_client_id_;
-      memcpy((void*)(message.message.data() + 1), &peer->connectID, sizeof(uint32_t));
+      Message message(MESSAGE_SET_ID, String(sizeof(ClientId) + sizeof(uint32_t), ' '));
+      memcpy((void*)message.message.data(), &id, sizeof(ClientId));
+      memcpy((void*)(message.message.data() + sizeof(ClientId)), &connect_id, sizeof(uint32_t));
       message_manager_.sendMessage(message);
 
-      latest_open_client_id_++;
-      connected_clients_++;
-      LMB_LOG_DEBG("[SERVER] Successfully connected to a client");
+      LMB_LOG_DEBG("[SERVER] Successfully connected to client %u", id);
     }
     
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     void Server::disconnect(ENetPeer* peer)
     {
-      uint8_t id;
-      memcpy(&id, peer->data, 1);
-      free(peer->data);
-      clients_.erase(peer);
-      connected_clients_--;
+      auto it = clients_.find(peer);
+      if (it == clients_.end())
+        return;
+
+      const ClientId id = it->second.id;
+      peers_.erase(id);
+      clients_.erase(it);
+      free_client_ids_.push(id);
 
-      LMB_LOG_DEBG("[SERVER] Successfully disconnected client %i", id);
+      LMB_LOG_DEBG("[SERVER] Successfully disconnected client %u", id);
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    void Server::setName(uint8_t id, String name)
+    void Server::setName(ClientId id, String name)
     {
       getClient(id).name = name;
-      LMB_LOG_DEBG("[SERVER] Client %i: Name is set to %s.", id, name.c_str());
+      LMB_LOG_DEBG("[SERVER] Client %u: Name is set to %s.", id, name.c_str());
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Server::sendSnapshot(Snapshot& snapshot)
+    {
+      const Snapshot& pushed = snapshots_.push(snapshot);
+      snapshot_bytes_ = 0u;
+
+      MessageWriter payload;
+      bool binned = false;
+      for (auto& it : clients_)
+      {
+        // The acked snapshot was of the other kind, so start over.
+        ClientData& client = it.second;
+        const bool filtered = interest_.getBudget() > 0u || !client.interest.observers.empty();
+        if (filtered != client.interest.filtered)
+        {
+          client.interest.filtered = filtered;
+          client.acked_snapshot    = kNoSnapshot;
+        }
+
+        payload.clear();
+        if (filtered)
+        {
+          if (!binned)
+            interest_.update(pushed);
+          binned = true;
+          interest_.encode(pushed, client.interest, client.acked_snapshot, payload);
+        }
+        else
+          snapshots_.encode(client.acked_snapshot, payload);
+        message_manager_.sendMessage(it.first, kMessageTypeSnapshot, 0u, payload, kChannelSequenced);
+        snapshot_bytes_ += payload.size();
+      }
+
+      if (message_manager_.getFlushPolicy() == FlushPolicy::kImmediate)
+        message_manager_.flush();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t Server::getSnapshotBytes() const
+    {
+      return snapshot_bytes_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t Server::getClientCount() const
+    {
+      return (uint32_t)clients_.size();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Server::setSnapshotBudget(size_t bytes)
+    {
+      interest_.setBudget(bytes);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Server::setObservers(ClientId id, const Vector<Observer>& observers)
+    {
+      getClient(id).interest.observers = observers;
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -135,17 +233,54 @@ namespace lambda
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ClientData& Server::getClient(uint8_t id)
+    void Server::handlePacket(ReceivedPacket& packet)
     {
-      for (auto& it : clients_)
+      // Relayed on the channel they came in on, with the same delivery.
+      // The ones of the library itself are for the server only.
+      MessageView message;
+      while (packet.next(message))
       {
-        uint8_t client_id = *(uint8_t*)it.first->data;
-        if (client_id == id)
+        if (message.type == kMessageTypeSnapshotAck)
+        {
+          auto it = clients_.find(packet.getPeer());
+          MessageReader reader = message.reader();
+          const uint32_t ack = (uint32_t)reader.readVarint();
+          // Acks can arrive out of order.
+          if (it != clients_.end() && reader.isValid() && ack > it->second.acked_snapshot && ack <= snapshots_.getSequence())
+            it->second.acked_snapshot = ack;
+        }
+        else if (message.type == kMessageTypeObservers)
         {
-          return it.second;
+          auto it = clients_.find(packet.getPeer());
+          MessageReader reader = message.reader();
+          const uint64_t count = reader.readVarint();
+          if (it == clients_.end() || count > kMaxObservers)
+            continue;
+
+          Vector<Observer>& observers = it->second.interest.observers;
+          observers.resize((size_t)count);
+          for (Observer& observer : observers)
+          {
+            observer.position.x = reader.read<float>();
+            observer.position.y = reader.read<float>();
+            observer.position.z = reader.read<float>();
+            observer.radius     = reader.read<float>();
+          }
+          if (!reader.isValid())
+            observers.clear();
         }
+        else if (message.type >= kMessageTypeUser)
+          message_manager_.sendMessage(message.type, message.sender, message.data, message.size, packet.getChannel());
       }
-      LMB_LOG_ERR("[SERVER] Could not find client with an ID of %i!", id);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ClientData& Server::getClient(ClientId id)
+    {
+      auto it = peers_.find(id);
+      if (it != peers_.end())
+        return clients_[it->second];
+      LMB_LOG_ERR("[SERVER] Could not find client with an ID of %u!", id);
       
       // To please the compiler. It will never get here.
       static ClientData backup_data;
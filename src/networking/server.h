@@ -1,5 +1,7 @@
 #pragma once
 #include "message_manager.h"
+#include "snapshot.h"
+#include "interest.h"
 
 struct _ENetPeer;
 typedef _ENetPeer ENetPeer;
@@ -14,35 +16,68 @@ namespace lambda
 
     struct ClientData
     {
+      ClientId id = kServerId;
       String name = "";
+      // The newest snapshot the client decoded, which the next one it
+      // gets is encoded against.
+      uint32_t acked_snapshot = kNoSnapshot;
+      // Clients with observers or a budget get their own snapshots.
+      ClientInterest interest;
     };
 
     class Server
     {
     public:
-      // General functions.
-      void initialize(uint16_t port = 1234u, uint32_t host = 0);
+      // General functions. ENet allows up to 4095 clients.
+      void initialize(uint16_t port = 1234u, uint32_t host = 0, uint32_t max_clients = 32u);
       void deinitialize();
       void update(double delta_time);
       uint8_t getUpdateRate() const;
       void setUpdateRate(uint8_t hertz);
+      // With FlushPolicy::kImmediate, relays go out at the end of update
+      // and snapshots as they are sent, instead of on the next tick.
+      void setFlushPolicy(FlushPolicy policy);
+      // Services the host on a thread of its own. See MessageManager.
+      void setThreaded(bool threaded, uint32_t service_timeout = 1u);
 
       // Connection and disconnection of clients.
-      void connect(ENetPeer* peer);
+      void connect(ENetPeer* peer, uint32_t connect_id);
       void disconnect(ENetPeer* peer);
 
       // Messages.
-      void setName(uint8_t id, String name);
+      void setName(ClientId id, String name);
+
+      // Replication. Takes the snapshot of this tick and sends every client
+      // its difference to the last snapshot that client acked, on
+      // kChannelSequenced. Snapshots that are lost are covered by the next.
+      void sendSnapshot(Snapshot& snapshot);
+      // The snapshot bytes the last sendSnapshot sent, to all clients.
+      size_t getSnapshotBytes() const;
+      uint32_t getClientCount() const;
+      // Limits what every client gets per snapshot. Entities that changed
+      // but did not fit are sent in a later snapshot. 0 is no limit.
+      void setSnapshotBudget(size_t bytes);
+      // Clients send their observers themselves. This is for observers
+      // the server decides on.
+      void setObservers(ClientId id, const Vector<Observer>& observers);
 
     private:
       void handleMessage(const Message& message);
-      ClientData& getClient(uint8_t id);
+      void handlePacket(ReceivedPacket& packet);
+      ClientData& getClient(ClientId id);
 
     private:
       MessageManager message_manager_;
+      SnapshotSender snapshots_;
+      InterestManager interest_;
+      size_t snapshot_bytes_ = 0u;
       UnorderedMap<ENetPeer*, ClientData> clients_;
-      uint8_t latest_open_client_id_ = 1;
-      uint8_t connected_clients_     = 0;
+      UnorderedMap<ClientId, ENetPeer*> peers_;
+      ClientId next_client_id_ = 1u;
+      // Waiting to be given out again. The IDs that were released first
+      // are reused first, so messages still on their way from a client
+      // that left are unlikely to be taken for those of a new one.
+      Queue<ClientId> free_client_ids_;
 
       ENetHost* server_ = nullptr;
     };
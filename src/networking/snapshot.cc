@@ -0,0 +1,620 @@
+#include "snapshot.h"
+#include "bit_stream.h"
+#include "message_codec.h"
+#include <EASTL/sort.h>
+#include <cmath>
+#include <cstring>
+
+namespace lambda
+{
+  namespace networking
+  {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static constexpr uint32_t kRotationMax = (1u << kRotationBits) - 1u;
+    static constexpr float    kSqrtHalf    = 0.70710678f;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static int32_t quantizeCoordinate(float value)
+    {
+      const double scaled = glm::clamp((double)value * (double)kPositionScale, -2147483647.0, 2147483647.0);
+      return (int32_t)std::llround(scaled);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    QuantizedTransform quantize(const glm::vec3& position, const glm::quat& rotation)
+    {
+      QuantizedTransform transform;
+      for (int i = 0; i < 3; ++i)
+        transform.position[i] = quantizeCoordinate(position[i]);
+
+      const glm::quat q = glm::normalize(rotation);
+      const float components[4] = { q.x, q.y, q.z, q.w };
+      uint32_t largest = 0u;
+      for (uint32_t i = 1u; i < 4u; ++i)
+      {
+        if (std::fabs(components[i]) > std::fabs(components[largest]))
+          largest = i;
+      }
+
+      // q and -q are the same rotation, so the one that is left out is
+      // always positive and can be rebuilt from the other three.
+      const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+      transform.rotation = largest << (3u * kRotationBits);
+      uint32_t shift = 0u;
+      for (uint32_t i = 0u; i < 4u; ++i)
+      {
+        if (i == largest)
+          continue;
+        const float normalized = (components[i] * sign / kSqrtHalf + 1.0f) * 0.5f;
+        const uint32_t value = (uint32_t)glm::clamp(std::lround(normalized * (float)kRotationMax), 0l, (long)kRotationMax);
+        transform.rotation |= value << shift;
+        shift += kRotationBits;
+      }
+      return transform;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    glm::vec3 dequantizePosition(const QuantizedTransform& transform)
+    {
+      return glm::vec3(
+        (float)transform.position[0],
+        (float)transform.position[1],
+        (float)transform.position[2]
+      ) * (1.0f / kPositionScale);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    glm::quat dequantizeRotation(const QuantizedTransform& transform)
+    {
+      const uint32_t largest = transform.rotation >> (3u * kRotationBits);
+      float components[4];
+      float sum = 0.0f;
+      uint32_t shift = 0u;
+      for (uint32_t i = 0u; i < 4u; ++i)
+      {
+        if (i == largest)
+          continue;
+        const uint32_t value = (transform.rotation >> shift) & kRotationMax;
+        components[i] = ((float)value / (float)kRotationMax * 2.0f - 1.0f) * kSqrtHalf;
+        sum += components[i] * components[i];
+        shift += kRotationBits;
+      }
+      components[largest] = std::sqrt(std::fmax(0.0f, 1.0f - sum));
+      return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Snapshot::add(uint32_t id, const glm::vec3& position, const glm::quat& rotation, const uint32_t* values, float priority)
+    {
+      ids.push_back(id);
+      transforms.push_back(quantize(position, rotation));
+      priorities.push_back(priority);
+      for (size_t i = 0u; i < field_bits.size(); ++i)
+      {
+        const uint32_t value = values ? values[i] : 0u;
+        fields.push_back(field_bits[i] < 32u ? value & ((1u << field_bits[i]) - 1u) : value);
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Snapshot::sort()
+    {
+      bool sorted = true;
+      for (size_t i = 1u; i < ids.size() && sorted; ++i)
+        sorted = ids[i - 1u] < ids[i];
+      if (sorted)
+        return;
+
+      Vector<uint32_t> order(ids.size());
+      for (size_t i = 0u; i < order.size(); ++i)
+        order[i] = (uint32_t)i;
+      eastl::sort(order.begin(), order.end(), [this](uint32_t lhs, uint32_t rhs) { return ids[lhs] < ids[rhs]; });
+
+      const size_t field_count = getFieldCount();
+      Vector<uint32_t> sorted_ids(ids.size());
+      Vector<QuantizedTransform> sorted_transforms(transforms.size());
+      Vector<uint32_t> sorted_fields(fields.size());
+      Vector<float> sorted_priorities(priorities.size());
+      for (size_t i = 0u; i < order.size(); ++i)
+      {
+        sorted_ids[i]        = ids[order[i]];
+        sorted_transforms[i] = transforms[order[i]];
+        if (!priorities.empty())
+          sorted_priorities[i] = priorities[order[i]];
+        for (size_t f = 0u; f < field_count; ++f)
+          sorted_fields[i * field_count + f] = fields[order[i] * field_count + f];
+      }
+      eastl::swap(ids, sorted_ids);
+      eastl::swap(transforms, sorted_transforms);
+      eastl::swap(fields, sorted_fields);
+      eastl::swap(priorities, sorted_priorities);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void Snapshot::clear()
+    {
+      sequence = kNoSnapshot;
+      time = 0.0f;
+      ids.clear();
+      transforms.clear();
+      fields.clear();
+      priorities.clear();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static bool sameFields(const Snapshot& lhs, size_t l, const Snapshot& rhs, size_t r)
+    {
+      const size_t count = lhs.getFieldCount();
+      return count == 0u || memcmp(&lhs.fields[l * count], &rhs.fields[r * count], count * sizeof(uint32_t)) == 0;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static void writeState(BitWriter& bits, const Snapshot& snapshot, size_t i, const Snapshot* baseline, size_t b)
+    {
+      const QuantizedTransform& transform = snapshot.transforms[i];
+      const size_t field_count = snapshot.getFieldCount();
+
+      if (baseline == nullptr)
+      {
+        for (int axis = 0; axis < 3; ++axis)
+          bits.writeSigned(transform.position[axis]);
+        bits.write(transform.rotation, 32u);
+        for (size_t f = 0u; f < field_count; ++f)
+          bits.write(snapshot.fields[i * field_count + f], snapshot.field_bits[f]);
+        return;
+      }
+
+      const QuantizedTransform& base = baseline->transforms[b];
+      const bool moved = base.position[0] != transform.position[0] ||
+        base.position[1] != transform.position[1] || base.position[2] != transform.position[2];
+      bits.writeBool(moved);
+      if (moved)
+      {
+        for (int axis = 0; axis < 3; ++axis)
+          bits.writeSigned((int32_t)((uint32_t)transform.position[axis] - (uint32_t)base.position[axis]));
+      }
+
+      const bool rotated = base.rotation != transform.rotation;
+      bits.writeBool(rotated);
+      if (rotated)
+        bits.write(transform.rotation, 32u);
+
+      for (size_t f = 0u; f < field_count; ++f)
+      {
+        const uint32_t value = snapshot.fields[i * field_count + f];
+        const bool changed = baseline->fields[b * field_count + f] != value;
+        bits.writeBool(changed);
+        if (changed)
+          bits.write(value, snapshot.field_bits[f]);
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t getEntityBits(const Snapshot& snapshot, size_t i, const Snapshot* baseline, size_t b)
+    {
+      const QuantizedTransform& transform = snapshot.transforms[i];
+      const size_t field_count = snapshot.getFieldCount();
+      // The id gap, which is usually small.
+      uint32_t bits = 10u;
+
+      if (baseline == nullptr)
+      {
+        for (int axis = 0; axis < 3; ++axis)
+          bits += BitWriter::getSignedBits(transform.position[axis]);
+        bits += 32u;
+        for (size_t f = 0u; f < field_count; ++f)
+          bits += snapshot.field_bits[f];
+        return bits;
+      }
+
+      if (transform == baseline->transforms[b] && sameFields(snapshot, i, *baseline, b))
+        return 0u;
+
+      const QuantizedTransform& base = baseline->transforms[b];
+      bits += 2u + (uint32_t)field_count;
+      if (base.position[0] != transform.position[0] || base.position[1] != transform.position[1] || base.position[2] != transform.position[2])
+      {
+        for (int axis = 0; axis < 3; ++axis)
+          bits += BitWriter::getSignedBits((int32_t)((uint32_t)transform.position[axis] - (uint32_t)base.position[axis]));
+      }
+      if (base.rotation != transform.rotation)
+        bits += 32u;
+      for (size_t f = 0u; f < field_count; ++f)
+      {
+        if (baseline->fields[b * field_count + f] != snapshot.fields[i * field_count + f])
+          bits += snapshot.field_bits[f];
+      }
+      return bits;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    static void readState(BitReader& bits, Snapshot& snapshot, const Snapshot* baseline, size_t b)
+    {
+      const size_t field_count = snapshot.getFieldCount();
+      QuantizedTransform transform;
+
+      if (baseline == nullptr)
+      {
+        for (int axis = 0; axis < 3; ++axis)
+          transform.position[axis] = bits.readSigned();
+        transform.rotation = bits.read(32u);
+        snapshot.transforms.push_back(transform);
+        for (size_t f = 0u; f < field_count; ++f)
+          snapshot.fields.push_back(bits.read(snapshot.field_bits[f]));
+        return;
+      }
+
+      transform = baseline->transforms[b];
+      if (bits.readBool())
+      {
+        for (int axis = 0; axis < 3; ++axis)
+          transform.position[axis] = (int32_t)((uint32_t)transform.position[axis] + (uint32_t)bits.readSigned());
+      }
+      if (bits.readBool())
+        transform.rotation = bits.read(32u);
+      snapshot.transforms.push_back(transform);
+
+      for (size_t f = 0u; f < field_count; ++f)
+      {
+        const uint32_t base = baseline->fields[b * field_count + f];
+        snapshot.fields.push_back(bits.readBool() ? bits.read(snapshot.field_bits[f]) : base);
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void encodeSnapshot(const Snapshot& snapshot, const Snapshot* baseline, MessageWriter& writer)
+    {
+      if (baseline != nullptr && baseline->field_bits != snapshot.field_bits)
+        baseline = nullptr;
+
+      BitWriter bits(writer);
+      bits.write(snapshot.sequence, 32u);
+      bits.write(baseline ? baseline->sequence : kNoSnapshot, 32u);
+      uint32_t time;
+      memcpy(&time, &snapshot.time, sizeof(time));
+      bits.write(time, 32u);
+      bits.writeUnsigned((uint32_t)snapshot.field_bits.size());
+      for (const uint8_t field_bits : snapshot.field_bits)
+        bits.write(field_bits - 1u, 5u);
+
+      // Entities that are gone, and the ones that are new or changed, with
+      // the slot they had in the baseline.
+      Vector<uint32_t> removed;
+      Vector<uint32_t> listed;
+      Vector<uint32_t> listed_base;
+      static constexpr uint32_t kNew = ~0u;
+      size_t i = 0u, b = 0u;
+      const size_t base_count = baseline ? baseline->size() : 0u;
+      while (i < snapshot.size() || b < base_count)
+      {
+        if (i == snapshot.size() || (b < base_count && baseline->ids[b] < snapshot.ids[i]))
+        {
+          removed.push_back(baseline->ids[b++]);
+        }
+        else if (b == base_count || snapshot.ids[i] < baseline->ids[b])
+        {
+          listed.push_back((uint32_t)i++);
+          listed_base.push_back(kNew);
+        }
+        else
+        {
+          if (!(snapshot.transforms[i] == baseline->transforms[b]) || !sameFields(snapshot, i, *baseline, b))
+          {
+            listed.push_back((uint32_t)i);
+            listed_base.push_back((uint32_t)b);
+          }
+          i++;
+          b++;
+        }
+      }
+
+      // Ids are written as the distance to the one before.
+      bits.writeUnsigned((uint32_t)removed.size());
+      uint32_t next = 0u;
+      for (const uint32_t id : removed)
+      {
+        bits.writeUnsigned(id - next);
+        next = id + 1u;
+      }
+
+      bits.writeUnsigned((uint32_t)listed.size());
+      next = 0u;
+      for (size_t l = 0u; l < listed.size(); ++l)
+      {
+        const uint32_t id = snapshot.ids[listed[l]];
+        bits.writeUnsigned(id - next);
+        next = id + 1u;
+        writeState(bits, snapshot, listed[l], listed_base[l] == kNew ? nullptr : baseline, listed_base[l]);
+      }
+      bits.flush();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool peekSnapshot(const uint8_t* data, size_t size, uint32_t& sequence, uint32_t& baseline)
+    {
+      BitReader bits(data, size);
+      sequence = bits.read(32u);
+      baseline = bits.read(32u);
+      return bits.isValid();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool decodeSnapshot(const uint8_t* data, size_t size, const Snapshot* baseline, Snapshot& snapshot)
+    {
+      BitReader bits(data, size);
+      snapshot.clear();
+      snapshot.sequence = bits.read(32u);
+      const uint32_t baseline_sequence = bits.read(32u);
+      const uint32_t time = bits.read(32u);
+      memcpy(&snapshot.time, &time, sizeof(time));
+      snapshot.field_bits.resize(bits.readUnsigned() & 0xFFu);
+      for (uint8_t& field_bits : snapshot.field_bits)
+        field_bits = (uint8_t)(bits.read(5u) + 1u);
+
+      if (baseline_sequence == kNoSnapshot)
+        baseline = nullptr;
+      else if (baseline == nullptr || baseline->sequence != baseline_sequence || baseline->field_bits != snapshot.field_bits)
+        return false;
+
+      // The count comes from the packet, so check that there is room for
+      // that many IDs before making room for them.
+      const uint32_t removed_count = bits.readUnsigned();
+      if (!bits.isValid() || (uint64_t)removed_count * BitWriter::getUnsignedBits(0u) > bits.getBitsLeft())
+        return false;
+      Vector<uint32_t> removed(removed_count);
+      uint32_t next = 0u;
+      for (uint32_t& id : removed)
+      {
+        id = next + bits.readUnsigned();
+        next = id + 1u;
+      }
+      if (!bits.isValid())
+        return false;
+
+      // Everything in the baseline that was not removed or listed carries
+      // over as it was.
+      const size_t field_count = snapshot.getFieldCount();
+      const size_t base_count = baseline ? baseline->size() : 0u;
+      size_t b = 0u, r = 0u;
+      auto carry = [&](uint64_t until) {
+        for (; b < base_count && (uint64_t)baseline->ids[b] < until; ++b)
+        {
+          while (r < removed.size() && removed[r] < baseline->ids[b])
+            r++;
+          if (r < removed.size() && removed[r] == baseline->ids[b])
+            continue;
+          snapshot.ids.push_back(baseline->ids[b]);
+          snapshot.transforms.push_back(baseline->transforms[b]);
+          for (size_t f = 0u; f < field_count; ++f)
+            snapshot.fields.push_back(baseline->fields[b * field_count + f]);
+        }
+      };
+
+      const uint32_t listed = bits.readUnsigned();
+      next = 0u;
+      for (uint32_t l = 0u; l < listed && bits.isValid(); ++l)
+      {
+        const uint32_t id = next + bits.readUnsigned();
+        if (l > 0u && id < next)
+          return false;
+        next = id + 1u;
+
+        carry(id);
+        snapshot.ids.push_back(id);
+        if (b < base_count && baseline->ids[b] == id)
+          readState(bits, snapshot, baseline, b++);
+        else
+          readState(bits, snapshot, nullptr, 0u);
+      }
+      carry((uint64_t)~0u + 1u);
+
+      return bits.isValid();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    const Snapshot& SnapshotSender::push(Snapshot& snapshot)
+    {
+      if (++sequence_ == kNoSnapshot)
+        ++sequence_;
+      Snapshot& slot = history_[sequence_ % kSnapshotHistory];
+      eastl::swap(slot.field_bits, snapshot.field_bits);
+      eastl::swap(slot.ids, snapshot.ids);
+      eastl::swap(slot.transforms, snapshot.transforms);
+      eastl::swap(slot.fields, snapshot.fields);
+      eastl::swap(slot.priorities, snapshot.priorities);
+      slot.sequence = sequence_;
+      slot.time     = snapshot.time;
+
+      // The caller gets the old buffers back to fill again.
+      snapshot.field_bits = slot.field_bits;
+      snapshot.clear();
+      encodings_.clear();
+      return slot;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void SnapshotSender::encode(uint32_t baseline, MessageWriter& writer)
+    {
+      const Snapshot* latest = find(sequence_);
+      if (latest == nullptr)
+        return;
+
+      const Snapshot* base = find(baseline);
+      if (base == latest)
+        base = nullptr;
+      const uint32_t key = base ? baseline : kNoSnapshot;
+
+      for (const Encoding& encoding : encodings_)
+      {
+        if (encoding.baseline == key)
+        {
+          writer.writeBytes(encoding.data.data(), encoding.data.size());
+          return;
+        }
+      }
+
+      MessageWriter encoded;
+      encodeSnapshot(*latest, base, encoded);
+      encodings_.push_back({ key, Vector<uint8_t>(encoded.data(), encoded.data() + encoded.size()) });
+      writer.writeBytes(encoded.data(), encoded.size());
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    const Snapshot* SnapshotSender::find(uint32_t sequence) const
+    {
+      const Snapshot& snapshot = history_[sequence % kSnapshotHistory];
+      return sequence != kNoSnapshot && snapshot.sequence == sequence ? &snapshot : nullptr;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t SnapshotSender::getSequence() const
+    {
+      return sequence_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void InterpolatedSnapshot::clear()
+    {
+      time = 0.0f;
+      ids.clear();
+      positions.clear();
+      rotations.clear();
+      fields.clear();
+      field_count = 0u;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool SnapshotReceiver::receive(const uint8_t* data, size_t size)
+    {
+      uint32_t sequence, baseline;
+      if (!peekSnapshot(data, size, sequence, baseline) || sequence == kNoSnapshot || sequence <= latest_)
+        return false;
+
+      if (!decodeSnapshot(data, size, find(baseline), scratch_))
+        return false;
+
+      if (latest_ == kNoSnapshot)
+        playback_time_ = (double)scratch_.time - (double)delay_;
+      latest_ = sequence;
+      eastl::swap(history_[sequence % kSnapshotHistory], scratch_);
+      return true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t SnapshotReceiver::getAck() const
+    {
+      return latest_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void SnapshotReceiver::update(double delta_time)
+    {
+      playback_time_ += delta_time;
+      const Snapshot* latest = find(latest_);
+      if (latest == nullptr)
+        return;
+
+      // Small drift is eased out so motion stays smooth. Large jumps,
+      // after a stall, are taken at once.
+      const double error = ((double)latest->time - (double)delay_) - playback_time_;
+      if (std::fabs(error) > 0.25)
+        playback_time_ += error;
+      else
+        playback_time_ += error * glm::clamp(delta_time * 2.0, 0.0, 1.0);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool SnapshotReceiver::sample(InterpolatedSnapshot& result) const
+    {
+      result.clear();
+
+      // The newest snapshot at or before the playback time, and the
+      // oldest one after it.
+      const Snapshot* from = nullptr;
+      const Snapshot* to   = nullptr;
+      const Snapshot* oldest = nullptr;
+      for (const Snapshot& snapshot : history_)
+      {
+        if (snapshot.sequence == kNoSnapshot)
+          continue;
+        if (oldest == nullptr || snapshot.time < oldest->time)
+          oldest = &snapshot;
+        if ((double)snapshot.time <= playback_time_)
+        {
+          if (from == nullptr || snapshot.time > from->time)
+            from = &snapshot;
+        }
+        else if (to == nullptr || snapshot.time < to->time)
+          to = &snapshot;
+      }
+      if (oldest == nullptr)
+        return false;
+      if (from == nullptr)
+        from = oldest;
+      if (to == nullptr || to->time <= from->time)
+        to = from;
+
+      const float t = to == from ? 0.0f : glm::clamp((float)((playback_time_ - (double)from->time) / (double)(to->time - from->time)), 0.0f, 1.0f);
+      const size_t field_count = to->getFieldCount();
+      const bool same_fields = from->field_bits == to->field_bits;
+      result.time = glm::mix(from->time, to->time, t);
+      result.field_count = field_count;
+      result.ids.reserve(to->size());
+      result.positions.reserve(to->size());
+      result.rotations.reserve(to->size());
+      result.fields.reserve(to->fields.size());
+
+      // Entities that are only in the older snapshot were removed.
+      size_t f = 0u;
+      for (size_t i = 0u; i < to->size(); ++i)
+      {
+        while (f < from->size() && from->ids[f] < to->ids[i])
+          f++;
+
+        const glm::vec3 position = dequantizePosition(to->transforms[i]);
+        const glm::quat rotation = dequantizeRotation(to->transforms[i]);
+        result.ids.push_back(to->ids[i]);
+        if (f < from->size() && from->ids[f] == to->ids[i])
+        {
+          result.positions.push_back(glm::mix(dequantizePosition(from->transforms[f]), position, t));
+          result.rotations.push_back(glm::slerp(dequantizeRotation(from->transforms[f]), rotation, t));
+          const Snapshot& source = same_fields ? *from : *to;
+          const size_t slot = same_fields ? f : i;
+          result.fields.insert(result.fields.end(), source.fields.begin() + slot * field_count, source.fields.begin() + (slot + 1u) * field_count);
+        }
+        else
+        {
+          result.positions.push_back(position);
+          result.rotations.push_back(rotation);
+          result.fields.insert(result.fields.end(), to->fields.begin() + i * field_count, to->fields.begin() + (i + 1u) * field_count);
+        }
+      }
+      return true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    const Snapshot* SnapshotReceiver::find(uint32_t sequence) const
+    {
+      const Snapshot& snapshot = history_[sequence % kSnapshotHistory];
+      return sequence != kNoSnapshot && snapshot.sequence == sequence ? &snapshot : nullptr;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void SnapshotReceiver::setDelay(float seconds)
+    {
+      delay_ = seconds;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    float SnapshotReceiver::getDelay() const
+    {
+      return delay_;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    double SnapshotReceiver::getPlaybackTime() const
+    {
+      return playback_time_;
+    }
+  }
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <containers/containers.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace lambda
+{
+  namespace networking
+  {
+    class MessageWriter;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Positions are fixed point in steps of 1/512 of a unit, which covers
+    // four million units either way. Rotations are stored as their three
+    // smallest components in 10 bits each, and which one was left out.
+    static constexpr float    kPositionScale   = 512.0f;
+    static constexpr uint32_t kRotationBits    = 10u;
+    static constexpr uint32_t kMaxFieldBits    = 32u;
+    static constexpr uint32_t kNoSnapshot      = 0u;
+    // How many snapshots the server keeps to delta against, and the
+    // client keeps to delta from and interpolate between.
+    static constexpr uint32_t kSnapshotHistory = 32u;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    struct QuantizedTransform
+    {
+      int32_t  position[3];
+      uint32_t rotation;
+
+      bool operator==(const QuantizedTransform& other) const
+      {
+        return position[0] == other.position[0] && position[1] == other.position[1] &&
+          position[2] == other.position[2] && rotation == other.rotation;
+      }
+    };
+
+    QuantizedTransform quantize(const glm::vec3& position, const glm::quat& rotation);
+    glm::vec3 dequantizePosition(const QuantizedTransform& transform);
+    glm::quat dequantizeRotation(const QuantizedTransform& transform);
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // The replicated state of every networked entity at one server tick.
+    // Entities are sorted on their id. Every entity has one value per
+    // field, of field_bits[i] bits each. Priorities are only used by the
+    // server to choose what to send, and are not sent.
+    struct Snapshot
+    {
+      uint32_t                   sequence = kNoSnapshot;
+      float                      time     = 0.0f;
+      Vector<uint8_t>            field_bits;
+      Vector<uint32_t>           ids;
+      Vector<QuantizedTransform> transforms;
+      Vector<uint32_t>           fields;
+      Vector<float>              priorities;
+
+      void add(uint32_t id, const glm::vec3& position, const glm::quat& rotation, const uint32_t* values = nullptr, float priority = 1.0f);
+      // Sorts the entities on their id if they were not added that way.
+      void sort();
+      void clear();
+      size_t size() const { return ids.size(); }
+      size_t getFieldCount() const { return field_bits.size(); }
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Writes the entities that were added, moved or removed since the
+    // baseline, bit packed. Without a baseline every entity is written.
+    // Positions are written as the difference to the baseline, so
+    // entities that move a little take few bits.
+    void encodeSnapshot(const Snapshot& snapshot, const Snapshot* baseline, MessageWriter& writer);
+    // Reads the sequence of the snapshot and the one it was encoded against.
+    bool peekSnapshot(const uint8_t* data, size_t size, uint32_t& sequence, uint32_t& baseline);
+    bool decodeSnapshot(const uint8_t* data, size_t size, const Snapshot* baseline, Snapshot& snapshot);
+    // Roughly the bits encodeSnapshot takes for entity i, which is slot b of
+    // the baseline, or new when baseline is null. 0 when it did not change.
+    uint32_t getEntityBits(const Snapshot& snapshot, size_t i, const Snapshot* baseline, size_t b);
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // The server side. Keeps the snapshots of the last ticks so every
+    // client gets the newest one encoded against the last one it acked.
+    class SnapshotSender
+    {
+    public:
+      // Takes the snapshot of this tick and gives it the next sequence.
+      const Snapshot& push(Snapshot& snapshot);
+      // Encodes the newest snapshot against baseline, or whole when the
+      // baseline is too old. Clients that acked the same snapshot share
+      // the encoding.
+      void encode(uint32_t baseline, MessageWriter& writer);
+      const Snapshot* find(uint32_t sequence) const;
+      uint32_t getSequence() const;
+
+    private:
+      struct Encoding
+      {
+        uint32_t        baseline;
+        Vector<uint8_t> data;
+      };
+
+      Snapshot         history_[kSnapshotHistory];
+      uint32_t         sequence_ = kNoSnapshot;
+      Vector<Encoding> encodings_;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Snapshot entities, dequantized and blended between two snapshots.
+    struct InterpolatedSnapshot
+    {
+      float              time = 0.0f;
+      Vector<uint32_t>   ids;
+      Vector<glm::vec3>  positions;
+      Vector<glm::quat>  rotations;
+      // Taken from the older snapshot, field count per entity.
+      Vector<uint32_t>   fields;
+      size_t             field_count = 0u;
+
+      void clear();
+      size_t size() const { return ids.size(); }
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // The client side. Decodes snapshots against the ones it received
+    // before, and plays them back delay seconds behind the newest one so
+    // there is usually a snapshot on either side to interpolate between.
+    class SnapshotReceiver
+    {
+    public:
+      // Returns false when the snapshot could not be decoded because its
+      // baseline is gone, or because it was older than the newest one.
+      bool receive(const uint8_t* data, size_t size);
+      // The newest snapshot that was decoded. The server encodes against it.
+      uint32_t getAck() const;
+      // Moves the playback clock, and keeps it delay seconds behind the
+      // newest snapshot.
+      void update(double delta_time);
+      // The entities at the playback time. False until a snapshot arrived.
+      bool sample(InterpolatedSnapshot& snapshot) const;
+      const Snapshot* find(uint32_t sequence) const;
+
+      void setDelay(float seconds);
+      float getDelay() const;
+      double getPlaybackTime() const;
+
+    private:
+      Snapshot history_[kSnapshotHistory];
+      uint32_t latest_        = kNoSnapshot;
+      double   playback_time_ = 0.0;
+      float    delay_         = 0.1f;
+      Snapshot scratch_;
+    };
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace lambda
+{
+  namespace networking
+  {
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // A fixed size queue between exactly one thread that pushes and one
+    // thread that pops. Neither locks or waits: push fails when the queue
+    // is full and pop fails when it is empty.
+    template<typename T, size_t Capacity>
+    class SpscQueue
+    {
+      static_assert(Capacity > 0u && (Capacity & (Capacity - 1u)) == 0u, "The capacity has to be a power of two");
+
+    public:
+      bool push(const T& value)
+      {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+          return false;
+        items_[tail & (Capacity - 1u)] = value;
+        tail_.store(tail + 1u, std::memory_order_release);
+        return true;
+      }
+
+      bool pop(T& value)
+      {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+          return false;
+        value = items_[head & (Capacity - 1u)];
+        head_.store(head + 1u, std::memory_order_release);
+        return true;
+      }
+
+    private:
+      T items_[Capacity];
+      // Apart, so the two threads do not share a cache line.
+      alignas(64) std::atomic<size_t> head_{ 0u };
+      alignas(64) std::atomic<size_t> tail_{ 0u };
+    };
+  }
+}
@@ -0,0 +1,534 @@
+#include "block_compression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void LoadBlock(const uint8_t pixels[64], float block[16][4])
+  {
+    for (int i = 0; i < 16; ++i)
+      for (int c = 0; c < 4; ++c)
+        block[i][c] = (float)pixels[i * 4 + c];
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static float Clamp255(float value)
+  {
+    return std::min(255.0f, std::max(0.0f, value));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Writes the bits from the lowest up, the way the BC formats count them.
+  class BitWriter
+  {
+  public:
+    BitWriter(uint8_t* block, uint32_t size) : block_(block), offset_(0u) { memset(block, 0, size); }
+
+    void Write(uint32_t value, uint32_t bits)
+    {
+      for (uint32_t i = 0u; i < bits; ++i, ++offset_)
+        if ((value >> i) & 1u)
+          block_[offset_ >> 3u] |= (uint8_t)(1u << (offset_ & 7u));
+    }
+
+  private:
+    uint8_t* block_;
+    uint32_t offset_;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // The endpoints of the line that the first channels of the pixels are
+  // fitted to. Only the principal axis takes the channels together, the
+  // bounding box only flips the channels that go against the largest one.
+  static void FindEndpoints(const float pixels[16][4], int channels, TextureQuality quality, float start[4], float end[4])
+  {
+    float mean[4] = {};
+    float min[4]  = { 255.0f, 255.0f, 255.0f, 255.0f };
+    float max[4]  = {};
+    for (int i = 0; i < 16; ++i)
+    {
+      for (int c = 0; c < channels; ++c)
+      {
+        mean[c] += pixels[i][c] / 16.0f;
+        min[c] = std::min(min[c], pixels[i][c]);
+        max[c] = std::max(max[c], pixels[i][c]);
+      }
+    }
+
+    float covariance[4][4] = {};
+    for (int i = 0; i < 16; ++i)
+      for (int a = 0; a < channels; ++a)
+        for (int b = 0; b < channels; ++b)
+          covariance[a][b] += (pixels[i][a] - mean[a]) * (pixels[i][b] - mean[b]);
+
+    int largest = 0;
+    for (int c = 1; c < channels; ++c)
+      if (covariance[c][c] > covariance[largest][largest])
+        largest = c;
+
+    if (quality == TextureQuality::kFast)
+    {
+      // Inset a little, as the extremes are rarely hit exactly.
+      for (int c = 0; c < channels; ++c)
+      {
+        const float inset = (max[c] - min[c]) / 16.0f;
+        const bool flip = covariance[largest][c] < 0.0f;
+        start[c] = flip ? max[c] - inset : min[c] + inset;
+        end[c]   = flip ? min[c] + inset : max[c] - inset;
+      }
+      return;
+    }
+
+    float axis[4] = {};
+    axis[largest] = 1.0f;
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+      float next[4] = {};
+      float length  = 0.0f;
+      for (int a = 0; a < channels; ++a)
+      {
+        for (int b = 0; b < channels; ++b)
+          next[a] += covariance[a][b] * axis[b];
+        length = std::max(length, std::fabs(next[a]));
+      }
+      if (length <= 0.0f)
+        break;
+      for (int c = 0; c < channels; ++c)
+        axis[c] = next[c] / length;
+    }
+
+    float length = 0.0f;
+    for (int c = 0; c < channels; ++c)
+      length += axis[c] * axis[c];
+    if (length <= 0.0f)
+    {
+      for (int c = 0; c < channels; ++c)
+        start[c] = end[c] = mean[c];
+      return;
+    }
+
+    float t_min = 0.0f;
+    float t_max = 0.0f;
+    for (int i = 0; i < 16; ++i)
+    {
+      float t = 0.0f;
+      for (int c = 0; c < channels; ++c)
+        t += (pixels[i][c] - mean[c]) * axis[c];
+      t_min = std::min(t_min, t / length);
+      t_max = std::max(t_max, t / length);
+    }
+    for (int c = 0; c < channels; ++c)
+    {
+      start[c] = Clamp255(mean[c] + axis[c] * t_min);
+      end[c]   = Clamp255(mean[c] + axis[c] * t_max);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // The endpoints that fit the pixels best for the weights that they were
+  // given between them, by least squares.
+  static bool RefineEndpoints(const float pixels[16][4], int channels, const float weights[16], float start[4], float end[4])
+  {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < 16; ++i)
+    {
+      const float b = weights[i];
+      const float a = 1.0f - b;
+      aa += a * a;
+      ab += a * b;
+      bb += b * b;
+      for (int c = 0; c < channels; ++c)
+      {
+        ax[c] += a * pixels[i][c];
+        bx[c] += b * pixels[i][c];
+      }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f)
+      return false;
+    for (int c = 0; c < channels; ++c)
+    {
+      start[c] = Clamp255((ax[c] * bb - bx[c] * ab) / determinant);
+      end[c]   = Clamp255((bx[c] * aa - ax[c] * ab) / determinant);
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static uint16_t To565(const float colour[4])
+  {
+    const uint32_t r = (uint32_t)(Clamp255(colour[0]) * 31.0f / 255.0f + 0.5f);
+    const uint32_t g = (uint32_t)(Clamp255(colour[1]) * 63.0f / 255.0f + 0.5f);
+    const uint32_t b = (uint32_t)(Clamp255(colour[2]) * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)((r << 11u) | (g << 5u) | b);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void From565(uint16_t packed, float colour[4])
+  {
+    const uint32_t r = (packed >> 11u) & 31u;
+    const uint32_t g = (packed >> 5u) & 63u;
+    const uint32_t b = packed & 31u;
+    colour[0] = (float)((r << 3u) | (r >> 2u));
+    colour[1] = (float)((g << 2u) | (g >> 4u));
+    colour[2] = (float)((b << 3u) | (b >> 2u));
+    colour[3] = 255.0f;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Always in the four colour mode, which is the only one BC3 has. Returns
+  // the squared error and the weight of the second endpoint per pixel.
+  static float EncodeColourEndpoints(const float pixels[16][4], uint16_t c0, uint16_t c1, uint8_t block[8], float weights[16])
+  {
+    if (c0 < c1)
+      std::swap(c0, c1);
+
+    float palette[4][4];
+    From565(c0, palette[0]);
+    From565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c)
+    {
+      palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+      palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+    }
+    static const float kWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+    // Equal endpoints decode in the three colour mode, where only the
+    // first index is the same.
+    const int count = c0 == c1 ? 1 : 4;
+    uint32_t indices = 0u;
+    float error = 0.0f;
+    for (int i = 0; i < 16; ++i)
+    {
+      int best = 0;
+      float best_error = 1e30f;
+      for (int p = 0; p < count; ++p)
+      {
+        float e = 0.0f;
+        for (int c = 0; c < 3; ++c)
+          e += (pixels[i][c] - palette[p][c]) * (pixels[i][c] - palette[p][c]);
+        if (e < best_error)
+        {
+          best_error = e;
+          best = p;
+        }
+      }
+      indices |= (uint32_t)best << (i * 2);
+      weights[i] = kWeights[best];
+      error += best_error;
+    }
+
+    BitWriter writer(block, 8u);
+    writer.Write(c0, 16u);
+    writer.Write(c1, 16u);
+    writer.Write(indices, 32u);
+    return error;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void EncodeColour(const float pixels[16][4], TextureQuality quality, uint8_t block[8])
+  {
+    float start[4], end[4], weights[16];
+    FindEndpoints(pixels, 3, quality, start, end);
+    float error = EncodeColourEndpoints(pixels, To565(start), To565(end), block, weights);
+
+    if (quality != TextureQuality::kHigh)
+      return;
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+      uint8_t candidate[8];
+      float candidate_weights[16];
+      if (!RefineEndpoints(pixels, 3, weights, start, end))
+        return;
+      const float candidate_error = EncodeColourEndpoints(pixels, To565(start), To565(end), candidate, candidate_weights);
+      if (candidate_error >= error)
+        return;
+      error = candidate_error;
+      memcpy(block, candidate, sizeof(candidate));
+      memcpy(weights, candidate_weights, sizeof(candidate_weights));
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Always in the eight value mode, with a0 > a1.
+  static float EncodeChannelEndpoints(const float values[16], int a0, int a1, uint8_t block[8])
+  {
+    float palette[8];
+    palette[0] = (float)a0;
+    palette[1] = (float)a1;
+    for (int p = 2; p < 8; ++p)
+      palette[p] = ((float)(8 - p) * a0 + (float)(p - 1) * a1) / 7.0f;
+    const int count = a0 == a1 ? 1 : 8;
+
+    BitWriter writer(block, 8u);
+    writer.Write((uint32_t)a0, 8u);
+    writer.Write((uint32_t)a1, 8u);
+
+    float error = 0.0f;
+    for (int i = 0; i < 16; ++i)
+    {
+      int best = 0;
+      float best_error = 1e30f;
+      for (int p = 0; p < count; ++p)
+      {
+        const float e = (values[i] - palette[p]) * (values[i] - palette[p]);
+        if (e < best_error)
+        {
+          best_error = e;
+          best = p;
+        }
+      }
+      writer.Write((uint32_t)best, 3u);
+      error += best_error;
+    }
+    return error;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void EncodeChannel(const float pixels[16][4], int channel, TextureQuality quality, uint8_t block[8])
+  {
+    float values[16];
+    int min = 255, max = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+      values[i] = pixels[i][channel];
+      min = std::min(min, (int)values[i]);
+      max = std::max(max, (int)values[i]);
+    }
+
+    float error = EncodeChannelEndpoints(values, max, min, block);
+    if (quality != TextureQuality::kHigh)
+      return;
+
+    // Pulling the ends in lets the six values in between land closer.
+    for (int top = 0; top < 4; ++top)
+    {
+      for (int bottom = 0; bottom < 4; ++bottom)
+      {
+        if ((top == 0 && bottom == 0) || max - top <= min + bottom)
+          continue;
+        uint8_t candidate[8];
+        const float candidate_error = EncodeChannelEndpoints(values, max - top, min + bottom, candidate);
+        if (candidate_error < error)
+        {
+          error = candidate_error;
+          memcpy(block, candidate, sizeof(candidate));
+        }
+      }
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static const int kBC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Mode 6: 7 bit RGBA endpoints with a shared lowest bit each, and 4 bit
+  // indices.
+  static float EncodeBC7Endpoints(const float pixels[16][4], const float start[4], const float end[4], uint8_t block[16], float weights[16])
+  {
+    uint32_t endpoints[2][4];
+    uint32_t p_bits[2];
+    const float* ends[2] = { start, end };
+    for (int e = 0; e < 2; ++e)
+    {
+      float best_error = 1e30f;
+      for (uint32_t p = 0u; p < 2u; ++p)
+      {
+        uint32_t quantised[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; ++c)
+        {
+          const int q = std::min(127, std::max(0, (int)std::floor((ends[e][c] - (float)p) / 2.0f + 0.5f)));
+          quantised[c] = (uint32_t)q;
+          const float value = (float)(((uint32_t)q << 1u) | p);
+          error += (value - ends[e][c]) * (value - ends[e][c]);
+        }
+        if (error < best_error)
+        {
+          best_error = error;
+          p_bits[e] = p;
+          memcpy(endpoints[e], quantised, sizeof(quantised));
+        }
+      }
+    }
+
+    int palette[16][4];
+    for (int c = 0; c < 4; ++c)
+    {
+      const int a = (int)((endpoints[0][c] << 1u) | p_bits[0]);
+      const int b = (int)((endpoints[1][c] << 1u) | p_bits[1]);
+      for (int i = 0; i < 16; ++i)
+        palette[i][c] = ((64 - kBC7Weights[i]) * a + kBC7Weights[i] * b + 32) >> 6;
+    }
+
+    uint32_t indices[16];
+    float error = 0.0f;
+    for (int i = 0; i < 16; ++i)
+    {
+      uint32_t best = 0u;
+      float best_error = 1e30f;
+      for (uint32_t p = 0u; p < 16u; ++p)
+      {
+        float e = 0.0f;
+        for (int c = 0; c < 4; ++c)
+          e += (pixels[i][c] - (float)palette[p][c]) * (pixels[i][c] - (float)palette[p][c]);
+        if (e < best_error)
+        {
+          best_error = e;
+          best = p;
+        }
+      }
+      indices[i] = best;
+      weights[i] = (float)kBC7Weights[best] / 64.0f;
+      error += best_error;
+    }
+
+    // The highest bit of the first index is implied to be 0.
+    if (indices[0] >= 8u)
+    {
+      std::swap(endpoints[0], endpoints[1]);
+      std::swap(p_bits[0], p_bits[1]);
+      for (int i = 0; i < 16; ++i)
+        indices[i] = 15u - indices[i];
+    }
+
+    BitWriter writer(block, 16u);
+    writer.Write(1u << 6u, 7u);
+    for (int c = 0; c < 4; ++c)
+    {
+      writer.Write(endpoints[0][c], 7u);
+      writer.Write(endpoints[1][c], 7u);
+    }
+    writer.Write(p_bits[0], 1u);
+    writer.Write(p_bits[1], 1u);
+    writer.Write(indices[0], 3u);
+    for (int i = 1; i < 16; ++i)
+      writer.Write(indices[i], 4u);
+    return error;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void EncodeBC1(const uint8_t pixels[64], TextureQuality quality, uint8_t block[8])
+  {
+    float loaded[16][4];
+    LoadBlock(pixels, loaded);
+    EncodeColour(loaded, quality, block);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void EncodeBC3(const uint8_t pixels[64], TextureQuality quality, uint8_t block[16])
+  {
+    float loaded[16][4];
+    LoadBlock(pixels, loaded);
+    EncodeChannel(loaded, 3, quality, block);
+    EncodeColour(loaded, quality, block + 8);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void EncodeBC4(const uint8_t pixels[64], TextureQuality quality, uint8_t block[8])
+  {
+    float loaded[16][4];
+    LoadBlock(pixels, loaded);
+    EncodeChannel(loaded, 0, quality, block);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void EncodeBC5(const uint8_t pixels[64], TextureQuality quality, uint8_t block[16])
+  {
+    float loaded[16][4];
+    LoadBlock(pixels, loaded);
+    EncodeChannel(loaded, 0, quality, block);
+    EncodeChannel(loaded, 1, quality, block + 8);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void EncodeBC7(const uint8_t pixels[64], TextureQuality quality, uint8_t block[16])
+  {
+    float loaded[16][4];
+    LoadBlock(pixels, loaded);
+
+    float start[4], end[4], weights[16];
+    FindEndpoints(loaded, 4, quality, start, end);
+    float error = EncodeBC7Endpoints(loaded, start, end, block, weights);
+
+    if (quality != TextureQuality::kHigh)
+      return;
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+      uint8_t candidate[16];
+      float candidate_weights[16];
+      if (!RefineEndpoints(loaded, 4, weights, start, end))
+        return;
+      const float candidate_error = EncodeBC7Endpoints(loaded, start, end, candidate, candidate_weights);
+      if (candidate_error >= error)
+        return;
+      error = candidate_error;
+      memcpy(block, candidate, sizeof(candidate));
+      memcpy(weights, candidate_weights, sizeof(candidate_weights));
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  uint32_t GetBlockSize(TextureFormat format)
+  {
+    switch (format)
+    {
+    case TextureFormat::kBC1:
+    case TextureFormat::kBC4:
+      return 8u;
+    case TextureFormat::kBC3:
+    case TextureFormat::kBC5:
+    case TextureFormat::kBC7:
+      return 16u;
+    default:
+      return 0u;
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void EncodeBlockRows(
+    TextureFormat format,
+    const uint8_t* rgba,
+    uint32_t width,
+    uint32_t height,
+    uint32_t first_row,
+    uint32_t last_row,
+    TextureQuality quality,
+    uint8_t* output)
+  {
+    const uint32_t block_size = GetBlockSize(format);
+    const uint32_t blocks_x   = std::max(1u, (width + 3u) / 4u);
+
+    uint8_t pixels[64];
+    for (uint32_t by = first_row; by < last_row; ++by)
+    {
+      for (uint32_t bx = 0u; bx < blocks_x; ++bx)
+      {
+        for (uint32_t y = 0u; y < 4u; ++y)
+        {
+          const uint32_t sy = std::min(by * 4u + y, height - 1u);
+          for (uint32_t x = 0u; x < 4u; ++x)
+          {
+            const uint32_t sx = std::min(bx * 4u + x, width - 1u);
+            memcpy(pixels + (y * 4u + x) * 4u, rgba + ((size_t)sy * width + sx) * 4u, 4u);
+          }
+        }
+
+        uint8_t* block = output + ((size_t)by * blocks_x + bx) * block_size;
+        switch (format)
+        {
+        case TextureFormat::kBC1: EncodeBC1(pixels, quality, block); break;
+        case TextureFormat::kBC3: EncodeBC3(pixels, quality, block); break;
+        case TextureFormat::kBC4: EncodeBC4(pixels, quality, block); break;
+        case TextureFormat::kBC5: EncodeBC5(pixels, quality, block); break;
+        case TextureFormat::kBC7: EncodeBC7(pixels, quality, block); break;
+        default: break;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <assets/enums.h>
+#include <cstdint>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // How hard the encoders look for the best endpoints.
+  enum class TextureQuality : uint8_t
+  {
+    kFast,   // Bounding box endpoints.
+    kNormal, // Endpoints along the principal axis.
+    kHigh,   // Principal axis, refined with least squares.
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Every encoder takes one 4x4 block of RGBA8 pixels, row after row. BC1
+  // never uses its 1 bit alpha, so it is for opaque blocks only. BC7 only
+  // uses mode 6, a single subset with 4 bit indices, which suits both
+  // opaque and transparent blocks.
+  void EncodeBC1(const uint8_t pixels[64], TextureQuality quality, uint8_t block[8]);
+  void EncodeBC3(const uint8_t pixels[64], TextureQuality quality, uint8_t block[16]);
+  void EncodeBC4(const uint8_t pixels[64], TextureQuality quality, uint8_t block[8]);
+  void EncodeBC5(const uint8_t pixels[64], TextureQuality quality, uint8_t block[16]);
+  void EncodeBC7(const uint8_t pixels[64], TextureQuality quality, uint8_t block[16]);
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Encodes the rows of blocks [first_row, last_row) of an RGBA8 image of
+  // any size into output, which holds the whole level. Blocks that hang
+  // over the edge repeat the last row and column. Rows can be encoded on
+  // different threads.
+  void EncodeBlockRows(
+    TextureFormat format,
+    const uint8_t* rgba,
+    uint32_t width,
+    uint32_t height,
+    uint32_t first_row,
+    uint32_t last_row,
+    TextureQuality quality,
+    uint8_t* output
+  );
+
+  // 8 or 16, or 0 when the format is not one of the ones above.
+  uint32_t GetBlockSize(TextureFormat format);
+}
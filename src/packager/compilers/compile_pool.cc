@@ -0,0 +1,117 @@
+#include "compile_pool.h"
+#include <containers/containers.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Batches are only touched with the mutex held, so the thread that waits
+  // for one can return as soon as the last chunk is counted.
+  struct Batch
+  {
+    const std::function<void(uint32_t, uint32_t)>* function;
+    uint32_t count;
+    uint32_t grain;
+    uint32_t next;
+    uint32_t done;
+  };
+
+  static std::mutex              g_mutex;
+  static std::condition_variable g_wake;
+  static Vector<Batch*>          g_batches;
+  static Vector<std::thread>     g_threads;
+  static bool                    g_stop = false;
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void runChunk(Batch& batch, std::unique_lock<std::mutex>& lock)
+  {
+    const uint32_t first = batch.next;
+    const uint32_t last  = std::min(batch.count, first + batch.grain);
+    batch.next = last;
+    if (last == batch.count)
+      g_batches.erase(eastl::find(g_batches.begin(), g_batches.end(), &batch));
+
+    lock.unlock();
+    (*batch.function)(first, last);
+    lock.lock();
+
+    batch.done += last - first;
+    if (batch.done == batch.count)
+      g_wake.notify_all();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void workerLoop()
+  {
+    std::unique_lock<std::mutex> lock(g_mutex);
+    while (true)
+    {
+      if (!g_batches.empty())
+        runChunk(*g_batches.front(), lock);
+      else if (g_stop)
+        return;
+      else
+        g_wake.wait(lock);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void CompilePool::Initialize(uint32_t thread_count)
+  {
+    Deinitialize();
+    g_stop = false;
+    for (uint32_t i = 1u; i < thread_count; ++i)
+      g_threads.push_back(std::thread(workerLoop));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void CompilePool::Deinitialize()
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_mutex);
+      g_stop = true;
+    }
+    g_wake.notify_all();
+    for (std::thread& thread : g_threads)
+      thread.join();
+    g_threads.clear();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  uint32_t CompilePool::GetThreadCount()
+  {
+    return (uint32_t)g_threads.size() + 1u;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void CompilePool::ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& function)
+  {
+    grain = std::max(1u, grain);
+    if (count == 0u)
+      return;
+    if (g_threads.empty() || count <= grain)
+    {
+      function(0u, count);
+      return;
+    }
+
+    Batch batch{ &function, count, grain, 0u, 0u };
+    std::unique_lock<std::mutex> lock(g_mutex);
+    g_batches.push_back(&batch);
+    g_wake.notify_all();
+
+    // Only this batch is worked on while waiting. Picking up a chunk of
+    // another one could be a whole file of the builder, which would hold
+    // this one up for as long.
+    while (batch.done < batch.count)
+    {
+      if (batch.next < batch.count)
+        runChunk(batch, lock);
+      else
+        g_wake.wait(lock);
+    }
+  }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // The threads the builder starts once and every compiler shares. A range
+  // is split over the workers that are idle and the thread that asks works
+  // on it too, also when that is a worker itself, so compilers that split
+  // their work from within a build job do not add any threads. Without
+  // workers the whole range runs on the calling thread.
+  class CompilePool
+  {
+  public:
+    // thread_count includes the thread that calls ParallelFor.
+    static void Initialize(uint32_t thread_count);
+    static void Deinitialize();
+    static uint32_t GetThreadCount();
+
+    // Calls function with [first, last) ranges of at most grain items,
+    // until all of [0, count) is done.
+    static void ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& function);
+  };
+}
@@ -1,9 +1,14 @@
 #include "mesh_compiler.h"
+#include "compile_pool.h"
+#include "mesh_optimizer.h"
+#include "mesh_simplifier.h"
 #include <utils/file_system.h>
 #include <utils/utilities.h>
 #include <utils/console.h>
 #include <memory/memory.h>
 #include <algorithm>
+#include <cfloat>
+#include <cstdio>
 #include <utils/decompose_matrix.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -546,6 +551,269 @@ namespace lambda
 		}
 	}
 
+	static VioletDataInfo VioletMeshData::* const kAttributeStreams[] = {
+		&VioletMeshData::pos, &VioletMeshData::nor, &VioletMeshData::tan, &VioletMeshData::col, &VioletMeshData::tex, &VioletMeshData::joi, &VioletMeshData::wei
+	};
+	static int VioletSubMesh::* const kAttributes[] = {
+		&VioletSubMesh::pos, &VioletSubMesh::nor, &VioletSubMesh::tan, &VioletSubMesh::col, &VioletSubMesh::tex, &VioletSubMesh::joi, &VioletSubMesh::wei
+	};
+	static const size_t kAttributeCount = sizeof(kAttributes) / sizeof(kAttributes[0]);
+
+	struct MeshStats
+	{
+		double acmr_before  = 0.0;
+		double acmr_after   = 0.0;
+		double fetch_before = 0.0;
+		double fetch_after  = 0.0;
+		size_t triangles    = 0u;
+		size_t lods         = 0u;
+	};
+
+	// Which index segment uses every segment of an attribute stream, -1
+	// for none and -2 when there are several or it is drawn without one.
+	Vector<int> getOwners(const Vector<VioletSubMesh>& meshes, int VioletSubMesh::* member, size_t segment_count)
+	{
+		Vector<int> owners(segment_count, -1);
+		for (const VioletSubMesh& mesh : meshes)
+		{
+			const int segment = mesh.*member;
+			if (segment < 0)
+				continue;
+			int& owner = owners.at(segment);
+			if (mesh.idx < 0 || (owner != -1 && owner != mesh.idx))
+				owner = -2;
+			else
+				owner = mesh.idx;
+		}
+		return owners;
+	}
+
+	Vector<uint32_t> getIndices(const VioletDataInfo& info, int idx)
+	{
+		const VioletDataSegment& segment = info.segments.at(idx);
+		Vector<uint32_t> indices(segment.count);
+		memcpy(indices.data(), info.data.data() + segment.offset, segment.count * sizeof(uint32_t));
+		return indices;
+	}
+
+	// The first sub mesh that draws the index segment as a triangle list,
+	// when every sub mesh that draws it agrees on what it indexes and the
+	// indices stay within the positions. Null when not.
+	const VioletSubMesh* getTriangleList(const VioletMesh& mesh, int idx)
+	{
+		const VioletSubMesh* first = nullptr;
+		for (const VioletSubMesh& sub_mesh : mesh.meshes)
+		{
+			if (sub_mesh.idx != idx)
+				continue;
+			if (first == nullptr)
+				first = &sub_mesh;
+			if (sub_mesh.topology != TINYGLTF_MODE_TRIANGLES)
+				return nullptr;
+			for (size_t a = 0u; a < kAttributeCount; ++a)
+				if (sub_mesh.*kAttributes[a] != first->*kAttributes[a])
+					return nullptr;
+		}
+		if (first == nullptr || first->pos < 0)
+			return nullptr;
+
+		const VioletDataSegment& positions = mesh.data.pos.segments.at(first->pos);
+		const VioletDataSegment& segment = mesh.data.idx.segments.at(idx);
+		if (positions.stride != sizeof(glm::vec3) || segment.count % 3u != 0u)
+			return nullptr;
+
+		const Vector<uint32_t> indices = getIndices(mesh.data.idx, idx);
+		for (const uint32_t index : indices)
+			if (index >= positions.count)
+				return nullptr;
+		return first;
+	}
+
+	// Reorders the triangles of every index segment for the vertex cache
+	// and overdraw, and its vertices for fetching when no other index
+	// segment uses them.
+	void optimizeMesh(VioletMesh& mesh, MeshStats& stats)
+	{
+		VioletMeshData& data = mesh.data;
+
+		Vector<int> owners[kAttributeCount];
+		for (size_t a = 0u; a < kAttributeCount; ++a)
+			owners[a] = getOwners(mesh.meshes, kAttributes[a], (data.*kAttributeStreams[a]).segments.size());
+
+		for (int i = 0; i < (int)data.idx.segments.size(); ++i)
+		{
+			const VioletSubMesh* first = getTriangleList(mesh, i);
+			if (first == nullptr)
+				continue;
+
+			const VioletDataSegment& positions = data.pos.segments.at(first->pos);
+			const size_t vertex_count = positions.count;
+			Vector<uint32_t> indices = getIndices(data.idx, i);
+
+			// As if the attributes were interleaved.
+			size_t vertex_size = 0u;
+			bool owned = true;
+			for (size_t a = 0u; a < kAttributeCount; ++a)
+			{
+				const int s = first->*kAttributes[a];
+				if (s < 0)
+					continue;
+				const VioletDataSegment& attribute = (data.*kAttributeStreams[a]).segments.at(s);
+				vertex_size += attribute.stride;
+				owned &= owners[a].at(s) == i && attribute.count == vertex_count;
+			}
+
+			const double triangle_count = (double)(indices.size() / 3u);
+			stats.acmr_before  += AnalyzeVertexCache(indices.data(), indices.size(), vertex_count) * triangle_count;
+			stats.fetch_before += AnalyzeVertexFetch(indices.data(), indices.size(), vertex_count, vertex_size) * triangle_count;
+
+			OptimizeVertexCache(indices.data(), indices.size(), vertex_count);
+			OptimizeOverdraw(
+				indices.data(),
+				indices.size(),
+				(const float*)(data.pos.data.data() + positions.offset),
+				positions.stride,
+				vertex_count,
+				1.05f
+			);
+
+			if (owned)
+			{
+				Vector<uint32_t> remap(vertex_count);
+				OptimizeVertexFetchRemap(remap.data(), indices.data(), indices.size(), vertex_count);
+				for (uint32_t& index : indices)
+					index = remap[index];
+
+				for (size_t a = 0u; a < kAttributeCount; ++a)
+				{
+					const int s = first->*kAttributes[a];
+					if (s < 0)
+						continue;
+					VioletDataInfo& stream = data.*kAttributeStreams[a];
+					const VioletDataSegment& attribute = stream.segments.at(s);
+					unsigned char* vertices = stream.data.data() + attribute.offset;
+					Vector<unsigned char> copy(vertices, vertices + attribute.count * attribute.stride);
+					for (size_t v = 0u; v < vertex_count; ++v)
+						memcpy(vertices + remap[v] * attribute.stride, copy.data() + v * attribute.stride, attribute.stride);
+				}
+			}
+
+			stats.acmr_after  += AnalyzeVertexCache(indices.data(), indices.size(), vertex_count) * triangle_count;
+			stats.fetch_after += AnalyzeVertexFetch(indices.data(), indices.size(), vertex_count, vertex_size) * triangle_count;
+			stats.triangles   += indices.size() / 3u;
+
+			memcpy(data.idx.data.data() + data.idx.segments.at(i).offset, indices.data(), indices.size() * sizeof(uint32_t));
+		}
+	}
+
+	// Adds a chain of simplified index segments for every index segment
+	// that draws triangles, one chain per job of the compile pool.
+	void generateLODs(VioletMesh& mesh, const MeshCompileInfo& info, MeshStats& stats)
+	{
+		if (info.lod_count == 0u)
+			return;
+
+		struct Chain
+		{
+			int                      idx;
+			Vector<Vector<uint32_t>> levels;
+			Vector<float>            errors;
+		};
+		Vector<Chain> chains;
+		for (int i = 0; i < (int)mesh.data.idx.segments.size(); ++i)
+			if (getTriangleList(mesh, i) != nullptr)
+				chains.push_back(Chain{ i });
+
+		CompilePool::ParallelFor((uint32_t)chains.size(), 1u, [&mesh, &info, &chains](uint32_t first, uint32_t last) {
+			for (uint32_t c = first; c < last; ++c)
+			{
+				Chain& chain = chains[c];
+				const VioletDataSegment& positions = mesh.data.pos.segments.at(getTriangleList(mesh, chain.idx)->pos);
+				const float* points = (const float*)(mesh.data.pos.data.data() + positions.offset);
+				const Vector<uint32_t> indices = getIndices(mesh.data.idx, chain.idx);
+
+				glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+				for (size_t v = 0u; v < positions.count; ++v)
+				{
+					const glm::vec3 point(points[v * 3u], points[v * 3u + 1u], points[v * 3u + 2u]);
+					min = glm::min(min, point);
+					max = glm::max(max, point);
+				}
+				const float max_error = info.lod_max_error * glm::length(max - min);
+
+				// Every level starts from the original, so its error is
+				// measured against what it stands in for.
+				size_t target = indices.size();
+				size_t previous = indices.size();
+				for (uint32_t level = 0u; level < info.lod_count; ++level)
+				{
+					target = (size_t)((float)(target / 3u) * info.lod_reduction) * 3u;
+					Vector<uint32_t> lod(indices.size());
+					float error = 0.0f;
+					lod.resize(SimplifyMesh(lod.data(), indices.data(), indices.size(), points, positions.stride, positions.count, target, max_error, &error));
+
+					// Not worth a level when it barely got smaller.
+					if (lod.empty() || lod.size() * 10u > previous * 9u)
+						break;
+
+					OptimizeVertexCache(lod.data(), lod.size(), positions.count);
+					previous = lod.size();
+					chain.levels.push_back(eastl::move(lod));
+					chain.errors.push_back(error);
+				}
+			}
+		});
+
+		// The levels go after the indices they came from, and every sub mesh
+		// that draws those gets them.
+		for (const Chain& chain : chains)
+		{
+			for (size_t level = 0u; level < chain.levels.size(); ++level)
+			{
+				const Vector<uint32_t>& lod = chain.levels[level];
+				const int idx = (int)mesh.data.idx.segments.size();
+				mesh.data.idx.segments.push_back({
+					/* offset */ mesh.data.idx.data.size(),
+					/* count  */ lod.size(),
+					/* stride */ sizeof(uint32_t)
+				});
+				const unsigned char* bytes = (const unsigned char*)lod.data();
+				mesh.data.idx.data.insert(mesh.data.idx.data.end(), bytes, bytes + lod.size() * sizeof(uint32_t));
+
+				for (int s = 0; s < (int)mesh.meshes.size(); ++s)
+				{
+					if (mesh.meshes[s].idx != chain.idx)
+						continue;
+					VioletSubMeshLOD sub_mesh_lod;
+					sub_mesh_lod.sub_mesh = s;
+					sub_mesh_lod.idx      = idx;
+					sub_mesh_lod.error    = chain.errors[level];
+					mesh.data.lods.push_back(sub_mesh_lod);
+				}
+				stats.lods++;
+			}
+		}
+	}
+
+	size_t getByteSize(const VioletMeshData& data)
+	{
+		size_t bytes = data.idx.data.size();
+		for (size_t a = 0u; a < kAttributeCount; ++a)
+			bytes += (data.*kAttributeStreams[a]).data.size();
+		return bytes;
+	}
+
+	// Stores the streams as small as they go. The runtime decodes them
+	// when the mesh is read.
+	void encodeMesh(VioletMeshData& data)
+	{
+		VioletMeshManager::EncodeStream(data.nor, VioletStreamEncoding::kOctahedral);
+		VioletMeshManager::EncodeStream(data.tan, VioletStreamEncoding::kOctahedralSign);
+		VioletMeshManager::EncodeStream(data.tex, VioletStreamEncoding::kHalf);
+		VioletMeshManager::EncodeStream(data.col, VioletStreamEncoding::kUnorm8);
+		VioletMeshManager::EncodeStream(data.idx, VioletStreamEncoding::kIndex16);
+	}
+
 	tinygltf::Model loadWorld(const String& path)
 	{
 		tinygltf::Model model;
@@ -602,6 +870,31 @@ namespace lambda
 	bool VioletMeshCompiler::Compile(MeshCompileInfo mesh_info)
 	{
 		VioletMesh mesh = loadMeshGLTF(mesh_info.file);
+		const size_t raw_bytes = getByteSize(mesh.data);
+
+		MeshStats stats;
+		optimizeMesh(mesh, stats);
+		generateLODs(mesh, mesh_info, stats);
+		encodeMesh(mesh.data);
+
+		const double weight = stats.triangles > 0u ? 1.0 / (double)stats.triangles : 0.0;
+		char report[256];
+		snprintf(
+			report,
+			sizeof(report),
+			"%s: %u triangles, ACMR %.3f -> %.3f, fetch %.2f -> %.2f, %u LODs, %.1f KB -> %.1f KB\n",
+			mesh_info.file.c_str(),
+			(unsigned int)stats.triangles,
+			stats.acmr_before * weight,
+			stats.acmr_after * weight,
+			stats.fetch_before * weight,
+			stats.fetch_after * weight,
+			(unsigned int)stats.lods,
+			raw_bytes / 1024.0,
+			getByteSize(mesh.data) / 1024.0
+		);
+		foundation::Info(report);
+
 		mesh.hash = GetHash(mesh_info.file);
 		mesh.file = mesh_info.file;
 		AddMesh(mesh);
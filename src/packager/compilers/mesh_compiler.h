@@ -6,11 +6,21 @@ namespace lambda
   struct MeshCompileInfo
   {
     String file;
+    // How many simplified versions every sub mesh gets at most. Each has
+    // lod_reduction of the triangles of the one before it, and stops the
+    // chain when it has to move the surface further than lod_max_error
+    // times the size of the sub mesh.
+    uint32_t lod_count     = 3u;
+    float    lod_reduction = 0.5f;
+    float    lod_max_error = 0.02f;
   };
 
   class VioletMeshCompiler : public VioletMeshManager
   {
   public:
+    // See VioletTextureCompiler::kVersion.
+    static constexpr uint32_t kVersion = 3u;
+
     VioletMeshCompiler();
     bool Compile(MeshCompileInfo mesh_info);
   };
@@ -0,0 +1,335 @@
+#include "mesh_optimizer.h"
+#include <containers/containers.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // The cache the optimizer scores against is larger than the one it is
+  // measured with, which is what Forsyth recommends.
+  static constexpr uint32_t kScoreCacheSize = 32u;
+  static constexpr uint32_t kFetchLineSize  = 64u;
+  static constexpr uint32_t kFetchLineCount = 64u;
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static float VertexScore(int cache_position, uint32_t valence)
+  {
+    if (valence == 0u)
+      return -1.0f;
+
+    // The last triangle's vertices score the same, so it does not matter
+    // in which order they went in.
+    float score = 0.0f;
+    if (cache_position >= 0)
+      score = cache_position < 3 ? 0.75f : std::pow(1.0f - (cache_position - 3) / float(kScoreCacheSize - 3u), 1.5f);
+
+    // Vertices with few triangles left are finished first.
+    return score + 2.0f / std::sqrt((float)valence);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // FIFO cache with time stamps. Returns how many of the triangle's
+  // vertices had to be transformed.
+  static uint32_t UpdateCache(const uint32_t* triangle, Vector<uint32_t>& cache_time, uint32_t& time, uint32_t cache_size)
+  {
+    uint32_t misses = 0u;
+    for (uint32_t k = 0u; k < 3u; ++k)
+    {
+      const uint32_t vertex = triangle[k];
+      if (time - cache_time[vertex] > cache_size)
+      {
+        cache_time[vertex] = time++;
+        ++misses;
+      }
+    }
+    return misses;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void OptimizeVertexCache(uint32_t* indices, size_t index_count, size_t vertex_count)
+  {
+    const size_t triangle_count = index_count / 3u;
+    if (triangle_count == 0u)
+      return;
+
+    // The triangles that use every vertex, packed one vertex after another.
+    Vector<uint32_t> live(vertex_count, 0u);
+    for (size_t i = 0u; i < triangle_count * 3u; ++i)
+      live[indices[i]]++;
+
+    Vector<uint32_t> first(vertex_count + 1u, 0u);
+    for (size_t v = 0u; v < vertex_count; ++v)
+      first[v + 1u] = first[v] + live[v];
+
+    Vector<uint32_t> adjacency(triangle_count * 3u);
+    Vector<uint32_t> fill(first.begin(), first.end() - 1);
+    for (size_t i = 0u; i < triangle_count * 3u; ++i)
+      adjacency[fill[indices[i]]++] = (uint32_t)(i / 3u);
+
+    Vector<int>   cache_position(vertex_count, -1);
+    Vector<float> vertex_score(vertex_count);
+    for (size_t v = 0u; v < vertex_count; ++v)
+      vertex_score[v] = VertexScore(-1, live[v]);
+
+    Vector<float>   triangle_score(triangle_count);
+    Vector<uint8_t> emitted(triangle_count, 0u);
+    size_t best = 0u;
+    for (size_t t = 0u; t < triangle_count; ++t)
+    {
+      const uint32_t* triangle = indices + t * 3u;
+      triangle_score[t] = vertex_score[triangle[0]] + vertex_score[triangle[1]] + vertex_score[triangle[2]];
+      if (triangle_score[t] > triangle_score[best])
+        best = t;
+    }
+
+    Vector<uint32_t> output;
+    output.reserve(triangle_count * 3u);
+    uint32_t cache[kScoreCacheSize + 3u];
+    uint32_t cache_count = 0u;
+    size_t   cursor = 0u;
+
+    while (true)
+    {
+      emitted[best] = 1u;
+      const uint32_t* triangle = indices + best * 3u;
+
+      // The triangle's vertices go to the front of the cache.
+      uint32_t next[kScoreCacheSize + 3u];
+      uint32_t next_count = 0u;
+      for (uint32_t k = 0u; k < 3u; ++k)
+      {
+        const uint32_t vertex = triangle[k];
+        output.push_back(vertex);
+
+        uint32_t* begin = adjacency.data() + first[vertex];
+        uint32_t* end   = begin + live[vertex];
+        uint32_t* it    = std::find(begin, end, (uint32_t)best);
+        std::swap(*it, *(end - 1));
+        live[vertex]--;
+
+        if (std::find(next, next + next_count, vertex) == next + next_count)
+          next[next_count++] = vertex;
+      }
+      for (uint32_t i = 0u; i < cache_count; ++i)
+        if (std::find(next, next + next_count, cache[i]) == next + next_count)
+          next[next_count++] = cache[i];
+
+      // Everything that was pushed out is back to no cache position.
+      for (uint32_t i = 0u; i < next_count; ++i)
+      {
+        const uint32_t vertex = next[i];
+        cache_position[vertex] = i < kScoreCacheSize ? (int)i : -1;
+        vertex_score[vertex] = VertexScore(cache_position[vertex], live[vertex]);
+      }
+      cache_count = std::min(next_count, kScoreCacheSize);
+      memcpy(cache, next, cache_count * sizeof(uint32_t));
+
+      // Only the triangles of the vertices that moved change score.
+      bool found = false;
+      float best_score = 0.0f;
+      for (uint32_t i = 0u; i < next_count; ++i)
+      {
+        const uint32_t vertex = next[i];
+        for (uint32_t j = first[vertex]; j < first[vertex] + live[vertex]; ++j)
+        {
+          const uint32_t t = adjacency[j];
+          const uint32_t* other = indices + t * 3u;
+          triangle_score[t] = vertex_score[other[0]] + vertex_score[other[1]] + vertex_score[other[2]];
+          if (!found || triangle_score[t] > best_score)
+          {
+            best = t;
+            best_score = triangle_score[t];
+            found = true;
+          }
+        }
+      }
+
+      // At a dead end, start again from the first triangle that is left.
+      if (!found)
+      {
+        while (cursor < triangle_count && emitted[cursor])
+          ++cursor;
+        if (cursor == triangle_count)
+          break;
+        best = cursor;
+      }
+    }
+
+    memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  void OptimizeOverdraw(
+    uint32_t* indices,
+    size_t index_count,
+    const float* positions,
+    size_t position_stride,
+    size_t vertex_count,
+    float threshold)
+  {
+    const size_t triangle_count = index_count / 3u;
+    if (triangle_count == 0u)
+      return;
+
+    const uint32_t cache_size = 16u;
+    Vector<uint32_t> cache_time(vertex_count, 0u);
+    uint32_t time = cache_size + 1u;
+
+    // A triangle with three new vertices is where the cache starts over.
+    Vector<uint32_t> hard;
+    for (size_t t = 0u; t < triangle_count; ++t)
+      if (UpdateCache(indices + t * 3u, cache_time, time, cache_size) == 3u || t == 0u)
+        hard.push_back((uint32_t)t);
+    hard.push_back((uint32_t)triangle_count);
+
+    // In between, split wherever the cluster is already about as cache
+    // friendly as the whole of it.
+    Vector<uint32_t> clusters;
+    for (size_t c = 0u; c + 1u < hard.size(); ++c)
+    {
+      const uint32_t begin = hard[c];
+      const uint32_t end   = hard[c + 1u];
+
+      time += cache_size + 1u;
+      uint32_t misses = 0u;
+      for (uint32_t t = begin; t < end; ++t)
+        misses += UpdateCache(indices + t * 3u, cache_time, time, cache_size);
+      const float cluster_threshold = threshold * (float)misses / (float)(end - begin);
+
+      time += cache_size + 1u;
+      uint32_t start = begin;
+      misses = 0u;
+      clusters.push_back(begin);
+      for (uint32_t t = begin; t < end; ++t)
+      {
+        misses += UpdateCache(indices + t * 3u, cache_time, time, cache_size);
+        if (t + 1u < end && (float)misses / (float)(t + 1u - start) <= cluster_threshold)
+        {
+          clusters.push_back(t + 1u);
+          start = t + 1u;
+          misses = 0u;
+          time += cache_size + 1u;
+        }
+      }
+    }
+    clusters.push_back((uint32_t)triangle_count);
+
+    auto position = [&](uint32_t vertex) {
+      const float* p = (const float*)((const char*)positions + vertex * position_stride);
+      return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    // Area weighted, so slivers do not pull the centre around.
+    Vector<glm::vec3> centroids(clusters.size() - 1u, glm::vec3(0.0f));
+    Vector<glm::vec3> normals(clusters.size() - 1u, glm::vec3(0.0f));
+    Vector<float>     areas(clusters.size() - 1u, 0.0f);
+    glm::vec3 mesh_centroid(0.0f);
+    float     mesh_area = 0.0f;
+    for (size_t c = 0u; c + 1u < clusters.size(); ++c)
+    {
+      for (uint32_t t = clusters[c]; t < clusters[c + 1u]; ++t)
+      {
+        const glm::vec3 a = position(indices[t * 3u + 0u]);
+        const glm::vec3 b = position(indices[t * 3u + 1u]);
+        const glm::vec3 d = position(indices[t * 3u + 2u]);
+        const glm::vec3 normal = glm::cross(b - a, d - a);
+        const float area = glm::length(normal);
+        centroids[c] += (a + b + d) * (area / 3.0f);
+        normals[c]   += normal;
+        areas[c]     += area;
+      }
+      mesh_centroid += centroids[c];
+      mesh_area     += areas[c];
+    }
+    if (mesh_area > 0.0f)
+      mesh_centroid /= mesh_area;
+
+    Vector<float>    keys(clusters.size() - 1u, 0.0f);
+    Vector<uint32_t> order(clusters.size() - 1u);
+    for (size_t c = 0u; c < order.size(); ++c)
+    {
+      order[c] = (uint32_t)c;
+      const float length = glm::length(normals[c]);
+      if (areas[c] > 0.0f && length > 0.0f)
+        keys[c] = glm::dot(centroids[c] / areas[c] - mesh_centroid, normals[c] / length);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return keys[lhs] > keys[rhs]; });
+
+    Vector<uint32_t> output;
+    output.reserve(triangle_count * 3u);
+    for (const uint32_t c : order)
+      output.insert(output.end(), indices + clusters[c] * 3u, indices + clusters[c + 1u] * 3u);
+    memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  size_t OptimizeVertexFetchRemap(uint32_t* remap, const uint32_t* indices, size_t index_count, size_t vertex_count)
+  {
+    memset(remap, 0xff, vertex_count * sizeof(uint32_t));
+
+    uint32_t next = 0u;
+    for (size_t i = 0u; i < index_count; ++i)
+      if (remap[indices[i]] == ~0u)
+        remap[indices[i]] = next++;
+
+    const size_t used = next;
+    for (size_t v = 0u; v < vertex_count; ++v)
+      if (remap[v] == ~0u)
+        remap[v] = next++;
+    return used;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  float AnalyzeVertexCache(const uint32_t* indices, size_t index_count, size_t vertex_count, uint32_t cache_size)
+  {
+    const size_t triangle_count = index_count / 3u;
+    if (triangle_count == 0u)
+      return 0.0f;
+
+    Vector<uint32_t> cache_time(vertex_count, 0u);
+    uint32_t time = cache_size + 1u;
+    size_t misses = 0u;
+    for (size_t t = 0u; t < triangle_count; ++t)
+      misses += UpdateCache(indices + t * 3u, cache_time, time, cache_size);
+    return (float)misses / (float)triangle_count;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  float AnalyzeVertexFetch(const uint32_t* indices, size_t index_count, size_t vertex_count, size_t vertex_size)
+  {
+    if (index_count == 0u || vertex_size == 0u)
+      return 0.0f;
+
+    const size_t line_count = (vertex_count * vertex_size + kFetchLineSize - 1u) / kFetchLineSize;
+    Vector<uint32_t> line_time(line_count, 0u);
+    Vector<uint8_t>  used(vertex_count, 0u);
+    uint32_t time = kFetchLineCount + 1u;
+    size_t used_count = 0u;
+    size_t fetched = 0u;
+
+    for (size_t i = 0u; i < index_count; ++i)
+    {
+      const uint32_t vertex = indices[i];
+      if (!used[vertex])
+      {
+        used[vertex] = 1u;
+        ++used_count;
+      }
+
+      const size_t first = vertex * vertex_size / kFetchLineSize;
+      const size_t last  = ((vertex + 1u) * vertex_size - 1u) / kFetchLineSize;
+      for (size_t line = first; line <= last; ++line)
+      {
+        if (time - line_time[line] > kFetchLineCount)
+        {
+          line_time[line] = time++;
+          fetched += kFetchLineSize;
+        }
+      }
+    }
+    return (float)fetched / (float)(used_count * vertex_size);
+  }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // All of these work on triangle lists of indices below vertex_count.
+
+  // Reorders the triangles so vertices are used again while they are still
+  // in the post transform cache. Tom Forsyth's linear speed optimizer.
+  void OptimizeVertexCache(uint32_t* indices, size_t index_count, size_t vertex_count);
+
+  // Reorders clusters of cache optimized triangles so the ones that face
+  // away from the centre of the mesh are drawn first. Clusters are split
+  // where the cache would start over anyway, and in between as long as
+  // the ACMR stays under threshold times what it was.
+  void OptimizeOverdraw(
+    uint32_t* indices,
+    size_t index_count,
+    const float* positions,
+    size_t position_stride,
+    size_t vertex_count,
+    float threshold
+  );
+
+  // Fills remap with where every vertex should go so they are fetched in
+  // the order the indices first use them. Unused vertices go at the end.
+  // Returns how many vertices are used.
+  size_t OptimizeVertexFetchRemap(uint32_t* remap, const uint32_t* indices, size_t index_count, size_t vertex_count);
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Average transformed vertices per triangle with a FIFO cache. 3 is the
+  // worst, 0.5 the best a regular grid can do.
+  float AnalyzeVertexCache(const uint32_t* indices, size_t index_count, size_t vertex_count, uint32_t cache_size = 16u);
+
+  // Bytes that are read through 64 byte cache lines, divided by the bytes
+  // of the vertices that are used. 1 is the best.
+  float AnalyzeVertexFetch(const uint32_t* indices, size_t index_count, size_t vertex_count, size_t vertex_size);
+}
@@ -0,0 +1,266 @@
+#include "mesh_simplifier.h"
+#include <containers/containers.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // The sum of the squared distances to the planes of the triangles that
+  // were merged into a vertex, weighted by their area.
+  struct Quadric
+  {
+    double a00 = 0.0, a11 = 0.0, a22 = 0.0;
+    double a10 = 0.0, a20 = 0.0, a21 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double w = 0.0;
+
+    void add(const Quadric& other)
+    {
+      a00 += other.a00; a11 += other.a11; a22 += other.a22;
+      a10 += other.a10; a20 += other.a20; a21 += other.a21;
+      b0 += other.b0; b1 += other.b1; b2 += other.b2;
+      c += other.c;
+      w += other.w;
+    }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static Quadric MakePlane(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+  {
+    Quadric q;
+    const glm::vec3 cross = glm::cross(b - a, c - a);
+    const double area = glm::length(cross);
+    if (area <= 0.0)
+      return q;
+
+    const double x = cross.x / area, y = cross.y / area, z = cross.z / area;
+    const double d = -(x * a.x + y * a.y + z * a.z);
+    q.a00 = x * x * area; q.a11 = y * y * area; q.a22 = z * z * area;
+    q.a10 = y * x * area; q.a20 = z * x * area; q.a21 = z * y * area;
+    q.b0 = x * d * area; q.b1 = y * d * area; q.b2 = z * d * area;
+    q.c = d * d * area;
+    q.w = area;
+    return q;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Mean squared distance of the point to the planes.
+  static double Evaluate(const Quadric& q, const glm::vec3& p)
+  {
+    const double x = p.x, y = p.y, z = p.z;
+    const double e =
+      q.a00 * x * x + q.a11 * y * y + q.a22 * z * z +
+      2.0 * (q.a10 * x * y + q.a20 * x * z + q.a21 * y * z) +
+      2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+    return q.w > 0.0 ? std::max(0.0, e) / q.w : 0.0;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  struct Collapse
+  {
+    uint32_t from;
+    uint32_t to;
+    double   error;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  size_t SimplifyMesh(
+    uint32_t* destination,
+    const uint32_t* indices,
+    size_t index_count,
+    const float* positions,
+    size_t position_stride,
+    size_t vertex_count,
+    size_t target_index_count,
+    float target_error,
+    float* result_error)
+  {
+    *result_error = 0.0f;
+    Vector<uint32_t> result(indices, indices + index_count - index_count % 3u);
+
+    Vector<glm::vec3> points(vertex_count);
+    for (size_t v = 0u; v < vertex_count; ++v)
+    {
+      const float* p = (const float*)((const char*)positions + v * position_stride);
+      points[v] = glm::vec3(p[0], p[1], p[2]);
+    }
+
+    // Vertices that share a position belong to the same corner, with
+    // different attributes on either side of a seam.
+    Vector<uint32_t> sorted(vertex_count);
+    for (size_t v = 0u; v < vertex_count; ++v)
+      sorted[v] = (uint32_t)v;
+    auto less = [&](uint32_t lhs, uint32_t rhs) {
+      const glm::vec3& a = points[lhs];
+      const glm::vec3& b = points[rhs];
+      return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+    };
+    std::sort(sorted.begin(), sorted.end(), less);
+
+    Vector<uint32_t> corner(vertex_count);
+    Vector<uint8_t>  locked(vertex_count, 0u);
+    for (size_t i = 0u; i < vertex_count;)
+    {
+      size_t j = i + 1u;
+      while (j < vertex_count && !less(sorted[i], sorted[j]))
+        ++j;
+      for (size_t k = i; k < j; ++k)
+      {
+        corner[sorted[k]] = sorted[i];
+        locked[sorted[k]] = j - i > 1u ? 1u : 0u;
+      }
+      i = j;
+    }
+
+    // Edges that only one triangle goes along are on a border.
+    Vector<uint64_t> edges;
+    edges.reserve(result.size());
+    for (size_t i = 0u; i < result.size(); ++i)
+    {
+      const uint32_t a = corner[result[i]];
+      const uint32_t b = corner[result[i - i % 3u + (i + 1u) % 3u]];
+      edges.push_back(((uint64_t)a << 32u) | b);
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t i = 0u; i < result.size(); ++i)
+    {
+      const uint32_t a = corner[result[i]];
+      const uint32_t b = corner[result[i - i % 3u + (i + 1u) % 3u]];
+      if (!std::binary_search(edges.begin(), edges.end(), ((uint64_t)b << 32u) | a))
+        locked[result[i]] = locked[result[i - i % 3u + (i + 1u) % 3u]] = 1u;
+    }
+
+    Vector<Quadric> quadrics(vertex_count);
+    for (size_t t = 0u; t < result.size(); t += 3u)
+    {
+      const Quadric plane = MakePlane(points[result[t]], points[result[t + 1u]], points[result[t + 2u]]);
+      for (size_t k = 0u; k < 3u; ++k)
+        quadrics[result[t + k]].add(plane);
+    }
+
+    const double max_error = (double)target_error * (double)target_error;
+    Vector<uint32_t>  first(vertex_count + 1u);
+    Vector<uint32_t>  adjacency;
+    Vector<uint32_t>  remap(vertex_count);
+    Vector<uint8_t>   touched(vertex_count);
+    Vector<Collapse>  collapses;
+
+    while (result.size() > target_index_count)
+    {
+      // The triangles around every vertex.
+      std::fill(first.begin(), first.end(), 0u);
+      for (const uint32_t index : result)
+        first[index + 1u]++;
+      for (size_t v = 0u; v < vertex_count; ++v)
+        first[v + 1u] += first[v];
+      adjacency.resize(result.size());
+      Vector<uint32_t> fill(first.begin(), first.end() - 1);
+      for (size_t i = 0u; i < result.size(); ++i)
+        adjacency[fill[result[i]]++] = (uint32_t)(i / 3u);
+
+      // The cheapest edge out of every vertex that can move.
+      collapses.clear();
+      for (size_t v = 0u; v < vertex_count; ++v)
+      {
+        if (locked[v] || first[v] == first[v + 1u])
+          continue;
+
+        Collapse best = { (uint32_t)v, (uint32_t)v, 0.0 };
+        for (uint32_t j = first[v]; j < first[v + 1u]; ++j)
+        {
+          const uint32_t* triangle = result.data() + adjacency[j] * 3u;
+          for (size_t k = 0u; k < 3u; ++k)
+          {
+            const uint32_t to = triangle[k];
+            if (to == v)
+              continue;
+            Quadric q = quadrics[v];
+            q.add(quadrics[to]);
+            const double error = Evaluate(q, points[to]);
+            if (best.to == v || error < best.error)
+              best = { (uint32_t)v, to, error };
+          }
+        }
+        if (best.to != v && best.error <= max_error)
+          collapses.push_back(best);
+      }
+      if (collapses.empty())
+        break;
+      std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+      // Collapses in one pass may not touch each other's triangles, as
+      // the checks below only look at where the vertices are now.
+      for (size_t v = 0u; v < vertex_count; ++v)
+        remap[v] = (uint32_t)v;
+      std::fill(touched.begin(), touched.end(), (uint8_t)0u);
+      size_t triangle_count = result.size() / 3u;
+      size_t collapsed = 0u;
+
+      for (const Collapse& collapse : collapses)
+      {
+        if (triangle_count * 3u <= target_index_count)
+          break;
+        if (touched[collapse.from] || touched[collapse.to])
+          continue;
+
+        // Triangles that would turn over are not worth the saving.
+        bool flips = false;
+        size_t removed = 0u;
+        for (uint32_t j = first[collapse.from]; j < first[collapse.from + 1u] && !flips; ++j)
+        {
+          const uint32_t* triangle = result.data() + adjacency[j] * 3u;
+          if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+          {
+            ++removed;
+            continue;
+          }
+
+          glm::vec3 before[3], after[3];
+          for (size_t k = 0u; k < 3u; ++k)
+          {
+            before[k] = points[triangle[k]];
+            after[k]  = points[triangle[k] == collapse.from ? collapse.to : triangle[k]];
+          }
+          const glm::vec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+          const glm::vec3 normal_after  = glm::cross(after[1] - after[0], after[2] - after[0]);
+          flips = glm::dot(normal_before, normal_after) <= 0.0f;
+        }
+        if (flips)
+          continue;
+
+        for (uint32_t j = first[collapse.from]; j < first[collapse.from + 1u]; ++j)
+        {
+          const uint32_t* triangle = result.data() + adjacency[j] * 3u;
+          touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1u;
+        }
+        remap[collapse.from] = collapse.to;
+        quadrics[collapse.to].add(quadrics[collapse.from]);
+        *result_error = std::max(*result_error, (float)std::sqrt(collapse.error));
+        triangle_count -= removed;
+        ++collapsed;
+      }
+      if (collapsed == 0u)
+        break;
+
+      // Triangles that lost a corner are gone.
+      size_t write = 0u;
+      for (size_t t = 0u; t < result.size(); t += 3u)
+      {
+        const uint32_t a = remap[result[t]], b = remap[result[t + 1u]], c = remap[result[t + 2u]];
+        if (a == b || b == c || a == c)
+          continue;
+        result[write++] = a;
+        result[write++] = b;
+        result[write++] = c;
+      }
+      result.resize(write);
+    }
+
+    memcpy(destination, result.data(), result.size() * sizeof(uint32_t));
+    return result.size();
+  }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace lambda
+{
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Collapses the edges of a triangle list onto one of their vertices,
+  // cheapest first by quadric error, until target_index_count indices are
+  // left or the next collapse would move the surface further than
+  // target_error. Vertices on open borders and on attribute seams, where
+  // vertices share a position, never move, so the result indexes the
+  // same vertices as the input. Returns the new index count, and the
+  // largest error that was made in result_error, in the units of the
+  // positions. Destination can be the same as indices.
+  size_t SimplifyMesh(
+    uint32_t* destination,
+    const uint32_t* indices,
+    size_t index_count,
+    const float* positions,
+    size_t position_stride,
+    size_t vertex_count,
+    size_t target_index_count,
+    float target_error,
+    float* result_error
+  );
+}
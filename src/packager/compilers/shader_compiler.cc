@@ -1,15 +1,22 @@
 #include "shader_compiler.h"
+#include "compile_pool.h"
 #include <utils/file_system.h>
 #include <utils/console.h>
 #include <utils/utilities.h>
 #include <memory/memory.h>
+#include <xxhash.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
 
 #if VIOLET_SHADER_CONDUCTOR
 #include <ShaderConductor/ShaderConductor.hpp>
 #include <d3d12.h>
 
-static lambda::String kFilePath;
-static lambda::String kFailedMsg = "";
+// Per thread, as the builder compiles shaders in parallel.
+static thread_local lambda::String kFilePath;
+static thread_local lambda::String kFailedMsg = "";
 
 ///////////////////////////////////////////////////////////////////////////////
 ShaderConductor::Blob* includeCallback(const char* include)
@@ -285,8 +292,25 @@ bool compileHLSL(lambda::String file, lambda::String source, lambda::String perm
 	return true;
 }
 
+
 namespace lambda
 {
+	///////////////////////////////////////////////////////////////////////////
+	// The stages in the order that they are compiled in.
+	static const struct
+	{
+		ShaderStages stage;
+		const char*  entry;
+		const char*  profile;
+	} kStages[(size_t)ShaderStages::kCount] = {
+		{ ShaderStages::kVertex,   "VS", "vs_5_0" },
+		{ ShaderStages::kPixel,    "PS", "ps_5_0" },
+		{ ShaderStages::kGeometry, "GS", "gs_5_0" },
+		{ ShaderStages::kCompute,  "CS", "cs_5_0" },
+		{ ShaderStages::kHull,     "HS", "hs_5_0" },
+		{ ShaderStages::kDomain,   "DS", "ds_5_0" },
+	};
+
 	///////////////////////////////////////////////////////////////////////////
 	VioletShaderCompiler::VioletShaderCompiler()
 		: VioletShaderManager()
@@ -294,12 +318,103 @@ namespace lambda
 	}
 
 	///////////////////////////////////////////////////////////////////////////
-	bool CompileX(
+	// Whether the name is used on its own, and not as a part of another
+	// name. With call set it has to be followed by a '('.
+	static bool HasIdentifier(const String& source, const char* name, bool call)
+	{
+		const size_t length = strlen(name);
+		for (size_t offset = source.find(name); offset != String::npos; offset = source.find(name, offset + 1u))
+		{
+			if (offset > 0u && (isalnum((unsigned char)source[offset - 1u]) || source[offset - 1u] == '_'))
+				continue;
+
+			size_t next = offset + length;
+			if (next < source.size() && (isalnum((unsigned char)source[next]) || source[next] == '_'))
+				continue;
+			if (!call)
+				return true;
+
+			while (next < source.size() && isspace((unsigned char)source[next]))
+				next++;
+			if (next < source.size() && source[next] == '(')
+				return true;
+		}
+		return false;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// The source with its includes pasted in, relative to the file that
+	// includes them. Every file is pasted once, as the include guards would.
+	static String ExpandIncludes(const String& folder, const String& source, Set<String>& included)
+	{
+		String expanded;
+		size_t offset = 0u;
+		while (offset < source.size())
+		{
+			size_t end = source.find('\n', offset);
+			if (end == String::npos)
+				end = source.size();
+			const String line = source.substr(offset, end - offset);
+			offset = end + 1u;
+
+			const size_t include = line.find("#include");
+			const size_t begin   = include == String::npos ? String::npos : line.find('"', include);
+			const size_t close   = begin == String::npos ? String::npos : line.find('"', begin + 1u);
+			if (close == String::npos)
+			{
+				expanded += line + "\n";
+				continue;
+			}
+
+			const String path = FileSystem::FixFilePath(folder + line.substr(begin + 1u, close - begin - 1u));
+			if (included.insert(path).second && FileSystem::DoesFileExist(path))
+				expanded += ExpandIncludes(FileSystem::RemoveName(path), FileSystem::FileToString(path), included);
+		}
+		return expanded;
+	}
+
+#if VIOLET_WIN32
+	///////////////////////////////////////////////////////////////////////////
+	static bool PreprocessHLSL(const String& file, const String& source, String& output)
+	{
+		ID3D10Blob* blob  = nullptr;
+		ID3D10Blob* error = nullptr;
+		IncludeHandler include_handler;
+
+		HRESULT result = D3DPreprocess(
+			(void*)source.data(),
+			source.size(),
+			file.c_str(),
+			nullptr,
+			&include_handler,
+			&blob,
+			&error
+		);
+		if (error)
+			error->Release();
+		if (FAILED(result) || !blob)
+		{
+			if (blob)
+				blob->Release();
+			return false;
+		}
+
+		output = String((const char*)blob->GetBufferPointer(), blob->GetBufferSize());
+		blob->Release();
+		return true;
+	}
+#endif
+
+	///////////////////////////////////////////////////////////////////////////
+	// Compiles one stage to one target. A stage that turns out to have no
+	// entry point succeeds with an empty output.
+	static bool CompileTarget(
 		const String& file,
 		const String& source,
 		const String& permutation,
 		const String& stage,
-		Array<Vector<char>, VIOLET_LANG_COUNT>& output,
+		int target,
+		Vector<char>& output,
 		Vector<VioletShaderResource>& resources)
 	{
 		kFilePath = lambda::FileSystem::RemoveName(file) + "/";
@@ -318,6 +433,17 @@ namespace lambda
 		}
 
 #if VIOLET_SHADER_CONDUCTOR
+		if (target == VIOLET_HLSL)
+		{
+#if VIOLET_WIN32
+			return compileHLSL(file, source, permutation, entry, stage, output, resources);
+#else
+			output.resize(source.size());
+			memcpy(output.data(), source.c_str(), source.size());
+			return true;
+#endif
+		}
+
 		ShaderConductor::ShaderStage sc_stage;
 		switch (entry[0])
 		{
@@ -329,17 +455,12 @@ namespace lambda
 		case 'V': sc_stage = ShaderConductor::ShaderStage::VertexShader; break;
 		}
 
-		ShaderConductor::MacroDefine defines[VIOLET_LANG_COUNT][1] = {
-			{ { "VIOLET_SPIRV", "0" } },
-			{ { "VIOLET_SPIRV", "0" } },
-			{ { "VIOLET_SPIRV", "0" } },
-			{ { "VIOLET_SPIRV", "0" } },
+		ShaderConductor::MacroDefine defines[1] = {
+			{ "VIOLET_SPIRV", target == VIOLET_SPIRV ? "1" : "0" }
 		};
 
-		defines[VIOLET_SPIRV][0].value = "1";
-
 		ShaderConductor::Compiler::SourceDesc source_desc;
-		source_desc.defines = nullptr;
+		source_desc.defines = defines;
 		source_desc.entryPoint = entry.c_str();
 		source_desc.fileName = file.c_str();
 		source_desc.loadIncludeCallback = includeCallback;
@@ -356,88 +477,51 @@ namespace lambda
 		options.shaderModel.major_ver = 6;
 		options.shaderModel.minor_ver = 0;
 
-		ShaderConductor::Compiler::TargetDesc target_descs[VIOLET_LANG_COUNT];
-		target_descs[VIOLET_DXIL].language  = ShaderConductor::ShadingLanguage::Dxil;
-		target_descs[VIOLET_DXIL].version   = nullptr;
-		target_descs[VIOLET_SPIRV].language = ShaderConductor::ShadingLanguage::SpirV;
-		target_descs[VIOLET_SPIRV].version  = nullptr;
-		target_descs[VIOLET_METAL].language = ShaderConductor::ShadingLanguage::Msl_macOS;
-		target_descs[VIOLET_METAL].version  = nullptr;
-		target_descs[VIOLET_HLSL].language  = ShaderConductor::ShadingLanguage::Hlsl;
-		target_descs[VIOLET_HLSL].version   = "50";
-
-		ShaderConductor::Compiler::ResultDesc results[VIOLET_LANG_COUNT];
-
-		for (int i = 0; i < VIOLET_LANG_COUNT; ++i)
+		ShaderConductor::Compiler::TargetDesc target_desc;
+		switch (target)
 		{
-			source_desc.defines = defines[i];
+		case VIOLET_DXIL:  target_desc.language = ShaderConductor::ShadingLanguage::Dxil;      break;
+		case VIOLET_SPIRV: target_desc.language = ShaderConductor::ShadingLanguage::SpirV;     break;
+		case VIOLET_METAL: target_desc.language = ShaderConductor::ShadingLanguage::Msl_macOS; break;
+		}
+		target_desc.version = nullptr;
 
-			ShaderConductor::Compiler::Compile(source_desc, options, &target_descs[i], 1, &results[i]);
+		ShaderConductor::Compiler::ResultDesc result;
+		ShaderConductor::Compiler::Compile(source_desc, options, &target_desc, 1, &result);
 
-			if (!kFailedMsg.empty())
-			{
-				foundation::Error(kFailedMsg + "\n");
-				kFailedMsg = "";
-				return false;
-			}
-			/*catch (const std::exception& e)
-			{
-				foundation::Error(String("Could not find file: ") + e.what() + "\n");
-				return false;
-			}*/
+		if (!kFailedMsg.empty())
+		{
+			foundation::Error(kFailedMsg + "\n");
+			kFailedMsg = "";
+			return false;
+		}
 
-			if (results[i].hasError)
-			{
-				String error = String(
-					(char*)results[i].errorWarningMsg->Data(),
-					results[i].errorWarningMsg->Size()
-				);
+		if (result.hasError)
+		{
+			String error = String(
+				(char*)result.errorWarningMsg->Data(),
+				result.errorWarningMsg->Size()
+			);
 
-				if (error == "error: missing entry point definition\n")
-					return true;
+			if (error == "error: missing entry point definition\n")
+				return true;
 
-				String err = "Permutation: " + permutation + " ShaderConductor: Failed to compile shader \"" + file +
-					"\" with message:\n" + error;
+			String err = "Permutation: " + permutation + " ShaderConductor: Failed to compile shader \"" + file +
+				"\" with message:\n" + error;
 
-				foundation::Error(err.c_str());
-				return false;
-			}
+			foundation::Error(err.c_str());
+			return false;
 		}
 
-		for (int i = 0; i < VIOLET_LANG_COUNT; ++i)
-		{
-			if (i != VIOLET_HLSL)
-			{
-				output[i].resize(results[i].target->Size());
-				memcpy(output[i].data(), results[i].target->Data(), output[i].size());
-			}
-			else
-			{
-#if VIOLET_WIN32
-				if (!compileHLSL(file, source, permutation, entry, stage, output[i], resources))
-					return false;
-#else
-				output[i].resize(source.size());
-				memcpy(output[i].data(), source.c_str(), source.size());
-#endif
-			}
-		}
+		output.resize(result.target->Size());
+		memcpy(output.data(), result.target->Data(), output.size());
 #else
-		for (int i = 0; i < VIOLET_LANG_COUNT; ++i)
-		{
 #if VIOLET_WIN32
-			if (i == VIOLET_HLSL)
-			{
-				if (!compileHLSL(file, source, permutation, entry, stage, output[i], resources))
-					return false;
-			}
-			else
+		if (target == VIOLET_HLSL)
+			return compileHLSL(file, source, permutation, entry, stage, output, resources);
 #endif
-			{
-				output[i].resize(source.size());
-				memcpy(output[i].data(), source.c_str(), output[i].size());
-			}
-		}
+		output.resize(source.size());
+		memcpy(output.data(), source.c_str(), output.size());
 #endif
 		return true;
 	}
@@ -466,30 +550,159 @@ namespace lambda
 		for (uint32_t i = 0; i < permutations.size(); ++i)
 			perms += "#define " + permutations[i] + " " + toString(i + 1) + "\n";
 
-		for (const String& permutation : permutations)
+		// Without a preprocessor at hand the permutations only differ when
+		// the source looks at TYPE.
+#if !VIOLET_WIN32
+		Set<String> included;
+		const String expanded = ExpandIncludes(FileSystem::RemoveName(compile_info.file), source, included);
+		const bool uses_type = HasIdentifier(expanded, "TYPE", false);
+#endif
+
+		// Every stage of every permutation that has an entry point, once per
+		// preprocessed source.
+		struct Stage
+		{
+			String        source;
+			String        permutation;
+			const char*   profile;
+			uint64_t      key;
+			bool          cached;
+			CompiledStage compiled;
+		};
+		Vector<Stage> stages;
+		Vector<Array<int32_t, (size_t)ShaderStages::kCount>> programs(permutations.size());
+		UnorderedMap<uint64_t, int32_t> unique;
+		uint32_t skipped = 0u;
+
+		for (uint32_t p = 0u; p < permutations.size(); ++p)
 		{
 			String perm_source = perms;
-			perm_source += "#define TYPE " + permutation + "\n";
+			perm_source += "#define TYPE " + permutations[p] + "\n";
 			perm_source += source;
 
+#if VIOLET_WIN32
+			kFilePath = FileSystem::RemoveName(compile_info.file) + "/";
+			String preprocessed;
+			if (!PreprocessHLSL(compile_info.file, perm_source, preprocessed))
+				preprocessed = perm_source;
+#else
+			const String preprocessed = perms + (uses_type ? "#define TYPE " + permutations[p] + "\n" : String()) + expanded;
+#endif
+
+			for (uint32_t s = 0u; s < (uint32_t)ShaderStages::kCount; ++s)
+			{
+				programs[p][s] = -1;
+				if (!HasIdentifier(preprocessed, kStages[s].entry, true))
+				{
+					skipped++;
+					continue;
+				}
+
+				XXH64_state_t* state = XXH64_createState();
+				XXH64_reset(state, 0u);
+				XXH64_update(state, compile_info.file.c_str(), compile_info.file.size() + 1u);
+				XXH64_update(state, kStages[s].profile, strlen(kStages[s].profile) + 1u);
+				XXH64_update(state, preprocessed.data(), preprocessed.size());
+				const uint64_t key = XXH64_digest(state);
+				XXH64_freeState(state);
+
+				auto it = unique.find(key);
+				if (it != unique.end())
+				{
+					programs[p][s] = it->second;
+					continue;
+				}
+
+				Stage stage;
+				stage.source      = perm_source;
+				stage.permutation = permutations[p];
+				stage.profile     = kStages[s].profile;
+				stage.key         = key;
+				stage.cached      = false;
+				{
+					std::lock_guard<std::mutex> lock(compiled_mutex_);
+					auto file = compiled_.find(compile_info.file);
+					if (file != compiled_.end())
+					{
+						auto compiled = file->second.find(key);
+						if (compiled != file->second.end())
+						{
+							stage.compiled = compiled->second;
+							stage.cached   = true;
+						}
+					}
+				}
+
+				programs[p][s] = (int32_t)stages.size();
+				unique.insert(eastl::make_pair(key, (int32_t)stages.size()));
+				stages.push_back(eastl::move(stage));
+			}
+		}
+
+		// Every target of every stage is a job of its own. Only the HLSL
+		// target reflects, so the resources are not shared between jobs.
+		struct Job
+		{
+			uint32_t stage;
+			int      target;
+		};
+		Vector<Job> jobs;
+		for (uint32_t i = 0u; i < stages.size(); ++i)
+			if (!stages[i].cached)
+				for (int target = 0; target < VIOLET_LANG_COUNT; ++target)
+					jobs.push_back(Job{ i, target });
+
+		std::atomic<bool> failed(false);
+		CompilePool::ParallelFor((uint32_t)jobs.size(), 1u, [&](uint32_t first, uint32_t last) {
+			for (uint32_t i = first; i < last && !failed; ++i)
+			{
+				Stage& stage = stages[jobs[i].stage];
+				Vector<VioletShaderResource> resources;
+				if (!CompileTarget(
+					compile_info.file,
+					stage.source,
+					stage.permutation,
+					stage.profile,
+					jobs[i].target,
+					stage.compiled.blobs[jobs[i].target],
+					jobs[i].target == VIOLET_HLSL ? stage.compiled.resources : resources))
+					failed = true;
+			}
+		});
+
+		if (failed)
+			return false;
+
+		{
+			UnorderedMap<uint64_t, CompiledStage> file;
+			for (const Stage& stage : stages)
+				file.insert(eastl::make_pair(stage.key, stage.compiled));
+			std::lock_guard<std::mutex> lock(compiled_mutex_);
+			compiled_[compile_info.file] = eastl::move(file);
+		}
+
+		// Added on this thread, so the build cache records it.
+		for (uint32_t p = 0u; p < permutations.size(); ++p)
+		{
 			VioletShader shader_program;
-			shader_program.file_path = compile_info.file + "|" + permutation;
+			shader_program.file_path = compile_info.file + "|" + permutations[p];
 			shader_program.hash = GetHash(shader_program.file_path);
-			if (!CompileX(compile_info.file, perm_source, permutation, "vs_5_0", shader_program.blobs[(int)ShaderStages::kVertex], shader_program.resources[(int)ShaderStages::kVertex]))
-				return false;
-			if (!CompileX(compile_info.file, perm_source, permutation, "ps_5_0", shader_program.blobs[(int)ShaderStages::kPixel], shader_program.resources[(int)ShaderStages::kPixel]))
-				return false;
-			if (!CompileX(compile_info.file, perm_source, permutation, "gs_5_0", shader_program.blobs[(int)ShaderStages::kGeometry], shader_program.resources[(int)ShaderStages::kGeometry]))
-				return false;
-			if (!CompileX(compile_info.file, perm_source, permutation, "cs_5_0", shader_program.blobs[(int)ShaderStages::kCompute], shader_program.resources[(int)ShaderStages::kCompute]))
-				return false;
-			if (!CompileX(compile_info.file, perm_source, permutation, "hs_5_0", shader_program.blobs[(int)ShaderStages::kHull], shader_program.resources[(int)ShaderStages::kHull]))
-				return false;
-			if (!CompileX(compile_info.file, perm_source, permutation, "ds_5_0", shader_program.blobs[(int)ShaderStages::kDomain], shader_program.resources[(int)ShaderStages::kDomain]))
-				return false;
-
+			for (uint32_t s = 0u; s < (uint32_t)ShaderStages::kCount; ++s)
+			{
+				if (programs[p][s] < 0)
+					continue;
+				const CompiledStage& compiled = stages[programs[p][s]].compiled;
+				shader_program.blobs[(int)kStages[s].stage]     = compiled.blobs;
+				shader_program.resources[(int)kStages[s].stage] = compiled.resources;
+			}
 			AddShader(shader_program);
 		}
+
+		foundation::Debug(
+			compile_info.file + ": " + toString((uint32_t)stages.size()) + " unique stages, " +
+			toString(skipped) + " without an entry point, " +
+			toString((uint32_t)jobs.size()) + " compiles.\n"
+		);
 		return true;
 	}
-}
\ No newline at end of file
+}
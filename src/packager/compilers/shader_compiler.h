@@ -1,5 +1,6 @@
 #pragma once
 #include <assets/shader_manager.h>
+#include <mutex>
 
 namespace lambda
 {
@@ -11,7 +12,24 @@ namespace lambda
 	class VioletShaderCompiler : public VioletShaderManager
 	{
 	public:
+		// See VioletTextureCompiler::kVersion.
+		static constexpr uint32_t kVersion = 2u;
+
 		VioletShaderCompiler();
 		bool Compile(ShaderCompileInfo compile_info);
+
+	private:
+		struct CompiledStage
+		{
+			Array<Vector<char>, VIOLET_LANG_COUNT> blobs;
+			Vector<VioletShaderResource> resources;
+		};
+
+		// The stages of the last build of every file by the hash of their
+		// preprocessed source, so rebuilds that come out the same are not
+		// compiled again. Replaced on every build, so it only holds what the
+		// files compile to now.
+		UnorderedMap<String, UnorderedMap<uint64_t, CompiledStage>> compiled_;
+		std::mutex compiled_mutex_;
 	};
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "texture_compiler.h"
+#include "compile_pool.h"
 #include <utils/file_system.h>
 #include <utils/utilities.h>
 #include <utils/console.h>
@@ -11,14 +12,23 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-#define STB_IMAGE_RESIZE_IMPLEMENTATION
-#include <stb_image_resize.h>
-
 #define STBI_MSC_SECURE_CRT
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 
+#include <utils/timer.h>
+#include <glm/gtc/packing.hpp>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define VIOLET_TEXTURE_SSE 1
+#else
+#define VIOLET_TEXTURE_SSE 0
+#endif
 
 namespace lambda
 {
@@ -28,6 +38,97 @@ namespace lambda
   {
   }
 
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Colour textures are stored in sRGB, so their mips are averaged in
+  // linear space. Data, like the DMRA maps and normals, is averaged as is.
+  static struct GammaTables
+  {
+    GammaTables()
+    {
+      for (int i = 0; i < 256; ++i)
+      {
+        const float v = (float)i / 255.0f;
+        to_linear[i] = v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+      }
+      for (int i = 0; i < 4096; ++i)
+      {
+        const float v = (float)i / 4095.0f;
+        const float s = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+        to_srgb[i] = (uint8_t)std::min(255.0f, s * 255.0f + 0.5f);
+      }
+    }
+    float   to_linear[256];
+    uint8_t to_srgb[4096];
+  } kGamma;
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static bool isLinearData(const String& file)
+  {
+    const String name = FileSystem::FileName(file);
+    for (const char* suffix : { "_dmra", "_ao", "_dis", "_met", "_rgh", "_nrm", "_normal" })
+    {
+      const size_t length = strlen(suffix);
+      if (name.size() >= length && name.compare(name.size() - length, length, suffix) == 0)
+        return true;
+    }
+    return false;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static void decodeRow(const uint8_t* row, int w, bool linear, float* output)
+  {
+    for (int i = 0; i < w * 4; i += 4)
+    {
+      for (int c = 0; c < 3; ++c)
+        output[i + c] = linear ? row[i + c] / 255.0f : kGamma.to_linear[row[i + c]];
+      output[i + 3] = row[i + 3] / 255.0f;
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Box filters the rows [first_row, last_row) of the next level. The last
+  // row and column of odd sizes are folded into their neighbours.
+  static void downsampleRows(const uint8_t* source, int w, int h, uint8_t* destination, int new_width, int first_row, int last_row, bool linear)
+  {
+    Vector<float> rows((size_t)w * 8u);
+    Vector<float> filtered((size_t)new_width * 4u);
+    float* top    = rows.data();
+    float* bottom = rows.data() + w * 4;
+
+    for (int y = first_row; y < last_row; ++y)
+    {
+      decodeRow(source + (size_t)std::min(y * 2, h - 1) * w * 4, w, linear, top);
+      decodeRow(source + (size_t)std::min(y * 2 + 1, h - 1) * w * 4, w, linear, bottom);
+
+      for (int x = 0; x < new_width; ++x)
+      {
+        const int x0 = std::min(x * 2, w - 1) * 4;
+        const int x1 = std::min(x * 2 + 1, w - 1) * 4;
+#if VIOLET_TEXTURE_SSE
+        const __m128 sum = _mm_add_ps(
+          _mm_add_ps(_mm_loadu_ps(top + x0), _mm_loadu_ps(top + x1)),
+          _mm_add_ps(_mm_loadu_ps(bottom + x0), _mm_loadu_ps(bottom + x1))
+        );
+        _mm_storeu_ps(filtered.data() + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+        for (int c = 0; c < 4; ++c)
+          filtered[x * 4 + c] = (top[x0 + c] + top[x1 + c] + bottom[x0 + c] + bottom[x1 + c]) * 0.25f;
+#endif
+      }
+
+      uint8_t* output = destination + (size_t)y * new_width * 4;
+      for (int i = 0; i < new_width * 4; i += 4)
+      {
+        for (int c = 0; c < 3; ++c)
+        {
+          const float v = std::min(1.0f, std::max(0.0f, filtered[i + c]));
+          output[i + c] = linear ? (uint8_t)(v * 255.0f + 0.5f) : kGamma.to_srgb[(int)(v * 4095.0f + 0.5f)];
+        }
+        output[i + 3] = (uint8_t)(std::min(1.0f, std::max(0.0f, filtered[i + 3])) * 255.0f + 0.5f);
+      }
+    }
+  }
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	int calcImageSize(int w, int h, int mips)
 	{
@@ -42,7 +143,9 @@ namespace lambda
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	void genMips(int w, int h, int mips, unsigned char* data)
+	// Every level is made from the one before it, in bands of rows that are
+	// filtered by the compile pool.
+	void genMips(int w, int h, int mips, unsigned char* data, bool linear)
 	{
 		int offset = 0;
 
@@ -52,17 +155,9 @@ namespace lambda
 			int new_height = std::max(1, h / 2);
 			int new_offset = offset + w * h * 4;
 
-			stbir_resize_uint8(
-				data + offset,
-				w,
-				h,
-				0,
-				data + new_offset,
-				new_width,
-				new_height,
-				0,
-				STBI_rgb_alpha
-			);
+			CompilePool::ParallelFor((uint32_t)new_height, 16u, [&](uint32_t first, uint32_t last) {
+				downsampleRows(data + offset, w, h, data + new_offset, new_width, (int)first, (int)last, linear);
+			});
 
 			w = new_width;
 			h = new_height;
@@ -70,19 +165,37 @@ namespace lambda
 		}
 	}
 
+  /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  static const char* formatName(TextureFormat format)
+  {
+    switch (format)
+    {
+    case TextureFormat::kBC1:          return "BC1";
+    case TextureFormat::kBC3:          return "BC3";
+    case TextureFormat::kBC4:          return "BC4";
+    case TextureFormat::kBC5:          return "BC5";
+    case TextureFormat::kBC7:          return "BC7";
+    case TextureFormat::kR8G8B8A8:     return "RGBA8";
+    case TextureFormat::kR16G16B16A16: return "RGBA16F";
+    default:                           return "?";
+    }
+  }
+
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	bool VioletTextureCompiler::Compile(TextureCompileInfo texture_info)
   {
-		String extension = FileSystem::GetExtension(texture_info.file);
 		Vector<char> raw_data;
 		int w, h, num_mips;
 		bool contains_alpha = false;
 		TextureFormat format;
 		Vector<char> raw_texture = FileSystem::FileToVector(texture_info.file);
+		double mip_milliseconds = 0.0;
+		double encode_milliseconds = 0.0;
 
 		if (stbi_is_hdr_from_memory((unsigned char*)raw_texture.data(), (int)raw_texture.size()))
 		{
-			format = TextureFormat::kR32G32B32A32;
+			// Half floats are plenty for colours, at half the size.
+			format = TextureFormat::kR16G16B16A16;
 
 			int bpp;
 			float* data = stbi_loadf_from_memory((unsigned char*)raw_texture.data(), (int)raw_texture.size(), &w, &h, &bpp, STBI_rgb_alpha);
@@ -105,14 +218,16 @@ namespace lambda
 
 			num_mips = 1;
 
-			raw_data.resize(w * h * 4 * sizeof(float)* num_mips);
-			memcpy(raw_data.data(), data, w * h * 4 * sizeof(float));
+			utilities::Timer timer;
+			raw_data.resize(w * h * 4 * sizeof(uint16_t) * num_mips);
+			uint16_t* halves = (uint16_t*)raw_data.data();
+			for (int i = 0; i < w * h * 4; ++i)
+				halves[i] = glm::packHalf1x16(data[i]);
+			encode_milliseconds = timer.elapsed().milliseconds();
 			stbi_image_free(data);
 		}
 		else
 		{
-			format = TextureFormat::kR8G8B8A8;
-
 			int bpp;
 			uint8_t* data = stbi_load_from_memory((unsigned char*)raw_texture.data(), (int)raw_texture.size(), &w, &h, &bpp, STBI_rgb_alpha);
 
@@ -134,11 +249,64 @@ namespace lambda
 
 			num_mips = (int)floorf(std::log2f(std::fminf((float)w, (float)h)) + 1.0f);
 
-			int data_size = calcImageSize(w, h, num_mips);
-			raw_data.resize(data_size);
-			memcpy(raw_data.data(), data, w * h * 4);
+			utilities::Timer timer;
+			Vector<char> mips(calcImageSize(w, h, num_mips));
+			memcpy(mips.data(), data, w * h * 4);
 			stbi_image_free(data);
-			genMips(w, h, num_mips, (unsigned char*)raw_data.data());
+			genMips(w, h, num_mips, (unsigned char*)mips.data(), isLinearData(texture_info.file));
+			mip_milliseconds = timer.elapsed().milliseconds();
+
+			format = texture_info.format;
+			if (format == TextureFormat::kUnknown)
+			{
+				format = texture_info.quality == TextureQuality::kHigh ? TextureFormat::kBC7 :
+					contains_alpha ? TextureFormat::kBC3 : TextureFormat::kBC1;
+			}
+			else if (format != TextureFormat::kR8G8B8A8 && GetBlockSize(format) == 0u)
+			{
+				foundation::Warning("Texture format " + toString((uint32_t)format) + " is not supported, using RGBA8: " + texture_info.file + "\n");
+				format = TextureFormat::kR8G8B8A8;
+			}
+
+			// Block compressed textures have to start at a multiple of 4.
+			if (GetBlockSize(format) != 0u && (w % 4 != 0 || h % 4 != 0))
+				format = TextureFormat::kR8G8B8A8;
+
+			if (format == TextureFormat::kR8G8B8A8)
+				raw_data = eastl::move(mips);
+			else
+			{
+				timer.reset();
+
+				size_t size = 0u;
+				Vector<size_t> mip_sizes(num_mips);
+				for (int mip = 0; mip < num_mips; ++mip)
+				{
+					uint32_t bpp, bpr, bpl;
+					calculateImageMemory(format, (uint16_t)std::max(1, w >> mip), (uint16_t)std::max(1, h >> mip), bpp, bpr, bpl);
+					mip_sizes[mip] = bpl;
+					size += bpl;
+				}
+				raw_data.resize(size);
+
+				size_t source_offset = 0u;
+				size_t output_offset = 0u;
+				for (int mip = 0; mip < num_mips; ++mip)
+				{
+					const uint32_t mip_width  = (uint32_t)std::max(1, w >> mip);
+					const uint32_t mip_height = (uint32_t)std::max(1, h >> mip);
+					const uint8_t* source = (const uint8_t*)mips.data() + source_offset;
+					uint8_t* output = (uint8_t*)raw_data.data() + output_offset;
+
+					CompilePool::ParallelFor((mip_height + 3u) / 4u, 4u, [&](uint32_t first, uint32_t last) {
+						EncodeBlockRows(format, source, mip_width, mip_height, first, last, texture_info.quality, output);
+					});
+
+					source_offset += (size_t)mip_width * mip_height * 4u;
+					output_offset += mip_sizes[mip];
+				}
+				encode_milliseconds = timer.elapsed().milliseconds();
+			}
 		}
 
 		VioletTexture texture;
@@ -152,6 +320,30 @@ namespace lambda
 		texture.data      = raw_data;
 		AddTexture(texture);
 
+		// Compared against what it used to be stored as.
+		const double uncompressed = format == TextureFormat::kR16G16B16A16 ?
+			(double)w * h * 4.0 * sizeof(float) : (double)calcImageSize(w, h, num_mips);
+		const double pixels = format == TextureFormat::kR16G16B16A16 ?
+			(double)w * h : uncompressed / 4.0;
+		char report[256];
+		snprintf(
+			report,
+			sizeof(report),
+			"%s: %s %dx%d, %d mips, %.2f MB -> %.2f MB (%.1f:1), mips %.0fms, encode %.0fms (%.1f MP/s)\n",
+			texture_info.file.c_str(),
+			formatName(format),
+			w,
+			h,
+			num_mips,
+			uncompressed / (1024.0 * 1024.0),
+			raw_data.size() / (1024.0 * 1024.0),
+			uncompressed / std::max<size_t>(1u, raw_data.size()),
+			mip_milliseconds,
+			encode_milliseconds,
+			encode_milliseconds > 0.0 ? pixels / 1000.0 / encode_milliseconds : 0.0
+		);
+		foundation::Info(report);
+
 		return true;
   }
-}
\ No newline at end of file
+}
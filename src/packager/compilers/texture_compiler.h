@@ -1,16 +1,25 @@
 #pragma once
 #include <assets/texture_manager.h>
+#include "block_compression.h"
 
 namespace lambda
 {
   struct TextureCompileInfo
   {
     String file;
+    // Unknown picks BC1, or BC3 when there is alpha, or BC7 at high
+    // quality. Sizes that are not a multiple of 4 stay RGBA8.
+    TextureFormat format = TextureFormat::kUnknown;
+    TextureQuality quality = TextureQuality::kNormal;
   };
 
   class VioletTextureCompiler : public VioletTextureManager
   {
   public:
+    // Bump when the output changes, so the build cache stops handing out
+    // what the older version compiled.
+    static constexpr uint32_t kVersion = 2u;
+
     VioletTextureCompiler();
     bool Compile(TextureCompileInfo texture_info);
   };
@@ -11,6 +11,9 @@ namespace lambda
   class VioletWaveCompiler : public VioletWaveManager
   {
   public:
+    // See VioletTextureCompiler::kVersion.
+    static constexpr uint32_t kVersion = 1u;
+
     VioletWaveCompiler();
 	bool Compile(WaveCompileInfo wave_info);
   };